@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+
+"""Before/after --benchmark throughput and VRAM comparison of two vkrt builds.
+
+Each build renders every scene headless for the same sample count. Runs alternate between the builds so thermal and
+clock drift affect both equally, and the median samples/s of each build is reported with the relative change. Builds
+that print the offline render memory line also get their device-local, geometry and BLAS footprints compared.
+With --textured, every scene is rendered with a tiled base-color texture on its non-emissive materials instead.
+"""
+
+import argparse
+import statistics
+import sys
+from contextlib import nullcontext
+from pathlib import Path
+
+from vkrt_bench import (
+    DEFAULT_BINARY,
+    DEFAULT_SCENE,
+    DEFAULT_TEXTURE,
+    parse_render_memory,
+    parse_timed_render,
+    run_vkrt,
+    textured_scene_variant,
+)
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--baseline", type=Path, required=True, help="vkrt binary built from the baseline tree")
+    parser.add_argument("--candidate", type=Path, default=DEFAULT_BINARY, help="vkrt binary built with the change")
+    parser.add_argument("--scene", type=Path, action="append", help="scene to render; repeat for several scenes")
+    parser.add_argument("--width", type=int, default=1920)
+    parser.add_argument("--height", type=int, default=1080)
+    parser.add_argument("--samples", type=int, default=4096, help="timed samples per run")
+    parser.add_argument("--runs", type=int, default=5, help="runs per build and scene")
+    parser.add_argument("--textured", action="store_true", help="texture every non-emissive material")
+    parser.add_argument("--texture", type=Path, default=DEFAULT_TEXTURE, help="texture used by --textured")
+    parser.add_argument(
+        "--texture-tiling", type=float, default=32.0, help="UV repeats per texcoord unit used by --textured"
+    )
+    return parser.parse_args()
+
+
+def benchmark(args, binary, scene):
+    output = run_vkrt(
+        binary,
+        [
+            "--benchmark",
+            "--render-headless",
+            "--scene", scene,
+            "--render-width", args.width,
+            "--render-height", args.height,
+            "--render-samples", args.samples,
+        ],
+    )
+    return parse_timed_render(output)[1], parse_render_memory(output)
+
+
+def relative_spread(values):
+    """Run-to-run range relative to the median; a change smaller than this is noise."""
+    median = statistics.median(values)
+    return (max(values) - min(values)) / median if median > 0.0 else 0.0
+
+
+def compare_scene(args, scene):
+    builds = {"baseline": args.baseline, "candidate": args.candidate}
+    samples_per_second = {name: [] for name in builds}
+    memory = {}
+    for run in range(args.runs):
+        print(f"{scene.name}: run {run + 1}/{args.runs}", file=sys.stderr, flush=True)
+        for name, binary in builds.items():
+            throughput, memory[name] = benchmark(args, binary, scene)
+            samples_per_second[name].append(throughput)
+    medians = {name: statistics.median(values) for name, values in samples_per_second.items()}
+    spread = max(relative_spread(values) for values in samples_per_second.values())
+    return medians, spread, memory
+
+
+def print_memory(memory_rows):
+    labels = ("device-local", "geometry", "BLAS")
+    print(f"\n{'scene':<24} {'memory (MiB)':<13} {'baseline':>10} {'candidate':>10} {'change':>8}")
+    for name, memory in memory_rows:
+        for index, label in enumerate(labels):
+            baseline = memory["baseline"][index] if memory["baseline"] else None
+            candidate = memory["candidate"][index] if memory["candidate"] else None
+            if baseline is None or candidate is None:
+                missing = "baseline" if baseline is None else "candidate"
+                print(f"{name:<24} {'-':<13} (no memory line from the {missing} build)")
+                break
+            change = f"{(candidate / baseline - 1.0) * 100.0:>+7.1f}%" if baseline > 0.0 else f"{'-':>8}"
+            print(f"{name:<24} {label:<13} {baseline:>10.2f} {candidate:>10.2f} {change}")
+
+
+def main():
+    args = parse_args()
+    for binary in (args.baseline, args.candidate):
+        if not binary.is_file():
+            raise RuntimeError(f"missing executable: {binary}")
+    if args.runs < 1:
+        raise RuntimeError("--runs must be at least 1")
+    scenes = args.scene or [DEFAULT_SCENE]
+
+    rows = []
+    memory_rows = []
+    for scene in scenes:
+        variant = nullcontext(scene)
+        if args.textured:
+            variant = textured_scene_variant(scene, args.texture, args.texture_tiling)
+        with variant as scene_path:
+            medians, spread, memory = compare_scene(args, Path(scene_path).resolve())
+        rows.append((scene.name, medians["baseline"], medians["candidate"], spread))
+        memory_rows.append((scene.name, memory))
+
+    print(f"{'scene':<24} {'baseline (samples/s)':>21} {'candidate (samples/s)':>22} {'change':>8} {'spread':>7}")
+    for name, baseline, candidate, spread in rows:
+        change = (candidate / baseline - 1.0) * 100.0 if baseline > 0.0 else 0.0
+        print(f"{name:<24} {baseline:>21.2f} {candidate:>22.2f} {change:>+7.1f}% {spread * 100.0:>6.1f}%")
+    print_memory(memory_rows)
+    return 0
+
+
+if __name__ == "__main__":
+    try:
+        raise SystemExit(main())
+    except Exception as exc:
+        print(exc, file=sys.stderr)
+        raise SystemExit(1)
@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+
+"""Equal-time RMSE comparison of the alias-table and light-BVH emitter samplers.
+
+Both samplers render the scene headless for the same wall-clock budget. Each result is compared against a long
+reference render, and the variance ratio at equal time is reported as the BVH's efficiency gain.
+"""
+
+import argparse
+import sys
+import tempfile
+from pathlib import Path
+
+from vkrt_bench import (
+    DEFAULT_BINARY,
+    DEFAULT_SCENE,
+    parse_time_limited_render,
+    read_exr,
+    rgb_rmse,
+    run_vkrt,
+    scene_variant,
+)
+
+LIGHT_SAMPLING_MODES = {"alias": 0, "bvh": 1}
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--binary", type=Path, default=DEFAULT_BINARY)
+    parser.add_argument("--scene", type=Path, default=DEFAULT_SCENE)
+    parser.add_argument("--width", type=int, default=512)
+    parser.add_argument("--height", type=int, default=512)
+    parser.add_argument("--time", type=float, default=10.0, help="seconds per sampler")
+    parser.add_argument(
+        "--reference-time", type=float, default=300.0, help="seconds for the BVH reference render"
+    )
+    parser.add_argument("--reference", type=Path, help="reuse an existing reference EXR")
+    parser.add_argument("--output-dir", type=Path, help="keep the rendered EXRs here")
+    return parser.parse_args()
+
+
+def render(args, mode, seconds, output_path):
+    with scene_variant(args.scene, {"lightSamplingMode": LIGHT_SAMPLING_MODES[mode]}) as scene_path:
+        output = run_vkrt(
+            args.binary,
+            [
+                "--scene", scene_path,
+                "--render-headless",
+                "--render-width", args.width,
+                "--render-height", args.height,
+                "--render-time", seconds,
+                "--render-output", output_path,
+            ],
+        )
+    return parse_time_limited_render(output)
+
+
+def compare(args, output_dir):
+    reference_path = args.reference
+    if reference_path is None:
+        reference_path = output_dir / "reference.exr"
+        print(f"Rendering {args.reference_time:.0f} s BVH reference...", flush=True)
+        render(args, "bvh", args.reference_time, reference_path)
+    reference = read_exr(reference_path)
+
+    results = {}
+    for mode in LIGHT_SAMPLING_MODES:
+        image_path = output_dir / f"{mode}.exr"
+        elapsed, samples = render(args, mode, args.time, image_path)
+        results[mode] = (elapsed, samples, rgb_rmse(read_exr(image_path), reference))
+
+    print(f"{'sampler':<8} {'time (s)':>9} {'samples':>9} {'RMSE':>12}")
+    for mode, (elapsed, samples, rmse) in results.items():
+        print(f"{mode:<8} {elapsed:>9.2f} {samples:>9} {rmse:>12.6g}")
+
+    alias_rmse = results["alias"][2]
+    bvh_rmse = results["bvh"][2]
+    if bvh_rmse > 0.0:
+        print(f"BVH efficiency at equal time: {(alias_rmse / bvh_rmse) ** 2:.2f}x (alias MSE / BVH MSE)")
+
+
+def main():
+    args = parse_args()
+    if not args.binary.is_file():
+        raise RuntimeError(f"missing executable: {args.binary}")
+
+    if args.output_dir:
+        args.output_dir.mkdir(parents=True, exist_ok=True)
+        compare(args, args.output_dir.resolve())
+        return 0
+    with tempfile.TemporaryDirectory() as output_dir:
+        compare(args, Path(output_dir))
+    return 0
+
+
+if __name__ == "__main__":
+    try:
+        raise SystemExit(main())
+    except Exception as exc:
+        print(exc, file=sys.stderr)
+        raise SystemExit(1)
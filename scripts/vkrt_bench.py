@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+
+"""Helpers shared by the benchmark scripts: running vkrt, scene variants and reading its EXR output."""
+
+import json
+import os
+import re
+import struct
+import subprocess
+import zlib
+from contextlib import contextmanager
+from itertools import accumulate
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parents[1]
+DEFAULT_BINARY = ROOT / "build" / "vkrt"
+DEFAULT_SCENE = ROOT / "assets" / "scenes" / "cornell.json"
+DEFAULT_TEXTURE = ROOT / "assets" / "images" / "dragon.png"
+TEXTURE_COLOR_SPACE_SRGB = 0
+
+EXR_MAGIC = 20000630
+EXR_COMPRESSION_NONE = 0
+EXR_COMPRESSION_ZIPS = 2
+EXR_COMPRESSION_ZIP = 3
+EXR_PIXEL_FORMATS = {0: ("I", 4), 1: ("e", 2), 2: ("f", 4)}
+
+TIME_LIMIT_PATTERN = re.compile(r"stopped by time/noise limit after ([0-9.]+) s, ([0-9]+) samples")
+TIMED_RESULT_PATTERN = re.compile(r"Offline render complete: ([0-9.]+) s, ([0-9.]+) samples/s")
+MEMORY_PATTERN = re.compile(
+    r"Offline render memory: ([0-9.]+) MiB device-local used, ([0-9.]+) MiB geometry, ([0-9.]+) MiB BLAS"
+)
+
+
+def run_vkrt(binary, arguments, timeout=None):
+    command = [str(binary), *[str(argument) for argument in arguments]]
+    completed = subprocess.run(
+        command, cwd=ROOT, capture_output=True, text=True, timeout=timeout
+    )
+    if completed.returncode != 0:
+        raise RuntimeError(
+            f"{' '.join(command)} failed ({completed.returncode}):\n"
+            f"{completed.stdout}{completed.stderr}"
+        )
+    return completed.stdout + completed.stderr
+
+
+def parse_time_limited_render(output):
+    match = TIME_LIMIT_PATTERN.search(output)
+    if not match:
+        raise RuntimeError(f"no time-limited render summary in output:\n{output}")
+    return float(match.group(1)), int(match.group(2))
+
+
+def parse_timed_render(output):
+    match = TIMED_RESULT_PATTERN.search(output)
+    if not match:
+        raise RuntimeError(f"no offline render summary in output:\n{output}")
+    return float(match.group(1)), float(match.group(2))
+
+
+def parse_render_memory(output):
+    """Returns (device-local used, geometry, BLAS) in MiB, or None for builds that do not print the memory line."""
+    match = MEMORY_PATTERN.search(output)
+    if not match:
+        return None
+    return tuple(float(group) for group in match.groups())
+
+
+@contextmanager
+def write_scene_variant(scene_path, suffix, scene):
+    """Writes a copy of the scene next to the original, so relative asset paths still resolve."""
+    variant_path = scene_path.with_name(f".{scene_path.stem}.{suffix}.json")
+    variant_path.write_text(json.dumps(scene, indent=2))
+    try:
+        yield variant_path
+    finally:
+        variant_path.unlink(missing_ok=True)
+
+
+@contextmanager
+def scene_variant(scene_path, settings):
+    scene_path = Path(scene_path).resolve()
+    scene = json.loads(scene_path.read_text())
+    scene.setdefault("sceneSettings", {}).update(settings)
+
+    suffix = "_".join(f"{key}{value}" for key, value in sorted(settings.items()))
+    with write_scene_variant(scene_path, suffix, scene) as variant_path:
+        yield variant_path
+
+
+@contextmanager
+def textured_scene_variant(scene_path, texture_path, tiling):
+    """Puts one tiled base-color texture on every non-emissive material, so most hits sample a minified texture."""
+    scene_path = Path(scene_path).resolve()
+    texture_path = Path(texture_path).resolve()
+    scene = json.loads(scene_path.read_text())
+
+    textures = scene.setdefault("textureImports", [])
+    texture_index = max((texture["index"] for texture in textures), default=-1) + 1
+    textures.append(
+        {
+            "index": texture_index,
+            "colorSpace": TEXTURE_COLOR_SPACE_SRGB,
+            "path": os.path.relpath(texture_path, scene_path.parent),
+        }
+    )
+    for material in scene.get("materials", []):
+        properties = material.setdefault("material", {})
+        if properties.get("emissionLuminance", 0.0) > 0.0:
+            continue
+        properties["baseColorTextureIndex"] = texture_index
+        properties["baseColorTextureTransform"] = [tiling, tiling, 0.0, 0.0]
+
+    with write_scene_variant(scene_path, f"textured{tiling:g}", scene) as variant_path:
+        yield variant_path
+
+
+def read_null_terminated(data, offset):
+    end = data.index(b"\0", offset)
+    return data[offset:end].decode("ascii"), end + 1
+
+
+def parse_exr_channels(value):
+    channels = []
+    offset = 0
+    while value[offset] != 0:
+        name, offset = read_null_terminated(value, offset)
+        pixel_type = struct.unpack_from("<i", value, offset)[0]
+        offset += 16
+        channels.append((name, pixel_type))
+    return channels
+
+
+def undo_exr_zip_filter(data):
+    predicted = bytes(accumulate(data, lambda previous, delta: (previous + delta - 128) & 0xFF))
+    half = (len(predicted) + 1) // 2
+    restored = bytearray(len(predicted))
+    restored[0::2] = predicted[:half]
+    restored[1::2] = predicted[half:]
+    return bytes(restored)
+
+
+def read_exr(path):
+    """Reads a single-part scanline EXR, as written by the exporter. Returns (width, height, {channel: [values]})."""
+    data = Path(path).read_bytes()
+    magic, version = struct.unpack_from("<ii", data, 0)
+    if magic != EXR_MAGIC or (version & 0x1200) != 0:
+        raise RuntimeError(f"{path}: only single-part scanline EXR files are supported")
+
+    attributes = {}
+    offset = 8
+    while data[offset] != 0:
+        name, offset = read_null_terminated(data, offset)
+        _, offset = read_null_terminated(data, offset)
+        size = struct.unpack_from("<i", data, offset)[0]
+        offset += 4
+        attributes[name] = data[offset : offset + size]
+        offset += size
+    offset += 1
+
+    channels = parse_exr_channels(attributes["channels"])
+    compression = attributes["compression"][0]
+    x_min, y_min, x_max, y_max = struct.unpack("<iiii", attributes["dataWindow"])
+    width = x_max - x_min + 1
+    height = y_max - y_min + 1
+    lines_per_block = {EXR_COMPRESSION_NONE: 1, EXR_COMPRESSION_ZIPS: 1, EXR_COMPRESSION_ZIP: 16}.get(compression)
+    if lines_per_block is None:
+        raise RuntimeError(f"{path}: unsupported EXR compression {compression}")
+
+    block_count = (height + lines_per_block - 1) // lines_per_block
+    block_offsets = struct.unpack_from(f"<{block_count}Q", data, offset)
+    pixels = {name: [0.0] * (width * height) for name, _ in channels}
+    for block_offset in block_offsets:
+        y, size = struct.unpack_from("<ii", data, block_offset)
+        block = data[block_offset + 8 : block_offset + 8 + size]
+        line_count = min(lines_per_block, y_max + 1 - y)
+        line_bytes = sum(width * EXR_PIXEL_FORMATS[pixel_type][1] for _, pixel_type in channels)
+        if compression != EXR_COMPRESSION_NONE and size < line_bytes * line_count:
+            block = undo_exr_zip_filter(zlib.decompress(block))
+
+        cursor = 0
+        for line in range(line_count):
+            row = (y - y_min + line) * width
+            for name, pixel_type in channels:
+                code, byte_count = EXR_PIXEL_FORMATS[pixel_type]
+                values = struct.unpack_from(f"<{width}{code}", block, cursor)
+                pixels[name][row : row + width] = values
+                cursor += width * byte_count
+    return width, height, pixels
+
+
+def rgb_rmse(image, reference):
+    width, height, pixels = image
+    reference_width, reference_height, reference_pixels = reference
+    if (width, height) != (reference_width, reference_height):
+        raise RuntimeError("image and reference sizes differ")
+
+    total = 0.0
+    for channel in ("R", "G", "B"):
+        for value, expected in zip(pixels[channel], reference_pixels[channel]):
+            total += (value - expected) ** 2
+    return (total / (3 * width * height)) ** 0.5
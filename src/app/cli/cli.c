@@ -1,5 +1,6 @@
 #include "cli.h"
 
+#include "scene/controller.h"
 #include "vkrt.h"
 #include "vulkan/vulkan_core.h"
 
@@ -104,6 +105,27 @@ static int parseUnsignedValue(
     return 1;
 }
 
+static int parsePositiveFloatValue(
+    const char* text,
+    float* outValue,
+    const char* optionName,
+    char* error,
+    size_t errorSize
+) {
+    if (!text || !outValue || !optionName || !error || errorSize == 0) return 0;
+
+    errno = 0;
+    char* end = NULL;
+    double parsed = strtod(text, &end);
+    if (errno != 0 || end == text || (end && end[0] != '\0') || !(parsed > 0.0) || parsed > 1e9) {
+        (void)snprintf(error, errorSize, "Invalid value for %s: %s", optionName, text);
+        return 0;
+    }
+
+    *outValue = (float)parsed;
+    return 1;
+}
+
 static int parseDeviceIndexValue(const char* text, int32_t* outValue, char* error, size_t errorSize) {
     if (!text || !outValue || !error || errorSize == 0) return 0;
 
@@ -128,6 +150,7 @@ void CLIDefaultLaunchOptions(CLILaunchOptions* options) {
     options->offlineRender.width = kOfflineRenderWidth;
     options->offlineRender.height = kOfflineRenderHeight;
     options->offlineRender.targetSamples = kOfflineRenderTargetSamples;
+    meshDefaultImportOptions(&options->meshImport);
     VKRT_defaultCreateInfo(&options->createInfo);
 }
 
@@ -211,6 +234,16 @@ static int parseOfflineRenderArgument(
         return value &&
                parseUnsignedValue(value, &options->offlineRender.targetSamples, "--render-samples", error, errorSize);
     }
+    if (optionMatches(arg, "--render-noise")) {
+        const char* value = requireOptionValue(argc, argv, index, "--render-noise", error, errorSize);
+        float* target = &options->offlineRender.noiseThreshold;
+        return value && parsePositiveFloatValue(value, target, "--render-noise", error, errorSize);
+    }
+    if (optionMatches(arg, "--render-time")) {
+        const char* value = requireOptionValue(argc, argv, index, "--render-time", error, errorSize);
+        float* target = &options->offlineRender.timeLimitSeconds;
+        return value && parsePositiveFloatValue(value, target, "--render-time", error, errorSize);
+    }
     return -1;
 }
 
@@ -246,10 +279,29 @@ static int parseSceneArgument(
         options->renderOutputPath = value;
         return 1;
     }
+    if (stringsEqual(arg, "--no-mesh-optimize")) {
+        options->meshImport.optimizeGeometry = 0u;
+        return 1;
+    }
+    if (optionMatches(arg, "--mesh-weld-epsilon")) {
+        const char* value = requireOptionValue(argc, argv, index, "--mesh-weld-epsilon", error, errorSize);
+        float* target = &options->meshImport.weldEpsilon;
+        return value && parsePositiveFloatValue(value, target, "--mesh-weld-epsilon", error, errorSize);
+    }
+    if (optionMatches(arg, "--prebuild-cache")) {
+        const char* value = requireOptionValue(argc, argv, index, "--prebuild-cache", error, errorSize);
+        if (!value || !value[0]) return setCLIError(error, errorSize, "Invalid value for --prebuild-cache", NULL);
+        options->prebuildCacheScenePath = value;
+        options->mode = CLI_MODE_PREBUILD_CACHE;
+        return 1;
+    }
     return -1;
 }
 
 static int validateCLIArgumentCombination(const CLILaunchOptions* options, char* error, size_t errorSize) {
+    if (options->mode == CLI_MODE_PREBUILD_CACHE && (options->offlineRender.enabled || options->startupImportPath)) {
+        return setCLIError(error, errorSize, "--prebuild-cache cannot be combined with --render or --import", NULL);
+    }
     if (!options->offlineRender.enabled) return 1;
     if (options->startupImportPath) {
         return setCLIError(error, errorSize, "--render cannot be combined with --import", NULL);
@@ -312,6 +364,14 @@ int CLIHandleImmediateMode(const CLILaunchOptions* options, int* outExitCode) {
         case CLI_MODE_VERSION:
             CLIPrintVersion();
             return 1;
+        case CLI_MODE_PREBUILD_CACHE:
+            if (!sceneControllerPrebuildMeshCaches(options->prebuildCacheScenePath)) {
+                (void)fprintf(stderr, "Failed to prebuild mesh caches for %s\n", options->prebuildCacheScenePath);
+                if (outExitCode) *outExitCode = EXIT_FAILURE;
+                return 1;
+            }
+            printf("Mesh caches ready for %s\n", options->prebuildCacheScenePath);
+            return 1;
         case CLI_MODE_RUN:
         default:
             return 0;
@@ -370,9 +430,14 @@ void CLIPrintHelp(void) {
     printf("  --render-width <px>       Override offline render width (default: 3840)\n");
     printf("  --render-height <px>      Override offline render height (default: 2160)\n");
     printf("  --render-samples <n>      Override offline render target samples (default: 16384)\n");
+    printf("  --render-noise <ratio>    Stop the offline render once every tile's relative error is below this\n");
+    printf("  --render-time <seconds>   Stop the offline render after this much sampling time\n");
     printf("  --import <path>           Import a mesh on startup\n");
     printf("  --render-output <path>    Save the --render-headless image after completion\n");
     printf("  --benchmark               Alias for --render\n");
+    printf("  --no-mesh-optimize        Import meshes without vertex welding and reordering\n");
+    printf("  --mesh-weld-epsilon <v>   Weld vertices whose attributes differ by less than this (default: exact)\n");
+    printf("  --prebuild-cache <path>   Build the mesh caches for a vkrt scene (.json) and exit\n");
     printf("\nViewport Controls:\n");
     printf("  Middle mouse drag          Orbit camera\n");
     printf("  Shift + middle mouse drag  Pan camera\n");
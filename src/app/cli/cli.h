@@ -1,5 +1,6 @@
 #pragma once
 
+#include "mesh/loader.h"
 #include "vkrt.h"
 
 #include <stddef.h>
@@ -9,6 +10,7 @@ typedef enum CLIMode {
     CLI_MODE_RUN = 0,
     CLI_MODE_HELP,
     CLI_MODE_VERSION,
+    CLI_MODE_PREBUILD_CACHE,
 } CLIMode;
 
 typedef struct CLIOfflineRenderOptions {
@@ -17,6 +19,8 @@ typedef struct CLIOfflineRenderOptions {
     uint32_t width;
     uint32_t height;
     uint32_t targetSamples;
+    float noiseThreshold;
+    float timeLimitSeconds;
 } CLIOfflineRenderOptions;
 
 typedef struct CLILaunchOptions {
@@ -26,7 +30,9 @@ typedef struct CLILaunchOptions {
     const char* startupScenePath;
     const char* startupImportPath;
     const char* renderOutputPath;
+    const char* prebuildCacheScenePath;
     CLIOfflineRenderOptions offlineRender;
+    MeshImportOptions meshImport;
 } CLILaunchOptions;
 
 void CLIDefaultLaunchOptions(CLILaunchOptions* options);
@@ -163,6 +163,20 @@ static void drawSpectralSamplingControls(VKRT* vkrt, VKRT_SceneSettingsSnapshot*
     }
 }
 
+static void drawSamplerControls(VKRT* vkrt, VKRT_SceneSettingsSnapshot* settings) {
+    const char* samplerLabels[] = {"Hash", "Sobol", "Blue Noise"};
+    int samplerMode = (int)settings->samplerMode;
+    if (samplerMode < 0 || samplerMode >= (int)VKRT_SAMPLER_MODE_COUNT) samplerMode = 0;
+    if (ImGui_ComboCharEx("Sampler", &samplerMode, samplerLabels, VKRT_SAMPLER_MODE_COUNT, VKRT_SAMPLER_MODE_COUNT)) {
+        VKRT_Result result = VKRT_setSamplerMode(vkrt, (VKRT_SamplerMode)samplerMode);
+        logCameraInspectorFailure("Updating sampler mode failed", result);
+        if (result == VKRT_SUCCESS) {
+            settings->samplerMode = (uint32_t)samplerMode;
+        }
+    }
+    tooltipOnHover("Sobol converges fastest. Blue Noise spreads low sample count error into fine, even grain.");
+}
+
 static bool drawAutoExposureControls(VKRT* vkrt, VKRT_SceneSettingsSnapshot* settings) {
     bool autoExposureEnabled = settings->autoExposureEnabled != 0;
     if (ImGui_Checkbox("Auto Exposure", &autoExposureEnabled)) {
@@ -208,6 +222,7 @@ static void drawCameraShadingSection(VKRT* vkrt, VKRT_SceneSettingsSnapshot* set
         drawToneMappingControls(vkrt, settings);
         drawRenderModeControls(vkrt, settings);
         drawSpectralSamplingControls(vkrt, settings);
+        drawSamplerControls(vkrt, settings);
 
         bool autoExposureEnabled = drawAutoExposureControls(vkrt, settings);
         if (!autoExposureEnabled) drawExposureControls(vkrt, settings);
@@ -370,6 +385,46 @@ static void drawCameraDebugSection(VKRT* vkrt, const VKRT_SceneSettingsSnapshot*
         }
         tooltipOnHover("Samples lights directly to reduce noise from emissive lighting.");
 
+        const char* lightSamplingLabels[] = {"Alias Table", "Light BVH"};
+        int lightSamplingValue = (int)settings->lightSamplingMode;
+        if (lightSamplingValue < 0 || lightSamplingValue >= (int)VKRT_LIGHT_SAMPLING_MODE_COUNT) lightSamplingValue = 0;
+        ImGui_BeginDisabled(!neeEnabled);
+        if (ImGui_ComboCharEx(
+                "Light Sampling",
+                &lightSamplingValue,
+                lightSamplingLabels,
+                VKRT_LIGHT_SAMPLING_MODE_COUNT,
+                VKRT_LIGHT_SAMPLING_MODE_COUNT
+            )) {
+            logCameraInspectorFailure(
+                "Updating light sampling mode failed",
+                VKRT_setLightSamplingMode(vkrt, (VKRT_LightSamplingMode)lightSamplingValue)
+            );
+        }
+        ImGui_EndDisabled();
+        tooltipOnHover("Light BVH picks emitters by their estimated contribution to the shaded point.");
+
+        const char* directLightingLabels[] = {"NEE", "ReSTIR (Unbiased)", "ReSTIR (Biased)"};
+        int directLightingValue = (int)settings->directLightingMode;
+        if (directLightingValue < 0 || directLightingValue >= (int)VKRT_DIRECT_LIGHTING_MODE_COUNT) {
+            directLightingValue = 0;
+        }
+        ImGui_BeginDisabled(!neeEnabled);
+        if (ImGui_ComboCharEx(
+                "Direct Lighting",
+                &directLightingValue,
+                directLightingLabels,
+                VKRT_DIRECT_LIGHTING_MODE_COUNT,
+                VKRT_DIRECT_LIGHTING_MODE_COUNT
+            )) {
+            logCameraInspectorFailure(
+                "Updating direct lighting mode failed",
+                VKRT_setDirectLightingMode(vkrt, (VKRT_DirectLightingMode)directLightingValue)
+            );
+        }
+        ImGui_EndDisabled();
+        tooltipOnHover("ReSTIR reuses first-hit light samples across pixels and frames. Biased is for preview.");
+
         ImGui_EndDisabled();
         inspectorUnindentSection();
         inspectorEndCollapsingHeaderSection();
@@ -1,6 +1,7 @@
 #include "IconsFontAwesome6.h"
 #include "common.h"
 #include "sections.h"
+#include "session.h"
 #include "vkrt.h"
 #include "vkrt_types.h"
 
@@ -74,7 +75,13 @@ static void drawSystemSummary(const VKRT_RuntimeSnapshot* runtime, const VKRT_Sy
 
     char driverText[K_OVERVIEW_DRIVER_TEXT_CAPACITY];
     char viewportText[K_OVERVIEW_TIME_TEXT_CAPACITY];
+    char blasBytesText[K_OVERVIEW_COUNT_TEXT_CAPACITY];
+    char blasUncompactedBytesText[K_OVERVIEW_COUNT_TEXT_CAPACITY];
+    char blasMemoryText[K_OVERVIEW_DRIVER_TEXT_CAPACITY];
     formatDriverVersionText(system->vendorID, system->driverVersion, driverText, sizeof(driverText));
+    formatByteSize(runtime->blasMemoryBytes, blasBytesText, sizeof(blasBytesText));
+    formatByteSize(runtime->blasUncompactedMemoryBytes, blasUncompactedBytesText, sizeof(blasUncompactedBytesText));
+    (void)snprintf(blasMemoryText, sizeof(blasMemoryText), "%s / %s", blasBytesText, blasUncompactedBytesText);
     (void)snprintf(
         viewportText,
         sizeof(viewportText),
@@ -87,12 +94,60 @@ static void drawSystemSummary(const VKRT_RuntimeSnapshot* runtime, const VKRT_Sy
         inspectorKeyValueRow("GPU", system->deviceName);
         inspectorKeyValueRow("Driver", driverText);
         inspectorKeyValueRow("Viewport", viewportText);
+        inspectorKeyValueRow("BLAS Memory", blasMemoryText);
         endCompactTable();
     }
 }
 
-void inspectorDrawSceneOverviewSection(VKRT* vkrt) {
-    if (!vkrt) return;
+static void formatMeshImportProgressOverlay(
+    const SessionMeshImportProgress* progress,
+    char* outText,
+    size_t outTextSize,
+    float* outFraction
+) {
+    *outFraction = 0.0f;
+    switch (progress->stage) {
+        case SESSION_MESH_IMPORT_STAGE_DECODING:
+            (void)snprintf(outText, outTextSize, "Decoding");
+            break;
+        case SESSION_MESH_IMPORT_STAGE_UPLOADING:
+            if (progress->totalItems > 0u) {
+                *outFraction = (float)progress->completedItems / (float)progress->totalItems;
+            }
+            (void)snprintf(outText, outTextSize, "Uploading %u / %u", progress->completedItems, progress->totalItems);
+            break;
+        case SESSION_MESH_IMPORT_STAGE_CANCELLING:
+            (void)snprintf(outText, outTextSize, "Cancelling");
+            break;
+        case SESSION_MESH_IMPORT_STAGE_IDLE:
+        default:
+            (void)snprintf(outText, outTextSize, "Idle");
+            break;
+    }
+}
+
+static void drawMeshImportProgress(Session* session) {
+    const SessionMeshImportProgress* progress = sessionGetMeshImportProgress(session);
+    if (!progress || progress->stage == SESSION_MESH_IMPORT_STAGE_IDLE) return;
+
+    char overlay[K_OVERVIEW_DRIVER_TEXT_CAPACITY];
+    float fraction = 0.0f;
+    formatMeshImportProgressOverlay(progress, overlay, sizeof(overlay), &fraction);
+
+    ImGui_Dummy((ImVec2){0.0f, kInspectorControlSpacing});
+    ImGui_SeparatorText(ICON_FA_FILE_IMPORT " Import");
+    inspectorIndentSection();
+    ImGui_ProgressBar(fraction, (ImVec2){-1.0f, 0.0f}, overlay);
+    ImGui_BeginDisabled(progress->stage == SESSION_MESH_IMPORT_STAGE_CANCELLING);
+    if (inspectorPaddedButton(ICON_FA_XMARK " Cancel Import")) {
+        sessionQueueMeshImportCancel(session);
+    }
+    ImGui_EndDisabled();
+    inspectorUnindentSection();
+}
+
+void inspectorDrawSceneOverviewSection(VKRT* vkrt, Session* session) {
+    if (!vkrt || !session) return;
 
     VKRT_SceneSettingsSnapshot settings = {0};
     VKRT_RenderStatusSnapshot status = {0};
@@ -113,4 +168,6 @@ void inspectorDrawSceneOverviewSection(VKRT* vkrt) {
     inspectorIndentSection();
     drawSystemSummary(&runtime, &system);
     inspectorUnindentSection();
+
+    drawMeshImportProgress(session);
 }
@@ -120,7 +120,7 @@ static void drawPropertiesPanelSelector(Session* session) {
 }
 
 static void drawSceneWindowContent(VKRT* vkrt, Session* session) {
-    inspectorDrawSceneOverviewSection(vkrt);
+    inspectorDrawSceneOverviewSection(vkrt, session);
     ImGui_Dummy((ImVec2){0.0f, kInspectorControlSpacing});
     ImGui_SeparatorText(ICON_FA_CUBES " Scene");
     VKRT_RenderStatusSnapshot status = {0};
@@ -5,7 +5,7 @@
 
 void inspectorPrepareRenderState(VKRT* vkrt, Session* session);
 void inspectorDrawSceneBrowserSection(VKRT* vkrt, Session* session);
-void inspectorDrawSceneOverviewSection(VKRT* vkrt);
+void inspectorDrawSceneOverviewSection(VKRT* vkrt, Session* session);
 void inspectorDrawSelectionTab(VKRT* vkrt, Session* session);
 void inspectorDrawCameraTab(VKRT* vkrt, Session* session);
 void inspectorDrawRenderTab(VKRT* vkrt, Session* session);
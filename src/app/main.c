@@ -2,6 +2,7 @@
 #include "debug.h"
 #include "editor/editor.h"
 #include "mesh/controller.h"
+#include "mesh/loader.h"
 #include "render/benchmark.h"
 #include "render/controller.h"
 #include "scene/controller.h"
@@ -20,6 +21,8 @@ int main(int argc, char* argv[]) {
         return EXIT_FAILURE;
     }
 
+    meshSetImportOptions(&launchOptions.meshImport);
+
     int earlyExitCode = EXIT_SUCCESS;
     if (CLIHandleImmediateMode(&launchOptions, &earlyExitCode)) return earlyExitCode;
 
@@ -77,6 +80,7 @@ int main(int argc, char* argv[]) {
     exitCode = renderControllerRunInteractiveLoop(vkrt, &session);
 
 cleanup:
+    meshControllerShutdown(&session);
     VKRT_destroy(vkrt);
     sessionDeinit(&session);
     return exitCode;
@@ -0,0 +1,657 @@
+#include "cache.h"
+
+#include "constants.h"
+#include "debug.h"
+#include "formats.h"
+#include "io.h"
+#include "loader.h"
+#include "platform.h"
+#include "vkrt.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <types.h>
+
+enum {
+    K_MESH_CACHE_FILE_MAGIC = 0x48434d56u,
+    // Bump whenever the importer produces different data for the same source files.
+    K_MESH_CACHE_FILE_VERSION = 3u,
+    K_MESH_CACHE_ALIGNMENT = 64u,
+};
+
+static const char* kMeshCacheDirectory = "vkrt";
+static const uint32_t kMeshCacheNoString = UINT32_MAX;
+static const uint8_t kMeshCachePadding[K_MESH_CACHE_ALIGNMENT] = {0};
+
+typedef struct MeshCacheString {
+    uint32_t offset;
+    uint32_t length;
+} MeshCacheString;
+
+typedef struct MeshCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vertexSize;
+    uint32_t materialSize;
+    uint64_t fileSize;
+    uint32_t dependencyCount;
+    uint32_t nodeCount;
+    uint32_t entryCount;
+    uint32_t materialCount;
+    uint32_t textureCount;
+    uint32_t stringSize;
+    uint32_t optimizeGeometry;
+    float weldEpsilon;
+    uint64_t dependencyOffset;
+    uint64_t nodeOffset;
+    uint64_t entryOffset;
+    uint64_t materialOffset;
+    uint64_t textureOffset;
+    uint64_t stringOffset;
+} MeshCacheHeader;
+
+typedef struct MeshCacheDependency {
+    VKRT_FileStamp stamp;
+    MeshCacheString path;
+} MeshCacheDependency;
+
+typedef struct MeshCacheNode {
+    float localTransform[16];
+    float position[3];
+    float rotation[3];
+    float scale[3];
+    uint32_t parentIndex;
+    uint32_t meshEntryCount;
+    MeshCacheString name;
+} MeshCacheNode;
+
+typedef struct MeshCacheEntry {
+    uint64_t vertexOffset;
+    uint64_t vertexCount;
+    uint64_t indexOffset;
+    uint64_t indexCount;
+    float position[3];
+    float rotation[3];
+    float scale[3];
+    uint32_t nodeIndex;
+    uint32_t materialIndex;
+    uint32_t renderBackfaces;
+    MeshCacheString name;
+} MeshCacheEntry;
+
+typedef struct MeshCacheMaterial {
+    Material material;
+    MeshCacheString name;
+} MeshCacheMaterial;
+
+typedef struct MeshCacheTexture {
+    uint64_t pixelOffset;
+    uint64_t byteSize;
+    uint64_t mipLevelOffsets[VKRT_TEXTURE_MAX_MIP_LEVELS];
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;
+    uint32_t colorSpace;
+    uint32_t mipLevelCount;
+    MeshCacheString name;
+} MeshCacheTexture;
+
+typedef struct MeshCacheStringTable {
+    char* data;
+    size_t size;
+    size_t capacity;
+} MeshCacheStringTable;
+
+typedef struct MeshCacheWriter {
+    VKRT_FileSpan* spans;
+    size_t spanCount;
+    uint64_t fileSize;
+    MeshCacheStringTable strings;
+} MeshCacheWriter;
+
+typedef struct MeshCacheView {
+    uint8_t* bytes;
+    size_t size;
+    MeshCacheHeader header;
+    const char* strings;
+} MeshCacheView;
+
+static uint64_t hashMeshCacheKey(const char* value) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const unsigned char* cursor = (const unsigned char*)value; *cursor; cursor++) {
+        hash ^= *cursor;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static uint64_t alignMeshCacheOffset(uint64_t offset) {
+    return (offset + (K_MESH_CACHE_ALIGNMENT - 1u)) & ~(uint64_t)(K_MESH_CACHE_ALIGNMENT - 1u);
+}
+
+static int resolveMeshCachePath(const char* resolvedPath, char* outPath, size_t outPathSize) {
+    char directory[VKRT_PATH_MAX];
+    if (resolveUserCacheDirectory(kMeshCacheDirectory, directory, sizeof(directory)) != 0) return -1;
+
+    int written = snprintf(
+        outPath,
+        outPathSize,
+        "%s/mesh-%016llx.vkrtcache",
+        directory,
+        (unsigned long long)hashMeshCacheKey(resolvedPath)
+    );
+    return (written > 0 && (size_t)written < outPathSize) ? 0 : -1;
+}
+
+static int queryTexturePayloadSize(const TextureImportEntry* texture, size_t* outSize) {
+    uint32_t levelCount = texture->mipLevelCount > 0u ? texture->mipLevelCount : 1u;
+    if (levelCount > VKRT_TEXTURE_MAX_MIP_LEVELS) return -1;
+
+    size_t payloadSize = 0u;
+    for (uint32_t level = 0; level < levelCount; level++) {
+        uint32_t levelWidth = (texture->width >> level) > 0u ? texture->width >> level : 1u;
+        uint32_t levelHeight = (texture->height >> level) > 0u ? texture->height >> level : 1u;
+        size_t levelBytes = 0u;
+        size_t offset = texture->mipLevelOffsets[level];
+        if (!vkrtTryComputeTextureByteSize(levelWidth, levelHeight, texture->format, &levelBytes) ||
+            offset > SIZE_MAX - levelBytes) {
+            return -1;
+        }
+        if (offset + levelBytes > payloadSize) payloadSize = offset + levelBytes;
+    }
+
+    *outSize = payloadSize;
+    return 0;
+}
+
+static int appendMeshCacheString(MeshCacheStringTable* table, const char* value, MeshCacheString* outString) {
+    if (!value) {
+        *outString = (MeshCacheString){.offset = kMeshCacheNoString, .length = 0u};
+        return 0;
+    }
+
+    size_t length = strlen(value);
+    if (length >= kMeshCacheNoString || table->size >= kMeshCacheNoString - length - 1u) return -1;
+
+    size_t requiredSize = table->size + length + 1u;
+    if (requiredSize > table->capacity) {
+        size_t nextCapacity = table->capacity > 0u ? table->capacity : 256u;
+        while (nextCapacity < requiredSize) nextCapacity *= 2u;
+        char* resized = (char*)realloc(table->data, nextCapacity);
+        if (!resized) return -1;
+        table->data = resized;
+        table->capacity = nextCapacity;
+    }
+
+    memcpy(table->data + table->size, value, length + 1u);
+    *outString = (MeshCacheString){.offset = (uint32_t)table->size, .length = (uint32_t)length};
+    table->size = requiredSize;
+    return 0;
+}
+
+static uint64_t appendMeshCachePayload(MeshCacheWriter* writer, const void* data, size_t size) {
+    uint64_t offset = alignMeshCacheOffset(writer->fileSize);
+    if (offset > writer->fileSize) {
+        writer->spans[writer->spanCount++] = (VKRT_FileSpan){
+            .data = kMeshCachePadding,
+            .size = (size_t)(offset - writer->fileSize),
+        };
+    }
+    if (size > 0u) {
+        writer->spans[writer->spanCount++] = (VKRT_FileSpan){.data = data, .size = size};
+    }
+    writer->fileSize = offset + size;
+    return offset;
+}
+
+static int writeMeshCacheDependencies(
+    MeshCacheWriter* writer,
+    MeshCacheDependency* records,
+    const char* resolvedPath,
+    const char* const* dependencyPaths,
+    uint32_t dependencyCount
+) {
+    for (uint32_t dependencyIndex = 0u; dependencyIndex <= dependencyCount; dependencyIndex++) {
+        const char* path = dependencyIndex == 0u ? resolvedPath : dependencyPaths[dependencyIndex - 1u];
+        MeshCacheDependency* record = &records[dependencyIndex];
+        if (!path || queryFileStamp(path, &record->stamp) != 0 ||
+            appendMeshCacheString(&writer->strings, path, &record->path) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int writeMeshCacheNodes(MeshCacheWriter* writer, MeshCacheNode* records, const MeshImportData* importData) {
+    for (uint32_t nodeIndex = 0u; nodeIndex < importData->nodeCount; nodeIndex++) {
+        const NodeImportEntry* node = &importData->nodes[nodeIndex];
+        MeshCacheNode* record = &records[nodeIndex];
+        memcpy(record->localTransform, node->localTransform, sizeof(record->localTransform));
+        memcpy(record->position, node->position, sizeof(record->position));
+        memcpy(record->rotation, node->rotation, sizeof(record->rotation));
+        memcpy(record->scale, node->scale, sizeof(record->scale));
+        record->parentIndex = node->parentIndex;
+        record->meshEntryCount = node->meshEntryCount;
+        if (appendMeshCacheString(&writer->strings, node->name, &record->name) != 0) return -1;
+    }
+    return 0;
+}
+
+static int writeMeshCacheEntries(MeshCacheWriter* writer, MeshCacheEntry* records, const MeshImportData* importData) {
+    for (uint32_t entryIndex = 0u; entryIndex < importData->count; entryIndex++) {
+        const MeshImportEntry* entry = &importData->entries[entryIndex];
+        MeshCacheEntry* record = &records[entryIndex];
+        if (entry->vertexCount > SIZE_MAX / sizeof(Vertex) || entry->indexCount > SIZE_MAX / sizeof(uint32_t)) {
+            return -1;
+        }
+
+        record->vertexCount = entry->vertexCount;
+        record->vertexOffset = appendMeshCachePayload(writer, entry->vertices, entry->vertexCount * sizeof(Vertex));
+        record->indexCount = entry->indexCount;
+        record->indexOffset = appendMeshCachePayload(writer, entry->indices, entry->indexCount * sizeof(uint32_t));
+        memcpy(record->position, entry->position, sizeof(record->position));
+        memcpy(record->rotation, entry->rotation, sizeof(record->rotation));
+        memcpy(record->scale, entry->scale, sizeof(record->scale));
+        record->nodeIndex = entry->nodeIndex;
+        record->materialIndex = entry->materialIndex;
+        record->renderBackfaces = entry->renderBackfaces;
+        if (appendMeshCacheString(&writer->strings, entry->name, &record->name) != 0) return -1;
+    }
+    return 0;
+}
+
+static int writeMeshCacheMaterials(
+    MeshCacheWriter* writer,
+    MeshCacheMaterial* records,
+    const MeshImportData* importData
+) {
+    for (uint32_t materialIndex = 0u; materialIndex < importData->materialCount; materialIndex++) {
+        const MaterialImportEntry* material = &importData->materials[materialIndex];
+        records[materialIndex].material = material->material;
+        if (appendMeshCacheString(&writer->strings, material->name, &records[materialIndex].name) != 0) return -1;
+    }
+    return 0;
+}
+
+static int writeMeshCacheTextures(
+    MeshCacheWriter* writer,
+    MeshCacheTexture* records,
+    const MeshImportData* importData
+) {
+    for (uint32_t textureIndex = 0u; textureIndex < importData->textureCount; textureIndex++) {
+        const TextureImportEntry* texture = &importData->textures[textureIndex];
+        MeshCacheTexture* record = &records[textureIndex];
+        size_t payloadSize = 0u;
+        if (!texture->pixels || queryTexturePayloadSize(texture, &payloadSize) != 0) return -1;
+
+        record->byteSize = payloadSize;
+        record->pixelOffset = appendMeshCachePayload(writer, texture->pixels, payloadSize);
+        for (uint32_t level = 0u; level < VKRT_TEXTURE_MAX_MIP_LEVELS; level++) {
+            record->mipLevelOffsets[level] = texture->mipLevelOffsets[level];
+        }
+        record->width = texture->width;
+        record->height = texture->height;
+        record->format = texture->format;
+        record->colorSpace = texture->colorSpace;
+        record->mipLevelCount = texture->mipLevelCount;
+        if (appendMeshCacheString(&writer->strings, texture->name, &record->name) != 0) return -1;
+    }
+    return 0;
+}
+
+static MeshCacheHeader buildMeshCacheHeader(
+    const MeshImportOptions* options,
+    uint32_t dependencyCount,
+    const MeshImportData* importData
+) {
+    MeshCacheHeader header = {
+        .magic = K_MESH_CACHE_FILE_MAGIC,
+        .version = K_MESH_CACHE_FILE_VERSION,
+        .vertexSize = (uint32_t)sizeof(Vertex),
+        .materialSize = (uint32_t)sizeof(Material),
+        .optimizeGeometry = options->optimizeGeometry,
+        .weldEpsilon = options->optimizeGeometry ? options->weldEpsilon : 0.0f,
+        .dependencyCount = dependencyCount,
+        .nodeCount = importData->nodeCount,
+        .entryCount = importData->count,
+        .materialCount = importData->materialCount,
+        .textureCount = importData->textureCount,
+    };
+    header.dependencyOffset = alignMeshCacheOffset(sizeof(MeshCacheHeader));
+    header.nodeOffset =
+        alignMeshCacheOffset(header.dependencyOffset + (uint64_t)dependencyCount * sizeof(MeshCacheDependency));
+    header.entryOffset = alignMeshCacheOffset(header.nodeOffset + (uint64_t)header.nodeCount * sizeof(MeshCacheNode));
+    header.materialOffset =
+        alignMeshCacheOffset(header.entryOffset + (uint64_t)header.entryCount * sizeof(MeshCacheEntry));
+    header.textureOffset =
+        alignMeshCacheOffset(header.materialOffset + (uint64_t)header.materialCount * sizeof(MeshCacheMaterial));
+    return header;
+}
+
+int meshCacheStore(
+    const char* resolvedPath,
+    const MeshImportOptions* options,
+    const char* const* dependencyPaths,
+    uint32_t dependencyCount,
+    const MeshImportData* importData
+) {
+    if (!resolvedPath || !resolvedPath[0] || !options || !importData || (!dependencyPaths && dependencyCount > 0u) ||
+        dependencyCount == UINT32_MAX) {
+        return -1;
+    }
+
+    uint64_t startTime = getMicroseconds();
+    char path[VKRT_PATH_MAX];
+    if (resolveMeshCachePath(resolvedPath, path, sizeof(path)) != 0) return -1;
+
+    MeshCacheHeader header = buildMeshCacheHeader(options, dependencyCount + 1u, importData);
+    uint64_t metadataSize =
+        alignMeshCacheOffset(header.textureOffset + (uint64_t)header.textureCount * sizeof(MeshCacheTexture));
+    size_t spanCapacity = 3u + 2u * (2u * (size_t)importData->count + importData->textureCount);
+    if (metadataSize > SIZE_MAX) return -1;
+
+    uint8_t* metadata = (uint8_t*)calloc(1u, (size_t)metadataSize);
+    MeshCacheWriter writer = {
+        .spans = (VKRT_FileSpan*)calloc(spanCapacity, sizeof(VKRT_FileSpan)),
+        .fileSize = metadataSize,
+    };
+    if (!metadata || !writer.spans) {
+        free(metadata);
+        free(writer.spans);
+        return -1;
+    }
+    writer.spans[writer.spanCount++] = (VKRT_FileSpan){.data = metadata, .size = (size_t)metadataSize};
+
+    int result = -1;
+    if (writeMeshCacheDependencies(
+            &writer,
+            (MeshCacheDependency*)(metadata + header.dependencyOffset),
+            resolvedPath,
+            dependencyPaths,
+            dependencyCount
+        ) != 0 ||
+        writeMeshCacheNodes(&writer, (MeshCacheNode*)(metadata + header.nodeOffset), importData) != 0 ||
+        writeMeshCacheEntries(&writer, (MeshCacheEntry*)(metadata + header.entryOffset), importData) != 0 ||
+        writeMeshCacheMaterials(&writer, (MeshCacheMaterial*)(metadata + header.materialOffset), importData) != 0 ||
+        writeMeshCacheTextures(&writer, (MeshCacheTexture*)(metadata + header.textureOffset), importData) != 0 ||
+        writer.strings.size > UINT32_MAX) {
+        LOG_TRACE("Skipping mesh cache for %s", resolvedPath);
+        goto store_done;
+    }
+
+    header.stringSize = (uint32_t)writer.strings.size;
+    header.stringOffset = appendMeshCachePayload(&writer, writer.strings.data, writer.strings.size);
+    header.fileSize = writer.fileSize;
+    memcpy(metadata, &header, sizeof(header));
+
+    if (writeFileSpansReplacing(path, writer.spans, writer.spanCount) != 0) {
+        LOG_ERROR("Failed to write mesh cache: %s", path);
+        goto store_done;
+    }
+
+    LOG_TRACE(
+        "Mesh cache saved (%llu bytes) to %s in %.3f ms",
+        (unsigned long long)header.fileSize,
+        path,
+        (double)(getMicroseconds() - startTime) / 1e3
+    );
+    result = 0;
+
+store_done:
+    free(writer.strings.data);
+    free(writer.spans);
+    free(metadata);
+    return result;
+}
+
+static int meshCacheSectionValid(const MeshCacheView* view, uint64_t offset, uint64_t count, size_t stride) {
+    return offset % K_MESH_CACHE_ALIGNMENT == 0u && offset <= view->size && count <= (view->size - offset) / stride;
+}
+
+static int readMeshCacheHeader(MeshCacheView* view, const MeshImportOptions* options) {
+    if (view->size < sizeof(MeshCacheHeader)) return 0;
+    memcpy(&view->header, view->bytes, sizeof(view->header));
+
+    const MeshCacheHeader* header = &view->header;
+    float weldEpsilon = options->optimizeGeometry ? options->weldEpsilon : 0.0f;
+    if (header->magic != K_MESH_CACHE_FILE_MAGIC || header->version != K_MESH_CACHE_FILE_VERSION ||
+        header->vertexSize != sizeof(Vertex) || header->materialSize != sizeof(Material) ||
+        header->optimizeGeometry != options->optimizeGeometry || header->weldEpsilon != weldEpsilon ||
+        header->fileSize != view->size || header->dependencyCount == 0u ||
+        !meshCacheSectionValid(view, header->dependencyOffset, header->dependencyCount, sizeof(MeshCacheDependency)) ||
+        !meshCacheSectionValid(view, header->nodeOffset, header->nodeCount, sizeof(MeshCacheNode)) ||
+        !meshCacheSectionValid(view, header->entryOffset, header->entryCount, sizeof(MeshCacheEntry)) ||
+        !meshCacheSectionValid(view, header->materialOffset, header->materialCount, sizeof(MeshCacheMaterial)) ||
+        !meshCacheSectionValid(view, header->textureOffset, header->textureCount, sizeof(MeshCacheTexture)) ||
+        !meshCacheSectionValid(view, header->stringOffset, header->stringSize, 1u)) {
+        return 0;
+    }
+
+    view->strings = (const char*)(view->bytes + header->stringOffset);
+    return 1;
+}
+
+static int readMeshCacheString(const MeshCacheView* view, MeshCacheString string, const char** outValue) {
+    *outValue = NULL;
+    if (string.offset == kMeshCacheNoString) return 1;
+    if (string.offset >= view->header.stringSize || string.length >= view->header.stringSize - string.offset ||
+        view->strings[string.offset + string.length] != '\0') {
+        return 0;
+    }
+
+    *outValue = view->strings + string.offset;
+    return 1;
+}
+
+static int duplicateMeshCacheString(const MeshCacheView* view, MeshCacheString string, char** outValue) {
+    const char* value = NULL;
+    *outValue = NULL;
+    if (!readMeshCacheString(view, string, &value)) return 0;
+    if (!value) return 1;
+
+    *outValue = stringDuplicate(value);
+    return *outValue != NULL;
+}
+
+static int meshCacheDependenciesCurrent(const MeshCacheView* view, const char* resolvedPath) {
+    const MeshCacheDependency* records = (const MeshCacheDependency*)(view->bytes + view->header.dependencyOffset);
+    for (uint32_t dependencyIndex = 0u; dependencyIndex < view->header.dependencyCount; dependencyIndex++) {
+        const MeshCacheDependency* record = &records[dependencyIndex];
+        const char* path = NULL;
+        if (!readMeshCacheString(view, record->path, &path) || !path) return 0;
+        if (dependencyIndex == 0u && strcmp(path, resolvedPath) != 0) return 0;
+
+        VKRT_FileStamp stamp = {0};
+        if (queryFileStamp(path, &stamp) != 0 || stamp.size != record->stamp.size ||
+            stamp.modifiedTime != record->stamp.modifiedTime) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int openMeshCache(
+    const char* resolvedPath,
+    const MeshImportOptions* options,
+    VKRT_MappedFile* outFile,
+    MeshCacheView* outView
+) {
+    char path[VKRT_PATH_MAX];
+    if (resolveMeshCachePath(resolvedPath, path, sizeof(path)) != 0) return 0;
+    if (mapFile(path, VKRT_FILE_ACCESS_SEQUENTIAL, outFile) != 0) return 0;
+
+    *outView = (MeshCacheView){.bytes = (uint8_t*)outFile->data, .size = outFile->size};
+    if (!readMeshCacheHeader(outView, options) || !meshCacheDependenciesCurrent(outView, resolvedPath)) {
+        LOG_TRACE("Ignoring stale mesh cache %s", path);
+        unmapFile(outFile);
+        return 0;
+    }
+    return 1;
+}
+
+static int loadMeshCacheNodes(const MeshCacheView* view, MeshImportData* importData) {
+    uint32_t nodeCount = view->header.nodeCount;
+    if (nodeCount == 0u) return 1;
+
+    importData->nodes = (NodeImportEntry*)calloc(nodeCount, sizeof(NodeImportEntry));
+    if (!importData->nodes) return 0;
+    importData->nodeCapacity = nodeCount;
+
+    const MeshCacheNode* records = (const MeshCacheNode*)(view->bytes + view->header.nodeOffset);
+    for (uint32_t nodeIndex = 0u; nodeIndex < nodeCount; nodeIndex++) {
+        const MeshCacheNode* record = &records[nodeIndex];
+        NodeImportEntry* node = &importData->nodes[nodeIndex];
+        // Nodes are written parents first, and the importer relies on that to create scene objects in order.
+        if (record->parentIndex != VKRT_INVALID_INDEX && record->parentIndex >= nodeIndex) return 0;
+        if (!duplicateMeshCacheString(view, record->name, &node->name)) return 0;
+        memcpy(node->localTransform, record->localTransform, sizeof(record->localTransform));
+        memcpy(node->position, record->position, sizeof(node->position));
+        memcpy(node->rotation, record->rotation, sizeof(node->rotation));
+        memcpy(node->scale, record->scale, sizeof(node->scale));
+        node->parentIndex = record->parentIndex;
+        node->meshEntryCount = record->meshEntryCount;
+        importData->nodeCount++;
+    }
+    return 1;
+}
+
+static int meshCacheIndicesValid(const MeshCacheView* view, const MeshCacheEntry* record) {
+    if (record->indexCount % 3u != 0u) return 0;
+
+    const uint32_t* indices = (const uint32_t*)(view->bytes + record->indexOffset);
+    for (uint64_t i = 0u; i < record->indexCount; i++) {
+        if (indices[i] >= record->vertexCount) return 0;
+    }
+    return 1;
+}
+
+static int loadMeshCacheEntries(const MeshCacheView* view, MeshImportData* importData) {
+    uint32_t entryCount = view->header.entryCount;
+    if (entryCount == 0u) return 0;
+
+    importData->entries = (MeshImportEntry*)calloc(entryCount, sizeof(MeshImportEntry));
+    if (!importData->entries) return 0;
+    importData->entryCapacity = entryCount;
+
+    const MeshCacheEntry* records = (const MeshCacheEntry*)(view->bytes + view->header.entryOffset);
+    for (uint32_t entryIndex = 0u; entryIndex < entryCount; entryIndex++) {
+        const MeshCacheEntry* record = &records[entryIndex];
+        MeshImportEntry* entry = &importData->entries[entryIndex];
+        if (record->nodeIndex >= view->header.nodeCount ||
+            (record->materialIndex != VKRT_INVALID_INDEX && record->materialIndex >= view->header.materialCount) ||
+            !meshCacheSectionValid(view, record->vertexOffset, record->vertexCount, sizeof(Vertex)) ||
+            !meshCacheSectionValid(view, record->indexOffset, record->indexCount, sizeof(uint32_t)) ||
+            !meshCacheIndicesValid(view, record) || !duplicateMeshCacheString(view, record->name, &entry->name)) {
+            return 0;
+        }
+
+        entry->vertices = (Vertex*)(view->bytes + record->vertexOffset);
+        entry->indices = (uint32_t*)(view->bytes + record->indexOffset);
+        entry->vertexCount = (size_t)record->vertexCount;
+        entry->indexCount = (size_t)record->indexCount;
+        entry->nodeIndex = record->nodeIndex;
+        entry->materialIndex = record->materialIndex;
+        entry->renderBackfaces = (uint8_t)record->renderBackfaces;
+        memcpy(entry->position, record->position, sizeof(entry->position));
+        memcpy(entry->rotation, record->rotation, sizeof(entry->rotation));
+        memcpy(entry->scale, record->scale, sizeof(entry->scale));
+        importData->count++;
+    }
+    return 1;
+}
+
+static int loadMeshCacheMaterials(const MeshCacheView* view, MeshImportData* importData) {
+    uint32_t materialCount = view->header.materialCount;
+    if (materialCount == 0u) return 1;
+
+    importData->materials = (MaterialImportEntry*)calloc(materialCount, sizeof(MaterialImportEntry));
+    if (!importData->materials) return 0;
+
+    const MeshCacheMaterial* records = (const MeshCacheMaterial*)(view->bytes + view->header.materialOffset);
+    for (uint32_t materialIndex = 0u; materialIndex < materialCount; materialIndex++) {
+        MaterialImportEntry* material = &importData->materials[materialIndex];
+        if (!duplicateMeshCacheString(view, records[materialIndex].name, &material->name)) return 0;
+        material->material = records[materialIndex].material;
+        importData->materialCount++;
+    }
+    return 1;
+}
+
+static int loadMeshCacheTextures(const MeshCacheView* view, MeshImportData* importData) {
+    uint32_t textureCount = view->header.textureCount;
+    if (textureCount == 0u) return 1;
+
+    importData->textures = (TextureImportEntry*)calloc(textureCount, sizeof(TextureImportEntry));
+    if (!importData->textures) return 0;
+    importData->textureCapacity = textureCount;
+
+    const MeshCacheTexture* records = (const MeshCacheTexture*)(view->bytes + view->header.textureOffset);
+    for (uint32_t textureIndex = 0u; textureIndex < textureCount; textureIndex++) {
+        const MeshCacheTexture* record = &records[textureIndex];
+        TextureImportEntry* texture = &importData->textures[textureIndex];
+        *texture = (TextureImportEntry){
+            .width = record->width,
+            .height = record->height,
+            .format = record->format,
+            .colorSpace = record->colorSpace,
+            .mipLevelCount = record->mipLevelCount,
+        };
+        for (uint32_t level = 0u; level < VKRT_TEXTURE_MAX_MIP_LEVELS; level++) {
+            if (record->mipLevelOffsets[level] > SIZE_MAX) return 0;
+            texture->mipLevelOffsets[level] = (size_t)record->mipLevelOffsets[level];
+        }
+
+        size_t payloadSize = 0u;
+        if (!meshCacheSectionValid(view, record->pixelOffset, record->byteSize, 1u) ||
+            queryTexturePayloadSize(texture, &payloadSize) != 0 || payloadSize > record->byteSize ||
+            !duplicateMeshCacheString(view, record->name, &texture->name)) {
+            return 0;
+        }
+
+        texture->pixels = view->bytes + record->pixelOffset;
+        importData->textureCount++;
+    }
+    return 1;
+}
+
+int meshCacheIsCurrent(const char* resolvedPath, const MeshImportOptions* options) {
+    if (!resolvedPath || !resolvedPath[0] || !options) return 0;
+
+    VKRT_MappedFile file = {0};
+    MeshCacheView view = {0};
+    if (!openMeshCache(resolvedPath, options, &file, &view)) return 0;
+    unmapFile(&file);
+    return 1;
+}
+
+// On a hit the vertex, index and texel arrays point into the mapped cache until meshReleaseImportData.
+int meshCacheLoad(const char* resolvedPath, const MeshImportOptions* options, MeshImportData* outImportData) {
+    if (!resolvedPath || !resolvedPath[0] || !options || !outImportData) return 0;
+    *outImportData = (MeshImportData){0};
+
+    uint64_t startTime = getMicroseconds();
+    VKRT_MappedFile file = {0};
+    MeshCacheView view = {0};
+    if (!openMeshCache(resolvedPath, options, &file, &view)) return 0;
+
+    outImportData->cacheStorage = file;
+    if (!loadMeshCacheNodes(&view, outImportData) || !loadMeshCacheEntries(&view, outImportData) ||
+        !loadMeshCacheMaterials(&view, outImportData) || !loadMeshCacheTextures(&view, outImportData)) {
+        LOG_TRACE("Ignoring malformed mesh cache for %s", resolvedPath);
+        meshReleaseImportData(outImportData);
+        return 0;
+    }
+
+    LOG_TRACE(
+        "Mesh cache loaded. File: %s, Meshes: %u, Materials: %u, Textures: %u, Time: %.3f ms",
+        resolvedPath,
+        outImportData->count,
+        outImportData->materialCount,
+        outImportData->textureCount,
+        (double)(getMicroseconds() - startTime) / 1e3
+    );
+    return 1;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "loader.h"
+
+#include <stdint.h>
+
+int meshCacheLoad(const char* resolvedPath, const MeshImportOptions* options, MeshImportData* outImportData);
+int meshCacheIsCurrent(const char* resolvedPath, const MeshImportOptions* options);
+int meshCacheStore(
+    const char* resolvedPath,
+    const MeshImportOptions* options,
+    const char* const* dependencyPaths,
+    uint32_t dependencyCount,
+    const MeshImportData* importData
+);
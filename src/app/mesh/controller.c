@@ -3,6 +3,7 @@
 #include "constants.h"
 #include "debug.h"
 #include "loader.h"
+#include "platform.h"
 #include "session.h"
 #include "vkrt.h"
 #include "vkrt_types.h"
@@ -12,6 +13,49 @@
 #include <string.h>
 #include <types.h>
 
+static const uint32_t kMeshImportCommitTexturesPerFrame = 4u;
+static const size_t kMeshImportCommitBytesPerFrame = (size_t)64u * 1024u * 1024u;
+
+typedef enum MeshImportCommitStage {
+    MESH_IMPORT_COMMIT_STAGE_TEXTURES = 0,
+    MESH_IMPORT_COMMIT_STAGE_MATERIALS,
+    MESH_IMPORT_COMMIT_STAGE_NODES,
+    MESH_IMPORT_COMMIT_STAGE_MESHES,
+    MESH_IMPORT_COMMIT_STAGE_FINALIZE,
+} MeshImportCommitStage;
+
+typedef struct MeshImportCommit {
+    MeshImportData importData;
+    const char* path;
+    const char* importName;
+    uint32_t* importedTextureIndices;
+    uint32_t* importedMaterialIndices;
+    uint32_t* nodeObjectIndices;
+    uint32_t meshCountBeforeImport;
+    uint32_t materialCountBeforeImport;
+    uint32_t textureCountBeforeImport;
+    uint32_t objectCountBeforeImport;
+    uint32_t textureRecordCountBeforeImport;
+    uint32_t nextTextureIndex;
+    uint32_t nextEntryIndex;
+    uint32_t configuredMeshCount;
+    MeshImportCommitStage stage;
+} MeshImportCommit;
+
+// Decode runs on its own thread; everything after it happens on the main loop, a bounded batch per frame.
+struct MeshImportTask {
+    VKRT_Thread thread;
+    VKRT_Mutex mutex;
+    char* path;
+    MeshImportData decodedData;
+    int decodeResult;
+    uint8_t decodeFinished;
+    uint8_t threadJoined;
+    uint8_t cancelled;
+    uint8_t committing;
+    MeshImportCommit commit;
+};
+
 static uint32_t colorSpaceForTextureSlot(uint32_t textureSlot) {
     switch (textureSlot) {
         case VKRT_MATERIAL_TEXTURE_SLOT_BASE_COLOR:
@@ -241,6 +285,8 @@ static int attachImportedMeshesToSceneObjects(
     Session* session,
     const MeshImportData* importData,
     uint32_t meshIndexBase,
+    uint32_t firstEntryIndex,
+    uint32_t entryCount,
     const char* importName,
     const uint32_t* nodeObjectIndices
 ) {
@@ -248,7 +294,7 @@ static int attachImportedMeshesToSceneObjects(
 
     const vec3 zero = {0.0f, 0.0f, 0.0f};
     const vec3 one = {1.0f, 1.0f, 1.0f};
-    for (uint32_t entryIndex = 0u; entryIndex < importData->count; entryIndex++) {
+    for (uint32_t entryIndex = firstEntryIndex; entryIndex < firstEntryIndex + entryCount; entryIndex++) {
         const MeshImportEntry* entry = &importData->entries[entryIndex];
         uint32_t meshIndex = meshIndexBase + entryIndex;
         uint32_t nodeIndex = entry->nodeIndex;
@@ -293,31 +339,6 @@ static int attachImportedMeshesToSceneObjects(
     return sessionSyncSceneObjectTransforms(vkrt, session);
 }
 
-static int buildImportedSceneObjects(
-    VKRT* vkrt,
-    Session* session,
-    const MeshImportData* importData,
-    uint32_t meshIndexBase,
-    const char* importName
-) {
-    if (!vkrt || !session || !importData) return 0;
-
-    uint32_t* nodeObjectIndices =
-        importData->nodeCount > 0 ? (uint32_t*)malloc(importData->nodeCount * sizeof(uint32_t)) : NULL;
-    if (importData->nodeCount > 0 && !nodeObjectIndices) {
-        return 0;
-    }
-
-    if (!createImportedNodeObjects(session, importData, nodeObjectIndices) ||
-        !attachImportedMeshesToSceneObjects(vkrt, session, importData, meshIndexBase, importName, nodeObjectIndices)) {
-        free(nodeObjectIndices);
-        return 0;
-    }
-
-    free(nodeObjectIndices);
-    return 1;
-}
-
 static int allocateImportedIndexMaps(
     const MeshImportData* importData,
     uint32_t** outImportedTextureIndices,
@@ -350,48 +371,61 @@ static int allocateImportedIndexMaps(
     return 1;
 }
 
-static int uploadImportedMeshGeometry(VKRT* vkrt, const MeshImportData* importData) {
+static int uploadImportedMeshGeometry(
+    VKRT* vkrt,
+    const MeshImportData* importData,
+    uint32_t firstEntryIndex,
+    uint32_t entryCount
+) {
     if (!vkrt || !importData) return 0;
-    if (importData->count == 0u) return 1;
+    if (entryCount == 0u) return 1;
 
-    VKRT_MeshUpload* uploads = (VKRT_MeshUpload*)calloc(importData->count, sizeof(VKRT_MeshUpload));
+    VKRT_MeshUpload* uploads = (VKRT_MeshUpload*)calloc(entryCount, sizeof(VKRT_MeshUpload));
     if (!uploads) return 0;
 
-    for (uint32_t entryIndex = 0u; entryIndex < importData->count; entryIndex++) {
-        const MeshImportEntry* entry = &importData->entries[entryIndex];
-        uploads[entryIndex].vertices = entry->vertices;
-        uploads[entryIndex].vertexCount = entry->vertexCount;
-        uploads[entryIndex].indices = entry->indices;
-        uploads[entryIndex].indexCount = entry->indexCount;
+    for (uint32_t uploadIndex = 0u; uploadIndex < entryCount; uploadIndex++) {
+        const MeshImportEntry* entry = &importData->entries[firstEntryIndex + uploadIndex];
+        uploads[uploadIndex].vertices = entry->vertices;
+        uploads[uploadIndex].vertexCount = entry->vertexCount;
+        uploads[uploadIndex].indices = entry->indices;
+        uploads[uploadIndex].indexCount = entry->indexCount;
     }
 
-    VKRT_Result result = VKRT_uploadMeshDataBatch(vkrt, uploads, importData->count);
+    VKRT_Result result = VKRT_uploadMeshDataBatch(vkrt, uploads, entryCount);
     free(uploads);
     return result == VKRT_SUCCESS;
 }
 
-static int uploadImportedTextures(VKRT* vkrt, const MeshImportData* importData, uint32_t* importedTextureIndices) {
+static int uploadImportedTextures(
+    VKRT* vkrt,
+    const MeshImportData* importData,
+    uint32_t firstTextureIndex,
+    uint32_t textureCount,
+    uint32_t* importedTextureIndices
+) {
     if (!vkrt || !importData) return 0;
-    if (importData->textureCount == 0u) return 1;
+    if (textureCount == 0u) return 1;
     if (!importedTextureIndices) return 0;
 
-    VKRT_TextureUpload* textureUploads =
-        (VKRT_TextureUpload*)calloc(importData->textureCount, sizeof(VKRT_TextureUpload));
+    VKRT_TextureUpload* textureUploads = (VKRT_TextureUpload*)calloc(textureCount, sizeof(VKRT_TextureUpload));
     if (!textureUploads) return 0;
 
-    for (uint32_t textureIndex = 0u; textureIndex < importData->textureCount; textureIndex++) {
-        const TextureImportEntry* texture = &importData->textures[textureIndex];
-        textureUploads[textureIndex] = (VKRT_TextureUpload){
+    for (uint32_t uploadIndex = 0u; uploadIndex < textureCount; uploadIndex++) {
+        const TextureImportEntry* texture = &importData->textures[firstTextureIndex + uploadIndex];
+        textureUploads[uploadIndex] = (VKRT_TextureUpload){
             .name = texture->name,
             .pixels = texture->pixels,
             .width = texture->width,
             .height = texture->height,
             .format = texture->format,
             .colorSpace = texture->colorSpace,
+            .mipLevelCount = texture->mipLevelCount,
+            .mipLevelOffsets = texture->mipLevelOffsets,
         };
     }
 
-    VKRT_Result result = VKRT_addTexturesBatch(vkrt, textureUploads, importData->textureCount, importedTextureIndices);
+    VKRT_Result result =
+        VKRT_addTexturesBatch(vkrt, textureUploads, textureCount, &importedTextureIndices[firstTextureIndex]);
     free(textureUploads);
     return result == VKRT_SUCCESS;
 }
@@ -424,16 +458,17 @@ static int configureImportedMeshes(
     const MeshImportData* importData,
     const uint32_t* importedMaterialIndices,
     uint32_t meshCountBeforeImport,
+    uint32_t firstEntryIndex,
+    uint32_t entryCount,
     const char* path,
     const char* importName,
-    uint32_t* outConfiguredMeshCount
+    uint32_t* inOutConfiguredMeshCount
 ) {
-    if (outConfiguredMeshCount) *outConfiguredMeshCount = 0u;
-    if (!vkrt || !importData || !outConfiguredMeshCount) return 0;
+    if (!vkrt || !importData || !inOutConfiguredMeshCount) return 0;
 
-    for (uint32_t entryIndex = 0u; entryIndex < importData->count; entryIndex++) {
+    for (uint32_t entryIndex = firstEntryIndex; entryIndex < firstEntryIndex + entryCount; entryIndex++) {
         const MeshImportEntry* entry = &importData->entries[entryIndex];
-        uint32_t meshIndex = meshCountBeforeImport + *outConfiguredMeshCount;
+        uint32_t meshIndex = meshCountBeforeImport + *inOutConfiguredMeshCount;
 
         VKRT_Result materialResult = VKRT_SUCCESS;
         if (entry->materialIndex != VKRT_INVALID_INDEX) {
@@ -453,27 +488,7 @@ static int configureImportedMeshes(
             LOG_ERROR("Mesh imported but failed to store mesh label. File: %s", meshName);
         }
 
-        (*outConfiguredMeshCount)++;
-    }
-
-    return 1;
-}
-
-static int finalizeImportedAssetRegistration(
-    VKRT* vkrt,
-    Session* session,
-    const MeshImportData* importData,
-    uint32_t meshCountBeforeImport,
-    uint32_t textureRecordCountBeforeImport,
-    uint32_t objectCountBeforeImport,
-    const char* importName
-) {
-    if (!buildImportedSceneObjects(vkrt, session, importData, meshCountBeforeImport, importName)) return 0;
-
-    if (!sessionAppendImportedTextureRecords(session, importData->textureCount)) {
-        sessionTruncateTextureRecords(session, textureRecordCountBeforeImport);
-        rollbackImportedSceneObjects(session, objectCountBeforeImport);
-        return 0;
+        (*inOutConfiguredMeshCount)++;
     }
 
     return 1;
@@ -536,137 +551,377 @@ static int verifyImportedMeshCount(VKRT* vkrt, uint32_t meshCountBeforeImport, c
     return 1;
 }
 
-int meshControllerImportMesh(
+static void releaseMeshImportCommit(MeshImportCommit* commit) {
+    if (!commit) return;
+    cleanupImportedIndexMaps(commit->importedTextureIndices, commit->importedMaterialIndices);
+    free(commit->nodeObjectIndices);
+    meshReleaseImportData(&commit->importData);
+    *commit = (MeshImportCommit){0};
+}
+
+// Takes ownership of the decoded data. Baseline counts are captured here rather than at decode start, since the
+// scene may change while a background decode is still running.
+static int beginMeshImportCommit(
     VKRT* vkrt,
     Session* session,
+    MeshImportData* importData,
     const char* path,
     const char* importName,
-    uint32_t* outMeshIndex
+    MeshImportCommit* outCommit
 ) {
-    if (outMeshIndex) *outMeshIndex = VKRT_INVALID_INDEX;
-    if (!vkrt || !session || !path || !path[0]) return 0;
+    if (!outCommit) return 0;
+    *outCommit = (MeshImportCommit){
+        .path = path,
+        .importName = importName,
+        .stage = MESH_IMPORT_COMMIT_STAGE_TEXTURES,
+    };
+    if (importData) {
+        outCommit->importData = *importData;
+        *importData = (MeshImportData){0};
+    }
+    if (!vkrt || !session || !importData) {
+        releaseMeshImportCommit(outCommit);
+        return 0;
+    }
 
-    uint32_t meshCountBeforeImport = 0;
-    uint32_t materialCountBeforeImport = 0;
-    uint32_t textureCountBeforeImport = 0;
-    uint32_t objectCountBeforeImport = 0u;
-    uint32_t textureRecordCountBeforeImport = 0u;
+    MeshImportData* data = &outCommit->importData;
     if (!queryImportBaselineCounts(
             vkrt,
             session,
-            &meshCountBeforeImport,
-            &materialCountBeforeImport,
-            &textureCountBeforeImport,
-            &objectCountBeforeImport,
-            &textureRecordCountBeforeImport
+            &outCommit->meshCountBeforeImport,
+            &outCommit->materialCountBeforeImport,
+            &outCommit->textureCountBeforeImport,
+            &outCommit->objectCountBeforeImport,
+            &outCommit->textureRecordCountBeforeImport
+        ) ||
+        !allocateImportedIndexMaps(data, &outCommit->importedTextureIndices, &outCommit->importedMaterialIndices)) {
+        releaseMeshImportCommit(outCommit);
+        return 0;
+    }
+
+    if (data->nodeCount > 0u) {
+        outCommit->nodeObjectIndices = (uint32_t*)malloc(data->nodeCount * sizeof(uint32_t));
+        if (!outCommit->nodeObjectIndices) {
+            releaseMeshImportCommit(outCommit);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void rollbackMeshImportCommit(VKRT* vkrt, Session* session, const MeshImportCommit* commit) {
+    if (!commit) return;
+    sessionTruncateTextureRecords(session, commit->textureRecordCountBeforeImport);
+    rollbackFailedImport(
+        vkrt,
+        session,
+        commit->meshCountBeforeImport,
+        commit->materialCountBeforeImport,
+        commit->textureCountBeforeImport,
+        commit->objectCountBeforeImport
+    );
+}
+
+static uint32_t queryMeshImportCommitItemCount(const MeshImportCommit* commit) {
+    const MeshImportData* data = &commit->importData;
+    return data->textureCount + data->materialCount + data->count;
+}
+
+static uint32_t queryMeshImportCommitCompletedItems(const MeshImportCommit* commit) {
+    uint32_t completedItems = commit->nextTextureIndex + commit->nextEntryIndex;
+    if (commit->stage > MESH_IMPORT_COMMIT_STAGE_MATERIALS) completedItems += commit->importData.materialCount;
+    return completedItems;
+}
+
+static uint32_t queryMeshCommitBatchCount(const MeshImportData* importData, uint32_t firstEntryIndex, uint8_t bounded) {
+    uint32_t remainingCount = importData->count - firstEntryIndex;
+    if (!bounded) return remainingCount;
+
+    size_t batchBytes = 0u;
+    uint32_t batchCount = 0u;
+    while (batchCount < remainingCount) {
+        const MeshImportEntry* entry = &importData->entries[firstEntryIndex + batchCount];
+        size_t entryBytes = entry->vertexCount * sizeof(Vertex) + entry->indexCount * sizeof(uint32_t);
+        if (batchCount > 0u && batchBytes + entryBytes > kMeshImportCommitBytesPerFrame) break;
+        batchBytes += entryBytes;
+        batchCount++;
+    }
+    return batchCount;
+}
+
+static int commitImportedMeshBatch(VKRT* vkrt, Session* session, MeshImportCommit* commit, uint8_t bounded) {
+    const MeshImportData* data = &commit->importData;
+    uint32_t firstEntryIndex = commit->nextEntryIndex;
+    uint32_t entryCount = queryMeshCommitBatchCount(data, firstEntryIndex, bounded);
+
+    if (!uploadImportedMeshGeometry(vkrt, data, firstEntryIndex, entryCount)) {
+        LOG_ERROR("Mesh upload failed. File: %s", commit->path);
+        return 0;
+    }
+    if (!configureImportedMeshes(
+            vkrt,
+            data,
+            commit->importedMaterialIndices,
+            commit->meshCountBeforeImport,
+            firstEntryIndex,
+            entryCount,
+            commit->path,
+            commit->importName,
+            &commit->configuredMeshCount
+        ) ||
+        !attachImportedMeshesToSceneObjects(
+            vkrt,
+            session,
+            data,
+            commit->meshCountBeforeImport,
+            firstEntryIndex,
+            entryCount,
+            commit->importName,
+            commit->nodeObjectIndices
         )) {
         return 0;
     }
 
+    commit->nextEntryIndex += entryCount;
+    return 1;
+}
+
+static int finalizeImportedAssetRegistration(VKRT* vkrt, Session* session, const MeshImportCommit* commit) {
+    if (!sessionAppendImportedTextureRecords(session, commit->importData.textureCount) ||
+        !sessionRegisterMeshImportBatch(session, commit->path, commit->configuredMeshCount)) {
+        return 0;
+    }
+    return verifyImportedMeshCount(vkrt, commit->meshCountBeforeImport, commit->path);
+}
+
+// Advances the commit by one stage, or by one bounded batch of textures or meshes. Textures and materials go first
+// so every mesh batch can be bound to its final material as soon as it appears. Returns 1 once the import is
+// registered, 0 while work remains and -1 on failure; the caller owns rollback.
+static int stepMeshImportCommit(VKRT* vkrt, Session* session, MeshImportCommit* commit, uint8_t bounded) {
+    if (!vkrt || !session || !commit) return -1;
+
+    MeshImportData* data = &commit->importData;
+    switch (commit->stage) {
+        case MESH_IMPORT_COMMIT_STAGE_TEXTURES: {
+            uint32_t textureCount = data->textureCount - commit->nextTextureIndex;
+            if (bounded && textureCount > kMeshImportCommitTexturesPerFrame) {
+                textureCount = kMeshImportCommitTexturesPerFrame;
+            }
+            if (!uploadImportedTextures(
+                    vkrt,
+                    data,
+                    commit->nextTextureIndex,
+                    textureCount,
+                    commit->importedTextureIndices
+                )) {
+                LOG_ERROR("Texture import failed. File: %s", commit->path);
+                return -1;
+            }
+            commit->nextTextureIndex += textureCount;
+            if (commit->nextTextureIndex == data->textureCount) commit->stage = MESH_IMPORT_COMMIT_STAGE_MATERIALS;
+            return 0;
+        }
+        case MESH_IMPORT_COMMIT_STAGE_MATERIALS:
+            if (!uploadImportedMaterials(
+                    vkrt,
+                    data,
+                    commit->importedTextureIndices,
+                    commit->importedMaterialIndices
+                )) {
+                LOG_ERROR("Material import failed. File: %s", commit->path);
+                return -1;
+            }
+            commit->stage = MESH_IMPORT_COMMIT_STAGE_NODES;
+            return 0;
+        case MESH_IMPORT_COMMIT_STAGE_NODES:
+            if (!createImportedNodeObjects(session, data, commit->nodeObjectIndices)) return -1;
+            commit->stage = MESH_IMPORT_COMMIT_STAGE_MESHES;
+            return 0;
+        case MESH_IMPORT_COMMIT_STAGE_MESHES:
+            if (!commitImportedMeshBatch(vkrt, session, commit, bounded)) return -1;
+            if (commit->nextEntryIndex == data->count) commit->stage = MESH_IMPORT_COMMIT_STAGE_FINALIZE;
+            return 0;
+        case MESH_IMPORT_COMMIT_STAGE_FINALIZE:
+            return finalizeImportedAssetRegistration(vkrt, session, commit) ? 1 : -1;
+        default:
+            return -1;
+    }
+}
+
+int meshControllerImportMesh(
+    VKRT* vkrt,
+    Session* session,
+    const char* path,
+    const char* importName,
+    uint32_t* outMeshIndex
+) {
+    if (outMeshIndex) *outMeshIndex = VKRT_INVALID_INDEX;
+    if (!vkrt || !session || !path || !path[0]) return 0;
+
     MeshImportData importData = {0};
     if (meshLoadFromFile(path, &importData) != 0) {
         LOG_ERROR("Mesh import failed. File: %s", path);
         return 0;
     }
 
-    uint32_t* importedTextureIndices = NULL;
-    uint32_t* importedMaterialIndices = NULL;
-    if (!allocateImportedIndexMaps(&importData, &importedTextureIndices, &importedMaterialIndices)) {
-        meshReleaseImportData(&importData);
-        return 0;
+    MeshImportCommit commit = {0};
+    if (!beginMeshImportCommit(vkrt, session, &importData, path, importName, &commit)) return 0;
+
+    int result = 0;
+    while (result == 0) {
+        result = stepMeshImportCommit(vkrt, session, &commit, 0u);
     }
 
-    if (!uploadImportedMeshGeometry(vkrt, &importData)) {
-        LOG_ERROR("Mesh upload failed. File: %s", path);
-        rollbackImportedMeshes(vkrt, meshCountBeforeImport);
-        cleanupImportedIndexMaps(importedTextureIndices, importedMaterialIndices);
-        meshReleaseImportData(&importData);
-        return 0;
+    if (result < 0) {
+        rollbackMeshImportCommit(vkrt, session, &commit);
+    } else if (outMeshIndex) {
+        *outMeshIndex = commit.configuredMeshCount > 0u ? commit.meshCountBeforeImport : VKRT_INVALID_INDEX;
     }
+    releaseMeshImportCommit(&commit);
+    return result > 0;
+}
 
-    if (!uploadImportedTextures(vkrt, &importData, importedTextureIndices)) {
-        LOG_ERROR("Texture import failed. File: %s", path);
-        rollbackImportedMeshes(vkrt, meshCountBeforeImport);
-        rollbackImportedTextures(vkrt, textureCountBeforeImport);
-        cleanupImportedIndexMaps(importedTextureIndices, importedMaterialIndices);
-        meshReleaseImportData(&importData);
+static int decodeMeshImportTask(void* userData) {
+    MeshImportTask* task = (MeshImportTask*)userData;
+    if (!task) return -1;
+
+    MeshImportData importData = {0};
+    int result = meshLoadFromFile(task->path, &importData);
+
+    vkrtMutexLock(&task->mutex);
+    task->decodedData = importData;
+    task->decodeResult = result;
+    task->decodeFinished = 1u;
+    vkrtMutexUnlock(&task->mutex);
+    return result;
+}
+
+static void destroyMeshImportTask(Session* session) {
+    MeshImportTask* task = session->runtime.meshImportTask;
+    if (!task) return;
+
+    if (!task->threadJoined) (void)vkrtThreadJoin(task->thread, NULL);
+    releaseMeshImportCommit(&task->commit);
+    meshReleaseImportData(&task->decodedData);
+    vkrtMutexDestroy(&task->mutex);
+    free(task->path);
+    free(task);
+
+    session->runtime.meshImportTask = NULL;
+    sessionSetMeshImportProgress(session, SESSION_MESH_IMPORT_STAGE_IDLE, 0u, 0u);
+}
+
+static int startMeshImportTask(Session* session, char* path) {
+    MeshImportTask* task = (MeshImportTask*)calloc(1u, sizeof(*task));
+    if (!task) return 0;
+    if (vkrtMutexInit(&task->mutex, VKRT_MUTEX_PLAIN) != VKRT_THREAD_SUCCESS) {
+        free(task);
         return 0;
     }
 
-    if (!uploadImportedMaterials(vkrt, &importData, importedTextureIndices, importedMaterialIndices)) {
-        LOG_ERROR("Material import failed. File: %s", path);
-        rollbackImportedMeshes(vkrt, meshCountBeforeImport);
-        rollbackImportedMaterials(vkrt, materialCountBeforeImport);
-        rollbackImportedTextures(vkrt, textureCountBeforeImport);
-        cleanupImportedIndexMaps(importedTextureIndices, importedMaterialIndices);
-        meshReleaseImportData(&importData);
+    task->path = path;
+    if (vkrtThreadCreate(&task->thread, decodeMeshImportTask, task) != VKRT_THREAD_SUCCESS) {
+        vkrtMutexDestroy(&task->mutex);
+        free(task);
         return 0;
     }
 
-    uint32_t configuredMeshCount = 0u;
-    if (!configureImportedMeshes(
-            vkrt,
-            &importData,
-            importedMaterialIndices,
-            meshCountBeforeImport,
-            path,
-            importName,
-            &configuredMeshCount
-        ) ||
-        !finalizeImportedAssetRegistration(
-            vkrt,
-            session,
-            &importData,
-            meshCountBeforeImport,
-            textureRecordCountBeforeImport,
-            objectCountBeforeImport,
-            importName
-        )) {
-        rollbackFailedImport(
-            vkrt,
-            session,
-            meshCountBeforeImport,
-            materialCountBeforeImport,
-            textureCountBeforeImport,
-            objectCountBeforeImport
-        );
-        cleanupImportedIndexMaps(importedTextureIndices, importedMaterialIndices);
-        meshReleaseImportData(&importData);
-        return 0;
+    session->runtime.meshImportTask = task;
+    sessionSetMeshImportProgress(session, SESSION_MESH_IMPORT_STAGE_DECODING, 0u, 0u);
+    return 1;
+}
+
+static int takeDecodedMeshImport(VKRT* vkrt, Session* session, MeshImportTask* task) {
+    vkrtMutexLock(&task->mutex);
+    uint8_t decodeFinished = task->decodeFinished;
+    vkrtMutexUnlock(&task->mutex);
+    if (!decodeFinished) return 0;
+
+    (void)vkrtThreadJoin(task->thread, NULL);
+    task->threadJoined = 1u;
+
+    if (task->cancelled) {
+        LOG_INFO("Mesh import cancelled. File: %s", task->path);
+        return -1;
+    }
+    if (task->decodeResult != 0) {
+        LOG_ERROR("Mesh import failed. File: %s", task->path);
+        return -1;
+    }
+    if (!beginMeshImportCommit(vkrt, session, &task->decodedData, task->path, NULL, &task->commit)) {
+        LOG_ERROR("Mesh import failed. File: %s", task->path);
+        return -1;
     }
 
-    if (!sessionRegisterMeshImportBatch(session, path, configuredMeshCount)) {
-        sessionTruncateTextureRecords(session, textureRecordCountBeforeImport);
-        rollbackFailedImport(
-            vkrt,
+    task->committing = 1u;
+    return 1;
+}
+
+static void updateMeshImportTask(VKRT* vkrt, Session* session) {
+    MeshImportTask* task = session->runtime.meshImportTask;
+    if (!task) return;
+
+    if (!task->committing) {
+        int decodeResult = takeDecodedMeshImport(vkrt, session, task);
+        if (decodeResult < 0) destroyMeshImportTask(session);
+        if (decodeResult <= 0) return;
+    }
+
+    int result = stepMeshImportCommit(vkrt, session, &task->commit, 1u);
+    if (result == 0) {
+        sessionSetMeshImportProgress(
             session,
-            meshCountBeforeImport,
-            materialCountBeforeImport,
-            textureCountBeforeImport,
-            objectCountBeforeImport
+            SESSION_MESH_IMPORT_STAGE_UPLOADING,
+            queryMeshImportCommitCompletedItems(&task->commit),
+            queryMeshImportCommitItemCount(&task->commit)
         );
-        cleanupImportedIndexMaps(importedTextureIndices, importedMaterialIndices);
-        meshReleaseImportData(&importData);
-        return 0;
+        return;
     }
 
-    if (outMeshIndex) *outMeshIndex = configuredMeshCount > 0u ? meshCountBeforeImport : VKRT_INVALID_INDEX;
+    if (result < 0) rollbackMeshImportCommit(vkrt, session, &task->commit);
+    destroyMeshImportTask(session);
+}
 
-    cleanupImportedIndexMaps(importedTextureIndices, importedMaterialIndices);
-    meshReleaseImportData(&importData);
+int meshControllerIsImportCommitting(const Session* session) {
+    return session && session->runtime.meshImportTask && session->runtime.meshImportTask->committing;
+}
 
-    if (!verifyImportedMeshCount(vkrt, meshCountBeforeImport, path)) {
-        rollbackImportedMeshes(vkrt, meshCountBeforeImport);
-        rollbackImportedMaterials(vkrt, materialCountBeforeImport);
-        rollbackImportedTextures(vkrt, textureCountBeforeImport);
-        return 0;
+// A commit in progress is rolled back at once. A decode cannot be interrupted, so it is left to finish in the
+// background and its result is dropped.
+void meshControllerCancelImport(VKRT* vkrt, Session* session) {
+    if (!vkrt || !session || !session->runtime.meshImportTask) return;
+
+    MeshImportTask* task = session->runtime.meshImportTask;
+    if (task->committing) {
+        rollbackMeshImportCommit(vkrt, session, &task->commit);
+        LOG_INFO("Mesh import cancelled. File: %s", task->path);
+        destroyMeshImportTask(session);
+        return;
     }
-    return 1;
+
+    task->cancelled = 1u;
+    sessionSetMeshImportProgress(session, SESSION_MESH_IMPORT_STAGE_CANCELLING, 0u, 0u);
 }
 
+void meshControllerShutdown(Session* session) {
+    if (!session) return;
+    destroyMeshImportTask(session);
+}
+
+static void applyQueuedMeshImportCancel(VKRT* vkrt, Session* session) {
+    if (!sessionTakeMeshImportCancel(session)) return;
+    meshControllerCancelImport(vkrt, session);
+}
+
+// Only one import runs at a time; a newer request stays queued until the current one is committed or dropped.
 static void applyQueuedMeshImport(VKRT* vkrt, Session* session) {
+    if (session->runtime.meshImportTask) return;
+
     char* importPath = NULL;
     if (!sessionTakeMeshImport(session, &importPath)) return;
+    if (startMeshImportTask(session, importPath)) return;
+
+    LOG_INFO("Background mesh import unavailable, importing on the main thread. File: %s", importPath);
     meshControllerImportMesh(vkrt, session, importPath, NULL, NULL);
     free(importPath);
 }
@@ -752,7 +1007,15 @@ static void applyQueuedMeshRemoval(VKRT* vkrt, Session* session) {
 }
 
 void meshControllerApplySessionActions(VKRT* vkrt, Session* session) {
+    if (!vkrt || !session) return;
+
+    applyQueuedMeshImportCancel(vkrt, session);
     applyQueuedMeshImport(vkrt, session);
+    updateMeshImportTask(vkrt, session);
+
+    // Edits that append or remove meshes, materials or textures would shift the indices a committing import rolls
+    // back to, so they stay queued until the commit finishes. Replacing the environment adds and removes textures too.
+    if (meshControllerIsImportCommitting(session)) return;
     applyQueuedTextureImport(vkrt, session);
     applyQueuedEnvironmentImport(vkrt, session);
     applyQueuedEnvironmentClear(vkrt, session);
@@ -10,4 +10,7 @@ int meshControllerImportMesh(
     const char* importName,
     uint32_t* outMeshIndex
 );
+int meshControllerIsImportCommitting(const Session* session);
+void meshControllerCancelImport(VKRT* vkrt, Session* session);
+void meshControllerShutdown(Session* session);
 void meshControllerApplySessionActions(VKRT* vkrt, Session* session);
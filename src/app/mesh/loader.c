@@ -1,10 +1,13 @@
 #include "loader.h"
 
+#include "cache.h"
 #include "cgltf.h"
 #include "constants.h"
 #include "debug.h"
 #include "image.h"
 #include "io.h"
+#include "job_pool.h"
+#include "optimize.h"
 #include "platform.h"
 #include "vkrt.h"
 #include "vkrt_types.h"
@@ -25,8 +28,17 @@ enum {
 };
 
 static const size_t kMeshImportMaxPrimitiveBytes = (size_t)1024u * 1024u * 1024u;
-static const uint32_t kMeshImportTextureDecodeThreadCount = 6u;
 static const float kAlphaBlendMaskCutoff = 1.0f / 255.0f;
+static const MeshImportOptions kDefaultMeshImportOptions = {
+    .optimizeGeometry = 1u,
+    .weldEpsilon = 0.0f,
+};
+
+// Set once from the command line before any import starts; every import takes a snapshot when it begins.
+static MeshImportOptions gMeshImportOptions = {
+    .optimizeGeometry = 1u,
+    .weldEpsilon = 0.0f,
+};
 
 typedef struct MeshImportFeatureReport {
     int unsupportedMaterialTextures;
@@ -43,20 +55,25 @@ typedef struct MeshImportFeatureReport {
 
 typedef struct ImportedTextureReference {
     const cgltf_image* image;
+    const cgltf_image* compressedImage;
     const cgltf_texture* texture;
     uint32_t colorSpace;
 } ImportedTextureReference;
 
-typedef struct TextureDecodeThreadContext {
+typedef struct TextureDecodeJobContext {
     const char* resolvedPath;
     const ImportedTextureReference* references;
     TextureImportEntry* outputs;
-    uint32_t startIndex;
-    uint32_t endIndex;
-    int failed;
-} TextureDecodeThreadContext;
+} TextureDecodeJobContext;
+
+typedef struct GLTFMappedFiles {
+    VKRT_MappedFile* files;
+    uint32_t count;
+    uint32_t capacity;
+} GLTFMappedFiles;
 
 typedef struct MaterialTextureCache {
+    const cgltf_data* data;
     const cgltf_image** images;
     uint32_t* colorSpaces;
     uint32_t* textureIndices;
@@ -113,13 +130,42 @@ static void releaseImportNode(NodeImportEntry* node) {
 static void releaseImportTexture(TextureImportEntry* texture) {
     if (!texture) return;
     free(texture->name);
-    free(texture->pixels);
+    if (texture->mappedStorage.data) {
+        unmapFile(&texture->mappedStorage);
+    } else {
+        free(texture->pixels);
+    }
     memset(texture, 0, sizeof(*texture));
 }
 
+void meshDefaultImportOptions(MeshImportOptions* outOptions) {
+    if (!outOptions) return;
+    *outOptions = kDefaultMeshImportOptions;
+}
+
+void meshSetImportOptions(const MeshImportOptions* options) {
+    gMeshImportOptions = options ? *options : kDefaultMeshImportOptions;
+    if (!(gMeshImportOptions.weldEpsilon > 0.0f)) gMeshImportOptions.weldEpsilon = 0.0f;
+}
+
+void meshGetImportOptions(MeshImportOptions* outOptions) {
+    if (!outOptions) return;
+    *outOptions = gMeshImportOptions;
+}
+
 void meshReleaseImportData(MeshImportData* importData) {
     if (!importData) return;
 
+    if (importData->cacheStorage.data) {
+        for (uint32_t i = 0; i < importData->count; i++) {
+            importData->entries[i].vertices = NULL;
+            importData->entries[i].indices = NULL;
+        }
+        for (uint32_t i = 0; i < importData->textureCount; i++) {
+            importData->textures[i].pixels = NULL;
+        }
+    }
+
     for (uint32_t i = 0; i < importData->count; i++) {
         releaseImportEntry(&importData->entries[i]);
     }
@@ -154,6 +200,8 @@ void meshReleaseImportData(MeshImportData* importData) {
     importData->textures = NULL;
     importData->textureCount = 0;
     importData->textureCapacity = 0;
+
+    unmapFile(&importData->cacheStorage);
 }
 
 static int ensureImportEntryCapacity(MeshImportData* importData, uint32_t additionalCount) {
@@ -274,7 +322,39 @@ static int textureReferenceEqual(
     return reference && reference->image == image && reference->colorSpace == colorSpace;
 }
 
+static const cgltf_image* queryTextureDDSImage(const cgltf_data* data, const cgltf_texture* texture) {
+    if (!data || !texture) return NULL;
+
+    for (cgltf_size i = 0; i < texture->extensions_count; i++) {
+        const cgltf_extension* extension = &texture->extensions[i];
+        if (!extension->name || strcmp(extension->name, "MSFT_texture_dds") != 0 || !extension->data) continue;
+
+        const char* source = strstr(extension->data, "\"source\"");
+        source = source ? strchr(source, ':') : NULL;
+        if (!source) return NULL;
+
+        char* end = NULL;
+        unsigned long imageIndex = strtoul(source + 1, &end, 10);
+        if (end == source + 1 || imageIndex >= data->images_count) return NULL;
+        return &data->images[imageIndex];
+    }
+    return NULL;
+}
+
+// Block-compressed sources (KHR_texture_basisu KTX2, MSFT_texture_dds) are preferred over the core image.
+static const cgltf_image* queryCompressedTextureImage(const cgltf_data* data, const cgltf_texture* texture) {
+    if (!texture) return NULL;
+    if (texture->has_basisu && texture->basisu_image) return texture->basisu_image;
+    return queryTextureDDSImage(data, texture);
+}
+
+static const cgltf_image* queryTextureSourceImage(const cgltf_data* data, const cgltf_texture* texture) {
+    if (!texture) return NULL;
+    return texture->image ? texture->image : queryCompressedTextureImage(data, texture);
+}
+
 static int appendImportedTextureReference(
+    const cgltf_data* data,
     ImportedTextureReference* references,
     uint32_t* inoutReferenceCount,
     const cgltf_texture_view* textureView,
@@ -283,14 +363,14 @@ static int appendImportedTextureReference(
     if (!references || !inoutReferenceCount) {
         return 0;
     }
-    if (!textureView || !textureView->texture || !textureView->texture->image) {
+    if (!textureView || !queryTextureSourceImage(data, textureView->texture)) {
         return 1;
     }
     if (textureViewUsesUnsupportedTransform(textureView)) {
         return 1;
     }
 
-    const cgltf_image* image = textureView->texture->image;
+    const cgltf_image* image = queryTextureSourceImage(data, textureView->texture);
     for (uint32_t i = 0; i < *inoutReferenceCount; i++) {
         if (textureReferenceEqual(&references[i], image, colorSpace)) {
             return 1;
@@ -299,6 +379,7 @@ static int appendImportedTextureReference(
 
     references[*inoutReferenceCount] = (ImportedTextureReference){
         .image = image,
+        .compressedImage = queryCompressedTextureImage(data, textureView->texture),
         .texture = textureView->texture,
         .colorSpace = colorSpace,
     };
@@ -323,6 +404,7 @@ static int collectImportedTextureReferences(
     for (cgltf_size materialIndex = 0; materialIndex < data->materials_count; materialIndex++) {
         const cgltf_material* material = &data->materials[materialIndex];
         if (!appendImportedTextureReference(
+                data,
                 references,
                 outReferenceCount,
                 queryMaterialBaseColorTextureView(material),
@@ -331,6 +413,7 @@ static int collectImportedTextureReferences(
             return 0;
         }
         if (!appendImportedTextureReference(
+                data,
                 references,
                 outReferenceCount,
                 &material->pbr_metallic_roughness.metallic_roughness_texture,
@@ -339,6 +422,7 @@ static int collectImportedTextureReferences(
             return 0;
         }
         if (!appendImportedTextureReference(
+                data,
                 references,
                 outReferenceCount,
                 &material->normal_texture,
@@ -347,6 +431,7 @@ static int collectImportedTextureReferences(
             return 0;
         }
         if (!appendImportedTextureReference(
+                data,
                 references,
                 outReferenceCount,
                 &material->emissive_texture,
@@ -403,12 +488,12 @@ static void copyTextureTransform(float4 outTransform, float* outRotation, const
     }
 }
 
-static int resolveTextureImagePath(const char* resolvedPath, const cgltf_image* image, char outPath[VKRT_PATH_MAX]) {
-    if (!resolvedPath || !image || !image->uri || !image->uri[0] || !outPath) return 0;
-    if (strstr(image->uri, "data:") == image->uri) return 0;
+static int resolveGLTFUriPath(const char* resolvedPath, const char* uri, char outPath[VKRT_PATH_MAX]) {
+    if (!resolvedPath || !uri || !uri[0] || !outPath) return 0;
+    if (strstr(uri, "data:") == uri) return 0;
 
     char decodedUri[VKRT_PATH_MAX];
-    if (snprintf(decodedUri, sizeof(decodedUri), "%s", image->uri) >= (int)sizeof(decodedUri)) {
+    if (snprintf(decodedUri, sizeof(decodedUri), "%s", uri) >= (int)sizeof(decodedUri)) {
         return 0;
     }
     cgltf_decode_uri(decodedUri);
@@ -429,6 +514,10 @@ static int resolveTextureImagePath(const char* resolvedPath, const cgltf_image*
     return resolveExistingPath(combinedPath, outPath, VKRT_PATH_MAX) == 0;
 }
 
+static int resolveTextureImagePath(const char* resolvedPath, const cgltf_image* image, char outPath[VKRT_PATH_MAX]) {
+    return image && resolveGLTFUriPath(resolvedPath, image->uri, outPath);
+}
+
 static int decodeTextureImage(
     const char* resolvedPath,
     const cgltf_image* image,
@@ -469,6 +558,7 @@ static const char* queryImportedTextureName(const cgltf_image* image, const cglt
 static int buildImportedTextureEntry(
     const char* resolvedPath,
     const cgltf_image* image,
+    const cgltf_image* compressedImage,
     const cgltf_texture* texture,
     uint32_t colorSpace,
     TextureImportEntry* outEntry
@@ -477,8 +567,14 @@ static int buildImportedTextureEntry(
     *outEntry = (TextureImportEntry){0};
 
     VKRT_LoadedImage decoded = {0};
-    if (!decodeTextureImage(resolvedPath, image, colorSpace, &decoded)) {
-        return 0;
+    int decodedCompressed = compressedImage && decodeTextureImage(resolvedPath, compressedImage, colorSpace, &decoded);
+    if (!decodedCompressed) {
+        if (compressedImage == image || !decodeTextureImage(resolvedPath, image, colorSpace, &decoded)) {
+            return 0;
+        }
+        if (compressedImage) {
+            LOG_INFO("Using fallback image for texture %s", queryImportedTextureName(image, texture));
+        }
     }
 
     char* duplicatedName = stringDuplicate(queryImportedTextureName(image, texture));
@@ -490,32 +586,32 @@ static int buildImportedTextureEntry(
     *outEntry = (TextureImportEntry){
         .name = duplicatedName,
         .pixels = decoded.pixels,
+        .mappedStorage = decoded.mappedStorage,
         .width = decoded.width,
         .height = decoded.height,
         .format = decoded.format,
         .colorSpace = decoded.colorSpace,
+        .mipLevelCount = decoded.mipLevelCount,
     };
+    memcpy(outEntry->mipLevelOffsets, decoded.mipLevelOffsets, sizeof(outEntry->mipLevelOffsets));
     return 1;
 }
 
-static int decodeTextureReferenceRange(void* userData) {
-    TextureDecodeThreadContext* context = (TextureDecodeThreadContext*)userData;
+static int decodeTextureReferenceJob(void* userData, uint32_t referenceIndex) {
+    TextureDecodeJobContext* context = (TextureDecodeJobContext*)userData;
     if (!context) return -1;
 
-    for (uint32_t i = context->startIndex; i < context->endIndex; i++) {
-        const ImportedTextureReference* reference = &context->references[i];
-        if (!buildImportedTextureEntry(
-                context->resolvedPath,
-                reference->image,
-                reference->texture,
-                reference->colorSpace,
-                &context->outputs[i]
-            )) {
-            context->failed = 1;
-            return -1;
-        }
+    const ImportedTextureReference* reference = &context->references[referenceIndex];
+    if (!buildImportedTextureEntry(
+            context->resolvedPath,
+            reference->image,
+            reference->compressedImage,
+            reference->texture,
+            reference->colorSpace,
+            &context->outputs[referenceIndex]
+        )) {
+        return -1;
     }
-
     return 0;
 }
 
@@ -526,16 +622,6 @@ static void releaseTextureImportEntries(TextureImportEntry* textures, uint32_t t
     }
 }
 
-static void freeTextureDecodeBuffers(
-    TextureDecodeThreadContext* contexts,
-    VKRT_Thread* threads,
-    TextureImportEntry* decodedTextures
-) {
-    free((void*)contexts);
-    free((void*)threads);
-    free((void*)decodedTextures);
-}
-
 static void storeDecodedTextureReferences(
     const ImportedTextureReference* references,
     uint32_t referenceCount,
@@ -576,6 +662,7 @@ static int appendDecodedTextureEntries(
 
 static int decodeImportedTextureReferences(
     MeshImportData* importData,
+    VKRT_JobPool* jobPool,
     const char* resolvedPath,
     const ImportedTextureReference* references,
     uint32_t referenceCount,
@@ -592,49 +679,13 @@ static int decodeImportedTextureReferences(
     TextureImportEntry* decodedTextures = (TextureImportEntry*)calloc(referenceCount, sizeof(*decodedTextures));
     if (!decodedTextures) return 0;
 
-    uint32_t threadCount =
-        referenceCount < kMeshImportTextureDecodeThreadCount ? referenceCount : kMeshImportTextureDecodeThreadCount;
-    TextureDecodeThreadContext* contexts = (TextureDecodeThreadContext*)calloc(threadCount, sizeof(*contexts));
-    VKRT_Thread* threads = (VKRT_Thread*)calloc(threadCount, sizeof(*threads));
-    if (!contexts || !threads) {
-        freeTextureDecodeBuffers(contexts, threads, decodedTextures);
-        return 0;
-    }
-
-    uint32_t chunkSize = (referenceCount + threadCount - 1u) / threadCount;
-    uint32_t launchedThreads = 0u;
-    int failed = 0;
-    for (uint32_t threadIndex = 0; threadIndex < threadCount; threadIndex++) {
-        uint32_t startIndex = threadIndex * chunkSize;
-        uint32_t endIndex = startIndex + chunkSize;
-        if (startIndex >= referenceCount) break;
-        if (endIndex > referenceCount) endIndex = referenceCount;
-
-        contexts[threadIndex] = (TextureDecodeThreadContext){
-            .resolvedPath = resolvedPath,
-            .references = references,
-            .outputs = decodedTextures,
-            .startIndex = startIndex,
-            .endIndex = endIndex,
-            .failed = 0,
-        };
-
-        if (vkrtThreadCreate(&threads[threadIndex], decodeTextureReferenceRange, &contexts[threadIndex]) !=
-            VKRT_THREAD_SUCCESS) {
-            failed = 1;
-            launchedThreads = threadIndex;
-            break;
-        }
-        launchedThreads = threadIndex + 1u;
-    }
-
-    for (uint32_t threadIndex = 0; threadIndex < launchedThreads; threadIndex++) {
-        int threadResult = 0;
-        if (vkrtThreadJoin(threads[threadIndex], &threadResult) != VKRT_THREAD_SUCCESS || threadResult != 0 ||
-            contexts[threadIndex].failed) {
-            failed = 1;
-        }
-    }
+    // Every job writes only its own slot, so textures land in reference order however the pool schedules them.
+    TextureDecodeJobContext context = {
+        .resolvedPath = resolvedPath,
+        .references = references,
+        .outputs = decodedTextures,
+    };
+    int failed = vkrtJobPoolRun(jobPool, referenceCount, decodeTextureReferenceJob, &context) != 0;
 
     if (!failed && !appendDecodedTextureEntries(importData, decodedTextures, referenceCount)) {
         failed = 1;
@@ -655,7 +706,7 @@ static int decodeImportedTextureReferences(
         releaseTextureImportEntries(decodedTextures, referenceCount);
     }
 
-    freeTextureDecodeBuffers(contexts, threads, decodedTextures);
+    free((void*)decodedTextures);
     return failed ? 0 : 1;
 }
 
@@ -708,20 +759,26 @@ static int registerImportedTexture(
     uint32_t* outTextureIndex
 ) {
     if (outTextureIndex) *outTextureIndex = VKRT_INVALID_INDEX;
-    if (!importData || !textureView || !textureView->texture || !textureView->texture->image || !textureCache) {
+    if (!importData || !textureView || !textureCache) {
         return 0;
     }
-    if (textureViewUsesUnsupportedTransform(textureView)) {
+    const cgltf_image* image = queryTextureSourceImage(textureCache->data, textureView->texture);
+    if (!image || textureViewUsesUnsupportedTransform(textureView)) {
         return 0;
     }
-
-    const cgltf_image* image = textureView->texture->image;
     if (findCachedImportedTextureIndex(image, colorSpace, textureCache, outTextureIndex)) {
         return 1;
     }
 
     TextureImportEntry texture = {0};
-    if (!buildImportedTextureEntry(resolvedPath, image, textureView->texture, colorSpace, &texture)) {
+    if (!buildImportedTextureEntry(
+            resolvedPath,
+            image,
+            queryCompressedTextureImage(textureCache->data, textureView->texture),
+            textureView->texture,
+            colorSpace,
+            &texture
+        )) {
         return 0;
     }
     if (appendImportTexture(importData, &texture) != 0) {
@@ -839,7 +896,12 @@ static void releaseImportedMaterials(MaterialImportEntry* materials, cgltf_size
     }
 }
 
-static int populateImportMaterials(const cgltf_data* data, MeshImportData* importData, const char* resolvedPath) {
+static int populateImportMaterials(
+    const cgltf_data* data,
+    MeshImportData* importData,
+    const char* resolvedPath,
+    VKRT_JobPool* jobPool
+) {
     if (!data || !importData) return -1;
     if (data->materials_count == 0) return 0;
     if (data->materials_count > (cgltf_size)VKRT_INVALID_INDEX) return -1;
@@ -866,6 +928,7 @@ static int populateImportMaterials(const cgltf_data* data, MeshImportData* impor
     }
 
     MaterialTextureCache textureCache = {
+        .data = data,
         .images = cachedImages,
         .colorSpaces = cachedColorSpaces,
         .textureIndices = cachedTextureIndices,
@@ -876,6 +939,7 @@ static int populateImportMaterials(const cgltf_data* data, MeshImportData* impor
         if (!collectImportedTextureReferences(data, references, &textureCache.count) ||
             !decodeImportedTextureReferences(
                 importData,
+                jobPool,
                 resolvedPath,
                 references,
                 textureCache.count,
@@ -1995,51 +2059,138 @@ static int buildPrimitiveEntry(
     return 1;
 }
 
-static int appendNodePrimitiveEntries(
-    const cgltf_data* data,
+typedef struct PrimitiveBuildJob {
+    const cgltf_node* node;
+    cgltf_size primitiveIndex;
+    uint32_t nodeIndex;
+    int result;
+    MeshImportEntry entry;
+    MeshOptimizeStats optimizeStats;
+} PrimitiveBuildJob;
+
+typedef struct PrimitiveBuildJobContext {
+    const cgltf_data* data;
+    const MeshImportOptions* options;
+    PrimitiveBuildJob* jobs;
+} PrimitiveBuildJobContext;
+
+static int buildPrimitiveJob(void* userData, uint32_t jobIndex) {
+    PrimitiveBuildJobContext* context = (PrimitiveBuildJobContext*)userData;
+    if (!context) return -1;
+
+    PrimitiveBuildJob* job = &context->jobs[jobIndex];
+    job->result = buildPrimitiveEntry(context->data, job->node, job->node->mesh, job->primitiveIndex, &job->entry);
+    if (job->result <= 0 || !context->options->optimizeGeometry) return job->result < 0 ? -1 : 0;
+
+    if (meshOptimizePrimitive(&job->entry, context->options->weldEpsilon, &job->optimizeStats) != 0) return -1;
+    LOG_TRACE(
+        "Primitive optimized. Mesh: %s, Vertices: %zu -> %zu, Indices: %zu -> %zu",
+        job->entry.name,
+        job->optimizeStats.vertexCountBefore,
+        job->optimizeStats.vertexCountAfter,
+        job->optimizeStats.indexCountBefore,
+        job->optimizeStats.indexCountAfter
+    );
+    return 0;
+}
+
+static void logPrimitiveOptimizeTotals(const PrimitiveBuildJob* jobs, uint32_t jobCount) {
+    MeshOptimizeStats totals = {0};
+    for (uint32_t jobIndex = 0u; jobIndex < jobCount; jobIndex++) {
+        const MeshOptimizeStats* stats = &jobs[jobIndex].optimizeStats;
+        totals.vertexCountBefore += stats->vertexCountBefore;
+        totals.vertexCountAfter += stats->vertexCountAfter;
+        totals.indexCountBefore += stats->indexCountBefore;
+        totals.indexCountAfter += stats->indexCountAfter;
+    }
+    LOG_TRACE(
+        "glTF geometry optimized. Vertices: %zu -> %zu, Indices: %zu -> %zu",
+        totals.vertexCountBefore,
+        totals.vertexCountAfter,
+        totals.indexCountBefore,
+        totals.indexCountAfter
+    );
+}
+
+static int countPrimitiveBuildJobs(const cgltf_data* data, uint32_t* outJobCount) {
+    cgltf_size jobCount = 0u;
+    for (cgltf_size nodeIndex = 0; nodeIndex < data->nodes_count; nodeIndex++) {
+        const cgltf_mesh* mesh = data->nodes[nodeIndex].mesh;
+        if (!mesh) continue;
+        jobCount += mesh->primitives_count;
+        if (jobCount > (cgltf_size)UINT32_MAX) return -1;
+    }
+    *outJobCount = (uint32_t)jobCount;
+    return 0;
+}
+
+static void queueNodePrimitiveJobs(
     const cgltf_node* node,
     uint32_t nodeIndex,
-    MeshImportData* importData
+    PrimitiveBuildJob* jobs,
+    uint32_t jobCapacity,
+    uint32_t* jobCount
 ) {
-    if (!data || !node || !importData) return -1;
-    if (!node->mesh) return 0;
-
+    if (!node->mesh) return;
     for (cgltf_size primitiveIndex = 0; primitiveIndex < node->mesh->primitives_count; primitiveIndex++) {
-        MeshImportEntry entry = {0};
-        int buildResult = buildPrimitiveEntry(data, node, node->mesh, primitiveIndex, &entry);
-        if (buildResult < 0) {
-            releaseImportEntry(&entry);
-            return -1;
-        }
-        if (buildResult == 0) continue;
-
-        entry.nodeIndex = nodeIndex;
-        if (appendImportEntry(importData, &entry) != 0) {
-            releaseImportEntry(&entry);
-            return -1;
-        }
-        importData->nodes[nodeIndex].meshEntryCount++;
+        if (*jobCount >= jobCapacity) return;
+        jobs[(*jobCount)++] = (PrimitiveBuildJob){
+            .node = node,
+            .primitiveIndex = primitiveIndex,
+            .nodeIndex = nodeIndex,
+        };
     }
+}
+
+// Entries are appended in the order the jobs were queued, which is the order the serial walk used to produce.
+static int appendPrimitiveJobEntries(MeshImportData* importData, PrimitiveBuildJob* jobs, uint32_t jobCount) {
+    for (uint32_t jobIndex = 0u; jobIndex < jobCount; jobIndex++) {
+        PrimitiveBuildJob* job = &jobs[jobIndex];
+        if (job->result <= 0) continue;
 
+        job->entry.nodeIndex = job->nodeIndex;
+        if (appendImportEntry(importData, &job->entry) != 0) return -1;
+        job->result = 0;
+        importData->nodes[job->nodeIndex].meshEntryCount++;
+    }
     return 0;
 }
 
+static void releasePrimitiveBuildJobs(PrimitiveBuildJob* jobs, uint32_t jobCount) {
+    if (!jobs) return;
+    for (uint32_t jobIndex = 0u; jobIndex < jobCount; jobIndex++) {
+        if (jobs[jobIndex].result != 0) releaseImportEntry(&jobs[jobIndex].entry);
+    }
+    free((void*)jobs);
+}
+
 static int collectNodeEntries(
     const cgltf_data* data,
     const cgltf_node* const* rootNodes,
     cgltf_size rootNodeCount,
-    MeshImportData* importData
+    const MeshImportOptions* options,
+    MeshImportData* importData,
+    VKRT_JobPool* jobPool
 ) {
-    if (!data || !rootNodes || !importData) return -1;
+    if (!data || !rootNodes || !options || !importData) return -1;
     if (rootNodeCount == 0u) return 0;
 
+    uint32_t jobCapacity = 0u;
+    if (countPrimitiveBuildJobs(data, &jobCapacity) != 0) return -1;
+
     typedef struct NodeStackEntry {
         const cgltf_node* node;
         uint32_t parentNodeIndex;
     } NodeStackEntry;
 
     NodeStackEntry* stack = (NodeStackEntry*)calloc((size_t)data->nodes_count, sizeof(*stack));
-    if (!stack) return -1;
+    PrimitiveBuildJob* jobs = (PrimitiveBuildJob*)calloc(jobCapacity > 0u ? jobCapacity : 1u, sizeof(*jobs));
+    if (!stack || !jobs) {
+        free(stack);
+        free((void*)jobs);
+        return -1;
+    }
+    uint32_t jobCount = 0u;
 
     cgltf_size stackCount = 0u;
     for (cgltf_size rootNodeIndex = rootNodeCount; rootNodeIndex > 0u; rootNodeIndex--) {
@@ -2052,11 +2203,12 @@ static int collectNodeEntries(
     while (stackCount > 0u) {
         NodeStackEntry stackEntry = stack[--stackCount];
         uint32_t nodeIndex = VKRT_INVALID_INDEX;
-        if (appendNodeEntry(importData, stackEntry.node, stackEntry.parentNodeIndex, &nodeIndex) != 0 ||
-            appendNodePrimitiveEntries(data, stackEntry.node, nodeIndex, importData) != 0) {
+        if (appendNodeEntry(importData, stackEntry.node, stackEntry.parentNodeIndex, &nodeIndex) != 0) {
             free(stack);
+            free((void*)jobs);
             return -1;
         }
+        queueNodePrimitiveJobs(stackEntry.node, nodeIndex, jobs, jobCapacity, &jobCount);
 
         for (cgltf_size childIndex = stackEntry.node->children_count; childIndex > 0u; childIndex--) {
             stack[stackCount++] = (NodeStackEntry){
@@ -2067,7 +2219,82 @@ static int collectNodeEntries(
     }
 
     free(stack);
-    return 0;
+
+    // Primitive extraction, including tangent generation and the optimization pass, is independent per primitive;
+    // only the append is serial.
+    PrimitiveBuildJobContext context = {
+        .data = data,
+        .options = options,
+        .jobs = jobs,
+    };
+    int result = vkrtJobPoolRun(jobPool, jobCount, buildPrimitiveJob, &context);
+    if (result == 0 && options->optimizeGeometry) logPrimitiveOptimizeTotals(jobs, jobCount);
+    if (result == 0) result = appendPrimitiveJobEntries(importData, jobs, jobCount);
+    releasePrimitiveBuildJobs(jobs, jobCount);
+    return result;
+}
+
+// cgltf hands file data back by pointer alone, so every view it was given is tracked until it is released.
+static cgltf_result readMappedGLTFFile(
+    const struct cgltf_memory_options* memoryOptions,
+    const struct cgltf_file_options* fileOptions,
+    const char* path,
+    cgltf_size* size,
+    void** data
+) {
+    (void)memoryOptions;
+    GLTFMappedFiles* mappedFiles = fileOptions ? (GLTFMappedFiles*)fileOptions->user_data : NULL;
+    if (!mappedFiles || !path || !data) return cgltf_result_invalid_options;
+
+    if (mappedFiles->count == mappedFiles->capacity) {
+        if (mappedFiles->capacity > UINT32_MAX / 2u) return cgltf_result_out_of_memory;
+        uint32_t nextCapacity = mappedFiles->capacity > 0u ? mappedFiles->capacity * 2u : 8u;
+        VKRT_MappedFile* resized =
+            (VKRT_MappedFile*)realloc(mappedFiles->files, (size_t)nextCapacity * sizeof(VKRT_MappedFile));
+        if (!resized) return cgltf_result_out_of_memory;
+        mappedFiles->files = resized;
+        mappedFiles->capacity = nextCapacity;
+    }
+
+    VKRT_MappedFile file = {0};
+    if (mapFile(path, VKRT_FILE_ACCESS_SEQUENTIAL, &file) != 0) return cgltf_result_file_not_found;
+
+    cgltf_size requestedSize = size ? *size : 0u;
+    if (requestedSize > file.size) {
+        unmapFile(&file);
+        return cgltf_result_io_error;
+    }
+
+    mappedFiles->files[mappedFiles->count++] = file;
+    if (size) *size = requestedSize > 0u ? requestedSize : file.size;
+    *data = file.data;
+    return cgltf_result_success;
+}
+
+static void releaseMappedGLTFFile(
+    const struct cgltf_memory_options* memoryOptions,
+    const struct cgltf_file_options* fileOptions,
+    void* data
+) {
+    (void)memoryOptions;
+    GLTFMappedFiles* mappedFiles = fileOptions ? (GLTFMappedFiles*)fileOptions->user_data : NULL;
+    if (!mappedFiles || !data) return;
+
+    for (uint32_t fileIndex = 0u; fileIndex < mappedFiles->count; fileIndex++) {
+        if (mappedFiles->files[fileIndex].data != data) continue;
+        unmapFile(&mappedFiles->files[fileIndex]);
+        mappedFiles->files[fileIndex] = mappedFiles->files[--mappedFiles->count];
+        return;
+    }
+}
+
+static void releaseGLTFData(cgltf_data* data, GLTFMappedFiles* mappedFiles) {
+    if (data) cgltf_free(data);
+    for (uint32_t fileIndex = 0u; fileIndex < mappedFiles->count; fileIndex++) {
+        unmapFile(&mappedFiles->files[fileIndex]);
+    }
+    free((void*)mappedFiles->files);
+    *mappedFiles = (GLTFMappedFiles){0};
 }
 
 static int parseGLTFFile(const char* resolvedPath, cgltf_options* options, cgltf_data** outData) {
@@ -2084,10 +2311,15 @@ static int parseGLTFFile(const char* resolvedPath, cgltf_options* options, cgltf
     return 0;
 }
 
-static int collectRootNodeEntries(const cgltf_data* data, MeshImportData* importData) {
+static int collectRootNodeEntries(
+    const cgltf_data* data,
+    const MeshImportOptions* options,
+    MeshImportData* importData,
+    VKRT_JobPool* jobPool
+) {
     if (data->scene && data->scene->nodes_count > 0) {
         const cgltf_node* const* sceneRootNodes = (const cgltf_node* const*)data->scene->nodes;
-        return collectNodeEntries(data, sceneRootNodes, data->scene->nodes_count, importData);
+        return collectNodeEntries(data, sceneRootNodes, data->scene->nodes_count, options, importData, jobPool);
     }
 
     const cgltf_node** rootNodes = (const cgltf_node**)calloc(data->nodes_count, sizeof(const cgltf_node*));
@@ -2101,7 +2333,7 @@ static int collectRootNodeEntries(const cgltf_data* data, MeshImportData* import
         rootNodes[rootNodeCount++] = &data->nodes[nodeIndex];
     }
 
-    int result = collectNodeEntries(data, rootNodes, rootNodeCount, importData);
+    int result = collectNodeEntries(data, rootNodes, rootNodeCount, options, importData, jobPool);
     free((void*)rootNodes);
     return result;
 }
@@ -2130,6 +2362,65 @@ static void logMeshImportProgress(const char* resolvedPath, const cgltf_data* da
     );
 }
 
+static int appendGLTFDependencyPath(
+    const char* resolvedPath,
+    const char* uri,
+    char** dependencyPaths,
+    uint32_t* inOutDependencyCount
+) {
+    if (!uri || !uri[0] || strstr(uri, "data:") == uri) return 0;
+
+    char dependencyPath[VKRT_PATH_MAX];
+    if (!resolveGLTFUriPath(resolvedPath, uri, dependencyPath)) return -1;
+
+    char* duplicatedPath = stringDuplicate(dependencyPath);
+    if (!duplicatedPath) return -1;
+    dependencyPaths[(*inOutDependencyCount)++] = duplicatedPath;
+    return 0;
+}
+
+// External buffers and images decide whether the cache is still current along with the glTF itself. An import
+// that could not resolve one of them is left uncached so that it is retried once the file turns up.
+static void storeMeshImportCache(
+    const char* resolvedPath,
+    const MeshImportOptions* options,
+    const cgltf_data* data,
+    const MeshImportData* importData
+) {
+    size_t dependencyCapacity = data->buffers_count + data->images_count;
+    if (dependencyCapacity >= UINT32_MAX) return;
+
+    char** dependencyPaths = (char**)calloc(dependencyCapacity > 0u ? dependencyCapacity : 1u, sizeof(char*));
+    if (!dependencyPaths) return;
+
+    uint32_t dependencyCount = 0u;
+    int resolved = 1;
+    for (cgltf_size bufferIndex = 0; bufferIndex < data->buffers_count && resolved; bufferIndex++) {
+        resolved = appendGLTFDependencyPath(
+                       resolvedPath,
+                       data->buffers[bufferIndex].uri,
+                       dependencyPaths,
+                       &dependencyCount
+                   ) == 0;
+    }
+    for (cgltf_size imageIndex = 0; imageIndex < data->images_count && resolved; imageIndex++) {
+        resolved = appendGLTFDependencyPath(
+                       resolvedPath,
+                       data->images[imageIndex].uri,
+                       dependencyPaths,
+                       &dependencyCount
+                   ) == 0;
+    }
+
+    if (resolved) {
+        (void)meshCacheStore(resolvedPath, options, (const char* const*)dependencyPaths, dependencyCount, importData);
+    }
+    for (uint32_t dependencyIndex = 0u; dependencyIndex < dependencyCount; dependencyIndex++) {
+        free(dependencyPaths[dependencyIndex]);
+    }
+    free((void*)dependencyPaths);
+}
+
 int meshLoadFromFile(const char* filePath, MeshImportData* outImportData) {
     if (!filePath || !filePath[0] || !outImportData) return -1;
 
@@ -2140,40 +2431,53 @@ int meshLoadFromFile(const char* filePath, MeshImportData* outImportData) {
     }
 
     *outImportData = (MeshImportData){0};
+    MeshImportOptions importOptions = {0};
+    meshGetImportOptions(&importOptions);
+    if (meshCacheLoad(resolvedPath, &importOptions, outImportData)) return 0;
 
+    // glTF, GLB and .bin files are mapped rather than read, so buffer data and embedded images are used in place.
+    GLTFMappedFiles mappedFiles = {0};
     cgltf_options options = {0};
+    options.file.read = readMappedGLTFFile;
+    options.file.release = releaseMappedGLTFFile;
+    options.file.user_data = &mappedFiles;
     cgltf_data* data = NULL;
 
     if (parseGLTFFile(resolvedPath, &options, &data) != 0) {
+        releaseGLTFData(NULL, &mappedFiles);
         return -1;
     }
 
     logIgnoredImportFeatures(resolvedPath, data);
-    if (populateImportMaterials(data, outImportData, resolvedPath) != 0) {
-        cgltf_free(data);
+
+    // Without a shared pool every batch runs serially on this thread.
+    VKRT_JobPool* jobPool = vkrtJobPoolShared();
+    if (populateImportMaterials(data, outImportData, resolvedPath, jobPool) != 0) {
+        releaseGLTFData(data, &mappedFiles);
         meshReleaseImportData(outImportData);
         LOG_ERROR("Failed to extract material entries from '%s'", resolvedPath);
         return -1;
     }
 
-    int result = collectRootNodeEntries(data, outImportData);
+    int result = collectRootNodeEntries(data, &importOptions, outImportData, jobPool);
 
     if (result != 0) {
-        cgltf_free(data);
+        releaseGLTFData(data, &mappedFiles);
         meshReleaseImportData(outImportData);
         LOG_ERROR("Failed to extract mesh entries from '%s'", resolvedPath);
         return -1;
     }
 
     if (outImportData->count == 0) {
-        cgltf_free(data);
+        releaseGLTFData(data, &mappedFiles);
         meshReleaseImportData(outImportData);
         LOG_ERROR("No triangle mesh primitives were found in '%s'", resolvedPath);
         return -1;
     }
 
     logMeshImportProgress(resolvedPath, data, outImportData);
-    cgltf_free(data);
+    storeMeshImportCache(resolvedPath, &importOptions, data, outImportData);
+    releaseGLTFData(data, &mappedFiles);
 
     return 0;
 }
@@ -1,7 +1,13 @@
 #pragma once
 
+#include "io.h"
 #include "vkrt.h"
 
+typedef struct MeshImportOptions {
+    uint8_t optimizeGeometry;
+    float weldEpsilon;
+} MeshImportOptions;
+
 typedef struct MaterialImportEntry {
     char* name;
     Material material;
@@ -10,10 +16,13 @@ typedef struct MaterialImportEntry {
 typedef struct TextureImportEntry {
     char* name;
     void* pixels;
+    VKRT_MappedFile mappedStorage;
     uint32_t width;
     uint32_t height;
     uint32_t format;
     uint32_t colorSpace;
+    uint32_t mipLevelCount;
+    size_t mipLevelOffsets[VKRT_TEXTURE_MAX_MIP_LEVELS];
 } TextureImportEntry;
 
 typedef struct MeshImportEntry {
@@ -52,7 +61,12 @@ typedef struct MeshImportData {
     TextureImportEntry* textures;
     uint32_t textureCount;
     uint32_t textureCapacity;
+    // Set when the import came from a mesh cache; vertex, index and texel arrays then point into this mapping.
+    VKRT_MappedFile cacheStorage;
 } MeshImportData;
 
+void meshDefaultImportOptions(MeshImportOptions* outOptions);
+void meshSetImportOptions(const MeshImportOptions* options);
+void meshGetImportOptions(MeshImportOptions* outOptions);
 int meshLoadFromFile(const char* filePath, MeshImportData* outImportData);
 void meshReleaseImportData(MeshImportData* importData);
@@ -0,0 +1,354 @@
+#include "optimize.h"
+
+#include "loader.h"
+#include "vkrt.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <types.h>
+
+enum {
+    K_WELD_COMPONENT_COUNT = 20,
+    K_TIPSIFY_CACHE_SIZE = 16,
+};
+
+static const uint32_t kNoVertex = UINT32_MAX;
+static const double kWeldCellLimit = 9.0e18;
+
+typedef struct WeldTable {
+    uint32_t* slots;
+    size_t slotMask;
+    uint32_t* uniqueSources;
+    uint64_t* uniqueHashes;
+    uint32_t uniqueCount;
+} WeldTable;
+
+typedef struct TipsifyState {
+    const uint32_t* indices;
+    uint32_t vertexCount;
+    uint32_t* adjacencyOffsets;
+    uint32_t* adjacency;
+    uint32_t* liveCounts;
+    uint32_t* cacheTimes;
+    uint32_t* deadEnd;
+    size_t deadEndCount;
+    uint8_t* emitted;
+    uint32_t timeStamp;
+    uint32_t cursor;
+} TipsifyState;
+
+static void gatherWeldComponents(const Vertex* vertex, float outComponents[K_WELD_COMPONENT_COUNT]) {
+    memcpy(outComponents, vertex->position, sizeof(float) * 4u);
+    memcpy(outComponents + 4, vertex->normal, sizeof(float) * 4u);
+    memcpy(outComponents + 8, vertex->tangent, sizeof(float) * 4u);
+    memcpy(outComponents + 12, vertex->color, sizeof(float) * 4u);
+    memcpy(outComponents + 16, vertex->texcoord0, sizeof(float) * 2u);
+    memcpy(outComponents + 18, vertex->texcoord1, sizeof(float) * 2u);
+}
+
+static int64_t quantizeWeldComponent(float value, float weldEpsilon) {
+    if (!(weldEpsilon > 0.0f)) {
+        float normalized = value + 0.0f;
+        uint32_t bits = 0u;
+        memcpy(&bits, &normalized, sizeof(bits));
+        return (int64_t)bits;
+    }
+
+    double cell = floor((double)value / (double)weldEpsilon);
+    if (!(cell > -kWeldCellLimit)) cell = -kWeldCellLimit;
+    if (cell > kWeldCellLimit) cell = kWeldCellLimit;
+    return (int64_t)cell;
+}
+
+static uint64_t buildWeldKey(const Vertex* vertex, float weldEpsilon, int64_t outKey[K_WELD_COMPONENT_COUNT]) {
+    float components[K_WELD_COMPONENT_COUNT];
+    gatherWeldComponents(vertex, components);
+
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (uint32_t component = 0u; component < K_WELD_COMPONENT_COUNT; component++) {
+        outKey[component] = quantizeWeldComponent(components[component], weldEpsilon);
+        hash = (hash ^ (uint64_t)outKey[component]) * 0x100000001b3ull;
+    }
+    return hash ^ (hash >> 32u);
+}
+
+static void releaseWeldTable(WeldTable* table) {
+    free(table->slots);
+    free(table->uniqueSources);
+    free(table->uniqueHashes);
+    *table = (WeldTable){0};
+}
+
+static int createWeldTable(size_t vertexCount, WeldTable* outTable) {
+    size_t slotCount = 16u;
+    while (slotCount < vertexCount * 2u) slotCount *= 2u;
+
+    *outTable = (WeldTable){
+        .slots = (uint32_t*)malloc(slotCount * sizeof(uint32_t)),
+        .slotMask = slotCount - 1u,
+        .uniqueSources = (uint32_t*)malloc(vertexCount * sizeof(uint32_t)),
+        .uniqueHashes = (uint64_t*)malloc(vertexCount * sizeof(uint64_t)),
+    };
+    if (!outTable->slots || !outTable->uniqueSources || !outTable->uniqueHashes) {
+        releaseWeldTable(outTable);
+        return -1;
+    }
+    memset(outTable->slots, 0xff, slotCount * sizeof(uint32_t));
+    return 0;
+}
+
+static void weldVertices(const MeshImportEntry* entry, float weldEpsilon, WeldTable* table, uint32_t* outRemap) {
+    int64_t key[K_WELD_COMPONENT_COUNT];
+    int64_t candidateKey[K_WELD_COMPONENT_COUNT];
+
+    for (size_t vertexIndex = 0; vertexIndex < entry->vertexCount; vertexIndex++) {
+        uint64_t hash = buildWeldKey(&entry->vertices[vertexIndex], weldEpsilon, key);
+        size_t slot = (size_t)hash & table->slotMask;
+        for (;;) {
+            uint32_t candidate = table->slots[slot];
+            if (candidate == kNoVertex) {
+                table->slots[slot] = table->uniqueCount;
+                table->uniqueSources[table->uniqueCount] = (uint32_t)vertexIndex;
+                table->uniqueHashes[table->uniqueCount] = hash;
+                outRemap[vertexIndex] = table->uniqueCount++;
+                break;
+            }
+            if (table->uniqueHashes[candidate] == hash) {
+                (void)buildWeldKey(&entry->vertices[table->uniqueSources[candidate]], weldEpsilon, candidateKey);
+                if (memcmp(key, candidateKey, sizeof(key)) == 0) {
+                    outRemap[vertexIndex] = candidate;
+                    break;
+                }
+            }
+            slot = (slot + 1u) & table->slotMask;
+        }
+    }
+}
+
+static size_t remapWeldedTriangles(
+    const uint32_t* indices,
+    size_t indexCount,
+    const uint32_t* remap,
+    uint32_t* outIndices
+) {
+    size_t outIndexCount = 0u;
+    for (size_t indexOffset = 0; indexOffset + 2u < indexCount; indexOffset += 3u) {
+        uint32_t a = remap[indices[indexOffset]];
+        uint32_t b = remap[indices[indexOffset + 1u]];
+        uint32_t c = remap[indices[indexOffset + 2u]];
+        if (a == b || b == c || a == c) continue;
+        outIndices[outIndexCount++] = a;
+        outIndices[outIndexCount++] = b;
+        outIndices[outIndexCount++] = c;
+    }
+    return outIndexCount;
+}
+
+static void releaseTipsifyState(TipsifyState* state) {
+    free(state->adjacencyOffsets);
+    free(state->adjacency);
+    free(state->liveCounts);
+    free(state->cacheTimes);
+    free(state->deadEnd);
+    free(state->emitted);
+    *state = (TipsifyState){0};
+}
+
+static int createTipsifyState(const uint32_t* indices, size_t indexCount, uint32_t vertexCount, TipsifyState* out) {
+    size_t triangleCount = indexCount / 3u;
+    *out = (TipsifyState){
+        .indices = indices,
+        .vertexCount = vertexCount,
+        .adjacencyOffsets = (uint32_t*)calloc((size_t)vertexCount + 1u, sizeof(uint32_t)),
+        .adjacency = (uint32_t*)malloc(indexCount * sizeof(uint32_t)),
+        .liveCounts = (uint32_t*)calloc(vertexCount, sizeof(uint32_t)),
+        .cacheTimes = (uint32_t*)calloc(vertexCount, sizeof(uint32_t)),
+        .deadEnd = (uint32_t*)malloc(indexCount * sizeof(uint32_t)),
+        .emitted = (uint8_t*)calloc(triangleCount, sizeof(uint8_t)),
+        .timeStamp = K_TIPSIFY_CACHE_SIZE + 1u,
+    };
+    if (!out->adjacencyOffsets || !out->adjacency || !out->liveCounts || !out->cacheTimes || !out->deadEnd ||
+        !out->emitted) {
+        releaseTipsifyState(out);
+        return -1;
+    }
+
+    for (size_t indexOffset = 0; indexOffset < indexCount; indexOffset++) {
+        out->liveCounts[indices[indexOffset]]++;
+    }
+    for (uint32_t vertex = 0u; vertex < vertexCount; vertex++) {
+        out->adjacencyOffsets[vertex + 1u] = out->adjacencyOffsets[vertex] + out->liveCounts[vertex];
+    }
+
+    for (size_t indexOffset = 0; indexOffset < indexCount; indexOffset++) {
+        uint32_t vertex = indices[indexOffset];
+        out->adjacency[out->adjacencyOffsets[vertex] + out->cacheTimes[vertex]++] = (uint32_t)(indexOffset / 3u);
+    }
+    memset(out->cacheTimes, 0, (size_t)vertexCount * sizeof(uint32_t));
+    return 0;
+}
+
+static uint32_t selectNextFanningVertex(TipsifyState* state, size_t candidateBegin) {
+    uint32_t bestVertex = kNoVertex;
+    int64_t bestPriority = -1;
+    for (size_t candidate = candidateBegin; candidate < state->deadEndCount; candidate++) {
+        uint32_t vertex = state->deadEnd[candidate];
+        if (state->liveCounts[vertex] == 0u) continue;
+
+        int64_t age = (int64_t)state->timeStamp - (int64_t)state->cacheTimes[vertex];
+        int64_t priority = age + 2 * (int64_t)state->liveCounts[vertex] <= K_TIPSIFY_CACHE_SIZE ? age : 0;
+        if (priority > bestPriority) {
+            bestPriority = priority;
+            bestVertex = vertex;
+        }
+    }
+    if (bestVertex != kNoVertex) return bestVertex;
+
+    while (state->deadEndCount > 0u) {
+        uint32_t vertex = state->deadEnd[--state->deadEndCount];
+        if (state->liveCounts[vertex] > 0u) return vertex;
+    }
+    while (state->cursor < state->vertexCount) {
+        uint32_t vertex = state->cursor++;
+        if (state->liveCounts[vertex] > 0u) return vertex;
+    }
+    return kNoVertex;
+}
+
+static int reorderTrianglesForLocality(uint32_t* indices, size_t indexCount, uint32_t vertexCount) {
+    TipsifyState state = {0};
+    uint32_t* reordered = (uint32_t*)malloc(indexCount * sizeof(uint32_t));
+    if (!reordered || createTipsifyState(indices, indexCount, vertexCount, &state) != 0) {
+        free(reordered);
+        return -1;
+    }
+
+    size_t reorderedCount = 0u;
+    uint32_t fanningVertex = 0u;
+    while (fanningVertex != kNoVertex) {
+        size_t candidateBegin = state.deadEndCount;
+        uint32_t adjacencyEnd = state.adjacencyOffsets[fanningVertex + 1u];
+        for (uint32_t adjacency = state.adjacencyOffsets[fanningVertex]; adjacency < adjacencyEnd; adjacency++) {
+            uint32_t triangle = state.adjacency[adjacency];
+            if (state.emitted[triangle]) continue;
+
+            for (uint32_t corner = 0u; corner < 3u; corner++) {
+                uint32_t vertex = indices[(size_t)triangle * 3u + corner];
+                reordered[reorderedCount++] = vertex;
+                state.deadEnd[state.deadEndCount++] = vertex;
+                state.liveCounts[vertex]--;
+                if (state.timeStamp - state.cacheTimes[vertex] > K_TIPSIFY_CACHE_SIZE) {
+                    state.cacheTimes[vertex] = state.timeStamp++;
+                }
+            }
+            state.emitted[triangle] = 1u;
+        }
+        fanningVertex = selectNextFanningVertex(&state, candidateBegin);
+    }
+
+    memcpy(indices, reordered, indexCount * sizeof(uint32_t));
+    free(reordered);
+    releaseTipsifyState(&state);
+    return 0;
+}
+
+static Vertex* reorderVertexFetch(
+    const Vertex* sourceVertices,
+    const uint32_t* uniqueSources,
+    uint32_t uniqueCount,
+    uint32_t* indices,
+    size_t indexCount,
+    size_t* outVertexCount
+) {
+    uint32_t* fetchRemap = (uint32_t*)malloc((size_t)uniqueCount * sizeof(uint32_t));
+    Vertex* vertices = (Vertex*)malloc((size_t)uniqueCount * sizeof(Vertex));
+    if (!fetchRemap || !vertices) {
+        free(fetchRemap);
+        free(vertices);
+        return NULL;
+    }
+    memset(fetchRemap, 0xff, (size_t)uniqueCount * sizeof(uint32_t));
+
+    uint32_t vertexCount = 0u;
+    for (size_t indexOffset = 0; indexOffset < indexCount; indexOffset++) {
+        uint32_t unique = indices[indexOffset];
+        if (fetchRemap[unique] == kNoVertex) {
+            fetchRemap[unique] = vertexCount;
+            vertices[vertexCount++] = sourceVertices[uniqueSources[unique]];
+        }
+        indices[indexOffset] = fetchRemap[unique];
+    }
+    free(fetchRemap);
+
+    Vertex* shrunk = (Vertex*)realloc(vertices, (size_t)vertexCount * sizeof(Vertex));
+    *outVertexCount = vertexCount;
+    return shrunk ? shrunk : vertices;
+}
+
+// Returns -1 only when an allocation fails; the entry is left unchanged whenever it is not optimized.
+int meshOptimizePrimitive(MeshImportEntry* entry, float weldEpsilon, MeshOptimizeStats* outStats) {
+    if (!entry || !entry->vertices || !entry->indices) return -1;
+
+    MeshOptimizeStats stats = {
+        .vertexCountBefore = entry->vertexCount,
+        .vertexCountAfter = entry->vertexCount,
+        .indexCountBefore = entry->indexCount,
+        .indexCountAfter = entry->indexCount,
+    };
+    if (outStats) *outStats = stats;
+    if (entry->vertexCount == 0u || entry->vertexCount >= kNoVertex || entry->indexCount < 3u ||
+        entry->indexCount % 3u != 0u) {
+        return 0;
+    }
+
+    WeldTable table = {0};
+    uint32_t* remap = (uint32_t*)malloc(entry->vertexCount * sizeof(uint32_t));
+    uint32_t* indices = (uint32_t*)malloc(entry->indexCount * sizeof(uint32_t));
+    if (!remap || !indices || createWeldTable(entry->vertexCount, &table) != 0) {
+        free(remap);
+        free(indices);
+        return -1;
+    }
+
+    weldVertices(entry, weldEpsilon, &table, remap);
+    size_t indexCount = remapWeldedTriangles(entry->indices, entry->indexCount, remap, indices);
+    free(remap);
+    if (indexCount == 0u) {
+        releaseWeldTable(&table);
+        free(indices);
+        return 0;
+    }
+
+    size_t vertexCount = 0u;
+    Vertex* vertices = NULL;
+    if (reorderTrianglesForLocality(indices, indexCount, table.uniqueCount) != 0 ||
+        !(vertices = reorderVertexFetch(
+              entry->vertices,
+              table.uniqueSources,
+              table.uniqueCount,
+              indices,
+              indexCount,
+              &vertexCount
+          ))) {
+        releaseWeldTable(&table);
+        free(indices);
+        return -1;
+    }
+    releaseWeldTable(&table);
+
+    uint32_t* shrunkIndices = (uint32_t*)realloc(indices, indexCount * sizeof(uint32_t));
+    free(entry->vertices);
+    free(entry->indices);
+    entry->vertices = vertices;
+    entry->vertexCount = vertexCount;
+    entry->indices = shrunkIndices ? shrunkIndices : indices;
+    entry->indexCount = indexCount;
+
+    stats.vertexCountAfter = vertexCount;
+    stats.indexCountAfter = indexCount;
+    if (outStats) *outStats = stats;
+    return 0;
+}
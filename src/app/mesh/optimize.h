@@ -0,0 +1,14 @@
+#pragma once
+
+#include "loader.h"
+
+#include <stddef.h>
+
+typedef struct MeshOptimizeStats {
+    size_t vertexCountBefore;
+    size_t vertexCountAfter;
+    size_t indexCountBefore;
+    size_t indexCountAfter;
+} MeshOptimizeStats;
+
+int meshOptimizePrimitive(MeshImportEntry* entry, float weldEpsilon, MeshOptimizeStats* outStats);
@@ -70,8 +70,20 @@ static int lockOfflineRenderSampling(VKRT* vkrt, uint32_t* outSamplesPerFrame) {
     return 1;
 }
 
+static uint8_t offlineRenderUsesTimeOrNoise(const CLIOfflineRenderOptions* options) {
+    return options && (options->noiseThreshold > 0.0f || options->timeLimitSeconds > 0.0f);
+}
+
+static int configureOfflineRenderTermination(VKRT* vkrt, const CLIOfflineRenderOptions* options) {
+    if (!offlineRenderUsesTimeOrNoise(options)) return 1;
+    return VKRT_setNoiseThreshold(vkrt, options->noiseThreshold) == VKRT_SUCCESS &&
+           VKRT_setRenderTermination(vkrt, VKRT_RENDER_TERMINATION_TIME_OR_NOISE, options->timeLimitSeconds) ==
+               VKRT_SUCCESS;
+}
+
 static int beginOfflineRender(VKRT* vkrt, const CLIOfflineRenderOptions* options, OfflineRenderState* state) {
     if (!vkrt || !options || !state) return 0;
+    if (!configureOfflineRenderTermination(vkrt, options)) return 0;
     if (VKRT_startRender(vkrt, options->width, options->height, UINT32_MAX) != VKRT_SUCCESS) {
         return 0;
     }
@@ -136,6 +148,28 @@ static void printOfflineRenderResult(
     );
 }
 
+static void printOfflineRenderMemory(VKRT* vkrt) {
+    VKRT_MemorySnapshot memory = {0};
+    VKRT_RuntimeSnapshot runtime = {0};
+    uint64_t deviceLocalUsedBytes = 0u;
+    const double bytesPerMiB = 1024.0 * 1024.0;
+
+    if (VKRT_getMemorySnapshot(vkrt, &memory) != VKRT_SUCCESS ||
+        VKRT_getRuntimeSnapshot(vkrt, &runtime) != VKRT_SUCCESS) {
+        return;
+    }
+    for (uint32_t i = 0; i < memory.heapCount && i < VKRT_MAX_MEMORY_HEAPS; i++) {
+        if (memory.heaps[i].deviceLocal) deviceLocalUsedBytes += memory.heaps[i].usedBytes;
+    }
+
+    printf(
+        "Offline render memory: %.2f MiB device-local used, %.2f MiB geometry, %.2f MiB BLAS\n",
+        (double)deviceLocalUsedBytes / bytesPerMiB,
+        (double)runtime.geometryHeapUsedBytes / bytesPerMiB,
+        (double)runtime.blasMemoryBytes / bytesPerMiB
+    );
+}
+
 static void queryOfflineRenderDeviceName(VKRT* vkrt, char* outName, size_t outNameSize) {
     VKRT_SystemInfo systemInfo = {0};
     if (!outName || outNameSize == 0u) return;
@@ -196,7 +230,18 @@ static OfflineRenderStepResult finishOfflineRenderIfTargetReached(
 ) {
     uint64_t measuredSamples = 0u;
 
-    if (!state || !options || !status || !state->timingStarted) return OFFLINE_RENDER_STEP_CONTINUE;
+    if (!state || !options || !status) return OFFLINE_RENDER_STEP_CONTINUE;
+    if (offlineRenderUsesTimeOrNoise(options) && VKRT_renderStatusIsComplete(status)) {
+        printf(
+            "Offline render stopped by time/noise limit after %.3f s, %llu samples\n",
+            state->renderStartTimeUs > 0u && nowUs >= state->renderStartTimeUs
+                ? (double)(nowUs - state->renderStartTimeUs) / 1000000.0
+                : 0.0,
+            (unsigned long long)status->totalSamples
+        );
+        return OFFLINE_RENDER_STEP_SUCCESS;
+    }
+    if (!state->timingStarted) return OFFLINE_RENDER_STEP_CONTINUE;
 
     measuredSamples = queryMeasuredSamples(state, status->totalSamples);
     if (measuredSamples >= options->targetSamples) {
@@ -238,7 +283,9 @@ static OfflineRenderStepResult runOfflineRenderIteration(
         return OFFLINE_RENDER_STEP_CONTINUE;
     }
 
-    return finishOfflineRenderIfTargetReached(state, options, &status, nowUs);
+    OfflineRenderStepResult result = finishOfflineRenderIfTargetReached(state, options, &status, nowUs);
+    if (result == OFFLINE_RENDER_STEP_SUCCESS) printOfflineRenderMemory(vkrt);
+    return result;
 }
 
 void offlineRenderPrepareLaunchOptions(CLILaunchOptions* options) {
@@ -4,7 +4,9 @@
 #include "constants.h"
 #include "debug.h"
 #include "io.h"
+#include "mesh/cache.h"
 #include "mesh/controller.h"
+#include "mesh/loader.h"
 #include "platform.h"
 #include "session.h"
 #include "vkrt.h"
@@ -663,6 +665,8 @@ static void remapStandaloneTextureIndices(
 static int clearCurrentScene(VKRT* vkrt, Session* session) {
     if (!vkrt || !session) return 0;
 
+    meshControllerCancelImport(vkrt, session);
+
     uint32_t meshCount = 0u;
     if (VKRT_getMeshCount(vkrt, &meshCount) != VKRT_SUCCESS) return 0;
     for (uint32_t i = meshCount; i > 0u; i--) {
@@ -795,6 +799,9 @@ static int saveSceneSettings(cJSON* sceneRoot, const VKRT_SceneSettingsSnapshot*
     cJSON_AddNumberToObject(settingsObject, "environmentStrength", settings->environmentStrength);
     cJSON_AddNumberToObject(settingsObject, "environmentRotation", settings->environmentRotation);
     cJSON_AddBoolToObject(settingsObject, "misNeeEnabled", settings->misNeeEnabled != 0u);
+    cJSON_AddNumberToObject(settingsObject, "lightSamplingMode", settings->lightSamplingMode);
+    cJSON_AddNumberToObject(settingsObject, "directLightingMode", settings->directLightingMode);
+    cJSON_AddNumberToObject(settingsObject, "samplerMode", settings->samplerMode);
 
     addObjectItem(sceneRoot, "sceneSettings", settingsObject);
     return 1;
@@ -857,6 +864,9 @@ static int applySceneSettings(
     float environmentStrength = settings.environmentStrength;
     float environmentRotation = settings.environmentRotation;
     uint8_t misNeeEnabled = (uint8_t)(settings.misNeeEnabled != 0u);
+    uint32_t lightSamplingMode = settings.lightSamplingMode;
+    uint32_t directLightingMode = settings.directLightingMode;
+    uint32_t samplerMode = settings.samplerMode;
 
     if (!jsonReadOptionalFloatArrayField(cameraObject, "position", cameraPosition, 3u) ||
         !jsonReadOptionalFloatArrayField(cameraObject, "target", cameraTarget, 3u) ||
@@ -872,7 +882,10 @@ static int applySceneSettings(
         !jsonReadOptionalFloatArrayField(settingsObject, "environmentColor", environmentColor, 3u) ||
         !jsonReadOptionalFloatField(settingsObject, "environmentStrength", &environmentStrength) ||
         !jsonReadOptionalFloatField(settingsObject, "environmentRotation", &environmentRotation) ||
-        !jsonReadOptionalBoolField(settingsObject, "misNeeEnabled", &misNeeEnabled)) {
+        !jsonReadOptionalBoolField(settingsObject, "misNeeEnabled", &misNeeEnabled) ||
+        !jsonReadOptionalUInt32Field(settingsObject, "lightSamplingMode", &lightSamplingMode) ||
+        !jsonReadOptionalUInt32Field(settingsObject, "directLightingMode", &directLightingMode) ||
+        !jsonReadOptionalUInt32Field(settingsObject, "samplerMode", &samplerMode)) {
         return 0;
     }
 
@@ -888,6 +901,9 @@ static int applySceneSettings(
            VKRT_setEnvironmentLight(vkrt, environmentColor, environmentStrength) == VKRT_SUCCESS &&
            VKRT_setEnvironmentRotation(vkrt, environmentRotation) == VKRT_SUCCESS &&
            VKRT_setMisNeeEnabled(vkrt, misNeeEnabled ? 1u : 0u) == VKRT_SUCCESS &&
+           VKRT_setLightSamplingMode(vkrt, lightSamplingMode) == VKRT_SUCCESS &&
+           VKRT_setDirectLightingMode(vkrt, directLightingMode) == VKRT_SUCCESS &&
+           VKRT_setSamplerMode(vkrt, samplerMode) == VKRT_SUCCESS &&
            VKRT_cameraSetPose(vkrt, cameraPosition, cameraTarget, cameraUp, vfov) == VKRT_SUCCESS;
 }
 
@@ -1657,6 +1673,62 @@ int sceneControllerLoadSceneFromPath(VKRT* vkrt, Session* session, const char* p
     return 0;
 }
 
+static int prebuildMeshImportCache(const char* resolvedPath) {
+    MeshImportOptions options = {0};
+    meshGetImportOptions(&options);
+    if (meshCacheIsCurrent(resolvedPath, &options)) {
+        LOG_INFO("Mesh cache is current. File: %s", resolvedPath);
+        return 1;
+    }
+
+    MeshImportData importData = {0};
+    if (meshLoadFromFile(resolvedPath, &importData) != 0) return 0;
+    meshReleaseImportData(&importData);
+
+    if (!meshCacheIsCurrent(resolvedPath, &options)) {
+        LOG_ERROR("Mesh cache could not be written. File: %s", resolvedPath);
+        return 0;
+    }
+    LOG_INFO("Mesh cache built. File: %s", resolvedPath);
+    return 1;
+}
+
+// Runs every mesh import of a scene through the importer without creating a renderer, so a later load of the
+// scene finds its mesh caches already current.
+int sceneControllerPrebuildMeshCaches(const char* path) {
+    if (!path || !path[0]) return 0;
+
+    char* jsonText = NULL;
+    if (!readTextFile(path, &jsonText) || !jsonText) {
+        LOG_ERROR("Scene file could not be read: %s", path);
+        return 0;
+    }
+
+    cJSON* root = cJSON_Parse(jsonText);
+    free(jsonText);
+    const cJSON* meshImportsArray = root ? cJSON_GetObjectItemCaseSensitive(root, "meshImports") : NULL;
+    if (!cJSON_IsArray(meshImportsArray)) {
+        LOG_ERROR("Scene file has no mesh imports: %s", path);
+        cJSON_Delete(root);
+        return 0;
+    }
+
+    int succeeded = 1;
+    cJSON* meshImport = NULL;
+    cJSON_ArrayForEach(meshImport, (cJSON*)meshImportsArray) {
+        char resolvedPath[VKRT_PATH_MAX];
+        if (!cJSON_IsString(meshImport) || !resolveSceneAssetPath(path, meshImport->valuestring, resolvedPath)) {
+            LOG_ERROR("Scene mesh import could not be resolved. Scene: %s", path);
+            succeeded = 0;
+            continue;
+        }
+        if (!prebuildMeshImportCache(resolvedPath)) succeeded = 0;
+    }
+
+    cJSON_Delete(root);
+    return succeeded;
+}
+
 int sceneControllerLoadDefaultScene(VKRT* vkrt, Session* session) {
     char resolvedPath[VKRT_PATH_MAX];
     if (resolveExistingPath(kDefaultScenePath, resolvedPath, sizeof(resolvedPath)) != 0) {
@@ -1688,8 +1760,9 @@ void sceneControllerApplySessionActions(VKRT* vkrt, Session* session) {
         free(openScenePath);
     }
 
+    // A half-committed import has no mesh records yet, so saving waits for it to finish.
     char* saveScenePath = NULL;
-    if (sessionTakeSceneSave(session, &saveScenePath)) {
+    if (!meshControllerIsImportCommitting(session) && sessionTakeSceneSave(session, &saveScenePath)) {
         if (!sceneControllerSaveScene(vkrt, session, saveScenePath)) {
             LOG_ERROR("Scene save failed. File: %s", saveScenePath);
         }
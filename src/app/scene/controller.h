@@ -5,6 +5,7 @@
 
 int sceneControllerLoadDefaultScene(VKRT* vkrt, Session* session);
 int sceneControllerLoadSceneFromPath(VKRT* vkrt, Session* session, const char* path);
+int sceneControllerPrebuildMeshCaches(const char* path);
 int sceneControllerLoadStartupScene(
     VKRT* vkrt,
     Session* session,
@@ -435,6 +435,11 @@ void sessionQueueMeshImport(Session* session, const char* path) {
     session->commands.meshImportPath = stringDuplicate(path);
 }
 
+void sessionQueueMeshImportCancel(Session* session) {
+    if (!session) return;
+    session->commands.cancelMeshImportRequested = 1u;
+}
+
 void sessionQueueSceneOpen(Session* session, const char* path) {
     if (!session) return;
 
@@ -504,6 +509,12 @@ int sessionTakeMeshImport(Session* session, char** outPath) {
     return 1;
 }
 
+int sessionTakeMeshImportCancel(Session* session) {
+    if (!session || !session->commands.cancelMeshImportRequested) return 0;
+    session->commands.cancelMeshImportRequested = 0u;
+    return 1;
+}
+
 int sessionTakeSceneOpen(Session* session, char** outPath) {
     if (!session || !session->commands.sceneOpenPath) return 0;
 
@@ -637,6 +648,24 @@ const char* sessionGetEnvironmentTexturePath(const Session* session) {
     return session->editor.environmentTexturePath;
 }
 
+void sessionSetMeshImportProgress(
+    Session* session,
+    SessionMeshImportStage stage,
+    uint32_t completedItems,
+    uint32_t totalItems
+) {
+    if (!session) return;
+    session->runtime.meshImportProgress = (SessionMeshImportProgress){
+        .stage = stage,
+        .completedItems = completedItems,
+        .totalItems = totalItems,
+    };
+}
+
+const SessionMeshImportProgress* sessionGetMeshImportProgress(const Session* session) {
+    return session ? &session->runtime.meshImportProgress : NULL;
+}
+
 uint32_t sessionGetSceneObjectCount(const Session* session) {
     return session ? session->editor.sceneObjectCount : 0u;
 }
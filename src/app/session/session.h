@@ -16,8 +16,16 @@ typedef enum SessionRenderCommand {
     SESSION_RENDER_COMMAND_RESET_ACCUMULATION,
 } SessionRenderCommand;
 
+typedef enum SessionMeshImportStage {
+    SESSION_MESH_IMPORT_STAGE_IDLE = 0,
+    SESSION_MESH_IMPORT_STAGE_DECODING,
+    SESSION_MESH_IMPORT_STAGE_UPLOADING,
+    SESSION_MESH_IMPORT_STAGE_CANCELLING,
+} SessionMeshImportStage;
+
 typedef struct EditorUIState EditorUIState;
 typedef struct DialogState DialogState;
+typedef struct MeshImportTask MeshImportTask;
 
 typedef struct SessionRenderSettings {
     uint32_t width;
@@ -53,6 +61,12 @@ typedef struct SessionSceneObjectCreateInfo {
     const vec3* localScale;
 } SessionSceneObjectCreateInfo;
 
+typedef struct SessionMeshImportProgress {
+    SessionMeshImportStage stage;
+    uint32_t completedItems;
+    uint32_t totalItems;
+} SessionMeshImportProgress;
+
 typedef struct SessionMeshRecord {
     uint32_t importBatchIndex;
     uint32_t importLocalIndex;
@@ -100,6 +114,7 @@ typedef struct SessionCommandQueue {
     char* sceneOpenPath;
     char* sceneSavePath;
     char* meshImportPath;
+    uint8_t cancelMeshImportRequested;
     char* textureImportPath;
     uint32_t textureImportMaterialIndex;
     uint32_t textureImportSlot;
@@ -114,6 +129,8 @@ typedef struct SessionCommandQueue {
 typedef struct SessionRuntimeState {
     SessionRenderTimer renderTimer;
     uint32_t lastSyncedSelectedMeshIndex;
+    MeshImportTask* meshImportTask;
+    SessionMeshImportProgress meshImportProgress;
 } SessionRuntimeState;
 
 typedef struct Session {
@@ -141,6 +158,7 @@ int sessionTakeRenderSaveDialogRequest(Session* session);
 void sessionQueueSceneOpen(Session* session, const char* path);
 void sessionQueueSceneSave(Session* session, const char* path);
 void sessionQueueMeshImport(Session* session, const char* path);
+void sessionQueueMeshImportCancel(Session* session);
 void sessionQueueTextureImport(Session* session, uint32_t materialIndex, uint32_t textureSlot, const char* path);
 void sessionQueueEnvironmentImport(Session* session, const char* path);
 void sessionQueueEnvironmentClear(Session* session);
@@ -150,6 +168,7 @@ int sessionTakeSceneOpen(Session* session, char** outPath);
 int sessionTakeSceneSave(Session* session, char** outPath);
 int sessionTakeSceneObjectRemoval(Session* session, uint32_t* outObjectIndex);
 int sessionTakeMeshImport(Session* session, char** outPath);
+int sessionTakeMeshImportCancel(Session* session);
 int sessionTakeTextureImport(Session* session, uint32_t* outMaterialIndex, uint32_t* outTextureSlot, char** outPath);
 int sessionTakeEnvironmentImport(Session* session, char** outPath);
 int sessionTakeEnvironmentClear(Session* session);
@@ -170,6 +189,13 @@ const char* sessionGetCurrentScenePath(const Session* session);
 void sessionSetEnvironmentTexturePath(Session* session, const char* path);
 void sessionClearEnvironmentTexturePath(Session* session);
 const char* sessionGetEnvironmentTexturePath(const Session* session);
+void sessionSetMeshImportProgress(
+    Session* session,
+    SessionMeshImportStage stage,
+    uint32_t completedItems,
+    uint32_t totalItems
+);
+const SessionMeshImportProgress* sessionGetMeshImportProgress(const Session* session);
 
 uint32_t sessionGetSceneObjectCount(const Session* session);
 const SessionSceneObject* sessionGetSceneObject(const Session* session, uint32_t objectIndex);
@@ -5,6 +5,7 @@ enum {
     VKRT_DEFAULT_HEIGHT = 900u,
     VKRT_MAX_FRAMES_IN_FLIGHT = 2u,
     VKRT_FRAMETIME_HISTORY_SIZE = 128u,
+    VKRT_MAX_MEMORY_HEAPS = 16u,
 };
 
 static const float VKRT_RENDER_VIEW_ZOOM_MIN = 1.0f;
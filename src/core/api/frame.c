@@ -7,6 +7,7 @@
 #include "export.h"
 #include "geometry.h"
 #include "lighting.h"
+#include "platform.h"
 #include "rebuild.h"
 #include "scene.h"
 #include "state.h"
@@ -100,6 +101,8 @@ VKRT_Result VKRT_beginFrame(VKRT* vkrt) {
         return VKRT_ERROR_OPERATION_FAILED;
     }
     resolveAutoExposureReadback(vkrt, vkrt->runtime.currentFrame);
+    resolveAdaptiveSamplingReadback(vkrt, vkrt->runtime.currentFrame);
+    resolveBottomLevelAccelerationStructureCompaction(vkrt, vkrt->runtime.currentFrame);
     resolveCompletedSelection(vkrt);
     vkrtCleanupFrameSceneUpdate(vkrt, vkrt->runtime.currentFrame);
     recordFrameTime(vkrt, vkrt->runtime.currentFrame);
@@ -142,6 +145,7 @@ VKRT_Result VKRT_beginFrame(VKRT* vkrt) {
 
 typedef struct SceneUpdateState {
     VkBool32 materialDirty;
+    VkBool32 materialPatchDirty;
     VkBool32 textureDirty;
     VkBool32 sceneDirty;
     VkBool32 selectionDirty;
@@ -152,8 +156,13 @@ typedef struct SceneUpdateState {
 static void querySceneUpdateState(const VKRT* vkrt, SceneUpdateState* state) {
     if (!vkrt || !state) return;
 
+    VkBool32 materialPatchDirty = vkrt->core.materialDirtyEnd > vkrt->core.materialDirtyBegin;
+    VkBool32 materialDirty = vkrt->core.materialResourceRevision != vkrt->core.materialRevision ||
+                             (materialPatchDirty && !vkrtSceneMaterialBufferPatchable(vkrt));
+
     *state = (SceneUpdateState){
-        .materialDirty = vkrt->core.materialResourceRevision != vkrt->core.materialRevision,
+        .materialDirty = materialDirty,
+        .materialPatchDirty = materialPatchDirty && !materialDirty,
         .textureDirty = vkrt->core.textureResourceRevision != vkrt->core.textureRevision,
         .sceneDirty = vkrt->core.sceneResourceRevision != vkrt->core.sceneRevision,
         .selectionDirty = vkrt->core.selectionResourceRevision != vkrt->core.selectionRevision,
@@ -194,7 +203,11 @@ static VKRT_Result rebuildDirtySceneResources(VKRT* vkrt, SceneUpdateState* stat
         if (result != VKRT_SUCCESS) {
             return result;
         }
-        state->lightsRebuilt = VK_TRUE;
+    } else if (state->materialPatchDirty) {
+        VKRT_Result result = vkrtScenePatchMaterialBuffer(vkrt);
+        if (result != VKRT_SUCCESS) {
+            return result;
+        }
     }
 
     if (state->lightDirty && !state->lightsRebuilt) {
@@ -228,10 +241,15 @@ VKRT_Result VKRT_updateScene(VKRT* vkrt) {
     if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
     if (!vkrt->runtime.frameAcquired && !vkrt->runtime.frameOffscreen) return VKRT_SUCCESS;
 
+    VKRT_Result result = compactBottomLevelAccelerationStructures(vkrt);
+    if (result != VKRT_SUCCESS) {
+        return result;
+    }
+
     SceneUpdateState state = {0};
     querySceneUpdateState(vkrt, &state);
 
-    VKRT_Result result = synchronizeSceneUpdate(vkrt, &state);
+    result = synchronizeSceneUpdate(vkrt, &state);
     if (result != VKRT_SUCCESS) {
         return result;
     }
@@ -240,6 +258,9 @@ VKRT_Result VKRT_updateScene(VKRT* vkrt) {
     if (result != VKRT_SUCCESS) {
         return result;
     }
+    if (state.sceneDirty || state.lightsRebuilt) {
+        invalidateReservoirHistory(vkrt);
+    }
 
     result = vkrtScenePreparePendingGeometryUploads(vkrt);
     if (result != VKRT_SUCCESS) {
@@ -278,18 +299,39 @@ VKRT_Result VKRT_trace(VKRT* vkrt) {
         return result;
     }
 
-    VkSemaphore waitSemaphores[] = {vkrt->runtime.imageAvailableSemaphores[vkrt->runtime.currentFrame]};
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_TRANSFER_BIT};
+    VkSemaphore waitSemaphores[2] = {VK_NULL_HANDLE, VK_NULL_HANDLE};
+    VkPipelineStageFlags waitStages[2] = {0, 0};
+    uint64_t waitValues[2] = {0u, 0u};
+    uint32_t waitSemaphoreCount = 0u;
+    if (!vkrt->runtime.frameOffscreen) {
+        waitSemaphores[waitSemaphoreCount] = vkrt->runtime.imageAvailableSemaphores[vkrt->runtime.currentFrame];
+        waitStages[waitSemaphoreCount++] = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    }
+
+    uint64_t transferWaitValue = vkrt->runtime.transfer.submittedValue;
+    if (transferWaitValue > vkrt->runtime.transfer.graphicsWaitValue) {
+        waitSemaphores[waitSemaphoreCount] = vkrt->runtime.transfer.timeline;
+        waitValues[waitSemaphoreCount] = transferWaitValue;
+        waitStages[waitSemaphoreCount++] = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+    }
+
     VkSemaphore signalSemaphores[] = {VK_NULL_HANDLE};
     if (!vkrt->runtime.frameOffscreen) {
         signalSemaphores[0] = vkrt->runtime.renderFinishedSemaphores[vkrt->runtime.frameImageIndex];
     }
 
+    VkTimelineSemaphoreSubmitInfo timelineSubmitInfo = {
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .waitSemaphoreValueCount = waitSemaphoreCount,
+        .pWaitSemaphoreValues = waitValues,
+    };
+
     VkSubmitInfo submitInfo = {0};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.waitSemaphoreCount = vkrt->runtime.frameOffscreen ? 0u : 1u;
-    submitInfo.pWaitSemaphores = vkrt->runtime.frameOffscreen ? NULL : waitSemaphores;
-    submitInfo.pWaitDstStageMask = vkrt->runtime.frameOffscreen ? NULL : waitStages;
+    submitInfo.pNext = &timelineSubmitInfo;
+    submitInfo.waitSemaphoreCount = waitSemaphoreCount;
+    submitInfo.pWaitSemaphores = waitSemaphoreCount > 0u ? waitSemaphores : NULL;
+    submitInfo.pWaitDstStageMask = waitSemaphoreCount > 0u ? waitStages : NULL;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &vkrt->runtime.commandBuffers[vkrt->runtime.currentFrame];
     submitInfo.signalSemaphoreCount = vkrt->runtime.frameOffscreen ? 0u : 1u;
@@ -309,6 +351,7 @@ VKRT_Result VKRT_trace(VKRT* vkrt) {
         LOG_ERROR("Failed to submit draw queue");
         return result;
     }
+    vkrt->runtime.transfer.graphicsWaitValue = transferWaitValue;
 
     vkrt->core.materialResourceRevision = vkrt->core.materialRevision;
     vkrt->core.textureResourceRevision = vkrt->core.textureRevision;
@@ -367,6 +410,23 @@ VKRT_Result VKRT_present(VKRT* vkrt) {
     return VKRT_SUCCESS;
 }
 
+static VkBool32 renderSamplingTargetReached(const VKRT* vkrt) {
+    if (vkrt->renderStatus.renderTargetSamples > 0 &&
+        vkrt->renderStatus.totalSamples >= vkrt->renderStatus.renderTargetSamples) {
+        return VK_TRUE;
+    }
+
+    const VKRT_AdaptiveSamplingState* adaptive = &vkrt->renderControl.adaptiveSampling;
+    if (adaptive->terminationMode != VKRT_RENDER_TERMINATION_TIME_OR_NOISE) return VK_FALSE;
+    if (adaptiveSamplingConverged(vkrt) && vkrt->renderStatus.totalSamples >= VKRT_ADAPTIVE_MIN_SAMPLES) {
+        return VK_TRUE;
+    }
+    if (adaptive->timeLimitSeconds <= 0.0f) return VK_FALSE;
+
+    uint64_t elapsedMicroseconds = getMicroseconds() - adaptive->renderStartMicroseconds;
+    return (double)elapsedMicroseconds >= (double)adaptive->timeLimitSeconds * 1e6 ? VK_TRUE : VK_FALSE;
+}
+
 VKRT_Result VKRT_endFrame(VKRT* vkrt) {
     if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
 
@@ -382,14 +442,14 @@ VKRT_Result VKRT_endFrame(VKRT* vkrt) {
             vkrt->renderStatus.accumulationFrame++;
             vkrt->renderStatus.totalSamples += renderedSPP;
             vkrt->core.sceneData->frameNumber++;
+            advanceReservoirHistory(vkrt);
 
             uint32_t nextReadIndex = vkrt->core.accumulationWriteIndex;
             vkrt->core.accumulationWriteIndex = vkrt->core.accumulationReadIndex;
             vkrt->core.accumulationReadIndex = nextReadIndex;
         }
 
-        if (VKRT_renderPhaseIsSampling(vkrt->renderStatus.renderPhase) && vkrt->renderStatus.renderTargetSamples > 0 &&
-            vkrt->renderStatus.totalSamples >= vkrt->renderStatus.renderTargetSamples) {
+        if (VKRT_renderPhaseIsSampling(vkrt->renderStatus.renderPhase) && renderSamplingTargetReached(vkrt)) {
             VKRT_stopRenderSampling(vkrt);
         }
     }
@@ -47,3 +47,10 @@ VKRT_Result VKRT_removeMesh(VKRT* vkrt, uint32_t meshIndex) {
     if (meshIndex >= vkrt->core.meshCount) return VKRT_ERROR_INVALID_ARGUMENT;
     return vkrtSceneRemoveMesh(vkrt, meshIndex);
 }
+
+VKRT_Result VKRT_defragmentGeometry(VKRT* vkrt) {
+    if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
+    VKRT_Result stateReady = vkrtRequireSceneStateReady(vkrt);
+    if (stateReady != VKRT_SUCCESS) return stateReady;
+    return vkrtSceneDefragmentGeometry(vkrt);
+}
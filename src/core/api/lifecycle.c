@@ -1,13 +1,19 @@
 #include "GLFW/glfw3.h"
 #include "accel/accel.h"
+#include "allocator.h"
 #include "command/pool.h"
 #include "config.h"
 #include "debug.h"
 #include "descriptor.h"
 #include "device.h"
+#include "environment.h"
 #include "export.h"
+#include "geometry_dedup.h"
+#include "geometry_heap.h"
 #include "images.h"
 #include "instance.h"
+#include "job_pool.h"
+#include "lighting.h"
 #include "pipeline.h"
 #include "platform.h"
 #include "procs.h"
@@ -77,17 +83,14 @@ static void releaseGLFW(void) {
     }
 }
 
-static void destroyBufferAndMemory(VKRT* vkrt, VkBuffer* buffer, VkDeviceMemory* memory) {
+static void destroyBufferAndMemory(VKRT* vkrt, VkBuffer* buffer, MemoryAllocation* memory) {
     if (!vkrt || vkrt->core.device == VK_NULL_HANDLE || !buffer || !memory) return;
 
     if (*buffer != VK_NULL_HANDLE) {
         vkDestroyBuffer(vkrt->core.device, *buffer, NULL);
         *buffer = VK_NULL_HANDLE;
     }
-    if (*memory != VK_NULL_HANDLE) {
-        vkFreeMemory(vkrt->core.device, *memory, NULL);
-        *memory = VK_NULL_HANDLE;
-    }
+    vkrtFreeMemory(vkrt, memory);
 }
 
 static void releaseMeshHostGeometry(VKRT* vkrt) {
@@ -98,6 +101,7 @@ static void releaseMeshHostGeometry(VKRT* vkrt) {
     }
 
     for (uint32_t i = 0; i < vkrt->core.meshCount; i++) {
+        vkrtReleaseEmissiveTriangleCache(&vkrt->core.meshes[i].emissiveCache);
         if (!vkrt->core.meshes[i].ownsGeometry) continue;
         free(vkrt->core.meshes[i].vertices);
         free(vkrt->core.meshes[i].indices);
@@ -119,8 +123,10 @@ static void releaseSceneMaterials(VKRT* vkrt) {
 
 static void releaseGeometryLayout(VKRT* vkrt) {
     if (!vkrt) return;
-    vkrt->core.geometryLayout.vertexCapacity = 0;
-    vkrt->core.geometryLayout.indexCapacity = 0;
+    vkrtGeometryRangeRelease(&vkrt->core.geometryLayout.vertices);
+    vkrtGeometryRangeRelease(&vkrt->core.geometryLayout.indices);
+    vkrt->core.geometryLayout.uploadedBytes = 0;
+    vkrtGeometryDedupRelease(&vkrt->core.geometryDedup);
 }
 
 static void cleanupSwapChainAndStorageResources(VKRT* vkrt) {
@@ -147,10 +153,9 @@ static void cleanupSceneAndAccelerationResources(VKRT* vkrt) {
     if (!vkrt || vkrt->core.device == VK_NULL_HANDLE) return;
 
     for (uint32_t i = 0; i < VKRT_MAX_FRAMES_IN_FLIGHT; i++) {
-        vkrtCleanupFrameSceneUpdate(vkrt, i);
+        vkrtDestroyFrameSceneUpdate(vkrt, i);
     }
-    vkrtDestroyAccelerationStructureResources(vkrt, &vkrt->core.sceneTopLevelAccelerationStructure);
-    vkrtDestroyAccelerationStructureResources(vkrt, &vkrt->core.selectionTopLevelAccelerationStructure);
+    destroyTopLevelAccelerationStructures(vkrt);
     destroyBufferAndMemory(vkrt, &vkrt->core.sceneMeshData.buffer, &vkrt->core.sceneMeshData.memory);
     destroyBufferAndMemory(vkrt, &vkrt->core.sceneMaterialData.buffer, &vkrt->core.sceneMaterialData.memory);
     destroyBufferAndMemory(vkrt, &vkrt->core.sceneEmissiveMeshData.buffer, &vkrt->core.sceneEmissiveMeshData.memory);
@@ -163,8 +168,18 @@ static void cleanupSceneAndAccelerationResources(VKRT* vkrt) {
     destroyBufferAndMemory(vkrt, &vkrt->core.sceneMeshAliasIdx.buffer, &vkrt->core.sceneMeshAliasIdx.memory);
     destroyBufferAndMemory(vkrt, &vkrt->core.sceneTriAliasQ.buffer, &vkrt->core.sceneTriAliasQ.memory);
     destroyBufferAndMemory(vkrt, &vkrt->core.sceneTriAliasIdx.buffer, &vkrt->core.sceneTriAliasIdx.memory);
+    destroyBufferAndMemory(vkrt, &vkrt->core.sceneLightBVHData.buffer, &vkrt->core.sceneLightBVHData.memory);
     destroyBufferAndMemory(vkrt, &vkrt->core.sceneRGB2SpecSRGBData.buffer, &vkrt->core.sceneRGB2SpecSRGBData.memory);
     vkrt->core.rgb2specSRGBInfo = (RGB2SpecTableInfo){0};
+    destroyBufferAndMemory(vkrt, &vkrt->core.sceneSamplerData.buffer, &vkrt->core.sceneSamplerData.memory);
+    destroyBufferAndMemory(vkrt, &vkrt->core.sceneEnvironmentAliasQ.buffer, &vkrt->core.sceneEnvironmentAliasQ.memory);
+    destroyBufferAndMemory(
+        vkrt,
+        &vkrt->core.sceneEnvironmentAliasIdx.buffer,
+        &vkrt->core.sceneEnvironmentAliasIdx.memory
+    );
+    destroyBufferAndMemory(vkrt, &vkrt->core.sceneEnvironmentPmf.buffer, &vkrt->core.sceneEnvironmentPmf.memory);
+    vkrtReleaseEnvironmentDistribution(&vkrt->core.environmentDistribution);
 
     for (uint32_t i = 0; i < vkrt->core.meshCount; i++) {
         if (!vkrt->core.meshes[i].ownsGeometry) continue;
@@ -175,21 +190,17 @@ static void cleanupSceneAndAccelerationResources(VKRT* vkrt) {
     releaseSceneMaterials(vkrt);
     vkrtReleaseSceneTextures(vkrt);
 
+    destroyBufferAndMemory(vkrt, &vkrt->core.positionData.buffer, &vkrt->core.positionData.memory);
     destroyBufferAndMemory(vkrt, &vkrt->core.vertexData.buffer, &vkrt->core.vertexData.memory);
     destroyBufferAndMemory(vkrt, &vkrt->core.indexData.buffer, &vkrt->core.indexData.memory);
     destroyAutoExposureReadbacks(vkrt);
+    destroyAdaptiveSamplingResources(vkrt);
 
-    if (vkrt->core.selectionData && vkrt->core.selection.memory != VK_NULL_HANDLE) {
-        vkUnmapMemory(vkrt->core.device, vkrt->core.selection.memory);
-        vkrt->core.selectionData = NULL;
-    }
+    vkrt->core.selectionData = NULL;
     destroyBufferAndMemory(vkrt, &vkrt->core.selection.buffer, &vkrt->core.selection.memory);
 
     for (uint32_t i = 0; i < VKRT_MAX_FRAMES_IN_FLIGHT; i++) {
-        if (vkrt->core.sceneFrameData[i] && vkrt->core.sceneDataMemories[i] != VK_NULL_HANDLE) {
-            vkUnmapMemory(vkrt->core.device, vkrt->core.sceneDataMemories[i]);
-            vkrt->core.sceneFrameData[i] = NULL;
-        }
+        vkrt->core.sceneFrameData[i] = NULL;
         destroyBufferAndMemory(vkrt, &vkrt->core.sceneDataBuffers[i], &vkrt->core.sceneDataMemories[i]);
     }
     vkrt->core.sceneData = NULL;
@@ -222,10 +233,15 @@ static void cleanupDescriptorAndPipelineResources(VKRT* vkrt) {
         vkDestroyPipeline(vkrt->core.device, vkrt->core.computePipeline, NULL);
         vkrt->core.computePipeline = VK_NULL_HANDLE;
     }
+    if (vkrt->core.adaptivePipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(vkrt->core.device, vkrt->core.adaptivePipeline, NULL);
+        vkrt->core.adaptivePipeline = VK_NULL_HANDLE;
+    }
     if (vkrt->core.pipelineLayout != VK_NULL_HANDLE) {
         vkDestroyPipelineLayout(vkrt->core.device, vkrt->core.pipelineLayout, NULL);
         vkrt->core.pipelineLayout = VK_NULL_HANDLE;
     }
+    destroyPipelineCache(vkrt);
 }
 
 static void cleanupSynchronizationResources(VKRT* vkrt) {
@@ -250,6 +266,12 @@ static void cleanupSynchronizationResources(VKRT* vkrt) {
 static void cleanupCommandAndQueryResources(VKRT* vkrt) {
     if (!vkrt || vkrt->core.device == VK_NULL_HANDLE) return;
 
+    destroyTransferQueueResources(vkrt);
+    if (vkrt->runtime.singleTimeFence != VK_NULL_HANDLE) {
+        vkDestroyFence(vkrt->core.device, vkrt->runtime.singleTimeFence, NULL);
+        vkrt->runtime.singleTimeFence = VK_NULL_HANDLE;
+    }
+
     if (vkrt->runtime.commandPool != VK_NULL_HANDLE) {
         const uint32_t commandBufferCount = VKRT_MAX_FRAMES_IN_FLIGHT;
         vkFreeCommandBuffers(
@@ -421,6 +443,7 @@ static VKRT_Result createInstanceAndDevice(VKRT* vkrt, const VKRT_CreateInfo* cr
     if (!vkrt->runtime.headless && createSurface(vkrt) != VKRT_SUCCESS) return VKRT_ERROR_OPERATION_FAILED;
     if (pickPhysicalDevice(vkrt, createInfo) != VKRT_SUCCESS) return VKRT_ERROR_OPERATION_FAILED;
     if (createLogicalDevice(vkrt) != VKRT_SUCCESS) return VKRT_ERROR_OPERATION_FAILED;
+    if (vkrtCreateMemoryAllocator(vkrt) != VKRT_SUCCESS) return VKRT_ERROR_OPERATION_FAILED;
     if (loadDeviceProcs(vkrt) != VKRT_SUCCESS) return VKRT_ERROR_OPERATION_FAILED;
     if (createQueryPool(vkrt) != VKRT_SUCCESS) return VKRT_ERROR_OPERATION_FAILED;
 
@@ -452,6 +475,10 @@ static VKRT_Result createPipelineBackendResources(VKRT* vkrt) {
     if (createCommandPool(vkrt) != VKRT_SUCCESS) return VKRT_ERROR_OPERATION_FAILED;
     logStepTime("Command pool created", stepStartTime);
 
+    stepStartTime = getMicroseconds();
+    if (createTransferQueueResources(vkrt) != VKRT_SUCCESS) return VKRT_ERROR_OPERATION_FAILED;
+    logStepTime("Transfer queue resources created", stepStartTime);
+
     stepStartTime = getMicroseconds();
     if (vkrtEnsureTextureBindings(vkrt) != VKRT_SUCCESS) return VKRT_ERROR_OPERATION_FAILED;
     logStepTime("Texture bindings ensured", stepStartTime);
@@ -461,16 +488,17 @@ static VKRT_Result createPipelineBackendResources(VKRT* vkrt) {
     logStepTime("Descriptor set layout created", stepStartTime);
 
     stepStartTime = getMicroseconds();
-    if (createRayTracingPipeline(vkrt) != VKRT_SUCCESS) return VKRT_ERROR_OPERATION_FAILED;
-    logStepTime("Main RT pipeline created", stepStartTime);
+    if (createPipelineCache(vkrt) != VKRT_SUCCESS) return VKRT_ERROR_OPERATION_FAILED;
+    logStepTime("Pipeline cache created", stepStartTime);
 
     stepStartTime = getMicroseconds();
-    if (createSelectionRayTracingPipeline(vkrt) != VKRT_SUCCESS) return VKRT_ERROR_OPERATION_FAILED;
-    logStepTime("Selection RT pipeline created", stepStartTime);
-
-    stepStartTime = getMicroseconds();
-    if (createComputePipeline(vkrt) != VKRT_SUCCESS) return VKRT_ERROR_OPERATION_FAILED;
-    logStepTime("Compute pipeline created", stepStartTime);
+    const VkBool32 pipelineCacheWarm = vkrt->core.pipelineCacheLoadedSize > 0;
+    if (createRenderPipelines(vkrt) != VKRT_SUCCESS) return VKRT_ERROR_OPERATION_FAILED;
+    logStepTime(
+        pipelineCacheWarm ? "RT and compute pipelines created (warm cache)"
+                          : "RT and compute pipelines created (cold cache)",
+        stepStartTime
+    );
     return VKRT_SUCCESS;
 }
 
@@ -490,6 +518,10 @@ static VKRT_Result createSceneBackendResources(VKRT* vkrt) {
     if (createRGB2SpecResources(vkrt) != VKRT_SUCCESS) return VKRT_ERROR_OPERATION_FAILED;
     logStepTime("RGB2Spec resources created", stepStartTime);
 
+    stepStartTime = getMicroseconds();
+    if (createSamplerResources(vkrt) != VKRT_SUCCESS) return VKRT_ERROR_OPERATION_FAILED;
+    logStepTime("Sampler resources created", stepStartTime);
+
     stepStartTime = getMicroseconds();
     if (createDescriptorPool(vkrt) != VKRT_SUCCESS) return VKRT_ERROR_OPERATION_FAILED;
     logStepTime("Descriptor pool created", stepStartTime);
@@ -595,6 +627,8 @@ VKRT_Result VKRT_initWithCreateInfo(VKRT* vkrt, const VKRT_CreateInfo* createInf
 
     if (acquireGLFW() != VKRT_SUCCESS) return VKRT_ERROR_INITIALIZATION_FAILED;
     vkrt->runtime.glfwInitialized = 1u;
+    (void)vkrtJobPoolAcquireShared();
+    vkrt->runtime.jobPoolAcquired = 1u;
     if (!createInfo->headless) {
         glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
         glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
@@ -666,6 +700,7 @@ void VKRT_deinit(VKRT* vkrt) {
         logStepTime("Command and query resource cleanup complete", stepStartTime);
 
         stepStartTime = getMicroseconds();
+        vkrtDestroyMemoryAllocator(vkrt);
         vkDestroyDevice(vkrt->core.device, NULL);
         vkrt->core.device = VK_NULL_HANDLE;
         logStepTime("Vulkan device shutdown complete", stepStartTime);
@@ -686,6 +721,10 @@ void VKRT_deinit(VKRT* vkrt) {
     }
     logStepTime("Vulkan instance shutdown complete", stepStartTime);
 
+    if (vkrt->runtime.jobPoolAcquired) {
+        vkrtJobPoolReleaseShared();
+    }
+
     stepStartTime = getMicroseconds();
     if (vkrt->runtime.window) {
         glfwDestroyWindow(vkrt->runtime.window);
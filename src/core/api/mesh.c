@@ -229,6 +229,15 @@ static int materialsEqual(const Material* a, const Material* b) {
            materialComponentEqual(a->textureRotations, b->textureRotations, 4);
 }
 
+// Mirrors the fields the light builder reads when weighting and filtering emissive meshes.
+static int materialLightingEqual(const Material* a, const Material* b) {
+    if (!a || !b) return 0;
+
+    return materialComponentEqual(a->emissionColor, b->emissionColor, 3) &&
+           a->emissionLuminance == b->emissionLuminance && a->opacity == b->opacity && a->alphaMode == b->alphaMode &&
+           (a->emissiveTextureIndex == VKRT_INVALID_INDEX) == (b->emissiveTextureIndex == VKRT_INVALID_INDEX);
+}
+
 static int meshVectorFinite(const vec3 value) {
     return value && isfinite(value[0]) && isfinite(value[1]) && isfinite(value[2]);
 }
@@ -484,7 +493,10 @@ VKRT_Result VKRT_setMaterial(VKRT* vkrt, uint32_t materialIndex, const Material*
     vkrtAdjustMaterialTextureUseCounts(vkrt, &previousMaterial, -1);
     vkrt->core.materials[materialIndex].material = sanitized;
     vkrtAdjustMaterialTextureUseCounts(vkrt, &sanitized, 1);
-    vkrtMarkMaterialResourcesDirty(vkrt);
+    vkrtMarkMaterialRangeDirty(vkrt, materialIndex);
+    if (!materialLightingEqual(&previousMaterial, &sanitized) && vkrtCountMaterialUsers(vkrt, materialIndex) > 0u) {
+        vkrtMarkLightResourcesDirty(vkrt);
+    }
     if (selectionMaskUsesMaterial(vkrt, materialIndex)) {
         markSelectionMaskDirty(vkrt);
     }
@@ -520,17 +532,17 @@ VKRT_Result VKRT_setMeshTransform(VKRT* vkrt, uint32_t meshIndex, vec3 position,
     if (position) {
         glm_vec3_copy(position, resolvedPosition);
     } else {
-        glm_vec3_copy(mesh->info.position, resolvedPosition);
+        glm_vec3_copy(mesh->position, resolvedPosition);
     }
     if (rotation) {
         glm_vec3_copy(rotation, resolvedRotation);
     } else {
-        glm_vec3_copy(mesh->info.rotation, resolvedRotation);
+        glm_vec3_copy(mesh->rotation, resolvedRotation);
     }
     if (scale) {
         glm_vec3_copy(scale, resolvedScale);
     } else {
-        glm_vec3_copy(mesh->info.scale, resolvedScale);
+        glm_vec3_copy(mesh->scale, resolvedScale);
     }
 
     mat4 worldTransform = GLM_MAT4_IDENTITY_INIT;
@@ -550,7 +562,8 @@ VKRT_Result VKRT_setMeshTransformMatrix(VKRT* vkrt, uint32_t meshIndex, mat4 wor
         return VKRT_SUCCESS;
     }
 
-    VKRT_decomposeMeshTransform(mesh->worldTransform, mesh->info.position, mesh->info.rotation, mesh->info.scale);
+    VKRT_decomposeMeshTransform(mesh->worldTransform, mesh->position, mesh->rotation, mesh->scale);
+    packMeshInfoTransform(mesh->worldTransform, &mesh->info);
     vkrtMarkSceneResourcesDirty(vkrt);
     const Material* material = vkrtGetSceneMaterialData(vkrt, mesh->info.materialIndex);
     if (material && material->emissionLuminance > 0.0f) {
@@ -1,3 +1,4 @@
+#include "allocator.h"
 #include "state.h"
 #include "textures.h"
 #include "types.h"
@@ -34,6 +35,23 @@ VKRT_Result VKRT_getRuntimeSnapshot(const VKRT* vkrt, VKRT_RuntimeSnapshot* outR
     memcpy(outRuntime->displayViewportRect, vkrt->runtime.displayViewportRect, sizeof(outRuntime->displayViewportRect));
     outRuntime->presentMode = vkrt->runtime.presentMode;
     outRuntime->displayRefreshHz = vkrt->runtime.displayRefreshHz;
+
+    outRuntime->blasMemoryBytes = 0u;
+    outRuntime->blasUncompactedMemoryBytes = 0u;
+    for (uint32_t i = 0; i < vkrt->core.meshCount; i++) {
+        const Mesh* mesh = &vkrt->core.meshes[i];
+        if (!mesh->ownsGeometry) continue;
+        outRuntime->blasMemoryBytes += mesh->bottomLevelAccelerationStructure.size;
+        outRuntime->blasUncompactedMemoryBytes += mesh->bottomLevelAccelerationStructure.uncompactedSize;
+    }
+
+    const GeometryLayout* layout = &vkrt->core.geometryLayout;
+    uint64_t vertexStride = sizeof(ShaderVertex) + VKRT_VERTEX_POSITION_COMPONENTS * sizeof(float);
+    outRuntime->geometryHeapBytes = (uint64_t)layout->vertices.capacity * vertexStride +
+                                    (uint64_t)layout->indices.capacity * sizeof(uint32_t);
+    outRuntime->geometryHeapUsedBytes = (uint64_t)layout->vertices.usedCount * vertexStride +
+                                        (uint64_t)layout->indices.usedCount * sizeof(uint32_t);
+    outRuntime->geometryUploadedBytes = layout->uploadedBytes;
     return VKRT_SUCCESS;
 }
 
@@ -47,6 +65,12 @@ VKRT_Result VKRT_getSystemInfo(const VKRT* vkrt, VKRT_SystemInfo* outSystemInfo)
     return VKRT_SUCCESS;
 }
 
+VKRT_Result VKRT_getMemorySnapshot(const VKRT* vkrt, VKRT_MemorySnapshot* outMemory) {
+    if (!vkrt || !outMemory) return VKRT_ERROR_INVALID_ARGUMENT;
+    vkrtQueryMemoryStats(vkrt, outMemory);
+    return VKRT_SUCCESS;
+}
+
 VKRT_Result VKRT_getOverlayInfo(const VKRT* vkrt, VKRT_OverlayInfo* outOverlayInfo) {
     if (!vkrt || !outOverlayInfo) return VKRT_ERROR_INVALID_ARGUMENT;
 
@@ -4,6 +4,7 @@
 #include "export.h"
 #include "images.h"
 #include "numeric.h"
+#include "platform.h"
 #include "scene.h"
 #include "state.h"
 #include "swapchain.h"
@@ -36,6 +37,14 @@ VKRT_Result VKRT_setRenderDenoiseEnabled(VKRT* vkrt, uint8_t enabled) {
     return VKRT_SUCCESS;
 }
 
+VKRT_Result VKRT_setDenoiseThreading(VKRT* vkrt, uint32_t threadCount, uint8_t pinThreads) {
+    if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
+
+    vkrt->renderImageExporter.denoiseThreadCount = threadCount;
+    vkrt->renderImageExporter.denoisePinThreads = pinThreads ? 1u : 0u;
+    return VKRT_SUCCESS;
+}
+
 static void finishRenderWithoutDenoise(VKRT* vkrt, VkBool32 previousUsesRenderPresentProfile) {
     if (!vkrt) return;
 
@@ -241,6 +250,7 @@ static void beginRenderSamplingSession(VKRT* vkrt, uint32_t targetSamples, VkBoo
     vkrt->renderStatus.renderPhase = VKRT_RENDER_PHASE_SAMPLING;
     vkrt->renderStatus.renderDenoiseEnabled = vkrt->renderControl.finalImageDenoiseEnabled ? 1u : 0u;
     vkrt->renderStatus.renderTargetSamples = targetSamples;
+    vkrt->renderControl.adaptiveSampling.renderStartMicroseconds = getMicroseconds();
     resetRenderSessionState(vkrt, resetViewTransform);
     vkrtRefreshPresentModeIfNeeded(vkrt, usedRenderPresentProfile);
 }
@@ -277,6 +287,18 @@ VKRT_Result VKRT_continueRender(VKRT* vkrt, uint32_t targetSamples) {
     return VKRT_SUCCESS;
 }
 
+VKRT_Result VKRT_setRenderTermination(VKRT* vkrt, VKRT_RenderTerminationMode mode, float timeLimitSeconds) {
+    if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
+    if (mode != VKRT_RENDER_TERMINATION_SAMPLES && mode != VKRT_RENDER_TERMINATION_TIME_OR_NOISE) {
+        return VKRT_ERROR_INVALID_ARGUMENT;
+    }
+
+    // Time-or-noise still honors the sample target; whichever limit is hit first ends sampling.
+    vkrt->renderControl.adaptiveSampling.terminationMode = mode;
+    vkrt->renderControl.adaptiveSampling.timeLimitSeconds = vkrtFiniteClampf(timeLimitSeconds, 0.0f, 0.0f, INFINITY);
+    return VKRT_SUCCESS;
+}
+
 VKRT_Result VKRT_stopRenderSampling(VKRT* vkrt) {
     if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
     if (!VKRT_renderPhaseIsSampling(vkrt->renderStatus.renderPhase)) {
@@ -166,6 +166,11 @@ VKRT_Result VKRT_setEnvironmentLight(VKRT* vkrt, vec3 color, float strength) {
         return VKRT_SUCCESS;
     }
 
+    // The environment's share of light samples scales with its strength.
+    if (vkrt->sceneSettings.environmentStrength != strength &&
+        vkrt->sceneSettings.environmentTextureIndex != VKRT_INVALID_INDEX) {
+        vkrtMarkLightResourcesDirty(vkrt);
+    }
     memcpy(vkrt->sceneSettings.environmentColor, sanitizedColor, sizeof(sanitizedColor));
     vkrt->sceneSettings.environmentStrength = strength;
     resetSceneData(vkrt);
@@ -212,6 +217,37 @@ VKRT_Result VKRT_setMisNeeEnabled(VKRT* vkrt, uint8_t enabled) {
     return VKRT_SUCCESS;
 }
 
+VKRT_Result VKRT_setLightSamplingMode(VKRT* vkrt, VKRT_LightSamplingMode mode) {
+    VKRT_Result stateReady = vkrtRequireSceneStateReady(vkrt);
+    if (stateReady != VKRT_SUCCESS) return stateReady;
+    if (mode >= VKRT_LIGHT_SAMPLING_MODE_COUNT) return VKRT_ERROR_INVALID_ARGUMENT;
+    if (vkrt->sceneSettings.lightSamplingMode == mode) return VKRT_SUCCESS;
+    vkrt->sceneSettings.lightSamplingMode = mode;
+    resetSceneData(vkrt);
+    return VKRT_SUCCESS;
+}
+
+VKRT_Result VKRT_setDirectLightingMode(VKRT* vkrt, VKRT_DirectLightingMode mode) {
+    VKRT_Result stateReady = vkrtRequireSceneStateReady(vkrt);
+    if (stateReady != VKRT_SUCCESS) return stateReady;
+    if (mode >= VKRT_DIRECT_LIGHTING_MODE_COUNT) return VKRT_ERROR_INVALID_ARGUMENT;
+    if (vkrt->sceneSettings.directLightingMode == mode) return VKRT_SUCCESS;
+    vkrt->sceneSettings.directLightingMode = mode;
+    invalidateReservoirHistory(vkrt);
+    resetSceneData(vkrt);
+    return VKRT_SUCCESS;
+}
+
+VKRT_Result VKRT_setSamplerMode(VKRT* vkrt, VKRT_SamplerMode mode) {
+    VKRT_Result stateReady = vkrtRequireSceneStateReady(vkrt);
+    if (stateReady != VKRT_SUCCESS) return stateReady;
+    if (mode >= VKRT_SAMPLER_MODE_COUNT) return VKRT_ERROR_INVALID_ARGUMENT;
+    if (vkrt->sceneSettings.samplerMode == mode) return VKRT_SUCCESS;
+    vkrt->sceneSettings.samplerMode = mode;
+    resetSceneData(vkrt);
+    return VKRT_SUCCESS;
+}
+
 VKRT_Result VKRT_setTimeRange(VKRT* vkrt, float timeBase, float timeStep) {
     VKRT_Result stateReady = vkrtRequireSceneStateReady(vkrt);
     if (stateReady != VKRT_SUCCESS) return stateReady;
@@ -233,6 +269,19 @@ VKRT_Result VKRT_setTimeRange(VKRT* vkrt, float timeBase, float timeStep) {
     return VKRT_SUCCESS;
 }
 
+VKRT_Result VKRT_setNoiseThreshold(VKRT* vkrt, float noiseThreshold) {
+    VKRT_Result stateReady = vkrtRequireSceneStateReady(vkrt);
+    if (stateReady != VKRT_SUCCESS) return stateReady;
+
+    // Zero disables adaptive sampling; moments are always accumulated, so toggling keeps the current image.
+    noiseThreshold = vkrtFiniteClampf(noiseThreshold, 0.0f, 0.0f, 1.0f);
+    if (vkrt->sceneSettings.noiseThreshold == noiseThreshold) return VKRT_SUCCESS;
+
+    vkrt->sceneSettings.noiseThreshold = noiseThreshold;
+    syncSceneStateData(vkrt);
+    return VKRT_SUCCESS;
+}
+
 VKRT_Result VKRT_requestSelectionAtPixel(VKRT* vkrt, uint32_t x, uint32_t y) {
     if (!vkrt || !vkrt->core.selectionData) return VKRT_ERROR_INVALID_ARGUMENT;
     if (x > 0xFFFFu || y > 0xFFFFu) return VKRT_ERROR_INVALID_ARGUMENT;
@@ -33,6 +33,7 @@ VKRT_Result VKRT_uploadMeshData(
 );
 VKRT_Result VKRT_uploadMeshDataBatch(VKRT* vkrt, const VKRT_MeshUpload* uploads, size_t uploadCount);
 VKRT_Result VKRT_removeMesh(VKRT* vkrt, uint32_t meshIndex);
+VKRT_Result VKRT_defragmentGeometry(VKRT* vkrt);
 VKRT_Result VKRT_applyCameraInput(VKRT* vkrt, const VKRT_CameraInput* input);
 VKRT_Result VKRT_invalidateAccumulation(VKRT* vkrt);
 VKRT_Result VKRT_setSamplesPerPixel(VKRT* vkrt, uint32_t samplesPerPixel);
@@ -50,20 +51,27 @@ VKRT_Result VKRT_setEnvironmentTextureFromFile(VKRT* vkrt, const char* path);
 VKRT_Result VKRT_clearEnvironmentTexture(VKRT* vkrt);
 VKRT_Result VKRT_setDebugMode(VKRT* vkrt, VKRT_DebugMode mode);
 VKRT_Result VKRT_setMisNeeEnabled(VKRT* vkrt, uint8_t enabled);
+VKRT_Result VKRT_setLightSamplingMode(VKRT* vkrt, VKRT_LightSamplingMode mode);
+VKRT_Result VKRT_setDirectLightingMode(VKRT* vkrt, VKRT_DirectLightingMode mode);
+VKRT_Result VKRT_setSamplerMode(VKRT* vkrt, VKRT_SamplerMode mode);
 VKRT_Result VKRT_setTimeRange(VKRT* vkrt, float timeBase, float timeStep);
+VKRT_Result VKRT_setNoiseThreshold(VKRT* vkrt, float noiseThreshold);
 void VKRT_defaultRenderExportSettings(VKRT_RenderExportSettings* settings);
 VKRT_Result VKRT_setRenderDenoiseEnabled(VKRT* vkrt, uint8_t enabled);
+VKRT_Result VKRT_setDenoiseThreading(VKRT* vkrt, uint32_t threadCount, uint8_t pinThreads);
 VKRT_Result VKRT_denoiseRenderToViewport(VKRT* vkrt);
 VKRT_Result VKRT_saveRenderImageEx(VKRT* vkrt, const char* path, const VKRT_RenderExportSettings* settings);
 VKRT_Result VKRT_saveRenderImage(VKRT* vkrt, const char* path);
 VKRT_Result VKRT_startRender(VKRT* vkrt, uint32_t width, uint32_t height, uint32_t targetSamples);
 VKRT_Result VKRT_continueRender(VKRT* vkrt, uint32_t targetSamples);
+VKRT_Result VKRT_setRenderTermination(VKRT* vkrt, VKRT_RenderTerminationMode mode, float timeLimitSeconds);
 VKRT_Result VKRT_stopRenderSampling(VKRT* vkrt);
 VKRT_Result VKRT_stopRender(VKRT* vkrt);
 VKRT_Result VKRT_getSceneSettings(const VKRT* vkrt, VKRT_SceneSettingsSnapshot* outSettings);
 VKRT_Result VKRT_getRenderStatus(const VKRT* vkrt, VKRT_RenderStatusSnapshot* outStatus);
 VKRT_Result VKRT_getRuntimeSnapshot(const VKRT* vkrt, VKRT_RuntimeSnapshot* outRuntime);
 VKRT_Result VKRT_getSystemInfo(const VKRT* vkrt, VKRT_SystemInfo* outSystemInfo);
+VKRT_Result VKRT_getMemorySnapshot(const VKRT* vkrt, VKRT_MemorySnapshot* outMemory);
 VKRT_Result VKRT_getRenderSourceExtent(const VKRT* vkrt, float* outWidth, float* outHeight);
 VKRT_Result VKRT_getDisplayViewportExtent(const VKRT* vkrt, float* outWidth, float* outHeight);
 VKRT_Result VKRT_getRenderViewCrop(const VKRT* vkrt, float zoom, float* outWidth, float* outHeight);
@@ -29,6 +29,9 @@ typedef uint32_t VKRT_ToneMappingMode;
 typedef uint32_t VKRT_RenderMode;
 typedef uint32_t VKRT_SpectralSamplingMode;
 typedef uint32_t VKRT_DebugMode;
+typedef uint32_t VKRT_LightSamplingMode;
+typedef uint32_t VKRT_DirectLightingMode;
+typedef uint32_t VKRT_SamplerMode;
 typedef uint32_t VKRT_MaterialTextureSlot;
 typedef uint32_t VKRT_TextureColorSpace;
 
@@ -74,6 +77,10 @@ typedef struct VKRT_TextureUpload {
     uint32_t height;
     uint32_t format;
     uint32_t colorSpace;
+    // Optional prebuilt mip chain: level i starts at pixels + mipLevelOffsets[i]. When mipLevelCount <= 1,
+    // uncompressed textures get their mips generated on upload.
+    uint32_t mipLevelCount;
+    const size_t* mipLevelOffsets;
 } VKRT_TextureUpload;
 
 static inline Material VKRT_materialDefault(void) {
@@ -142,8 +149,12 @@ typedef struct VKRT_SceneSettingsSnapshot {
     float timeStep;
     uint32_t debugMode;
     uint32_t misNeeEnabled;
+    uint32_t lightSamplingMode;
+    uint32_t directLightingMode;
+    uint32_t samplerMode;
     uint32_t selectionEnabled;
     uint32_t selectedMeshIndex;
+    float noiseThreshold;
 } VKRT_SceneSettingsSnapshot;
 
 typedef enum VKRT_RenderPhase {
@@ -154,6 +165,11 @@ typedef enum VKRT_RenderPhase {
     VKRT_RENDER_PHASE_COMPLETE_DENOISED,
 } VKRT_RenderPhase;
 
+typedef enum VKRT_RenderTerminationMode {
+    VKRT_RENDER_TERMINATION_SAMPLES = 0,
+    VKRT_RENDER_TERMINATION_TIME_OR_NOISE,
+} VKRT_RenderTerminationMode;
+
 typedef struct VKRT_RenderStatusSnapshot {
     uint32_t framesPerSecond;
     float averageFrametime;
@@ -165,6 +181,8 @@ typedef struct VKRT_RenderStatusSnapshot {
     VKRT_RenderPhase renderPhase;
     uint8_t renderDenoiseEnabled;
     uint32_t renderTargetSamples;
+    uint32_t adaptiveActiveTiles;
+    uint32_t adaptiveTileCount;
     float displayRenderTimeMs;
     float displayFrameTimeMs;
 } VKRT_RenderStatusSnapshot;
@@ -235,6 +253,11 @@ typedef struct VKRT_RuntimeSnapshot {
     uint32_t displayViewportRect[4];
     uint32_t presentMode;
     float displayRefreshHz;
+    uint64_t blasMemoryBytes;
+    uint64_t blasUncompactedMemoryBytes;
+    uint64_t geometryHeapBytes;
+    uint64_t geometryHeapUsedBytes;
+    uint64_t geometryUploadedBytes;
 } VKRT_RuntimeSnapshot;
 
 typedef struct VKRT_RenderExportSettings {
@@ -247,6 +270,26 @@ typedef struct VKRT_SystemInfo {
     uint32_t driverVersion;
 } VKRT_SystemInfo;
 
+typedef struct VKRT_MemoryHeapStats {
+    uint64_t heapSize;
+    uint64_t reservedBytes;
+    uint64_t usedBytes;
+    uint32_t blockCount;
+    uint32_t allocationCount;
+    uint8_t deviceLocal;
+} VKRT_MemoryHeapStats;
+
+typedef struct VKRT_MemorySnapshot {
+    VKRT_MemoryHeapStats heaps[VKRT_MAX_MEMORY_HEAPS];
+    uint32_t heapCount;
+    uint32_t blockCount;
+    uint32_t allocationCount;
+    uint32_t dedicatedAllocationCount;
+    uint64_t reservedBytes;
+    uint64_t usedBytes;
+    float fragmentation;
+} VKRT_MemorySnapshot;
+
 typedef struct VKRT_MeshSnapshot {
     MeshInfo info;
     Material material;
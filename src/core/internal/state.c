@@ -1,5 +1,6 @@
 #include "state.h"
 
+#include "allocator.h"
 #include "config.h"
 #include "types.h"
 #include "vkrt_engine_types.h"
@@ -22,7 +23,21 @@ VKRT_Result vkrtWaitForAllInFlightFrames(const VKRT* vkrt) {
     if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
     VkResult result =
         vkWaitForFences(vkrt->core.device, VKRT_MAX_FRAMES_IN_FLIGHT, vkrt->runtime.inFlightFences, VK_TRUE, UINT64_MAX);
-    return vkrtConvertVkResult(result);
+    if (result != VK_SUCCESS) return vkrtConvertVkResult(result);
+    return vkrtWaitForTransferValue(vkrt, vkrt->runtime.transfer.submittedValue);
+}
+
+VKRT_Result vkrtWaitForTransferValue(const VKRT* vkrt, uint64_t value) {
+    if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
+    if (value == 0u || vkrt->runtime.transfer.timeline == VK_NULL_HANDLE) return VKRT_SUCCESS;
+
+    VkSemaphoreWaitInfo waitInfo = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .semaphoreCount = 1u,
+        .pSemaphores = &vkrt->runtime.transfer.timeline,
+        .pValues = &value,
+    };
+    return vkrtConvertVkResult(vkWaitSemaphores(vkrt->core.device, &waitInfo, UINT64_MAX));
 }
 
 VKRT_Result vkrtConvertVkResult(VkResult result) {
@@ -95,10 +110,7 @@ void vkrtDestroyAccelerationStructureResources(VKRT* vkrt, AccelerationStructure
         vkDestroyBuffer(vkrt->core.device, accelerationStructure->buffer, NULL);
         accelerationStructure->buffer = VK_NULL_HANDLE;
     }
-    if (accelerationStructure->memory != VK_NULL_HANDLE) {
-        vkFreeMemory(vkrt->core.device, accelerationStructure->memory, NULL);
-        accelerationStructure->memory = VK_NULL_HANDLE;
-    }
+    vkrtFreeMemory(vkrt, &accelerationStructure->memory);
     accelerationStructure->deviceAddress = 0;
 }
 
@@ -117,6 +129,17 @@ void vkrtMarkMaterialResourcesDirty(VKRT* vkrt) {
     vkrt->core.materialRevision++;
 }
 
+void vkrtMarkMaterialRangeDirty(VKRT* vkrt, uint32_t materialIndex) {
+    if (!vkrt) return;
+    if (vkrt->core.materialDirtyEnd <= vkrt->core.materialDirtyBegin) {
+        vkrt->core.materialDirtyBegin = materialIndex;
+        vkrt->core.materialDirtyEnd = materialIndex + 1u;
+        return;
+    }
+    if (materialIndex < vkrt->core.materialDirtyBegin) vkrt->core.materialDirtyBegin = materialIndex;
+    if (materialIndex >= vkrt->core.materialDirtyEnd) vkrt->core.materialDirtyEnd = materialIndex + 1u;
+}
+
 void vkrtMarkTextureResourcesDirty(VKRT* vkrt) {
     if (!vkrt) return;
     vkrt->core.textureRevision++;
@@ -6,6 +6,7 @@
 
 VKRT_Result vkrtRequireSceneStateReady(const VKRT* vkrt);
 VKRT_Result vkrtWaitForAllInFlightFrames(const VKRT* vkrt);
+VKRT_Result vkrtWaitForTransferValue(const VKRT* vkrt, uint64_t value);
 VKRT_Result vkrtConvertVkResult(VkResult result);
 VKRT_Result vkrtEnsureDefaultMaterial(VKRT* vkrt);
 const SceneMaterial* vkrtGetSceneMaterial(const VKRT* vkrt, uint32_t materialIndex);
@@ -17,5 +18,6 @@ void vkrtDestroyAccelerationStructureResources(VKRT* vkrt, AccelerationStructure
 void vkrtMarkSceneResourcesDirty(VKRT* vkrt);
 void vkrtMarkSelectionResourcesDirty(VKRT* vkrt);
 void vkrtMarkMaterialResourcesDirty(VKRT* vkrt);
+void vkrtMarkMaterialRangeDirty(VKRT* vkrt, uint32_t materialIndex);
 void vkrtMarkTextureResourcesDirty(VKRT* vkrt);
 void vkrtMarkLightResourcesDirty(VKRT* vkrt);
@@ -6,18 +6,78 @@
 #include <stddef.h>
 #include <vulkan/vulkan.h>
 
+typedef struct MemoryAllocation_T* MemoryAllocation;
+struct MemoryBlock;
+
+typedef enum MemoryResourceKind {
+    MEMORY_RESOURCE_BUFFER = 0,
+    MEMORY_RESOURCE_IMAGE = 1,
+    MEMORY_RESOURCE_KIND_COUNT = 2
+} MemoryResourceKind;
+
+typedef struct MemoryPool {
+    struct MemoryBlock** blocks;
+    uint32_t blockCount;
+} MemoryPool;
+
+typedef struct MemoryAllocator {
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    VkDeviceSize preferredBlockSizes[VK_MAX_MEMORY_HEAPS];
+    MemoryPool pools[VK_MAX_MEMORY_TYPES][MEMORY_RESOURCE_KIND_COUNT];
+    uint32_t dedicatedAllocationCounts[VK_MAX_MEMORY_HEAPS];
+    VkDeviceSize dedicatedBytes[VK_MAX_MEMORY_HEAPS];
+    VKRT_Mutex lock;
+    uint8_t initialized;
+} MemoryAllocator;
+
 typedef struct AccelerationStructure {
     VkAccelerationStructureKHR structure;
-    VkDeviceMemory memory;
+    MemoryAllocation memory;
     VkBuffer buffer;
     VkDeviceAddress deviceAddress;
+    VkDeviceSize size;
+    VkDeviceSize uncompactedSize;
+    uint64_t buildId;
 } AccelerationStructure;
 
+// The emissive triangles that came from one run of VKRT_LIGHT_CLUSTER_TRIANGLE_COUNT source triangles. Degenerate
+// triangles are dropped, so a cluster can be empty. The bounds are in object space; the two-sided normal cone is in
+// the area basis, like the areas.
+typedef struct EmissiveTriangleCluster {
+    uint32_t firstTriangle;
+    uint32_t triangleCount;
+    float area;
+    float boundsMin[3];
+    float boundsMax[3];
+    float normalAxis[3];
+    float normalCosTheta;
+} EmissiveTriangleCluster;
+
+// Object-space emissive triangles with one alias table per cluster, reused until the mesh's area basis changes.
+typedef struct EmissiveTriangleCache {
+    EmissiveTriangle* triangles;
+    float* aliasQ;
+    uint32_t* aliasIdx;
+    EmissiveTriangleCluster* clusters;
+    uint32_t triangleCount;
+    uint32_t clusterCount;
+    uint64_t serial;
+    float areaBasis[3][3];
+    float totalArea;
+    float boundsMin[3];
+    float boundsMax[3];
+    uint8_t worldSpaceAreas;
+} EmissiveTriangleCache;
+
 typedef struct Mesh {
     MeshInfo info;
     mat4 worldTransform;
+    vec3 position;
+    vec3 rotation;
+    vec3 scale;
     char name[VKRT_NAME_LEN];
     AccelerationStructure bottomLevelAccelerationStructure;
+    EmissiveTriangleCache emissiveCache;
     Vertex* vertices;
     uint32_t* indices;
     uint64_t geometryFingerprint;
@@ -37,7 +97,7 @@ typedef struct SceneMaterial {
 typedef struct SceneTexture {
     VkImage image;
     VkImageView view;
-    VkDeviceMemory memory;
+    MemoryAllocation memory;
     uint32_t width;
     uint32_t height;
     uint32_t format;
@@ -46,14 +106,39 @@ typedef struct SceneTexture {
     char name[VKRT_NAME_LEN];
 } SceneTexture;
 
+typedef struct GeometryRange {
+    uint32_t offset;
+    uint32_t count;
+} GeometryRange;
+
+typedef struct GeometryRangeAllocator {
+    GeometryRange* freeRanges;
+    uint32_t freeRangeCount;
+    uint32_t freeRangeCapacity;
+    uint32_t capacity;
+    uint32_t usedCount;
+} GeometryRangeAllocator;
+
 typedef struct GeometryLayout {
-    uint32_t vertexCapacity;
-    uint32_t indexCapacity;
+    GeometryRangeAllocator vertices;
+    GeometryRangeAllocator indices;
+    uint64_t uploadedBytes;
 } GeometryLayout;
 
+typedef struct GeometryDedupEntry {
+    uint64_t fingerprint;
+    uint32_t owner;
+} GeometryDedupEntry;
+
+typedef struct GeometryDedupTable {
+    GeometryDedupEntry* entries;
+    uint32_t capacity;
+    uint32_t count;
+} GeometryDedupTable;
+
 typedef struct Buffer {
     VkBuffer buffer;
-    VkDeviceMemory memory;
+    MemoryAllocation memory;
     VkDeviceAddress deviceAddress;
     uint32_t count;
 } Buffer;
@@ -61,9 +146,11 @@ typedef struct Buffer {
 typedef struct QueueFamily {
     int32_t graphics;
     int32_t present;
+    int32_t transfer;
 } QueueFamily;
 
 struct RenderImageExportJob;
+struct VKRT_OIDNContext;
 
 typedef struct RenderImageExporter {
     VKRT_Mutex stateLock;
@@ -72,6 +159,9 @@ typedef struct RenderImageExporter {
     VKRT_Thread workerThread;
     struct RenderImageExportJob* head;
     struct RenderImageExportJob* tail;
+    struct VKRT_OIDNContext* denoiser;
+    uint32_t denoiseThreadCount;
+    uint8_t denoisePinThreads;
     uint32_t pendingJobCount;
     void* completedViewportPixels;
     size_t completedViewportByteCount;
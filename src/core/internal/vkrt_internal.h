@@ -12,6 +12,8 @@ typedef struct VKRT_DeviceProcedures {
     PFN_vkGetAccelerationStructureBuildSizesKHR vkGetAccelerationStructureBuildSizesKHR;
     PFN_vkGetAccelerationStructureDeviceAddressKHR vkGetAccelerationStructureDeviceAddressKHR;
     PFN_vkCmdBuildAccelerationStructuresKHR vkCmdBuildAccelerationStructuresKHR;
+    PFN_vkCmdWriteAccelerationStructuresPropertiesKHR vkCmdWriteAccelerationStructuresPropertiesKHR;
+    PFN_vkCmdCopyAccelerationStructureKHR vkCmdCopyAccelerationStructureKHR;
     PFN_vkGetBufferDeviceAddressKHR vkGetBufferDeviceAddressKHR;
     PFN_vkCmdTraceRaysKHR vkCmdTraceRaysKHR;
     PFN_vkGetRayTracingShaderGroupStackSizeKHR vkGetRayTracingShaderGroupStackSizeKHR;
@@ -50,13 +52,40 @@ typedef enum VKRT_HitGroupVariant {
     VKRT_HIT_GROUP_VARIANT_COUNT = 2u
 } VKRT_HitGroupVariant;
 
+typedef struct FrameTransfer {
+    VkBuffer buffer;
+    MemoryAllocation memory;
+} FrameTransfer;
+
+typedef struct TLASState {
+    FrameTransfer instanceBuffer;
+    FrameTransfer scratchBuffer;
+    VkAccelerationStructureInstanceKHR* mappedInstances;
+    VkAccelerationStructureInstanceKHR* hostInstances;
+    uint32_t instanceCapacity;
+    uint32_t instanceCount;
+    uint32_t refitCount;
+    VkBool32 built;
+} TLASState;
+
+typedef struct EnvironmentDistribution {
+    float* aliasQ;
+    uint32_t* aliasIdx;
+    float* pmf;
+    uint32_t width;
+    uint32_t height;
+    float integratedLuminance;
+} EnvironmentDistribution;
+
 typedef struct VKRT_Core {
     VkInstance instance;
     VkDebugUtilsMessengerEXT debugMessenger;
     VkPhysicalDevice physicalDevice;
     VkDevice device;
+    MemoryAllocator memoryAllocator;
     VkQueue graphicsQueue;
     VkQueue presentQueue;
+    VkQueue transferQueue;
     QueueFamily indices;
     VkDescriptorSetLayout descriptorSetLayout;
     VkDescriptorPool descriptorPool;
@@ -65,24 +94,27 @@ typedef struct VKRT_Core {
     VkSampler textureSamplers[VKRT_TEXTURE_SAMPLER_VARIANT_COUNT];
     VkImage textureFallbackImage;
     VkImageView textureFallbackView;
-    VkDeviceMemory textureFallbackMemory;
+    MemoryAllocation textureFallbackMemory;
     VkPipelineLayout pipelineLayout;
+    VkPipelineCache pipelineCache;
+    size_t pipelineCacheLoadedSize;
     VkPipeline rayTracingPipeline;
     VkPipeline selectionRayTracingPipeline;
     VkPipeline computePipeline;
+    VkPipeline adaptivePipeline;
     VkBuffer shaderBindingTableBuffer;
-    VkDeviceMemory shaderBindingTableMemory;
+    MemoryAllocation shaderBindingTableMemory;
     VkStridedDeviceAddressRegionKHR shaderBindingTables[4];
     VkStridedDeviceAddressRegionKHR mainRaygenRegions[VKRT_MAIN_RAYGEN_GROUP_COUNT];
     uint32_t mainRayTracingStackSizes[VKRT_MAIN_RAYGEN_GROUP_COUNT];
     VkBuffer selectionShaderBindingTableBuffer;
-    VkDeviceMemory selectionShaderBindingTableMemory;
+    MemoryAllocation selectionShaderBindingTableMemory;
     VkStridedDeviceAddressRegionKHR selectionShaderBindingTables[4];
     uint32_t selectionRayTracingStackSize;
     SceneData sceneDataHost;
     SceneData* sceneData;
     VkBuffer sceneDataBuffers[VKRT_MAX_FRAMES_IN_FLIGHT];
-    VkDeviceMemory sceneDataMemories[VKRT_MAX_FRAMES_IN_FLIGHT];
+    MemoryAllocation sceneDataMemories[VKRT_MAX_FRAMES_IN_FLIGHT];
     SceneData* sceneFrameData[VKRT_MAX_FRAMES_IN_FLIGHT];
     Selection* selectionData;
     uint32_t selectionPendingFrame;
@@ -92,32 +124,47 @@ typedef struct VKRT_Core {
     uint8_t selectionResultReady;
     VkImage outputImage;
     VkImageView outputImageView;
-    VkDeviceMemory outputImageMemory;
+    MemoryAllocation outputImageMemory;
     VkImage accumulationImages[2];
     VkImageView accumulationImageViews[2];
-    VkDeviceMemory accumulationImageMemories[2];
+    MemoryAllocation accumulationImageMemories[2];
     VkImage albedoImages[2];
     VkImageView albedoImageViews[2];
-    VkDeviceMemory albedoImageMemories[2];
+    MemoryAllocation albedoImageMemories[2];
     VkImage normalImages[2];
     VkImageView normalImageViews[2];
-    VkDeviceMemory normalImageMemories[2];
+    MemoryAllocation normalImageMemories[2];
+    VkImage reservoirSampleImages[2];
+    VkImageView reservoirSampleImageViews[2];
+    MemoryAllocation reservoirSampleImageMemories[2];
+    VkImage reservoirDataImages[2];
+    VkImageView reservoirDataImageViews[2];
+    MemoryAllocation reservoirDataImageMemories[2];
+    VkImage reservoirSurfaceImages[2];
+    VkImageView reservoirSurfaceImageViews[2];
+    MemoryAllocation reservoirSurfaceImageMemories[2];
     uint32_t accumulationReadIndex;
     uint32_t accumulationWriteIndex;
     VkBool32 accumulationNeedsReset;
     VkBool32 selectionMaskDirty;
     VkImage selectionMaskImage;
     VkImageView selectionMaskImageView;
-    VkDeviceMemory selectionMaskImageMemory;
+    MemoryAllocation selectionMaskImageMemory;
+    VkImage adaptiveMomentImage;
+    VkImageView adaptiveMomentImageView;
+    MemoryAllocation adaptiveMomentImageMemory;
     Mesh* meshes;
     SceneMaterial* materials;
     SceneTexture* textures;
     Buffer selection;
+    Buffer adaptiveStatus;
+    Buffer positionData;
     Buffer vertexData;
     Buffer indexData;
     uint32_t meshCount;
     uint32_t materialCount;
     uint32_t textureCount;
+    uint64_t blasBuildCounter;
     Buffer sceneMeshData;
     Buffer sceneMaterialData;
     Buffer sceneEmissiveMeshData;
@@ -126,10 +173,18 @@ typedef struct VKRT_Core {
     Buffer sceneMeshAliasIdx;
     Buffer sceneTriAliasQ;
     Buffer sceneTriAliasIdx;
+    Buffer sceneLightBVHData;
     Buffer sceneRGB2SpecSRGBData;
     RGB2SpecTableInfo rgb2specSRGBInfo;
+    Buffer sceneSamplerData;
+    Buffer sceneEnvironmentAliasQ;
+    Buffer sceneEnvironmentAliasIdx;
+    Buffer sceneEnvironmentPmf;
+    EnvironmentDistribution environmentDistribution;
     AccelerationStructure sceneTopLevelAccelerationStructure;
     AccelerationStructure selectionTopLevelAccelerationStructure;
+    TLASState sceneTLASState;
+    TLASState selectionTLASState;
     VkBool32 descriptorSetReady[VKRT_MAX_FRAMES_IN_FLIGHT];
     uint32_t sceneRevision;
     uint32_t selectionRevision;
@@ -141,61 +196,120 @@ typedef struct VKRT_Core {
     uint32_t materialResourceRevision;
     uint32_t textureResourceRevision;
     uint32_t lightResourceRevision;
+    uint32_t materialDirtyBegin;
+    uint32_t materialDirtyEnd;
     GeometryLayout geometryLayout;
+    GeometryDedupTable geometryDedup;
     uint32_t emissiveMeshCount;
     uint32_t emissiveTriangleCount;
+    uint64_t emissiveCacheSerial;
+    uint64_t emissiveTriangleLayoutKey;
     DeviceExtensionSupport deviceExtensionSupport;
+    float maxSamplerAnisotropy;
+    VkBool32 textureCompressionBC;
     char deviceName[VKRT_DEVICE_NAME_LEN];
     uint32_t vendorID;
+    uint32_t deviceID;
     uint32_t driverVersion;
+    uint8_t pipelineCacheUUID[VK_UUID_SIZE];
     uint32_t apiVersion;
     VkRayTracingInvocationReorderModeEXT serReorderingHintMode;
     uint32_t serMaxShaderBindingTableRecordIndex;
     VKRT_DeviceProcedures procs;
 } VKRT_Core;
 
-typedef struct FrameTransfer {
-    VkBuffer buffer;
-    VkDeviceMemory memory;
-} FrameTransfer;
-
 typedef struct PendingGeometryUpload {
     uint32_t meshIndex;
     VkBuffer stagingBuffer;
-    VkDeviceMemory stagingMemory;
-    VkDeviceSize indexOffset;
+    VkBufferCopy positionCopy;
+    VkBufferCopy vertexCopy;
+    VkBufferCopy indexCopy;
 } PendingGeometryUpload;
 
 typedef struct PendingBufferCopy {
     VkBuffer stagingBuffer;
-    VkDeviceMemory stagingMemory;
+    VkDeviceSize stagingOffset;
     VkBuffer dstBuffer;
+    VkDeviceSize dstOffset;
     VkDeviceSize size;
 } PendingBufferCopy;
 
+typedef struct StagingRing {
+    FrameTransfer transfer;
+    uint8_t* mapped;
+    VkDeviceSize capacity;
+    VkDeviceSize head;
+    VkDeviceSize requestedBytes;
+    FrameTransfer* fallbacks;
+    uint32_t fallbackCount;
+    uint32_t fallbackCapacity;
+    uint64_t transferValue;
+} StagingRing;
+
 typedef struct PendingBLASBuild {
     uint32_t meshIndex;
-    VkBuffer scratchBuffer;
-    VkDeviceMemory scratchMemory;
+    uint64_t buildId;
+    VkDeviceSize scratchOffset;
+    uint32_t queryIndex;
 } PendingBLASBuild;
 
+typedef struct BLASCompactionCandidate {
+    uint64_t buildId;
+    VkDeviceSize compactedSize;
+} BLASCompactionCandidate;
+
+typedef struct PendingBLASCompaction {
+    AccelerationStructure source;
+    VkAccelerationStructureKHR destination;
+} PendingBLASCompaction;
+
 typedef struct FrameSceneUpdate {
+    StagingRing staging;
     PendingBufferCopy* sceneTransfers;
     uint32_t sceneTransferCount;
+    uint32_t sceneTransferCapacity;
     PendingGeometryUpload* geometryUploads;
     uint32_t geometryUploadCount;
     PendingBLASBuild* blasBuilds;
     uint32_t blasBuildCount;
-    FrameTransfer sceneTLASInstanceBuffer;
-    FrameTransfer sceneTLASScratch;
-    FrameTransfer selectionTLASInstanceBuffer;
-    FrameTransfer selectionTLASScratch;
-    uint32_t sceneTLASInstanceCount;
-    uint32_t selectionTLASInstanceCount;
+    Buffer blasScratch;
+    VkDeviceSize blasScratchCapacity;
+    VkQueryPool blasCompactionQueryPool;
+    uint32_t blasCompactionQueryCapacity;
+    uint32_t blasCompactionQueryCount;
+    BLASCompactionCandidate* blasCompactionCandidates;
+    uint32_t blasCompactionCandidateCount;
+    PendingBLASCompaction* blasCompactions;
+    uint32_t blasCompactionCount;
+    VkBuildAccelerationStructureModeKHR sceneTLASBuildMode;
+    VkBuildAccelerationStructureModeKHR selectionTLASBuildMode;
     VkBool32 sceneTLASBuildPending;
     VkBool32 selectionTLASBuildPending;
 } FrameSceneUpdate;
 
+typedef struct TransferSubmission {
+    VkCommandBuffer commandBuffer;
+    uint64_t value;
+} TransferSubmission;
+
+typedef struct PendingImageAcquire {
+    VkImage image;
+    uint64_t value;
+} PendingImageAcquire;
+
+typedef struct TransferQueueState {
+    VkCommandPool commandPool;
+    VkSemaphore timeline;
+    uint64_t submittedValue;
+    uint64_t graphicsWaitValue;
+    TransferSubmission* submissions;
+    uint32_t submissionCount;
+    uint32_t submissionCapacity;
+    PendingImageAcquire* acquires;
+    uint32_t acquireCount;
+    uint32_t acquireCapacity;
+} TransferQueueState;
+
 typedef struct VKRT_Runtime {
     GLFWwindow* window;
     VkSurfaceKHR surface;
@@ -212,6 +326,8 @@ typedef struct VKRT_Runtime {
     uint32_t displayViewportRect[4];
     VkCommandPool commandPool;
     VkCommandBuffer commandBuffers[VKRT_MAX_FRAMES_IN_FLIGHT];
+    VkFence singleTimeFence;
+    TransferQueueState transfer;
     FrameSceneUpdate frameSceneUpdates[VKRT_MAX_FRAMES_IN_FLIGHT];
     VkSemaphore imageAvailableSemaphores[VKRT_MAX_FRAMES_IN_FLIGHT];
     VkSemaphore* renderFinishedSemaphores;
@@ -231,6 +347,7 @@ typedef struct VKRT_Runtime {
     VkBool32 headless;
     uint8_t disableSER;
     uint8_t glfwInitialized;
+    uint8_t jobPoolAcquired;
     VkPresentModeKHR presentMode;
     float displayRefreshHz;
     VkBool32 swapChainFormatLogInitialized;
@@ -266,11 +383,25 @@ typedef struct VKRT_AutoExposureState {
     VKRT_AutoExposureReadback readbacks[VKRT_MAX_FRAMES_IN_FLIGHT];
 } VKRT_AutoExposureState;
 
+typedef struct VKRT_AdaptiveSamplingReadback {
+    Buffer buffer;
+    AdaptiveStatus* mappedStatus;
+    uint8_t pending;
+} VKRT_AdaptiveSamplingReadback;
+
+typedef struct VKRT_AdaptiveSamplingState {
+    VKRT_AdaptiveSamplingReadback readbacks[VKRT_MAX_FRAMES_IN_FLIGHT];
+    VKRT_RenderTerminationMode terminationMode;
+    float timeLimitSeconds;
+    uint64_t renderStartMicroseconds;
+} VKRT_AdaptiveSamplingState;
+
 typedef struct VKRT_RenderControlState {
     VKRT_RenderViewState view;
     VKRT_TimingState timing;
     VKRT_AutoSPPState autoSPP;
     VKRT_AutoExposureState autoExposure;
+    VKRT_AdaptiveSamplingState adaptiveSampling;
     uint64_t renderSequence;
     uint8_t finalImageDenoiseEnabled;
     uint8_t viewportDenoisePending;
@@ -12,6 +12,10 @@ VKRT_Result createBottomLevelAccelerationStructureForGeometry(
 );
 VKRT_Result prepareBottomLevelAccelerationStructureBuilds(VKRT* vkrt);
 VKRT_Result recordBottomLevelAccelerationStructureBuilds(VKRT* vkrt, VkCommandBuffer commandBuffer);
+VKRT_Result recordBottomLevelAccelerationStructureCompactionQueries(VKRT* vkrt, VkCommandBuffer commandBuffer);
+void resolveBottomLevelAccelerationStructureCompaction(VKRT* vkrt, uint32_t frameIndex);
+VKRT_Result compactBottomLevelAccelerationStructures(VKRT* vkrt);
 VKRT_Result createTopLevelAccelerationStructures(VKRT* vkrt);
 VKRT_Result createSelectionTopLevelAccelerationStructure(VKRT* vkrt);
 VKRT_Result recordTopLevelAccelerationStructureBuilds(VKRT* vkrt, VkCommandBuffer commandBuffer);
+void destroyTopLevelAccelerationStructures(VKRT* vkrt);
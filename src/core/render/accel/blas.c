@@ -1,7 +1,9 @@
 #include "accel.h"
+#include "allocator.h"
 #include "buffer.h"
-#include "device.h"
+#include "debug.h"
 #include "rebuild.h"
+#include "state.h"
 #include "types.h"
 #include "vkrt_engine_types.h"
 #include "vkrt_internal.h"
@@ -10,6 +12,11 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+
+static const VkBuildAccelerationStructureFlagsKHR kBLASBuildFlags =
+    VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR |
+    VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_COMPACTION_BIT_KHR;
 
 static void buildBLASGeometryInfo(
     const MeshInfo* meshInfo,
@@ -22,9 +29,10 @@ static void buildBLASGeometryInfo(
     trianglesData.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_TRIANGLES_DATA_KHR;
     trianglesData.vertexFormat = VK_FORMAT_R32G32B32_SFLOAT;
     trianglesData.vertexData.deviceAddress = vertexDataAddress;
-    trianglesData.vertexStride = sizeof(ShaderVertex);
+    trianglesData.vertexStride = VKRT_VERTEX_POSITION_COMPONENTS * sizeof(float);
     trianglesData.maxVertex = meshInfo->vertexBase + meshInfo->vertexCount - 1;
-    trianglesData.indexType = VK_INDEX_TYPE_UINT32;
+    trianglesData.indexType =
+        meshInfo->indexFormat == VKRT_MESH_INDEX_FORMAT_UINT16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
     trianglesData.indexData.deviceAddress = indexDataAddress;
 
     *outGeometry = (VkAccelerationStructureGeometryKHR){0};
@@ -36,43 +44,22 @@ static void buildBLASGeometryInfo(
     *outBuildInfo = (VkAccelerationStructureBuildGeometryInfoKHR){0};
     outBuildInfo->sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
     outBuildInfo->type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
-    outBuildInfo->flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
+    outBuildInfo->flags = kBLASBuildFlags;
     outBuildInfo->mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
     outBuildInfo->geometryCount = 1;
     outBuildInfo->pGeometries = outGeometry;
 }
 
-static VKRT_Result prepareBLAS(
+static VKRT_Result createBLASStorage(
     VKRT* vkrt,
-    const MeshInfo* meshInfo,
-    VkDeviceAddress vertexDataAddress,
-    VkDeviceAddress indexDataAddress,
+    VkDeviceSize accelerationStructureSize,
     AccelerationStructure* outAccelerationStructure
 ) {
-    if (!vkrt || !meshInfo || !outAccelerationStructure) return VKRT_ERROR_INVALID_ARGUMENT;
-
-    VkAccelerationStructureGeometryKHR geometry;
-    VkAccelerationStructureBuildGeometryInfoKHR buildInfo;
-    buildBLASGeometryInfo(meshInfo, vertexDataAddress, indexDataAddress, &geometry, &buildInfo);
-
-    uint32_t primitiveCount = meshInfo->indexCount / 3;
-    VkAccelerationStructureBuildSizesInfoKHR sizesInfo = {0};
-    sizesInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
-    vkrt->core.procs.vkGetAccelerationStructureBuildSizesKHR(
-        vkrt->core.device,
-        VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
-        &buildInfo,
-        &primitiveCount,
-        &sizesInfo
-    );
-
-    VkMemoryAllocateFlagsInfo allocFlags = {0};
-    allocFlags.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
-    allocFlags.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+    if (!vkrt || !outAccelerationStructure || accelerationStructureSize == 0) return VKRT_ERROR_INVALID_ARGUMENT;
 
     VkBufferCreateInfo blasBufferCreateInfo = {0};
     blasBufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    blasBufferCreateInfo.size = sizesInfo.accelerationStructureSize;
+    blasBufferCreateInfo.size = accelerationStructureSize;
     blasBufferCreateInfo.usage =
         VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
     blasBufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
@@ -82,39 +69,21 @@ static VKRT_Result prepareBLAS(
         return VKRT_ERROR_OPERATION_FAILED;
     }
 
-    VkMemoryRequirements memReqs = {0};
-    vkGetBufferMemoryRequirements(vkrt->core.device, outAccelerationStructure->buffer, &memReqs);
-
-    VkMemoryAllocateInfo memAlloc = {0};
-    memAlloc.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    memAlloc.pNext = &allocFlags;
-    memAlloc.allocationSize = memReqs.size;
-    if (findMemoryType(vkrt, memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &memAlloc.memoryTypeIndex) !=
-        VKRT_SUCCESS) {
-        vkDestroyBuffer(vkrt->core.device, outAccelerationStructure->buffer, NULL);
-        outAccelerationStructure->buffer = VK_NULL_HANDLE;
-        return VKRT_ERROR_OPERATION_FAILED;
-    }
-
-    if (vkAllocateMemory(vkrt->core.device, &memAlloc, NULL, &outAccelerationStructure->memory) != VK_SUCCESS) {
+    if (vkrtAllocateBufferMemory(
+            vkrt,
+            outAccelerationStructure->buffer,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            &outAccelerationStructure->memory
+        ) != VKRT_SUCCESS) {
         vkDestroyBuffer(vkrt->core.device, outAccelerationStructure->buffer, NULL);
         outAccelerationStructure->buffer = VK_NULL_HANDLE;
         return VKRT_ERROR_OPERATION_FAILED;
     }
 
-    if (vkBindBufferMemory(vkrt->core.device, outAccelerationStructure->buffer, outAccelerationStructure->memory, 0) !=
-        VK_SUCCESS) {
-        vkDestroyBuffer(vkrt->core.device, outAccelerationStructure->buffer, NULL);
-        vkFreeMemory(vkrt->core.device, outAccelerationStructure->memory, NULL);
-        outAccelerationStructure->buffer = VK_NULL_HANDLE;
-        outAccelerationStructure->memory = VK_NULL_HANDLE;
-        return VKRT_ERROR_OPERATION_FAILED;
-    }
-
     VkAccelerationStructureCreateInfoKHR asCreateInfo = {0};
     asCreateInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR;
     asCreateInfo.buffer = outAccelerationStructure->buffer;
-    asCreateInfo.size = sizesInfo.accelerationStructureSize;
+    asCreateInfo.size = accelerationStructureSize;
     asCreateInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
 
     if (vkrt->core.procs.vkCreateAccelerationStructureKHR(
@@ -124,9 +93,8 @@ static VKRT_Result prepareBLAS(
             &outAccelerationStructure->structure
         ) != VK_SUCCESS) {
         vkDestroyBuffer(vkrt->core.device, outAccelerationStructure->buffer, NULL);
-        vkFreeMemory(vkrt->core.device, outAccelerationStructure->memory, NULL);
+        vkrtFreeMemory(vkrt, &outAccelerationStructure->memory);
         outAccelerationStructure->buffer = VK_NULL_HANDLE;
-        outAccelerationStructure->memory = VK_NULL_HANDLE;
         return VKRT_ERROR_OPERATION_FAILED;
     }
 
@@ -135,7 +103,40 @@ static VKRT_Result prepareBLAS(
     addrInfo.accelerationStructure = outAccelerationStructure->structure;
     outAccelerationStructure->deviceAddress =
         vkrt->core.procs.vkGetAccelerationStructureDeviceAddressKHR(vkrt->core.device, &addrInfo);
+    outAccelerationStructure->size = accelerationStructureSize;
+
+    return VKRT_SUCCESS;
+}
+
+static VKRT_Result prepareBLAS(
+    VKRT* vkrt,
+    const MeshInfo* meshInfo,
+    VkDeviceAddress vertexDataAddress,
+    VkDeviceAddress indexDataAddress,
+    AccelerationStructure* outAccelerationStructure
+) {
+    if (!vkrt || !meshInfo || !outAccelerationStructure) return VKRT_ERROR_INVALID_ARGUMENT;
+
+    VkAccelerationStructureGeometryKHR geometry;
+    VkAccelerationStructureBuildGeometryInfoKHR buildInfo;
+    buildBLASGeometryInfo(meshInfo, vertexDataAddress, indexDataAddress, &geometry, &buildInfo);
 
+    uint32_t primitiveCount = meshInfo->indexCount / 3;
+    VkAccelerationStructureBuildSizesInfoKHR sizesInfo = {0};
+    sizesInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
+    vkrt->core.procs.vkGetAccelerationStructureBuildSizesKHR(
+        vkrt->core.device,
+        VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
+        &buildInfo,
+        &primitiveCount,
+        &sizesInfo
+    );
+
+    VKRT_Result result = createBLASStorage(vkrt, sizesInfo.accelerationStructureSize, outAccelerationStructure);
+    if (result != VKRT_SUCCESS) return result;
+
+    outAccelerationStructure->uncompactedSize = sizesInfo.accelerationStructureSize;
+    outAccelerationStructure->buildId = ++vkrt->core.blasBuildCounter;
     return VKRT_SUCCESS;
 }
 
@@ -154,6 +155,80 @@ VKRT_Result createBottomLevelAccelerationStructureForGeometry(
     return prepareBLAS(vkrt, meshInfo, vertexDataAddress, indexDataAddress, outAccelerationStructure);
 }
 
+static VkDeviceSize queryBLASScratchAlignment(VKRT* vkrt) {
+    VkPhysicalDeviceAccelerationStructurePropertiesKHR accelerationStructureProperties = {0};
+    accelerationStructureProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_PROPERTIES_KHR;
+
+    VkPhysicalDeviceProperties2 physicalDeviceProperties2 = {0};
+    physicalDeviceProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    physicalDeviceProperties2.pNext = &accelerationStructureProperties;
+
+    vkGetPhysicalDeviceProperties2(vkrt->core.physicalDevice, &physicalDeviceProperties2);
+    VkDeviceSize alignment = accelerationStructureProperties.minAccelerationStructureScratchOffsetAlignment;
+    return alignment > 0 ? alignment : 1;
+}
+
+static VkDeviceSize alignBLASScratchOffset(VkDeviceSize offset, VkDeviceSize alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+static VKRT_Result reserveBLASScratch(VKRT* vkrt, FrameSceneUpdate* update, VkDeviceSize requiredBytes) {
+    if (update->blasScratch.buffer != VK_NULL_HANDLE && update->blasScratchCapacity >= requiredBytes) {
+        return VKRT_SUCCESS;
+    }
+
+    destroyBufferResources(vkrt, &update->blasScratch);
+    update->blasScratchCapacity = 0;
+    if (createBuffer(
+            vkrt,
+            requiredBytes,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            &update->blasScratch.buffer,
+            &update->blasScratch.memory
+        ) != VKRT_SUCCESS) {
+        return VKRT_ERROR_OPERATION_FAILED;
+    }
+
+    update->blasScratch.deviceAddress = queryBufferDeviceAddress(vkrt, update->blasScratch.buffer);
+    update->blasScratchCapacity = requiredBytes;
+    return VKRT_SUCCESS;
+}
+
+static VKRT_Result reserveBLASCompactionQueries(VKRT* vkrt, FrameSceneUpdate* update, uint32_t queryCount) {
+    if (update->blasCompactionQueryPool != VK_NULL_HANDLE && update->blasCompactionQueryCapacity >= queryCount) {
+        return VKRT_SUCCESS;
+    }
+
+    uint32_t capacity = update->blasCompactionQueryCapacity > 0u ? update->blasCompactionQueryCapacity : 16u;
+    while (capacity < queryCount) {
+        if (capacity > UINT32_MAX / 2u) {
+            capacity = queryCount;
+            break;
+        }
+        capacity *= 2u;
+    }
+
+    if (update->blasCompactionQueryPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(vkrt->core.device, update->blasCompactionQueryPool, NULL);
+        update->blasCompactionQueryPool = VK_NULL_HANDLE;
+        update->blasCompactionQueryCapacity = 0u;
+    }
+
+    VkQueryPoolCreateInfo queryPoolCreateInfo = {0};
+    queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolCreateInfo.queryType = VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR;
+    queryPoolCreateInfo.queryCount = capacity;
+    if (vkCreateQueryPool(vkrt->core.device, &queryPoolCreateInfo, NULL, &update->blasCompactionQueryPool) !=
+        VK_SUCCESS) {
+        update->blasCompactionQueryPool = VK_NULL_HANDLE;
+        return VKRT_ERROR_OPERATION_FAILED;
+    }
+
+    update->blasCompactionQueryCapacity = capacity;
+    return VKRT_SUCCESS;
+}
+
 VKRT_Result prepareBottomLevelAccelerationStructureBuilds(VKRT* vkrt) {
     if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
 
@@ -171,8 +246,10 @@ VKRT_Result prepareBottomLevelAccelerationStructureBuilds(VKRT* vkrt) {
 
     update->blasBuilds = (PendingBLASBuild*)calloc(pendingCount, sizeof(PendingBLASBuild));
     if (!update->blasBuilds) return VKRT_ERROR_OPERATION_FAILED;
-    update->blasBuildCount = pendingCount;
 
+    // Every build in the batch runs concurrently, so each gets its own aligned slice of one shared scratch arena.
+    VkDeviceSize scratchAlignment = queryBLASScratchAlignment(vkrt);
+    VkDeviceSize scratchBytes = 0;
     uint32_t writeIndex = 0;
     for (uint32_t i = 0; i < vkrt->core.meshCount; i++) {
         Mesh* mesh = &vkrt->core.meshes[i];
@@ -183,7 +260,7 @@ VKRT_Result prepareBottomLevelAccelerationStructureBuilds(VKRT* vkrt) {
         VkAccelerationStructureBuildGeometryInfoKHR buildInfo;
         buildBLASGeometryInfo(
             &mesh->info,
-            vkrt->core.vertexData.deviceAddress,
+            vkrt->core.positionData.deviceAddress,
             vkrt->core.indexData.deviceAddress,
             &geometry,
             &buildInfo
@@ -199,30 +276,57 @@ VKRT_Result prepareBottomLevelAccelerationStructureBuilds(VKRT* vkrt) {
             &sizesInfo
         );
 
-        PendingBLASBuild* build = &update->blasBuilds[writeIndex];
+        PendingBLASBuild* build = &update->blasBuilds[writeIndex++];
         build->meshIndex = i;
-        if (createBuffer(
-                vkrt,
-                sizesInfo.buildScratchSize,
-                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
-                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                &build->scratchBuffer,
-                &build->scratchMemory
-            ) != VKRT_SUCCESS) {
-            update->blasBuildCount = writeIndex + 1u;
-            return VKRT_ERROR_OPERATION_FAILED;
-        }
-
-        writeIndex++;
+        build->buildId = mesh->bottomLevelAccelerationStructure.buildId;
+        build->scratchOffset = alignBLASScratchOffset(scratchBytes, scratchAlignment);
+        build->queryIndex = UINT32_MAX;
+        scratchBytes = build->scratchOffset + sizesInfo.buildScratchSize;
     }
+    update->blasBuildCount = writeIndex;
 
-    return VKRT_SUCCESS;
+    VKRT_Result result = reserveBLASScratch(vkrt, update, scratchBytes + scratchAlignment);
+    if (result != VKRT_SUCCESS) return result;
+    return reserveBLASCompactionQueries(vkrt, update, pendingCount);
+}
+
+static void recordBLASCompactionCopies(VKRT* vkrt, VkCommandBuffer commandBuffer, const FrameSceneUpdate* update) {
+    for (uint32_t i = 0; i < update->blasCompactionCount; i++) {
+        const PendingBLASCompaction* compaction = &update->blasCompactions[i];
+        VkCopyAccelerationStructureInfoKHR copyInfo = {0};
+        copyInfo.sType = VK_STRUCTURE_TYPE_COPY_ACCELERATION_STRUCTURE_INFO_KHR;
+        copyInfo.src = compaction->source.structure;
+        copyInfo.dst = compaction->destination;
+        copyInfo.mode = VK_COPY_ACCELERATION_STRUCTURE_MODE_COMPACT_KHR;
+        vkrt->core.procs.vkCmdCopyAccelerationStructureKHR(commandBuffer, &copyInfo);
+    }
 }
 
 VKRT_Result recordBottomLevelAccelerationStructureBuilds(VKRT* vkrt, VkCommandBuffer commandBuffer) {
     if (!vkrt || commandBuffer == VK_NULL_HANDLE) return VKRT_ERROR_INVALID_ARGUMENT;
 
     FrameSceneUpdate* update = vkrtCurrentFrameSceneUpdate(vkrt);
+    recordBLASCompactionCopies(vkrt, commandBuffer, update);
+    if (update->blasBuildCount == 0 || update->blasScratch.buffer == VK_NULL_HANDLE) return VKRT_SUCCESS;
+
+    uint32_t buildCapacity = update->blasBuildCount;
+    VkAccelerationStructureGeometryKHR* geometries =
+        (VkAccelerationStructureGeometryKHR*)calloc(buildCapacity, sizeof(*geometries));
+    VkAccelerationStructureBuildGeometryInfoKHR* buildInfos =
+        (VkAccelerationStructureBuildGeometryInfoKHR*)calloc(buildCapacity, sizeof(*buildInfos));
+    VkAccelerationStructureBuildRangeInfoKHR* rangeInfos =
+        (VkAccelerationStructureBuildRangeInfoKHR*)calloc(buildCapacity, sizeof(*rangeInfos));
+    const VkAccelerationStructureBuildRangeInfoKHR** rangeInfoPointers =
+        (const VkAccelerationStructureBuildRangeInfoKHR**)calloc(buildCapacity, sizeof(*rangeInfoPointers));
+    if (!geometries || !buildInfos || !rangeInfos || !rangeInfoPointers) {
+        free(geometries);
+        free(buildInfos);
+        free(rangeInfos);
+        free((void*)rangeInfoPointers);
+        return VKRT_ERROR_OUT_OF_MEMORY;
+    }
+
+    uint32_t buildCount = 0;
     for (uint32_t i = 0; i < update->blasBuildCount; i++) {
         PendingBLASBuild* pending = &update->blasBuilds[i];
         Mesh* mesh = &vkrt->core.meshes[pending->meshIndex];
@@ -231,32 +335,194 @@ VKRT_Result recordBottomLevelAccelerationStructureBuilds(VKRT* vkrt, VkCommandBu
             continue;
         }
 
-        VkAccelerationStructureGeometryKHR geometry;
-        VkAccelerationStructureBuildGeometryInfoKHR buildInfo;
         buildBLASGeometryInfo(
             &mesh->info,
-            vkrt->core.vertexData.deviceAddress,
+            vkrt->core.positionData.deviceAddress,
             vkrt->core.indexData.deviceAddress,
-            &geometry,
-            &buildInfo
+            &geometries[buildCount],
+            &buildInfos[buildCount]
         );
-        buildInfo.dstAccelerationStructure = mesh->bottomLevelAccelerationStructure.structure;
+        buildInfos[buildCount].dstAccelerationStructure = mesh->bottomLevelAccelerationStructure.structure;
+        buildInfos[buildCount].scratchData.deviceAddress = update->blasScratch.deviceAddress + pending->scratchOffset;
 
-        VkBufferDeviceAddressInfo scratchAddressInfo = {0};
-        scratchAddressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
-        scratchAddressInfo.buffer = pending->scratchBuffer;
-        buildInfo.scratchData.deviceAddress =
-            vkrt->core.procs.vkGetBufferDeviceAddressKHR(vkrt->core.device, &scratchAddressInfo);
+        VkAccelerationStructureBuildRangeInfoKHR* rangeInfo = &rangeInfos[buildCount];
+        rangeInfo->primitiveCount = mesh->info.indexCount / 3u;
+        rangeInfo->primitiveOffset = (uint32_t)(mesh->info.indexBase * sizeof(uint32_t));
+        rangeInfo->firstVertex = mesh->info.vertexBase;
+        rangeInfoPointers[buildCount] = rangeInfo;
 
-        uint32_t primitiveCount = mesh->info.indexCount / 3u;
-        VkAccelerationStructureBuildRangeInfoKHR rangeInfo = {0};
-        rangeInfo.primitiveCount = primitiveCount;
-        rangeInfo.primitiveOffset = (uint32_t)(mesh->info.indexBase * sizeof(uint32_t));
-        rangeInfo.firstVertex = mesh->info.vertexBase;
-        const VkAccelerationStructureBuildRangeInfoKHR* rangeInfos[] = {&rangeInfo};
+        pending->queryIndex = buildCount++;
+    }
 
-        vkrt->core.procs.vkCmdBuildAccelerationStructuresKHR(commandBuffer, 1, &buildInfo, rangeInfos);
+    if (buildCount > 0) {
+        vkrt->core.procs.vkCmdBuildAccelerationStructuresKHR(commandBuffer, buildCount, buildInfos, rangeInfoPointers);
     }
 
+    free(geometries);
+    free(buildInfos);
+    free(rangeInfos);
+    free((void*)rangeInfoPointers);
+    return VKRT_SUCCESS;
+}
+
+VKRT_Result recordBottomLevelAccelerationStructureCompactionQueries(VKRT* vkrt, VkCommandBuffer commandBuffer) {
+    if (!vkrt || commandBuffer == VK_NULL_HANDLE) return VKRT_ERROR_INVALID_ARGUMENT;
+
+    FrameSceneUpdate* update = vkrtCurrentFrameSceneUpdate(vkrt);
+    if (update->blasCompactionQueryPool == VK_NULL_HANDLE || update->blasBuildCount == 0) return VKRT_SUCCESS;
+
+    VkAccelerationStructureKHR* structures =
+        (VkAccelerationStructureKHR*)calloc(update->blasBuildCount, sizeof(*structures));
+    if (!structures) return VKRT_ERROR_OUT_OF_MEMORY;
+
+    uint32_t queryCount = 0;
+    for (uint32_t i = 0; i < update->blasBuildCount; i++) {
+        const PendingBLASBuild* pending = &update->blasBuilds[i];
+        if (pending->queryIndex == UINT32_MAX) continue;
+        const Mesh* mesh = &vkrt->core.meshes[pending->meshIndex];
+        structures[pending->queryIndex] = mesh->bottomLevelAccelerationStructure.structure;
+        queryCount++;
+    }
+
+    if (queryCount > 0) {
+        vkCmdResetQueryPool(commandBuffer, update->blasCompactionQueryPool, 0, queryCount);
+        vkrt->core.procs.vkCmdWriteAccelerationStructuresPropertiesKHR(
+            commandBuffer,
+            queryCount,
+            structures,
+            VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR,
+            update->blasCompactionQueryPool,
+            0
+        );
+    }
+    update->blasCompactionQueryCount = queryCount;
+
+    free(structures);
+    return VKRT_SUCCESS;
+}
+
+void resolveBottomLevelAccelerationStructureCompaction(VKRT* vkrt, uint32_t frameIndex) {
+    if (!vkrt || frameIndex >= VKRT_MAX_FRAMES_IN_FLIGHT) return;
+
+    FrameSceneUpdate* update = &vkrt->runtime.frameSceneUpdates[frameIndex];
+    uint32_t queryCount = update->blasCompactionQueryCount;
+    update->blasCompactionQueryCount = 0;
+    if (queryCount == 0 || update->blasCompactionQueryPool == VK_NULL_HANDLE) return;
+
+    uint64_t* compactedSizes = (uint64_t*)calloc(queryCount, sizeof(*compactedSizes));
+    BLASCompactionCandidate* candidates = (BLASCompactionCandidate*)calloc(queryCount, sizeof(*candidates));
+    if (!compactedSizes || !candidates) {
+        free(compactedSizes);
+        free(candidates);
+        return;
+    }
+
+    VkResult result = vkGetQueryPoolResults(
+        vkrt->core.device,
+        update->blasCompactionQueryPool,
+        0,
+        queryCount,
+        (size_t)queryCount * sizeof(*compactedSizes),
+        compactedSizes,
+        sizeof(*compactedSizes),
+        VK_QUERY_RESULT_64_BIT
+    );
+    if (result != VK_SUCCESS) {
+        free(compactedSizes);
+        free(candidates);
+        return;
+    }
+
+    uint32_t candidateCount = 0;
+    for (uint32_t i = 0; i < update->blasBuildCount; i++) {
+        const PendingBLASBuild* pending = &update->blasBuilds[i];
+        if (pending->queryIndex >= queryCount) continue;
+        candidates[candidateCount++] = (BLASCompactionCandidate){
+            .buildId = pending->buildId,
+            .compactedSize = compactedSizes[pending->queryIndex],
+        };
+    }
+    free(compactedSizes);
+
+    free(update->blasCompactionCandidates);
+    update->blasCompactionCandidates = candidates;
+    update->blasCompactionCandidateCount = candidateCount;
+}
+
+static int32_t findBLASCompactionOwner(const VKRT* vkrt, uint64_t buildId) {
+    for (uint32_t i = 0; i < vkrt->core.meshCount; i++) {
+        const Mesh* mesh = &vkrt->core.meshes[i];
+        if (!mesh->ownsGeometry || mesh->blasBuildPending) continue;
+        if (mesh->bottomLevelAccelerationStructure.buildId == buildId) return (int32_t)i;
+    }
+    return -1;
+}
+
+static void syncCompactedBLASReferences(VKRT* vkrt, uint32_t ownerIndex) {
+    VkDeviceAddress deviceAddress = vkrt->core.meshes[ownerIndex].bottomLevelAccelerationStructure.deviceAddress;
+    for (uint32_t i = 0; i < vkrt->core.meshCount; i++) {
+        Mesh* mesh = &vkrt->core.meshes[i];
+        if (mesh->ownsGeometry || mesh->geometrySource != ownerIndex) continue;
+        mesh->bottomLevelAccelerationStructure.deviceAddress = deviceAddress;
+    }
+}
+
+VKRT_Result compactBottomLevelAccelerationStructures(VKRT* vkrt) {
+    if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
+
+    FrameSceneUpdate* update = vkrtCurrentFrameSceneUpdate(vkrt);
+    uint32_t candidateCount = update->blasCompactionCandidateCount;
+    if (candidateCount == 0) return VKRT_SUCCESS;
+
+    PendingBLASCompaction* compactions = (PendingBLASCompaction*)realloc(
+        update->blasCompactions,
+        (size_t)(update->blasCompactionCount + candidateCount) * sizeof(*compactions)
+    );
+    if (!compactions) return VKRT_ERROR_OUT_OF_MEMORY;
+    update->blasCompactions = compactions;
+
+    VkDeviceSize bytesBefore = 0;
+    VkDeviceSize bytesAfter = 0;
+    uint32_t compactedCount = 0;
+    for (uint32_t i = 0; i < candidateCount; i++) {
+        const BLASCompactionCandidate* candidate = &update->blasCompactionCandidates[i];
+        int32_t ownerIndex = findBLASCompactionOwner(vkrt, candidate->buildId);
+        if (ownerIndex < 0) continue;
+
+        AccelerationStructure* current = &vkrt->core.meshes[ownerIndex].bottomLevelAccelerationStructure;
+        if (candidate->compactedSize == 0 || candidate->compactedSize >= current->size) continue;
+
+        AccelerationStructure compacted = {0};
+        if (createBLASStorage(vkrt, candidate->compactedSize, &compacted) != VKRT_SUCCESS) {
+            LOG_ERROR("Failed to allocate compacted BLAS storage");
+            continue;
+        }
+        compacted.uncompactedSize = current->uncompactedSize;
+        compacted.buildId = current->buildId;
+
+        bytesBefore += current->size;
+        bytesAfter += compacted.size;
+        update->blasCompactions[update->blasCompactionCount++] = (PendingBLASCompaction){
+            .source = *current,
+            .destination = compacted.structure,
+        };
+        *current = compacted;
+        syncCompactedBLASReferences(vkrt, (uint32_t)ownerIndex);
+        compactedCount++;
+    }
+
+    free(update->blasCompactionCandidates);
+    update->blasCompactionCandidates = NULL;
+    update->blasCompactionCandidateCount = 0;
+
+    if (compactedCount > 0) {
+        LOG_TRACE(
+            "Compacted %u BLAS from %llu to %llu bytes",
+            compactedCount,
+            (unsigned long long)bytesBefore,
+            (unsigned long long)bytesAfter
+        );
+        vkrtMarkSceneResourcesDirty(vkrt);
+    }
     return VKRT_SUCCESS;
 }
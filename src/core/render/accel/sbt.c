@@ -1,8 +1,9 @@
 #include "accel.h"
+#include "allocator.h"
 #include "buffer.h"
 #include "debug.h"
-#include "device.h"
 #include "platform.h"
+#include "staging.h"
 #include "vkrt_internal.h"
 #include "vkrt_types.h"
 #include "vulkan/vulkan_core.h"
@@ -13,7 +14,7 @@
 
 typedef struct ShaderBindingTableBuildOutput {
     VkBuffer* buffer;
-    VkDeviceMemory* memory;
+    MemoryAllocation* memory;
     VkStridedDeviceAddressRegionKHR* tables;
 } ShaderBindingTableBuildOutput;
 
@@ -38,10 +39,11 @@ static void logShaderBindingTableUploaded(const char* label, uint64_t startTime)
     LOG_TRACE("%s SBT uploaded in %.3f ms", label ? label : "RT", (double)(getMicroseconds() - startTime) / 1e3);
 }
 
-static void destroyShaderBindingTableStageResources(VKRT* vkrt, VkBuffer buffer, VkDeviceMemory memory) {
+static void destroyShaderBindingTableBuffer(VKRT* vkrt, VkBuffer* buffer, MemoryAllocation* memory) {
     if (!vkrt) return;
-    if (buffer != VK_NULL_HANDLE) vkDestroyBuffer(vkrt->core.device, buffer, NULL);
-    if (memory != VK_NULL_HANDLE) vkFreeMemory(vkrt->core.device, memory, NULL);
+    if (*buffer != VK_NULL_HANDLE) vkDestroyBuffer(vkrt->core.device, *buffer, NULL);
+    *buffer = VK_NULL_HANDLE;
+    vkrtFreeMemory(vkrt, memory);
 }
 
 static VKRT_Result createShaderBindingTableStageBuffer(
@@ -50,25 +52,15 @@ static VKRT_Result createShaderBindingTableStageBuffer(
     uint32_t groupCount,
     VkDeviceSize handleSize,
     VkDeviceSize stride,
-    VkBuffer* outStageBuffer,
-    VkDeviceMemory* outStageMemory
+    StagingAllocation* outStage
 ) {
-    if (createBuffer(
-            vkrt,
-            groupCount * stride,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            outStageBuffer,
-            outStageMemory
-        ) != VKRT_SUCCESS) {
+    if (vkrtAllocateStaging(vkrt, groupCount * stride, outStage) != VKRT_SUCCESS) {
         return VKRT_ERROR_OPERATION_FAILED;
     }
 
     uint8_t* handles = (uint8_t*)malloc(groupCount * handleSize);
     if (!handles) {
-        destroyShaderBindingTableStageResources(vkrt, *outStageBuffer, *outStageMemory);
-        *outStageBuffer = VK_NULL_HANDLE;
-        *outStageMemory = VK_NULL_HANDLE;
+        vkrtReleaseStaging(vkrt, outStage);
         return VKRT_ERROR_OPERATION_FAILED;
     }
 
@@ -82,26 +74,13 @@ static VKRT_Result createShaderBindingTableStageBuffer(
     );
     if (handlesResult != VK_SUCCESS) {
         free(handles);
-        destroyShaderBindingTableStageResources(vkrt, *outStageBuffer, *outStageMemory);
-        *outStageBuffer = VK_NULL_HANDLE;
-        *outStageMemory = VK_NULL_HANDLE;
-        return VKRT_ERROR_OPERATION_FAILED;
-    }
-
-    void* mapped = NULL;
-    VkResult mapResult = vkMapMemory(vkrt->core.device, *outStageMemory, 0, groupCount * stride, 0, &mapped);
-    if (mapResult != VK_SUCCESS || !mapped) {
-        free(handles);
-        destroyShaderBindingTableStageResources(vkrt, *outStageBuffer, *outStageMemory);
-        *outStageBuffer = VK_NULL_HANDLE;
-        *outStageMemory = VK_NULL_HANDLE;
+        vkrtReleaseStaging(vkrt, outStage);
         return VKRT_ERROR_OPERATION_FAILED;
     }
 
     for (uint32_t groupIndex = 0; groupIndex < groupCount; groupIndex++) {
-        memcpy(((uint8_t*)mapped) + (groupIndex * stride), handles + (groupIndex * handleSize), handleSize);
+        memcpy(((uint8_t*)outStage->mapped) + (groupIndex * stride), handles + (groupIndex * handleSize), handleSize);
     }
-    vkUnmapMemory(vkrt->core.device, *outStageMemory);
     free(handles);
     return VKRT_SUCCESS;
 }
@@ -122,38 +101,10 @@ static VKRT_Result createShaderBindingTableDeviceBuffer(
         return VKRT_ERROR_OPERATION_FAILED;
     }
 
-    VkMemoryRequirements memoryRequirements = {0};
-    vkGetBufferMemoryRequirements(vkrt->core.device, *output->buffer, &memoryRequirements);
-
-    VkMemoryAllocateFlagsInfo memoryAllocateFlagsInfo = {0};
-    memoryAllocateFlagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
-    memoryAllocateFlagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
-
-    VkMemoryAllocateInfo memoryAllocateInfo = {0};
-    memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    memoryAllocateInfo.pNext = &memoryAllocateFlagsInfo;
-    memoryAllocateInfo.allocationSize = memoryRequirements.size;
-    if (findMemoryType(
-            vkrt,
-            memoryRequirements.memoryTypeBits,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            &memoryAllocateInfo.memoryTypeIndex
-        ) != VKRT_SUCCESS) {
-        vkDestroyBuffer(vkrt->core.device, *output->buffer, NULL);
-        *output->buffer = VK_NULL_HANDLE;
-        return VKRT_ERROR_OPERATION_FAILED;
-    }
-
-    if (vkAllocateMemory(vkrt->core.device, &memoryAllocateInfo, NULL, output->memory) != VK_SUCCESS) {
-        vkDestroyBuffer(vkrt->core.device, *output->buffer, NULL);
-        *output->buffer = VK_NULL_HANDLE;
-        return VKRT_ERROR_OPERATION_FAILED;
-    }
-    if (vkBindBufferMemory(vkrt->core.device, *output->buffer, *output->memory, 0) != VK_SUCCESS) {
+    if (vkrtAllocateBufferMemory(vkrt, *output->buffer, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, output->memory) !=
+        VKRT_SUCCESS) {
         vkDestroyBuffer(vkrt->core.device, *output->buffer, NULL);
-        vkFreeMemory(vkrt->core.device, *output->memory, NULL);
         *output->buffer = VK_NULL_HANDLE;
-        *output->memory = VK_NULL_HANDLE;
         return VKRT_ERROR_OPERATION_FAILED;
     }
     return VKRT_SUCCESS;
@@ -230,36 +181,24 @@ static VKRT_Result createShaderBindingTableForPipeline(
     VkDeviceSize stride = rayTracingPipelineProperties.shaderGroupBaseAlignment;
     VkDeviceSize sbtSize = groupCount * stride;
 
-    VkBuffer stageBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory stageMemory = VK_NULL_HANDLE;
-    if (createShaderBindingTableStageBuffer(
-            vkrt,
-            pipeline,
-            groupCount,
-            handleSize,
-            stride,
-            &stageBuffer,
-            &stageMemory
-        ) != VKRT_SUCCESS) {
+    StagingAllocation stage = {0};
+    if (createShaderBindingTableStageBuffer(vkrt, pipeline, groupCount, handleSize, stride, &stage) != VKRT_SUCCESS) {
         return VKRT_ERROR_OPERATION_FAILED;
     }
     logShaderBindingTableHandlesReady(label, handlesStartTime, groupCount, stride, sbtSize);
 
     uint64_t uploadStartTime = getMicroseconds();
     if (createShaderBindingTableDeviceBuffer(vkrt, sbtSize, &output) != VKRT_SUCCESS) {
-        destroyShaderBindingTableStageResources(vkrt, stageBuffer, stageMemory);
+        vkrtReleaseStaging(vkrt, &stage);
         return VKRT_ERROR_OPERATION_FAILED;
     }
 
-    if (copyBuffer(vkrt, stageBuffer, *output.buffer, sbtSize) != VKRT_SUCCESS) {
-        vkDestroyBuffer(vkrt->core.device, *output.buffer, NULL);
-        vkFreeMemory(vkrt->core.device, *output.memory, NULL);
-        *output.buffer = VK_NULL_HANDLE;
-        *output.memory = VK_NULL_HANDLE;
-        destroyShaderBindingTableStageResources(vkrt, stageBuffer, stageMemory);
+    if (copyBuffer(vkrt, stage.buffer, stage.offset, *output.buffer, sbtSize) != VKRT_SUCCESS) {
+        destroyShaderBindingTableBuffer(vkrt, output.buffer, output.memory);
+        vkrtReleaseStaging(vkrt, &stage);
         return VKRT_ERROR_OPERATION_FAILED;
     }
-    destroyShaderBindingTableStageResources(vkrt, stageBuffer, stageMemory);
+    vkrtReleaseStaging(vkrt, &stage);
     buildShaderBindingTableRegions(
         vkrt,
         *output.buffer,
@@ -1,7 +1,7 @@
 #include "accel.h"
+#include "allocator.h"
 #include "buffer.h"
 #include "constants.h"
-#include "device.h"
 #include "geometry.h"
 #include "scene.h"
 #include "state.h"
@@ -13,179 +13,165 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
-typedef struct TLASBuildResources {
+static const uint32_t kTLASMaxRefitsBeforeRebuild = 64u;
+static const VkBuildAccelerationStructureFlagsKHR kTLASBuildFlags =
+    VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR | VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR;
+
+typedef struct TLASBuildTarget {
     AccelerationStructure* accelerationStructure;
-    FrameTransfer* instanceBuffer;
-    FrameTransfer* scratchBuffer;
+    TLASState* state;
+    VkBuildAccelerationStructureModeKHR* buildMode;
     VkBool32* buildPending;
-} TLASBuildResources;
-
-typedef struct PreparedTLASState {
-    Buffer meshData;
-    AccelerationStructure sceneTLAS;
-    AccelerationStructure selectionTLAS;
-    FrameTransfer sceneTLASInstanceBuffer;
-    FrameTransfer sceneTLASScratch;
-    FrameTransfer selectionTLASInstanceBuffer;
-    FrameTransfer selectionTLASScratch;
-    uint32_t sceneTLASInstanceCount;
-    uint32_t selectionTLASInstanceCount;
-    VkBool32 sceneTLASBuildPending;
-    VkBool32 selectionTLASBuildPending;
-} PreparedTLASState;
-
-static TLASBuildResources querySceneTLASBuildResources(PreparedTLASState* state) {
-    return (TLASBuildResources){
-        .accelerationStructure = &state->sceneTLAS,
-        .instanceBuffer = &state->sceneTLASInstanceBuffer,
-        .scratchBuffer = &state->sceneTLASScratch,
-        .buildPending = &state->sceneTLASBuildPending,
+} TLASBuildTarget;
+
+typedef struct TLASInstanceWriteSummary {
+    uint32_t changedCount;
+    VkBool32 referencesChanged;
+} TLASInstanceWriteSummary;
+
+static TLASBuildTarget querySceneTLASBuildTarget(VKRT* vkrt) {
+    FrameSceneUpdate* update = vkrtCurrentFrameSceneUpdate(vkrt);
+    return (TLASBuildTarget){
+        .accelerationStructure = &vkrt->core.sceneTopLevelAccelerationStructure,
+        .state = &vkrt->core.sceneTLASState,
+        .buildMode = &update->sceneTLASBuildMode,
+        .buildPending = &update->sceneTLASBuildPending,
     };
 }
 
-static TLASBuildResources querySelectionTLASBuildResources(PreparedTLASState* state) {
-    return (TLASBuildResources){
-        .accelerationStructure = &state->selectionTLAS,
-        .instanceBuffer = &state->selectionTLASInstanceBuffer,
-        .scratchBuffer = &state->selectionTLASScratch,
-        .buildPending = &state->selectionTLASBuildPending,
+static TLASBuildTarget querySelectionTLASBuildTarget(VKRT* vkrt) {
+    FrameSceneUpdate* update = vkrtCurrentFrameSceneUpdate(vkrt);
+    return (TLASBuildTarget){
+        .accelerationStructure = &vkrt->core.selectionTopLevelAccelerationStructure,
+        .state = &vkrt->core.selectionTLASState,
+        .buildMode = &update->selectionTLASBuildMode,
+        .buildPending = &update->selectionTLASBuildPending,
     };
 }
 
-static void resetTLASBuildResources(VKRT* vkrt, const TLASBuildResources* resources) {
-    if (!vkrt || !resources) return;
-    destroyTransfer(vkrt, resources->instanceBuffer);
-    destroyTransfer(vkrt, resources->scratchBuffer);
-    vkrtDestroyAccelerationStructureResources(vkrt, resources->accelerationStructure);
-    if (resources->buildPending) {
-        *resources->buildPending = VK_FALSE;
-    }
+static void destroyTLASState(VKRT* vkrt, TLASState* state) {
+    if (!vkrt || !state) return;
+
+    destroyTransfer(vkrt, &state->instanceBuffer);
+    destroyTransfer(vkrt, &state->scratchBuffer);
+    free(state->hostInstances);
+    *state = (TLASState){0};
+}
+
+static void resetTLASBuildTarget(VKRT* vkrt, const TLASBuildTarget* target) {
+    if (!vkrt || !target) return;
+
+    destroyTLASState(vkrt, target->state);
+    vkrtDestroyAccelerationStructureResources(vkrt, target->accelerationStructure);
+    *target->buildMode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
+    *target->buildPending = VK_FALSE;
+}
+
+static void fillTLASGeometry(VkDeviceAddress instanceDeviceAddress, VkAccelerationStructureGeometryKHR* outGeometry) {
+    VkAccelerationStructureGeometryInstancesDataKHR geometryInstancesData = {0};
+    geometryInstancesData.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
+    geometryInstancesData.arrayOfPointers = VK_FALSE;
+    geometryInstancesData.data.deviceAddress = instanceDeviceAddress;
+
+    *outGeometry = (VkAccelerationStructureGeometryKHR){0};
+    outGeometry->sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
+    outGeometry->geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR;
+    outGeometry->geometry.instances = geometryInstancesData;
+    outGeometry->flags = VK_GEOMETRY_OPAQUE_BIT_KHR;
 }
 
 static VKRT_Result createTLASAccelerationStructure(
     VKRT* vkrt,
-    TLASBuildResources* resources,
-    const VkAccelerationStructureBuildSizesInfoKHR* buildSizesInfo
+    VkDeviceSize accelerationStructureSize,
+    AccelerationStructure* outAccelerationStructure
 ) {
-    if (!vkrt || !resources || !buildSizesInfo) return VKRT_ERROR_INVALID_ARGUMENT;
+    if (!vkrt || !outAccelerationStructure) return VKRT_ERROR_INVALID_ARGUMENT;
 
     uint32_t graphicsFamily = vkrt->core.indices.graphics;
     VkBufferCreateInfo tlasBufferCreateInfo = {0};
     tlasBufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    tlasBufferCreateInfo.size = buildSizesInfo->accelerationStructureSize;
+    tlasBufferCreateInfo.size = accelerationStructureSize;
     tlasBufferCreateInfo.usage =
         VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
     tlasBufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     tlasBufferCreateInfo.queueFamilyIndexCount = 1;
     tlasBufferCreateInfo.pQueueFamilyIndices = &graphicsFamily;
 
-    if (vkCreateBuffer(vkrt->core.device, &tlasBufferCreateInfo, NULL, &resources->accelerationStructure->buffer) !=
+    if (vkCreateBuffer(vkrt->core.device, &tlasBufferCreateInfo, NULL, &outAccelerationStructure->buffer) !=
         VK_SUCCESS) {
         return VKRT_ERROR_OPERATION_FAILED;
     }
 
-    VkMemoryRequirements tlasMemoryRequirements = {0};
-    vkGetBufferMemoryRequirements(vkrt->core.device, resources->accelerationStructure->buffer, &tlasMemoryRequirements);
-
-    VkMemoryAllocateFlagsInfo allocateFlags = {0};
-    allocateFlags.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
-    allocateFlags.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
-
-    VkMemoryAllocateInfo tlasAllocateInfo = {0};
-    tlasAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    tlasAllocateInfo.pNext = &allocateFlags;
-    tlasAllocateInfo.allocationSize = tlasMemoryRequirements.size;
-    if (findMemoryType(
+    if (vkrtAllocateBufferMemory(
             vkrt,
-            tlasMemoryRequirements.memoryTypeBits,
+            outAccelerationStructure->buffer,
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            &tlasAllocateInfo.memoryTypeIndex
+            &outAccelerationStructure->memory
         ) != VKRT_SUCCESS) {
         return VKRT_ERROR_OPERATION_FAILED;
     }
 
-    if (vkAllocateMemory(vkrt->core.device, &tlasAllocateInfo, NULL, &resources->accelerationStructure->memory) !=
-        VK_SUCCESS) {
-        return VKRT_ERROR_OPERATION_FAILED;
-    }
-
-    if (vkBindBufferMemory(
-            vkrt->core.device,
-            resources->accelerationStructure->buffer,
-            resources->accelerationStructure->memory,
-            0
-        ) != VK_SUCCESS) {
-        return VKRT_ERROR_OPERATION_FAILED;
-    }
-
     VkAccelerationStructureCreateInfoKHR createInfo = {0};
     createInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR;
-    createInfo.buffer = resources->accelerationStructure->buffer;
-    createInfo.size = buildSizesInfo->accelerationStructureSize;
+    createInfo.buffer = outAccelerationStructure->buffer;
+    createInfo.size = accelerationStructureSize;
     createInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
 
     if (vkrt->core.procs.vkCreateAccelerationStructureKHR(
             vkrt->core.device,
             &createInfo,
             NULL,
-            &resources->accelerationStructure->structure
+            &outAccelerationStructure->structure
         ) != VK_SUCCESS) {
         return VKRT_ERROR_OPERATION_FAILED;
     }
 
     VkAccelerationStructureDeviceAddressInfoKHR addressInfo = {0};
     addressInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR;
-    addressInfo.accelerationStructure = resources->accelerationStructure->structure;
-    resources->accelerationStructure->deviceAddress =
+    addressInfo.accelerationStructure = outAccelerationStructure->structure;
+    outAccelerationStructure->deviceAddress =
         vkrt->core.procs.vkGetAccelerationStructureDeviceAddressKHR(vkrt->core.device, &addressInfo);
     return VKRT_SUCCESS;
 }
 
-static VKRT_Result prepareTLASBuild(
+static VKRT_Result createTLASState(
     VKRT* vkrt,
-    const TLASBuildResources* resources,
-    const VkAccelerationStructureInstanceKHR* instances,
-    uint32_t instanceCount
+    uint32_t instanceCapacity,
+    TLASState* outState,
+    AccelerationStructure* outAccelerationStructure
 ) {
-    if (!vkrt || !resources) return VKRT_ERROR_INVALID_ARGUMENT;
-
-    resetTLASBuildResources(vkrt, resources);
-
-    VkDeviceAddress instanceDeviceAddress = 0;
-    VkAccelerationStructureInstanceKHR emptyInstance = {0};
-    const VkAccelerationStructureInstanceKHR* instanceData = instances ? instances : &emptyInstance;
-    uint32_t sizeQueryCount = instanceCount > 0u ? instanceCount : 1u;
+    if (!vkrt || !outState || !outAccelerationStructure || instanceCapacity == 0u) {
+        return VKRT_ERROR_INVALID_ARGUMENT;
+    }
 
-    VKRT_Result result = createDeviceBufferFromData(
+    VkDeviceSize instanceBytes = (VkDeviceSize)instanceCapacity * sizeof(VkAccelerationStructureInstanceKHR);
+    VKRT_Result result = createBuffer(
         vkrt,
-        instanceData,
-        sizeof(*instanceData) * sizeQueryCount,
+        instanceBytes,
         VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
             VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
-        &resources->instanceBuffer->buffer,
-        &resources->instanceBuffer->memory,
-        &instanceDeviceAddress
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        &outState->instanceBuffer.buffer,
+        &outState->instanceBuffer.memory
     );
-    if (result != VKRT_SUCCESS) {
-        return result;
-    }
+    if (result != VKRT_SUCCESS) return result;
 
-    VkAccelerationStructureGeometryInstancesDataKHR geometryInstancesData = {0};
-    geometryInstancesData.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
-    geometryInstancesData.arrayOfPointers = VK_FALSE;
-    geometryInstancesData.data.deviceAddress = instanceDeviceAddress;
+    outState->mappedInstances = (VkAccelerationStructureInstanceKHR*)vkrtMappedMemory(outState->instanceBuffer.memory);
+    if (!outState->mappedInstances) return VKRT_ERROR_OPERATION_FAILED;
+
+    outState->hostInstances =
+        (VkAccelerationStructureInstanceKHR*)calloc(instanceCapacity, sizeof(*outState->hostInstances));
+    if (!outState->hostInstances) return VKRT_ERROR_OUT_OF_MEMORY;
 
     VkAccelerationStructureGeometryKHR accelerationGeometry = {0};
-    accelerationGeometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
-    accelerationGeometry.geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR;
-    accelerationGeometry.geometry.instances = geometryInstancesData;
-    accelerationGeometry.flags = VK_GEOMETRY_OPAQUE_BIT_KHR;
+    fillTLASGeometry(queryBufferDeviceAddress(vkrt, outState->instanceBuffer.buffer), &accelerationGeometry);
 
     VkAccelerationStructureBuildGeometryInfoKHR buildInfo = {0};
     buildInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
     buildInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
-    buildInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
+    buildInfo.flags = kTLASBuildFlags;
     buildInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
     buildInfo.geometryCount = 1;
     buildInfo.pGeometries = &accelerationGeometry;
@@ -196,95 +182,142 @@ static VKRT_Result prepareTLASBuild(
         vkrt->core.device,
         VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
         &buildInfo,
-        &sizeQueryCount,
+        &instanceCapacity,
         &buildSizesInfo
     );
 
-    result = createTLASAccelerationStructure(vkrt, (TLASBuildResources*)resources, &buildSizesInfo);
-    if (result != VKRT_SUCCESS) {
-        resetTLASBuildResources(vkrt, resources);
-        return result;
-    }
+    result = createTLASAccelerationStructure(vkrt, buildSizesInfo.accelerationStructureSize, outAccelerationStructure);
+    if (result != VKRT_SUCCESS) return result;
 
+    VkDeviceSize scratchSize = buildSizesInfo.buildScratchSize > buildSizesInfo.updateScratchSize
+                                 ? buildSizesInfo.buildScratchSize
+                                 : buildSizesInfo.updateScratchSize;
     result = createBuffer(
         vkrt,
-        buildSizesInfo.buildScratchSize,
+        scratchSize,
         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        &resources->scratchBuffer->buffer,
-        &resources->scratchBuffer->memory
+        &outState->scratchBuffer.buffer,
+        &outState->scratchBuffer.memory
     );
+    if (result != VKRT_SUCCESS) return result;
+
+    outState->instanceCapacity = instanceCapacity;
+    return VKRT_SUCCESS;
+}
+
+static uint32_t queryGrownTLASCapacity(uint32_t currentCapacity, uint32_t requiredCapacity) {
+    uint32_t capacity = currentCapacity > 0u ? currentCapacity : 1u;
+    while (capacity < requiredCapacity) {
+        if (capacity > UINT32_MAX / 2u) return requiredCapacity;
+        capacity *= 2u;
+    }
+    return capacity;
+}
+
+static VKRT_Result reserveTLASInstances(VKRT* vkrt, const TLASBuildTarget* target, uint32_t instanceCount) {
+    if (!vkrt || !target) return VKRT_ERROR_INVALID_ARGUMENT;
+
+    uint32_t requiredCapacity = instanceCount > 0u ? instanceCount : 1u;
+    if (target->accelerationStructure->structure != VK_NULL_HANDLE &&
+        target->state->instanceCapacity >= requiredCapacity) {
+        return VKRT_SUCCESS;
+    }
+
+    TLASState nextState = {0};
+    AccelerationStructure nextAccelerationStructure = {0};
+    uint32_t capacity = queryGrownTLASCapacity(target->state->instanceCapacity, requiredCapacity);
+    VKRT_Result result = createTLASState(vkrt, capacity, &nextState, &nextAccelerationStructure);
     if (result != VKRT_SUCCESS) {
-        resetTLASBuildResources(vkrt, resources);
+        destroyTLASState(vkrt, &nextState);
+        vkrtDestroyAccelerationStructureResources(vkrt, &nextAccelerationStructure);
         return result;
     }
 
-    *resources->buildPending = VK_TRUE;
+    resetTLASBuildTarget(vkrt, target);
+    *target->state = nextState;
+    *target->accelerationStructure = nextAccelerationStructure;
     return VKRT_SUCCESS;
 }
 
-static void destroyPreparedTLASState(VKRT* vkrt, PreparedTLASState* state) {
-    if (!vkrt || !state) return;
+static void writeTLASInstance(
+    TLASState* state,
+    uint32_t instanceIndex,
+    const VkAccelerationStructureInstanceKHR* instance,
+    TLASInstanceWriteSummary* summary
+) {
+    VkAccelerationStructureInstanceKHR* cached = &state->hostInstances[instanceIndex];
+    if (memcmp(cached, instance, sizeof(*instance)) == 0) return;
 
-    TLASBuildResources sceneResources = querySceneTLASBuildResources(state);
-    TLASBuildResources selectionResources = querySelectionTLASBuildResources(state);
-    destroyBufferResources(vkrt, &state->meshData);
-    resetTLASBuildResources(vkrt, &sceneResources);
-    resetTLASBuildResources(vkrt, &selectionResources);
+    if (cached->accelerationStructureReference != instance->accelerationStructureReference) {
+        summary->referencesChanged = VK_TRUE;
+    }
+    *cached = *instance;
+    state->mappedInstances[instanceIndex] = *instance;
+    summary->changedCount++;
 }
 
-static VKRT_Result recordTLASBuild(
-    VKRT* vkrt,
-    VkCommandBuffer commandBuffer,
-    const TLASBuildResources* resources,
-    uint32_t instanceCount
+static void scheduleTLASBuild(
+    const TLASBuildTarget* target,
+    uint32_t instanceCount,
+    const TLASInstanceWriteSummary* summary
 ) {
-    if (!vkrt || commandBuffer == VK_NULL_HANDLE || !resources || !resources->buildPending) {
-        return VKRT_ERROR_INVALID_ARGUMENT;
-    }
-    if (!*resources->buildPending) return VKRT_SUCCESS;
-    if (resources->accelerationStructure->structure == VK_NULL_HANDLE ||
-        resources->instanceBuffer->buffer == VK_NULL_HANDLE || resources->scratchBuffer->buffer == VK_NULL_HANDLE) {
-        return VKRT_SUCCESS;
+    TLASState* state = target->state;
+    VkBool32 countChanged = state->instanceCount != instanceCount;
+    if (state->built && !countChanged && summary->changedCount == 0u) return;
+
+    VkBool32 canRefit = state->built && !countChanged && !summary->referencesChanged && instanceCount > 0u &&
+                        state->refitCount < kTLASMaxRefitsBeforeRebuild;
+    if (canRefit) {
+        state->refitCount++;
+        *target->buildMode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR;
+    } else {
+        state->refitCount = 0u;
+        state->built = VK_FALSE;
+        *target->buildMode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
     }
 
-    VkBufferDeviceAddressInfo instanceAddressInfo = {0};
-    instanceAddressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
-    instanceAddressInfo.buffer = resources->instanceBuffer->buffer;
-    VkDeviceAddress instanceDeviceAddress =
-        vkrt->core.procs.vkGetBufferDeviceAddressKHR(vkrt->core.device, &instanceAddressInfo);
+    state->instanceCount = instanceCount;
+    *target->buildPending = VK_TRUE;
+}
 
-    VkBufferDeviceAddressInfo scratchAddressInfo = {0};
-    scratchAddressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
-    scratchAddressInfo.buffer = resources->scratchBuffer->buffer;
+static VKRT_Result recordTLASBuild(VKRT* vkrt, VkCommandBuffer commandBuffer, const TLASBuildTarget* target) {
+    if (!vkrt || commandBuffer == VK_NULL_HANDLE || !target) {
+        return VKRT_ERROR_INVALID_ARGUMENT;
+    }
+    if (!*target->buildPending) return VKRT_SUCCESS;
 
-    VkAccelerationStructureGeometryInstancesDataKHR geometryInstancesData = {0};
-    geometryInstancesData.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
-    geometryInstancesData.arrayOfPointers = VK_FALSE;
-    geometryInstancesData.data.deviceAddress = instanceDeviceAddress;
+    TLASState* state = target->state;
+    if (target->accelerationStructure->structure == VK_NULL_HANDLE ||
+        state->instanceBuffer.buffer == VK_NULL_HANDLE || state->scratchBuffer.buffer == VK_NULL_HANDLE) {
+        return VKRT_SUCCESS;
+    }
 
     VkAccelerationStructureGeometryKHR accelerationGeometry = {0};
-    accelerationGeometry.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
-    accelerationGeometry.geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR;
-    accelerationGeometry.geometry.instances = geometryInstancesData;
-    accelerationGeometry.flags = VK_GEOMETRY_OPAQUE_BIT_KHR;
+    fillTLASGeometry(queryBufferDeviceAddress(vkrt, state->instanceBuffer.buffer), &accelerationGeometry);
 
+    VkBuildAccelerationStructureModeKHR mode = *target->buildMode;
     VkAccelerationStructureBuildGeometryInfoKHR buildInfo = {0};
     buildInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
     buildInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
-    buildInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
-    buildInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
+    buildInfo.flags = kTLASBuildFlags;
+    buildInfo.mode = mode;
     buildInfo.geometryCount = 1;
     buildInfo.pGeometries = &accelerationGeometry;
-    buildInfo.dstAccelerationStructure = resources->accelerationStructure->structure;
-    buildInfo.scratchData.deviceAddress =
-        vkrt->core.procs.vkGetBufferDeviceAddressKHR(vkrt->core.device, &scratchAddressInfo);
+    buildInfo.srcAccelerationStructure =
+        mode == VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR ? target->accelerationStructure->structure
+                                                                 : VK_NULL_HANDLE;
+    buildInfo.dstAccelerationStructure = target->accelerationStructure->structure;
+    buildInfo.scratchData.deviceAddress = queryBufferDeviceAddress(vkrt, state->scratchBuffer.buffer);
 
     VkAccelerationStructureBuildRangeInfoKHR buildRangeInfo = {0};
-    buildRangeInfo.primitiveCount = instanceCount;
+    buildRangeInfo.primitiveCount = state->instanceCount;
     const VkAccelerationStructureBuildRangeInfoKHR* buildRangeInfos[] = {&buildRangeInfo};
 
     vkrt->core.procs.vkCmdBuildAccelerationStructuresKHR(commandBuffer, 1, &buildInfo, buildRangeInfos);
+    if (mode == VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR) {
+        state->built = VK_TRUE;
+    }
     return VKRT_SUCCESS;
 }
 
@@ -358,202 +391,82 @@ static VkBool32 buildSelectionTLASInstance(const VKRT* vkrt, VkAccelerationStruc
     return VK_TRUE;
 }
 
-static VKRT_Result allocateSceneTLASInstances(
-    const VKRT* vkrt,
-    VkAccelerationStructureInstanceKHR** outInstances,
-    uint32_t* outInstanceCount
-) {
-    if (outInstances) *outInstances = NULL;
-    if (outInstanceCount) *outInstanceCount = 0u;
-    if (!vkrt || !outInstances || !outInstanceCount) return VKRT_ERROR_INVALID_ARGUMENT;
+static VKRT_Result prepareSceneTLAS(VKRT* vkrt) {
+    if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
 
     uint32_t meshCount = vkrt->core.meshCount;
-    if (meshCount == 0u) return VKRT_SUCCESS;
-
-    VkAccelerationStructureInstanceKHR* instances =
-        (VkAccelerationStructureInstanceKHR*)malloc(sizeof(*instances) * meshCount);
-    if (!instances) return VKRT_ERROR_OPERATION_FAILED;
-
     for (uint32_t meshIndex = 0; meshIndex < meshCount; meshIndex++) {
-        if (!buildTLASInstanceForMesh(vkrt, meshIndex, &instances[meshIndex])) {
-            free(instances);
+        if (vkrt->core.meshes[meshIndex].bottomLevelAccelerationStructure.deviceAddress == 0) {
             return VKRT_ERROR_OPERATION_FAILED;
         }
     }
 
-    *outInstances = instances;
-    *outInstanceCount = meshCount;
-    return VKRT_SUCCESS;
-}
-
-static VKRT_Result prepareSceneTLASState(
-    VKRT* vkrt,
-    PreparedTLASState* state,
-    const VkAccelerationStructureInstanceKHR* sceneInstances,
-    uint32_t sceneInstanceCount
-) {
-    if (!vkrt || !state) return VKRT_ERROR_INVALID_ARGUMENT;
-
-    VKRT_Result result = vkrtSceneBuildMeshInfoBuffer(vkrt, &state->meshData);
-    if (result != VKRT_SUCCESS) return result;
-
-    TLASBuildResources sceneResources = querySceneTLASBuildResources(state);
-    result = prepareTLASBuild(vkrt, &sceneResources, sceneInstances, sceneInstanceCount);
+    TLASBuildTarget target = querySceneTLASBuildTarget(vkrt);
+    VKRT_Result result = reserveTLASInstances(vkrt, &target, meshCount);
     if (result != VKRT_SUCCESS) return result;
 
-    state->sceneTLASInstanceCount = sceneInstanceCount;
-    return VKRT_SUCCESS;
-}
-
-static VKRT_Result prepareSelectionTLASState(VKRT* vkrt, PreparedTLASState* state) {
-    if (!vkrt || !state) return VKRT_ERROR_INVALID_ARGUMENT;
-
-    VkAccelerationStructureInstanceKHR selectionInstance = {0};
-    if (!buildSelectionTLASInstance(vkrt, &selectionInstance)) return VKRT_SUCCESS;
-
-    TLASBuildResources selectionResources = querySelectionTLASBuildResources(state);
-    VKRT_Result result = prepareTLASBuild(vkrt, &selectionResources, &selectionInstance, 1u);
-    if (result != VKRT_SUCCESS) return result;
+    TLASInstanceWriteSummary summary = {0};
+    for (uint32_t meshIndex = 0; meshIndex < meshCount; meshIndex++) {
+        VkAccelerationStructureInstanceKHR instance = {0};
+        (void)buildTLASInstanceForMesh(vkrt, meshIndex, &instance);
+        writeTLASInstance(target.state, meshIndex, &instance, &summary);
+    }
 
-    state->selectionTLASInstanceCount = 1u;
+    scheduleTLASBuild(&target, meshCount, &summary);
     return VKRT_SUCCESS;
 }
 
-static void commitPreparedTLASState(VKRT* vkrt, PreparedTLASState* state) {
-    if (!vkrt || !state) return;
-
-    FrameSceneUpdate* update = vkrtCurrentFrameSceneUpdate(vkrt);
-    Buffer previousMeshData = vkrt->core.sceneMeshData;
-    AccelerationStructure previousSceneTLAS = vkrt->core.sceneTopLevelAccelerationStructure;
-    AccelerationStructure previousSelectionTLAS = vkrt->core.selectionTopLevelAccelerationStructure;
-    FrameTransfer previousSceneTLASInstanceBuffer = update->sceneTLASInstanceBuffer;
-    FrameTransfer previousSceneTLASScratch = update->sceneTLASScratch;
-    FrameTransfer previousSelectionTLASInstanceBuffer = update->selectionTLASInstanceBuffer;
-    FrameTransfer previousSelectionTLASScratch = update->selectionTLASScratch;
-
-    vkrt->core.sceneMeshData = state->meshData;
-    vkrt->core.sceneTopLevelAccelerationStructure = state->sceneTLAS;
-    vkrt->core.selectionTopLevelAccelerationStructure = state->selectionTLAS;
-    update->sceneTLASInstanceBuffer = state->sceneTLASInstanceBuffer;
-    update->sceneTLASScratch = state->sceneTLASScratch;
-    update->selectionTLASInstanceBuffer = state->selectionTLASInstanceBuffer;
-    update->selectionTLASScratch = state->selectionTLASScratch;
-    update->sceneTLASInstanceCount = state->sceneTLASInstanceCount;
-    update->selectionTLASInstanceCount = state->selectionTLASInstanceCount;
-    update->sceneTLASBuildPending = state->sceneTLASBuildPending;
-    update->selectionTLASBuildPending = state->selectionTLASBuildPending;
-
-    state->meshData = (Buffer){0};
-    state->sceneTLAS = (AccelerationStructure){0};
-    state->selectionTLAS = (AccelerationStructure){0};
-    state->sceneTLASInstanceBuffer = (FrameTransfer){0};
-    state->sceneTLASScratch = (FrameTransfer){0};
-    state->selectionTLASInstanceBuffer = (FrameTransfer){0};
-    state->selectionTLASScratch = (FrameTransfer){0};
-    state->sceneTLASInstanceCount = 0u;
-    state->selectionTLASInstanceCount = 0u;
-    state->sceneTLASBuildPending = VK_FALSE;
-    state->selectionTLASBuildPending = VK_FALSE;
-
-    destroyBufferResources(vkrt, &previousMeshData);
-    destroyTransfer(vkrt, &previousSceneTLASInstanceBuffer);
-    destroyTransfer(vkrt, &previousSceneTLASScratch);
-    destroyTransfer(vkrt, &previousSelectionTLASInstanceBuffer);
-    destroyTransfer(vkrt, &previousSelectionTLASScratch);
-    vkrtDestroyAccelerationStructureResources(vkrt, &previousSceneTLAS);
-    vkrtDestroyAccelerationStructureResources(vkrt, &previousSelectionTLAS);
-}
-
 VKRT_Result createSelectionTopLevelAccelerationStructure(VKRT* vkrt) {
     if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
 
-    FrameSceneUpdate* update = vkrtCurrentFrameSceneUpdate(vkrt);
-    AccelerationStructure previousSelectionTLAS = vkrt->core.selectionTopLevelAccelerationStructure;
-    FrameTransfer previousInstanceBuffer = update->selectionTLASInstanceBuffer;
-    FrameTransfer previousScratchBuffer = update->selectionTLASScratch;
-
-    AccelerationStructure nextSelectionTLAS = {0};
-    FrameTransfer nextInstanceBuffer = {0};
-    FrameTransfer nextScratchBuffer = {0};
-    VkBool32 nextBuildPending = VK_FALSE;
-    uint32_t nextInstanceCount = 0u;
-    TLASBuildResources nextSelectionResources = {
-        .accelerationStructure = &nextSelectionTLAS,
-        .instanceBuffer = &nextInstanceBuffer,
-        .scratchBuffer = &nextScratchBuffer,
-        .buildPending = &nextBuildPending,
-    };
-
+    TLASBuildTarget target = querySelectionTLASBuildTarget(vkrt);
     VkAccelerationStructureInstanceKHR selectionInstance = {0};
-    if (buildSelectionTLASInstance(vkrt, &selectionInstance)) {
-        VKRT_Result result = prepareTLASBuild(vkrt, &nextSelectionResources, &selectionInstance, 1u);
-        if (result != VKRT_SUCCESS) {
-            resetTLASBuildResources(vkrt, &nextSelectionResources);
-            return result;
-        }
-        nextInstanceCount = 1u;
+    if (!buildSelectionTLASInstance(vkrt, &selectionInstance)) {
+        resetTLASBuildTarget(vkrt, &target);
+        return VKRT_SUCCESS;
     }
 
-    vkrt->core.selectionTopLevelAccelerationStructure = nextSelectionTLAS;
-    update->selectionTLASInstanceBuffer = nextInstanceBuffer;
-    update->selectionTLASScratch = nextScratchBuffer;
-    update->selectionTLASInstanceCount = nextInstanceCount;
-    update->selectionTLASBuildPending = nextBuildPending;
+    VKRT_Result result = reserveTLASInstances(vkrt, &target, 1u);
+    if (result != VKRT_SUCCESS) return result;
 
-    destroyTransfer(vkrt, &previousInstanceBuffer);
-    destroyTransfer(vkrt, &previousScratchBuffer);
-    vkrtDestroyAccelerationStructureResources(vkrt, &previousSelectionTLAS);
+    TLASInstanceWriteSummary summary = {0};
+    writeTLASInstance(target.state, 0u, &selectionInstance, &summary);
+    scheduleTLASBuild(&target, 1u, &summary);
     return VKRT_SUCCESS;
 }
 
 VKRT_Result createTopLevelAccelerationStructures(VKRT* vkrt) {
     if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
-    PreparedTLASState state = {0};
-    VkAccelerationStructureInstanceKHR* sceneInstances = NULL;
-    uint32_t sceneInstanceCount = 0u;
-
-    VKRT_Result result = allocateSceneTLASInstances(vkrt, &sceneInstances, &sceneInstanceCount);
-    if (result != VKRT_SUCCESS) {
-        return result;
-    }
 
-    result = prepareSceneTLASState(vkrt, &state, sceneInstances, sceneInstanceCount);
-    if (result == VKRT_SUCCESS) {
-        result = prepareSelectionTLASState(vkrt, &state);
-    }
+    VKRT_Result result = vkrtSceneRebuildMeshInfoBuffer(vkrt);
+    if (result != VKRT_SUCCESS) return result;
 
-    free(sceneInstances);
-    if (result != VKRT_SUCCESS) {
-        destroyPreparedTLASState(vkrt, &state);
-        return result;
-    }
+    result = prepareSceneTLAS(vkrt);
+    if (result != VKRT_SUCCESS) return result;
 
-    commitPreparedTLASState(vkrt, &state);
-    return VKRT_SUCCESS;
+    return createSelectionTopLevelAccelerationStructure(vkrt);
 }
 
 VKRT_Result recordTopLevelAccelerationStructureBuilds(VKRT* vkrt, VkCommandBuffer commandBuffer) {
     if (!vkrt || commandBuffer == VK_NULL_HANDLE) return VKRT_ERROR_INVALID_ARGUMENT;
 
-    FrameSceneUpdate* update = vkrtCurrentFrameSceneUpdate(vkrt);
-    TLASBuildResources sceneTLASResources = {
-        .accelerationStructure = &vkrt->core.sceneTopLevelAccelerationStructure,
-        .instanceBuffer = &update->sceneTLASInstanceBuffer,
-        .scratchBuffer = &update->sceneTLASScratch,
-        .buildPending = &update->sceneTLASBuildPending,
-    };
-    TLASBuildResources selectionTLASResources = {
-        .accelerationStructure = &vkrt->core.selectionTopLevelAccelerationStructure,
-        .instanceBuffer = &update->selectionTLASInstanceBuffer,
-        .scratchBuffer = &update->selectionTLASScratch,
-        .buildPending = &update->selectionTLASBuildPending,
-    };
+    TLASBuildTarget sceneTarget = querySceneTLASBuildTarget(vkrt);
+    TLASBuildTarget selectionTarget = querySelectionTLASBuildTarget(vkrt);
 
-    VKRT_Result result = recordTLASBuild(vkrt, commandBuffer, &sceneTLASResources, update->sceneTLASInstanceCount);
+    VKRT_Result result = recordTLASBuild(vkrt, commandBuffer, &sceneTarget);
     if (result != VKRT_SUCCESS) return result;
 
-    result = recordTLASBuild(vkrt, commandBuffer, &selectionTLASResources, update->selectionTLASInstanceCount);
+    result = recordTLASBuild(vkrt, commandBuffer, &selectionTarget);
     if (result != VKRT_SUCCESS) return result;
 
     return VKRT_SUCCESS;
 }
+
+void destroyTopLevelAccelerationStructures(VKRT* vkrt) {
+    if (!vkrt) return;
+
+    TLASBuildTarget sceneTarget = querySceneTLASBuildTarget(vkrt);
+    TLASBuildTarget selectionTarget = querySelectionTLASBuildTarget(vkrt);
+    resetTLASBuildTarget(vkrt, &sceneTarget);
+    resetTLASBuildTarget(vkrt, &selectionTarget);
+}
@@ -38,21 +38,35 @@ static VkBool32 descriptorResourcesReadyForFrame(VKRT* vkrt, uint32_t frameIndex
 
     return vkrt->core.sceneDataBuffers[frameIndex] != VK_NULL_HANDLE && vkrt->core.outputImageView != VK_NULL_HANDLE &&
            vkrt->core.selectionMaskImageView != VK_NULL_HANDLE &&
+           vkrt->core.adaptiveMomentImageView != VK_NULL_HANDLE &&
            vkrt->core.accumulationImageViews[vkrt->core.accumulationReadIndex] != VK_NULL_HANDLE &&
            vkrt->core.accumulationImageViews[vkrt->core.accumulationWriteIndex] != VK_NULL_HANDLE &&
            vkrt->core.albedoImageViews[vkrt->core.accumulationReadIndex] != VK_NULL_HANDLE &&
            vkrt->core.albedoImageViews[vkrt->core.accumulationWriteIndex] != VK_NULL_HANDLE &&
            vkrt->core.normalImageViews[vkrt->core.accumulationReadIndex] != VK_NULL_HANDLE &&
            vkrt->core.normalImageViews[vkrt->core.accumulationWriteIndex] != VK_NULL_HANDLE &&
-           vkrt->core.vertexData.buffer != VK_NULL_HANDLE && vkrt->core.indexData.buffer != VK_NULL_HANDLE &&
-           vkrt->core.selection.buffer != VK_NULL_HANDLE && vkrt->core.sceneMeshData.buffer != VK_NULL_HANDLE &&
+           vkrt->core.reservoirSampleImageViews[vkrt->core.accumulationReadIndex] != VK_NULL_HANDLE &&
+           vkrt->core.reservoirSampleImageViews[vkrt->core.accumulationWriteIndex] != VK_NULL_HANDLE &&
+           vkrt->core.reservoirDataImageViews[vkrt->core.accumulationReadIndex] != VK_NULL_HANDLE &&
+           vkrt->core.reservoirDataImageViews[vkrt->core.accumulationWriteIndex] != VK_NULL_HANDLE &&
+           vkrt->core.reservoirSurfaceImageViews[vkrt->core.accumulationReadIndex] != VK_NULL_HANDLE &&
+           vkrt->core.reservoirSurfaceImageViews[vkrt->core.accumulationWriteIndex] != VK_NULL_HANDLE &&
+           vkrt->core.positionData.buffer != VK_NULL_HANDLE && vkrt->core.vertexData.buffer != VK_NULL_HANDLE &&
+           vkrt->core.indexData.buffer != VK_NULL_HANDLE &&
+           vkrt->core.selection.buffer != VK_NULL_HANDLE && vkrt->core.adaptiveStatus.buffer != VK_NULL_HANDLE &&
+           vkrt->core.sceneMeshData.buffer != VK_NULL_HANDLE &&
            vkrt->core.sceneMaterialData.buffer != VK_NULL_HANDLE &&
            vkrt->core.sceneEmissiveMeshData.buffer != VK_NULL_HANDLE &&
            vkrt->core.sceneEmissiveTriangleData.buffer != VK_NULL_HANDLE &&
            vkrt->core.sceneMeshAliasQ.buffer != VK_NULL_HANDLE &&
            vkrt->core.sceneMeshAliasIdx.buffer != VK_NULL_HANDLE &&
            vkrt->core.sceneTriAliasQ.buffer != VK_NULL_HANDLE && vkrt->core.sceneTriAliasIdx.buffer != VK_NULL_HANDLE &&
-           vkrt->core.sceneRGB2SpecSRGBData.buffer != VK_NULL_HANDLE && textureDescriptorsReady(vkrt);
+           vkrt->core.sceneLightBVHData.buffer != VK_NULL_HANDLE &&
+           vkrt->core.sceneRGB2SpecSRGBData.buffer != VK_NULL_HANDLE &&
+           vkrt->core.sceneSamplerData.buffer != VK_NULL_HANDLE &&
+           vkrt->core.sceneEnvironmentAliasQ.buffer != VK_NULL_HANDLE &&
+           vkrt->core.sceneEnvironmentAliasIdx.buffer != VK_NULL_HANDLE &&
+           vkrt->core.sceneEnvironmentPmf.buffer != VK_NULL_HANDLE && textureDescriptorsReady(vkrt);
 }
 
 static VkWriteDescriptorSet makeDescriptorWrite(
@@ -122,13 +136,13 @@ typedef struct AccelerationStructureWriteState {
 } AccelerationStructureWriteState;
 
 typedef struct ImageDescriptorWriteState {
-    VkDescriptorImageInfo infos[8];
-    VkWriteDescriptorSet writes[8];
+    VkDescriptorImageInfo infos[15];
+    VkWriteDescriptorSet writes[15];
 } ImageDescriptorWriteState;
 
 typedef struct BufferDescriptorWriteState {
-    VkDescriptorBufferInfo infos[13];
-    VkWriteDescriptorSet writes[13];
+    VkDescriptorBufferInfo infos[20];
+    VkWriteDescriptorSet writes[20];
 } BufferDescriptorWriteState;
 
 typedef struct TextureDescriptorWriteState {
@@ -248,6 +262,13 @@ static VKRT_Result updateDescriptorSetForFrame(VKRT* vkrt, uint32_t frameIndex)
         {7u, vkrt->core.albedoImageViews[vkrt->core.accumulationWriteIndex]},
         {8u, vkrt->core.normalImageViews[vkrt->core.accumulationReadIndex]},
         {9u, vkrt->core.normalImageViews[vkrt->core.accumulationWriteIndex]},
+        {28u, vkrt->core.adaptiveMomentImageView},
+        {32u, vkrt->core.reservoirSampleImageViews[vkrt->core.accumulationReadIndex]},
+        {33u, vkrt->core.reservoirSampleImageViews[vkrt->core.accumulationWriteIndex]},
+        {34u, vkrt->core.reservoirDataImageViews[vkrt->core.accumulationReadIndex]},
+        {35u, vkrt->core.reservoirDataImageViews[vkrt->core.accumulationWriteIndex]},
+        {36u, vkrt->core.reservoirSurfaceImageViews[vkrt->core.accumulationReadIndex]},
+        {37u, vkrt->core.reservoirSurfaceImageViews[vkrt->core.accumulationWriteIndex]},
     };
     ImageDescriptorWriteState imageState = {0};
     appendImageDescriptorWrites(
@@ -271,6 +292,13 @@ static VKRT_Result updateDescriptorSetForFrame(VKRT* vkrt, uint32_t frameIndex)
         {20u, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, vkrt->core.sceneTriAliasQ.buffer, VK_WHOLE_SIZE},
         {21u, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, vkrt->core.sceneTriAliasIdx.buffer, VK_WHOLE_SIZE},
         {24u, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, vkrt->core.sceneRGB2SpecSRGBData.buffer, VK_WHOLE_SIZE},
+        {25u, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, vkrt->core.sceneEnvironmentAliasQ.buffer, VK_WHOLE_SIZE},
+        {26u, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, vkrt->core.sceneEnvironmentAliasIdx.buffer, VK_WHOLE_SIZE},
+        {27u, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, vkrt->core.sceneEnvironmentPmf.buffer, VK_WHOLE_SIZE},
+        {29u, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, vkrt->core.adaptiveStatus.buffer, sizeof(AdaptiveStatus)},
+        {30u, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, vkrt->core.positionData.buffer, VK_WHOLE_SIZE},
+        {31u, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, vkrt->core.sceneLightBVHData.buffer, VK_WHOLE_SIZE},
+        {38u, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, vkrt->core.sceneSamplerData.buffer, VK_WHOLE_SIZE},
     };
     BufferDescriptorWriteState bufferState = {0};
     appendBufferDescriptorWrites(
@@ -316,7 +344,7 @@ VKRT_Result createDescriptorSetLayout(VKRT* vkrt) {
         makeDescriptorSetLayoutBinding(0u, VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR, 1u, rgen),
         makeDescriptorSetLayoutBinding(1u, VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR, 1u, rgen),
         makeDescriptorSetLayoutBinding(2u, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1u, rgen),
-        makeDescriptorSetLayoutBinding(3u, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1u, rgen),
+        makeDescriptorSetLayoutBinding(3u, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1u, rgen | comp),
         makeDescriptorSetLayoutBinding(4u, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1u, rgen | comp),
         makeDescriptorSetLayoutBinding(5u, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1u, rgen | comp),
         makeDescriptorSetLayoutBinding(6u, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1u, rgen),
@@ -338,6 +366,20 @@ VKRT_Result createDescriptorSetLayout(VKRT* vkrt) {
         makeDescriptorSetLayoutBinding(22u, VK_DESCRIPTOR_TYPE_SAMPLER, VKRT_TEXTURE_SAMPLER_VARIANT_COUNT, rtAll),
         makeDescriptorSetLayoutBinding(23u, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VKRT_MAX_BINDLESS_TEXTURES, rtAll),
         makeDescriptorSetLayoutBinding(24u, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1u, rtAll),
+        makeDescriptorSetLayoutBinding(25u, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1u, rgen),
+        makeDescriptorSetLayoutBinding(26u, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1u, rgen),
+        makeDescriptorSetLayoutBinding(27u, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1u, rgen),
+        makeDescriptorSetLayoutBinding(28u, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1u, rgen | comp),
+        makeDescriptorSetLayoutBinding(29u, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1u, rgen | comp),
+        makeDescriptorSetLayoutBinding(30u, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1u, rgen | rhit),
+        makeDescriptorSetLayoutBinding(31u, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1u, rgen),
+        makeDescriptorSetLayoutBinding(32u, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1u, rgen),
+        makeDescriptorSetLayoutBinding(33u, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1u, rgen),
+        makeDescriptorSetLayoutBinding(34u, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1u, rgen),
+        makeDescriptorSetLayoutBinding(35u, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1u, rgen),
+        makeDescriptorSetLayoutBinding(36u, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1u, rgen),
+        makeDescriptorSetLayoutBinding(37u, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1u, rgen),
+        makeDescriptorSetLayoutBinding(38u, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1u, rgen),
     };
 
     VkDescriptorSetLayoutCreateInfo createInfo = {0};
@@ -358,8 +400,8 @@ VKRT_Result createDescriptorPool(VKRT* vkrt) {
 
     static const VkDescriptorPoolSize rendererPoolSizes[] = {
         {VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR, 2u * VKRT_MAX_FRAMES_IN_FLIGHT},
-        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 8u * VKRT_MAX_FRAMES_IN_FLIGHT},
-        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 13u * VKRT_MAX_FRAMES_IN_FLIGHT},
+        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 15u * VKRT_MAX_FRAMES_IN_FLIGHT},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 19u * VKRT_MAX_FRAMES_IN_FLIGHT},
         {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VKRT_MAX_FRAMES_IN_FLIGHT},
         {VK_DESCRIPTOR_TYPE_SAMPLER, VKRT_TEXTURE_SAMPLER_VARIANT_COUNT * VKRT_MAX_FRAMES_IN_FLIGHT},
         {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, VKRT_MAX_BINDLESS_TEXTURES * VKRT_MAX_FRAMES_IN_FLIGHT},
@@ -5,5 +5,9 @@
 VKRT_Result createRayTracingPipeline(VKRT* vkrt);
 VKRT_Result createSelectionRayTracingPipeline(VKRT* vkrt);
 VKRT_Result createComputePipeline(VKRT* vkrt);
+VKRT_Result createAdaptivePipeline(VKRT* vkrt);
+VKRT_Result createRenderPipelines(VKRT* vkrt);
+VKRT_Result createPipelineCache(VKRT* vkrt);
+void destroyPipelineCache(VKRT* vkrt);
 VKRT_Result createSyncObjects(VKRT* vkrt);
 VKRT_Result createShaderModule(VKRT* vkrt, const uint32_t* spirv, size_t length, VkShaderModule* outShaderModule);
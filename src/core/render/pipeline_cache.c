@@ -0,0 +1,230 @@
+#include "debug.h"
+#include "io.h"
+#include "pipeline.h"
+#include "platform.h"
+#include "shaders.h"
+#include "vkrt_internal.h"
+#include "vkrt_types.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vulkan/vulkan_core.h>
+
+enum {
+    K_PIPELINE_CACHE_FILE_MAGIC = 0x43505256u,
+    K_PIPELINE_CACHE_FILE_VERSION = 1u,
+    K_PIPELINE_CACHE_MAX_FILE_SIZE = 256u * 1024u * 1024u,
+};
+
+static const char* kPipelineCacheDirectory = "vkrt";
+
+typedef struct PipelineCacheFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint64_t dataSize;
+} PipelineCacheFileHeader;
+
+typedef struct EmbeddedShaderBlob {
+    const uint32_t* data;
+    const size_t* size;
+} EmbeddedShaderBlob;
+
+static const EmbeddedShaderBlob kEmbeddedShaderBlobs[] = {
+    {shaderRgenData, &shaderRgenSize},
+    {shaderRgenSpectralSingleData, &shaderRgenSpectralSingleSize},
+    {shaderRgenSpectralHeroData, &shaderRgenSpectralHeroSize},
+    {shaderRchitData, &shaderRchitSize},
+    {shaderRahitData, &shaderRahitSize},
+    {shaderRmissData, &shaderRmissSize},
+    {shaderShadowRchitData, &shaderShadowRchitSize},
+    {shaderShadowRahitData, &shaderShadowRahitSize},
+    {shaderShadowMissData, &shaderShadowMissSize},
+    {shaderRgenSerData, &shaderRgenSerSize},
+    {shaderRgenSpectralSingleSerData, &shaderRgenSpectralSingleSerSize},
+    {shaderRgenSpectralHeroSerData, &shaderRgenSpectralHeroSerSize},
+    {shaderRchitSerData, &shaderRchitSerSize},
+    {shaderRmissSerData, &shaderRmissSerSize},
+    {shaderShadowRchitSerData, &shaderShadowRchitSerSize},
+    {shaderShadowMissSerData, &shaderShadowMissSerSize},
+    {shaderCompData, &shaderCompSize},
+    {shaderAdaptiveCompData, &shaderAdaptiveCompSize},
+    {shaderSelectRgenData, &shaderSelectRgenSize},
+    {shaderSelectRchitData, &shaderSelectRchitSize},
+    {shaderSelectRahitData, &shaderSelectRahitSize},
+    {shaderSelectRmissData, &shaderSelectRmissSize},
+};
+
+static uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static uint64_t computePipelineCacheKey(const VKRT* vkrt) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hash = hashBytes(hash, &vkrt->core.vendorID, sizeof(vkrt->core.vendorID));
+    hash = hashBytes(hash, &vkrt->core.deviceID, sizeof(vkrt->core.deviceID));
+    hash = hashBytes(hash, &vkrt->core.driverVersion, sizeof(vkrt->core.driverVersion));
+    hash = hashBytes(hash, vkrt->core.pipelineCacheUUID, VK_UUID_SIZE);
+    for (size_t i = 0; i < VKRT_ARRAY_COUNT(kEmbeddedShaderBlobs); i++) {
+        const size_t size = *kEmbeddedShaderBlobs[i].size;
+        hash = hashBytes(hash, &size, sizeof(size));
+        hash = hashBytes(hash, kEmbeddedShaderBlobs[i].data, size);
+    }
+    return hash;
+}
+
+static int resolvePipelineCachePath(const VKRT* vkrt, char* outPath, size_t outPathSize) {
+    char directory[VKRT_PATH_MAX];
+    if (resolveUserCacheDirectory(kPipelineCacheDirectory, directory, sizeof(directory)) != 0) return -1;
+
+    int written = snprintf(
+        outPath,
+        outPathSize,
+        "%s/pipeline-%04x-%04x.bin",
+        directory,
+        vkrt->core.vendorID,
+        vkrt->core.deviceID
+    );
+    return (written > 0 && (size_t)written < outPathSize) ? 0 : -1;
+}
+
+static int pipelineCacheDataMatchesDevice(const VKRT* vkrt, const uint8_t* data, size_t dataSize) {
+    VkPipelineCacheHeaderVersionOne header = {0};
+    if (dataSize < sizeof(header)) return 0;
+
+    memcpy(&header, data, sizeof(header));
+    return header.headerSize >= sizeof(header) && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           header.vendorID == vkrt->core.vendorID && header.deviceID == vkrt->core.deviceID &&
+           memcmp(header.pipelineCacheUUID, vkrt->core.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+static uint8_t* readPipelineCacheFile(const VKRT* vkrt, const char* path, uint64_t key, size_t* outDataSize) {
+    *outDataSize = 0;
+
+    FILE* file = NULL;
+#ifdef _WIN32
+    if (fopen_s(&file, path, "rb") != 0) file = NULL;
+#else
+    file = fopen(path, "rb");
+#endif
+    if (!file) return NULL;
+
+    PipelineCacheFileHeader header = {0};
+    uint8_t* data = NULL;
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != K_PIPELINE_CACHE_FILE_MAGIC ||
+        header.version != K_PIPELINE_CACHE_FILE_VERSION || header.key != key || header.dataSize == 0 ||
+        header.dataSize > K_PIPELINE_CACHE_MAX_FILE_SIZE) {
+        LOG_TRACE("Ignoring stale pipeline cache %s", path);
+        goto read_done;
+    }
+
+    data = (uint8_t*)malloc((size_t)header.dataSize);
+    if (!data) goto read_done;
+    if (fread(data, 1, (size_t)header.dataSize, file) != (size_t)header.dataSize ||
+        !pipelineCacheDataMatchesDevice(vkrt, data, (size_t)header.dataSize)) {
+        LOG_TRACE("Ignoring incompatible pipeline cache %s", path);
+        free(data);
+        data = NULL;
+        goto read_done;
+    }
+    *outDataSize = (size_t)header.dataSize;
+
+read_done:
+    (void)fclose(file);
+    return data;
+}
+
+VKRT_Result createPipelineCache(VKRT* vkrt) {
+    if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
+    if (vkrt->core.pipelineCache != VK_NULL_HANDLE) return VKRT_SUCCESS;
+
+    uint64_t startTime = getMicroseconds();
+    char path[VKRT_PATH_MAX];
+    size_t initialDataSize = 0;
+    uint8_t* initialData = NULL;
+    if (resolvePipelineCachePath(vkrt, path, sizeof(path)) == 0) {
+        initialData = readPipelineCacheFile(vkrt, path, computePipelineCacheKey(vkrt), &initialDataSize);
+    }
+
+    VkPipelineCacheCreateInfo createInfo = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .initialDataSize = initialDataSize,
+        .pInitialData = initialData,
+    };
+    VkResult result = vkCreatePipelineCache(vkrt->core.device, &createInfo, NULL, &vkrt->core.pipelineCache);
+    if (result != VK_SUCCESS && initialData) {
+        createInfo.initialDataSize = 0;
+        createInfo.pInitialData = NULL;
+        initialDataSize = 0;
+        result = vkCreatePipelineCache(vkrt->core.device, &createInfo, NULL, &vkrt->core.pipelineCache);
+    }
+    free(initialData);
+
+    if (result != VK_SUCCESS) {
+        LOG_ERROR("Failed to create pipeline cache");
+        vkrt->core.pipelineCache = VK_NULL_HANDLE;
+        return VKRT_ERROR_PIPELINE_CREATION_FAILED;
+    }
+
+    vkrt->core.pipelineCacheLoadedSize = initialDataSize;
+    LOG_TRACE(
+        "Pipeline cache %s (%zu bytes) in %.3f ms",
+        initialDataSize > 0 ? "loaded" : "empty",
+        initialDataSize,
+        (double)(getMicroseconds() - startTime) / 1e3
+    );
+    return VKRT_SUCCESS;
+}
+
+static void savePipelineCache(VKRT* vkrt) {
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(vkrt->core.device, vkrt->core.pipelineCache, &dataSize, NULL) != VK_SUCCESS ||
+        dataSize == 0 || dataSize == vkrt->core.pipelineCacheLoadedSize || dataSize > K_PIPELINE_CACHE_MAX_FILE_SIZE) {
+        return;
+    }
+
+    char path[VKRT_PATH_MAX];
+    if (resolvePipelineCachePath(vkrt, path, sizeof(path)) != 0) return;
+
+    uint8_t* fileData = (uint8_t*)malloc(sizeof(PipelineCacheFileHeader) + dataSize);
+    if (!fileData) return;
+
+    uint8_t* cacheData = fileData + sizeof(PipelineCacheFileHeader);
+    if (vkGetPipelineCacheData(vkrt->core.device, vkrt->core.pipelineCache, &dataSize, cacheData) != VK_SUCCESS) {
+        free(fileData);
+        return;
+    }
+
+    PipelineCacheFileHeader header = {
+        .magic = K_PIPELINE_CACHE_FILE_MAGIC,
+        .version = K_PIPELINE_CACHE_FILE_VERSION,
+        .key = computePipelineCacheKey(vkrt),
+        .dataSize = dataSize,
+    };
+    memcpy(fileData, &header, sizeof(header));
+
+    if (writeFileReplacing(path, fileData, sizeof(header) + dataSize) != 0) {
+        LOG_ERROR("Failed to write pipeline cache: %s", path);
+    } else {
+        LOG_TRACE("Pipeline cache saved (%zu bytes) to %s", dataSize, path);
+        vkrt->core.pipelineCacheLoadedSize = dataSize;
+    }
+    free(fileData);
+}
+
+void destroyPipelineCache(VKRT* vkrt) {
+    if (!vkrt || vkrt->core.device == VK_NULL_HANDLE || vkrt->core.pipelineCache == VK_NULL_HANDLE) return;
+
+    savePipelineCache(vkrt);
+    vkDestroyPipelineCache(vkrt->core.device, vkrt->core.pipelineCache, NULL);
+    vkrt->core.pipelineCache = VK_NULL_HANDLE;
+    vkrt->core.pipelineCacheLoadedSize = 0;
+}
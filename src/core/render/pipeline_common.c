@@ -1,6 +1,7 @@
 #include "debug.h"
 #include "pipeline.h"
 #include "pipeline_internal.h"
+#include "platform.h"
 #include "shaders.h"
 #include "vkrt_internal.h"
 #include "vkrt_types.h"
@@ -284,3 +285,52 @@ VKRT_Result createShaderModule(VKRT* vkrt, const uint32_t* spirv, size_t length,
 
     return VKRT_SUCCESS;
 }
+
+enum {
+    K_RENDER_PIPELINE_TASK_COUNT = 4,
+};
+
+typedef struct RenderPipelineTask {
+    VKRT* vkrt;
+    VKRT_Result (*create)(VKRT* vkrt);
+    VKRT_Result result;
+} RenderPipelineTask;
+
+static int runRenderPipelineTask(void* userData) {
+    RenderPipelineTask* task = (RenderPipelineTask*)userData;
+    task->result = task->create(task->vkrt);
+    return task->result == VKRT_SUCCESS ? VKRT_THREAD_SUCCESS : VKRT_THREAD_ERROR;
+}
+
+VKRT_Result createRenderPipelines(VKRT* vkrt) {
+    if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
+
+    // The layout is shared, so it must exist before the pipelines are compiled side by side.
+    if (createRayTracingPipelineLayout(vkrt) != VKRT_SUCCESS) return VKRT_ERROR_OPERATION_FAILED;
+
+    RenderPipelineTask tasks[K_RENDER_PIPELINE_TASK_COUNT] = {
+        {vkrt, createRayTracingPipeline, VKRT_ERROR_OPERATION_FAILED},
+        {vkrt, createSelectionRayTracingPipeline, VKRT_ERROR_OPERATION_FAILED},
+        {vkrt, createComputePipeline, VKRT_ERROR_OPERATION_FAILED},
+        {vkrt, createAdaptivePipeline, VKRT_ERROR_OPERATION_FAILED},
+    };
+    VKRT_Thread threads[K_RENDER_PIPELINE_TASK_COUNT] = {0};
+    uint8_t threadStarted[K_RENDER_PIPELINE_TASK_COUNT] = {0};
+
+    for (uint32_t i = 1; i < K_RENDER_PIPELINE_TASK_COUNT; i++) {
+        threadStarted[i] = vkrtThreadCreate(&threads[i], runRenderPipelineTask, &tasks[i]) == VKRT_THREAD_SUCCESS;
+    }
+    (void)runRenderPipelineTask(&tasks[0]);
+    for (uint32_t i = 1; i < K_RENDER_PIPELINE_TASK_COUNT; i++) {
+        if (threadStarted[i]) {
+            (void)vkrtThreadJoin(threads[i], NULL);
+        } else {
+            (void)runRenderPipelineTask(&tasks[i]);
+        }
+    }
+
+    for (uint32_t i = 0; i < K_RENDER_PIPELINE_TASK_COUNT; i++) {
+        if (tasks[i].result != VKRT_SUCCESS) return tasks[i].result;
+    }
+    return VKRT_SUCCESS;
+}
@@ -12,12 +12,16 @@
 #include <stdint.h>
 #include <vulkan/vulkan_core.h>
 
-VKRT_Result createComputePipeline(VKRT* vkrt) {
-    if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
-
+static VKRT_Result createComputePipelineFromShader(
+    VKRT* vkrt,
+    const uint32_t* spirv,
+    size_t spirvSize,
+    const char* label,
+    VkPipeline* outPipeline
+) {
     uint64_t startTime = getMicroseconds();
     VkShaderModule compModule = VK_NULL_HANDLE;
-    if (createShaderModule(vkrt, shaderCompData, shaderCompSize, &compModule) != VKRT_SUCCESS) {
+    if (createShaderModule(vkrt, spirv, spirvSize, &compModule) != VKRT_SUCCESS) {
         return VKRT_ERROR_OPERATION_FAILED;
     }
 
@@ -28,18 +32,46 @@ VKRT_Result createComputePipeline(VKRT* vkrt) {
         .layout = vkrt->core.pipelineLayout,
     };
 
-    if (vkCreateComputePipelines(vkrt->core.device, VK_NULL_HANDLE, 1, &createInfo, NULL, &vkrt->core.computePipeline) !=
-        VK_SUCCESS) {
-        LOG_ERROR("Failed to create compute pipeline");
+    if (vkCreateComputePipelines(
+            vkrt->core.device,
+            vkrt->core.pipelineCache,
+            1,
+            &createInfo,
+            NULL,
+            outPipeline
+        ) != VK_SUCCESS) {
+        LOG_ERROR("Failed to create %s pipeline", label);
         vkDestroyShaderModule(vkrt->core.device, compModule, NULL);
         return VKRT_ERROR_OPERATION_FAILED;
     }
 
     vkDestroyShaderModule(vkrt->core.device, compModule, NULL);
-    LOG_INFO("Compute pipeline created in %.3f ms", (double)(getMicroseconds() - startTime) / 1e3);
+    LOG_INFO("%s pipeline created in %.3f ms", label, (double)(getMicroseconds() - startTime) / 1e3);
     return VKRT_SUCCESS;
 }
 
+VKRT_Result createComputePipeline(VKRT* vkrt) {
+    if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
+    return createComputePipelineFromShader(
+        vkrt,
+        shaderCompData,
+        shaderCompSize,
+        "Compute",
+        &vkrt->core.computePipeline
+    );
+}
+
+VKRT_Result createAdaptivePipeline(VKRT* vkrt) {
+    if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
+    return createComputePipelineFromShader(
+        vkrt,
+        shaderAdaptiveCompData,
+        shaderAdaptiveCompSize,
+        "Adaptive sampling",
+        &vkrt->core.adaptivePipeline
+    );
+}
+
 VKRT_Result createSyncObjects(VKRT* vkrt) {
     if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
 
@@ -56,7 +56,7 @@ static VkResult createRayTracingPipelineTracked(
     VkResult result = vkrt->core.procs.vkCreateRayTracingPipelinesKHR(
         vkrt->core.device,
         VK_NULL_HANDLE,
-        VK_NULL_HANDLE,
+        vkrt->core.pipelineCache,
         1,
         pipelineCreateInfo,
         NULL,
@@ -50,6 +50,9 @@ extern const size_t shaderShadowMissSerSize;
 extern const uint32_t shaderCompData[];
 extern const size_t shaderCompSize;
 
+extern const uint32_t shaderAdaptiveCompData[];
+extern const size_t shaderAdaptiveCompSize;
+
 extern const uint32_t shaderSelectRgenData[];
 extern const size_t shaderSelectRgenSize;
 
@@ -0,0 +1,508 @@
+#include "allocator.h"
+
+#include "debug.h"
+#include "platform.h"
+#include "vkrt_engine_types.h"
+#include "vkrt_internal.h"
+#include "vkrt_types.h"
+#include "vulkan/vulkan_core.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const VkDeviceSize kLargeHeapBlockSize = 64ull * 1024ull * 1024ull;
+static const VkDeviceSize kLargeHeapThreshold = 1024ull * 1024ull * 1024ull;
+static const uint32_t kInitialFreeRangeCapacity = 8u;
+
+typedef struct MemoryRange {
+    VkDeviceSize offset;
+    VkDeviceSize size;
+} MemoryRange;
+
+typedef struct MemoryBlock {
+    VkDeviceMemory memory;
+    VkDeviceSize size;
+    VkDeviceSize usedBytes;
+    void* mapped;
+    MemoryRange* freeRanges;
+    uint32_t freeRangeCount;
+    uint32_t freeRangeCapacity;
+    uint32_t allocationCount;
+    uint32_t memoryTypeIndex;
+    uint32_t kind;
+} MemoryBlock;
+
+struct MemoryAllocation_T {
+    MemoryBlock* block;
+    VkDeviceMemory memory;
+    VkDeviceSize offset;
+    VkDeviceSize size;
+    void* mapped;
+    uint32_t memoryTypeIndex;
+};
+
+static VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+    if (alignment <= 1u) return value;
+    return (value + alignment - 1u) & ~(alignment - 1u);
+}
+
+static uint32_t queryHeapIndex(const MemoryAllocator* allocator, uint32_t memoryTypeIndex) {
+    return allocator->memoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+}
+
+static VKRT_Result selectMemoryType(
+    const MemoryAllocator* allocator,
+    uint32_t typeFilter,
+    VkMemoryPropertyFlags properties,
+    uint32_t* outMemoryTypeIndex
+) {
+    for (uint32_t i = 0; i < allocator->memoryProperties.memoryTypeCount; i++) {
+        if ((typeFilter & (1u << i)) &&
+            (allocator->memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+            *outMemoryTypeIndex = i;
+            return VKRT_SUCCESS;
+        }
+    }
+
+    LOG_ERROR("Failed to find suitable memory type");
+    return VKRT_ERROR_OPERATION_FAILED;
+}
+
+static VKRT_Result allocateDeviceMemory(
+    VKRT* vkrt,
+    VkDeviceSize size,
+    uint32_t memoryTypeIndex,
+    MemoryResourceKind kind,
+    VkDeviceMemory* outMemory,
+    void** outMapped
+) {
+    const MemoryAllocator* allocator = &vkrt->core.memoryAllocator;
+    *outMemory = VK_NULL_HANDLE;
+    *outMapped = NULL;
+
+    VkMemoryAllocateInfo memoryAllocateInfo = {0};
+    memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    memoryAllocateInfo.allocationSize = size;
+    memoryAllocateInfo.memoryTypeIndex = memoryTypeIndex;
+
+    VkMemoryAllocateFlagsInfo memoryAllocateFlagsInfo = {0};
+    if (kind == MEMORY_RESOURCE_BUFFER) {
+        memoryAllocateFlagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+        memoryAllocateFlagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+        memoryAllocateInfo.pNext = &memoryAllocateFlagsInfo;
+    }
+
+    if (vkAllocateMemory(vkrt->core.device, &memoryAllocateInfo, NULL, outMemory) != VK_SUCCESS) {
+        LOG_ERROR("Failed to allocate device memory");
+        *outMemory = VK_NULL_HANDLE;
+        return VKRT_ERROR_OUT_OF_MEMORY;
+    }
+
+    VkMemoryPropertyFlags flags = allocator->memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
+    if (flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        if (vkMapMemory(vkrt->core.device, *outMemory, 0, VK_WHOLE_SIZE, 0, outMapped) != VK_SUCCESS) {
+            vkFreeMemory(vkrt->core.device, *outMemory, NULL);
+            *outMemory = VK_NULL_HANDLE;
+            *outMapped = NULL;
+            return VKRT_ERROR_OPERATION_FAILED;
+        }
+    }
+
+    return VKRT_SUCCESS;
+}
+
+static int reserveFreeRanges(MemoryBlock* block, uint32_t requiredCount) {
+    if (block->freeRangeCapacity >= requiredCount) return 1;
+
+    uint32_t capacity = block->freeRangeCapacity > 0u ? block->freeRangeCapacity : kInitialFreeRangeCapacity;
+    while (capacity < requiredCount) {
+        capacity *= 2u;
+    }
+
+    MemoryRange* resized = (MemoryRange*)realloc(block->freeRanges, (size_t)capacity * sizeof(MemoryRange));
+    if (!resized) return 0;
+    block->freeRanges = resized;
+    block->freeRangeCapacity = capacity;
+    return 1;
+}
+
+static void insertFreeRange(MemoryBlock* block, uint32_t index, MemoryRange range) {
+    memmove(
+        &block->freeRanges[index + 1u],
+        &block->freeRanges[index],
+        (size_t)(block->freeRangeCount - index) * sizeof(MemoryRange)
+    );
+    block->freeRanges[index] = range;
+    block->freeRangeCount++;
+}
+
+static void removeFreeRange(MemoryBlock* block, uint32_t index) {
+    memmove(
+        &block->freeRanges[index],
+        &block->freeRanges[index + 1u],
+        (size_t)(block->freeRangeCount - index - 1u) * sizeof(MemoryRange)
+    );
+    block->freeRangeCount--;
+}
+
+static int allocateFromBlock(MemoryBlock* block, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize* outOffset) {
+    uint32_t bestIndex = UINT32_MAX;
+    VkDeviceSize bestLeftover = 0u;
+
+    for (uint32_t i = 0; i < block->freeRangeCount; i++) {
+        const MemoryRange* range = &block->freeRanges[i];
+        VkDeviceSize alignedOffset = alignUp(range->offset, alignment);
+        VkDeviceSize padding = alignedOffset - range->offset;
+        if (padding > range->size || range->size - padding < size) continue;
+
+        VkDeviceSize leftover = range->size - padding - size;
+        if (bestIndex == UINT32_MAX || leftover < bestLeftover) {
+            bestIndex = i;
+            bestLeftover = leftover;
+            if (leftover == 0u) break;
+        }
+    }
+    if (bestIndex == UINT32_MAX) return 0;
+    if (!reserveFreeRanges(block, block->freeRangeCount + 1u)) return 0;
+
+    MemoryRange range = block->freeRanges[bestIndex];
+    VkDeviceSize alignedOffset = alignUp(range.offset, alignment);
+    MemoryRange head = {range.offset, alignedOffset - range.offset};
+    MemoryRange tail = {alignedOffset + size, range.size - head.size - size};
+
+    removeFreeRange(block, bestIndex);
+    uint32_t insertIndex = bestIndex;
+    if (head.size > 0u) {
+        insertFreeRange(block, insertIndex, head);
+        insertIndex++;
+    }
+    if (tail.size > 0u) {
+        insertFreeRange(block, insertIndex, tail);
+    }
+
+    block->usedBytes += size;
+    block->allocationCount++;
+    *outOffset = alignedOffset;
+    return 1;
+}
+
+static void releaseToBlock(MemoryBlock* block, VkDeviceSize offset, VkDeviceSize size) {
+    uint32_t index = 0u;
+    while (index < block->freeRangeCount && block->freeRanges[index].offset < offset) {
+        index++;
+    }
+
+    int mergesPrevious =
+        index > 0u && block->freeRanges[index - 1u].offset + block->freeRanges[index - 1u].size == offset;
+    int mergesNext = index < block->freeRangeCount && offset + size == block->freeRanges[index].offset;
+
+    if (mergesPrevious && mergesNext) {
+        block->freeRanges[index - 1u].size += size + block->freeRanges[index].size;
+        removeFreeRange(block, index);
+    } else if (mergesPrevious) {
+        block->freeRanges[index - 1u].size += size;
+    } else if (mergesNext) {
+        block->freeRanges[index].offset = offset;
+        block->freeRanges[index].size += size;
+    } else if (reserveFreeRanges(block, block->freeRangeCount + 1u)) {
+        insertFreeRange(block, index, (MemoryRange){offset, size});
+    } else {
+        LOG_ERROR("Failed to track freed memory range");
+    }
+
+    block->usedBytes -= size;
+    block->allocationCount--;
+}
+
+static void destroyBlock(VKRT* vkrt, MemoryBlock* block) {
+    if (!block) return;
+    if (block->memory != VK_NULL_HANDLE) {
+        vkFreeMemory(vkrt->core.device, block->memory, NULL);
+    }
+    free(block->freeRanges);
+    free(block);
+}
+
+static MemoryBlock* createBlock(VKRT* vkrt, MemoryPool* pool, uint32_t memoryTypeIndex, MemoryResourceKind kind) {
+    MemoryAllocator* allocator = &vkrt->core.memoryAllocator;
+    MemoryBlock** resized =
+        (MemoryBlock**)realloc(pool->blocks, (size_t)(pool->blockCount + 1u) * sizeof(MemoryBlock*));
+    if (!resized) return NULL;
+    pool->blocks = resized;
+
+    MemoryBlock* block = (MemoryBlock*)calloc(1, sizeof(MemoryBlock));
+    if (!block) return NULL;
+
+    block->size = allocator->preferredBlockSizes[queryHeapIndex(allocator, memoryTypeIndex)];
+    block->memoryTypeIndex = memoryTypeIndex;
+    block->kind = (uint32_t)kind;
+    if (!reserveFreeRanges(block, 1u) ||
+        allocateDeviceMemory(vkrt, block->size, memoryTypeIndex, kind, &block->memory, &block->mapped) !=
+            VKRT_SUCCESS) {
+        destroyBlock(vkrt, block);
+        return NULL;
+    }
+
+    block->freeRanges[0] = (MemoryRange){0u, block->size};
+    block->freeRangeCount = 1u;
+    pool->blocks[pool->blockCount++] = block;
+    return block;
+}
+
+static void releaseEmptyBlock(VKRT* vkrt, MemoryPool* pool, MemoryBlock* block) {
+    if (block->allocationCount != 0u || pool->blockCount <= 1u) return;
+
+    for (uint32_t i = 0; i < pool->blockCount; i++) {
+        if (pool->blocks[i] != block) continue;
+        pool->blocks[i] = pool->blocks[pool->blockCount - 1u];
+        pool->blockCount--;
+        destroyBlock(vkrt, block);
+        return;
+    }
+}
+
+static VKRT_Result allocateMemory(
+    VKRT* vkrt,
+    const VkMemoryRequirements* requirements,
+    VkMemoryPropertyFlags properties,
+    MemoryResourceKind kind,
+    MemoryAllocation* outAllocation
+) {
+    MemoryAllocator* allocator = &vkrt->core.memoryAllocator;
+    *outAllocation = VK_NULL_HANDLE;
+
+    uint32_t memoryTypeIndex = 0u;
+    VKRT_Result result =
+        selectMemoryType(allocator, requirements->memoryTypeBits, properties, &memoryTypeIndex);
+    if (result != VKRT_SUCCESS) return result;
+
+    MemoryAllocation allocation = (MemoryAllocation)calloc(1, sizeof(*allocation));
+    if (!allocation) return VKRT_ERROR_OUT_OF_MEMORY;
+    allocation->memoryTypeIndex = memoryTypeIndex;
+    allocation->size = requirements->size;
+
+    uint32_t heapIndex = queryHeapIndex(allocator, memoryTypeIndex);
+    if (requirements->size > allocator->preferredBlockSizes[heapIndex] / 2u) {
+        result = allocateDeviceMemory(
+            vkrt,
+            requirements->size,
+            memoryTypeIndex,
+            kind,
+            &allocation->memory,
+            &allocation->mapped
+        );
+        if (result != VKRT_SUCCESS) {
+            free(allocation);
+            return result;
+        }
+
+        vkrtMutexLock(&allocator->lock);
+        allocator->dedicatedAllocationCounts[heapIndex]++;
+        allocator->dedicatedBytes[heapIndex] += requirements->size;
+        vkrtMutexUnlock(&allocator->lock);
+        *outAllocation = allocation;
+        return VKRT_SUCCESS;
+    }
+
+    vkrtMutexLock(&allocator->lock);
+    MemoryPool* pool = &allocator->pools[memoryTypeIndex][kind];
+    MemoryBlock* block = NULL;
+    VkDeviceSize offset = 0u;
+    for (uint32_t i = 0; i < pool->blockCount; i++) {
+        if (allocateFromBlock(pool->blocks[i], requirements->size, requirements->alignment, &offset)) {
+            block = pool->blocks[i];
+            break;
+        }
+    }
+    if (!block) {
+        block = createBlock(vkrt, pool, memoryTypeIndex, kind);
+        if (!block || !allocateFromBlock(block, requirements->size, requirements->alignment, &offset)) {
+            vkrtMutexUnlock(&allocator->lock);
+            free(allocation);
+            return VKRT_ERROR_OUT_OF_MEMORY;
+        }
+    }
+    vkrtMutexUnlock(&allocator->lock);
+
+    allocation->block = block;
+    allocation->memory = block->memory;
+    allocation->offset = offset;
+    allocation->mapped = block->mapped ? (uint8_t*)block->mapped + offset : NULL;
+    *outAllocation = allocation;
+    return VKRT_SUCCESS;
+}
+
+VKRT_Result vkrtCreateMemoryAllocator(VKRT* vkrt) {
+    if (!vkrt || vkrt->core.physicalDevice == VK_NULL_HANDLE) return VKRT_ERROR_INVALID_ARGUMENT;
+
+    MemoryAllocator* allocator = &vkrt->core.memoryAllocator;
+    *allocator = (MemoryAllocator){0};
+    vkGetPhysicalDeviceMemoryProperties(vkrt->core.physicalDevice, &allocator->memoryProperties);
+
+    for (uint32_t i = 0; i < allocator->memoryProperties.memoryHeapCount; i++) {
+        VkDeviceSize heapSize = allocator->memoryProperties.memoryHeaps[i].size;
+        VkDeviceSize blockSize = heapSize >= kLargeHeapThreshold ? kLargeHeapBlockSize : heapSize / 8u;
+        allocator->preferredBlockSizes[i] = blockSize > 0u ? blockSize : heapSize;
+    }
+
+    if (vkrtMutexInit(&allocator->lock, VKRT_MUTEX_PLAIN) != VKRT_THREAD_SUCCESS) {
+        return VKRT_ERROR_OPERATION_FAILED;
+    }
+    allocator->initialized = 1u;
+    return VKRT_SUCCESS;
+}
+
+void vkrtDestroyMemoryAllocator(VKRT* vkrt) {
+    if (!vkrt || !vkrt->core.memoryAllocator.initialized) return;
+
+    MemoryAllocator* allocator = &vkrt->core.memoryAllocator;
+    for (uint32_t typeIndex = 0; typeIndex < VK_MAX_MEMORY_TYPES; typeIndex++) {
+        for (uint32_t kind = 0; kind < MEMORY_RESOURCE_KIND_COUNT; kind++) {
+            MemoryPool* pool = &allocator->pools[typeIndex][kind];
+            for (uint32_t i = 0; i < pool->blockCount; i++) {
+                if (pool->blocks[i]->allocationCount != 0u) {
+                    LOG_ERROR("Destroying memory block with %u live allocations", pool->blocks[i]->allocationCount);
+                }
+                destroyBlock(vkrt, pool->blocks[i]);
+            }
+            free(pool->blocks);
+        }
+    }
+
+    vkrtMutexDestroy(&allocator->lock);
+    *allocator = (MemoryAllocator){0};
+}
+
+VKRT_Result vkrtAllocateBufferMemory(
+    VKRT* vkrt,
+    VkBuffer buffer,
+    VkMemoryPropertyFlags properties,
+    MemoryAllocation* outAllocation
+) {
+    if (!vkrt || buffer == VK_NULL_HANDLE || !outAllocation) return VKRT_ERROR_INVALID_ARGUMENT;
+
+    VkMemoryRequirements memoryRequirements = {0};
+    vkGetBufferMemoryRequirements(vkrt->core.device, buffer, &memoryRequirements);
+
+    VKRT_Result result =
+        allocateMemory(vkrt, &memoryRequirements, properties, MEMORY_RESOURCE_BUFFER, outAllocation);
+    if (result != VKRT_SUCCESS) return result;
+
+    if (vkBindBufferMemory(vkrt->core.device, buffer, (*outAllocation)->memory, (*outAllocation)->offset) !=
+        VK_SUCCESS) {
+        vkrtFreeMemory(vkrt, outAllocation);
+        return VKRT_ERROR_OPERATION_FAILED;
+    }
+    return VKRT_SUCCESS;
+}
+
+VKRT_Result vkrtAllocateImageMemory(
+    VKRT* vkrt,
+    VkImage image,
+    VkMemoryPropertyFlags properties,
+    MemoryAllocation* outAllocation
+) {
+    if (!vkrt || image == VK_NULL_HANDLE || !outAllocation) return VKRT_ERROR_INVALID_ARGUMENT;
+
+    VkMemoryRequirements memoryRequirements = {0};
+    vkGetImageMemoryRequirements(vkrt->core.device, image, &memoryRequirements);
+
+    VKRT_Result result = allocateMemory(vkrt, &memoryRequirements, properties, MEMORY_RESOURCE_IMAGE, outAllocation);
+    if (result != VKRT_SUCCESS) return result;
+
+    if (vkBindImageMemory(vkrt->core.device, image, (*outAllocation)->memory, (*outAllocation)->offset) !=
+        VK_SUCCESS) {
+        vkrtFreeMemory(vkrt, outAllocation);
+        return VKRT_ERROR_OPERATION_FAILED;
+    }
+    return VKRT_SUCCESS;
+}
+
+void vkrtFreeMemory(VKRT* vkrt, MemoryAllocation* allocation) {
+    if (!vkrt || !allocation || *allocation == VK_NULL_HANDLE) return;
+
+    MemoryAllocator* allocator = &vkrt->core.memoryAllocator;
+    MemoryAllocation handle = *allocation;
+    uint32_t heapIndex = queryHeapIndex(allocator, handle->memoryTypeIndex);
+
+    vkrtMutexLock(&allocator->lock);
+    if (handle->block) {
+        MemoryBlock* block = handle->block;
+        releaseToBlock(block, handle->offset, handle->size);
+        releaseEmptyBlock(vkrt, &allocator->pools[block->memoryTypeIndex][block->kind], block);
+    } else {
+        vkFreeMemory(vkrt->core.device, handle->memory, NULL);
+        allocator->dedicatedAllocationCounts[heapIndex]--;
+        allocator->dedicatedBytes[heapIndex] -= handle->size;
+    }
+    vkrtMutexUnlock(&allocator->lock);
+
+    free(handle);
+    *allocation = VK_NULL_HANDLE;
+}
+
+void* vkrtMappedMemory(MemoryAllocation allocation) {
+    return allocation ? allocation->mapped : NULL;
+}
+
+void vkrtQueryMemoryStats(const VKRT* vkrt, VKRT_MemorySnapshot* outSnapshot) {
+    if (!vkrt || !outSnapshot) return;
+
+    memset(outSnapshot, 0, sizeof(*outSnapshot));
+    const MemoryAllocator* allocator = &vkrt->core.memoryAllocator;
+    if (!allocator->initialized) return;
+    VKRT_Mutex* lock = (VKRT_Mutex*)&allocator->lock;
+
+    uint32_t heapCount = allocator->memoryProperties.memoryHeapCount;
+    if (heapCount > VKRT_MAX_MEMORY_HEAPS) heapCount = VKRT_MAX_MEMORY_HEAPS;
+    outSnapshot->heapCount = heapCount;
+
+    VkDeviceSize totalFreeBytes = 0u;
+    VkDeviceSize largestFreeRange = 0u;
+
+    vkrtMutexLock(lock);
+    for (uint32_t heapIndex = 0; heapIndex < heapCount; heapIndex++) {
+        VKRT_MemoryHeapStats* heap = &outSnapshot->heaps[heapIndex];
+        heap->heapSize = allocator->memoryProperties.memoryHeaps[heapIndex].size;
+        heap->deviceLocal =
+            (allocator->memoryProperties.memoryHeaps[heapIndex].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0u;
+        heap->reservedBytes = allocator->dedicatedBytes[heapIndex];
+        heap->usedBytes = allocator->dedicatedBytes[heapIndex];
+        heap->allocationCount = allocator->dedicatedAllocationCounts[heapIndex];
+        outSnapshot->dedicatedAllocationCount += allocator->dedicatedAllocationCounts[heapIndex];
+    }
+
+    for (uint32_t typeIndex = 0; typeIndex < allocator->memoryProperties.memoryTypeCount; typeIndex++) {
+        uint32_t heapIndex = queryHeapIndex(allocator, typeIndex);
+        if (heapIndex >= heapCount) continue;
+
+        VKRT_MemoryHeapStats* heap = &outSnapshot->heaps[heapIndex];
+        for (uint32_t kind = 0; kind < MEMORY_RESOURCE_KIND_COUNT; kind++) {
+            const MemoryPool* pool = &allocator->pools[typeIndex][kind];
+            for (uint32_t i = 0; i < pool->blockCount; i++) {
+                const MemoryBlock* block = pool->blocks[i];
+                heap->blockCount++;
+                heap->allocationCount += block->allocationCount;
+                heap->reservedBytes += block->size;
+                heap->usedBytes += block->usedBytes;
+                for (uint32_t rangeIndex = 0; rangeIndex < block->freeRangeCount; rangeIndex++) {
+                    VkDeviceSize rangeSize = block->freeRanges[rangeIndex].size;
+                    totalFreeBytes += rangeSize;
+                    if (rangeSize > largestFreeRange) largestFreeRange = rangeSize;
+                }
+            }
+        }
+    }
+    vkrtMutexUnlock(lock);
+
+    for (uint32_t heapIndex = 0; heapIndex < heapCount; heapIndex++) {
+        const VKRT_MemoryHeapStats* heap = &outSnapshot->heaps[heapIndex];
+        outSnapshot->blockCount += heap->blockCount;
+        outSnapshot->allocationCount += heap->allocationCount;
+        outSnapshot->reservedBytes += heap->reservedBytes;
+        outSnapshot->usedBytes += heap->usedBytes;
+    }
+    outSnapshot->fragmentation =
+        totalFreeBytes > 0u ? 1.0f - (float)((double)largestFreeRange / (double)totalFreeBytes) : 0.0f;
+}
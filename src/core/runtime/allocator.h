@@ -0,0 +1,21 @@
+#pragma once
+
+#include "vkrt_internal.h"
+
+VKRT_Result vkrtCreateMemoryAllocator(VKRT* vkrt);
+void vkrtDestroyMemoryAllocator(VKRT* vkrt);
+VKRT_Result vkrtAllocateBufferMemory(
+    VKRT* vkrt,
+    VkBuffer buffer,
+    VkMemoryPropertyFlags properties,
+    MemoryAllocation* outAllocation
+);
+VKRT_Result vkrtAllocateImageMemory(
+    VKRT* vkrt,
+    VkImage image,
+    VkMemoryPropertyFlags properties,
+    MemoryAllocation* outAllocation
+);
+void vkrtFreeMemory(VKRT* vkrt, MemoryAllocation* allocation);
+void* vkrtMappedMemory(MemoryAllocation allocation);
+void vkrtQueryMemoryStats(const VKRT* vkrt, VKRT_MemorySnapshot* outSnapshot);
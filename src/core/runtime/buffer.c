@@ -1,8 +1,9 @@
 #include "buffer.h"
 
+#include "allocator.h"
 #include "command/pool.h"
 #include "debug.h"
-#include "device.h"
+#include "staging.h"
 #include "vkrt_engine_types.h"
 #include "vkrt_internal.h"
 #include "vkrt_types.h"
@@ -13,79 +14,58 @@
 #include <stdlib.h>
 #include <string.h>
 
+static const uint32_t kInitialSceneTransferCapacity = 16u;
+
 static VKRT_Result appendPendingSceneTransfer(
     VKRT* vkrt,
-    VkBuffer stagingBuffer,
-    VkDeviceMemory stagingMemory,
+    const StagingAllocation* staging,
     VkBuffer dstBuffer,
+    VkDeviceSize dstOffset,
     VkDeviceSize size
 ) {
-    if (!vkrt || stagingBuffer == VK_NULL_HANDLE || stagingMemory == VK_NULL_HANDLE || dstBuffer == VK_NULL_HANDLE ||
-        size == 0) {
+    if (!vkrt || !staging || staging->buffer == VK_NULL_HANDLE || dstBuffer == VK_NULL_HANDLE || size == 0) {
         return VKRT_ERROR_INVALID_ARGUMENT;
     }
 
     FrameSceneUpdate* update = vkrtCurrentFrameSceneUpdate(vkrt);
-    uint32_t nextCount = update->sceneTransferCount + 1u;
-    PendingBufferCopy* resized =
-        (PendingBufferCopy*)realloc(update->sceneTransfers, (size_t)nextCount * sizeof(PendingBufferCopy));
-    if (!resized) {
-        return VKRT_ERROR_OUT_OF_MEMORY;
+    if (update->sceneTransferCount == update->sceneTransferCapacity) {
+        uint32_t capacity =
+            update->sceneTransferCapacity > 0u ? update->sceneTransferCapacity * 2u : kInitialSceneTransferCapacity;
+        PendingBufferCopy* resized =
+            (PendingBufferCopy*)realloc(update->sceneTransfers, (size_t)capacity * sizeof(PendingBufferCopy));
+        if (!resized) {
+            return VKRT_ERROR_OUT_OF_MEMORY;
+        }
+        update->sceneTransfers = resized;
+        update->sceneTransferCapacity = capacity;
     }
 
-    update->sceneTransfers = resized;
-    update->sceneTransfers[update->sceneTransferCount] = (PendingBufferCopy){
-        .stagingBuffer = stagingBuffer,
-        .stagingMemory = stagingMemory,
+    update->sceneTransfers[update->sceneTransferCount++] = (PendingBufferCopy){
+        .stagingBuffer = staging->buffer,
+        .stagingOffset = staging->offset,
         .dstBuffer = dstBuffer,
+        .dstOffset = dstOffset,
         .size = size,
     };
-    update->sceneTransferCount = nextCount;
     return VKRT_SUCCESS;
 }
 
-static void destroyRawBuffer(VKRT* vkrt, VkBuffer* buffer, VkDeviceMemory* memory) {
+static void destroyRawBuffer(VKRT* vkrt, VkBuffer* buffer, MemoryAllocation* memory) {
     if (!vkrt || !buffer || !memory) return;
     if (*buffer != VK_NULL_HANDLE) {
         vkDestroyBuffer(vkrt->core.device, *buffer, NULL);
         *buffer = VK_NULL_HANDLE;
     }
-    if (*memory != VK_NULL_HANDLE) {
-        vkFreeMemory(vkrt->core.device, *memory, NULL);
-        *memory = VK_NULL_HANDLE;
-    }
+    vkrtFreeMemory(vkrt, memory);
 }
 
-static VKRT_Result createStagingBufferFromData(
-    VKRT* vkrt,
-    const void* hostData,
-    VkDeviceSize size,
-    VkBuffer* outBuffer,
-    VkDeviceMemory* outMemory
-) {
-    if (!vkrt || !hostData || !outBuffer || !outMemory) return VKRT_ERROR_INVALID_ARGUMENT;
-
-    *outBuffer = VK_NULL_HANDLE;
-    *outMemory = VK_NULL_HANDLE;
+static VKRT_Result stageHostData(VKRT* vkrt, const void* hostData, VkDeviceSize size, StagingAllocation* outStaging) {
+    if (!vkrt || !hostData || !outStaging) return VKRT_ERROR_INVALID_ARGUMENT;
 
-    VKRT_Result result = createBuffer(
-        vkrt,
-        size,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        outBuffer,
-        outMemory
-    );
+    VKRT_Result result = vkrtAllocateStaging(vkrt, size, outStaging);
     if (result != VKRT_SUCCESS) return result;
 
-    void* mapped = NULL;
-    if (vkMapMemory(vkrt->core.device, *outMemory, 0, size, 0, &mapped) != VK_SUCCESS || !mapped) {
-        destroyRawBuffer(vkrt, outBuffer, outMemory);
-        return VKRT_ERROR_OPERATION_FAILED;
-    }
-
-    memcpy(mapped, hostData, (size_t)size);
-    vkUnmapMemory(vkrt->core.device, *outMemory);
+    memcpy(outStaging->mapped, hostData, (size_t)size);
     return VKRT_SUCCESS;
 }
 
@@ -102,7 +82,7 @@ VKRT_Result createBuffer(
     VkBufferUsageFlags usage,
     VkMemoryPropertyFlags properties,
     VkBuffer* buffer,
-    VkDeviceMemory* bufferMemory
+    MemoryAllocation* bufferMemory
 ) {
     if (!vkrt || !buffer || !bufferMemory) return VKRT_ERROR_INVALID_ARGUMENT;
 
@@ -117,46 +97,18 @@ VKRT_Result createBuffer(
         return VKRT_ERROR_OPERATION_FAILED;
     }
 
-    VkMemoryRequirements memoryRequirements;
-    vkGetBufferMemoryRequirements(vkrt->core.device, *buffer, &memoryRequirements);
-
-    VkMemoryAllocateInfo memoryAllocateInfo = {0};
-    memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    memoryAllocateInfo.allocationSize = memoryRequirements.size;
-    uint32_t memoryTypeIndex = 0;
-    if (findMemoryType(vkrt, memoryRequirements.memoryTypeBits, properties, &memoryTypeIndex) != VKRT_SUCCESS) {
-        vkDestroyBuffer(vkrt->core.device, *buffer, NULL);
-        *buffer = VK_NULL_HANDLE;
-        return VKRT_ERROR_OPERATION_FAILED;
-    }
-    memoryAllocateInfo.memoryTypeIndex = memoryTypeIndex;
-
-    VkMemoryAllocateFlagsInfo memoryAllocateFlagsInfo = {0};
-    if (usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) {
-        memoryAllocateFlagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
-        memoryAllocateFlagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
-        memoryAllocateInfo.pNext = &memoryAllocateFlagsInfo;
-    }
-
-    if (vkAllocateMemory(vkrt->core.device, &memoryAllocateInfo, NULL, bufferMemory) != VK_SUCCESS) {
+    VKRT_Result result = vkrtAllocateBufferMemory(vkrt, *buffer, properties, bufferMemory);
+    if (result != VKRT_SUCCESS) {
         LOG_ERROR("Failed to allocate buffer memory");
         vkDestroyBuffer(vkrt->core.device, *buffer, NULL);
         *buffer = VK_NULL_HANDLE;
-        return VKRT_ERROR_OPERATION_FAILED;
-    }
-
-    if (vkBindBufferMemory(vkrt->core.device, *buffer, *bufferMemory, 0) != VK_SUCCESS) {
-        vkDestroyBuffer(vkrt->core.device, *buffer, NULL);
-        vkFreeMemory(vkrt->core.device, *bufferMemory, NULL);
-        *buffer = VK_NULL_HANDLE;
-        *bufferMemory = VK_NULL_HANDLE;
-        return VKRT_ERROR_OPERATION_FAILED;
+        return result;
     }
 
     return VKRT_SUCCESS;
 }
 
-VKRT_Result copyBuffer(VKRT* vkrt, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) {
+VKRT_Result copyBuffer(VKRT* vkrt, VkBuffer srcBuffer, VkDeviceSize srcOffset, VkBuffer dstBuffer, VkDeviceSize size) {
     if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
 
     VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
@@ -164,6 +116,7 @@ VKRT_Result copyBuffer(VKRT* vkrt, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDev
     if (result != VKRT_SUCCESS) return result;
 
     VkBufferCopy copyRegion = {0};
+    copyRegion.srcOffset = srcOffset;
     copyRegion.size = size;
     vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
 
@@ -176,7 +129,7 @@ VKRT_Result createHostBufferFromData(
     VkDeviceSize size,
     VkBufferUsageFlags usage,
     VkBuffer* outBuffer,
-    VkDeviceMemory* outMemory,
+    MemoryAllocation* outMemory,
     VkDeviceAddress* outDeviceAddress
 ) {
     if (!vkrt || !hostData || !outBuffer || !outMemory) return VKRT_ERROR_INVALID_ARGUMENT;
@@ -191,17 +144,13 @@ VKRT_Result createHostBufferFromData(
     );
     if (result != VKRT_SUCCESS) return result;
 
-    void* mapped = NULL;
-    if (vkMapMemory(vkrt->core.device, *outMemory, 0, size, 0, &mapped) != VK_SUCCESS || !mapped) {
-        vkDestroyBuffer(vkrt->core.device, *outBuffer, NULL);
-        vkFreeMemory(vkrt->core.device, *outMemory, NULL);
-        *outBuffer = VK_NULL_HANDLE;
-        *outMemory = VK_NULL_HANDLE;
+    void* mapped = vkrtMappedMemory(*outMemory);
+    if (!mapped) {
+        destroyRawBuffer(vkrt, outBuffer, outMemory);
         return VKRT_ERROR_OPERATION_FAILED;
     }
 
     memcpy(mapped, hostData, (size_t)size);
-    vkUnmapMemory(vkrt->core.device, *outMemory);
 
     if (outDeviceAddress) {
         *outDeviceAddress = queryBufferDeviceAddress(vkrt, *outBuffer);
@@ -215,14 +164,13 @@ VKRT_Result createDeviceBufferFromData(
     VkDeviceSize size,
     VkBufferUsageFlags usage,
     VkBuffer* outBuffer,
-    VkDeviceMemory* outMemory,
+    MemoryAllocation* outMemory,
     VkDeviceAddress* outDeviceAddress
 ) {
     if (!vkrt || !hostData || !outBuffer || !outMemory) return VKRT_ERROR_INVALID_ARGUMENT;
 
-    VkBuffer stagingBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
-    VKRT_Result result = createStagingBufferFromData(vkrt, hostData, size, &stagingBuffer, &stagingMemory);
+    StagingAllocation staging = {0};
+    VKRT_Result result = stageHostData(vkrt, hostData, size, &staging);
     if (result != VKRT_SUCCESS) return result;
 
     result = createBuffer(
@@ -234,13 +182,13 @@ VKRT_Result createDeviceBufferFromData(
         outMemory
     );
     if (result != VKRT_SUCCESS) {
-        destroyRawBuffer(vkrt, &stagingBuffer, &stagingMemory);
+        vkrtReleaseStaging(vkrt, &staging);
         return result;
     }
 
-    result = appendPendingSceneTransfer(vkrt, stagingBuffer, stagingMemory, *outBuffer, size);
+    result = appendPendingSceneTransfer(vkrt, &staging, *outBuffer, 0, size);
     if (result != VKRT_SUCCESS) {
-        destroyRawBuffer(vkrt, &stagingBuffer, &stagingMemory);
+        vkrtReleaseStaging(vkrt, &staging);
         destroyRawBuffer(vkrt, outBuffer, outMemory);
         return result;
     }
@@ -251,20 +199,44 @@ VKRT_Result createDeviceBufferFromData(
     return VKRT_SUCCESS;
 }
 
+VKRT_Result updateDeviceBufferFromData(VKRT* vkrt, const void* hostData, VkDeviceSize size, VkBuffer dstBuffer) {
+    return updateDeviceBufferRangeFromData(vkrt, hostData, size, dstBuffer, 0);
+}
+
+VKRT_Result updateDeviceBufferRangeFromData(
+    VKRT* vkrt,
+    const void* hostData,
+    VkDeviceSize size,
+    VkBuffer dstBuffer,
+    VkDeviceSize dstOffset
+) {
+    if (!vkrt || !hostData || size == 0 || dstBuffer == VK_NULL_HANDLE) return VKRT_ERROR_INVALID_ARGUMENT;
+
+    StagingAllocation staging = {0};
+    VKRT_Result result = stageHostData(vkrt, hostData, size, &staging);
+    if (result != VKRT_SUCCESS) return result;
+
+    result = appendPendingSceneTransfer(vkrt, &staging, dstBuffer, dstOffset, size);
+    if (result != VKRT_SUCCESS) {
+        vkrtReleaseStaging(vkrt, &staging);
+        return result;
+    }
+    return VKRT_SUCCESS;
+}
+
 VKRT_Result createDeviceBufferFromDataImmediate(
     VKRT* vkrt,
     const void* hostData,
     VkDeviceSize size,
     VkBufferUsageFlags usage,
     VkBuffer* outBuffer,
-    VkDeviceMemory* outMemory,
+    MemoryAllocation* outMemory,
     VkDeviceAddress* outDeviceAddress
 ) {
     if (!vkrt || !hostData || !outBuffer || !outMemory) return VKRT_ERROR_INVALID_ARGUMENT;
 
-    VkBuffer stagingBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
-    VKRT_Result result = createStagingBufferFromData(vkrt, hostData, size, &stagingBuffer, &stagingMemory);
+    StagingAllocation staging = {0};
+    VKRT_Result result = stageHostData(vkrt, hostData, size, &staging);
     if (result != VKRT_SUCCESS) return result;
 
     result = createBuffer(
@@ -276,12 +248,12 @@ VKRT_Result createDeviceBufferFromDataImmediate(
         outMemory
     );
     if (result != VKRT_SUCCESS) {
-        destroyRawBuffer(vkrt, &stagingBuffer, &stagingMemory);
+        vkrtReleaseStaging(vkrt, &staging);
         return result;
     }
 
-    result = copyBuffer(vkrt, stagingBuffer, *outBuffer, size);
-    destroyRawBuffer(vkrt, &stagingBuffer, &stagingMemory);
+    result = copyBuffer(vkrt, staging.buffer, staging.offset, *outBuffer, size);
+    vkrtReleaseStaging(vkrt, &staging);
     if (result != VKRT_SUCCESS) {
         destroyRawBuffer(vkrt, outBuffer, outMemory);
         return result;
@@ -325,10 +297,7 @@ void destroyBufferResources(VKRT* vkrt, Buffer* buffer) {
         vkDestroyBuffer(vkrt->core.device, buffer->buffer, NULL);
         buffer->buffer = VK_NULL_HANDLE;
     }
-    if (buffer->memory != VK_NULL_HANDLE) {
-        vkFreeMemory(vkrt->core.device, buffer->memory, NULL);
-        buffer->memory = VK_NULL_HANDLE;
-    }
+    vkrtFreeMemory(vkrt, &buffer->memory);
     buffer->deviceAddress = 0;
     buffer->count = 0;
 }
@@ -339,8 +308,5 @@ void destroyTransfer(VKRT* vkrt, FrameTransfer* transfer) {
         vkDestroyBuffer(vkrt->core.device, transfer->buffer, NULL);
         transfer->buffer = VK_NULL_HANDLE;
     }
-    if (transfer->memory != VK_NULL_HANDLE) {
-        vkFreeMemory(vkrt->core.device, transfer->memory, NULL);
-        transfer->memory = VK_NULL_HANDLE;
-    }
+    vkrtFreeMemory(vkrt, &transfer->memory);
 }
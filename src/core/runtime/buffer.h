@@ -8,16 +8,16 @@ VKRT_Result createBuffer(
     VkBufferUsageFlags usage,
     VkMemoryPropertyFlags properties,
     VkBuffer* buffer,
-    VkDeviceMemory* bufferMemory
+    MemoryAllocation* bufferMemory
 );
-VKRT_Result copyBuffer(VKRT* vkrt, VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
+VKRT_Result copyBuffer(VKRT* vkrt, VkBuffer srcBuffer, VkDeviceSize srcOffset, VkBuffer dstBuffer, VkDeviceSize size);
 VKRT_Result createHostBufferFromData(
     VKRT* vkrt,
     const void* hostData,
     VkDeviceSize size,
     VkBufferUsageFlags usage,
     VkBuffer* outBuffer,
-    VkDeviceMemory* outMemory,
+    MemoryAllocation* outMemory,
     VkDeviceAddress* outDeviceAddress
 );
 VKRT_Result createDeviceBufferFromData(
@@ -26,16 +26,24 @@ VKRT_Result createDeviceBufferFromData(
     VkDeviceSize size,
     VkBufferUsageFlags usage,
     VkBuffer* outBuffer,
-    VkDeviceMemory* outMemory,
+    MemoryAllocation* outMemory,
     VkDeviceAddress* outDeviceAddress
 );
+VKRT_Result updateDeviceBufferFromData(VKRT* vkrt, const void* hostData, VkDeviceSize size, VkBuffer dstBuffer);
+VKRT_Result updateDeviceBufferRangeFromData(
+    VKRT* vkrt,
+    const void* hostData,
+    VkDeviceSize size,
+    VkBuffer dstBuffer,
+    VkDeviceSize dstOffset
+);
 VKRT_Result createDeviceBufferFromDataImmediate(
     VKRT* vkrt,
     const void* hostData,
     VkDeviceSize size,
     VkBufferUsageFlags usage,
     VkBuffer* outBuffer,
-    VkDeviceMemory* outMemory,
+    MemoryAllocation* outMemory,
     VkDeviceAddress* outDeviceAddress
 );
 VKRT_Result createZeroInitializedDeviceBuffer(
@@ -3,11 +3,15 @@
 #include "config.h"
 #include "debug.h"
 #include "record.h"
+#include "state.h"
 #include "vkrt_types.h"
 #include "vulkan/vulkan_core.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 
+static const uint32_t kTransferTrackingInitialCapacity = 8u;
+
 typedef struct ImageLayoutTransitionRule {
     VkImageLayout oldLayout;
     VkImageLayout newLayout;
@@ -30,9 +34,62 @@ VKRT_Result createCommandPool(VKRT* vkrt) {
         LOG_ERROR("Failed to create command pool");
         return VKRT_ERROR_OPERATION_FAILED;
     }
+
+    VkFenceCreateInfo fenceCreateInfo = {0};
+    fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    if (vkCreateFence(vkrt->core.device, &fenceCreateInfo, NULL, &vkrt->runtime.singleTimeFence) != VK_SUCCESS) {
+        LOG_ERROR("Failed to create single-time command fence");
+        return VKRT_ERROR_OPERATION_FAILED;
+    }
     return VKRT_SUCCESS;
 }
 
+VKRT_Result createTransferQueueResources(VKRT* vkrt) {
+    if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
+
+    TransferQueueState* transfer = &vkrt->runtime.transfer;
+    VkCommandPoolCreateInfo commandPoolCreateInfo = {0};
+    commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    commandPoolCreateInfo.queueFamilyIndex = (uint32_t)vkrt->core.indices.transfer;
+
+    if (vkCreateCommandPool(vkrt->core.device, &commandPoolCreateInfo, NULL, &transfer->commandPool) != VK_SUCCESS) {
+        LOG_ERROR("Failed to create transfer command pool");
+        return VKRT_ERROR_OPERATION_FAILED;
+    }
+
+    VkSemaphoreTypeCreateInfo semaphoreTypeCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = 0u,
+    };
+    VkSemaphoreCreateInfo semaphoreCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &semaphoreTypeCreateInfo,
+    };
+    if (vkCreateSemaphore(vkrt->core.device, &semaphoreCreateInfo, NULL, &transfer->timeline) != VK_SUCCESS) {
+        LOG_ERROR("Failed to create transfer timeline semaphore");
+        destroyTransferQueueResources(vkrt);
+        return VKRT_ERROR_OPERATION_FAILED;
+    }
+    return VKRT_SUCCESS;
+}
+
+void destroyTransferQueueResources(VKRT* vkrt) {
+    if (!vkrt || vkrt->core.device == VK_NULL_HANDLE) return;
+
+    TransferQueueState* transfer = &vkrt->runtime.transfer;
+    if (transfer->commandPool != VK_NULL_HANDLE) {
+        vkDestroyCommandPool(vkrt->core.device, transfer->commandPool, NULL);
+    }
+    if (transfer->timeline != VK_NULL_HANDLE) {
+        vkDestroySemaphore(vkrt->core.device, transfer->timeline, NULL);
+    }
+    free(transfer->submissions);
+    free(transfer->acquires);
+    *transfer = (TransferQueueState){0};
+}
+
 VKRT_Result createCommandBuffers(VKRT* vkrt) {
     if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
 
@@ -90,11 +147,13 @@ VKRT_Result endSingleTimeCommands(VKRT* vkrt, VkCommandBuffer commandBuffer) {
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBuffer;
 
-    if (vkQueueSubmit(vkrt->core.graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+    VkFence fence = vkrt->runtime.singleTimeFence;
+    if (vkResetFences(vkrt->core.device, 1, &fence) != VK_SUCCESS ||
+        vkQueueSubmit(vkrt->core.graphicsQueue, 1, &submitInfo, fence) != VK_SUCCESS) {
         vkFreeCommandBuffers(vkrt->core.device, vkrt->runtime.commandPool, 1, &commandBuffer);
         return VKRT_ERROR_OPERATION_FAILED;
     }
-    if (vkQueueWaitIdle(vkrt->core.graphicsQueue) != VK_SUCCESS) {
+    if (vkWaitForFences(vkrt->core.device, 1, &fence, VK_TRUE, UINT64_MAX) != VK_SUCCESS) {
         vkFreeCommandBuffers(vkrt->core.device, vkrt->runtime.commandPool, 1, &commandBuffer);
         return VKRT_ERROR_OPERATION_FAILED;
     }
@@ -103,6 +162,208 @@ VKRT_Result endSingleTimeCommands(VKRT* vkrt, VkCommandBuffer commandBuffer) {
     return VKRT_SUCCESS;
 }
 
+static void reclaimTransferSubmissions(VKRT* vkrt) {
+    TransferQueueState* transfer = &vkrt->runtime.transfer;
+    if (transfer->submissionCount == 0u) return;
+
+    uint64_t completedValue = 0u;
+    if (vkGetSemaphoreCounterValue(vkrt->core.device, transfer->timeline, &completedValue) != VK_SUCCESS) return;
+
+    uint32_t keptCount = 0u;
+    for (uint32_t i = 0; i < transfer->submissionCount; i++) {
+        TransferSubmission submission = transfer->submissions[i];
+        if (submission.value <= completedValue) {
+            vkFreeCommandBuffers(vkrt->core.device, transfer->commandPool, 1, &submission.commandBuffer);
+            continue;
+        }
+        transfer->submissions[keptCount++] = submission;
+    }
+    transfer->submissionCount = keptCount;
+}
+
+static int reserveTransferTracking(TransferQueueState* transfer) {
+    if (transfer->submissionCount == transfer->submissionCapacity) {
+        uint32_t capacity =
+            transfer->submissionCapacity > 0u ? transfer->submissionCapacity * 2u : kTransferTrackingInitialCapacity;
+        TransferSubmission* resized =
+            (TransferSubmission*)realloc(transfer->submissions, (size_t)capacity * sizeof(TransferSubmission));
+        if (!resized) return 0;
+        transfer->submissions = resized;
+        transfer->submissionCapacity = capacity;
+    }
+
+    if (transfer->acquireCount == transfer->acquireCapacity) {
+        uint32_t capacity =
+            transfer->acquireCapacity > 0u ? transfer->acquireCapacity * 2u : kTransferTrackingInitialCapacity;
+        PendingImageAcquire* resized =
+            (PendingImageAcquire*)realloc(transfer->acquires, (size_t)capacity * sizeof(PendingImageAcquire));
+        if (!resized) return 0;
+        transfer->acquires = resized;
+        transfer->acquireCapacity = capacity;
+    }
+    return 1;
+}
+
+static void recordImageOwnershipTransfer(
+    VkCommandBuffer commandBuffer,
+    VkImage image,
+    uint32_t srcQueueFamilyIndex,
+    uint32_t dstQueueFamilyIndex,
+    VkBool32 release
+) {
+    VkImageMemoryBarrier2 barrier = {0};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcQueueFamilyIndex = srcQueueFamilyIndex;
+    barrier.dstQueueFamilyIndex = dstQueueFamilyIndex;
+    barrier.image = image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+
+    if (release) {
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    } else {
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT |
+                               VK_PIPELINE_STAGE_2_RAY_TRACING_SHADER_BIT_KHR;
+        barrier.dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
+    }
+
+    VkDependencyInfo dependencyInfo = {0};
+    dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dependencyInfo.imageMemoryBarrierCount = 1;
+    dependencyInfo.pImageMemoryBarriers = &barrier;
+    vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+}
+
+VKRT_Result beginTransferCommands(VKRT* vkrt, VkCommandBuffer* outCommandBuffer) {
+    if (!vkrt || !outCommandBuffer) return VKRT_ERROR_INVALID_ARGUMENT;
+
+    TransferQueueState* transfer = &vkrt->runtime.transfer;
+    reclaimTransferSubmissions(vkrt);
+
+    VkCommandBufferAllocateInfo commandBufferAllocateInfo = {0};
+    commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    commandBufferAllocateInfo.commandPool = transfer->commandPool;
+    commandBufferAllocateInfo.commandBufferCount = 1;
+
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    if (vkAllocateCommandBuffers(vkrt->core.device, &commandBufferAllocateInfo, &commandBuffer) != VK_SUCCESS) {
+        return VKRT_ERROR_OPERATION_FAILED;
+    }
+
+    VkCommandBufferBeginInfo commandBufferBeginInfo = {0};
+    commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    commandBufferBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    if (vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo) != VK_SUCCESS) {
+        vkFreeCommandBuffers(vkrt->core.device, transfer->commandPool, 1, &commandBuffer);
+        return VKRT_ERROR_OPERATION_FAILED;
+    }
+
+    *outCommandBuffer = commandBuffer;
+    return VKRT_SUCCESS;
+}
+
+VKRT_Result submitTransferImageUpload(
+    VKRT* vkrt,
+    VkCommandBuffer commandBuffer,
+    VkImage image,
+    uint64_t* outTransferValue
+) {
+    if (!vkrt || commandBuffer == VK_NULL_HANDLE || image == VK_NULL_HANDLE || !outTransferValue) {
+        return VKRT_ERROR_INVALID_ARGUMENT;
+    }
+
+    TransferQueueState* transfer = &vkrt->runtime.transfer;
+    uint32_t graphicsFamily = (uint32_t)vkrt->core.indices.graphics;
+    uint32_t transferFamily = (uint32_t)vkrt->core.indices.transfer;
+    if (transferFamily != graphicsFamily) {
+        recordImageOwnershipTransfer(commandBuffer, image, transferFamily, graphicsFamily, VK_TRUE);
+    } else {
+        transitionImageLayout(
+            commandBuffer,
+            image,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+        );
+    }
+
+    if (!reserveTransferTracking(transfer)) {
+        vkFreeCommandBuffers(vkrt->core.device, transfer->commandPool, 1, &commandBuffer);
+        return VKRT_ERROR_OUT_OF_MEMORY;
+    }
+    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+        vkFreeCommandBuffers(vkrt->core.device, transfer->commandPool, 1, &commandBuffer);
+        return VKRT_ERROR_OPERATION_FAILED;
+    }
+
+    uint64_t signalValue = transfer->submittedValue + 1u;
+    VkTimelineSemaphoreSubmitInfo timelineSubmitInfo = {
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .signalSemaphoreValueCount = 1u,
+        .pSignalSemaphoreValues = &signalValue,
+    };
+
+    VkSubmitInfo submitInfo = {0};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineSubmitInfo;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &transfer->timeline;
+
+    if (vkQueueSubmit(vkrt->core.transferQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+        vkFreeCommandBuffers(vkrt->core.device, transfer->commandPool, 1, &commandBuffer);
+        return VKRT_ERROR_OPERATION_FAILED;
+    }
+
+    transfer->submittedValue = signalValue;
+    transfer->submissions[transfer->submissionCount++] = (TransferSubmission){commandBuffer, signalValue};
+    transfer->acquires[transfer->acquireCount++] = (PendingImageAcquire){image, signalValue};
+    *outTransferValue = signalValue;
+    return VKRT_SUCCESS;
+}
+
+void recordPendingImageAcquires(VKRT* vkrt, VkCommandBuffer commandBuffer) {
+    if (!vkrt || commandBuffer == VK_NULL_HANDLE) return;
+
+    TransferQueueState* transfer = &vkrt->runtime.transfer;
+    uint32_t graphicsFamily = (uint32_t)vkrt->core.indices.graphics;
+    uint32_t transferFamily = (uint32_t)vkrt->core.indices.transfer;
+    if (transferFamily != graphicsFamily) {
+        for (uint32_t i = 0; i < transfer->acquireCount; i++) {
+            recordImageOwnershipTransfer(
+                commandBuffer,
+                transfer->acquires[i].image,
+                transferFamily,
+                graphicsFamily,
+                VK_FALSE
+            );
+        }
+    }
+    transfer->acquireCount = 0u;
+}
+
+void dropPendingImageAcquire(VKRT* vkrt, VkImage image) {
+    if (!vkrt || image == VK_NULL_HANDLE) return;
+
+    TransferQueueState* transfer = &vkrt->runtime.transfer;
+    for (uint32_t i = 0; i < transfer->acquireCount; i++) {
+        if (transfer->acquires[i].image != image) continue;
+        if (vkrtWaitForTransferValue(vkrt, transfer->acquires[i].value) != VKRT_SUCCESS) {
+            LOG_ERROR("Failed waiting for pending texture upload");
+        }
+        transfer->acquires[i] = transfer->acquires[--transfer->acquireCount];
+        return;
+    }
+}
+
 static int findImageLayoutTransitionRule(
     VkImageLayout oldLayout,
     VkImageLayout newLayout,
@@ -219,7 +480,7 @@ void transitionImageLayout(
     barrier.image = image;
     barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
     barrier.subresourceRange.baseArrayLayer = 0;
     barrier.subresourceRange.layerCount = 1;
 
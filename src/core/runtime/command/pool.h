@@ -2,7 +2,20 @@
 
 #include "vkrt_internal.h"
 
+#include <stdint.h>
+
 VKRT_Result createCommandPool(VKRT* vkrt);
 VKRT_Result createCommandBuffers(VKRT* vkrt);
+VKRT_Result createTransferQueueResources(VKRT* vkrt);
+void destroyTransferQueueResources(VKRT* vkrt);
 VKRT_Result beginSingleTimeCommands(VKRT* vkrt, VkCommandBuffer* outCommandBuffer);
 VKRT_Result endSingleTimeCommands(VKRT* vkrt, VkCommandBuffer commandBuffer);
+VKRT_Result beginTransferCommands(VKRT* vkrt, VkCommandBuffer* outCommandBuffer);
+VKRT_Result submitTransferImageUpload(
+    VKRT* vkrt,
+    VkCommandBuffer commandBuffer,
+    VkImage image,
+    uint64_t* outTransferValue
+);
+void recordPendingImageAcquires(VKRT* vkrt, VkCommandBuffer commandBuffer);
+void dropPendingImageAcquire(VKRT* vkrt, VkImage image);
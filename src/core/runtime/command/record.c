@@ -2,6 +2,7 @@
 
 #include "accel/accel.h"
 #include "debug.h"
+#include "pool.h"
 #include "scene.h"
 #include "types.h"
 #include "view.h"
@@ -109,12 +110,25 @@ static void recordMemoryAccessBarrier(
 static void recordSceneUpdateCommands(VKRT* vkrt, VkCommandBuffer commandBuffer) {
     FrameSceneUpdate* update = vkrtCurrentFrameSceneUpdate(vkrt);
     VkBool32 hasTransferWrites = VK_FALSE;
-    VkBool32 hasBLASBuilds = update->blasBuildCount > 0 ? VK_TRUE : VK_FALSE;
+    VkBool32 hasBLASBuilds = update->blasBuildCount > 0 || update->blasCompactionCount > 0 ? VK_TRUE : VK_FALSE;
     VkBool32 hasTLASBuild = update->sceneTLASBuildPending || update->selectionTLASBuildPending;
 
+    if (update->sceneTransferCount > 0) {
+        // In-place patches overwrite buffers the previous frame's shaders may still be reading.
+        recordMemoryAccessBarrier(
+            commandBuffer,
+            VK_ACCESS_2_SHADER_READ_BIT,
+            VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            VK_PIPELINE_STAGE_2_RAY_TRACING_SHADER_BIT_KHR,
+            VK_PIPELINE_STAGE_2_TRANSFER_BIT
+        );
+    }
+
     for (uint32_t i = 0; i < update->sceneTransferCount; i++) {
         PendingBufferCopy* transfer = &update->sceneTransfers[i];
         VkBufferCopy copyRegion = {
+            .srcOffset = transfer->stagingOffset,
+            .dstOffset = transfer->dstOffset,
             .size = transfer->size,
         };
         vkCmdCopyBuffer(commandBuffer, transfer->stagingBuffer, transfer->dstBuffer, 1, &copyRegion);
@@ -123,21 +137,9 @@ static void recordSceneUpdateCommands(VKRT* vkrt, VkCommandBuffer commandBuffer)
 
     for (uint32_t i = 0; i < update->geometryUploadCount; i++) {
         PendingGeometryUpload* upload = &update->geometryUploads[i];
-        Mesh* mesh = &vkrt->core.meshes[upload->meshIndex];
-        VkBufferCopy copyRegions[2] = {
-            {
-                .srcOffset = 0,
-                .dstOffset = (VkDeviceSize)mesh->info.vertexBase * sizeof(ShaderVertex),
-                .size = (VkDeviceSize)mesh->info.vertexCount * sizeof(ShaderVertex),
-            },
-            {
-                .srcOffset = upload->indexOffset,
-                .dstOffset = (VkDeviceSize)mesh->info.indexBase * sizeof(uint32_t),
-                .size = (VkDeviceSize)mesh->info.indexCount * sizeof(uint32_t),
-            },
-        };
-        vkCmdCopyBuffer(commandBuffer, upload->stagingBuffer, vkrt->core.vertexData.buffer, 1, &copyRegions[0]);
-        vkCmdCopyBuffer(commandBuffer, upload->stagingBuffer, vkrt->core.indexData.buffer, 1, &copyRegions[1]);
+        vkCmdCopyBuffer(commandBuffer, upload->stagingBuffer, vkrt->core.positionData.buffer, 1, &upload->positionCopy);
+        vkCmdCopyBuffer(commandBuffer, upload->stagingBuffer, vkrt->core.vertexData.buffer, 1, &upload->vertexCopy);
+        vkCmdCopyBuffer(commandBuffer, upload->stagingBuffer, vkrt->core.indexData.buffer, 1, &upload->indexCopy);
         hasTransferWrites = VK_TRUE;
     }
 
@@ -161,6 +163,7 @@ static void recordSceneUpdateCommands(VKRT* vkrt, VkCommandBuffer commandBuffer)
             VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
             VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR | VK_PIPELINE_STAGE_2_RAY_TRACING_SHADER_BIT_KHR
         );
+        recordBottomLevelAccelerationStructureCompactionQueries(vkrt, commandBuffer);
     }
 
     if (hasTLASBuild) {
@@ -194,6 +197,7 @@ typedef struct RecordCommandContext {
     VkImage normalWriteImage;
     VkImage outputImage;
     VkImage selectionMaskImage;
+    VkImage adaptiveMomentImage;
     VkImage destImage;
     VkImageSubresourceRange clearRange;
     VkBool32 renderModeActive;
@@ -201,6 +205,7 @@ typedef struct RecordCommandContext {
     VkBool32 shouldTrace;
     VkBool32 shouldSelectionTrace;
     VkBool32 shouldSelectionPost;
+    VkBool32 shouldAdaptiveSampling;
 } RecordCommandContext;
 
 typedef struct ViewportRect {
@@ -238,6 +243,7 @@ static void initializeRecordCommandContext(
     context->normalWriteImage = vkrt->core.normalImages[vkrt->core.accumulationWriteIndex];
     context->outputImage = vkrt->core.outputImage;
     context->selectionMaskImage = vkrt->core.selectionMaskImage;
+    context->adaptiveMomentImage = vkrt->core.adaptiveMomentImage;
     context->destImage = presentToSwapchain ? vkrt->runtime.swapChainImages[imageIndex] : VK_NULL_HANDLE;
     context->clearRange = (VkImageSubresourceRange){
         .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
@@ -259,6 +265,9 @@ static void initializeRecordCommandContext(
                                     vkrt->core.selectionRayTracingPipeline != VK_NULL_HANDLE;
     context->shouldSelectionPost =
         context->shouldTrace && selectionOverlayEnabled && vkrt->core.computePipeline != VK_NULL_HANDLE;
+    context->shouldAdaptiveSampling = context->shouldTrace && vkrt->sceneSettings.noiseThreshold > 0.0f &&
+                                      vkrt->sceneSettings.debugMode == VKRT_DEBUG_MODE_NONE &&
+                                      vkrt->core.adaptivePipeline != VK_NULL_HANDLE;
 }
 
 static VKRT_Result beginRecordCommandContext(RecordCommandContext* context) {
@@ -279,6 +288,8 @@ static VKRT_Result beginRecordCommandContext(RecordCommandContext* context) {
         context->qbase
     );
 
+    recordPendingImageAcquires(context->vkrt, context->commandBuffer);
+
     beginDebugLabel(context->vkrt, context->commandBuffer, "Scene Update", 0.23f, 0.54f, 0.91f);
     recordSceneUpdateCommands(context->vkrt, context->commandBuffer);
     endDebugLabel(context->vkrt, context->commandBuffer);
@@ -297,6 +308,40 @@ static VKRT_Result beginRecordCommandContext(RecordCommandContext* context) {
     return VKRT_SUCCESS;
 }
 
+static void resetAdaptiveSamplingImages(const RecordCommandContext* context) {
+    // Every tile starts active; the status buffer reads as "nothing evaluated yet" so raygen keeps its base rate.
+    VkClearColorValue clearMoment = {.float32 = {0.0f, 1.0f, 0.0f, 0.0f}};
+    transitionImageLayout(
+        context->commandBuffer,
+        context->adaptiveMomentImage,
+        VK_IMAGE_LAYOUT_GENERAL,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+    );
+    vkCmdClearColorImage(
+        context->commandBuffer,
+        context->adaptiveMomentImage,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        &clearMoment,
+        1,
+        &context->clearRange
+    );
+    transitionImageLayout(
+        context->commandBuffer,
+        context->adaptiveMomentImage,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_IMAGE_LAYOUT_GENERAL
+    );
+
+    vkCmdFillBuffer(context->commandBuffer, context->vkrt->core.adaptiveStatus.buffer, 0, sizeof(AdaptiveStatus), 0u);
+    recordMemoryAccessBarrier(
+        context->commandBuffer,
+        VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        VK_ACCESS_2_SHADER_READ_BIT,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_2_RAY_TRACING_SHADER_BIT_KHR
+    );
+}
+
 static void resetAccumulationImages(const RecordCommandContext* context) {
     if (!context || !context->vkrt) return;
 
@@ -443,6 +488,8 @@ static void resetAccumulationImages(const RecordCommandContext* context) {
         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
         VK_IMAGE_LAYOUT_GENERAL
     );
+
+    resetAdaptiveSamplingImages(context);
 }
 
 static void recordMainTracePass(const RecordCommandContext* context) {
@@ -574,6 +621,54 @@ static void recordSelectionPostPass(const RecordCommandContext* context) {
     endDebugLabel(context->vkrt, context->commandBuffer);
 }
 
+static void recordAdaptiveSamplingPass(const RecordCommandContext* context) {
+    if (!context || !context->shouldAdaptiveSampling) return;
+
+    // Raygen already consumed this frame's status, so it can be cleared before the tiles are re-evaluated.
+    recordMemoryAccessBarrier(
+        context->commandBuffer,
+        VK_ACCESS_2_SHADER_WRITE_BIT,
+        VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_RAY_TRACING_SHADER_BIT_KHR,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT
+    );
+    vkCmdFillBuffer(context->commandBuffer, context->vkrt->core.adaptiveStatus.buffer, 0, sizeof(AdaptiveStatus), 0u);
+    recordMemoryAccessBarrier(
+        context->commandBuffer,
+        VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT
+    );
+
+    beginDebugLabel(context->vkrt, context->commandBuffer, "Adaptive Sampling", 0.95f, 0.80f, 0.20f);
+    vkCmdBindPipeline(context->commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, context->vkrt->core.adaptivePipeline);
+    vkCmdBindDescriptorSets(
+        context->commandBuffer,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        context->vkrt->core.pipelineLayout,
+        0,
+        1,
+        &context->vkrt->core.descriptorSets[context->vkrt->runtime.currentFrame],
+        0,
+        NULL
+    );
+
+    uint32_t groupCountX = (context->renderExtent.width + VKRT_ADAPTIVE_TILE_SIZE - 1u) / VKRT_ADAPTIVE_TILE_SIZE;
+    uint32_t groupCountY = (context->renderExtent.height + VKRT_ADAPTIVE_TILE_SIZE - 1u) / VKRT_ADAPTIVE_TILE_SIZE;
+    vkCmdDispatch(context->commandBuffer, groupCountX, groupCountY, 1);
+
+    recordMemoryAccessBarrier(
+        context->commandBuffer,
+        VK_ACCESS_2_SHADER_WRITE_BIT,
+        VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_TRANSFER_READ_BIT,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_2_RAY_TRACING_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_TRANSFER_BIT
+    );
+    recordAdaptiveSamplingReadback(context->vkrt, context->commandBuffer);
+    endDebugLabel(context->vkrt, context->commandBuffer);
+}
+
 static void recordTracingPasses(RecordCommandContext* context) {
     if (!context || !context->descriptorReady) return;
 
@@ -585,6 +680,7 @@ static void recordTracingPasses(RecordCommandContext* context) {
     }
 
     recordMainTracePass(context);
+    recordAdaptiveSamplingPass(context);
     recordSelectionTracePass(context);
     recordSelectionPostPass(context);
 
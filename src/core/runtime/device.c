@@ -51,6 +51,7 @@ typedef struct DeviceFeatureChain {
     VkPhysicalDeviceRayTracingInvocationReorderFeaturesEXT deviceReorderFeatures;
     VkPhysicalDeviceDescriptorIndexingFeatures deviceDescriptorIndexingFeatures;
     VkPhysicalDeviceSynchronization2Features deviceSynchronization2Features;
+    VkPhysicalDeviceTimelineSemaphoreFeatures deviceTimelineSemaphoreFeatures;
     VkPhysicalDeviceDynamicRenderingFeatures deviceDynamicRenderingFeatures;
 } DeviceFeatureChain;
 
@@ -179,7 +180,7 @@ static int buildDeviceQueueCreateInfos(
     VkDeviceQueueCreateInfo** outCreateInfos,
     uint32_t* outCreateInfoCount
 ) {
-    uint32_t uniqueQueueFamilies[2] = {0u, 0u};
+    uint32_t uniqueQueueFamilies[3] = {0u, 0u, 0u};
     uint32_t queueCreateInfoCount = 0u;
     VkDeviceQueueCreateInfo* queueCreateInfos = NULL;
 
@@ -187,10 +188,11 @@ static int buildDeviceQueueCreateInfos(
 
     uniqueQueueFamilies[0] = (uint32_t)indices.graphics;
     uniqueQueueFamilies[1] = (uint32_t)indices.present;
-    queueCreateInfos = (VkDeviceQueueCreateInfo*)malloc(2u * sizeof(VkDeviceQueueCreateInfo));
+    uniqueQueueFamilies[2] = (uint32_t)indices.transfer;
+    queueCreateInfos = (VkDeviceQueueCreateInfo*)malloc(3u * sizeof(VkDeviceQueueCreateInfo));
     if (!queueCreateInfos) return 0;
 
-    for (uint32_t i = 0; i < 2u; i++) {
+    for (uint32_t i = 0; i < 3u; i++) {
         VkBool32 duplicate = VK_FALSE;
         for (uint32_t j = 0; j < queueCreateInfoCount; j++) {
             if (uniqueQueueFamilies[i] == queueCreateInfos[j].queueFamilyIndex) {
@@ -247,6 +249,11 @@ static void initDeviceFeatureChain(DeviceFeatureChain* chain) {
                 .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES,
                 .synchronization2 = VK_TRUE,
             },
+        .deviceTimelineSemaphoreFeatures =
+            {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES,
+                .timelineSemaphore = VK_TRUE,
+            },
         .deviceDynamicRenderingFeatures = {
             .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES,
             .dynamicRendering = VK_TRUE,
@@ -258,7 +265,8 @@ static void initDeviceFeatureChain(DeviceFeatureChain* chain) {
     chain->deviceReorderFeatures.pNext = &chain->deviceAccelerationStructureFeatures;
     chain->deviceDescriptorIndexingFeatures.pNext = &chain->deviceRayTracingPipelineFeatures;
     chain->deviceSynchronization2Features.pNext = &chain->deviceDescriptorIndexingFeatures;
-    chain->deviceDynamicRenderingFeatures.pNext = &chain->deviceSynchronization2Features;
+    chain->deviceTimelineSemaphoreFeatures.pNext = &chain->deviceSynchronization2Features;
+    chain->deviceDynamicRenderingFeatures.pNext = &chain->deviceTimelineSemaphoreFeatures;
 }
 
 static void querySupportedReorderFeatures(
@@ -468,7 +476,9 @@ static void storeSelectedPhysicalDeviceInfo(VKRT* vkrt, const VkPhysicalDevice*
     LOG_INFO("Selected device [%u]: %s", (uint32_t)bestDevice, deviceProperties.deviceName);
     (void)snprintf(vkrt->core.deviceName, sizeof(vkrt->core.deviceName), "%s", deviceProperties.deviceName);
     vkrt->core.vendorID = deviceProperties.vendorID;
+    vkrt->core.deviceID = deviceProperties.deviceID;
     vkrt->core.driverVersion = deviceProperties.driverVersion;
+    memcpy(vkrt->core.pipelineCacheUUID, deviceProperties.pipelineCacheUUID, VK_UUID_SIZE);
 }
 
 static int32_t scoreDeviceSuitability(VKRT* vkrt, DeviceExtensionSupport* outExtensionSupport) {
@@ -739,7 +749,17 @@ VKRT_Result createLogicalDevice(VKRT* vkrt) {
 
     vkrt->core.deviceExtensionSupport = extensionSupport;
 
+    VkPhysicalDeviceFeatures supportedFeatures = {0};
+    vkGetPhysicalDeviceFeatures(vkrt->core.physicalDevice, &supportedFeatures);
+    VkPhysicalDeviceProperties deviceProperties = {0};
+    vkGetPhysicalDeviceProperties(vkrt->core.physicalDevice, &deviceProperties);
+
     VkPhysicalDeviceFeatures deviceFeatures = {0};
+    deviceFeatures.samplerAnisotropy = supportedFeatures.samplerAnisotropy;
+    deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+    vkrt->core.textureCompressionBC = supportedFeatures.textureCompressionBC;
+    vkrt->core.maxSamplerAnisotropy =
+        supportedFeatures.samplerAnisotropy ? deviceProperties.limits.maxSamplerAnisotropy : 1.0f;
 
     VkDeviceCreateInfo createInfo = {0};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -767,6 +787,10 @@ VKRT_Result createLogicalDevice(VKRT* vkrt) {
 
     vkGetDeviceQueue(vkrt->core.device, indices.graphics, 0, &vkrt->core.graphicsQueue);
     vkGetDeviceQueue(vkrt->core.device, indices.present, 0, &vkrt->core.presentQueue);
+    vkGetDeviceQueue(vkrt->core.device, indices.transfer, 0, &vkrt->core.transferQueue);
+    if (indices.transfer != indices.graphics) {
+        LOG_INFO("Using dedicated transfer queue family %d for uploads", indices.transfer);
+    }
 
     free((void*)queueCreateInfos);
     return VKRT_SUCCESS;
@@ -790,10 +814,26 @@ VKRT_Result createQueryPool(VKRT* vkrt) {
     return VKRT_SUCCESS;
 }
 
+static int32_t findTransferQueueFamily(
+    const VkQueueFamilyProperties* queueFamilies,
+    uint32_t queueFamilyCount,
+    int32_t graphicsFamily
+) {
+    int32_t asyncFamily = -1;
+    for (uint32_t i = 0; i < queueFamilyCount; i++) {
+        VkQueueFlags flags = queueFamilies[i].queueFlags;
+        if (!(flags & VK_QUEUE_TRANSFER_BIT) || (flags & VK_QUEUE_GRAPHICS_BIT)) continue;
+        if (!(flags & VK_QUEUE_COMPUTE_BIT)) return (int32_t)i;
+        if (asyncFamily < 0) asyncFamily = (int32_t)i;
+    }
+    return asyncFamily >= 0 ? asyncFamily : graphicsFamily;
+}
+
 QueueFamily findQueueFamilies(VKRT* vkrt) {
     QueueFamily indices;
     indices.graphics = -1;
     indices.present = -1;
+    indices.transfer = -1;
 
     uint32_t queueFamilyCount = 0;
     vkGetPhysicalDeviceQueueFamilyProperties(vkrt->core.physicalDevice, &queueFamilyCount, NULL);
@@ -827,6 +867,10 @@ QueueFamily findQueueFamilies(VKRT* vkrt) {
         }
     }
 
+    if (isQueueFamilyComplete(indices)) {
+        indices.transfer = findTransferQueueFamily(queueFamilies, queueFamilyCount, indices.graphics);
+    }
+
     free((void*)queueFamilies);
 
     return indices;
@@ -887,25 +931,3 @@ VkBool32 extensionsSupported(VKRT* vkrt, VkPhysicalDevice device, DeviceExtensio
     if (outSupport) *outSupport = support;
     return support.missingRequiredMask == 0;
 }
-
-VKRT_Result findMemoryType(
-    VKRT* vkrt,
-    uint32_t typeFilter,
-    VkMemoryPropertyFlags properties,
-    uint32_t* outMemoryTypeIndex
-) {
-    if (!vkrt || !outMemoryTypeIndex) return VKRT_ERROR_INVALID_ARGUMENT;
-
-    VkPhysicalDeviceMemoryProperties memProperties;
-    vkGetPhysicalDeviceMemoryProperties(vkrt->core.physicalDevice, &memProperties);
-
-    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-        if ((typeFilter & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
-            *outMemoryTypeIndex = i;
-            return VKRT_SUCCESS;
-        }
-    }
-
-    LOG_ERROR("Failed to find suitable memory type");
-    return VKRT_ERROR_OPERATION_FAILED;
-}
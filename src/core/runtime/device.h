@@ -18,9 +18,3 @@ VKRT_Result createQueryPool(VKRT* vkrt);
 VkBool32 isQueueFamilyComplete(QueueFamily indices);
 QueueFamily findQueueFamilies(VKRT* vkrt);
 VkBool32 extensionsSupported(VKRT* vkrt, VkPhysicalDevice device, DeviceExtensionSupport* outSupport);
-VKRT_Result findMemoryType(
-    VKRT* vkrt,
-    uint32_t typeFilter,
-    VkMemoryPropertyFlags properties,
-    uint32_t* outMemoryTypeIndex
-);
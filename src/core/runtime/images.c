@@ -1,11 +1,12 @@
 #include "images.h"
 
-#include "buffer.h"
+#include "allocator.h"
 #include "command/pool.h"
 #include "command/record.h"
+#include "constants.h"
 #include "debug.h"
-#include "device.h"
 #include "scene.h"
+#include "staging.h"
 #include "vkrt_types.h"
 #include "vulkan/vulkan_core.h"
 
@@ -16,13 +17,14 @@ static VKRT_Result createImageWithMemory(
     VKRT* vkrt,
     VkExtent2D extent,
     VkFormat format,
+    uint32_t mipLevels,
     VkImageUsageFlags usage,
     VkImage* outImage,
     VkImageView* outView,
-    VkDeviceMemory* outMemory
+    MemoryAllocation* outMemory
 ) {
     if (!vkrt || !outImage || !outView || !outMemory) return VKRT_ERROR_INVALID_ARGUMENT;
-    if (extent.width == 0 || extent.height == 0) return VKRT_ERROR_INVALID_ARGUMENT;
+    if (extent.width == 0 || extent.height == 0 || mipLevels == 0) return VKRT_ERROR_INVALID_ARGUMENT;
 
     *outImage = VK_NULL_HANDLE;
     *outView = VK_NULL_HANDLE;
@@ -32,7 +34,7 @@ static VKRT_Result createImageWithMemory(
         .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
         .imageType = VK_IMAGE_TYPE_2D,
         .extent = (VkExtent3D){extent.width, extent.height, 1u},
-        .mipLevels = 1,
+        .mipLevels = mipLevels,
         .arrayLayers = 1,
         .format = format,
         .tiling = VK_IMAGE_TILING_OPTIMAL,
@@ -46,28 +48,7 @@ static VKRT_Result createImageWithMemory(
         return VKRT_ERROR_OPERATION_FAILED;
     }
 
-    VkMemoryRequirements memoryRequirements = {0};
-    vkGetImageMemoryRequirements(vkrt->core.device, *outImage, &memoryRequirements);
-
-    VkMemoryAllocateInfo memoryAllocateInfo = {0};
-    memoryAllocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    memoryAllocateInfo.allocationSize = memoryRequirements.size;
-    if (findMemoryType(
-            vkrt,
-            memoryRequirements.memoryTypeBits,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            &memoryAllocateInfo.memoryTypeIndex
-        ) != VKRT_SUCCESS) {
-        vkrtDestroyImageResources(vkrt, outImage, outView, outMemory);
-        return VKRT_ERROR_OPERATION_FAILED;
-    }
-
-    if (vkAllocateMemory(vkrt->core.device, &memoryAllocateInfo, NULL, outMemory) != VK_SUCCESS) {
-        vkrtDestroyImageResources(vkrt, outImage, outView, outMemory);
-        return VKRT_ERROR_OPERATION_FAILED;
-    }
-
-    if (vkBindImageMemory(vkrt->core.device, *outImage, *outMemory, 0) != VK_SUCCESS) {
+    if (vkrtAllocateImageMemory(vkrt, *outImage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, outMemory) != VKRT_SUCCESS) {
         vkrtDestroyImageResources(vkrt, outImage, outView, outMemory);
         return VKRT_ERROR_OPERATION_FAILED;
     }
@@ -77,9 +58,18 @@ static VKRT_Result createImageWithMemory(
     imageViewCreateInfo.image = *outImage;
     imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
     imageViewCreateInfo.format = format;
+    if (format == VK_FORMAT_BC4_UNORM_BLOCK) {
+        // Single-channel block textures read as grayscale instead of red.
+        imageViewCreateInfo.components = (VkComponentMapping){
+            VK_COMPONENT_SWIZZLE_R,
+            VK_COMPONENT_SWIZZLE_R,
+            VK_COMPONENT_SWIZZLE_R,
+            VK_COMPONENT_SWIZZLE_ONE,
+        };
+    }
     imageViewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     imageViewCreateInfo.subresourceRange.baseMipLevel = 0;
-    imageViewCreateInfo.subresourceRange.levelCount = 1;
+    imageViewCreateInfo.subresourceRange.levelCount = mipLevels;
     imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
     imageViewCreateInfo.subresourceRange.layerCount = 1;
     if (vkCreateImageView(vkrt->core.device, &imageViewCreateInfo, NULL, outView) != VK_SUCCESS) {
@@ -90,7 +80,7 @@ static VKRT_Result createImageWithMemory(
     return VKRT_SUCCESS;
 }
 
-void vkrtDestroyImageResources(VKRT* vkrt, VkImage* image, VkImageView* view, VkDeviceMemory* memory) {
+void vkrtDestroyImageResources(VKRT* vkrt, VkImage* image, VkImageView* view, MemoryAllocation* memory) {
     if (!vkrt || vkrt->core.device == VK_NULL_HANDLE) return;
 
     if (view && *view != VK_NULL_HANDLE) {
@@ -98,12 +88,12 @@ void vkrtDestroyImageResources(VKRT* vkrt, VkImage* image, VkImageView* view, Vk
         *view = VK_NULL_HANDLE;
     }
     if (image && *image != VK_NULL_HANDLE) {
+        dropPendingImageAcquire(vkrt, *image);
         vkDestroyImage(vkrt->core.device, *image, NULL);
         *image = VK_NULL_HANDLE;
     }
-    if (memory && *memory != VK_NULL_HANDLE) {
-        vkFreeMemory(vkrt->core.device, *memory, NULL);
-        *memory = VK_NULL_HANDLE;
+    if (memory) {
+        vkrtFreeMemory(vkrt, memory);
     }
 }
 
@@ -114,41 +104,9 @@ VKRT_Result vkrtCreateDeviceImage(
     VkImageUsageFlags usage,
     VkImage* outImage,
     VkImageView* outView,
-    VkDeviceMemory* outMemory
+    MemoryAllocation* outMemory
 ) {
-    return createImageWithMemory(vkrt, extent, format, usage, outImage, outView, outMemory);
-}
-
-static VKRT_Result createTextureUploadStagingBuffer(
-    VKRT* vkrt,
-    const TextureImageUpload* upload,
-    VkBuffer* outBuffer,
-    VkDeviceMemory* outMemory
-) {
-    VKRT_Result result = createBuffer(
-        vkrt,
-        upload->byteSize,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        outBuffer,
-        outMemory
-    );
-    if (result != VKRT_SUCCESS) {
-        return result;
-    }
-
-    void* mapped = NULL;
-    if (vkMapMemory(vkrt->core.device, *outMemory, 0, upload->byteSize, 0, &mapped) != VK_SUCCESS || !mapped) {
-        vkDestroyBuffer(vkrt->core.device, *outBuffer, NULL);
-        vkFreeMemory(vkrt->core.device, *outMemory, NULL);
-        *outBuffer = VK_NULL_HANDLE;
-        *outMemory = VK_NULL_HANDLE;
-        return VKRT_ERROR_OPERATION_FAILED;
-    }
-
-    memcpy(mapped, upload->pixels, (size_t)upload->byteSize);
-    vkUnmapMemory(vkrt->core.device, *outMemory);
-    return VKRT_SUCCESS;
+    return createImageWithMemory(vkrt, extent, format, 1u, usage, outImage, outView, outMemory);
 }
 
 VKRT_Result vkrtCreateSampledTextureImageFromData(
@@ -156,17 +114,23 @@ VKRT_Result vkrtCreateSampledTextureImageFromData(
     const TextureImageUpload* upload,
     VkImage* outImage,
     VkImageView* outView,
-    VkDeviceMemory* outMemory
+    MemoryAllocation* outMemory
 ) {
     if (!vkrt || !upload || !upload->pixels || upload->width == 0u || upload->height == 0u || !outImage || !outView ||
         !outMemory || upload->byteSize == 0u) {
         return VKRT_ERROR_INVALID_ARGUMENT;
     }
 
+    uint32_t mipLevelCount = upload->mipLevelCount > 0u ? upload->mipLevelCount : 1u;
+    if (mipLevelCount > VKRT_TEXTURE_MAX_MIP_LEVELS || (mipLevelCount > 1u && !upload->mipLevelOffsets)) {
+        return VKRT_ERROR_INVALID_ARGUMENT;
+    }
+
     VKRT_Result result = createImageWithMemory(
         vkrt,
         (VkExtent2D){upload->width, upload->height},
         upload->format,
+        mipLevelCount,
         VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
         outImage,
         outView,
@@ -176,60 +140,71 @@ VKRT_Result vkrtCreateSampledTextureImageFromData(
         return result;
     }
 
-    VkBuffer stagingBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
-    result = createTextureUploadStagingBuffer(vkrt, upload, &stagingBuffer, &stagingMemory);
+    StagingAllocation staging = {0};
+    result = vkrtAllocateStaging(vkrt, upload->byteSize, &staging);
     if (result != VKRT_SUCCESS) {
         vkrtDestroyImageResources(vkrt, outImage, outView, outMemory);
         return result;
     }
+    memcpy(staging.mapped, upload->pixels, (size_t)upload->byteSize);
 
     VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
-    result = beginSingleTimeCommands(vkrt, &commandBuffer);
+    result = beginTransferCommands(vkrt, &commandBuffer);
     if (result != VKRT_SUCCESS) {
-        vkDestroyBuffer(vkrt->core.device, stagingBuffer, NULL);
-        vkFreeMemory(vkrt->core.device, stagingMemory, NULL);
+        vkrtReleaseStaging(vkrt, &staging);
         vkrtDestroyImageResources(vkrt, outImage, outView, outMemory);
         return result;
     }
 
     transitionImageLayout(commandBuffer, *outImage, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
-    VkBufferImageCopy copyRegion = {0};
-    copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    copyRegion.imageSubresource.mipLevel = 0;
-    copyRegion.imageSubresource.baseArrayLayer = 0;
-    copyRegion.imageSubresource.layerCount = 1;
-    copyRegion.imageExtent = (VkExtent3D){upload->width, upload->height, 1u};
+    VkBufferImageCopy copyRegions[VKRT_TEXTURE_MAX_MIP_LEVELS];
+    for (uint32_t level = 0; level < mipLevelCount; level++) {
+        uint32_t levelWidth = (upload->width >> level) > 0u ? upload->width >> level : 1u;
+        uint32_t levelHeight = (upload->height >> level) > 0u ? upload->height >> level : 1u;
+        VkDeviceSize levelOffset = upload->mipLevelOffsets ? upload->mipLevelOffsets[level] : 0u;
+        copyRegions[level] = (VkBufferImageCopy){
+            .bufferOffset = staging.offset + levelOffset,
+            .imageSubresource =
+                {
+                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .mipLevel = level,
+                    .baseArrayLayer = 0,
+                    .layerCount = 1,
+                },
+            .imageExtent = (VkExtent3D){levelWidth, levelHeight, 1u},
+        };
+    }
 
     vkCmdCopyBufferToImage(
         commandBuffer,
-        stagingBuffer,
-        *outImage,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        1,
-        &copyRegion
-    );
-    transitionImageLayout(
-        commandBuffer,
+        staging.buffer,
         *outImage,
         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+        mipLevelCount,
+        copyRegions
     );
 
-    result = endSingleTimeCommands(vkrt, commandBuffer);
-    vkDestroyBuffer(vkrt->core.device, stagingBuffer, NULL);
-    vkFreeMemory(vkrt->core.device, stagingMemory, NULL);
+    uint64_t transferValue = 0u;
+    result = submitTransferImageUpload(vkrt, commandBuffer, *outImage, &transferValue);
     if (result != VKRT_SUCCESS) {
+        vkrtReleaseStaging(vkrt, &staging);
         vkrtDestroyImageResources(vkrt, outImage, outView, outMemory);
+        return result;
     }
-    return result;
+
+    vkrtRetainStagingForTransfer(vkrt, &staging, transferValue);
+    return VKRT_SUCCESS;
 }
 
+enum {
+    K_GPU_IMAGE_SLOT_COUNT = 15,
+};
+
 typedef struct GPUImageSlot {
     VkImage* image;
     VkImageView* view;
-    VkDeviceMemory* memory;
+    MemoryAllocation* memory;
     VkFormat format;
     VkImageUsageFlags usage;
 } GPUImageSlot;
@@ -251,14 +226,26 @@ static void clearGPUImageBindings(VKRT* vkrt) {
         vkrt->core.normalImages[i] = VK_NULL_HANDLE;
         vkrt->core.normalImageViews[i] = VK_NULL_HANDLE;
         vkrt->core.normalImageMemories[i] = VK_NULL_HANDLE;
+        vkrt->core.reservoirSampleImages[i] = VK_NULL_HANDLE;
+        vkrt->core.reservoirSampleImageViews[i] = VK_NULL_HANDLE;
+        vkrt->core.reservoirSampleImageMemories[i] = VK_NULL_HANDLE;
+        vkrt->core.reservoirDataImages[i] = VK_NULL_HANDLE;
+        vkrt->core.reservoirDataImageViews[i] = VK_NULL_HANDLE;
+        vkrt->core.reservoirDataImageMemories[i] = VK_NULL_HANDLE;
+        vkrt->core.reservoirSurfaceImages[i] = VK_NULL_HANDLE;
+        vkrt->core.reservoirSurfaceImageViews[i] = VK_NULL_HANDLE;
+        vkrt->core.reservoirSurfaceImageMemories[i] = VK_NULL_HANDLE;
     }
 
     vkrt->core.selectionMaskImage = VK_NULL_HANDLE;
     vkrt->core.selectionMaskImageView = VK_NULL_HANDLE;
     vkrt->core.selectionMaskImageMemory = VK_NULL_HANDLE;
+    vkrt->core.adaptiveMomentImage = VK_NULL_HANDLE;
+    vkrt->core.adaptiveMomentImageView = VK_NULL_HANDLE;
+    vkrt->core.adaptiveMomentImageMemory = VK_NULL_HANDLE;
 }
 
-static uint32_t queryGPUImageSlots(GPUImageState* state, GPUImageSlot slots[8]) {
+static uint32_t queryGPUImageSlots(GPUImageState* state, GPUImageSlot slots[K_GPU_IMAGE_SLOT_COUNT]) {
     if (!state || !slots) return 0;
 
     slots[0] = (GPUImageSlot){
@@ -317,7 +304,40 @@ static uint32_t queryGPUImageSlots(GPUImageState* state, GPUImageSlot slots[8])
         .format = VK_FORMAT_R32_UINT,
         .usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_STORAGE_BIT,
     };
-    return 8;
+    // Red holds the running mean of squared sample luminance, green the converged-tile mask.
+    slots[8] = (GPUImageSlot){
+        .image = &state->adaptiveMomentImage,
+        .view = &state->adaptiveMomentImageView,
+        .memory = &state->adaptiveMomentImageMemory,
+        .format = VK_FORMAT_R32G32_SFLOAT,
+        .usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_STORAGE_BIT,
+    };
+    // Direct-lighting reservoirs ping-pong with the accumulation images: the sampled light point and weight, the
+    // light index with packed normals and sample count, and the receiver position used to validate reuse.
+    for (uint32_t i = 0; i < 2; i++) {
+        slots[9 + i * 3] = (GPUImageSlot){
+            .image = &state->reservoirSampleImages[i],
+            .view = &state->reservoirSampleImageViews[i],
+            .memory = &state->reservoirSampleImageMemories[i],
+            .format = VK_FORMAT_R32G32B32A32_SFLOAT,
+            .usage = VK_IMAGE_USAGE_STORAGE_BIT,
+        };
+        slots[10 + i * 3] = (GPUImageSlot){
+            .image = &state->reservoirDataImages[i],
+            .view = &state->reservoirDataImageViews[i],
+            .memory = &state->reservoirDataImageMemories[i],
+            .format = VK_FORMAT_R32G32B32A32_UINT,
+            .usage = VK_IMAGE_USAGE_STORAGE_BIT,
+        };
+        slots[11 + i * 3] = (GPUImageSlot){
+            .image = &state->reservoirSurfaceImages[i],
+            .view = &state->reservoirSurfaceImageViews[i],
+            .memory = &state->reservoirSurfaceImageMemories[i],
+            .format = VK_FORMAT_R32G32B32A32_SFLOAT,
+            .usage = VK_IMAGE_USAGE_STORAGE_BIT,
+        };
+    }
+    return K_GPU_IMAGE_SLOT_COUNT;
 }
 
 void captureGPUImageState(const VKRT* vkrt, GPUImageState* outState) {
@@ -339,10 +359,22 @@ void captureGPUImageState(const VKRT* vkrt, GPUImageState* outState) {
         outState->normalImages[i] = vkrt->core.normalImages[i];
         outState->normalImageViews[i] = vkrt->core.normalImageViews[i];
         outState->normalImageMemories[i] = vkrt->core.normalImageMemories[i];
+        outState->reservoirSampleImages[i] = vkrt->core.reservoirSampleImages[i];
+        outState->reservoirSampleImageViews[i] = vkrt->core.reservoirSampleImageViews[i];
+        outState->reservoirSampleImageMemories[i] = vkrt->core.reservoirSampleImageMemories[i];
+        outState->reservoirDataImages[i] = vkrt->core.reservoirDataImages[i];
+        outState->reservoirDataImageViews[i] = vkrt->core.reservoirDataImageViews[i];
+        outState->reservoirDataImageMemories[i] = vkrt->core.reservoirDataImageMemories[i];
+        outState->reservoirSurfaceImages[i] = vkrt->core.reservoirSurfaceImages[i];
+        outState->reservoirSurfaceImageViews[i] = vkrt->core.reservoirSurfaceImageViews[i];
+        outState->reservoirSurfaceImageMemories[i] = vkrt->core.reservoirSurfaceImageMemories[i];
     }
     outState->selectionMaskImage = vkrt->core.selectionMaskImage;
     outState->selectionMaskImageView = vkrt->core.selectionMaskImageView;
     outState->selectionMaskImageMemory = vkrt->core.selectionMaskImageMemory;
+    outState->adaptiveMomentImage = vkrt->core.adaptiveMomentImage;
+    outState->adaptiveMomentImageView = vkrt->core.adaptiveMomentImageView;
+    outState->adaptiveMomentImageMemory = vkrt->core.adaptiveMomentImageMemory;
 }
 
 void applyGPUImageState(VKRT* vkrt, const GPUImageState* state) {
@@ -364,23 +396,36 @@ void applyGPUImageState(VKRT* vkrt, const GPUImageState* state) {
         vkrt->core.normalImages[i] = state->normalImages[i];
         vkrt->core.normalImageViews[i] = state->normalImageViews[i];
         vkrt->core.normalImageMemories[i] = state->normalImageMemories[i];
+        vkrt->core.reservoirSampleImages[i] = state->reservoirSampleImages[i];
+        vkrt->core.reservoirSampleImageViews[i] = state->reservoirSampleImageViews[i];
+        vkrt->core.reservoirSampleImageMemories[i] = state->reservoirSampleImageMemories[i];
+        vkrt->core.reservoirDataImages[i] = state->reservoirDataImages[i];
+        vkrt->core.reservoirDataImageViews[i] = state->reservoirDataImageViews[i];
+        vkrt->core.reservoirDataImageMemories[i] = state->reservoirDataImageMemories[i];
+        vkrt->core.reservoirSurfaceImages[i] = state->reservoirSurfaceImages[i];
+        vkrt->core.reservoirSurfaceImageViews[i] = state->reservoirSurfaceImageViews[i];
+        vkrt->core.reservoirSurfaceImageMemories[i] = state->reservoirSurfaceImageMemories[i];
     }
     vkrt->core.selectionMaskImage = state->selectionMaskImage;
     vkrt->core.selectionMaskImageView = state->selectionMaskImageView;
     vkrt->core.selectionMaskImageMemory = state->selectionMaskImageMemory;
+    vkrt->core.adaptiveMomentImage = state->adaptiveMomentImage;
+    vkrt->core.adaptiveMomentImageView = state->adaptiveMomentImageView;
+    vkrt->core.adaptiveMomentImageMemory = state->adaptiveMomentImageMemory;
 
     vkrt->core.accumulationReadIndex = 0;
     vkrt->core.accumulationWriteIndex = 1;
     vkrt->renderStatus.accumulationFrame = 0;
     vkrt->renderStatus.totalSamples = 0;
     vkrt->core.accumulationNeedsReset = VK_TRUE;
+    invalidateReservoirHistory(vkrt);
     markSelectionMaskDirty(vkrt);
 }
 
 void destroyGPUImageState(VKRT* vkrt, GPUImageState* state) {
     if (!vkrt || !state || vkrt->core.device == VK_NULL_HANDLE) return;
 
-    GPUImageSlot slots[8] = {0};
+    GPUImageSlot slots[K_GPU_IMAGE_SLOT_COUNT] = {0};
     uint32_t slotCount = queryGPUImageSlots(state, slots);
 
     for (uint32_t i = 0; i < slotCount; i++) {
@@ -399,7 +444,7 @@ VKRT_Result createGPUImageState(VKRT* vkrt, VkExtent2D extent, GPUImageState* ou
         return VKRT_ERROR_INVALID_ARGUMENT;
     }
 
-    GPUImageSlot slots[8] = {0};
+    GPUImageSlot slots[K_GPU_IMAGE_SLOT_COUNT] = {0};
     uint32_t slotCount = queryGPUImageSlots(outState, slots);
 
     for (uint32_t i = 0; i < slotCount; i++) {
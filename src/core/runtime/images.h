@@ -5,19 +5,31 @@
 typedef struct GPUImageState {
     VkImage outputImage;
     VkImageView outputImageView;
-    VkDeviceMemory outputImageMemory;
+    MemoryAllocation outputImageMemory;
     VkImage accumulationImages[2];
     VkImageView accumulationImageViews[2];
-    VkDeviceMemory accumulationImageMemories[2];
+    MemoryAllocation accumulationImageMemories[2];
     VkImage albedoImages[2];
     VkImageView albedoImageViews[2];
-    VkDeviceMemory albedoImageMemories[2];
+    MemoryAllocation albedoImageMemories[2];
     VkImage normalImages[2];
     VkImageView normalImageViews[2];
-    VkDeviceMemory normalImageMemories[2];
+    MemoryAllocation normalImageMemories[2];
+    VkImage reservoirSampleImages[2];
+    VkImageView reservoirSampleImageViews[2];
+    MemoryAllocation reservoirSampleImageMemories[2];
+    VkImage reservoirDataImages[2];
+    VkImageView reservoirDataImageViews[2];
+    MemoryAllocation reservoirDataImageMemories[2];
+    VkImage reservoirSurfaceImages[2];
+    VkImageView reservoirSurfaceImageViews[2];
+    MemoryAllocation reservoirSurfaceImageMemories[2];
     VkImage selectionMaskImage;
     VkImageView selectionMaskImageView;
-    VkDeviceMemory selectionMaskImageMemory;
+    MemoryAllocation selectionMaskImageMemory;
+    VkImage adaptiveMomentImage;
+    VkImageView adaptiveMomentImageView;
+    MemoryAllocation adaptiveMomentImageMemory;
 } GPUImageState;
 
 typedef struct TextureImageUpload {
@@ -26,9 +38,11 @@ typedef struct TextureImageUpload {
     uint32_t height;
     VkFormat format;
     VkDeviceSize byteSize;
+    uint32_t mipLevelCount;
+    const VkDeviceSize* mipLevelOffsets;
 } TextureImageUpload;
 
-void vkrtDestroyImageResources(VKRT* vkrt, VkImage* image, VkImageView* view, VkDeviceMemory* memory);
+void vkrtDestroyImageResources(VKRT* vkrt, VkImage* image, VkImageView* view, MemoryAllocation* memory);
 VKRT_Result vkrtCreateDeviceImage(
     VKRT* vkrt,
     VkExtent2D extent,
@@ -36,14 +50,14 @@ VKRT_Result vkrtCreateDeviceImage(
     VkImageUsageFlags usage,
     VkImage* outImage,
     VkImageView* outView,
-    VkDeviceMemory* outMemory
+    MemoryAllocation* outMemory
 );
 VKRT_Result vkrtCreateSampledTextureImageFromData(
     VKRT* vkrt,
     const TextureImageUpload* upload,
     VkImage* outImage,
     VkImageView* outView,
-    VkDeviceMemory* outMemory
+    MemoryAllocation* outMemory
 );
 
 VKRT_Result createGPUImages(VKRT* vkrt);
@@ -37,6 +37,10 @@ VKRT_Result loadDeviceProcs(VKRT* vkrt) {
          "vkGetAccelerationStructureDeviceAddressKHR"},
         {(PFN_vkVoidFunction*)&vkrt->core.procs.vkCmdBuildAccelerationStructuresKHR,
          "vkCmdBuildAccelerationStructuresKHR"},
+        {(PFN_vkVoidFunction*)&vkrt->core.procs.vkCmdWriteAccelerationStructuresPropertiesKHR,
+         "vkCmdWriteAccelerationStructuresPropertiesKHR"},
+        {(PFN_vkVoidFunction*)&vkrt->core.procs.vkCmdCopyAccelerationStructureKHR,
+         "vkCmdCopyAccelerationStructureKHR"},
         {(PFN_vkVoidFunction*)&vkrt->core.procs.vkGetBufferDeviceAddressKHR, "vkGetBufferDeviceAddressKHR"},
         {(PFN_vkVoidFunction*)&vkrt->core.procs.vkCmdTraceRaysKHR, "vkCmdTraceRaysKHR"},
         {(PFN_vkVoidFunction*)&vkrt->core.procs.vkGetRayTracingShaderGroupStackSizeKHR,
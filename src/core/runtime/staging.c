@@ -0,0 +1,189 @@
+#include "staging.h"
+
+#include "allocator.h"
+#include "buffer.h"
+#include "debug.h"
+#include "state.h"
+#include "vkrt_internal.h"
+#include "vkrt_types.h"
+#include "vulkan/vulkan_core.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+static const VkDeviceSize kStagingAlignment = 16u;
+static const VkDeviceSize kStagingRingInitialCapacity = 4ull * 1024ull * 1024ull;
+static const VkDeviceSize kStagingRingMaxCapacity = 64ull * 1024ull * 1024ull;
+static const VkDeviceSize kStagingRingMaxAllocation = 16ull * 1024ull * 1024ull;
+static const uint32_t kStagingFallbackInitialCapacity = 4u;
+
+static VkDeviceSize alignStagingSize(VkDeviceSize size) {
+    return (size + kStagingAlignment - 1u) & ~(kStagingAlignment - 1u);
+}
+
+static VkDeviceSize queryStagingRingCapacity(VkDeviceSize requiredBytes) {
+    VkDeviceSize capacity = kStagingRingInitialCapacity;
+    while (capacity < requiredBytes && capacity < kStagingRingMaxCapacity) {
+        capacity *= 2u;
+    }
+    return capacity;
+}
+
+static VKRT_Result createStagingBuffer(VKRT* vkrt, VkDeviceSize size, FrameTransfer* outTransfer, void** outMapped) {
+    VKRT_Result result = createBuffer(
+        vkrt,
+        size,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        &outTransfer->buffer,
+        &outTransfer->memory
+    );
+    if (result != VKRT_SUCCESS) return result;
+
+    *outMapped = vkrtMappedMemory(outTransfer->memory);
+    if (!*outMapped) {
+        destroyTransfer(vkrt, outTransfer);
+        return VKRT_ERROR_OPERATION_FAILED;
+    }
+    return VKRT_SUCCESS;
+}
+
+static void destroyStagingRingBuffer(VKRT* vkrt, StagingRing* ring) {
+    destroyTransfer(vkrt, &ring->transfer);
+    ring->mapped = NULL;
+    ring->head = 0u;
+}
+
+static VKRT_Result allocateStagingFallback(
+    VKRT* vkrt,
+    StagingRing* ring,
+    VkDeviceSize size,
+    StagingAllocation* outAllocation
+) {
+    if (ring->fallbackCount == ring->fallbackCapacity) {
+        uint32_t capacity = ring->fallbackCapacity > 0u ? ring->fallbackCapacity * 2u : kStagingFallbackInitialCapacity;
+        FrameTransfer* resized = (FrameTransfer*)realloc(ring->fallbacks, (size_t)capacity * sizeof(FrameTransfer));
+        if (!resized) return VKRT_ERROR_OUT_OF_MEMORY;
+        ring->fallbacks = resized;
+        ring->fallbackCapacity = capacity;
+    }
+
+    FrameTransfer transfer = {0};
+    void* mapped = NULL;
+    VKRT_Result result = createStagingBuffer(vkrt, size, &transfer, &mapped);
+    if (result != VKRT_SUCCESS) return result;
+
+    ring->fallbacks[ring->fallbackCount++] = transfer;
+    *outAllocation = (StagingAllocation){
+        .buffer = transfer.buffer,
+        .offset = 0u,
+        .size = size,
+        .mapped = mapped,
+        .fallback = VK_TRUE,
+    };
+    return VKRT_SUCCESS;
+}
+
+VKRT_Result vkrtAllocateStaging(VKRT* vkrt, VkDeviceSize size, StagingAllocation* outAllocation) {
+    if (!vkrt || size == 0u || !outAllocation) return VKRT_ERROR_INVALID_ARGUMENT;
+
+    *outAllocation = (StagingAllocation){0};
+    StagingRing* ring = &vkrtCurrentFrameSceneUpdate(vkrt)->staging;
+    VkDeviceSize alignedSize = alignStagingSize(size);
+    if (alignedSize > kStagingRingMaxAllocation) {
+        return allocateStagingFallback(vkrt, ring, size, outAllocation);
+    }
+
+    ring->requestedBytes += alignedSize;
+    if (ring->transfer.buffer == VK_NULL_HANDLE) {
+        VkDeviceSize capacity = queryStagingRingCapacity(ring->capacity > alignedSize ? ring->capacity : alignedSize);
+        void* mapped = NULL;
+        VKRT_Result result = createStagingBuffer(vkrt, capacity, &ring->transfer, &mapped);
+        if (result != VKRT_SUCCESS) return result;
+        ring->mapped = (uint8_t*)mapped;
+        ring->capacity = capacity;
+        ring->head = 0u;
+    }
+
+    if (alignedSize > ring->capacity - ring->head) {
+        return allocateStagingFallback(vkrt, ring, size, outAllocation);
+    }
+
+    *outAllocation = (StagingAllocation){
+        .buffer = ring->transfer.buffer,
+        .offset = ring->head,
+        .size = size,
+        .mapped = ring->mapped + ring->head,
+        .fallback = VK_FALSE,
+    };
+    ring->head += alignedSize;
+    return VKRT_SUCCESS;
+}
+
+void vkrtReleaseStaging(VKRT* vkrt, StagingAllocation* allocation) {
+    if (!vkrt || !allocation || allocation->buffer == VK_NULL_HANDLE) return;
+
+    StagingRing* ring = &vkrtCurrentFrameSceneUpdate(vkrt)->staging;
+    VkDeviceSize alignedSize = alignStagingSize(allocation->size);
+    if (allocation->fallback) {
+        for (uint32_t i = ring->fallbackCount; i > 0u; i--) {
+            if (ring->fallbacks[i - 1u].buffer != allocation->buffer) continue;
+            destroyTransfer(vkrt, &ring->fallbacks[i - 1u]);
+            ring->fallbacks[i - 1u] = ring->fallbacks[ring->fallbackCount - 1u];
+            ring->fallbackCount--;
+            break;
+        }
+    } else if (allocation->offset + alignedSize == ring->head) {
+        ring->head = allocation->offset;
+    }
+
+    if (alignedSize <= kStagingRingMaxAllocation) {
+        ring->requestedBytes = ring->requestedBytes > alignedSize ? ring->requestedBytes - alignedSize : 0u;
+    }
+    *allocation = (StagingAllocation){0};
+}
+
+void vkrtRetainStagingForTransfer(VKRT* vkrt, StagingAllocation* allocation, uint64_t transferValue) {
+    if (!vkrt || !allocation) return;
+
+    StagingRing* ring = &vkrtCurrentFrameSceneUpdate(vkrt)->staging;
+    if (transferValue > ring->transferValue) {
+        ring->transferValue = transferValue;
+    }
+    *allocation = (StagingAllocation){0};
+}
+
+void vkrtResetStagingRing(VKRT* vkrt, uint32_t frameIndex) {
+    if (!vkrt || frameIndex >= VKRT_MAX_FRAMES_IN_FLIGHT) return;
+
+    StagingRing* ring = &vkrt->runtime.frameSceneUpdates[frameIndex].staging;
+    if (ring->transferValue != 0u) {
+        if (vkrtWaitForTransferValue(vkrt, ring->transferValue) != VKRT_SUCCESS) {
+            LOG_ERROR("Failed waiting for transfer uploads from staging ring %u", frameIndex);
+        }
+        ring->transferValue = 0u;
+    }
+
+    for (uint32_t i = 0; i < ring->fallbackCount; i++) {
+        destroyTransfer(vkrt, &ring->fallbacks[i]);
+    }
+    ring->fallbackCount = 0u;
+
+    if (ring->requestedBytes > ring->capacity && ring->capacity < kStagingRingMaxCapacity) {
+        LOG_TRACE("Growing staging ring %u to fit %llu bytes", frameIndex, (unsigned long long)ring->requestedBytes);
+        destroyStagingRingBuffer(vkrt, ring);
+        ring->capacity = queryStagingRingCapacity(ring->requestedBytes);
+    }
+    ring->head = 0u;
+    ring->requestedBytes = 0u;
+}
+
+void vkrtDestroyStagingRing(VKRT* vkrt, uint32_t frameIndex) {
+    if (!vkrt || frameIndex >= VKRT_MAX_FRAMES_IN_FLIGHT) return;
+
+    StagingRing* ring = &vkrt->runtime.frameSceneUpdates[frameIndex].staging;
+    vkrtResetStagingRing(vkrt, frameIndex);
+    destroyStagingRingBuffer(vkrt, ring);
+    free(ring->fallbacks);
+    *ring = (StagingRing){0};
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "vkrt_internal.h"
+
+#include <stdint.h>
+
+typedef struct StagingAllocation {
+    VkBuffer buffer;
+    VkDeviceSize offset;
+    VkDeviceSize size;
+    void* mapped;
+    VkBool32 fallback;
+} StagingAllocation;
+
+VKRT_Result vkrtAllocateStaging(VKRT* vkrt, VkDeviceSize size, StagingAllocation* outAllocation);
+void vkrtReleaseStaging(VKRT* vkrt, StagingAllocation* allocation);
+void vkrtRetainStagingForTransfer(VKRT* vkrt, StagingAllocation* allocation, uint64_t transferValue);
+void vkrtResetStagingRing(VKRT* vkrt, uint32_t frameIndex);
+void vkrtDestroyStagingRing(VKRT* vkrt, uint32_t frameIndex);
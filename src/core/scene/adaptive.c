@@ -0,0 +1,122 @@
+#include "allocator.h"
+#include "buffer.h"
+#include "config.h"
+#include "constants.h"
+#include "scene.h"
+#include "types.h"
+#include "vkrt_internal.h"
+#include "vkrt_types.h"
+#include "vulkan/vulkan_core.h"
+
+#include <stdint.h>
+#include <string.h>
+
+static void clearAdaptiveSamplingReadback(VKRT_AdaptiveSamplingReadback* readback) {
+    if (!readback) return;
+    memset(readback, 0, sizeof(*readback));
+}
+
+VKRT_Result createAdaptiveSamplingResources(VKRT* vkrt) {
+    if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
+
+    if (createBuffer(
+            vkrt,
+            sizeof(AdaptiveStatus),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            &vkrt->core.adaptiveStatus.buffer,
+            &vkrt->core.adaptiveStatus.memory
+        ) != VKRT_SUCCESS) {
+        return VKRT_ERROR_OPERATION_FAILED;
+    }
+    vkrt->core.adaptiveStatus.deviceAddress = 0;
+    vkrt->core.adaptiveStatus.count = 1;
+
+    for (uint32_t i = 0; i < VKRT_MAX_FRAMES_IN_FLIGHT; i++) {
+        VKRT_AdaptiveSamplingReadback* readback = &vkrt->renderControl.adaptiveSampling.readbacks[i];
+        clearAdaptiveSamplingReadback(readback);
+
+        VKRT_Result result = createBuffer(
+            vkrt,
+            sizeof(AdaptiveStatus),
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            &readback->buffer.buffer,
+            &readback->buffer.memory
+        );
+        if (result != VKRT_SUCCESS) {
+            destroyAdaptiveSamplingResources(vkrt);
+            return result;
+        }
+
+        readback->mappedStatus = vkrtMappedMemory(readback->buffer.memory);
+        if (!readback->mappedStatus) {
+            destroyAdaptiveSamplingResources(vkrt);
+            return VKRT_ERROR_OPERATION_FAILED;
+        }
+        readback->buffer.count = 1;
+    }
+
+    return VKRT_SUCCESS;
+}
+
+void destroyAdaptiveSamplingResources(VKRT* vkrt) {
+    if (!vkrt || vkrt->core.device == VK_NULL_HANDLE) return;
+
+    for (uint32_t i = 0; i < VKRT_MAX_FRAMES_IN_FLIGHT; i++) {
+        VKRT_AdaptiveSamplingReadback* readback = &vkrt->renderControl.adaptiveSampling.readbacks[i];
+        if (readback->buffer.buffer != VK_NULL_HANDLE) {
+            vkDestroyBuffer(vkrt->core.device, readback->buffer.buffer, NULL);
+        }
+        vkrtFreeMemory(vkrt, &readback->buffer.memory);
+        clearAdaptiveSamplingReadback(readback);
+    }
+
+    if (vkrt->core.adaptiveStatus.buffer != VK_NULL_HANDLE) {
+        vkDestroyBuffer(vkrt->core.device, vkrt->core.adaptiveStatus.buffer, NULL);
+        vkrt->core.adaptiveStatus.buffer = VK_NULL_HANDLE;
+    }
+    vkrtFreeMemory(vkrt, &vkrt->core.adaptiveStatus.memory);
+}
+
+void resetAdaptiveSamplingState(VKRT* vkrt) {
+    if (!vkrt) return;
+
+    for (uint32_t i = 0; i < VKRT_MAX_FRAMES_IN_FLIGHT; i++) {
+        vkrt->renderControl.adaptiveSampling.readbacks[i].pending = 0u;
+    }
+    vkrt->renderStatus.adaptiveActiveTiles = 0u;
+    vkrt->renderStatus.adaptiveTileCount = 0u;
+}
+
+void recordAdaptiveSamplingReadback(VKRT* vkrt, VkCommandBuffer commandBuffer) {
+    if (!vkrt || commandBuffer == VK_NULL_HANDLE || vkrt->core.adaptiveStatus.buffer == VK_NULL_HANDLE) return;
+
+    VKRT_AdaptiveSamplingReadback* readback =
+        &vkrt->renderControl.adaptiveSampling.readbacks[vkrt->runtime.currentFrame];
+    if (readback->buffer.buffer == VK_NULL_HANDLE) return;
+
+    VkBufferCopy region = {.size = sizeof(AdaptiveStatus)};
+    vkCmdCopyBuffer(commandBuffer, vkrt->core.adaptiveStatus.buffer, readback->buffer.buffer, 1, &region);
+    readback->pending = 1u;
+}
+
+void resolveAdaptiveSamplingReadback(VKRT* vkrt, uint32_t frameIndex) {
+    if (!vkrt || frameIndex >= VKRT_MAX_FRAMES_IN_FLIGHT) return;
+
+    VKRT_AdaptiveSamplingReadback* readback = &vkrt->renderControl.adaptiveSampling.readbacks[frameIndex];
+    if (!readback->pending) return;
+    readback->pending = 0u;
+
+    if (!readback->mappedStatus) return;
+    vkrt->renderStatus.adaptiveActiveTiles = readback->mappedStatus->activeTileCount;
+    vkrt->renderStatus.adaptiveTileCount = readback->mappedStatus->evaluatedTileCount;
+}
+
+uint8_t adaptiveSamplingConverged(const VKRT* vkrt) {
+    if (!vkrt || vkrt->sceneSettings.noiseThreshold <= 0.0f) return 0u;
+    if (vkrt->sceneSettings.debugMode != VKRT_DEBUG_MODE_NONE) return 0u;
+
+    // Tiles below the minimum sample count always report active, so zero active tiles implies every tile converged.
+    return vkrt->renderStatus.adaptiveTileCount > 0u && vkrt->renderStatus.adaptiveActiveTiles == 0u ? 1u : 0u;
+}
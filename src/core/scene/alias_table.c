@@ -0,0 +1,62 @@
+#include "alias_table.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+int vkrtBuildAliasTable(const float* pmf, uint32_t count, float* outQ, uint32_t* outIdx) {
+    if (count == 0) return 1;
+
+    float* scaled = (float*)malloc(sizeof(float) * count);
+    uint32_t* smallBin = (uint32_t*)malloc(sizeof(uint32_t) * count);
+    uint32_t* largeBin = (uint32_t*)malloc(sizeof(uint32_t) * count);
+    if (!scaled || !smallBin || !largeBin) {
+        free(scaled);
+        free(smallBin);
+        free(largeBin);
+        return 0;
+    }
+
+    uint32_t smallCount = 0;
+    uint32_t largeCount = 0;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        scaled[i] = pmf[i] * (float)count;
+        if (scaled[i] < 1.0f) {
+            smallBin[smallCount++] = i;
+        } else {
+            largeBin[largeCount++] = i;
+        }
+    }
+
+    while (smallCount > 0 && largeCount > 0) {
+        uint32_t smallIndex = smallBin[--smallCount];
+        uint32_t largeIndex = largeBin[--largeCount];
+
+        outQ[smallIndex] = scaled[smallIndex];
+        outIdx[smallIndex] = largeIndex;
+
+        scaled[largeIndex] = scaled[largeIndex] + scaled[smallIndex] - 1.0f;
+        if (scaled[largeIndex] < 1.0f) {
+            smallBin[smallCount++] = largeIndex;
+        } else {
+            largeBin[largeCount++] = largeIndex;
+        }
+    }
+
+    while (largeCount > 0) {
+        uint32_t largeIndex = largeBin[--largeCount];
+        outQ[largeIndex] = 1.0f;
+        outIdx[largeIndex] = largeIndex;
+    }
+
+    while (smallCount > 0) {
+        uint32_t smallIndex = smallBin[--smallCount];
+        outQ[smallIndex] = 1.0f;
+        outIdx[smallIndex] = smallIndex;
+    }
+
+    free(scaled);
+    free(smallBin);
+    free(largeBin);
+    return 1;
+}
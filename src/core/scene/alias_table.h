@@ -0,0 +1,7 @@
+#pragma once
+
+#include <stdint.h>
+
+// Builds a Walker alias table for a normalized pmf. Sampling picks a bin uniformly, keeps it with probability
+// outQ[bin] and otherwise takes outIdx[bin]. Returns 0 on allocation failure.
+int vkrtBuildAliasTable(const float* pmf, uint32_t count, float* outQ, uint32_t* outIdx);
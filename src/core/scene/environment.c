@@ -1,14 +1,25 @@
 #include "environment.h"
 
 #include "constants.h"
+#include "debug.h"
+#include "formats.h"
+#include "image.h"
+#include "io.h"
+#include "platform.h"
 #include "scene.h"
+#include "state.h"
 #include "textures.h"
 #include "vkrt_engine_types.h"
 #include "vkrt_types.h"
 
+#include <stddef.h>
 #include <stdint.h>
 
-static VKRT_Result replaceEnvironmentTexture(VKRT* vkrt, uint32_t nextTextureIndex) {
+static VKRT_Result replaceEnvironmentTexture(
+    VKRT* vkrt,
+    uint32_t nextTextureIndex,
+    EnvironmentDistribution* nextDistribution
+) {
     if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
 
     uint32_t previousTextureIndex = vkrt->sceneSettings.environmentTextureIndex;
@@ -34,7 +45,14 @@ static VKRT_Result replaceEnvironmentTexture(VKRT* vkrt, uint32_t nextTextureInd
         }
     }
 
+    vkrtReleaseEnvironmentDistribution(&vkrt->core.environmentDistribution);
+    if (nextDistribution) {
+        vkrt->core.environmentDistribution = *nextDistribution;
+        *nextDistribution = (EnvironmentDistribution){0};
+    }
+
     vkrt->sceneSettings.environmentTextureIndex = nextTextureIndex;
+    vkrtMarkLightResourcesDirty(vkrt);
     resetSceneData(vkrt);
     return VKRT_SUCCESS;
 }
@@ -42,11 +60,47 @@ static VKRT_Result replaceEnvironmentTexture(VKRT* vkrt, uint32_t nextTextureInd
 VKRT_Result vkrtSceneSetEnvironmentTextureFromFile(VKRT* vkrt, const char* path) {
     if (!path || !path[0]) return VKRT_ERROR_INVALID_ARGUMENT;
 
+    char resolvedPath[VKRT_PATH_MAX];
+    if (resolveExistingPath(path, resolvedPath, sizeof(resolvedPath)) != 0) {
+        return VKRT_ERROR_INVALID_ARGUMENT;
+    }
+
+    VKRT_LoadedImage image = {0};
+    if (!vkrtLoadImageFromFile(resolvedPath, VKRT_TEXTURE_COLOR_SPACE_LINEAR, &image)) {
+        return VKRT_ERROR_OPERATION_FAILED;
+    }
+
+    EnvironmentDistribution distribution = {0};
+    if (vkrtTextureFormatIsBlockCompressed(image.format)) {
+        // The distribution is built from decoded texels, and block-compressed images stay encoded on the CPU.
+        LOG_WARN(
+            "Environment %s is block-compressed; importance sampling disabled, so small bright sources will be noisy",
+            pathBasename(resolvedPath)
+        );
+    } else if (vkrtBuildEnvironmentDistribution(&image, &distribution) != VKRT_SUCCESS) {
+        LOG_INFO("Environment %s has no usable luminance; importance sampling disabled", pathBasename(resolvedPath));
+    }
+
     uint32_t textureIndex = VKRT_INVALID_INDEX;
-    VKRT_Result result = vkrtSceneAddTextureFromFile(vkrt, path, NULL, VKRT_TEXTURE_COLOR_SPACE_LINEAR, &textureIndex);
-    if (result != VKRT_SUCCESS) return result;
+    VKRT_TextureUpload upload = {
+        .name = pathBasename(resolvedPath),
+        .pixels = image.pixels,
+        .width = image.width,
+        .height = image.height,
+        .format = image.format,
+        .colorSpace = image.colorSpace,
+        .mipLevelCount = image.mipLevelCount,
+        .mipLevelOffsets = image.mipLevelOffsets,
+    };
+    VKRT_Result result = vkrtSceneAddTextureFromPixels(vkrt, &upload, &textureIndex);
+    vkrtFreeLoadedImage(&image);
+    if (result != VKRT_SUCCESS) {
+        vkrtReleaseEnvironmentDistribution(&distribution);
+        return result;
+    }
 
-    result = replaceEnvironmentTexture(vkrt, textureIndex);
+    result = replaceEnvironmentTexture(vkrt, textureIndex, &distribution);
+    vkrtReleaseEnvironmentDistribution(&distribution);
     if (result == VKRT_SUCCESS) {
         return VKRT_SUCCESS;
     }
@@ -61,7 +115,7 @@ VKRT_Result vkrtSceneSetEnvironmentTextureFromFile(VKRT* vkrt, const char* path)
 }
 
 VKRT_Result vkrtSceneClearEnvironmentTexture(VKRT* vkrt) {
-    return replaceEnvironmentTexture(vkrt, VKRT_INVALID_INDEX);
+    return replaceEnvironmentTexture(vkrt, VKRT_INVALID_INDEX, NULL);
 }
 
 void vkrtRemapEnvironmentTextureIndexAfterRemoval(VKRT* vkrt, uint32_t removedTextureIndex) {
@@ -72,6 +126,8 @@ void vkrtRemapEnvironmentTextureIndexAfterRemoval(VKRT* vkrt, uint32_t removedTe
 
     if (textureIndex == removedTextureIndex) {
         vkrt->sceneSettings.environmentTextureIndex = VKRT_INVALID_INDEX;
+        vkrtReleaseEnvironmentDistribution(&vkrt->core.environmentDistribution);
+        vkrtMarkLightResourcesDirty(vkrt);
     } else if (textureIndex > removedTextureIndex) {
         vkrt->sceneSettings.environmentTextureIndex = textureIndex - 1u;
     }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "environment_distribution.h"
 #include "vkrt_internal.h"
 
 VKRT_Result vkrtSceneSetEnvironmentTextureFromFile(VKRT* vkrt, const char* path);
@@ -0,0 +1,158 @@
+#include "environment_distribution.h"
+
+#include "alias_table.h"
+#include "color.h"
+#include "formats.h"
+#include "image.h"
+#include "packing.h"
+#include "vkrt_types.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+static const uint32_t kEnvironmentDistributionMaxWidth = 1024u;
+static const uint32_t kEnvironmentDistributionMaxHeight = 512u;
+static const float kEnvironmentDistributionPi = 3.14159265358979323846f;
+
+static float loadedPixelLuminance(const VKRT_LoadedImage* image, size_t pixelIndex) {
+    float rgb[3] = {0.0f, 0.0f, 0.0f};
+    size_t channelIndex = pixelIndex * 4u;
+    const void* basePixels = vkrtLoadedImageBaseLevel(image);
+    switch (image->format) {
+        case VKRT_TEXTURE_FORMAT_RGBA8_UNORM: {
+            const uint8_t* pixels = (const uint8_t*)basePixels;
+            for (uint32_t c = 0; c < 3u; c++) rgb[c] = (float)pixels[channelIndex + c] * (1.0f / 255.0f);
+            break;
+        }
+        case VKRT_TEXTURE_FORMAT_RGBA16_UNORM: {
+            const uint16_t* pixels = (const uint16_t*)basePixels;
+            for (uint32_t c = 0; c < 3u; c++) rgb[c] = (float)pixels[channelIndex + c] * (1.0f / 65535.0f);
+            break;
+        }
+        case VKRT_TEXTURE_FORMAT_RGBA16_SFLOAT: {
+            const uint16_t* pixels = (const uint16_t*)basePixels;
+            for (uint32_t c = 0; c < 3u; c++) rgb[c] = unpackHalf(pixels[channelIndex + c]);
+            break;
+        }
+        case VKRT_TEXTURE_FORMAT_RGBA32_SFLOAT: {
+            const float* pixels = (const float*)basePixels;
+            for (uint32_t c = 0; c < 3u; c++) rgb[c] = pixels[channelIndex + c];
+            break;
+        }
+        default:
+            return 0.0f;
+    }
+
+    float luminance = linearSRGBLuminance(rgb);
+    return isfinite(luminance) && luminance > 0.0f ? luminance : 0.0f;
+}
+
+static float environmentCellLuminance(const VKRT_LoadedImage* image, uint32_t x, uint32_t y, uint32_t w, uint32_t h) {
+    uint32_t x0 = (uint32_t)(((uint64_t)x * image->width) / w);
+    uint32_t x1 = (uint32_t)(((uint64_t)(x + 1u) * image->width) / w);
+    uint32_t y0 = (uint32_t)(((uint64_t)y * image->height) / h);
+    uint32_t y1 = (uint32_t)(((uint64_t)(y + 1u) * image->height) / h);
+    if (x1 <= x0) x1 = x0 + 1u;
+    if (y1 <= y0) y1 = y0 + 1u;
+
+    double sum = 0.0;
+    for (uint32_t py = y0; py < y1; py++) {
+        for (uint32_t px = x0; px < x1; px++) {
+            sum += loadedPixelLuminance(image, ((size_t)py * image->width) + px);
+        }
+    }
+    return (float)(sum / (double)((x1 - x0) * (y1 - y0)));
+}
+
+void vkrtReleaseEnvironmentDistribution(EnvironmentDistribution* distribution) {
+    if (!distribution) return;
+    free(distribution->aliasQ);
+    free(distribution->aliasIdx);
+    free(distribution->pmf);
+    *distribution = (EnvironmentDistribution){0};
+}
+
+VKRT_Result vkrtBuildEnvironmentDistribution(
+    const VKRT_LoadedImage* image,
+    EnvironmentDistribution* outDistribution
+) {
+    if (!image || !image->pixels || !outDistribution) return VKRT_ERROR_INVALID_ARGUMENT;
+    *outDistribution = (EnvironmentDistribution){0};
+
+    uint32_t width = image->width < kEnvironmentDistributionMaxWidth ? image->width : kEnvironmentDistributionMaxWidth;
+    uint32_t height =
+        image->height < kEnvironmentDistributionMaxHeight ? image->height : kEnvironmentDistributionMaxHeight;
+    if (width == 0u || height == 0u) return VKRT_ERROR_INVALID_ARGUMENT;
+
+    size_t entryCount = (size_t)height + ((size_t)width * height);
+    float* weights = (float*)malloc(sizeof(float) * (size_t)width * height);
+    float* rowWeights = (float*)calloc(height, sizeof(float));
+    EnvironmentDistribution distribution = {
+        .aliasQ = (float*)malloc(sizeof(float) * entryCount),
+        .aliasIdx = (uint32_t*)malloc(sizeof(uint32_t) * entryCount),
+        .pmf = (float*)malloc(sizeof(float) * entryCount),
+        .width = width,
+        .height = height,
+    };
+    if (!weights || !rowWeights || !distribution.aliasQ || !distribution.aliasIdx || !distribution.pmf) {
+        free(weights);
+        free(rowWeights);
+        vkrtReleaseEnvironmentDistribution(&distribution);
+        return VKRT_ERROR_OUT_OF_MEMORY;
+    }
+
+    double totalWeight = 0.0;
+    for (uint32_t y = 0; y < height; y++) {
+        float sinTheta = sinf(kEnvironmentDistributionPi * ((float)y + 0.5f) / (float)height);
+        for (uint32_t x = 0; x < width; x++) {
+            float weight = environmentCellLuminance(image, x, y, width, height) * sinTheta;
+            weights[((size_t)y * width) + x] = weight;
+            rowWeights[y] += weight;
+        }
+        totalWeight += rowWeights[y];
+    }
+
+    VKRT_Result result = VKRT_SUCCESS;
+    if (!(totalWeight > 0.0) || !isfinite(totalWeight)) {
+        result = VKRT_ERROR_OPERATION_FAILED;
+    }
+
+    for (uint32_t y = 0; result == VKRT_SUCCESS && y < height; y++) {
+        distribution.pmf[y] = (float)(rowWeights[y] / totalWeight);
+
+        float* rowPmf = &distribution.pmf[height + ((size_t)y * width)];
+        float invRowWeight = rowWeights[y] > 0.0f ? 1.0f / rowWeights[y] : 0.0f;
+        for (uint32_t x = 0; x < width; x++) {
+            rowPmf[x] = invRowWeight > 0.0f ? weights[((size_t)y * width) + x] * invRowWeight : 1.0f / (float)width;
+        }
+        if (!vkrtBuildAliasTable(
+                rowPmf,
+                width,
+                &distribution.aliasQ[height + ((size_t)y * width)],
+                &distribution.aliasIdx[height + ((size_t)y * width)]
+            )) {
+            result = VKRT_ERROR_OUT_OF_MEMORY;
+        }
+    }
+    if (result == VKRT_SUCCESS &&
+        !vkrtBuildAliasTable(distribution.pmf, height, distribution.aliasQ, distribution.aliasIdx)) {
+        result = VKRT_ERROR_OUT_OF_MEMORY;
+    }
+
+    free(weights);
+    free(rowWeights);
+    if (result != VKRT_SUCCESS) {
+        vkrtReleaseEnvironmentDistribution(&distribution);
+        return result;
+    }
+
+    // Each cell spans (2pi / width) * (pi / height) of lat-long parameter space, so the sinTheta-weighted sum is a
+    // midpoint estimate of the radiance integral over the sphere.
+    distribution.integratedLuminance =
+        (float)(totalWeight * 2.0 * (double)kEnvironmentDistributionPi * (double)kEnvironmentDistributionPi /
+                ((double)width * (double)height));
+    *outDistribution = distribution;
+    return VKRT_SUCCESS;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "image.h"
+#include "vkrt_internal.h"
+
+// Builds the lat-long importance sampling distribution for an environment image: a row pmf and per-row conditional
+// pmfs, each with an alias table, laid out as [height row entries][height * width column entries].
+VKRT_Result vkrtBuildEnvironmentDistribution(
+    const VKRT_LoadedImage* image,
+    EnvironmentDistribution* outDistribution
+);
+void vkrtReleaseEnvironmentDistribution(EnvironmentDistribution* distribution);
@@ -1,3 +1,4 @@
+#include "allocator.h"
 #include "buffer.h"
 #include "color.h"
 #include "command/record.h"
@@ -84,15 +85,8 @@ VKRT_Result createAutoExposureReadbacks(VKRT* vkrt) {
             return result;
         }
 
-        if (vkMapMemory(
-                vkrt->core.device,
-                readback->buffer.memory,
-                0,
-                readbackBytes,
-                0,
-                (void**)&readback->mappedSamples
-            ) != VK_SUCCESS ||
-            !readback->mappedSamples) {
+        readback->mappedSamples = vkrtMappedMemory(readback->buffer.memory);
+        if (!readback->mappedSamples) {
             destroyAutoExposureReadbacks(vkrt);
             return VKRT_ERROR_OPERATION_FAILED;
         }
@@ -110,15 +104,10 @@ void destroyAutoExposureReadbacks(VKRT* vkrt) {
 
     for (uint32_t i = 0; i < VKRT_MAX_FRAMES_IN_FLIGHT; i++) {
         VKRT_AutoExposureReadback* readback = &vkrt->renderControl.autoExposure.readbacks[i];
-        if (readback->mappedSamples && readback->buffer.memory != VK_NULL_HANDLE) {
-            vkUnmapMemory(vkrt->core.device, readback->buffer.memory);
-        }
         if (readback->buffer.buffer != VK_NULL_HANDLE) {
             vkDestroyBuffer(vkrt->core.device, readback->buffer.buffer, NULL);
         }
-        if (readback->buffer.memory != VK_NULL_HANDLE) {
-            vkFreeMemory(vkrt->core.device, readback->buffer.memory, NULL);
-        }
+        vkrtFreeMemory(vkrt, &readback->buffer.memory);
         clearAutoExposureReadback(readback);
     }
 }
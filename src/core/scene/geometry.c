@@ -2,12 +2,17 @@
 
 #include "accel/accel.h"
 #include "buffer.h"
+#include "command/pool.h"
 #include "constants.h"
 #include "debug.h"
 #include "descriptor.h"
+#include "geometry_dedup.h"
+#include "geometry_heap.h"
+#include "lighting.h"
 #include "packing.h"
 #include "rebuild.h"
 #include "scene.h"
+#include "staging.h"
 #include "state.h"
 #include "types.h"
 #include "vkrt_engine_types.h"
@@ -19,31 +24,42 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <vec3.h>
 
-static const uint64_t kGeometryFingerprintSeed = 1469598103934665603ull;
-static const uint64_t kGeometryFingerprintPrime = 1099511628211ull;
+enum {
+    K_GEOMETRY_HEAP_MAX_STREAMS = 2,
+};
+
+static const VkDeviceSize kVertexPositionStride = VKRT_VERTEX_POSITION_COMPONENTS * sizeof(float);
+
+typedef struct GeometryHeapStream {
+    Buffer* buffer;
+    VkDeviceSize elementSize;
+    VkBufferUsageFlags usage;
+} GeometryHeapStream;
 
 static VkBufferUsageFlags verticesUsage(void) {
-    return VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
-           VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    return VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+           VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+           VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
 }
 
 static VkBufferUsageFlags indicesUsage(void) {
-    return VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
-           VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    return VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+           VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+           VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
 }
 
-typedef struct GeometryBufferState {
-    Buffer vertexData;
-    Buffer indexData;
-    GeometryLayout layout;
-} GeometryBufferState;
+static MeshInfo* collectMeshInfos(const VKRT* vkrt) {
+    uint32_t meshCount = vkrt->core.meshCount;
+    MeshInfo* meshInfos = (MeshInfo*)malloc(sizeof(*meshInfos) * meshCount);
+    if (!meshInfos) return NULL;
 
-typedef struct GeometryOwnerState {
-    uint32_t vertexBase;
-    uint32_t indexBase;
-    AccelerationStructure accelerationStructure;
-} GeometryOwnerState;
+    for (uint32_t i = 0; i < meshCount; i++) {
+        meshInfos[i] = vkrt->core.meshes[i].info;
+    }
+    return meshInfos;
+}
 
 VKRT_Result vkrtSceneBuildMeshInfoBuffer(VKRT* vkrt, Buffer* outBuffer) {
     if (!vkrt || !outBuffer) return VKRT_ERROR_INVALID_ARGUMENT;
@@ -60,15 +76,11 @@ VKRT_Result vkrtSceneBuildMeshInfoBuffer(VKRT* vkrt, Buffer* outBuffer) {
         );
     }
 
-    MeshInfo* meshInfos = (MeshInfo*)malloc(sizeof(*meshInfos) * instanceCount);
+    MeshInfo* meshInfos = collectMeshInfos(vkrt);
     if (!meshInfos) {
         return VKRT_ERROR_OPERATION_FAILED;
     }
 
-    for (uint32_t i = 0; i < instanceCount; i++) {
-        meshInfos[i] = vkrt->core.meshes[i].info;
-    }
-
     VKRT_Result result = createDeviceBufferFromData(
         vkrt,
         meshInfos,
@@ -85,6 +97,20 @@ VKRT_Result vkrtSceneBuildMeshInfoBuffer(VKRT* vkrt, Buffer* outBuffer) {
 VKRT_Result vkrtSceneRebuildMeshInfoBuffer(VKRT* vkrt) {
     if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
 
+    uint32_t meshCount = vkrt->core.meshCount;
+    Buffer* meshData = &vkrt->core.sceneMeshData;
+    if (meshCount > 0u && meshData->buffer != VK_NULL_HANDLE && meshData->count == meshCount) {
+        MeshInfo* meshInfos = collectMeshInfos(vkrt);
+        if (!meshInfos) {
+            return VKRT_ERROR_OPERATION_FAILED;
+        }
+
+        VKRT_Result result =
+            updateDeviceBufferFromData(vkrt, meshInfos, sizeof(*meshInfos) * meshCount, meshData->buffer);
+        free(meshInfos);
+        return result;
+    }
+
     Buffer nextMeshData = {0};
     VKRT_Result result = vkrtSceneBuildMeshInfoBuffer(vkrt, &nextMeshData);
     if (result != VKRT_SUCCESS) {
@@ -112,17 +138,6 @@ static void syncDuplicateMeshFromSource(Mesh* mesh, const Mesh* source) {
     mesh->blasBuildPending = 0;
 }
 
-static void resetGeometryLayout(GeometryLayout* layout) {
-    layout->vertexCapacity = 0;
-    layout->indexCapacity = 0;
-}
-
-static void destroyGeometryBufferState(VKRT* vkrt, GeometryBufferState* state) {
-    if (!state) return;
-    destroyBufferResources(vkrt, &state->vertexData);
-    destroyBufferResources(vkrt, &state->indexData);
-    resetGeometryLayout(&state->layout);
-}
 
 static void markSceneMutation(VKRT* vkrt) {
     vkrtMarkMaterialResourcesDirty(vkrt);
@@ -143,72 +158,6 @@ static void shrinkMeshList(VKRT* vkrt, uint32_t meshCount) {
     if (shrunk) vkrt->core.meshes = shrunk;
 }
 
-static uint64_t hashGeometryBytes(uint64_t hash, const void* bytes, size_t byteCount) {
-    if (!bytes || byteCount == 0) return hash;
-
-    const uint8_t* cursor = (const uint8_t*)bytes;
-    size_t wordCount = byteCount / sizeof(uint64_t);
-    const uint64_t* words = (const uint64_t*)cursor;
-    for (size_t i = 0; i < wordCount; i++) {
-        hash ^= words[i];
-        hash *= kGeometryFingerprintPrime;
-    }
-
-    size_t remaining = byteCount - (wordCount * sizeof(uint64_t));
-    cursor += wordCount * sizeof(uint64_t);
-    for (size_t i = 0; i < remaining; i++) {
-        hash ^= (uint64_t)cursor[i];
-        hash *= kGeometryFingerprintPrime;
-    }
-    return hash;
-}
-
-static uint64_t geometryFingerprint(
-    const Vertex* vertices,
-    size_t vertexCount,
-    const uint32_t* indices,
-    size_t indexCount
-) {
-    uint64_t hash = kGeometryFingerprintSeed;
-    hash = hashGeometryBytes(hash, &vertexCount, sizeof(vertexCount));
-    hash = hashGeometryBytes(hash, &indexCount, sizeof(indexCount));
-    hash = hashGeometryBytes(hash, vertices, vertexCount * sizeof(Vertex));
-    hash = hashGeometryBytes(hash, indices, indexCount * sizeof(uint32_t));
-    return hash;
-}
-
-static uint32_t findDuplicateGeometrySource(
-    const VKRT* vkrt,
-    uint32_t meshCount,
-    const Vertex* vertices,
-    size_t vertexCount,
-    const uint32_t* indices,
-    size_t indexCount,
-    uint64_t fingerprint
-) {
-    if (!vkrt || !vertices || !indices) return VKRT_INVALID_INDEX;
-
-    for (uint32_t i = 0; i < meshCount; i++) {
-        const Mesh* existing = &vkrt->core.meshes[i];
-        if (!existing->ownsGeometry) continue;
-        if (existing->info.vertexCount != (uint32_t)vertexCount || existing->info.indexCount != (uint32_t)indexCount) {
-            continue;
-        }
-        if (existing->geometryFingerprint != fingerprint) {
-            continue;
-        }
-        if (memcmp(existing->vertices, vertices, vertexCount * sizeof(Vertex)) != 0) {
-            continue;
-        }
-        if (memcmp(existing->indices, indices, indexCount * sizeof(uint32_t)) != 0) {
-            continue;
-        }
-        return existing->geometrySource;
-    }
-
-    return VKRT_INVALID_INDEX;
-}
-
 static void initializeMeshDefaults(Mesh* mesh, size_t vertexCount, size_t indexCount) {
     if (!mesh) return;
 
@@ -218,13 +167,30 @@ static void initializeMeshDefaults(Mesh* mesh, size_t vertexCount, size_t indexC
     mesh->hasMaterialAssignment = 0u;
     mesh->info.vertexCount = (uint32_t)vertexCount;
     mesh->info.indexCount = (uint32_t)indexCount;
+    mesh->info.indexFormat = vertexCount <= VKRT_MESH_UINT16_INDEX_VERTEX_LIMIT ? VKRT_MESH_INDEX_FORMAT_UINT16
+                                                                                 : VKRT_MESH_INDEX_FORMAT_UINT32;
     mesh->info.materialIndex = 0u;
     mesh->info.renderBackfaces = vkrtResolveMeshRenderBackfaces(mesh);
     mesh->info.opacity = 1.0f;
-    float scale[3] = {1.0f, 1.0f, 1.0f};
-    memcpy(mesh->info.scale, scale, sizeof(scale));
-    memset(&mesh->info.rotation, 0, sizeof(mesh->info.rotation));
-    memset(&mesh->info.position, 0, sizeof(mesh->info.position));
+    glm_vec3_one(mesh->scale);
+    packMeshInfoTransform(mesh->worldTransform, &mesh->info);
+}
+
+// 16-bit index meshes pack two indices into each element of the 32-bit index heap.
+static uint32_t meshIndexElementCount(const MeshInfo* info) {
+    if (info->indexFormat == VKRT_MESH_INDEX_FORMAT_UINT16) {
+        return info->indexCount / 2u + (info->indexCount & 1u);
+    }
+    return info->indexCount;
+}
+
+static void releaseMeshGeometryRange(VKRT* vkrt, const Mesh* mesh) {
+    GeometryLayout* layout = &vkrt->core.geometryLayout;
+    uint32_t indexElementCount = meshIndexElementCount(&mesh->info);
+    if (vkrtGeometryRangeFree(&layout->vertices, mesh->info.vertexBase, mesh->info.vertexCount) != VKRT_SUCCESS ||
+        vkrtGeometryRangeFree(&layout->indices, mesh->info.indexBase, indexElementCount) != VKRT_SUCCESS) {
+        LOG_ERROR("Failed to return mesh geometry range to the geometry heap");
+    }
 }
 
 static void releaseNewMeshRange(VKRT* vkrt, uint32_t startIndex, uint32_t endIndex) {
@@ -232,182 +198,220 @@ static void releaseNewMeshRange(VKRT* vkrt, uint32_t startIndex, uint32_t endInd
 
     for (uint32_t i = startIndex; i < endIndex; i++) {
         Mesh* mesh = &vkrt->core.meshes[i];
+        vkrtReleaseEmissiveTriangleCache(&mesh->emissiveCache);
         if (!mesh->ownsGeometry) continue;
+        vkrtGeometryDedupRemove(&vkrt->core.geometryDedup, mesh->geometryFingerprint, i);
+        if (mesh->bottomLevelAccelerationStructure.structure != VK_NULL_HANDLE) {
+            releaseMeshGeometryRange(vkrt, mesh);
+            vkrtDestroyAccelerationStructureResources(vkrt, &mesh->bottomLevelAccelerationStructure);
+        }
         free(mesh->vertices);
         free(mesh->indices);
     }
 }
 
-static int backupMeshState(
-    const VKRT* vkrt,
-    Mesh** outMeshes,
-    uint32_t* outMeshCount,
-    uint32_t* outSelectedMeshIndex,
-    uint32_t* outSelectionEnabled
-) {
-    if (!vkrt || !outMeshes || !outMeshCount || !outSelectedMeshIndex || !outSelectionEnabled) {
-        return 0;
+static void syncDuplicateMeshRange(VKRT* vkrt, uint32_t startIndex, uint32_t endIndex) {
+    for (uint32_t i = startIndex; i < endIndex; i++) {
+        Mesh* mesh = &vkrt->core.meshes[i];
+        if (mesh->ownsGeometry) continue;
+        syncDuplicateMeshFromSource(mesh, &vkrt->core.meshes[mesh->geometrySource]);
     }
-
-    *outMeshes = NULL;
-    *outMeshCount = vkrt->core.meshCount;
-    *outSelectedMeshIndex = vkrt->sceneSettings.selectedMeshIndex;
-    *outSelectionEnabled = vkrt->sceneSettings.selectionEnabled;
-
-    if (vkrt->core.meshCount == 0) return 1;
-
-    Mesh* backup = (Mesh*)malloc((size_t)vkrt->core.meshCount * sizeof(Mesh));
-    if (!backup) return 0;
-
-    memcpy(backup, vkrt->core.meshes, (size_t)vkrt->core.meshCount * sizeof(Mesh));
-    *outMeshes = backup;
-    return 1;
 }
 
-static void restoreMeshState(
+static VKRT_Result createGeometryHeapBuffer(
     VKRT* vkrt,
-    const Mesh* meshes,
-    uint32_t meshCount,
-    uint32_t selectedMeshIndex,
-    uint32_t selectionEnabled
+    const GeometryHeapStream* stream,
+    uint32_t capacity,
+    Buffer* outBuffer
 ) {
-    if (!vkrt) return;
-
-    if (meshCount > 0 && meshes && vkrt->core.meshes) {
-        memcpy(vkrt->core.meshes, meshes, (size_t)meshCount * sizeof(Mesh));
-    }
-    vkrt->core.meshCount = meshCount;
-    vkrt->sceneSettings.selectedMeshIndex = selectedMeshIndex;
-    vkrt->sceneSettings.selectionEnabled = selectionEnabled;
+    *outBuffer = (Buffer){0};
+    VKRT_Result result = createBuffer(
+        vkrt,
+        (VkDeviceSize)capacity * stream->elementSize,
+        stream->usage,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        &outBuffer->buffer,
+        &outBuffer->memory
+    );
+    if (result != VKRT_SUCCESS) return result;
+    outBuffer->deviceAddress = queryBufferDeviceAddress(vkrt, outBuffer->buffer);
+    return VKRT_SUCCESS;
 }
 
-static void destroyOwnerAccelerationStructures(VKRT* vkrt, GeometryOwnerState* ownerStates, uint32_t ownerCount) {
-    if (!vkrt || !ownerStates) return;
+static uint32_t queryVertexHeapStreams(VKRT* vkrt, GeometryHeapStream* outStreams) {
+    outStreams[0] = (GeometryHeapStream){&vkrt->core.positionData, kVertexPositionStride, verticesUsage()};
+    outStreams[1] = (GeometryHeapStream){&vkrt->core.vertexData, sizeof(ShaderVertex), verticesUsage()};
+    return 2u;
+}
 
-    for (uint32_t i = 0; i < ownerCount; i++) {
-        vkrtDestroyAccelerationStructureResources(vkrt, &ownerStates[i].accelerationStructure);
-    }
+static uint32_t queryIndexHeapStreams(VKRT* vkrt, GeometryHeapStream* outStreams) {
+    outStreams[0] = (GeometryHeapStream){&vkrt->core.indexData, sizeof(uint32_t), indicesUsage()};
+    return 1u;
 }
 
-static VKRT_Result collectGeometryRequirements(
-    const VKRT* vkrt,
-    uint32_t* outVertexCapacity,
-    uint32_t* outIndexCapacity,
-    uint32_t* outOwnerCount
+static VKRT_Result growGeometryHeap(
+    VKRT* vkrt,
+    GeometryRangeAllocator* allocator,
+    const GeometryHeapStream* streams,
+    uint32_t streamCount,
+    uint32_t requiredCount
 ) {
-    if (!vkrt || !outVertexCapacity || !outIndexCapacity || !outOwnerCount) {
-        return VKRT_ERROR_INVALID_ARGUMENT;
+    uint32_t capacity = vkrtGeometryRangeGrowthTarget(allocator, requiredCount);
+    if (capacity == 0u) {
+        LOG_ERROR("Geometry heap growth exceeds 32-bit buffer limits");
+        return VKRT_ERROR_OPERATION_FAILED;
     }
 
-    uint64_t requiredVertexCapacity = 0;
-    uint64_t requiredIndexCapacity = 0;
-    uint32_t ownerCount = 0;
-    for (uint32_t i = 0; i < vkrt->core.meshCount; i++) {
-        const Mesh* mesh = &vkrt->core.meshes[i];
-        if (!mesh->ownsGeometry) continue;
-        requiredVertexCapacity += mesh->info.vertexCount;
-        requiredIndexCapacity += mesh->info.indexCount;
-        ownerCount++;
+    if (vkrtWaitForAllInFlightFrames(vkrt) != VKRT_SUCCESS) {
+        LOG_ERROR("Failed to wait for in-flight frames before growing geometry heap");
+        return VKRT_ERROR_OPERATION_FAILED;
     }
 
-    if (requiredVertexCapacity > VKRT_INVALID_INDEX || requiredIndexCapacity > VKRT_INVALID_INDEX) {
-        LOG_ERROR("Geometry layout rebuild exceeds 32-bit buffer limits");
-        return VKRT_ERROR_OPERATION_FAILED;
+    Buffer next[K_GEOMETRY_HEAP_MAX_STREAMS] = {0};
+    VKRT_Result result = VKRT_SUCCESS;
+    for (uint32_t i = 0; result == VKRT_SUCCESS && i < streamCount; i++) {
+        const GeometryHeapStream* stream = &streams[i];
+        result = createGeometryHeapBuffer(vkrt, stream, capacity, &next[i]);
+
+        // Existing ranges move over on the GPU; their BLASes were built from the old contents and stay valid.
+        if (result == VKRT_SUCCESS && allocator->capacity > 0u && stream->buffer->buffer != VK_NULL_HANDLE) {
+            result = copyBuffer(
+                vkrt,
+                stream->buffer->buffer,
+                0,
+                next[i].buffer,
+                (VkDeviceSize)allocator->capacity * stream->elementSize
+            );
+        }
+    }
+    if (result == VKRT_SUCCESS) {
+        result = vkrtGeometryRangeGrow(allocator, capacity);
+    }
+    if (result != VKRT_SUCCESS) {
+        for (uint32_t i = 0; i < streamCount; i++) destroyBufferResources(vkrt, &next[i]);
+        return result;
     }
 
-    *outVertexCapacity = (uint32_t)requiredVertexCapacity;
-    *outIndexCapacity = (uint32_t)requiredIndexCapacity;
-    *outOwnerCount = ownerCount;
+    for (uint32_t i = 0; i < streamCount; i++) {
+        destroyBufferResources(vkrt, streams[i].buffer);
+        *streams[i].buffer = next[i];
+    }
+    LOG_TRACE("Grew geometry heap to %u elements", capacity);
     return VKRT_SUCCESS;
 }
 
-static Mesh* allocateMeshBackupCopy(const VKRT* vkrt) {
-    if (!vkrt || vkrt->core.meshCount == 0) return NULL;
-
-    Mesh* backup = (Mesh*)malloc((size_t)vkrt->core.meshCount * sizeof(Mesh));
-    if (!backup) return NULL;
+static VKRT_Result allocateGeometryHeapRange(
+    VKRT* vkrt,
+    GeometryRangeAllocator* allocator,
+    const GeometryHeapStream* streams,
+    uint32_t streamCount,
+    uint32_t count,
+    uint32_t reserveCount,
+    uint32_t* outOffset
+) {
+    if (vkrtGeometryRangeAllocate(allocator, count, outOffset)) return VKRT_SUCCESS;
 
-    memcpy(backup, vkrt->core.meshes, (size_t)vkrt->core.meshCount * sizeof(Mesh));
-    return backup;
+    VKRT_Result result = growGeometryHeap(vkrt, allocator, streams, streamCount, reserveCount);
+    if (result != VKRT_SUCCESS) return result;
+    return vkrtGeometryRangeAllocate(allocator, count, outOffset) ? VKRT_SUCCESS : VKRT_ERROR_OPERATION_FAILED;
 }
 
-static VKRT_Result buildRebuiltGeometryOwners(
+static VKRT_Result allocateMeshGeometryRange(
     VKRT* vkrt,
-    GeometryBufferState* newState,
-    GeometryOwnerState* ownerStates,
-    uint32_t ownerCount
+    Mesh* mesh,
+    uint32_t reserveVertexCount,
+    uint32_t reserveIndexCount
 ) {
-    if (!vkrt || !newState || (ownerCount > 0 && !ownerStates)) return VKRT_ERROR_INVALID_ARGUMENT;
-
-    uint32_t ownerWriteIndex = 0;
-    for (uint32_t i = 0; i < vkrt->core.meshCount; i++) {
-        Mesh* mesh = &vkrt->core.meshes[i];
-        if (!mesh->ownsGeometry) continue;
-        if (ownerWriteIndex >= ownerCount) return VKRT_ERROR_OPERATION_FAILED;
+    GeometryLayout* layout = &vkrt->core.geometryLayout;
+    GeometryHeapStream streams[K_GEOMETRY_HEAP_MAX_STREAMS];
 
-        GeometryOwnerState* ownerState = &ownerStates[ownerWriteIndex];
-        ownerState->vertexBase = newState->vertexData.count;
-        ownerState->indexBase = newState->indexData.count;
-
-        MeshInfo geometryInfo = mesh->info;
-        geometryInfo.vertexBase = ownerState->vertexBase;
-        geometryInfo.indexBase = ownerState->indexBase;
-        VKRT_Result result = createBottomLevelAccelerationStructureForGeometry(
-            vkrt,
-            &geometryInfo,
-            newState->vertexData.deviceAddress,
-            newState->indexData.deviceAddress,
-            &ownerState->accelerationStructure
-        );
-        if (result != VKRT_SUCCESS) {
-            destroyOwnerAccelerationStructures(vkrt, ownerStates, ownerWriteIndex);
-            return VKRT_ERROR_OPERATION_FAILED;
-        }
+    uint32_t vertexBase = 0;
+    uint32_t streamCount = queryVertexHeapStreams(vkrt, streams);
+    VKRT_Result result = allocateGeometryHeapRange(
+        vkrt,
+        &layout->vertices,
+        streams,
+        streamCount,
+        mesh->info.vertexCount,
+        reserveVertexCount,
+        &vertexBase
+    );
+    if (result != VKRT_SUCCESS) return result;
 
-        newState->vertexData.count += mesh->info.vertexCount;
-        newState->indexData.count += mesh->info.indexCount;
-        ownerWriteIndex++;
+    uint32_t indexBase = 0;
+    streamCount = queryIndexHeapStreams(vkrt, streams);
+    result = allocateGeometryHeapRange(
+        vkrt,
+        &layout->indices,
+        streams,
+        streamCount,
+        meshIndexElementCount(&mesh->info),
+        reserveIndexCount,
+        &indexBase
+    );
+    if (result != VKRT_SUCCESS) {
+        (void)vkrtGeometryRangeFree(&layout->vertices, vertexBase, mesh->info.vertexCount);
+        return result;
     }
 
+    mesh->info.vertexBase = vertexBase;
+    mesh->info.indexBase = indexBase;
     return VKRT_SUCCESS;
 }
 
-static void applyRebuiltOwnerGeometry(VKRT* vkrt, const GeometryOwnerState* ownerStates, uint32_t ownerCount) {
-    uint32_t ownerReadIndex = 0;
-    for (uint32_t i = 0; i < vkrt->core.meshCount; i++) {
+static VKRT_Result allocateNewMeshGeometry(VKRT* vkrt, uint32_t startIndex, uint32_t endIndex) {
+    uint64_t remainingVertexCount = 0;
+    uint64_t remainingIndexCount = 0;
+    for (uint32_t i = startIndex; i < endIndex; i++) {
+        const Mesh* mesh = &vkrt->core.meshes[i];
+        if (!mesh->ownsGeometry) continue;
+        remainingVertexCount += mesh->info.vertexCount;
+        remainingIndexCount += meshIndexElementCount(&mesh->info);
+    }
+    if (remainingVertexCount > VKRT_INVALID_INDEX || remainingIndexCount > VKRT_INVALID_INDEX) {
+        LOG_ERROR("Mesh upload exceeds 32-bit geometry buffer limits");
+        return VKRT_ERROR_OPERATION_FAILED;
+    }
+
+    for (uint32_t i = startIndex; i < endIndex; i++) {
         Mesh* mesh = &vkrt->core.meshes[i];
         if (!mesh->ownsGeometry) continue;
-        if (ownerReadIndex >= ownerCount) return;
 
-        const GeometryOwnerState* ownerState = &ownerStates[ownerReadIndex++];
-        mesh->info.vertexBase = ownerState->vertexBase;
-        mesh->info.indexBase = ownerState->indexBase;
-        mesh->geometrySource = i;
+        // Growth reserves room for the rest of the batch so one import grows the heap at most once.
+        VKRT_Result result =
+            allocateMeshGeometryRange(vkrt, mesh, (uint32_t)remainingVertexCount, (uint32_t)remainingIndexCount);
+        if (result != VKRT_SUCCESS) return result;
+        remainingVertexCount -= mesh->info.vertexCount;
+        remainingIndexCount -= meshIndexElementCount(&mesh->info);
+
+        result = createBottomLevelAccelerationStructureForGeometry(
+            vkrt,
+            &mesh->info,
+            vkrt->core.positionData.deviceAddress,
+            vkrt->core.indexData.deviceAddress,
+            &mesh->bottomLevelAccelerationStructure
+        );
+        if (result != VKRT_SUCCESS) {
+            releaseMeshGeometryRange(vkrt, mesh);
+            return result;
+        }
+
         mesh->geometryUploadPending = 1;
         mesh->blasBuildPending = 1;
-        mesh->bottomLevelAccelerationStructure = ownerState->accelerationStructure;
     }
-}
 
-static void syncDuplicateGeometryOwners(VKRT* vkrt) {
-    for (uint32_t i = 0; i < vkrt->core.meshCount; i++) {
-        Mesh* mesh = &vkrt->core.meshes[i];
-        if (mesh->ownsGeometry) continue;
-        mesh->geometrySource = vkrt->core.meshes[mesh->geometrySource].geometrySource;
-        syncDuplicateMeshFromSource(mesh, &vkrt->core.meshes[mesh->geometrySource]);
-    }
+    syncDuplicateMeshRange(vkrt, startIndex, endIndex);
+    return VKRT_SUCCESS;
 }
 
-static void restorePreviousGeometryState(VKRT* vkrt, const GeometryBufferState* previousState, const Mesh* meshBackup) {
-    vkrt->core.vertexData = previousState->vertexData;
-    vkrt->core.indexData = previousState->indexData;
-    vkrt->core.geometryLayout = previousState->layout;
-    if (meshBackup) {
-        memcpy(vkrt->core.meshes, meshBackup, (size_t)vkrt->core.meshCount * sizeof(Mesh));
+static VKRT_Result syncGeometryDescriptors(VKRT* vkrt, VkBuffer previousVertexBuffer, VkBuffer previousIndexBuffer) {
+    if (vkrt->core.vertexData.buffer == previousVertexBuffer && vkrt->core.indexData.buffer == previousIndexBuffer) {
+        return VKRT_SUCCESS;
     }
-    updateAllDescriptorSets(vkrt);
+    return updateAllDescriptorSets(vkrt);
 }
 
+
 static int allocateMeshHostGeometry(const VKRT_MeshUpload* upload, Mesh* mesh) {
     if (!upload || !mesh || upload->vertexCount == 0 || upload->indexCount == 0) return 0;
 
@@ -497,148 +501,65 @@ static void updateSelectionAfterMeshRemoval(VKRT* vkrt, uint32_t meshIndex) {
     vkrt->sceneSettings.selectionEnabled = vkrt->sceneSettings.selectedMeshIndex != VKRT_INVALID_INDEX;
 }
 
-static VKRT_Result createGeometryBuffers(
-    VKRT* vkrt,
-    uint32_t vertexCapacity,
-    uint32_t indexCapacity,
-    GeometryBufferState* outState
-) {
-    if (!vkrt || !outState) return VKRT_ERROR_INVALID_ARGUMENT;
-
-    *outState = (GeometryBufferState){0};
-    if (vertexCapacity > 0) {
-        VKRT_Result result = createBuffer(
-            vkrt,
-            (VkDeviceSize)vertexCapacity * sizeof(ShaderVertex),
-            VK_BUFFER_USAGE_TRANSFER_DST_BIT | verticesUsage(),
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            &outState->vertexData.buffer,
-            &outState->vertexData.memory
-        );
-        if (result != VKRT_SUCCESS) {
-            destroyGeometryBufferState(vkrt, outState);
-            return result;
-        }
-        outState->vertexData.deviceAddress = queryBufferDeviceAddress(vkrt, outState->vertexData.buffer);
-        outState->layout.vertexCapacity = vertexCapacity;
-    } else {
-        VKRT_Result result = createZeroInitializedDeviceBuffer(
-            vkrt,
-            sizeof(ShaderVertex),
-            VK_BUFFER_USAGE_TRANSFER_DST_BIT | verticesUsage(),
-            &outState->vertexData
-        );
-        if (result != VKRT_SUCCESS) {
-            destroyGeometryBufferState(vkrt, outState);
-            return result;
-        }
-    }
 
-    if (indexCapacity > 0) {
-        VKRT_Result result = createBuffer(
-            vkrt,
-            (VkDeviceSize)indexCapacity * sizeof(uint32_t),
-            VK_BUFFER_USAGE_TRANSFER_DST_BIT | indicesUsage(),
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            &outState->indexData.buffer,
-            &outState->indexData.memory
-        );
-        if (result != VKRT_SUCCESS) {
-            destroyGeometryBufferState(vkrt, outState);
-            return result;
-        }
-        outState->indexData.deviceAddress = queryBufferDeviceAddress(vkrt, outState->indexData.buffer);
-        outState->layout.indexCapacity = indexCapacity;
-    } else {
-        VKRT_Result result = createZeroInitializedDeviceBuffer(
-            vkrt,
-            sizeof(uint32_t),
-            VK_BUFFER_USAGE_TRANSFER_DST_BIT | indicesUsage(),
-            &outState->indexData
-        );
-        if (result != VKRT_SUCCESS) {
-            destroyGeometryBufferState(vkrt, outState);
-            return result;
-        }
-    }
-
-    outState->vertexData.count = 0;
-    outState->indexData.count = 0;
-    return VKRT_SUCCESS;
+static uint32_t queryPackedGeometryCapacity(const GeometryRangeAllocator* allocator) {
+    return allocator->usedCount > 0u ? allocator->usedCount : 1u;
 }
 
-static VKRT_Result rebuildGeometryLayout(VKRT* vkrt) {
-    if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
-    if (vkrtWaitForAllInFlightFrames(vkrt) != VKRT_SUCCESS) {
-        LOG_ERROR("Failed to wait for in-flight frames before rebuilding geometry layout");
-        return VKRT_ERROR_OPERATION_FAILED;
-    }
-
-    uint32_t requiredVertexCapacity = 0;
-    uint32_t requiredIndexCapacity = 0;
-    uint32_t ownerCount = 0;
-    VKRT_Result result =
-        collectGeometryRequirements(vkrt, &requiredVertexCapacity, &requiredIndexCapacity, &ownerCount);
-    if (result != VKRT_SUCCESS) return result;
-
-    GeometryBufferState newState = {0};
-    result = createGeometryBuffers(vkrt, requiredVertexCapacity, requiredIndexCapacity, &newState);
-    if (result != VKRT_SUCCESS) return result;
+static VKRT_Result copyGeometryRegions(
+    VKRT* vkrt,
+    const GeometryHeapStream* streams,
+    const Buffer* destinations,
+    uint32_t streamCount,
+    const VkBufferCopy* elementRegions,
+    uint32_t regionCount
+) {
+    if (regionCount == 0u) return VKRT_SUCCESS;
 
-    GeometryOwnerState* ownerStates =
-        (GeometryOwnerState*)calloc(ownerCount > 0 ? ownerCount : 1u, sizeof(GeometryOwnerState));
-    if (!ownerStates) {
-        destroyGeometryBufferState(vkrt, &newState);
-        return VKRT_ERROR_OPERATION_FAILED;
-    }
+    VkBufferCopy* byteRegions = (VkBufferCopy*)malloc((size_t)regionCount * sizeof(VkBufferCopy));
+    if (!byteRegions) return VKRT_ERROR_OUT_OF_MEMORY;
 
-    Mesh* meshBackup = allocateMeshBackupCopy(vkrt);
-    if (vkrt->core.meshCount > 0 && !meshBackup) {
-        free(ownerStates);
-        destroyGeometryBufferState(vkrt, &newState);
-        return VKRT_ERROR_OPERATION_FAILED;
-    }
-    result = buildRebuiltGeometryOwners(vkrt, &newState, ownerStates, ownerCount);
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    VKRT_Result result = beginSingleTimeCommands(vkrt, &commandBuffer);
     if (result != VKRT_SUCCESS) {
-        free(meshBackup);
-        free(ownerStates);
-        destroyGeometryBufferState(vkrt, &newState);
+        free(byteRegions);
         return result;
     }
 
-    GeometryBufferState previousState = {
-        .vertexData = vkrt->core.vertexData,
-        .indexData = vkrt->core.indexData,
-        .layout = vkrt->core.geometryLayout,
-    };
-
-    vkrt->core.vertexData = newState.vertexData;
-    vkrt->core.indexData = newState.indexData;
-    vkrt->core.geometryLayout = newState.layout;
-
-    applyRebuiltOwnerGeometry(vkrt, ownerStates, ownerCount);
-    syncDuplicateGeometryOwners(vkrt);
+    for (uint32_t streamIndex = 0; streamIndex < streamCount; streamIndex++) {
+        VkDeviceSize elementSize = streams[streamIndex].elementSize;
+        for (uint32_t i = 0; i < regionCount; i++) {
+            byteRegions[i] = (VkBufferCopy){
+                .srcOffset = elementRegions[i].srcOffset * elementSize,
+                .dstOffset = elementRegions[i].dstOffset * elementSize,
+                .size = elementRegions[i].size * elementSize,
+            };
+        }
+        vkCmdCopyBuffer(
+            commandBuffer,
+            streams[streamIndex].buffer->buffer,
+            destinations[streamIndex].buffer,
+            regionCount,
+            byteRegions
+        );
+    }
+    free(byteRegions);
+    return endSingleTimeCommands(vkrt, commandBuffer);
+}
 
-    result = updateAllDescriptorSets(vkrt);
-    if (result != VKRT_SUCCESS) {
-        restorePreviousGeometryState(vkrt, &previousState, meshBackup);
-        destroyOwnerAccelerationStructures(vkrt, ownerStates, ownerCount);
-        free(meshBackup);
-        free(ownerStates);
-        destroyGeometryBufferState(vkrt, &newState);
-        return result;
+static void packMeshIndices(const Mesh* mesh, uint32_t* outElements) {
+    if (mesh->info.indexFormat != VKRT_MESH_INDEX_FORMAT_UINT16) {
+        memcpy(outElements, mesh->indices, (size_t)mesh->info.indexCount * sizeof(uint32_t));
+        return;
     }
 
-    if (meshBackup) {
-        for (uint32_t i = 0; i < vkrt->core.meshCount; i++) {
-            if (!meshBackup[i].ownsGeometry) continue;
-            vkrtDestroyAccelerationStructureResources(vkrt, &meshBackup[i].bottomLevelAccelerationStructure);
-        }
+    uint32_t elementCount = meshIndexElementCount(&mesh->info);
+    for (uint32_t i = 0; i < elementCount; i++) {
+        uint32_t first = i * 2u;
+        uint32_t low = mesh->indices[first] & 0xffffu;
+        uint32_t high = first + 1u < mesh->info.indexCount ? mesh->indices[first + 1u] & 0xffffu : 0u;
+        outElements[i] = low | (high << 16u);
     }
-    destroyGeometryBufferState(vkrt, &previousState);
-    free(meshBackup);
-    free(ownerStates);
-    return VKRT_SUCCESS;
 }
 
 VKRT_Result vkrtScenePreparePendingGeometryUploads(VKRT* vkrt) {
@@ -665,37 +586,49 @@ VKRT_Result vkrtScenePreparePendingGeometryUploads(VKRT* vkrt) {
         Mesh* mesh = &vkrt->core.meshes[i];
         if (!mesh->ownsGeometry || !mesh->geometryUploadPending) continue;
 
+        VkDeviceSize positionBytes = (VkDeviceSize)mesh->info.vertexCount * kVertexPositionStride;
         VkDeviceSize vertexBytes = (VkDeviceSize)mesh->info.vertexCount * sizeof(ShaderVertex);
-        VkDeviceSize indexBytes = (VkDeviceSize)mesh->info.indexCount * sizeof(uint32_t);
-        VkDeviceSize stagingSize = vertexBytes + indexBytes;
+        VkDeviceSize indexBytes = (VkDeviceSize)meshIndexElementCount(&mesh->info) * sizeof(uint32_t);
+        VkDeviceSize stagingSize = positionBytes + vertexBytes + indexBytes;
+        vkrt->core.geometryLayout.uploadedBytes += stagingSize;
 
-        PendingGeometryUpload* upload = &update->geometryUploads[writeIndex];
-        upload->meshIndex = i;
-        upload->indexOffset = vertexBytes;
-        if (createBuffer(
-                vkrt,
-                stagingSize,
-                VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                &upload->stagingBuffer,
-                &upload->stagingMemory
-            ) != VKRT_SUCCESS) {
-            update->geometryUploadCount = writeIndex + 1u;
+        StagingAllocation staging = {0};
+        if (vkrtAllocateStaging(vkrt, stagingSize, &staging) != VKRT_SUCCESS) {
+            update->geometryUploadCount = writeIndex;
             return VKRT_ERROR_OPERATION_FAILED;
         }
 
-        void* mapped = NULL;
-        if (vkMapMemory(vkrt->core.device, upload->stagingMemory, 0, stagingSize, 0, &mapped) != VK_SUCCESS ||
-            !mapped) {
-            update->geometryUploadCount = writeIndex + 1u;
-            return VKRT_ERROR_OPERATION_FAILED;
-        }
-        ShaderVertex* mappedVertices = (ShaderVertex*)mapped;
+        PendingGeometryUpload* upload = &update->geometryUploads[writeIndex];
+        upload->meshIndex = i;
+        upload->stagingBuffer = staging.buffer;
+        upload->positionCopy = (VkBufferCopy){
+            .srcOffset = staging.offset,
+            .dstOffset = (VkDeviceSize)mesh->info.vertexBase * kVertexPositionStride,
+            .size = positionBytes,
+        };
+        upload->vertexCopy = (VkBufferCopy){
+            .srcOffset = staging.offset + positionBytes,
+            .dstOffset = (VkDeviceSize)mesh->info.vertexBase * sizeof(ShaderVertex),
+            .size = vertexBytes,
+        };
+        upload->indexCopy = (VkBufferCopy){
+            .srcOffset = staging.offset + positionBytes + vertexBytes,
+            .dstOffset = (VkDeviceSize)mesh->info.indexBase * sizeof(uint32_t),
+            .size = indexBytes,
+        };
+
+        float* mappedPositions = (float*)staging.mapped;
+        ShaderVertex* mappedVertices = (ShaderVertex*)((char*)staging.mapped + positionBytes);
         for (uint32_t vertexIndex = 0; vertexIndex < mesh->info.vertexCount; vertexIndex++) {
-            mappedVertices[vertexIndex] = packShaderVertex(&mesh->vertices[vertexIndex]);
+            const Vertex* vertex = &mesh->vertices[vertexIndex];
+            memcpy(
+                &mappedPositions[(size_t)vertexIndex * VKRT_VERTEX_POSITION_COMPONENTS],
+                vertex->position,
+                (size_t)kVertexPositionStride
+            );
+            mappedVertices[vertexIndex] = packShaderVertex(vertex);
         }
-        memcpy((char*)mapped + vertexBytes, mesh->indices, (size_t)indexBytes);
-        vkUnmapMemory(vkrt->core.device, upload->stagingMemory);
+        packMeshIndices(mesh, (uint32_t*)((char*)staging.mapped + positionBytes + vertexBytes));
 
         writeIndex++;
     }
@@ -758,34 +691,39 @@ VKRT_Result vkrtSceneUploadMeshDataBatch(VKRT* vkrt, const VKRT_MeshUpload* uplo
 
     vkrt->core.meshes = resized;
 
+    uint64_t* fingerprints = (uint64_t*)malloc(uploadCount * sizeof(uint64_t));
+    if (!fingerprints) {
+        shrinkMeshList(vkrt, previousCount);
+        LOG_ERROR("Failed to allocate mesh fingerprints");
+        return VKRT_ERROR_OUT_OF_MEMORY;
+    }
+    vkrtGeometryFingerprintBatch(uploads, uploadCount, fingerprints);
+
     for (size_t uploadIndex = 0; uploadIndex < uploadCount; uploadIndex++) {
         const VKRT_MeshUpload* upload = &uploads[uploadIndex];
         uint32_t meshIndex = previousCount + (uint32_t)uploadIndex;
         Mesh* mesh = &vkrt->core.meshes[meshIndex];
         initializeMeshDefaults(mesh, upload->vertexCount, upload->indexCount);
 
-        uint64_t fingerprint =
-            geometryFingerprint(upload->vertices, upload->vertexCount, upload->indices, upload->indexCount);
-        uint32_t duplicateIndex = findDuplicateGeometrySource(
-            vkrt,
-            meshIndex,
-            upload->vertices,
-            upload->vertexCount,
-            upload->indices,
-            upload->indexCount,
-            fingerprint
-        );
+        uint64_t fingerprint = fingerprints[uploadIndex];
+        uint32_t duplicateIndex =
+            vkrtGeometryDedupFind(&vkrt->core.geometryDedup, vkrt->core.meshes, upload, fingerprint);
 
         if (duplicateIndex == VKRT_INVALID_INDEX) {
-            if (!allocateMeshHostGeometry(upload, mesh)) {
-                releaseNewMeshRange(vkrt, previousCount, meshIndex);
+            int hostAllocated = allocateMeshHostGeometry(upload, mesh);
+            if (hostAllocated) {
+                mesh->geometryFingerprint = fingerprint;
+                mesh->geometrySource = meshIndex;
+                mesh->ownsGeometry = 1;
+            }
+            if (!hostAllocated ||
+                vkrtGeometryDedupInsert(&vkrt->core.geometryDedup, fingerprint, meshIndex) != VKRT_SUCCESS) {
+                releaseNewMeshRange(vkrt, previousCount, meshIndex + 1u);
                 shrinkMeshList(vkrt, previousCount);
+                free(fingerprints);
                 LOG_ERROR("Failed to allocate mesh host data");
                 return VKRT_ERROR_OPERATION_FAILED;
             }
-            mesh->geometryFingerprint = fingerprint;
-            mesh->geometrySource = meshIndex;
-            mesh->ownsGeometry = 1;
         } else {
             mesh->geometrySource = duplicateIndex;
             mesh->ownsGeometry = 0;
@@ -793,8 +731,15 @@ VKRT_Result vkrtSceneUploadMeshDataBatch(VKRT* vkrt, const VKRT_MeshUpload* uplo
         }
     }
 
+    free(fingerprints);
+
     vkrt->core.meshCount = newCount;
-    if (rebuildGeometryLayout(vkrt) != VKRT_SUCCESS) {
+    VkBuffer previousVertexBuffer = vkrt->core.vertexData.buffer;
+    VkBuffer previousIndexBuffer = vkrt->core.indexData.buffer;
+    VKRT_Result result = allocateNewMeshGeometry(vkrt, previousCount, newCount);
+    VKRT_Result descriptorResult = syncGeometryDescriptors(vkrt, previousVertexBuffer, previousIndexBuffer);
+    if (result == VKRT_SUCCESS) result = descriptorResult;
+    if (result != VKRT_SUCCESS) {
         releaseNewMeshRange(vkrt, previousCount, newCount);
         vkrt->core.meshCount = previousCount;
         shrinkMeshList(vkrt, previousCount);
@@ -807,38 +752,144 @@ VKRT_Result vkrtSceneUploadMeshDataBatch(VKRT* vkrt, const VKRT_MeshUpload* uplo
 
 VKRT_Result vkrtSceneRemoveMesh(VKRT* vkrt, uint32_t meshIndex) {
     if (!vkrt || meshIndex >= vkrt->core.meshCount) return VKRT_ERROR_INVALID_ARGUMENT;
-
-    Mesh* meshBackup = NULL;
-    uint32_t meshCountBackup = 0;
-    uint32_t selectedMeshIndexBackup = VKRT_INVALID_INDEX;
-    uint32_t selectionEnabledBackup = 0;
-    if (!backupMeshState(vkrt, &meshBackup, &meshCountBackup, &selectedMeshIndexBackup, &selectionEnabledBackup)) {
-        LOG_ERROR("Failed to back up mesh state before removal");
+    if (vkrtWaitForAllInFlightFrames(vkrt) != VKRT_SUCCESS) {
+        LOG_ERROR("Failed to wait for in-flight frames before removing mesh");
         return VKRT_ERROR_OPERATION_FAILED;
     }
 
     Mesh removed = vkrt->core.meshes[meshIndex];
     int32_t promotedIndex = findGeometryPromotionCandidate(vkrt, meshIndex);
     promoteRemovedGeometryOwner(vkrt, promotedIndex, &removed);
+    vkrtGeometryDedupRemoveMesh(&vkrt->core.geometryDedup, removed.geometryFingerprint, meshIndex, promotedIndex);
     removeMeshSlot(vkrt, meshIndex);
     remapGeometrySourcesAfterRemoval(vkrt, meshIndex, promotedIndex);
     updateSelectionAfterMeshRemoval(vkrt, meshIndex);
 
-    if (rebuildGeometryLayout(vkrt) != VKRT_SUCCESS) {
-        restoreMeshState(vkrt, meshBackup, meshCountBackup, selectedMeshIndexBackup, selectionEnabledBackup);
-        free(meshBackup);
-        LOG_ERROR("Geometry layout rebuild failed after mesh removal");
-        return VKRT_ERROR_OPERATION_FAILED;
-    }
-
+    vkrtReleaseEmissiveTriangleCache(&removed.emissiveCache);
     if (removed.ownsGeometry && promotedIndex < 0) {
+        releaseMeshGeometryRange(vkrt, &removed);
         vkrtDestroyAccelerationStructureResources(vkrt, &removed.bottomLevelAccelerationStructure);
         free(removed.vertices);
         free(removed.indices);
     }
 
     shrinkMeshList(vkrt, vkrt->core.meshCount);
-    free(meshBackup);
     markSceneMutation(vkrt);
     return VKRT_SUCCESS;
 }
+
+VKRT_Result vkrtSceneDefragmentGeometry(VKRT* vkrt) {
+    if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
+
+    GeometryLayout* layout = &vkrt->core.geometryLayout;
+    uint32_t vertexCapacity = queryPackedGeometryCapacity(&layout->vertices);
+    uint32_t indexCapacity = queryPackedGeometryCapacity(&layout->indices);
+    if (layout->vertices.capacity <= vertexCapacity && layout->indices.capacity <= indexCapacity) {
+        return VKRT_SUCCESS;
+    }
+
+    if (vkrtWaitForAllInFlightFrames(vkrt) != VKRT_SUCCESS) {
+        LOG_ERROR("Failed to wait for in-flight frames before defragmenting geometry");
+        return VKRT_ERROR_OPERATION_FAILED;
+    }
+
+    uint32_t ownerCount = 0;
+    for (uint32_t i = 0; i < vkrt->core.meshCount; i++) {
+        if (vkrt->core.meshes[i].ownsGeometry) ownerCount++;
+    }
+
+    GeometryHeapStream vertexStreams[K_GEOMETRY_HEAP_MAX_STREAMS];
+    GeometryHeapStream indexStreams[K_GEOMETRY_HEAP_MAX_STREAMS];
+    uint32_t vertexStreamCount = queryVertexHeapStreams(vkrt, vertexStreams);
+    uint32_t indexStreamCount = queryIndexHeapStreams(vkrt, indexStreams);
+    Buffer nextVertexStreams[K_GEOMETRY_HEAP_MAX_STREAMS] = {0};
+    Buffer nextIndexStreams[K_GEOMETRY_HEAP_MAX_STREAMS] = {0};
+    VkBufferCopy* vertexRegions = (VkBufferCopy*)calloc(ownerCount > 0u ? ownerCount : 1u, sizeof(VkBufferCopy));
+    VkBufferCopy* indexRegions = (VkBufferCopy*)calloc(ownerCount > 0u ? ownerCount : 1u, sizeof(VkBufferCopy));
+    if (!vertexRegions || !indexRegions) {
+        free(vertexRegions);
+        free(indexRegions);
+        return VKRT_ERROR_OUT_OF_MEMORY;
+    }
+
+    VKRT_Result result = VKRT_SUCCESS;
+    for (uint32_t i = 0; result == VKRT_SUCCESS && i < vertexStreamCount; i++) {
+        result = createGeometryHeapBuffer(vkrt, &vertexStreams[i], vertexCapacity, &nextVertexStreams[i]);
+    }
+    for (uint32_t i = 0; result == VKRT_SUCCESS && i < indexStreamCount; i++) {
+        result = createGeometryHeapBuffer(vkrt, &indexStreams[i], indexCapacity, &nextIndexStreams[i]);
+    }
+
+    // Regions are recorded in elements and scaled per stream when the copies are recorded.
+    uint32_t regionCount = 0;
+    uint32_t vertexCursor = 0;
+    uint32_t indexCursor = 0;
+    for (uint32_t i = 0; result == VKRT_SUCCESS && i < vkrt->core.meshCount; i++) {
+        const Mesh* mesh = &vkrt->core.meshes[i];
+        if (!mesh->ownsGeometry) continue;
+
+        uint32_t indexElementCount = meshIndexElementCount(&mesh->info);
+        vertexRegions[regionCount] = (VkBufferCopy){
+            .srcOffset = mesh->info.vertexBase,
+            .dstOffset = vertexCursor,
+            .size = mesh->info.vertexCount,
+        };
+        indexRegions[regionCount] = (VkBufferCopy){
+            .srcOffset = mesh->info.indexBase,
+            .dstOffset = indexCursor,
+            .size = indexElementCount,
+        };
+        vertexCursor += mesh->info.vertexCount;
+        indexCursor += indexElementCount;
+        regionCount++;
+    }
+
+    if (result == VKRT_SUCCESS) {
+        result =
+            copyGeometryRegions(vkrt, vertexStreams, nextVertexStreams, vertexStreamCount, vertexRegions, regionCount);
+    }
+    if (result == VKRT_SUCCESS) {
+        result = copyGeometryRegions(vkrt, indexStreams, nextIndexStreams, indexStreamCount, indexRegions, regionCount);
+    }
+    free(vertexRegions);
+    free(indexRegions);
+    if (result == VKRT_SUCCESS) {
+        result = vkrtGeometryRangeReset(&layout->vertices, vertexCapacity, vertexCursor);
+    }
+    if (result == VKRT_SUCCESS) {
+        result = vkrtGeometryRangeReset(&layout->indices, indexCapacity, indexCursor);
+    }
+    if (result != VKRT_SUCCESS) {
+        for (uint32_t i = 0; i < K_GEOMETRY_HEAP_MAX_STREAMS; i++) {
+            destroyBufferResources(vkrt, &nextVertexStreams[i]);
+            destroyBufferResources(vkrt, &nextIndexStreams[i]);
+        }
+        return result;
+    }
+
+    // Compacted ranges keep their BLASes: only the shader-visible bases move.
+    vertexCursor = 0;
+    indexCursor = 0;
+    for (uint32_t i = 0; i < vkrt->core.meshCount; i++) {
+        Mesh* mesh = &vkrt->core.meshes[i];
+        if (!mesh->ownsGeometry) continue;
+        mesh->info.vertexBase = vertexCursor;
+        mesh->info.indexBase = indexCursor;
+        vertexCursor += mesh->info.vertexCount;
+        indexCursor += meshIndexElementCount(&mesh->info);
+    }
+    syncDuplicateMeshRange(vkrt, 0, vkrt->core.meshCount);
+
+    for (uint32_t i = 0; i < vertexStreamCount; i++) {
+        destroyBufferResources(vkrt, vertexStreams[i].buffer);
+        *vertexStreams[i].buffer = nextVertexStreams[i];
+    }
+    for (uint32_t i = 0; i < indexStreamCount; i++) {
+        destroyBufferResources(vkrt, indexStreams[i].buffer);
+        *indexStreams[i].buffer = nextIndexStreams[i];
+    }
+
+    LOG_INFO("Defragmented geometry heap to %u vertices and %u index elements", vertexCapacity, indexCapacity);
+    vkrtMarkSceneResourcesDirty(vkrt);
+    return updateAllDescriptorSets(vkrt);
+}
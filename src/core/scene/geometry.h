@@ -17,3 +17,4 @@ VKRT_Result vkrtSceneUploadMeshData(
 );
 VKRT_Result vkrtSceneUploadMeshDataBatch(VKRT* vkrt, const VKRT_MeshUpload* uploads, size_t uploadCount);
 VKRT_Result vkrtSceneRemoveMesh(VKRT* vkrt, uint32_t meshIndex);
+VKRT_Result vkrtSceneDefragmentGeometry(VKRT* vkrt);
@@ -0,0 +1,291 @@
+#include "geometry_dedup.h"
+
+#include "constants.h"
+#include "job_pool.h"
+#include "vkrt_engine_types.h"
+#include "vkrt_types.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum {
+    K_GEOMETRY_FINGERPRINT_LANE_COUNT = 4,
+};
+
+static const uint64_t kGeometryHashPrime1 = 0x9E3779B185EBCA87ull;
+static const uint64_t kGeometryHashPrime2 = 0xC2B2AE3D27D4EB4Full;
+static const uint64_t kGeometryHashPrime3 = 0x165667B19E3779F9ull;
+static const uint64_t kGeometryHashPrime4 = 0x85EBCA77C2B2AE63ull;
+static const uint64_t kGeometryHashPrime5 = 0x27D4EB2F165667C5ull;
+static const uint64_t kGeometryFingerprintSeed = 1469598103934665603ull;
+static const uint64_t kGeometryFingerprintParallelBytes = 1024ull * 1024ull;
+static const uint32_t kGeometryDedupInitialCapacity = 64u;
+
+typedef struct GeometryFingerprintJob {
+    const VKRT_MeshUpload* uploads;
+    uint64_t* fingerprints;
+} GeometryFingerprintJob;
+
+static uint64_t rotateLeft64(uint64_t value, uint32_t shift) {
+    return (value << shift) | (value >> (64u - shift));
+}
+
+static uint64_t loadHashWord(const uint8_t* bytes) {
+    uint64_t word;
+    memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+static uint64_t hashRound(uint64_t accumulator, uint64_t input) {
+    accumulator += input * kGeometryHashPrime2;
+    accumulator = rotateLeft64(accumulator, 31u);
+    return accumulator * kGeometryHashPrime1;
+}
+
+static uint64_t mergeHashLane(uint64_t hash, uint64_t lane) {
+    hash ^= hashRound(0u, lane);
+    return hash * kGeometryHashPrime1 + kGeometryHashPrime4;
+}
+
+static uint64_t avalancheHash(uint64_t hash) {
+    hash ^= hash >> 33u;
+    hash *= kGeometryHashPrime2;
+    hash ^= hash >> 29u;
+    hash *= kGeometryHashPrime3;
+    hash ^= hash >> 32u;
+    return hash;
+}
+
+static uint64_t hashGeometryBytes(const void* bytes, size_t byteCount, uint64_t seed) {
+    const uint8_t* cursor = (const uint8_t*)bytes;
+    const uint8_t* end = cursor + byteCount;
+    const size_t stripeBytes = K_GEOMETRY_FINGERPRINT_LANE_COUNT * sizeof(uint64_t);
+
+    // Independent lanes over 32-byte stripes keep the multiplies off a single dependency chain.
+    uint64_t hash = seed + kGeometryHashPrime5;
+    if (byteCount >= stripeBytes) {
+        uint64_t lanes[K_GEOMETRY_FINGERPRINT_LANE_COUNT] = {
+            seed + kGeometryHashPrime1 + kGeometryHashPrime2,
+            seed + kGeometryHashPrime2,
+            seed,
+            seed - kGeometryHashPrime1,
+        };
+        for (; (size_t)(end - cursor) >= stripeBytes; cursor += stripeBytes) {
+            for (uint32_t lane = 0; lane < K_GEOMETRY_FINGERPRINT_LANE_COUNT; lane++) {
+                lanes[lane] = hashRound(lanes[lane], loadHashWord(cursor + lane * sizeof(uint64_t)));
+            }
+        }
+
+        hash = rotateLeft64(lanes[0], 1u) + rotateLeft64(lanes[1], 7u) + rotateLeft64(lanes[2], 12u) +
+               rotateLeft64(lanes[3], 18u);
+        for (uint32_t lane = 0; lane < K_GEOMETRY_FINGERPRINT_LANE_COUNT; lane++) {
+            hash = mergeHashLane(hash, lanes[lane]);
+        }
+    }
+
+    hash += (uint64_t)byteCount;
+    for (; (size_t)(end - cursor) >= sizeof(uint64_t); cursor += sizeof(uint64_t)) {
+        hash ^= hashRound(0u, loadHashWord(cursor));
+        hash = rotateLeft64(hash, 27u) * kGeometryHashPrime1 + kGeometryHashPrime4;
+    }
+    if ((size_t)(end - cursor) >= sizeof(uint32_t)) {
+        uint32_t word;
+        memcpy(&word, cursor, sizeof(word));
+        hash ^= (uint64_t)word * kGeometryHashPrime1;
+        hash = rotateLeft64(hash, 23u) * kGeometryHashPrime2 + kGeometryHashPrime3;
+        cursor += sizeof(uint32_t);
+    }
+    for (; cursor < end; cursor++) {
+        hash ^= (uint64_t)(*cursor) * kGeometryHashPrime5;
+        hash = rotateLeft64(hash, 11u) * kGeometryHashPrime1;
+    }
+    return avalancheHash(hash);
+}
+
+uint64_t vkrtGeometryFingerprint(
+    const Vertex* vertices,
+    size_t vertexCount,
+    const uint32_t* indices,
+    size_t indexCount
+) {
+    uint64_t hash = hashGeometryBytes(vertices, vertexCount * sizeof(Vertex), kGeometryFingerprintSeed ^ vertexCount);
+    return hashGeometryBytes(indices, indexCount * sizeof(uint32_t), hash ^ indexCount);
+}
+
+static int fingerprintUploadJob(void* userData, uint32_t jobIndex) {
+    const GeometryFingerprintJob* job = (const GeometryFingerprintJob*)userData;
+    const VKRT_MeshUpload* upload = &job->uploads[jobIndex];
+    job->fingerprints[jobIndex] =
+        vkrtGeometryFingerprint(upload->vertices, upload->vertexCount, upload->indices, upload->indexCount);
+    return 0;
+}
+
+void vkrtGeometryFingerprintBatch(const VKRT_MeshUpload* uploads, size_t uploadCount, uint64_t* outFingerprints) {
+    if (!uploads || !outFingerprints || uploadCount == 0 || uploadCount > UINT32_MAX) return;
+
+    uint64_t totalBytes = 0u;
+    for (size_t i = 0; i < uploadCount; i++) {
+        totalBytes += (uint64_t)uploads[i].vertexCount * sizeof(Vertex);
+        totalBytes += (uint64_t)uploads[i].indexCount * sizeof(uint32_t);
+    }
+
+    GeometryFingerprintJob job = {
+        .uploads = uploads,
+        .fingerprints = outFingerprints,
+    };
+    VKRT_JobPool* pool = totalBytes < kGeometryFingerprintParallelBytes ? NULL : vkrtJobPoolShared();
+    (void)vkrtJobPoolRun(pool, (uint32_t)uploadCount, fingerprintUploadJob, &job);
+}
+
+static uint32_t dedupHomeSlot(const GeometryDedupTable* table, uint64_t fingerprint) {
+    return (uint32_t)fingerprint & (table->capacity - 1u);
+}
+
+static void placeDedupEntry(GeometryDedupTable* table, uint64_t fingerprint, uint32_t owner) {
+    uint32_t mask = table->capacity - 1u;
+    uint32_t slot = dedupHomeSlot(table, fingerprint);
+    while (table->entries[slot].owner != VKRT_INVALID_INDEX) {
+        slot = (slot + 1u) & mask;
+    }
+    table->entries[slot].fingerprint = fingerprint;
+    table->entries[slot].owner = owner;
+    table->count++;
+}
+
+static VKRT_Result reserveDedupEntries(GeometryDedupTable* table, uint32_t requiredCount) {
+    // Keep the load factor at or below 3/4 so linear probe runs stay short.
+    if (table->entries && (uint64_t)requiredCount * 4u <= (uint64_t)table->capacity * 3u) return VKRT_SUCCESS;
+
+    uint32_t capacity = table->capacity > 0u ? table->capacity : kGeometryDedupInitialCapacity;
+    while ((uint64_t)requiredCount * 4u > (uint64_t)capacity * 3u) {
+        if (capacity > UINT32_MAX / 2u) return VKRT_ERROR_OUT_OF_MEMORY;
+        capacity *= 2u;
+    }
+
+    GeometryDedupEntry* entries = (GeometryDedupEntry*)malloc((size_t)capacity * sizeof(GeometryDedupEntry));
+    if (!entries) return VKRT_ERROR_OUT_OF_MEMORY;
+    for (uint32_t i = 0; i < capacity; i++) {
+        entries[i].fingerprint = 0u;
+        entries[i].owner = VKRT_INVALID_INDEX;
+    }
+
+    GeometryDedupTable previous = *table;
+    table->entries = entries;
+    table->capacity = capacity;
+    table->count = 0u;
+    for (uint32_t i = 0; i < previous.capacity; i++) {
+        if (previous.entries[i].owner == VKRT_INVALID_INDEX) continue;
+        placeDedupEntry(table, previous.entries[i].fingerprint, previous.entries[i].owner);
+    }
+    free(previous.entries);
+    return VKRT_SUCCESS;
+}
+
+static void eraseDedupSlot(GeometryDedupTable* table, uint32_t slot) {
+    uint32_t mask = table->capacity - 1u;
+    uint32_t hole = slot;
+    uint32_t next = (hole + 1u) & mask;
+
+    // Backward-shift deletion: pull later entries of the probe run into the hole instead of leaving tombstones.
+    while (table->entries[next].owner != VKRT_INVALID_INDEX) {
+        uint32_t home = dedupHomeSlot(table, table->entries[next].fingerprint);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            table->entries[hole] = table->entries[next];
+            hole = next;
+        }
+        next = (next + 1u) & mask;
+    }
+    table->entries[hole].fingerprint = 0u;
+    table->entries[hole].owner = VKRT_INVALID_INDEX;
+    table->count--;
+}
+
+static int32_t findDedupSlot(const GeometryDedupTable* table, uint64_t fingerprint, uint32_t owner) {
+    if (!table->entries || table->capacity == 0u) return -1;
+
+    uint32_t mask = table->capacity - 1u;
+    for (uint32_t slot = dedupHomeSlot(table, fingerprint); table->entries[slot].owner != VKRT_INVALID_INDEX;
+         slot = (slot + 1u) & mask) {
+        if (table->entries[slot].fingerprint == fingerprint && table->entries[slot].owner == owner) {
+            return (int32_t)slot;
+        }
+    }
+    return -1;
+}
+
+uint32_t vkrtGeometryDedupFind(
+    const GeometryDedupTable* table,
+    const Mesh* meshes,
+    const VKRT_MeshUpload* upload,
+    uint64_t fingerprint
+) {
+    if (!table || !table->entries || table->capacity == 0u || !meshes || !upload) return VKRT_INVALID_INDEX;
+    if (!upload->vertices || !upload->indices) return VKRT_INVALID_INDEX;
+
+    uint32_t mask = table->capacity - 1u;
+    for (uint32_t slot = dedupHomeSlot(table, fingerprint); table->entries[slot].owner != VKRT_INVALID_INDEX;
+         slot = (slot + 1u) & mask) {
+        const GeometryDedupEntry* entry = &table->entries[slot];
+        if (entry->fingerprint != fingerprint) continue;
+
+        const Mesh* owner = &meshes[entry->owner];
+        if (owner->info.vertexCount != (uint32_t)upload->vertexCount ||
+            owner->info.indexCount != (uint32_t)upload->indexCount) {
+            continue;
+        }
+        if (memcmp(owner->vertices, upload->vertices, upload->vertexCount * sizeof(Vertex)) != 0) continue;
+        if (memcmp(owner->indices, upload->indices, upload->indexCount * sizeof(uint32_t)) != 0) continue;
+        return entry->owner;
+    }
+    return VKRT_INVALID_INDEX;
+}
+
+VKRT_Result vkrtGeometryDedupInsert(GeometryDedupTable* table, uint64_t fingerprint, uint32_t owner) {
+    if (!table || owner == VKRT_INVALID_INDEX) return VKRT_ERROR_INVALID_ARGUMENT;
+
+    VKRT_Result result = reserveDedupEntries(table, table->count + 1u);
+    if (result != VKRT_SUCCESS) return result;
+    placeDedupEntry(table, fingerprint, owner);
+    return VKRT_SUCCESS;
+}
+
+void vkrtGeometryDedupRemove(GeometryDedupTable* table, uint64_t fingerprint, uint32_t owner) {
+    if (!table) return;
+
+    int32_t slot = findDedupSlot(table, fingerprint, owner);
+    if (slot >= 0) eraseDedupSlot(table, (uint32_t)slot);
+}
+
+void vkrtGeometryDedupRemoveMesh(
+    GeometryDedupTable* table,
+    uint64_t fingerprint,
+    uint32_t meshIndex,
+    int32_t promotedIndex
+) {
+    if (!table || !table->entries) return;
+
+    int32_t slot = findDedupSlot(table, fingerprint, meshIndex);
+    if (slot >= 0) {
+        if (promotedIndex >= 0) {
+            table->entries[slot].owner = (uint32_t)promotedIndex;
+        } else {
+            eraseDedupSlot(table, (uint32_t)slot);
+        }
+    }
+
+    // Owners are mesh indices, so everything past the removed slot shifts down by one.
+    for (uint32_t i = 0; i < table->capacity; i++) {
+        uint32_t owner = table->entries[i].owner;
+        if (owner != VKRT_INVALID_INDEX && owner > meshIndex) table->entries[i].owner = owner - 1u;
+    }
+}
+
+void vkrtGeometryDedupRelease(GeometryDedupTable* table) {
+    if (!table) return;
+    free(table->entries);
+    table->entries = NULL;
+    table->capacity = 0u;
+    table->count = 0u;
+}
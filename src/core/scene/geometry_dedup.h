@@ -0,0 +1,30 @@
+#pragma once
+
+#include "vkrt_internal.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+uint64_t vkrtGeometryFingerprint(
+    const Vertex* vertices,
+    size_t vertexCount,
+    const uint32_t* indices,
+    size_t indexCount
+);
+void vkrtGeometryFingerprintBatch(const VKRT_MeshUpload* uploads, size_t uploadCount, uint64_t* outFingerprints);
+
+uint32_t vkrtGeometryDedupFind(
+    const GeometryDedupTable* table,
+    const Mesh* meshes,
+    const VKRT_MeshUpload* upload,
+    uint64_t fingerprint
+);
+VKRT_Result vkrtGeometryDedupInsert(GeometryDedupTable* table, uint64_t fingerprint, uint32_t owner);
+void vkrtGeometryDedupRemove(GeometryDedupTable* table, uint64_t fingerprint, uint32_t owner);
+void vkrtGeometryDedupRemoveMesh(
+    GeometryDedupTable* table,
+    uint64_t fingerprint,
+    uint32_t meshIndex,
+    int32_t promotedIndex
+);
+void vkrtGeometryDedupRelease(GeometryDedupTable* table);
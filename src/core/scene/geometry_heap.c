@@ -0,0 +1,170 @@
+#include "geometry_heap.h"
+
+#include "constants.h"
+#include "vkrt_engine_types.h"
+#include "vkrt_types.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const uint32_t kGeometryRangeInitialFreeCapacity = 16u;
+static const uint32_t kGeometryHeapMinimumGrowth = 64u * 1024u;
+
+static VKRT_Result reserveFreeRanges(GeometryRangeAllocator* allocator, uint32_t requiredCount) {
+    if (allocator->freeRangeCapacity >= requiredCount) return VKRT_SUCCESS;
+
+    uint32_t capacity =
+        allocator->freeRangeCapacity > 0u ? allocator->freeRangeCapacity : kGeometryRangeInitialFreeCapacity;
+    while (capacity < requiredCount) {
+        if (capacity > UINT32_MAX / 2u) {
+            capacity = requiredCount;
+            break;
+        }
+        capacity *= 2u;
+    }
+
+    GeometryRange* resized = (GeometryRange*)realloc(allocator->freeRanges, (size_t)capacity * sizeof(GeometryRange));
+    if (!resized) return VKRT_ERROR_OUT_OF_MEMORY;
+
+    allocator->freeRanges = resized;
+    allocator->freeRangeCapacity = capacity;
+    return VKRT_SUCCESS;
+}
+
+static void removeFreeRange(GeometryRangeAllocator* allocator, uint32_t index) {
+    uint32_t tailCount = allocator->freeRangeCount - index - 1u;
+    if (tailCount > 0u) {
+        memmove(&allocator->freeRanges[index], &allocator->freeRanges[index + 1u], tailCount * sizeof(GeometryRange));
+    }
+    allocator->freeRangeCount--;
+}
+
+int vkrtGeometryRangeAllocate(GeometryRangeAllocator* allocator, uint32_t count, uint32_t* outOffset) {
+    if (!allocator || !outOffset || count == 0u) return 0;
+
+    // First fit keeps allocations packed toward the front, leaving the tail free for growth.
+    for (uint32_t i = 0; i < allocator->freeRangeCount; i++) {
+        GeometryRange* range = &allocator->freeRanges[i];
+        if (range->count < count) continue;
+
+        *outOffset = range->offset;
+        range->offset += count;
+        range->count -= count;
+        if (range->count == 0u) removeFreeRange(allocator, i);
+        allocator->usedCount += count;
+        return 1;
+    }
+    return 0;
+}
+
+VKRT_Result vkrtGeometryRangeFree(GeometryRangeAllocator* allocator, uint32_t offset, uint32_t count) {
+    if (!allocator || count == 0u) return VKRT_ERROR_INVALID_ARGUMENT;
+    if ((uint64_t)offset + count > allocator->capacity || count > allocator->usedCount) {
+        return VKRT_ERROR_INVALID_ARGUMENT;
+    }
+
+    uint32_t insertIndex = 0;
+    while (insertIndex < allocator->freeRangeCount && allocator->freeRanges[insertIndex].offset < offset) {
+        insertIndex++;
+    }
+
+    GeometryRange* previous = insertIndex > 0u ? &allocator->freeRanges[insertIndex - 1u] : NULL;
+    GeometryRange* next = insertIndex < allocator->freeRangeCount ? &allocator->freeRanges[insertIndex] : NULL;
+    uint8_t joinsPrevious = previous && previous->offset + previous->count == offset;
+    uint8_t joinsNext = next && offset + count == next->offset;
+
+    if (joinsPrevious && joinsNext) {
+        previous->count += count + next->count;
+        removeFreeRange(allocator, insertIndex);
+    } else if (joinsPrevious) {
+        previous->count += count;
+    } else if (joinsNext) {
+        next->offset = offset;
+        next->count += count;
+    } else {
+        VKRT_Result result = reserveFreeRanges(allocator, allocator->freeRangeCount + 1u);
+        if (result != VKRT_SUCCESS) return result;
+
+        uint32_t tailCount = allocator->freeRangeCount - insertIndex;
+        if (tailCount > 0u) {
+            memmove(
+                &allocator->freeRanges[insertIndex + 1u],
+                &allocator->freeRanges[insertIndex],
+                tailCount * sizeof(GeometryRange)
+            );
+        }
+        allocator->freeRanges[insertIndex] = (GeometryRange){.offset = offset, .count = count};
+        allocator->freeRangeCount++;
+    }
+
+    allocator->usedCount -= count;
+    return VKRT_SUCCESS;
+}
+
+uint32_t vkrtGeometryRangeGrowthTarget(const GeometryRangeAllocator* allocator, uint32_t count) {
+    if (!allocator) return 0u;
+
+    uint32_t tailFree = 0u;
+    if (allocator->freeRangeCount > 0u) {
+        const GeometryRange* tail = &allocator->freeRanges[allocator->freeRangeCount - 1u];
+        if (tail->offset + tail->count == allocator->capacity) tailFree = tail->count;
+    }
+
+    uint64_t required = (uint64_t)allocator->capacity + (count > tailFree ? count - tailFree : 0u);
+    uint64_t geometric = (uint64_t)allocator->capacity + allocator->capacity / 2u;
+    uint64_t minimum = (uint64_t)allocator->capacity + kGeometryHeapMinimumGrowth;
+    uint64_t target = required;
+    if (target < geometric) target = geometric;
+    if (target < minimum) target = minimum;
+
+    if (target > VKRT_INVALID_INDEX) target = required;
+    if (target > VKRT_INVALID_INDEX) return 0u;
+    return (uint32_t)target;
+}
+
+VKRT_Result vkrtGeometryRangeGrow(GeometryRangeAllocator* allocator, uint32_t capacity) {
+    if (!allocator || capacity < allocator->capacity) return VKRT_ERROR_INVALID_ARGUMENT;
+    if (capacity == allocator->capacity) return VKRT_SUCCESS;
+
+    uint32_t previousCapacity = allocator->capacity;
+    uint32_t addedCount = capacity - previousCapacity;
+    if (allocator->freeRangeCount > 0u) {
+        GeometryRange* tail = &allocator->freeRanges[allocator->freeRangeCount - 1u];
+        if (tail->offset + tail->count == previousCapacity) {
+            tail->count += addedCount;
+            allocator->capacity = capacity;
+            return VKRT_SUCCESS;
+        }
+    }
+
+    VKRT_Result result = reserveFreeRanges(allocator, allocator->freeRangeCount + 1u);
+    if (result != VKRT_SUCCESS) return result;
+
+    allocator->freeRanges[allocator->freeRangeCount++] =
+        (GeometryRange){.offset = previousCapacity, .count = addedCount};
+    allocator->capacity = capacity;
+    return VKRT_SUCCESS;
+}
+
+VKRT_Result vkrtGeometryRangeReset(GeometryRangeAllocator* allocator, uint32_t capacity, uint32_t usedCount) {
+    if (!allocator || usedCount > capacity) return VKRT_ERROR_INVALID_ARGUMENT;
+
+    allocator->freeRangeCount = 0u;
+    allocator->capacity = capacity;
+    allocator->usedCount = usedCount;
+    if (usedCount == capacity) return VKRT_SUCCESS;
+
+    VKRT_Result result = reserveFreeRanges(allocator, 1u);
+    if (result != VKRT_SUCCESS) return result;
+
+    allocator->freeRanges[0] = (GeometryRange){.offset = usedCount, .count = capacity - usedCount};
+    allocator->freeRangeCount = 1u;
+    return VKRT_SUCCESS;
+}
+
+void vkrtGeometryRangeRelease(GeometryRangeAllocator* allocator) {
+    if (!allocator) return;
+    free(allocator->freeRanges);
+    *allocator = (GeometryRangeAllocator){0};
+}
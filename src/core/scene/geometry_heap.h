@@ -0,0 +1,12 @@
+#pragma once
+
+#include "vkrt_internal.h"
+
+#include <stdint.h>
+
+int vkrtGeometryRangeAllocate(GeometryRangeAllocator* allocator, uint32_t count, uint32_t* outOffset);
+VKRT_Result vkrtGeometryRangeFree(GeometryRangeAllocator* allocator, uint32_t offset, uint32_t count);
+uint32_t vkrtGeometryRangeGrowthTarget(const GeometryRangeAllocator* allocator, uint32_t count);
+VKRT_Result vkrtGeometryRangeGrow(GeometryRangeAllocator* allocator, uint32_t capacity);
+VKRT_Result vkrtGeometryRangeReset(GeometryRangeAllocator* allocator, uint32_t capacity, uint32_t usedCount);
+void vkrtGeometryRangeRelease(GeometryRangeAllocator* allocator);
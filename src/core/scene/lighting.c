@@ -1,24 +1,35 @@
 #include "lighting.h"
 
 #include "../../../external/cglm/include/types.h"
+#include "alias_table.h"
 #include "buffer.h"
 #include "color.h"
 #include "constants.h"
 #include "debug.h"
-#include "scene.h"
+#include "job_pool.h"
 #include "state.h"
 #include "types.h"
 #include "vkrt_engine_types.h"
 #include "vkrt_types.h"
 #include "vulkan/vulkan_core.h"
 
+#include <float.h>
 #include <limits.h>
 #include <math.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <vec3.h>
 
+static const float kInvTwoPiSquared = 0.050660591821f;
+static const float kMinEnvironmentSelectionProbability = 0.1f;
+static const float kMaxEnvironmentSelectionProbability = 0.9f;
+static const float kSimilarityTolerance = 1e-4f;
+static const uint64_t kEmissiveCacheParallelTriangles = 64ull * 1024ull;
+static const uint64_t kLayoutKeyOffset = 14695981039346656037ull;
+static const uint64_t kLayoutKeyPrime = 1099511628211ull;
+
 typedef struct LightBufferState {
     Buffer sceneEmissiveMeshData;
     Buffer sceneEmissiveTriangleData;
@@ -26,8 +37,15 @@ typedef struct LightBufferState {
     Buffer sceneMeshAliasIdx;
     Buffer sceneTriAliasQ;
     Buffer sceneTriAliasIdx;
+    Buffer sceneLightBVHData;
+    Buffer sceneEnvironmentAliasQ;
+    Buffer sceneEnvironmentAliasIdx;
+    Buffer sceneEnvironmentPmf;
     uint32_t emissiveMeshCount;
     uint32_t emissiveTriangleCount;
+    uint32_t environmentSamplingWidth;
+    uint32_t environmentSamplingHeight;
+    float environmentSelectionProbability;
 } LightBufferState;
 
 typedef struct EmissiveLightCounts {
@@ -35,6 +53,41 @@ typedef struct EmissiveLightCounts {
     uint32_t emissiveTriangleCount;
 } EmissiveLightCounts;
 
+// Triangle areas are measured in object space for similarity transforms, where every triangle scales by the same
+// factor, and in world space otherwise. Only the second kind has to be rebuilt when the transform changes.
+typedef struct EmissiveAreaBasis {
+    float linear[3][3];
+    float areaScale;
+    uint8_t worldSpace;
+} EmissiveAreaBasis;
+
+typedef struct EmissiveCandidate {
+    uint32_t meshIndex;
+    float emissionWeight;
+    EmissiveAreaBasis basis;
+} EmissiveCandidate;
+
+typedef struct EmissiveCacheRebuild {
+    uint32_t candidateIndex;
+    VKRT_Result result;
+} EmissiveCacheRebuild;
+
+typedef struct EmissiveCacheJob {
+    VKRT* vkrt;
+    const EmissiveCandidate* candidates;
+    EmissiveCacheRebuild* rebuilds;
+} EmissiveCacheJob;
+
+typedef struct LightBVHPrimitive {
+    float boundsMin[3];
+    float boundsMax[3];
+    float axis[3];
+    float cosTheta;
+    float power;
+    float sortKey;
+    uint32_t emitterIndex;
+} LightBVHPrimitive;
+
 typedef struct LightBuildScratch {
     EmissiveMesh* emissiveMeshes;
     EmissiveTriangle* emissiveTriangles;
@@ -43,13 +96,14 @@ typedef struct LightBuildScratch {
     float* triAliasQ;
     uint32_t* triAliasIdx;
     float* meshWeights;
-    float* triPmfScratch;
+    float* meshPmfScratch;
     uint32_t* sourceMeshIndices;
-    uint32_t meshCapacity;
-    uint32_t triangleCapacity;
+    LightBVHNode* lightBVHNodes;
+    uint32_t lightBVHNodeCount;
     uint32_t emissiveMeshCount;
     uint32_t emissiveTriangleCount;
     float totalSelectionWeight;
+    uint8_t reuseTriangles;
 } LightBuildScratch;
 
 static float materialEmissionWeight(const Material* material) {
@@ -66,15 +120,6 @@ static int materialEligibleForDirectLightSampling(const MeshInfo* meshInfo, cons
     return material->alphaMode == VKRT_MATERIAL_ALPHA_MODE_OPAQUE;
 }
 
-static void transformPosition(const VkTransformMatrixKHR* transform, const vec4 position, vec3 outWorld) {
-    outWorld[0] = (transform->matrix[0][0] * position[0]) + (transform->matrix[0][1] * position[1]) +
-                  (transform->matrix[0][2] * position[2]) + transform->matrix[0][3];
-    outWorld[1] = (transform->matrix[1][0] * position[0]) + (transform->matrix[1][1] * position[1]) +
-                  (transform->matrix[1][2] * position[2]) + transform->matrix[1][3];
-    outWorld[2] = (transform->matrix[2][0] * position[0]) + (transform->matrix[2][1] * position[1]) +
-                  (transform->matrix[2][2] * position[2]) + transform->matrix[2][3];
-}
-
 static void destroyLightBufferState(VKRT* vkrt, LightBufferState* state) {
     destroyBufferResources(vkrt, &state->sceneEmissiveMeshData);
     destroyBufferResources(vkrt, &state->sceneEmissiveTriangleData);
@@ -82,8 +127,15 @@ static void destroyLightBufferState(VKRT* vkrt, LightBufferState* state) {
     destroyBufferResources(vkrt, &state->sceneMeshAliasIdx);
     destroyBufferResources(vkrt, &state->sceneTriAliasQ);
     destroyBufferResources(vkrt, &state->sceneTriAliasIdx);
+    destroyBufferResources(vkrt, &state->sceneLightBVHData);
+    destroyBufferResources(vkrt, &state->sceneEnvironmentAliasQ);
+    destroyBufferResources(vkrt, &state->sceneEnvironmentAliasIdx);
+    destroyBufferResources(vkrt, &state->sceneEnvironmentPmf);
     state->emissiveMeshCount = 0;
     state->emissiveTriangleCount = 0;
+    state->environmentSamplingWidth = 0;
+    state->environmentSamplingHeight = 0;
+    state->environmentSelectionProbability = 0.0f;
 }
 
 static void applyLightBufferState(VKRT* vkrt, const LightBufferState* state) {
@@ -93,11 +145,21 @@ static void applyLightBufferState(VKRT* vkrt, const LightBufferState* state) {
     vkrt->core.sceneMeshAliasIdx = state->sceneMeshAliasIdx;
     vkrt->core.sceneTriAliasQ = state->sceneTriAliasQ;
     vkrt->core.sceneTriAliasIdx = state->sceneTriAliasIdx;
+    vkrt->core.sceneLightBVHData = state->sceneLightBVHData;
+    vkrt->core.sceneEnvironmentAliasQ = state->sceneEnvironmentAliasQ;
+    vkrt->core.sceneEnvironmentAliasIdx = state->sceneEnvironmentAliasIdx;
+    vkrt->core.sceneEnvironmentPmf = state->sceneEnvironmentPmf;
     vkrt->core.emissiveMeshCount = state->emissiveMeshCount;
     vkrt->core.emissiveTriangleCount = state->emissiveTriangleCount;
     if (vkrt->core.sceneData) {
-        vkrt->core.sceneData->emissiveMeshCount = state->emissiveMeshCount;
-        vkrt->core.sceneData->emissiveTriangleCount = state->emissiveTriangleCount;
+        SceneData* sceneData = vkrt->core.sceneData;
+        sceneData->emissiveMeshCount = state->emissiveMeshCount;
+        sceneData->emissiveTriangleCount = state->emissiveTriangleCount;
+        sceneData->environmentSelectionProbability = state->environmentSelectionProbability;
+        sceneData->environmentSamplingWidth = state->environmentSamplingWidth;
+        sceneData->environmentSamplingHeight = state->environmentSamplingHeight;
+        sceneData->environmentSamplingPdfScale = (float)state->environmentSamplingWidth *
+                                                 (float)state->environmentSamplingHeight * kInvTwoPiSquared;
     }
 }
 
@@ -105,64 +167,6 @@ static int canAllocateArray(uint32_t count, size_t elementSize) {
     return elementSize == 0 || (size_t)count <= (SIZE_MAX / elementSize);
 }
 
-static int buildAliasTable(const float* pmf, uint32_t count, float* outQ, uint32_t* outIdx) {
-    if (count == 0) return 1;
-
-    float* scaled = (float*)malloc(sizeof(float) * count);
-    uint32_t* smallBin = (uint32_t*)malloc(sizeof(uint32_t) * count);
-    uint32_t* largeBin = (uint32_t*)malloc(sizeof(uint32_t) * count);
-    if (!scaled || !smallBin || !largeBin) {
-        free(scaled);
-        free(smallBin);
-        free(largeBin);
-        return 0;
-    }
-
-    uint32_t smallCount = 0;
-    uint32_t largeCount = 0;
-
-    for (uint32_t i = 0; i < count; ++i) {
-        scaled[i] = pmf[i] * (float)count;
-        if (scaled[i] < 1.0f) {
-            smallBin[smallCount++] = i;
-        } else {
-            largeBin[largeCount++] = i;
-        }
-    }
-
-    while (smallCount > 0 && largeCount > 0) {
-        uint32_t smallIndex = smallBin[--smallCount];
-        uint32_t largeIndex = largeBin[--largeCount];
-
-        outQ[smallIndex] = scaled[smallIndex];
-        outIdx[smallIndex] = largeIndex;
-
-        scaled[largeIndex] = scaled[largeIndex] + scaled[smallIndex] - 1.0f;
-        if (scaled[largeIndex] < 1.0f) {
-            smallBin[smallCount++] = largeIndex;
-        } else {
-            largeBin[largeCount++] = largeIndex;
-        }
-    }
-
-    while (largeCount > 0) {
-        uint32_t largeIndex = largeBin[--largeCount];
-        outQ[largeIndex] = 1.0f;
-        outIdx[largeIndex] = largeIndex;
-    }
-
-    while (smallCount > 0) {
-        uint32_t smallIndex = smallBin[--smallCount];
-        outQ[smallIndex] = 1.0f;
-        outIdx[smallIndex] = smallIndex;
-    }
-
-    free(scaled);
-    free(smallBin);
-    free(largeBin);
-    return 1;
-}
-
 static VKRT_Result uploadLightBuffer(VKRT* vkrt, const void* data, VkDeviceSize size, Buffer* outBuffer) {
     return createDeviceBufferFromData(
         vkrt,
@@ -209,14 +213,19 @@ static void clearMeshLightPdfAreas(VKRT* vkrt) {
     if (!vkrt) return;
     for (uint32_t i = 0; i < vkrt->core.meshCount; i++) {
         vkrt->core.meshes[i].info.lightPdfArea = 0.0f;
+        vkrt->core.meshes[i].info.lightEmitterOffset = 0u;
     }
 }
 
-static VKRT_Result allocateLightBuildScratch(const EmissiveLightCounts* counts, LightBuildScratch* scratch) {
-    if (!counts || !scratch) return VKRT_ERROR_INVALID_ARGUMENT;
+static VKRT_Result allocateLightBuildScratch(
+    uint32_t emissiveMeshCount,
+    uint32_t emissiveTriangleCount,
+    LightBuildScratch* scratch
+) {
+    if (!scratch) return VKRT_ERROR_INVALID_ARGUMENT;
 
-    uint32_t allocMeshCount = counts->emissiveMeshCount > 0u ? counts->emissiveMeshCount : 1u;
-    uint32_t allocTriangleCount = counts->emissiveTriangleCount > 0u ? counts->emissiveTriangleCount : 1u;
+    uint32_t allocMeshCount = emissiveMeshCount > 0u ? emissiveMeshCount : 1u;
+    uint32_t allocTriangleCount = emissiveTriangleCount > 0u ? emissiveTriangleCount : 1u;
     if (!canAllocateArray(allocMeshCount, sizeof(EmissiveMesh)) ||
         !canAllocateArray(allocTriangleCount, sizeof(EmissiveTriangle)) ||
         !canAllocateArray(allocMeshCount, sizeof(float)) || !canAllocateArray(allocTriangleCount, sizeof(float)) ||
@@ -234,14 +243,12 @@ static VKRT_Result allocateLightBuildScratch(const EmissiveLightCounts* counts,
         .triAliasQ = (float*)calloc(allocTriangleCount, sizeof(float)),
         .triAliasIdx = (uint32_t*)calloc(allocTriangleCount, sizeof(uint32_t)),
         .meshWeights = (float*)calloc(allocMeshCount, sizeof(float)),
-        .triPmfScratch = (float*)calloc(allocTriangleCount, sizeof(float)),
+        .meshPmfScratch = (float*)calloc(allocMeshCount, sizeof(float)),
         .sourceMeshIndices = (uint32_t*)calloc(allocMeshCount, sizeof(uint32_t)),
-        .meshCapacity = allocMeshCount,
-        .triangleCapacity = allocTriangleCount,
     };
 
     if (!scratch->emissiveMeshes || !scratch->emissiveTriangles || !scratch->meshAliasQ || !scratch->meshAliasIdx ||
-        !scratch->triAliasQ || !scratch->triAliasIdx || !scratch->meshWeights || !scratch->triPmfScratch ||
+        !scratch->triAliasQ || !scratch->triAliasIdx || !scratch->meshWeights || !scratch->meshPmfScratch ||
         !scratch->sourceMeshIndices) {
         LOG_ERROR("Failed to allocate emissive light staging buffers");
         return VKRT_ERROR_OUT_OF_MEMORY;
@@ -259,157 +266,392 @@ static void freeLightBuildScratch(LightBuildScratch* scratch) {
     free(scratch->triAliasQ);
     free(scratch->triAliasIdx);
     free(scratch->meshWeights);
-    free(scratch->triPmfScratch);
+    free(scratch->meshPmfScratch);
     free(scratch->sourceMeshIndices);
+    free(scratch->lightBVHNodes);
     *scratch = (LightBuildScratch){0};
 }
 
-static VKRT_Result appendMeshEmissiveTriangles(
+void vkrtReleaseEmissiveTriangleCache(EmissiveTriangleCache* cache) {
+    if (!cache) return;
+
+    free(cache->triangles);
+    free(cache->aliasQ);
+    free(cache->aliasIdx);
+    free(cache->clusters);
+    *cache = (EmissiveTriangleCache){0};
+}
+
+static int nearlyEqual(float a, float b, float scale) {
+    return fabsf(a - b) <= kSimilarityTolerance * scale;
+}
+
+static void queryEmissiveAreaBasis(const Mesh* mesh, EmissiveAreaBasis* outBasis) {
+    vec3 columns[3];
+    for (int columnIndex = 0; columnIndex < 3; columnIndex++) {
+        for (int rowIndex = 0; rowIndex < 3; rowIndex++) {
+            columns[columnIndex][rowIndex] = mesh->worldTransform[columnIndex][rowIndex];
+        }
+    }
+
+    float scaleSquared = glm_vec3_dot(columns[0], columns[0]);
+    int similarity = scaleSquared > 0.0f &&
+                     nearlyEqual(glm_vec3_dot(columns[1], columns[1]), scaleSquared, scaleSquared) &&
+                     nearlyEqual(glm_vec3_dot(columns[2], columns[2]), scaleSquared, scaleSquared) &&
+                     nearlyEqual(glm_vec3_dot(columns[0], columns[1]), 0.0f, scaleSquared) &&
+                     nearlyEqual(glm_vec3_dot(columns[0], columns[2]), 0.0f, scaleSquared) &&
+                     nearlyEqual(glm_vec3_dot(columns[1], columns[2]), 0.0f, scaleSquared);
+
+    *outBasis = (EmissiveAreaBasis){0};
+    for (int rowIndex = 0; rowIndex < 3; rowIndex++) {
+        for (int columnIndex = 0; columnIndex < 3; columnIndex++) {
+            outBasis->linear[rowIndex][columnIndex] =
+                similarity ? (rowIndex == columnIndex ? 1.0f : 0.0f) : columns[columnIndex][rowIndex];
+        }
+    }
+    outBasis->areaScale = similarity ? scaleSquared : 1.0f;
+    outBasis->worldSpace = similarity ? 0u : 1u;
+}
+
+static int emissiveCacheMatchesBasis(const EmissiveTriangleCache* cache, const EmissiveAreaBasis* basis) {
+    if (cache->serial == 0u || cache->worldSpaceAreas != basis->worldSpace) return 0;
+    return !basis->worldSpace || memcmp(cache->areaBasis, basis->linear, sizeof(cache->areaBasis)) == 0;
+}
+
+static void applyAreaBasis(const EmissiveAreaBasis* basis, const vec3 vector, vec3 outVector) {
+    for (int rowIndex = 0; rowIndex < 3; rowIndex++) {
+        outVector[rowIndex] = (basis->linear[rowIndex][0] * vector[0]) + (basis->linear[rowIndex][1] * vector[1]) +
+                              (basis->linear[rowIndex][2] * vector[2]);
+    }
+}
+
+static void queryEmissiveTriangleNormal(
+    const EmissiveAreaBasis* basis,
+    const EmissiveTriangle* triangle,
+    vec3 outNormal
+) {
+    vec3 edge1 = {triangle->e1Pad[0], triangle->e1Pad[1], triangle->e1Pad[2]};
+    vec3 edge2 = {triangle->e2Pad[0], triangle->e2Pad[1], triangle->e2Pad[2]};
+    vec3 basisEdge1;
+    vec3 basisEdge2;
+    applyAreaBasis(basis, edge1, basisEdge1);
+    applyAreaBasis(basis, edge2, basisEdge2);
+    glm_vec3_cross(basisEdge1, basisEdge2, outNormal);
+}
+
+static void growBounds(float boundsMin[3], float boundsMax[3], const float point[3]) {
+    for (int axis = 0; axis < 3; axis++) {
+        boundsMin[axis] = fminf(boundsMin[axis], point[axis]);
+        boundsMax[axis] = fmaxf(boundsMax[axis], point[axis]);
+    }
+}
+
+// Emitters are two-sided, so the cone only has to cover each normal up to sign and never needs more than a
+// hemisphere: a cosine of zero already covers every direction.
+static void buildEmissiveNormalCone(
+    const EmissiveAreaBasis* basis,
+    const EmissiveTriangle* triangles,
+    uint32_t triangleCount,
+    EmissiveTriangleCluster* cluster
+) {
+    vec3 axis = GLM_VEC3_ZERO_INIT;
+    for (uint32_t triangleIndex = 0; triangleIndex < triangleCount; triangleIndex++) {
+        vec3 normal;
+        queryEmissiveTriangleNormal(basis, &triangles[triangleIndex], normal);
+        if (glm_vec3_dot(axis, normal) < 0.0f) {
+            glm_vec3_sub(axis, normal, axis);
+        } else {
+            glm_vec3_add(axis, normal, axis);
+        }
+    }
+
+    float axisLength = glm_vec3_norm(axis);
+    if (!(axisLength > 0.0f)) {
+        glm_vec3_copy((vec3){0.0f, 0.0f, 1.0f}, cluster->normalAxis);
+        cluster->normalCosTheta = 0.0f;
+        return;
+    }
+    glm_vec3_scale(axis, 1.0f / axisLength, axis);
+
+    float cosTheta = 1.0f;
+    for (uint32_t triangleIndex = 0; triangleIndex < triangleCount; triangleIndex++) {
+        vec3 normal;
+        queryEmissiveTriangleNormal(basis, &triangles[triangleIndex], normal);
+        float normalLength = glm_vec3_norm(normal);
+        if (!(normalLength > 0.0f)) continue;
+        cosTheta = fminf(cosTheta, fabsf(glm_vec3_dot(axis, normal)) / normalLength);
+    }
+    glm_vec3_copy(axis, cluster->normalAxis);
+    cluster->normalCosTheta = fmaxf(cosTheta, 0.0f);
+}
+
+// Each run of VKRT_LIGHT_CLUSTER_TRIANGLE_COUNT source triangles becomes one cluster, so a hit's primitive index
+// finds its cluster by division. Triangles stay in source order and each cluster gets its own alias table.
+static VKRT_Result buildEmissiveTriangleCache(
     const Mesh* mesh,
-    LightBuildScratch* scratch,
-    uint32_t* outTriangleOffset,
-    uint32_t* outValidTriangleCount,
-    float* outTotalArea
+    const EmissiveAreaBasis* basis,
+    EmissiveTriangleCache* cache
 ) {
-    if (!mesh || !scratch || !outTriangleOffset || !outValidTriangleCount || !outTotalArea) {
-        return VKRT_ERROR_INVALID_ARGUMENT;
+    vkrtReleaseEmissiveTriangleCache(cache);
+
+    uint32_t triangleCapacity = mesh->info.indexCount / 3u;
+    uint32_t clusterCount =
+        (triangleCapacity + VKRT_LIGHT_CLUSTER_TRIANGLE_COUNT - 1u) / VKRT_LIGHT_CLUSTER_TRIANGLE_COUNT;
+    cache->triangles = (EmissiveTriangle*)malloc((size_t)triangleCapacity * sizeof(EmissiveTriangle));
+    cache->aliasQ = (float*)malloc((size_t)triangleCapacity * sizeof(float));
+    cache->aliasIdx = (uint32_t*)malloc((size_t)triangleCapacity * sizeof(uint32_t));
+    cache->clusters = (EmissiveTriangleCluster*)calloc(clusterCount, sizeof(EmissiveTriangleCluster));
+    float* pmf = (float*)malloc((size_t)triangleCapacity * sizeof(float));
+    if (!cache->triangles || !cache->aliasQ || !cache->aliasIdx || !cache->clusters || !pmf) {
+        free(pmf);
+        vkrtReleaseEmissiveTriangleCache(cache);
+        LOG_ERROR("Failed to allocate emissive triangle cache");
+        return VKRT_ERROR_OUT_OF_MEMORY;
     }
 
-    uint32_t triangleCount = mesh->info.indexCount / 3u;
-    VkTransformMatrixKHR worldTransform = getMeshWorldTransform(mesh);
-    uint32_t triangleOffset = scratch->emissiveTriangleCount;
+    uint32_t triangleCount = 0u;
     float totalArea = 0.0f;
+    glm_vec3_copy((vec3){FLT_MAX, FLT_MAX, FLT_MAX}, cache->boundsMin);
+    glm_vec3_copy((vec3){-FLT_MAX, -FLT_MAX, -FLT_MAX}, cache->boundsMax);
+    for (uint32_t triangleIndex = 0; triangleIndex < triangleCapacity; triangleIndex++) {
+        EmissiveTriangleCluster* cluster = &cache->clusters[triangleIndex / VKRT_LIGHT_CLUSTER_TRIANGLE_COUNT];
+        if (triangleIndex % VKRT_LIGHT_CLUSTER_TRIANGLE_COUNT == 0u) {
+            cluster->firstTriangle = triangleCount;
+            glm_vec3_copy((vec3){FLT_MAX, FLT_MAX, FLT_MAX}, cluster->boundsMin);
+            glm_vec3_copy((vec3){-FLT_MAX, -FLT_MAX, -FLT_MAX}, cluster->boundsMax);
+        }
 
-    for (uint32_t triangleIndex = 0; triangleIndex < triangleCount; triangleIndex++) {
         uint32_t index0 = mesh->indices[(triangleIndex * 3u) + 0u];
         uint32_t index1 = mesh->indices[(triangleIndex * 3u) + 1u];
         uint32_t index2 = mesh->indices[(triangleIndex * 3u) + 2u];
         if (index0 >= mesh->info.vertexCount || index1 >= mesh->info.vertexCount || index2 >= mesh->info.vertexCount) {
             continue;
         }
-        if (scratch->emissiveTriangleCount >= scratch->triangleCapacity) {
-            LOG_ERROR("Emissive triangle staging overflow");
-            return VKRT_ERROR_OPERATION_FAILED;
-        }
-
-        vec3 position0;
-        vec3 position1;
-        vec3 position2;
-        transformPosition(&worldTransform, mesh->vertices[index0].position, position0);
-        transformPosition(&worldTransform, mesh->vertices[index1].position, position1);
-        transformPosition(&worldTransform, mesh->vertices[index2].position, position2);
 
+        const float* position0 = mesh->vertices[index0].position;
         vec3 edge1;
         vec3 edge2;
+        for (int axis = 0; axis < 3; axis++) {
+            edge1[axis] = mesh->vertices[index1].position[axis] - position0[axis];
+            edge2[axis] = mesh->vertices[index2].position[axis] - position0[axis];
+        }
+
+        vec3 basisEdge1;
+        vec3 basisEdge2;
         vec3 crossProduct;
-        glm_vec3_sub(position1, position0, edge1);
-        glm_vec3_sub(position2, position0, edge2);
-        glm_vec3_cross(edge1, edge2, crossProduct);
+        applyAreaBasis(basis, edge1, basisEdge1);
+        applyAreaBasis(basis, edge2, basisEdge2);
+        glm_vec3_cross(basisEdge1, basisEdge2, crossProduct);
         float area = 0.5f * glm_vec3_norm(crossProduct);
-        if (area <= 0.0f) continue;
-
-        EmissiveTriangle triangleGPU = {0};
-        triangleGPU.v0Area[0] = position0[0];
-        triangleGPU.v0Area[1] = position0[1];
-        triangleGPU.v0Area[2] = position0[2];
-        triangleGPU.v0Area[3] = area;
-        triangleGPU.e1Pad[0] = edge1[0];
-        triangleGPU.e1Pad[1] = edge1[1];
-        triangleGPU.e1Pad[2] = edge1[2];
-        triangleGPU.e2Pad[0] = edge2[0];
-        triangleGPU.e2Pad[1] = edge2[1];
-        triangleGPU.e2Pad[2] = edge2[2];
-
-        scratch->emissiveTriangles[scratch->emissiveTriangleCount++] = triangleGPU;
+        if (!(area > 0.0f)) continue;
+
+        EmissiveTriangle* triangle = &cache->triangles[triangleCount++];
+        *triangle = (EmissiveTriangle){0};
+        for (int axis = 0; axis < 3; axis++) {
+            triangle->v0Area[axis] = position0[axis];
+            triangle->e1Pad[axis] = edge1[axis];
+            triangle->e2Pad[axis] = edge2[axis];
+        }
+        triangle->v0Area[3] = area;
         totalArea += area;
+        cluster->triangleCount++;
+        cluster->area += area;
+        growBounds(cluster->boundsMin, cluster->boundsMax, position0);
+        growBounds(cluster->boundsMin, cluster->boundsMax, mesh->vertices[index1].position);
+        growBounds(cluster->boundsMin, cluster->boundsMax, mesh->vertices[index2].position);
     }
 
-    *outTriangleOffset = triangleOffset;
-    *outValidTriangleCount = scratch->emissiveTriangleCount - triangleOffset;
-    *outTotalArea = totalArea;
+    for (uint32_t clusterIndex = 0; clusterIndex < clusterCount; clusterIndex++) {
+        EmissiveTriangleCluster* cluster = &cache->clusters[clusterIndex];
+        if (cluster->triangleCount == 0u) continue;
+
+        growBounds(cache->boundsMin, cache->boundsMax, cluster->boundsMin);
+        growBounds(cache->boundsMin, cache->boundsMax, cluster->boundsMax);
+        buildEmissiveNormalCone(basis, &cache->triangles[cluster->firstTriangle], cluster->triangleCount, cluster);
+
+        float invClusterArea = 1.0f / cluster->area;
+        for (uint32_t i = 0; i < cluster->triangleCount; i++) {
+            pmf[cluster->firstTriangle + i] = cache->triangles[cluster->firstTriangle + i].v0Area[3] * invClusterArea;
+        }
+        if (!vkrtBuildAliasTable(
+                &pmf[cluster->firstTriangle],
+                cluster->triangleCount,
+                &cache->aliasQ[cluster->firstTriangle],
+                &cache->aliasIdx[cluster->firstTriangle]
+            )) {
+            free(pmf);
+            vkrtReleaseEmissiveTriangleCache(cache);
+            LOG_ERROR("Failed to build emissive triangle alias table");
+            return VKRT_ERROR_OPERATION_FAILED;
+        }
+    }
+    free(pmf);
+
+    cache->triangleCount = triangleCount;
+    cache->clusterCount = clusterCount;
+    cache->totalArea = totalArea;
+    cache->worldSpaceAreas = basis->worldSpace;
+    memcpy(cache->areaBasis, basis->linear, sizeof(cache->areaBasis));
     return VKRT_SUCCESS;
 }
 
-static VKRT_Result appendEmissiveMesh(
-    VKRT* vkrt,
-    uint32_t meshIndex,
-    const Material* material,
-    LightBuildScratch* scratch
+static int buildEmissiveCacheJob(void* userData, uint32_t jobIndex) {
+    const EmissiveCacheJob* job = (const EmissiveCacheJob*)userData;
+    EmissiveCacheRebuild* rebuild = &job->rebuilds[jobIndex];
+    const EmissiveCandidate* candidate = &job->candidates[rebuild->candidateIndex];
+    Mesh* mesh = &job->vkrt->core.meshes[candidate->meshIndex];
+    rebuild->result = buildEmissiveTriangleCache(mesh, &candidate->basis, &mesh->emissiveCache);
+    return rebuild->result == VKRT_SUCCESS ? 0 : -1;
+}
+
+static VKRT_Result collectEmissiveCandidates(
+    const VKRT* vkrt,
+    EmissiveCandidate* candidates,
+    uint32_t capacity,
+    uint32_t* outCount
 ) {
-    if (!vkrt || !material || !scratch) return VKRT_ERROR_INVALID_ARGUMENT;
+    uint32_t count = 0u;
+    for (uint32_t meshIndex = 0; meshIndex < vkrt->core.meshCount; meshIndex++) {
+        const Mesh* mesh = &vkrt->core.meshes[meshIndex];
+        const Material* material = vkrtGetSceneMaterialData(vkrt, mesh->info.materialIndex);
+        if (!material) continue;
+        if (!materialEligibleForDirectLightSampling(&mesh->info, material)) continue;
+        float emissionWeight = materialEmissionWeight(material);
+        if (emissionWeight <= 0.0f) continue;
+        if (!mesh->vertices || !mesh->indices) continue;
+        if ((mesh->info.indexCount / 3u) == 0u) continue;
+        if (count >= capacity) {
+            LOG_ERROR("Emissive mesh staging overflow");
+            return VKRT_ERROR_OPERATION_FAILED;
+        }
 
-    Mesh* mesh = &vkrt->core.meshes[meshIndex];
-    if (scratch->emissiveMeshCount >= scratch->meshCapacity) {
-        LOG_ERROR("Emissive mesh staging overflow");
-        return VKRT_ERROR_OPERATION_FAILED;
+        EmissiveCandidate* candidate = &candidates[count++];
+        candidate->meshIndex = meshIndex;
+        candidate->emissionWeight = emissionWeight;
+        queryEmissiveAreaBasis(mesh, &candidate->basis);
     }
 
-    float emissionWeight = materialEmissionWeight(material);
-    uint32_t triangleOffset = 0u;
-    uint32_t validTriangleCount = 0u;
-    float totalArea = 0.0f;
-    VKRT_Result result = appendMeshEmissiveTriangles(mesh, scratch, &triangleOffset, &validTriangleCount, &totalArea);
-    if (result != VKRT_SUCCESS) {
-        return result;
-    }
+    *outCount = count;
+    return VKRT_SUCCESS;
+}
 
-    float selectionWeight = totalArea * emissionWeight;
-    if (selectionWeight <= 0.0f || validTriangleCount == 0u) {
-        scratch->emissiveTriangleCount = triangleOffset;
-        return VKRT_SUCCESS;
+static VKRT_Result refreshEmissiveTriangleCaches(VKRT* vkrt, const EmissiveCandidate* candidates, uint32_t count) {
+    EmissiveCacheRebuild* rebuilds =
+        (EmissiveCacheRebuild*)malloc((size_t)(count > 0u ? count : 1u) * sizeof(EmissiveCacheRebuild));
+    if (!rebuilds) return VKRT_ERROR_OUT_OF_MEMORY;
+
+    uint32_t dirtyCount = 0u;
+    uint64_t dirtyTriangleCount = 0u;
+    for (uint32_t i = 0; i < count; i++) {
+        const Mesh* mesh = &vkrt->core.meshes[candidates[i].meshIndex];
+        if (emissiveCacheMatchesBasis(&mesh->emissiveCache, &candidates[i].basis)) continue;
+        rebuilds[dirtyCount++] = (EmissiveCacheRebuild){.candidateIndex = i, .result = VKRT_SUCCESS};
+        dirtyTriangleCount += mesh->info.indexCount / 3u;
     }
 
-    float invTotalArea = 1.0f / totalArea;
-    for (uint32_t triangleIndex = 0; triangleIndex < validTriangleCount; triangleIndex++) {
-        scratch->triPmfScratch[triangleIndex] =
-            scratch->emissiveTriangles[triangleOffset + triangleIndex].v0Area[3] * invTotalArea;
+    EmissiveCacheJob job = {
+        .vkrt = vkrt,
+        .candidates = candidates,
+        .rebuilds = rebuilds,
+    };
+    VKRT_JobPool* pool = dirtyTriangleCount < kEmissiveCacheParallelTriangles ? NULL : vkrtJobPoolShared();
+    VKRT_Result result = VKRT_SUCCESS;
+    if (vkrtJobPoolRun(pool, dirtyCount, buildEmissiveCacheJob, &job) != 0) {
+        for (uint32_t i = 0; i < dirtyCount && result == VKRT_SUCCESS; i++) {
+            result = rebuilds[i].result;
+        }
     }
-    if (!buildAliasTable(
-            scratch->triPmfScratch,
-            validTriangleCount,
-            &scratch->triAliasQ[triangleOffset],
-            &scratch->triAliasIdx[triangleOffset]
-        )) {
-        LOG_ERROR("Failed to build emissive triangle alias table");
-        return VKRT_ERROR_OPERATION_FAILED;
+
+    if (result == VKRT_SUCCESS) {
+        for (uint32_t i = 0; i < dirtyCount; i++) {
+            Mesh* mesh = &vkrt->core.meshes[candidates[rebuilds[i].candidateIndex].meshIndex];
+            mesh->emissiveCache.serial = ++vkrt->core.emissiveCacheSerial;
+        }
     }
+    free(rebuilds);
+    return result;
+}
 
-    EmissiveMesh emissiveMesh = {0};
-    emissiveMesh.triOffset = triangleOffset;
-    emissiveMesh.triCount = validTriangleCount;
-    emissiveMesh.invTotalArea = invTotalArea;
-    emissiveMesh.emission[0] = material->emissionColor[0] * material->emissionLuminance;
-    emissiveMesh.emission[1] = material->emissionColor[1] * material->emissionLuminance;
-    emissiveMesh.emission[2] = material->emissionColor[2] * material->emissionLuminance;
+static int emissiveCacheContributes(const EmissiveTriangleCache* cache) {
+    return cache->triangleCount > 0u && cache->totalArea > 0.0f;
+}
 
-    scratch->meshWeights[scratch->emissiveMeshCount] = selectionWeight;
-    scratch->totalSelectionWeight += selectionWeight;
-    scratch->sourceMeshIndices[scratch->emissiveMeshCount] = meshIndex;
-    scratch->emissiveMeshes[scratch->emissiveMeshCount++] = emissiveMesh;
-    return VKRT_SUCCESS;
+static uint64_t queryEmissiveTriangleLayoutKey(
+    const VKRT* vkrt,
+    const EmissiveCandidate* candidates,
+    uint32_t count,
+    uint32_t* outTriangleCount,
+    uint32_t* outEmitterCount
+) {
+    uint64_t key = kLayoutKeyOffset;
+    uint64_t triangleCount = 0u;
+    uint64_t emitterCount = 0u;
+    for (uint32_t i = 0; i < count; i++) {
+        const EmissiveTriangleCache* cache = &vkrt->core.meshes[candidates[i].meshIndex].emissiveCache;
+        if (!emissiveCacheContributes(cache)) continue;
+        key = (key ^ cache->serial) * kLayoutKeyPrime;
+        triangleCount += cache->triangleCount;
+        emitterCount += cache->clusterCount;
+    }
+
+    *outTriangleCount = triangleCount > UINT32_MAX ? UINT32_MAX : (uint32_t)triangleCount;
+    *outEmitterCount = emitterCount > UINT32_MAX ? UINT32_MAX : (uint32_t)emitterCount;
+    return key;
 }
 
-static VKRT_Result populateEmissiveLightScratch(VKRT* vkrt, LightBuildScratch* scratch) {
-    if (!vkrt || !scratch) return VKRT_ERROR_INVALID_ARGUMENT;
+// Every cluster becomes an emitter, empty ones included, so a mesh's emitters line up with its source triangles.
+// Empty clusters get no selection weight and never reach the light BVH.
+static void populateEmissiveLightScratch(
+    VKRT* vkrt,
+    const EmissiveCandidate* candidates,
+    uint32_t count,
+    LightBuildScratch* scratch
+) {
+    for (uint32_t i = 0; i < count; i++) {
+        const EmissiveCandidate* candidate = &candidates[i];
+        Mesh* mesh = &vkrt->core.meshes[candidate->meshIndex];
+        const EmissiveTriangleCache* cache = &mesh->emissiveCache;
+        if (!emissiveCacheContributes(cache)) continue;
+
+        uint32_t triangleOffset = scratch->emissiveTriangleCount;
+        if (!scratch->reuseTriangles) {
+            size_t triangleCount = cache->triangleCount;
+            EmissiveTriangle* triangles = &scratch->emissiveTriangles[triangleOffset];
+            memcpy(triangles, cache->triangles, triangleCount * sizeof(EmissiveTriangle));
+            memcpy(&scratch->triAliasQ[triangleOffset], cache->aliasQ, triangleCount * sizeof(float));
+            memcpy(&scratch->triAliasIdx[triangleOffset], cache->aliasIdx, triangleCount * sizeof(uint32_t));
+        }
+        scratch->emissiveTriangleCount += cache->triangleCount;
 
-    for (uint32_t meshIndex = 0; meshIndex < vkrt->core.meshCount; meshIndex++) {
-        Mesh* mesh = &vkrt->core.meshes[meshIndex];
         const Material* material = vkrtGetSceneMaterialData(vkrt, mesh->info.materialIndex);
-        if (!material) continue;
-        if (!materialEligibleForDirectLightSampling(&mesh->info, material)) continue;
-        if (materialEmissionWeight(material) <= 0.0f) continue;
-        if (!mesh->vertices || !mesh->indices) continue;
-        if ((mesh->info.indexCount / 3u) == 0u) continue;
-
-        VKRT_Result result = appendEmissiveMesh(vkrt, meshIndex, material, scratch);
-        if (result != VKRT_SUCCESS) {
-            return result;
+        mesh->info.lightEmitterOffset = scratch->emissiveMeshCount;
+        for (uint32_t clusterIndex = 0; clusterIndex < cache->clusterCount; clusterIndex++) {
+            const EmissiveTriangleCluster* cluster = &cache->clusters[clusterIndex];
+            float worldArea = cluster->area * candidate->basis.areaScale;
+            float selectionWeight = worldArea * candidate->emissionWeight;
+
+            EmissiveMesh emissiveMesh = {0};
+            emissiveMesh.triOffset = triangleOffset + cluster->firstTriangle;
+            emissiveMesh.triCount = cluster->triangleCount;
+            emissiveMesh.invTotalArea = cluster->triangleCount > 0u ? 1.0f / worldArea : 0.0f;
+            emissiveMesh.emission[0] = material->emissionColor[0] * material->emissionLuminance;
+            emissiveMesh.emission[1] = material->emissionColor[1] * material->emissionLuminance;
+            emissiveMesh.emission[2] = material->emissionColor[2] * material->emissionLuminance;
+            emissiveMesh.meshIndex = candidate->meshIndex;
+
+            scratch->meshWeights[scratch->emissiveMeshCount] = selectionWeight;
+            scratch->totalSelectionWeight += selectionWeight;
+            scratch->sourceMeshIndices[scratch->emissiveMeshCount] = candidate->meshIndex;
+            scratch->emissiveMeshes[scratch->emissiveMeshCount++] = emissiveMesh;
         }
     }
-    return VKRT_SUCCESS;
 }
 
-static VKRT_Result finalizeMeshSelectionWeights(VKRT* vkrt, LightBuildScratch* scratch) {
+static VKRT_Result finalizeMeshSelectionWeights(
+    VKRT* vkrt,
+    LightBuildScratch* scratch,
+    float meshSelectionProbability
+) {
     if (!vkrt || !scratch) return VKRT_ERROR_INVALID_ARGUMENT;
     if (scratch->emissiveMeshCount == 0u || scratch->totalSelectionWeight <= 0.0f) {
         return VKRT_SUCCESS;
@@ -418,20 +660,261 @@ static VKRT_Result finalizeMeshSelectionWeights(VKRT* vkrt, LightBuildScratch* s
     float invTotalWeight = 1.0f / scratch->totalSelectionWeight;
     for (uint32_t meshIndex = 0; meshIndex < scratch->emissiveMeshCount; meshIndex++) {
         float pmf = scratch->meshWeights[meshIndex] * invTotalWeight;
-        scratch->emissiveMeshes[meshIndex].pmfMesh = pmf;
-        scratch->triPmfScratch[meshIndex] = pmf;
+        float selectionPmf = pmf * meshSelectionProbability;
+        scratch->emissiveMeshes[meshIndex].pmfMesh = selectionPmf;
+        scratch->meshPmfScratch[meshIndex] = pmf;
+        // Every non-empty cluster of a mesh has the same density per unit area, so any of them sets the mesh's.
+        if (scratch->emissiveMeshes[meshIndex].triCount == 0u) continue;
         vkrt->core.meshes[scratch->sourceMeshIndices[meshIndex]].info.lightPdfArea =
-            pmf * scratch->emissiveMeshes[meshIndex].invTotalArea;
+            selectionPmf * scratch->emissiveMeshes[meshIndex].invTotalArea;
     }
-    if (
-        !buildAliasTable(scratch->triPmfScratch, scratch->emissiveMeshCount, scratch->meshAliasQ, scratch->meshAliasIdx)
-    ) {
+    if (!vkrtBuildAliasTable(
+            scratch->meshPmfScratch,
+            scratch->emissiveMeshCount,
+            scratch->meshAliasQ,
+            scratch->meshAliasIdx
+        )) {
         LOG_ERROR("Failed to build emissive mesh alias table");
         return VKRT_ERROR_OPERATION_FAILED;
     }
     return VKRT_SUCCESS;
 }
 
+static void transformEmissiveBounds(
+    const Mesh* mesh,
+    const float localMin[3],
+    const float localMax[3],
+    LightBVHPrimitive* out
+) {
+    glm_vec3_copy((vec3){FLT_MAX, FLT_MAX, FLT_MAX}, out->boundsMin);
+    glm_vec3_copy((vec3){-FLT_MAX, -FLT_MAX, -FLT_MAX}, out->boundsMax);
+    for (uint32_t corner = 0; corner < 8u; corner++) {
+        float local[3] = {
+            (corner & 1u) ? localMax[0] : localMin[0],
+            (corner & 2u) ? localMax[1] : localMin[1],
+            (corner & 4u) ? localMax[2] : localMin[2],
+        };
+        float world[3];
+        for (int rowIndex = 0; rowIndex < 3; rowIndex++) {
+            world[rowIndex] = (mesh->worldTransform[0][rowIndex] * local[0]) +
+                              (mesh->worldTransform[1][rowIndex] * local[1]) +
+                              (mesh->worldTransform[2][rowIndex] * local[2]) + mesh->worldTransform[3][rowIndex];
+        }
+        growBounds(out->boundsMin, out->boundsMax, world);
+    }
+}
+
+static void transformEmissiveNormalCone(
+    const Mesh* mesh,
+    const EmissiveTriangleCluster* cluster,
+    LightBVHPrimitive* out
+) {
+    out->cosTheta = cluster->normalCosTheta;
+    if (mesh->emissiveCache.worldSpaceAreas) {
+        memcpy(out->axis, cluster->normalAxis, sizeof(out->axis));
+        return;
+    }
+
+    // Similarity transforms preserve angles, so only the axis moves.
+    vec3 axis;
+    for (int rowIndex = 0; rowIndex < 3; rowIndex++) {
+        axis[rowIndex] = (mesh->worldTransform[0][rowIndex] * cluster->normalAxis[0]) +
+                         (mesh->worldTransform[1][rowIndex] * cluster->normalAxis[1]) +
+                         (mesh->worldTransform[2][rowIndex] * cluster->normalAxis[2]);
+    }
+    glm_vec3_normalize_to(axis, out->axis);
+}
+
+static float clampedAcos(float value) {
+    return acosf(fminf(fmaxf(value, -1.0f), 1.0f));
+}
+
+// Union of two double-sided normal cones. A cosine of zero is a hemisphere, which covers every direction once the
+// sign of the normal no longer matters.
+static void unionNormalCones(const LightBVHPrimitive* a, const LightBVHPrimitive* b, LightBVHPrimitive* out) {
+    if (a->cosTheta <= 0.0f || b->cosTheta <= 0.0f) {
+        memcpy(out->axis, a->axis, sizeof(out->axis));
+        out->cosTheta = 0.0f;
+        return;
+    }
+
+    vec3 axisA;
+    vec3 axisB;
+    memcpy(axisA, a->axis, sizeof(axisA));
+    memcpy(axisB, b->axis, sizeof(axisB));
+    if (glm_vec3_dot(axisA, axisB) < 0.0f) glm_vec3_negate(axisB);
+
+    float thetaA = clampedAcos(a->cosTheta);
+    float thetaB = clampedAcos(b->cosTheta);
+    float thetaD = clampedAcos(glm_vec3_dot(axisA, axisB));
+    if (thetaD + thetaB <= thetaA) {
+        glm_vec3_copy(axisA, out->axis);
+        out->cosTheta = a->cosTheta;
+        return;
+    }
+    if (thetaD + thetaA <= thetaB) {
+        glm_vec3_copy(axisB, out->axis);
+        out->cosTheta = b->cosTheta;
+        return;
+    }
+
+    float thetaO = 0.5f * (thetaA + thetaD + thetaB);
+    vec3 rotationAxis;
+    glm_vec3_cross(axisA, axisB, rotationAxis);
+    if (thetaO >= GLM_PI_2f || glm_vec3_norm2(rotationAxis) <= 0.0f) {
+        glm_vec3_copy(axisA, out->axis);
+        out->cosTheta = 0.0f;
+        return;
+    }
+
+    glm_vec3_normalize(rotationAxis);
+    glm_vec3_rotate(axisA, thetaO - thetaA, rotationAxis);
+    glm_vec3_normalize_to(axisA, out->axis);
+    out->cosTheta = cosf(thetaO);
+}
+
+static void unionLightBVHPrimitives(const LightBVHPrimitive* a, const LightBVHPrimitive* b, LightBVHPrimitive* out) {
+    LightBVHPrimitive result = {0};
+    for (int axis = 0; axis < 3; axis++) {
+        result.boundsMin[axis] = fminf(a->boundsMin[axis], b->boundsMin[axis]);
+        result.boundsMax[axis] = fmaxf(a->boundsMax[axis], b->boundsMax[axis]);
+    }
+    result.power = a->power + b->power;
+    unionNormalCones(a, b, &result);
+    *out = result;
+}
+
+static int compareLightBVHPrimitives(const void* lhs, const void* rhs) {
+    float a = ((const LightBVHPrimitive*)lhs)->sortKey;
+    float b = ((const LightBVHPrimitive*)rhs)->sortKey;
+    return (a > b) - (a < b);
+}
+
+static void writeLightBVHNode(const LightBVHPrimitive* bounds, uint32_t childOrEmitter, LightBVHNode* node) {
+    *node = (LightBVHNode){0};
+    for (int axis = 0; axis < 3; axis++) {
+        node->boundsMinPower[axis] = bounds->boundsMin[axis];
+        node->boundsMaxCosTheta[axis] = bounds->boundsMax[axis];
+        node->axis[axis] = bounds->axis[axis];
+    }
+    node->boundsMinPower[3] = bounds->power;
+    node->boundsMaxCosTheta[3] = bounds->cosTheta;
+    node->childOrEmitter = childOrEmitter;
+}
+
+// Depth-first layout: an interior node's first child follows it directly and the second child's index is stored.
+// Median splits keep the depth within the 32-bit trail that lets the shader replay a path for MIS.
+static uint32_t buildLightBVHNode(
+    LightBuildScratch* scratch,
+    LightBVHPrimitive* primitives,
+    uint32_t begin,
+    uint32_t end,
+    uint32_t bitTrail,
+    uint32_t depth,
+    LightBVHPrimitive* outBounds
+) {
+    uint32_t nodeIndex = scratch->lightBVHNodeCount++;
+    if (end - begin == 1u) {
+        const LightBVHPrimitive* primitive = &primitives[begin];
+        writeLightBVHNode(
+            primitive,
+            VKRT_LIGHT_BVH_LEAF_BIT | primitive->emitterIndex,
+            &scratch->lightBVHNodes[nodeIndex]
+        );
+        scratch->emissiveMeshes[primitive->emitterIndex].lightBitTrail = bitTrail;
+        *outBounds = *primitive;
+        return nodeIndex;
+    }
+
+    vec3 centroidMin = {FLT_MAX, FLT_MAX, FLT_MAX};
+    vec3 centroidMax = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (uint32_t i = begin; i < end; i++) {
+        vec3 centroid;
+        glm_vec3_add(primitives[i].boundsMin, primitives[i].boundsMax, centroid);
+        glm_vec3_scale(centroid, 0.5f, centroid);
+        growBounds(centroidMin, centroidMax, centroid);
+    }
+    vec3 extent;
+    glm_vec3_sub(centroidMax, centroidMin, extent);
+    int splitAxis = extent[1] > extent[0] ? 1 : 0;
+    if (extent[2] > extent[splitAxis]) splitAxis = 2;
+
+    for (uint32_t i = begin; i < end; i++) {
+        primitives[i].sortKey = primitives[i].boundsMin[splitAxis] + primitives[i].boundsMax[splitAxis];
+    }
+    qsort(&primitives[begin], end - begin, sizeof(LightBVHPrimitive), compareLightBVHPrimitives);
+
+    uint32_t middle = begin + ((end - begin) / 2u);
+    LightBVHPrimitive firstBounds;
+    LightBVHPrimitive secondBounds;
+    (void)buildLightBVHNode(scratch, primitives, begin, middle, bitTrail, depth + 1u, &firstBounds);
+    uint32_t secondChild = buildLightBVHNode(
+        scratch,
+        primitives,
+        middle,
+        end,
+        bitTrail | (1u << depth),
+        depth + 1u,
+        &secondBounds
+    );
+
+    unionLightBVHPrimitives(&firstBounds, &secondBounds, outBounds);
+    writeLightBVHNode(outBounds, secondChild, &scratch->lightBVHNodes[nodeIndex]);
+    return nodeIndex;
+}
+
+static void queryEmitterBVHPrimitive(
+    const VKRT* vkrt,
+    const LightBuildScratch* scratch,
+    uint32_t emitterIndex,
+    LightBVHPrimitive* out
+) {
+    const Mesh* mesh = &vkrt->core.meshes[scratch->sourceMeshIndices[emitterIndex]];
+    const EmissiveTriangleCluster* cluster =
+        &mesh->emissiveCache.clusters[emitterIndex - mesh->info.lightEmitterOffset];
+    *out = (LightBVHPrimitive){0};
+    transformEmissiveBounds(mesh, cluster->boundsMin, cluster->boundsMax, out);
+    transformEmissiveNormalCone(mesh, cluster, out);
+    out->power = scratch->meshWeights[emitterIndex];
+    out->emitterIndex = emitterIndex;
+}
+
+// Leaves are triangle clusters rather than whole meshes, so large or curved emitters still get tight bounds and
+// cones. Empty clusters carry no power and are left out.
+static VKRT_Result buildLightBVH(VKRT* vkrt, LightBuildScratch* scratch) {
+    if (!vkrt || !scratch) return VKRT_ERROR_INVALID_ARGUMENT;
+
+    uint32_t leafCount = 0u;
+    for (uint32_t emitterIndex = 0; emitterIndex < scratch->emissiveMeshCount; emitterIndex++) {
+        if (scratch->emissiveMeshes[emitterIndex].triCount > 0u) leafCount++;
+    }
+    if (leafCount == 0u) return VKRT_SUCCESS;
+    if (scratch->emissiveMeshCount > (VKRT_LIGHT_BVH_LEAF_BIT >> 1u)) {
+        LOG_ERROR("Light BVH exceeds emitter index limits");
+        return VKRT_ERROR_OPERATION_FAILED;
+    }
+
+    LightBVHPrimitive* primitives = (LightBVHPrimitive*)malloc((size_t)leafCount * sizeof(LightBVHPrimitive));
+    scratch->lightBVHNodes = (LightBVHNode*)malloc(((size_t)leafCount * 2u - 1u) * sizeof(LightBVHNode));
+    if (!primitives || !scratch->lightBVHNodes) {
+        free(primitives);
+        LOG_ERROR("Failed to allocate light BVH staging buffers");
+        return VKRT_ERROR_OUT_OF_MEMORY;
+    }
+
+    uint32_t primitiveCount = 0u;
+    for (uint32_t emitterIndex = 0; emitterIndex < scratch->emissiveMeshCount; emitterIndex++) {
+        if (scratch->emissiveMeshes[emitterIndex].triCount == 0u) continue;
+        queryEmitterBVHPrimitive(vkrt, scratch, emitterIndex, &primitives[primitiveCount++]);
+    }
+
+    LightBVHPrimitive rootBounds;
+    scratch->lightBVHNodeCount = 0u;
+    (void)buildLightBVHNode(scratch, primitives, 0u, leafCount, 0u, 0u, &rootBounds);
+    free(primitives);
+    return VKRT_SUCCESS;
+}
+
 static VKRT_Result uploadScratchLightBuffers(
     VKRT* vkrt,
     const LightBuildScratch* scratch,
@@ -450,15 +933,6 @@ static VKRT_Result uploadScratchLightBuffers(
     if (result != VKRT_SUCCESS) return result;
     nextState->sceneEmissiveMeshData.count = scratch->emissiveMeshCount;
 
-    result = uploadLightBuffer(
-        vkrt,
-        scratch->emissiveTriangles,
-        (VkDeviceSize)uploadTriangleCount * sizeof(EmissiveTriangle),
-        &nextState->sceneEmissiveTriangleData
-    );
-    if (result != VKRT_SUCCESS) return result;
-    nextState->sceneEmissiveTriangleData.count = scratch->emissiveTriangleCount;
-
     result = uploadLightBuffer(
         vkrt,
         scratch->meshAliasQ,
@@ -473,6 +947,30 @@ static VKRT_Result uploadScratchLightBuffers(
         &nextState->sceneMeshAliasIdx
     );
     if (result != VKRT_SUCCESS) return result;
+
+    LightBVHNode emptyNode = {0};
+    result = uploadLightBuffer(
+        vkrt,
+        scratch->lightBVHNodeCount > 0u ? (const void*)scratch->lightBVHNodes : (const void*)&emptyNode,
+        (VkDeviceSize)(scratch->lightBVHNodeCount > 0u ? scratch->lightBVHNodeCount : 1u) * sizeof(LightBVHNode),
+        &nextState->sceneLightBVHData
+    );
+    if (result != VKRT_SUCCESS) return result;
+    nextState->sceneLightBVHData.count = scratch->lightBVHNodeCount;
+
+    nextState->emissiveMeshCount = scratch->emissiveMeshCount;
+    nextState->emissiveTriangleCount = scratch->emissiveTriangleCount;
+    if (scratch->reuseTriangles) return VKRT_SUCCESS;
+
+    result = uploadLightBuffer(
+        vkrt,
+        scratch->emissiveTriangles,
+        (VkDeviceSize)uploadTriangleCount * sizeof(EmissiveTriangle),
+        &nextState->sceneEmissiveTriangleData
+    );
+    if (result != VKRT_SUCCESS) return result;
+    nextState->sceneEmissiveTriangleData.count = scratch->emissiveTriangleCount;
+
     result = uploadLightBuffer(
         vkrt,
         scratch->triAliasQ,
@@ -486,39 +984,152 @@ static VKRT_Result uploadScratchLightBuffers(
         (VkDeviceSize)uploadTriangleCount * sizeof(uint32_t),
         &nextState->sceneTriAliasIdx
     );
-    if (result != VKRT_SUCCESS) return result;
+    return result;
+}
 
-    nextState->emissiveMeshCount = scratch->emissiveMeshCount;
-    nextState->emissiveTriangleCount = scratch->emissiveTriangleCount;
-    return VKRT_SUCCESS;
+static int environmentDistributionActive(const VKRT* vkrt) {
+    const EnvironmentDistribution* distribution = &vkrt->core.environmentDistribution;
+    return vkrt->sceneSettings.environmentTextureIndex != VKRT_INVALID_INDEX && distribution->width > 0u &&
+           distribution->height > 0u && distribution->aliasQ && distribution->aliasIdx && distribution->pmf;
 }
 
-VKRT_Result vkrtSceneRebuildLightBuffers(VKRT* vkrt) {
-    if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
+static float queryEmitterBoundsRadius(const VKRT* vkrt, const LightBuildScratch* scratch) {
+    LightBVHPrimitive meshBounds;
+    float boundsMin[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float boundsMax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (uint32_t emitterIndex = 0; emitterIndex < scratch->emissiveMeshCount; emitterIndex++) {
+        const Mesh* mesh = &vkrt->core.meshes[scratch->sourceMeshIndices[emitterIndex]];
+        // Each mesh's clusters are contiguous, so its object-space bounds only need transforming once.
+        if (emitterIndex != mesh->info.lightEmitterOffset) continue;
+        transformEmissiveBounds(mesh, mesh->emissiveCache.boundsMin, mesh->emissiveCache.boundsMax, &meshBounds);
+        growBounds(boundsMin, boundsMax, meshBounds.boundsMin);
+        growBounds(boundsMin, boundsMax, meshBounds.boundsMax);
+    }
+
+    vec3 extent;
+    glm_vec3_sub(boundsMax, boundsMin, extent);
+    return 0.5f * glm_vec3_norm(extent);
+}
+
+// Splits light samples by emitted power. A Lambertian emitter radiates pi * area * L, and the environment sends
+// pi * R^2 * (integral of L over the sphere) through a sphere of radius R around the emitters, so the pi factors
+// cancel against the mesh selection weights. Clamping keeps both strategies alive for MIS.
+static float queryEnvironmentSelectionProbability(const VKRT* vkrt, const LightBuildScratch* scratch) {
+    if (!environmentDistributionActive(vkrt)) return 0.0f;
+    if (scratch->emissiveMeshCount == 0u || scratch->totalSelectionWeight <= 0.0f) return 1.0f;
+
+    float radius = queryEmitterBoundsRadius(vkrt, scratch);
+    float environmentPower = radius * radius * vkrt->core.environmentDistribution.integratedLuminance *
+                             vkrt->sceneSettings.environmentStrength;
+    if (!isfinite(environmentPower) || environmentPower <= 0.0f) return 0.0f;
+
+    float probability = environmentPower / (environmentPower + scratch->totalSelectionWeight);
+    if (probability < kMinEnvironmentSelectionProbability) return kMinEnvironmentSelectionProbability;
+    if (probability > kMaxEnvironmentSelectionProbability) return kMaxEnvironmentSelectionProbability;
+    return probability;
+}
 
+static VKRT_Result uploadEnvironmentLightBuffers(VKRT* vkrt, float selectionProbability, LightBufferState* nextState) {
+    if (!vkrt || !nextState) return VKRT_ERROR_INVALID_ARGUMENT;
+
+    float emptyQ = 1.0f;
+    uint32_t emptyIdx = 0u;
+    float emptyPmf = 0.0f;
+    const float* aliasQ = &emptyQ;
+    const uint32_t* aliasIdx = &emptyIdx;
+    const float* pmf = &emptyPmf;
+    uint32_t entryCount = 1u;
+
+    const EnvironmentDistribution* distribution = &vkrt->core.environmentDistribution;
+    if (selectionProbability > 0.0f) {
+        aliasQ = distribution->aliasQ;
+        aliasIdx = distribution->aliasIdx;
+        pmf = distribution->pmf;
+        entryCount = distribution->height + (distribution->width * distribution->height);
+        nextState->environmentSamplingWidth = distribution->width;
+        nextState->environmentSamplingHeight = distribution->height;
+        nextState->environmentSelectionProbability = selectionProbability;
+    }
+
+    VKRT_Result result =
+        uploadLightBuffer(vkrt, aliasQ, (VkDeviceSize)entryCount * sizeof(float), &nextState->sceneEnvironmentAliasQ);
+    if (result != VKRT_SUCCESS) return result;
+    result = uploadLightBuffer(
+        vkrt,
+        aliasIdx,
+        (VkDeviceSize)entryCount * sizeof(uint32_t),
+        &nextState->sceneEnvironmentAliasIdx
+    );
+    if (result != VKRT_SUCCESS) return result;
+    return uploadLightBuffer(vkrt, pmf, (VkDeviceSize)entryCount * sizeof(float), &nextState->sceneEnvironmentPmf);
+}
+
+static VKRT_Result prepareEmissiveLightScratch(VKRT* vkrt, LightBuildScratch* scratch, uint64_t* outLayoutKey) {
     EmissiveLightCounts counts = {0};
     VKRT_Result result = countEmissiveLights(vkrt, &counts);
-    if (result != VKRT_SUCCESS) {
-        return result;
+    if (result != VKRT_SUCCESS) return result;
+
+    EmissiveCandidate* candidates =
+        (EmissiveCandidate*)malloc((size_t)(counts.emissiveMeshCount > 0u ? counts.emissiveMeshCount : 1u) *
+                                   sizeof(EmissiveCandidate));
+    if (!candidates) return VKRT_ERROR_OUT_OF_MEMORY;
+
+    uint32_t candidateCount = 0u;
+    result = collectEmissiveCandidates(vkrt, candidates, counts.emissiveMeshCount, &candidateCount);
+    if (result == VKRT_SUCCESS) {
+        result = refreshEmissiveTriangleCaches(vkrt, candidates, candidateCount);
+    }
+
+    uint32_t triangleCount = 0u;
+    uint32_t emitterCount = 0u;
+    uint64_t layoutKey = 0u;
+    uint8_t reuseTriangles = 0u;
+    if (result == VKRT_SUCCESS) {
+        // Moving or recolouring an emitter leaves every cached block in place, so the triangle buffers stay valid.
+        layoutKey = queryEmissiveTriangleLayoutKey(vkrt, candidates, candidateCount, &triangleCount, &emitterCount);
+        reuseTriangles = layoutKey == vkrt->core.emissiveTriangleLayoutKey &&
+                                 vkrt->core.sceneEmissiveTriangleData.buffer != VK_NULL_HANDLE &&
+                                 vkrt->core.sceneTriAliasQ.buffer != VK_NULL_HANDLE &&
+                                 vkrt->core.sceneTriAliasIdx.buffer != VK_NULL_HANDLE &&
+                                 vkrt->core.emissiveTriangleCount == triangleCount
+                             ? 1u
+                             : 0u;
+        result = allocateLightBuildScratch(emitterCount, reuseTriangles ? 0u : triangleCount, scratch);
+    }
+    if (result == VKRT_SUCCESS) {
+        scratch->reuseTriangles = reuseTriangles;
+        populateEmissiveLightScratch(vkrt, candidates, candidateCount, scratch);
+        *outLayoutKey = layoutKey;
     }
 
+    free(candidates);
+    return result;
+}
+
+VKRT_Result vkrtSceneRebuildLightBuffers(VKRT* vkrt) {
+    if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
+
     clearMeshLightPdfAreas(vkrt);
 
     LightBuildScratch scratch = {0};
-    result = allocateLightBuildScratch(&counts, &scratch);
-    if (result != VKRT_SUCCESS) {
-        freeLightBuildScratch(&scratch);
-        return result;
-    }
+    uint64_t layoutKey = 0u;
+    VKRT_Result result = prepareEmissiveLightScratch(vkrt, &scratch, &layoutKey);
 
     LightBufferState nextState = {0};
-    result = populateEmissiveLightScratch(vkrt, &scratch);
+    float environmentSelectionProbability = 0.0f;
+    if (result == VKRT_SUCCESS) {
+        environmentSelectionProbability = queryEnvironmentSelectionProbability(vkrt, &scratch);
+        result = finalizeMeshSelectionWeights(vkrt, &scratch, 1.0f - environmentSelectionProbability);
+    }
     if (result == VKRT_SUCCESS) {
-        result = finalizeMeshSelectionWeights(vkrt, &scratch);
+        result = buildLightBVH(vkrt, &scratch);
     }
     if (result == VKRT_SUCCESS) {
         result = uploadScratchLightBuffers(vkrt, &scratch, &nextState);
     }
+    if (result == VKRT_SUCCESS) {
+        result = uploadEnvironmentLightBuffers(vkrt, environmentSelectionProbability, &nextState);
+    }
 
     LightBufferState previousState = {
         .sceneEmissiveMeshData = vkrt->core.sceneEmissiveMeshData,
@@ -527,12 +1138,25 @@ VKRT_Result vkrtSceneRebuildLightBuffers(VKRT* vkrt) {
         .sceneMeshAliasIdx = vkrt->core.sceneMeshAliasIdx,
         .sceneTriAliasQ = vkrt->core.sceneTriAliasQ,
         .sceneTriAliasIdx = vkrt->core.sceneTriAliasIdx,
+        .sceneLightBVHData = vkrt->core.sceneLightBVHData,
+        .sceneEnvironmentAliasQ = vkrt->core.sceneEnvironmentAliasQ,
+        .sceneEnvironmentAliasIdx = vkrt->core.sceneEnvironmentAliasIdx,
+        .sceneEnvironmentPmf = vkrt->core.sceneEnvironmentPmf,
         .emissiveMeshCount = vkrt->core.emissiveMeshCount,
         .emissiveTriangleCount = vkrt->core.emissiveTriangleCount,
     };
+    if (result == VKRT_SUCCESS && scratch.reuseTriangles) {
+        nextState.sceneEmissiveTriangleData = previousState.sceneEmissiveTriangleData;
+        nextState.sceneTriAliasQ = previousState.sceneTriAliasQ;
+        nextState.sceneTriAliasIdx = previousState.sceneTriAliasIdx;
+        previousState.sceneEmissiveTriangleData = (Buffer){0};
+        previousState.sceneTriAliasQ = (Buffer){0};
+        previousState.sceneTriAliasIdx = (Buffer){0};
+    }
     if (result == VKRT_SUCCESS) {
         applyLightBufferState(vkrt, &nextState);
         destroyLightBufferState(vkrt, &previousState);
+        vkrt->core.emissiveTriangleLayoutKey = layoutKey;
         nextState = (LightBufferState){0};
     }
 
@@ -2,4 +2,7 @@
 
 #include "vkrt_internal.h"
 
+#include <stdint.h>
+
 VKRT_Result vkrtSceneRebuildLightBuffers(VKRT* vkrt);
+void vkrtReleaseEmissiveTriangleCache(EmissiveTriangleCache* cache);
@@ -0,0 +1,240 @@
+#include "mipmap.h"
+
+#include "constants.h"
+#include "formats.h"
+#include "job_pool.h"
+#include "packing.h"
+#include "vkrt_types.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const VkDeviceSize kMipLevelAlignment = 16u;
+static const uint64_t kMipDownsampleParallelTexels = 64ull * 1024ull;
+
+typedef struct MipDownsampleJob {
+    const uint8_t* source;
+    uint8_t* destination;
+    uint32_t sourceWidth;
+    uint32_t sourceHeight;
+    uint32_t destinationWidth;
+    uint32_t rowBegin;
+    uint32_t rowEnd;
+    uint32_t format;
+    uint32_t colorSpace;
+    const float* srgbToLinear;
+} MipDownsampleJob;
+
+static uint32_t mipLevelExtent(uint32_t extent, uint32_t level) {
+    return (extent >> level) > 0u ? extent >> level : 1u;
+}
+
+static float srgbDecodeChannel(float value) {
+    if (value <= 0.04045f) return value / 12.92f;
+    return powf((value + 0.055f) / 1.055f, 2.4f);
+}
+
+static uint8_t encodeUnorm8(float value) {
+    if (!(value > 0.0f)) return 0u;
+    if (value >= 1.0f) return 255u;
+    return (uint8_t)((value * 255.0f) + 0.5f);
+}
+
+static uint16_t encodeUnorm16(float value) {
+    if (!(value > 0.0f)) return 0u;
+    if (value >= 1.0f) return 65535u;
+    return (uint16_t)((value * 65535.0f) + 0.5f);
+}
+
+static uint8_t encodeSRGB8(const float* srgbToLinear, float value) {
+    uint32_t low = 0u;
+    uint32_t high = 255u;
+    while (low < high) {
+        uint32_t middle = (low + high + 1u) >> 1u;
+        if (srgbToLinear[middle] <= value) {
+            low = middle;
+        } else {
+            high = middle - 1u;
+        }
+    }
+    if (low < 255u && (srgbToLinear[low + 1u] - value) < (value - srgbToLinear[low])) low++;
+    return (uint8_t)low;
+}
+
+static void loadTexel(const MipDownsampleJob* job, const uint8_t* level, size_t texelIndex, float outTexel[4]) {
+    switch (job->format) {
+        case VKRT_TEXTURE_FORMAT_RGBA8_UNORM: {
+            const uint8_t* texel = level + (texelIndex * 4u);
+            for (uint32_t c = 0; c < 4u; c++) {
+                outTexel[c] = (job->colorSpace == VKRT_TEXTURE_COLOR_SPACE_SRGB && c < 3u)
+                                ? job->srgbToLinear[texel[c]]
+                                : (float)texel[c] * (1.0f / 255.0f);
+            }
+            break;
+        }
+        case VKRT_TEXTURE_FORMAT_RGBA16_UNORM: {
+            const uint16_t* texel = (const uint16_t*)level + (texelIndex * 4u);
+            for (uint32_t c = 0; c < 4u; c++) outTexel[c] = (float)texel[c] * (1.0f / 65535.0f);
+            break;
+        }
+        case VKRT_TEXTURE_FORMAT_RGBA16_SFLOAT: {
+            const uint16_t* texel = (const uint16_t*)level + (texelIndex * 4u);
+            for (uint32_t c = 0; c < 4u; c++) outTexel[c] = unpackHalf(texel[c]);
+            break;
+        }
+        case VKRT_TEXTURE_FORMAT_RGBA32_SFLOAT:
+            memcpy(outTexel, (const float*)level + (texelIndex * 4u), sizeof(float) * 4u);
+            break;
+        default:
+            memset(outTexel, 0, sizeof(float) * 4u);
+            break;
+    }
+}
+
+static void storeTexel(const MipDownsampleJob* job, uint8_t* level, size_t texelIndex, const float texel[4]) {
+    switch (job->format) {
+        case VKRT_TEXTURE_FORMAT_RGBA8_UNORM: {
+            uint8_t* output = level + (texelIndex * 4u);
+            for (uint32_t c = 0; c < 4u; c++) {
+                output[c] = (job->colorSpace == VKRT_TEXTURE_COLOR_SPACE_SRGB && c < 3u)
+                              ? encodeSRGB8(job->srgbToLinear, texel[c])
+                              : encodeUnorm8(texel[c]);
+            }
+            break;
+        }
+        case VKRT_TEXTURE_FORMAT_RGBA16_UNORM: {
+            uint16_t* output = (uint16_t*)level + (texelIndex * 4u);
+            for (uint32_t c = 0; c < 4u; c++) output[c] = encodeUnorm16(texel[c]);
+            break;
+        }
+        case VKRT_TEXTURE_FORMAT_RGBA16_SFLOAT: {
+            uint16_t* output = (uint16_t*)level + (texelIndex * 4u);
+            for (uint32_t c = 0; c < 4u; c++) output[c] = packHalf(texel[c]);
+            break;
+        }
+        case VKRT_TEXTURE_FORMAT_RGBA32_SFLOAT:
+            memcpy((float*)level + (texelIndex * 4u), texel, sizeof(float) * 4u);
+            break;
+        default:
+            break;
+    }
+}
+
+static void downsampleMipRows(const MipDownsampleJob* job) {
+    for (uint32_t y = job->rowBegin; y < job->rowEnd; y++) {
+        uint32_t y0 = (y * 2u) < job->sourceHeight ? (y * 2u) : job->sourceHeight - 1u;
+        uint32_t y1 = (y0 + 1u) < job->sourceHeight ? (y0 + 1u) : y0;
+        for (uint32_t x = 0; x < job->destinationWidth; x++) {
+            uint32_t x0 = (x * 2u) < job->sourceWidth ? (x * 2u) : job->sourceWidth - 1u;
+            uint32_t x1 = (x0 + 1u) < job->sourceWidth ? (x0 + 1u) : x0;
+            size_t footprint[4] = {
+                ((size_t)y0 * job->sourceWidth) + x0,
+                ((size_t)y0 * job->sourceWidth) + x1,
+                ((size_t)y1 * job->sourceWidth) + x0,
+                ((size_t)y1 * job->sourceWidth) + x1,
+            };
+
+            float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+            for (uint32_t i = 0; i < 4u; i++) {
+                float texel[4];
+                loadTexel(job, job->source, footprint[i], texel);
+                for (uint32_t c = 0; c < 4u; c++) sum[c] += texel[c];
+            }
+            for (uint32_t c = 0; c < 4u; c++) sum[c] *= 0.25f;
+            storeTexel(job, job->destination, ((size_t)y * job->destinationWidth) + x, sum);
+        }
+    }
+}
+
+static int downsampleMipRowJob(void* userData, uint32_t jobIndex) {
+    MipDownsampleJob job = *(const MipDownsampleJob*)userData;
+    job.rowBegin = jobIndex;
+    job.rowEnd = jobIndex + 1u;
+    downsampleMipRows(&job);
+    return 0;
+}
+
+static void downsampleMipLevel(MipDownsampleJob* levelJob, uint32_t destinationHeight) {
+    uint64_t texelCount = (uint64_t)levelJob->destinationWidth * destinationHeight;
+    VKRT_JobPool* pool = texelCount < kMipDownsampleParallelTexels ? NULL : vkrtJobPoolShared();
+    (void)vkrtJobPoolRun(pool, destinationHeight, downsampleMipRowJob, levelJob);
+}
+
+uint32_t vkrtQueryTextureMipLevelCount(uint32_t width, uint32_t height) {
+    uint32_t extent = width > height ? width : height;
+    uint32_t levelCount = 1u;
+    while (extent > 1u && levelCount < VKRT_TEXTURE_MAX_MIP_LEVELS) {
+        extent >>= 1u;
+        levelCount++;
+    }
+    return levelCount;
+}
+
+VKRT_Result vkrtBuildTextureMipChain(
+    const void* pixels,
+    uint32_t width,
+    uint32_t height,
+    uint32_t format,
+    uint32_t colorSpace,
+    TextureMipChain* outChain
+) {
+    if (!pixels || !outChain || width == 0u || height == 0u) return VKRT_ERROR_INVALID_ARGUMENT;
+    *outChain = (TextureMipChain){0};
+
+    TextureMipChain chain = {0};
+    chain.levelCount = vkrtQueryTextureMipLevelCount(width, height);
+    for (uint32_t level = 0; level < chain.levelCount; level++) {
+        uint32_t levelWidth = mipLevelExtent(width, level);
+        uint32_t levelHeight = mipLevelExtent(height, level);
+        size_t levelBytes = 0u;
+        if (!vkrtTryComputeTextureByteSize(levelWidth, levelHeight, format, &levelBytes)) {
+            return VKRT_ERROR_INVALID_ARGUMENT;
+        }
+        chain.levelOffsets[level] = (chain.byteSize + kMipLevelAlignment - 1u) & ~(kMipLevelAlignment - 1u);
+        chain.byteSize = chain.levelOffsets[level] + (VkDeviceSize)levelBytes;
+    }
+    if (chain.byteSize > (VkDeviceSize)SIZE_MAX) return VKRT_ERROR_OUT_OF_MEMORY;
+
+    chain.pixels = malloc((size_t)chain.byteSize);
+    if (!chain.pixels) return VKRT_ERROR_OUT_OF_MEMORY;
+
+    uint8_t* base = (uint8_t*)chain.pixels;
+    size_t baseBytes = 0u;
+    (void)vkrtTryComputeTextureByteSize(width, height, format, &baseBytes);
+    memcpy(base, pixels, baseBytes);
+
+    float srgbToLinear[256];
+    for (uint32_t i = 0; i < 256u; i++) {
+        srgbToLinear[i] = srgbDecodeChannel((float)i * (1.0f / 255.0f));
+    }
+
+    for (uint32_t level = 1; level < chain.levelCount; level++) {
+        uint32_t sourceWidth = mipLevelExtent(width, level - 1u);
+        uint32_t sourceHeight = mipLevelExtent(height, level - 1u);
+        uint32_t levelWidth = mipLevelExtent(width, level);
+        uint32_t levelHeight = mipLevelExtent(height, level);
+        MipDownsampleJob job = {
+            .source = base + chain.levelOffsets[level - 1u],
+            .destination = base + chain.levelOffsets[level],
+            .sourceWidth = sourceWidth,
+            .sourceHeight = sourceHeight,
+            .destinationWidth = levelWidth,
+            .format = format,
+            .colorSpace = colorSpace,
+            .srgbToLinear = srgbToLinear,
+        };
+        downsampleMipLevel(&job, levelHeight);
+    }
+
+    *outChain = chain;
+    return VKRT_SUCCESS;
+}
+
+void vkrtReleaseTextureMipChain(TextureMipChain* chain) {
+    if (!chain) return;
+    free(chain->pixels);
+    *chain = (TextureMipChain){0};
+}
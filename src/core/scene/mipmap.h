@@ -0,0 +1,24 @@
+#pragma once
+
+#include "constants.h"
+#include "vkrt_internal.h"
+
+#include <stdint.h>
+
+typedef struct TextureMipChain {
+    void* pixels;
+    VkDeviceSize byteSize;
+    uint32_t levelCount;
+    VkDeviceSize levelOffsets[VKRT_TEXTURE_MAX_MIP_LEVELS];
+} TextureMipChain;
+
+uint32_t vkrtQueryTextureMipLevelCount(uint32_t width, uint32_t height);
+VKRT_Result vkrtBuildTextureMipChain(
+    const void* pixels,
+    uint32_t width,
+    uint32_t height,
+    uint32_t format,
+    uint32_t colorSpace,
+    TextureMipChain* outChain
+);
+void vkrtReleaseTextureMipChain(TextureMipChain* chain);
@@ -1,10 +1,11 @@
 #include "rebuild.h"
 
 #include "accel/accel.h"
+#include "allocator.h"
 #include "buffer.h"
 #include "config.h"
 #include "debug.h"
-#include "lighting.h"
+#include "staging.h"
 #include "state.h"
 #include "types.h"
 #include "vkrt_engine_types.h"
@@ -15,20 +16,33 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+// Large imports can need hundreds of megabytes of build scratch; keep the arena only while it stays modest.
+static const VkDeviceSize kBLASScratchRetainBytes = (VkDeviceSize)64u * 1024u * 1024u;
+
 static Buffer* getMaterialData(VKRT* vkrt) {
     return &vkrt->core.sceneMaterialData;
 }
 
+static void clearMaterialDirtyRange(VKRT* vkrt) {
+    vkrt->core.materialDirtyBegin = 0u;
+    vkrt->core.materialDirtyEnd = 0u;
+}
+
+static Material* collectMaterials(const VKRT* vkrt, uint32_t first, uint32_t count) {
+    Material* materials = (Material*)malloc((size_t)count * sizeof(Material));
+    if (!materials) {
+        LOG_ERROR("Failed to allocate material buffer");
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        materials[i] = vkrt->core.materials[first + i].material;
+    }
+    return materials;
+}
+
 void vkrtCleanupPendingGeometryUploads(VKRT* vkrt, FrameSceneUpdate* update) {
     if (!vkrt || !update) return;
-    for (uint32_t i = 0; i < update->geometryUploadCount; i++) {
-        if (update->geometryUploads[i].stagingBuffer != VK_NULL_HANDLE) {
-            vkDestroyBuffer(vkrt->core.device, update->geometryUploads[i].stagingBuffer, NULL);
-        }
-        if (update->geometryUploads[i].stagingMemory != VK_NULL_HANDLE) {
-            vkFreeMemory(vkrt->core.device, update->geometryUploads[i].stagingMemory, NULL);
-        }
-    }
     free(update->geometryUploads);
     update->geometryUploads = NULL;
     update->geometryUploadCount = 0;
@@ -36,17 +50,25 @@ void vkrtCleanupPendingGeometryUploads(VKRT* vkrt, FrameSceneUpdate* update) {
 
 void vkrtCleanupPendingBLASBuilds(VKRT* vkrt, FrameSceneUpdate* update) {
     if (!vkrt || !update) return;
-    for (uint32_t i = 0; i < update->blasBuildCount; i++) {
-        if (update->blasBuilds[i].scratchBuffer != VK_NULL_HANDLE) {
-            vkDestroyBuffer(vkrt->core.device, update->blasBuilds[i].scratchBuffer, NULL);
-        }
-        if (update->blasBuilds[i].scratchMemory != VK_NULL_HANDLE) {
-            vkFreeMemory(vkrt->core.device, update->blasBuilds[i].scratchMemory, NULL);
-        }
-    }
     free(update->blasBuilds);
     update->blasBuilds = NULL;
     update->blasBuildCount = 0;
+    update->blasCompactionQueryCount = 0;
+
+    if (update->blasScratchCapacity > kBLASScratchRetainBytes) {
+        destroyBufferResources(vkrt, &update->blasScratch);
+        update->blasScratchCapacity = 0;
+    }
+}
+
+void vkrtCleanupPendingBLASCompactions(VKRT* vkrt, FrameSceneUpdate* update) {
+    if (!vkrt || !update) return;
+    for (uint32_t i = 0; i < update->blasCompactionCount; i++) {
+        vkrtDestroyAccelerationStructureResources(vkrt, &update->blasCompactions[i].source);
+    }
+    free(update->blasCompactions);
+    update->blasCompactions = NULL;
+    update->blasCompactionCount = 0;
 }
 
 void vkrtCleanupFrameSceneUpdate(VKRT* vkrt, uint32_t frameIndex) {
@@ -54,32 +76,40 @@ void vkrtCleanupFrameSceneUpdate(VKRT* vkrt, uint32_t frameIndex) {
 
     FrameSceneUpdate* update = &vkrt->runtime.frameSceneUpdates[frameIndex];
 
-    for (uint32_t i = 0; i < update->sceneTransferCount; i++) {
-        if (update->sceneTransfers[i].stagingBuffer != VK_NULL_HANDLE) {
-            vkDestroyBuffer(vkrt->core.device, update->sceneTransfers[i].stagingBuffer, NULL);
-        }
-        if (update->sceneTransfers[i].stagingMemory != VK_NULL_HANDLE) {
-            vkFreeMemory(vkrt->core.device, update->sceneTransfers[i].stagingMemory, NULL);
-        }
-    }
-    free(update->sceneTransfers);
-    update->sceneTransfers = NULL;
     update->sceneTransferCount = 0;
-
     vkrtCleanupPendingGeometryUploads(vkrt, update);
     vkrtCleanupPendingBLASBuilds(vkrt, update);
+    vkrtCleanupPendingBLASCompactions(vkrt, update);
+    vkrtResetStagingRing(vkrt, frameIndex);
 
-    destroyTransfer(vkrt, &update->sceneTLASInstanceBuffer);
-    destroyTransfer(vkrt, &update->sceneTLASScratch);
-    destroyTransfer(vkrt, &update->selectionTLASInstanceBuffer);
-    destroyTransfer(vkrt, &update->selectionTLASScratch);
-
-    update->sceneTLASInstanceCount = 0u;
-    update->selectionTLASInstanceCount = 0u;
+    update->sceneTLASBuildMode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
+    update->selectionTLASBuildMode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
     update->sceneTLASBuildPending = VK_FALSE;
     update->selectionTLASBuildPending = VK_FALSE;
 }
 
+void vkrtDestroyFrameSceneUpdate(VKRT* vkrt, uint32_t frameIndex) {
+    if (!vkrt || frameIndex >= VKRT_MAX_FRAMES_IN_FLIGHT) return;
+
+    FrameSceneUpdate* update = &vkrt->runtime.frameSceneUpdates[frameIndex];
+    vkrtCleanupFrameSceneUpdate(vkrt, frameIndex);
+    vkrtDestroyStagingRing(vkrt, frameIndex);
+    free(update->sceneTransfers);
+    update->sceneTransfers = NULL;
+    update->sceneTransferCapacity = 0;
+
+    destroyBufferResources(vkrt, &update->blasScratch);
+    update->blasScratchCapacity = 0;
+    if (update->blasCompactionQueryPool != VK_NULL_HANDLE) {
+        vkDestroyQueryPool(vkrt->core.device, update->blasCompactionQueryPool, NULL);
+        update->blasCompactionQueryPool = VK_NULL_HANDLE;
+    }
+    update->blasCompactionQueryCapacity = 0;
+    free(update->blasCompactionCandidates);
+    update->blasCompactionCandidates = NULL;
+    update->blasCompactionCandidateCount = 0;
+}
+
 void vkrtDestroyMeshAccelerationStructure(VKRT* vkrt, Mesh* mesh) {
     if (!mesh) return;
     vkrtDestroyAccelerationStructureResources(vkrt, &mesh->bottomLevelAccelerationStructure);
@@ -104,25 +134,14 @@ VKRT_Result vkrtSceneRebuildMaterialBuffer(VKRT* vkrt) {
             return result;
         }
 
-        result = vkrtSceneRebuildLightBuffers(vkrt);
-        if (result != VKRT_SUCCESS) {
-            destroyBufferResources(vkrt, &nextMaterialData);
-            return result;
-        }
         *materialData = nextMaterialData;
         destroyBufferResources(vkrt, &previousMaterialData);
+        clearMaterialDirtyRange(vkrt);
         return VKRT_SUCCESS;
     }
 
-    Material* materials = (Material*)malloc((size_t)materialCount * sizeof(Material));
-    if (!materials) {
-        LOG_ERROR("Failed to allocate material buffer");
-        return VKRT_ERROR_OPERATION_FAILED;
-    }
-
-    for (uint32_t i = 0; i < materialCount; i++) {
-        materials[i] = vkrt->core.materials[i].material;
-    }
+    Material* materials = collectMaterials(vkrt, 0u, materialCount);
+    if (!materials) return VKRT_ERROR_OPERATION_FAILED;
 
     VKRT_Result result = createDeviceBufferFromData(
         vkrt,
@@ -138,14 +157,46 @@ VKRT_Result vkrtSceneRebuildMaterialBuffer(VKRT* vkrt) {
     free(materials);
     if (result != VKRT_SUCCESS) return result;
 
-    result = vkrtSceneRebuildLightBuffers(vkrt);
-    if (result != VKRT_SUCCESS) {
-        destroyBufferResources(vkrt, &nextMaterialData);
-        return result;
-    }
-
     *materialData = nextMaterialData;
     destroyBufferResources(vkrt, &previousMaterialData);
+    clearMaterialDirtyRange(vkrt);
+    return VKRT_SUCCESS;
+}
+
+int vkrtSceneMaterialBufferPatchable(const VKRT* vkrt) {
+    if (!vkrt) return 0;
+
+    // Edits only overwrite their own records; a count change means the buffer itself has to be reallocated.
+    const Buffer* materialData = &vkrt->core.sceneMaterialData;
+    return materialData->buffer != VK_NULL_HANDLE && materialData->count == vkrt->core.materialCount &&
+           vkrt->core.materialDirtyEnd <= vkrt->core.materialCount;
+}
+
+VKRT_Result vkrtScenePatchMaterialBuffer(VKRT* vkrt) {
+    if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
+
+    uint32_t first = vkrt->core.materialDirtyBegin;
+    uint32_t end = vkrt->core.materialDirtyEnd;
+    if (end <= first) return VKRT_SUCCESS;
+
+    Buffer* materialData = getMaterialData(vkrt);
+    if (!vkrtSceneMaterialBufferPatchable(vkrt)) return VKRT_ERROR_OPERATION_FAILED;
+
+    uint32_t count = end - first;
+    Material* materials = collectMaterials(vkrt, first, count);
+    if (!materials) return VKRT_ERROR_OPERATION_FAILED;
+
+    VKRT_Result result = updateDeviceBufferRangeFromData(
+        vkrt,
+        materials,
+        (VkDeviceSize)count * sizeof(Material),
+        materialData->buffer,
+        (VkDeviceSize)first * sizeof(Material)
+    );
+    free(materials);
+    if (result != VKRT_SUCCESS) return result;
+
+    clearMaterialDirtyRange(vkrt);
     return VKRT_SUCCESS;
 }
 
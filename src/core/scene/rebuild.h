@@ -6,7 +6,11 @@
 
 void vkrtCleanupPendingGeometryUploads(VKRT* vkrt, FrameSceneUpdate* update);
 void vkrtCleanupPendingBLASBuilds(VKRT* vkrt, FrameSceneUpdate* update);
+void vkrtCleanupPendingBLASCompactions(VKRT* vkrt, FrameSceneUpdate* update);
 void vkrtCleanupFrameSceneUpdate(VKRT* vkrt, uint32_t frameIndex);
+void vkrtDestroyFrameSceneUpdate(VKRT* vkrt, uint32_t frameIndex);
 void vkrtDestroyMeshAccelerationStructure(VKRT* vkrt, Mesh* mesh);
 VKRT_Result vkrtSceneRebuildMaterialBuffer(VKRT* vkrt);
+int vkrtSceneMaterialBufferPatchable(const VKRT* vkrt);
+VKRT_Result vkrtScenePatchMaterialBuffer(VKRT* vkrt);
 VKRT_Result vkrtSceneRebuildTopLevelAccelerationStructures(VKRT* vkrt);
@@ -0,0 +1,205 @@
+#include "buffer.h"
+#include "constants.h"
+#include "debug.h"
+#include "scene.h"
+#include "vkrt_engine_types.h"
+#include "vkrt_types.h"
+#include "vulkan/vulkan_core.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// References:
+// Sobol direction numbers: Joe, Kuo, 2008 - https://web.maths.unsw.edu.au/~fkuo/sobol/
+// Void-and-cluster dither arrays: Ulichney, 1993 - https://doi.org/10.1117/12.152707
+
+typedef struct SobolPolynomial {
+    uint32_t degree;
+    uint32_t coefficients;
+    uint32_t initialNumbers[3];
+} SobolPolynomial;
+
+// Dimensions 2-4 of the Joe-Kuo table; the first dimension is the van der Corput sequence.
+static const SobolPolynomial kSobolPolynomials[VKRT_SOBOL_DIMENSION_COUNT - 1u] = {
+    {1u, 0u, {1u, 0u, 0u}},
+    {2u, 1u, {1u, 3u, 0u}},
+    {3u, 1u, {1u, 3u, 1u}},
+};
+
+static const uint32_t kBlueNoiseTexelCount = VKRT_BLUE_NOISE_SIZE * VKRT_BLUE_NOISE_SIZE;
+static const float kBlueNoiseSigma = 1.5f;
+static const uint32_t kBlueNoiseSeed = 0x9e3779b9u;
+
+static void buildSobolDirections(uint32_t* directions) {
+    for (uint32_t bit = 0; bit < VKRT_SOBOL_DIRECTION_BITS; bit++) {
+        directions[bit] = 1u << (31u - bit);
+    }
+
+    for (uint32_t dimension = 1u; dimension < VKRT_SOBOL_DIMENSION_COUNT; dimension++) {
+        const SobolPolynomial* polynomial = &kSobolPolynomials[dimension - 1u];
+        uint32_t* v = directions + dimension * VKRT_SOBOL_DIRECTION_BITS;
+        uint32_t degree = polynomial->degree;
+
+        for (uint32_t bit = 0; bit < VKRT_SOBOL_DIRECTION_BITS; bit++) {
+            if (bit < degree) {
+                v[bit] = polynomial->initialNumbers[bit] << (31u - bit);
+                continue;
+            }
+
+            uint32_t value = v[bit - degree] ^ (v[bit - degree] >> degree);
+            for (uint32_t term = 1u; term < degree; term++) {
+                if (((polynomial->coefficients >> (degree - 1u - term)) & 1u) != 0u) {
+                    value ^= v[bit - term];
+                }
+            }
+            v[bit] = value;
+        }
+    }
+}
+
+static uint32_t nextBlueNoiseRandom(uint32_t* state) {
+    uint32_t value = *state;
+    value ^= value << 13u;
+    value ^= value >> 17u;
+    value ^= value << 5u;
+    *state = value;
+    return value;
+}
+
+static void buildBlueNoiseKernel(float* kernel) {
+    const uint32_t size = VKRT_BLUE_NOISE_SIZE;
+    for (uint32_t y = 0; y < size; y++) {
+        float dy = (float)(y < size - y ? y : size - y);
+        for (uint32_t x = 0; x < size; x++) {
+            float dx = (float)(x < size - x ? x : size - x);
+            kernel[y * size + x] = expf(-(dx * dx + dy * dy) / (2.0f * kBlueNoiseSigma * kBlueNoiseSigma));
+        }
+    }
+}
+
+static void splatBlueNoiseEnergy(float* energy, const float* kernel, uint32_t texel, float sign) {
+    const uint32_t size = VKRT_BLUE_NOISE_SIZE;
+    uint32_t texelX = texel % size;
+    uint32_t texelY = texel / size;
+    for (uint32_t y = 0; y < size; y++) {
+        const float* kernelRow = kernel + ((y + size - texelY) % size) * size;
+        for (uint32_t x = 0; x < size; x++) {
+            energy[y * size + x] += sign * kernelRow[(x + size - texelX) % size];
+        }
+    }
+}
+
+// Tightest cluster is the highest-energy set texel, largest void the lowest-energy empty one.
+static uint32_t findBlueNoiseExtreme(const float* energy, const uint8_t* pattern, uint8_t set) {
+    uint32_t best = 0u;
+    float bestEnergy = set ? -INFINITY : INFINITY;
+    for (uint32_t texel = 0; texel < kBlueNoiseTexelCount; texel++) {
+        if (pattern[texel] != set) continue;
+        if (set ? energy[texel] > bestEnergy : energy[texel] < bestEnergy) {
+            bestEnergy = energy[texel];
+            best = texel;
+        }
+    }
+    return best;
+}
+
+// Ranks every texel of a tileable mask with void-and-cluster. Once the initial pattern is ranked the remaining
+// texels are filled void by void, which skips Ulichney's separate majority phase at no visible cost for a mask
+// this small.
+static VKRT_Result buildBlueNoiseRanks(uint32_t* ranks) {
+    float* kernel = (float*)malloc(sizeof(float) * kBlueNoiseTexelCount);
+    float* energy = (float*)calloc(kBlueNoiseTexelCount, sizeof(float));
+    float* rankingEnergy = (float*)malloc(sizeof(float) * kBlueNoiseTexelCount);
+    uint8_t* pattern = (uint8_t*)calloc(kBlueNoiseTexelCount, sizeof(uint8_t));
+    uint8_t* rankingPattern = (uint8_t*)malloc(sizeof(uint8_t) * kBlueNoiseTexelCount);
+    if (!kernel || !energy || !rankingEnergy || !pattern || !rankingPattern) {
+        free(kernel);
+        free(energy);
+        free(rankingEnergy);
+        free(pattern);
+        free(rankingPattern);
+        return VKRT_ERROR_OUT_OF_MEMORY;
+    }
+
+    buildBlueNoiseKernel(kernel);
+
+    uint32_t randomState = kBlueNoiseSeed;
+    uint32_t initialCount = kBlueNoiseTexelCount / 10u;
+    for (uint32_t placed = 0; placed < initialCount;) {
+        uint32_t texel = nextBlueNoiseRandom(&randomState) % kBlueNoiseTexelCount;
+        if (pattern[texel]) continue;
+        pattern[texel] = 1u;
+        splatBlueNoiseEnergy(energy, kernel, texel, 1.0f);
+        placed++;
+    }
+
+    for (uint32_t iteration = 0; iteration < kBlueNoiseTexelCount; iteration++) {
+        uint32_t cluster = findBlueNoiseExtreme(energy, pattern, 1u);
+        pattern[cluster] = 0u;
+        splatBlueNoiseEnergy(energy, kernel, cluster, -1.0f);
+
+        uint32_t voidTexel = findBlueNoiseExtreme(energy, pattern, 0u);
+        pattern[voidTexel] = 1u;
+        splatBlueNoiseEnergy(energy, kernel, voidTexel, 1.0f);
+        if (voidTexel == cluster) break;
+    }
+
+    memcpy(rankingPattern, pattern, sizeof(uint8_t) * kBlueNoiseTexelCount);
+    memcpy(rankingEnergy, energy, sizeof(float) * kBlueNoiseTexelCount);
+    for (uint32_t rank = initialCount; rank > 0u; rank--) {
+        uint32_t cluster = findBlueNoiseExtreme(rankingEnergy, rankingPattern, 1u);
+        rankingPattern[cluster] = 0u;
+        splatBlueNoiseEnergy(rankingEnergy, kernel, cluster, -1.0f);
+        ranks[cluster] = rank - 1u;
+    }
+
+    for (uint32_t rank = initialCount; rank < kBlueNoiseTexelCount; rank++) {
+        uint32_t voidTexel = findBlueNoiseExtreme(energy, pattern, 0u);
+        pattern[voidTexel] = 1u;
+        splatBlueNoiseEnergy(energy, kernel, voidTexel, 1.0f);
+        ranks[voidTexel] = rank;
+    }
+
+    free(kernel);
+    free(energy);
+    free(rankingEnergy);
+    free(pattern);
+    free(rankingPattern);
+    return VKRT_SUCCESS;
+}
+
+VKRT_Result createSamplerResources(VKRT* vkrt) {
+    if (!vkrt) return VKRT_ERROR_INVALID_ARGUMENT;
+
+    const uint32_t directionCount = VKRT_SOBOL_DIMENSION_COUNT * VKRT_SOBOL_DIRECTION_BITS;
+    const uint32_t valueCount = directionCount + kBlueNoiseTexelCount;
+    uint32_t* data = (uint32_t*)malloc(sizeof(uint32_t) * valueCount);
+    if (!data) return VKRT_ERROR_OUT_OF_MEMORY;
+
+    buildSobolDirections(data);
+    VKRT_Result result = buildBlueNoiseRanks(data + directionCount);
+    if (result != VKRT_SUCCESS) {
+        LOG_ERROR("Building blue noise mask failed");
+        free(data);
+        return result;
+    }
+
+    Buffer buffer = {0};
+    result = createDeviceBufferFromDataImmediate(
+        vkrt,
+        data,
+        (VkDeviceSize)(sizeof(uint32_t) * valueCount),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+        &buffer.buffer,
+        &buffer.memory,
+        &buffer.deviceAddress
+    );
+    free(data);
+    if (result != VKRT_SUCCESS) return result;
+
+    buffer.count = valueCount;
+    vkrt->core.sceneSamplerData = buffer;
+    return VKRT_SUCCESS;
+}
@@ -6,6 +6,7 @@ void applyCameraInput(VKRT* vkrt, const VKRT_CameraInput* input);
 void recordFrameTime(VKRT* vkrt, uint32_t frameIndex);
 VKRT_Result createSceneUniform(VKRT* vkrt);
 VKRT_Result createRGB2SpecResources(VKRT* vkrt);
+VKRT_Result createSamplerResources(VKRT* vkrt);
 void markSelectionMaskDirty(VKRT* vkrt);
 void resetSceneData(VKRT* vkrt);
 void syncSceneStateData(VKRT* vkrt);
@@ -13,6 +14,8 @@ void syncAllSceneDataFrames(VKRT* vkrt);
 void syncSelectionSceneData(VKRT* vkrt);
 void syncCurrentFrameSceneData(VKRT* vkrt);
 void syncCameraMatrices(VKRT* vkrt);
+void invalidateReservoirHistory(VKRT* vkrt);
+void advanceReservoirHistory(VKRT* vkrt);
 void updateCamera(VKRT* vkrt);
 void updateAutoSPP(VKRT* vkrt);
 void resetAutoSPPState(VKRT* vkrt, VkBool32 resetSamplesPerPixel);
@@ -25,8 +28,15 @@ void recordAutoExposureReadback(
     VkImage accumulationImage,
     VkExtent2D renderExtent
 );
+VKRT_Result createAdaptiveSamplingResources(VKRT* vkrt);
+void destroyAdaptiveSamplingResources(VKRT* vkrt);
+void resetAdaptiveSamplingState(VKRT* vkrt);
+void resolveAdaptiveSamplingReadback(VKRT* vkrt, uint32_t frameIndex);
+void recordAdaptiveSamplingReadback(VKRT* vkrt, VkCommandBuffer commandBuffer);
+uint8_t adaptiveSamplingConverged(const VKRT* vkrt);
 void VKRT_buildMeshTransformMatrix(const vec3 position, const vec3 rotationDegrees, const vec3 scale, mat4 outMatrix);
 void VKRT_buildImportedNodeTransform(mat4 worldTransform, mat4 outEngineTransform);
 void VKRT_decomposeMeshNodeTransform(mat4 worldTransform, vec3 outPosition, vec3 outRotation, vec3 outScale);
 void VKRT_decomposeMeshTransform(mat4 worldTransform, vec3 outPosition, vec3 outRotation, vec3 outScale);
 VkTransformMatrixKHR getMeshWorldTransform(const Mesh* mesh);
+void packMeshInfoTransform(mat4 worldTransform, MeshInfo* outInfo);
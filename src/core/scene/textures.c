@@ -7,6 +7,7 @@
 #include "image.h"
 #include "images.h"
 #include "io.h"
+#include "mipmap.h"
 #include "platform.h"
 #include "scene.h"
 #include "state.h"
@@ -20,6 +21,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+static const float kTextureMaxAnisotropy = 16.0f;
+
 typedef struct TextureSlotAccess {
     uint32_t textureSlot;
     uint32_t* index;
@@ -36,6 +39,8 @@ typedef struct TextureUploadDesc {
     uint32_t height;
     uint32_t format;
     uint32_t colorSpace;
+    uint32_t mipLevelCount;
+    const size_t* mipLevelOffsets;
 } TextureUploadDesc;
 
 static void resetMaterialTextureTexcoordSet(uint32_t* packedSets, uint32_t textureSlot) {
@@ -153,8 +158,13 @@ static VKRT_Result createTextureSamplerVariant(VKRT* vkrt, uint32_t samplerIndex
     createInfo.addressModeU = textureAddressMode(kWrapModes[wrapS]);
     createInfo.addressModeV = textureAddressMode(kWrapModes[wrapT]);
     createInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
-    createInfo.maxLod = 0.0f;
-    createInfo.maxAnisotropy = 1.0f;
+    createInfo.minLod = 0.0f;
+    createInfo.maxLod = VK_LOD_CLAMP_NONE;
+    createInfo.anisotropyEnable = vkrt->core.maxSamplerAnisotropy > 1.0f ? VK_TRUE : VK_FALSE;
+    createInfo.maxAnisotropy = kTextureMaxAnisotropy;
+    if (vkrt->core.maxSamplerAnisotropy < createInfo.maxAnisotropy) {
+        createInfo.maxAnisotropy = vkrt->core.maxSamplerAnisotropy;
+    }
     createInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
 
     return vkCreateSampler(vkrt->core.device, &createInfo, NULL, &vkrt->core.textureSamplers[samplerIndex]) ==
@@ -220,17 +230,90 @@ static int queryTextureVkFormat(uint32_t format, uint32_t colorSpace, VkFormat*
             if (colorSpace != VKRT_TEXTURE_COLOR_SPACE_LINEAR) return 0;
             *outFormat = VK_FORMAT_R32G32B32A32_SFLOAT;
             return 1;
+        case VKRT_TEXTURE_FORMAT_BC1_RGBA_UNORM:
+            *outFormat = colorSpace == VKRT_TEXTURE_COLOR_SPACE_SRGB ? VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+                                                                     : VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+            return 1;
+        case VKRT_TEXTURE_FORMAT_BC1_RGB_UNORM:
+            *outFormat = colorSpace == VKRT_TEXTURE_COLOR_SPACE_SRGB ? VK_FORMAT_BC1_RGB_SRGB_BLOCK
+                                                                     : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+            return 1;
+        case VKRT_TEXTURE_FORMAT_BC3_RGBA_UNORM:
+            *outFormat =
+                colorSpace == VKRT_TEXTURE_COLOR_SPACE_SRGB ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+            return 1;
+        case VKRT_TEXTURE_FORMAT_BC4_R_UNORM:
+            if (colorSpace != VKRT_TEXTURE_COLOR_SPACE_LINEAR) return 0;
+            *outFormat = VK_FORMAT_BC4_UNORM_BLOCK;
+            return 1;
+        case VKRT_TEXTURE_FORMAT_BC5_RG_UNORM:
+            if (colorSpace != VKRT_TEXTURE_COLOR_SPACE_LINEAR) return 0;
+            *outFormat = VK_FORMAT_BC5_UNORM_BLOCK;
+            return 1;
+        case VKRT_TEXTURE_FORMAT_BC7_RGBA_UNORM:
+            *outFormat =
+                colorSpace == VKRT_TEXTURE_COLOR_SPACE_SRGB ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+            return 1;
         default:
             return 0;
     }
 }
 
+static int textureUploadProvidesMipLevels(uint32_t format, uint32_t mipLevelCount) {
+    return mipLevelCount > 1u || vkrtTextureFormatIsBlockCompressed(format);
+}
+
+// Prebuilt level chains are staged as one contiguous span starting at pixels; offsets must stay block aligned.
+static int queryProvidedTextureLevels(
+    uint32_t width,
+    uint32_t height,
+    uint32_t format,
+    uint32_t mipLevelCount,
+    const size_t* mipLevelOffsets,
+    VkDeviceSize* outLevelOffsets,
+    VkDeviceSize* outByteSize
+) {
+    uint32_t levelCount = mipLevelCount > 0u ? mipLevelCount : 1u;
+    if (levelCount > vkrtQueryTextureMipLevelCount(width, height) || (levelCount > 1u && !mipLevelOffsets)) return 0;
+
+    VkDeviceSize byteSize = 0u;
+    for (uint32_t level = 0; level < levelCount; level++) {
+        uint32_t levelWidth = (width >> level) > 0u ? width >> level : 1u;
+        uint32_t levelHeight = (height >> level) > 0u ? height >> level : 1u;
+        size_t levelBytes = 0u;
+        size_t offset = mipLevelOffsets ? mipLevelOffsets[level] : 0u;
+        if (!vkrtTryComputeTextureByteSize(levelWidth, levelHeight, format, &levelBytes) ||
+            (offset % vkrtTextureFormatBlockBytes(format)) != 0u || offset > SIZE_MAX - levelBytes) {
+            return 0;
+        }
+        if (outLevelOffsets) outLevelOffsets[level] = (VkDeviceSize)offset;
+        if ((VkDeviceSize)(offset + levelBytes) > byteSize) byteSize = (VkDeviceSize)(offset + levelBytes);
+    }
+
+    if (outByteSize) *outByteSize = byteSize;
+    return 1;
+}
+
+static int textureUploadLayoutValid(const VKRT_TextureUpload* upload) {
+    size_t byteSize = 0u;
+    if (!vkrtTryComputeTextureByteSize(upload->width, upload->height, upload->format, &byteSize)) return 0;
+    if (!textureUploadProvidesMipLevels(upload->format, upload->mipLevelCount)) return 1;
+    return queryProvidedTextureLevels(
+        upload->width,
+        upload->height,
+        upload->format,
+        upload->mipLevelCount,
+        upload->mipLevelOffsets,
+        NULL,
+        NULL
+    );
+}
+
 static int uploadSceneTexture(VKRT* vkrt, const TextureUploadDesc* upload, SceneTexture* outTexture) {
     if (!upload || !upload->name || !upload->pixels || !outTexture) return 0;
 
     *outTexture = (SceneTexture){0};
     VkFormat vkFormat = VK_FORMAT_UNDEFINED;
-    size_t byteSize = 0u;
 
     if (!queryTextureVkFormat(upload->format, upload->colorSpace, &vkFormat)) {
         LOG_ERROR(
@@ -240,25 +323,61 @@ static int uploadSceneTexture(VKRT* vkrt, const TextureUploadDesc* upload, Scene
         );
         return 0;
     }
-    if (!vkrtTryComputeTextureByteSize(upload->width, upload->height, upload->format, &byteSize)) {
+
+    if (vkrtTextureFormatIsBlockCompressed(upload->format) && !vkrt->core.textureCompressionBC) {
+        LOG_ERROR("Texture %s is block compressed but the device lacks BC texture support", upload->name);
         return 0;
     }
 
+    TextureMipChain mipChain = {0};
+    VkDeviceSize providedLevelOffsets[VKRT_TEXTURE_MAX_MIP_LEVELS] = {0};
     TextureImageUpload imageUpload = {
         .pixels = upload->pixels,
         .width = upload->width,
         .height = upload->height,
         .format = vkFormat,
-        .byteSize = (VkDeviceSize)byteSize,
+        .mipLevelCount = upload->mipLevelCount > 0u ? upload->mipLevelCount : 1u,
+        .mipLevelOffsets = providedLevelOffsets,
     };
-    if (vkrtCreateSampledTextureImageFromData(
-            vkrt,
-            &imageUpload,
-            &outTexture->image,
-            &outTexture->view,
-            &outTexture->memory
+    if (textureUploadProvidesMipLevels(upload->format, upload->mipLevelCount)) {
+        if (!queryProvidedTextureLevels(
+                upload->width,
+                upload->height,
+                upload->format,
+                upload->mipLevelCount,
+                upload->mipLevelOffsets,
+                providedLevelOffsets,
+                &imageUpload.byteSize
+            )) {
+            LOG_ERROR("Texture %s has an invalid mip level layout", upload->name);
+            return 0;
+        }
+    } else if (vkrtBuildTextureMipChain(
+            upload->pixels,
+            upload->width,
+            upload->height,
+            upload->format,
+            upload->colorSpace,
+            &mipChain
         ) != VKRT_SUCCESS) {
         return 0;
+    } else {
+        imageUpload.pixels = mipChain.pixels;
+        imageUpload.byteSize = mipChain.byteSize;
+        imageUpload.mipLevelCount = mipChain.levelCount;
+        imageUpload.mipLevelOffsets = mipChain.levelOffsets;
+    }
+
+    VKRT_Result result = vkrtCreateSampledTextureImageFromData(
+        vkrt,
+        &imageUpload,
+        &outTexture->image,
+        &outTexture->view,
+        &outTexture->memory
+    );
+    vkrtReleaseTextureMipChain(&mipChain);
+    if (result != VKRT_SUCCESS) {
+        return 0;
     }
 
     outTexture->width = upload->width;
@@ -296,13 +415,9 @@ static VKRT_Result validateTextureUploads(const VKRT* vkrt, const VKRT_TextureUp
 
     for (size_t uploadIndex = 0; uploadIndex < uploadCount; uploadIndex++) {
         const VKRT_TextureUpload* upload = &uploads[uploadIndex];
-        if (!vkrtTextureUploadValid(upload)) return VKRT_ERROR_INVALID_ARGUMENT;
-
-        size_t byteSize = 0u;
-        if (!vkrtTryComputeTextureByteSize(upload->width, upload->height, upload->format, &byteSize)) {
+        if (!vkrtTextureUploadValid(upload) || !textureUploadLayoutValid(upload)) {
             return VKRT_ERROR_INVALID_ARGUMENT;
         }
-        (void)byteSize;
     }
 
     return VKRT_SUCCESS;
@@ -401,18 +516,11 @@ VKRT_Result vkrtSceneAddTextureFromPixels(VKRT* vkrt, const VKRT_TextureUpload*
     if (outTextureIndex) *outTextureIndex = VKRT_INVALID_INDEX;
     VKRT_Result stateReady = vkrtRequireSceneStateReady(vkrt);
     if (stateReady != VKRT_SUCCESS) return stateReady;
-    if (!vkrtTextureUploadValid(upload)) return VKRT_ERROR_INVALID_ARGUMENT;
+    if (!vkrtTextureUploadValid(upload) || !textureUploadLayoutValid(upload)) return VKRT_ERROR_INVALID_ARGUMENT;
 
-    size_t byteSize = 0u;
-    if (!vkrtTryComputeTextureByteSize(upload->width, upload->height, upload->format, &byteSize)) {
-        return VKRT_ERROR_INVALID_ARGUMENT;
-    }
-    (void)byteSize;
-
-    VKRT_Result result = vkrtWaitForAllInFlightFrames(vkrt);
-    if (result != VKRT_SUCCESS) return result;
-
-    result = vkrtEnsureTextureBindings(vkrt);
+    // Frames in flight never see the new texture: the next frame's submit waits on the transfer timeline and
+    // acquires the image before its descriptor set is rewritten, so adding one does not stall rendering.
+    VKRT_Result result = vkrtEnsureTextureBindings(vkrt);
     if (result != VKRT_SUCCESS) return result;
 
     SceneTexture texture = {0};
@@ -423,6 +531,8 @@ VKRT_Result vkrtSceneAddTextureFromPixels(VKRT* vkrt, const VKRT_TextureUpload*
         .height = upload->height,
         .format = upload->format,
         .colorSpace = upload->colorSpace,
+        .mipLevelCount = upload->mipLevelCount,
+        .mipLevelOffsets = upload->mipLevelOffsets,
     };
     if (!uploadSceneTexture(vkrt, &uploadDesc, &texture)) {
         return VKRT_ERROR_OPERATION_FAILED;
@@ -446,9 +556,6 @@ VKRT_Result vkrtSceneAddTexturesBatch(
     VKRT_Result result = validateTextureUploads(vkrt, uploads, uploadCount);
     if (result != VKRT_SUCCESS) return result;
 
-    result = vkrtWaitForAllInFlightFrames(vkrt);
-    if (result != VKRT_SUCCESS) return result;
-
     result = vkrtEnsureTextureBindings(vkrt);
     if (result != VKRT_SUCCESS) return result;
 
@@ -462,6 +569,8 @@ VKRT_Result vkrtSceneAddTexturesBatch(
             .height = uploads[i].height,
             .format = uploads[i].format,
             .colorSpace = uploads[i].colorSpace,
+            .mipLevelCount = uploads[i].mipLevelCount,
+            .mipLevelOffsets = uploads[i].mipLevelOffsets,
         };
         if (!uploadSceneTexture(vkrt, &upload, &texture)) {
             result = VKRT_ERROR_OPERATION_FAILED;
@@ -509,6 +618,8 @@ VKRT_Result vkrtSceneAddTextureFromFile(
         .height = image.height,
         .format = image.format,
         .colorSpace = image.colorSpace,
+        .mipLevelCount = image.mipLevelCount,
+        .mipLevelOffsets = image.mipLevelOffsets,
     };
     VKRT_Result result = vkrtSceneAddTextureFromPixels(vkrt, &upload, outTextureIndex);
     vkrtFreeLoadedImage(&image);
@@ -616,7 +727,13 @@ VKRT_Result vkrtSceneSetMaterialTexture(
     resetMaterialTextureTexcoordSet(access.texcoordSets, access.textureSlot);
     setIdentityMaterialTextureTransform(*access.transform);
     *access.rotation = 0.0f;
-    vkrtMarkMaterialResourcesDirty(vkrt);
+    vkrtMarkMaterialRangeDirty(vkrt, materialIndex);
+    // Textured emitters are excluded from direct light sampling, so toggling the emissive map changes the light set.
+    if (access.textureSlot == VKRT_MATERIAL_TEXTURE_SLOT_EMISSIVE &&
+        (previousTextureIndex == VKRT_INVALID_INDEX) != (textureIndex == VKRT_INVALID_INDEX) &&
+        material->emissionLuminance > 0.0f && vkrtCountMaterialUsers(vkrt, materialIndex) > 0u) {
+        vkrtMarkLightResourcesDirty(vkrt);
+    }
     resetSceneData(vkrt);
     return vkrtReleaseTextureIfUnused(vkrt, previousTextureIndex);
 }
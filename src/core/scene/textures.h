@@ -26,39 +26,22 @@ static inline int vkrtTextureFormatValid(uint32_t format) {
 }
 
 static inline int vkrtTextureFormatAcceptsSRGBInput(uint32_t format) {
-    return format == VKRT_TEXTURE_FORMAT_RGBA8_UNORM;
-}
-
-static inline int vkrtTextureFormatCompatibleWithColorSpace(uint32_t format, uint32_t colorSpace) {
-    if (!vkrtTextureFormatValid(format) || !vkrtTextureColorSpaceValid(colorSpace)) return 0;
-    if (colorSpace == VKRT_TEXTURE_COLOR_SPACE_LINEAR) return 1;
-    return vkrtTextureFormatAcceptsSRGBInput(format);
-}
-
-static inline uint32_t vkrtTextureFormatBytesPerChannel(uint32_t format) {
     switch (format) {
         case VKRT_TEXTURE_FORMAT_RGBA8_UNORM:
-            return 1u;
-        case VKRT_TEXTURE_FORMAT_RGBA16_UNORM:
-        case VKRT_TEXTURE_FORMAT_RGBA16_SFLOAT:
-            return 2u;
-        case VKRT_TEXTURE_FORMAT_RGBA32_SFLOAT:
-            return 4u;
+        case VKRT_TEXTURE_FORMAT_BC1_RGBA_UNORM:
+        case VKRT_TEXTURE_FORMAT_BC1_RGB_UNORM:
+        case VKRT_TEXTURE_FORMAT_BC3_RGBA_UNORM:
+        case VKRT_TEXTURE_FORMAT_BC7_RGBA_UNORM:
+            return 1;
         default:
-            return 0u;
+            return 0;
     }
 }
 
-static inline int vkrtTryComputeTextureByteSize(uint32_t width, uint32_t height, uint32_t format, size_t* outBytes) {
-    if (!outBytes || width == 0u || height == 0u) return 0;
-    uint32_t bytesPerChannel = vkrtTextureFormatBytesPerChannel(format);
-    if (bytesPerChannel == 0u) return 0;
-
-    size_t rowBytes = (size_t)width * 4u * (size_t)bytesPerChannel;
-    if ((size_t)height > SIZE_MAX / rowBytes) return 0;
-
-    *outBytes = rowBytes * (size_t)height;
-    return 1;
+static inline int vkrtTextureFormatCompatibleWithColorSpace(uint32_t format, uint32_t colorSpace) {
+    if (!vkrtTextureFormatValid(format) || !vkrtTextureColorSpaceValid(colorSpace)) return 0;
+    if (colorSpace == VKRT_TEXTURE_COLOR_SPACE_LINEAR) return 1;
+    return vkrtTextureFormatAcceptsSRGBInput(format);
 }
 
 static inline int vkrtTextureUploadValid(const VKRT_TextureUpload* upload) {
@@ -221,3 +221,33 @@ VkTransformMatrixKHR getMeshWorldTransform(const Mesh* mesh) {
 
     return transform;
 }
+
+void packMeshInfoTransform(mat4 worldTransform, MeshInfo* outInfo) {
+    if (!worldTransform || !outInfo) return;
+
+    for (int rowIndex = 0; rowIndex < 3; ++rowIndex) {
+        for (int columnIndex = 0; columnIndex < 4; ++columnIndex) {
+            outInfo->objectToWorld[rowIndex][columnIndex] = worldTransform[columnIndex][rowIndex];
+        }
+    }
+
+    // The cofactor matrix is the inverse-transpose scaled by the determinant, so it
+    // keeps shear and non-uniform scale without dividing by a possibly tiny determinant.
+    vec3 column0 = {worldTransform[0][0], worldTransform[0][1], worldTransform[0][2]};
+    vec3 column1 = {worldTransform[1][0], worldTransform[1][1], worldTransform[1][2]};
+    vec3 column2 = {worldTransform[2][0], worldTransform[2][1], worldTransform[2][2]};
+    vec3 cofactors[3];
+    glm_vec3_cross(column1, column2, cofactors[0]);
+    glm_vec3_cross(column2, column0, cofactors[1]);
+    glm_vec3_cross(column0, column1, cofactors[2]);
+
+    float determinant = glm_vec3_dot(column0, cofactors[0]);
+    float sign = determinant < 0.0f ? -1.0f : 1.0f;
+    for (int rowIndex = 0; rowIndex < 3; ++rowIndex) {
+        for (int columnIndex = 0; columnIndex < 3; ++columnIndex) {
+            outInfo->normalToWorld[rowIndex][columnIndex] = cofactors[columnIndex][rowIndex] * sign;
+        }
+        outInfo->normalToWorld[rowIndex][3] = 0.0f;
+    }
+    outInfo->transformSign = sign;
+}
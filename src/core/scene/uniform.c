@@ -1,3 +1,4 @@
+#include "allocator.h"
 #include "buffer.h"
 #include "config.h"
 #include "constants.h"
@@ -34,15 +35,8 @@ static VKRT_Result createSceneFrameUniformBuffers(VKRT* vkrt, VkDeviceSize unifo
             return VKRT_ERROR_OPERATION_FAILED;
         }
 
-        if (vkMapMemory(
-                vkrt->core.device,
-                vkrt->core.sceneDataMemories[frameIndex],
-                0,
-                uniformBufferSize,
-                0,
-                (void**)&vkrt->core.sceneFrameData[frameIndex]
-            ) != VK_SUCCESS ||
-            !vkrt->core.sceneFrameData[frameIndex]) {
+        vkrt->core.sceneFrameData[frameIndex] = vkrtMappedMemory(vkrt->core.sceneDataMemories[frameIndex]);
+        if (!vkrt->core.sceneFrameData[frameIndex]) {
             return VKRT_ERROR_OPERATION_FAILED;
         }
 
@@ -65,15 +59,8 @@ static VKRT_Result createSelectionState(VKRT* vkrt) {
         return VKRT_ERROR_OPERATION_FAILED;
     }
 
-    if (vkMapMemory(
-            vkrt->core.device,
-            vkrt->core.selection.memory,
-            0,
-            selectionSize,
-            0,
-            (void**)&vkrt->core.selectionData
-        ) != VK_SUCCESS ||
-        !vkrt->core.selectionData) {
+    vkrt->core.selectionData = vkrtMappedMemory(vkrt->core.selection.memory);
+    if (!vkrt->core.selectionData) {
         return VKRT_ERROR_OPERATION_FAILED;
     }
 
@@ -87,7 +74,8 @@ static VKRT_Result createSelectionState(VKRT* vkrt) {
     vkrt->core.selection.deviceAddress = 0;
     vkrt->core.selection.count = 1;
     markSelectionMaskDirty(vkrt);
-    return createAutoExposureReadbacks(vkrt);
+    if (createAutoExposureReadbacks(vkrt) != VKRT_SUCCESS) return VKRT_ERROR_OPERATION_FAILED;
+    return createAdaptiveSamplingResources(vkrt);
 }
 
 static void initializeDefaultSceneSettings(VKRT* vkrt, uint32_t initialWidth, uint32_t initialHeight) {
@@ -146,8 +134,14 @@ static void initializeDefaultSceneSettings(VKRT* vkrt, uint32_t initialWidth, ui
     vkrt->sceneSettings.timeStep = 0.5f;
     vkrt->sceneSettings.debugMode = VKRT_DEBUG_MODE_NONE;
     vkrt->sceneSettings.misNeeEnabled = 1u;
+    vkrt->sceneSettings.lightSamplingMode = VKRT_LIGHT_SAMPLING_MODE_BVH;
+    vkrt->sceneSettings.directLightingMode = VKRT_DIRECT_LIGHTING_MODE_NEE;
+    vkrt->sceneSettings.samplerMode = VKRT_SAMPLER_MODE_SOBOL;
     vkrt->sceneSettings.selectionEnabled = 0;
     vkrt->sceneSettings.selectedMeshIndex = VKRT_INVALID_INDEX;
+    vkrt->sceneSettings.noiseThreshold = 0.0f;
+    vkrt->renderControl.adaptiveSampling.terminationMode = VKRT_RENDER_TERMINATION_SAMPLES;
+    vkrt->renderControl.adaptiveSampling.timeLimitSeconds = 0.0f;
 }
 
 static void writeSceneStateUniform(SceneData* sceneData, const VKRT* vkrt) {
@@ -168,8 +162,14 @@ static void writeSceneStateUniform(SceneData* sceneData, const VKRT* vkrt) {
     sceneData->environmentRotation = settings->environmentRotation;
     sceneData->debugMode = settings->debugMode;
     sceneData->misNeeEnabled = settings->misNeeEnabled ? 1u : 0u;
+    sceneData->lightSamplingMode = settings->lightSamplingMode;
+    sceneData->directLightingMode = settings->directLightingMode;
+    sceneData->samplerMode = settings->samplerMode;
     sceneData->selectionEnabled = settings->selectionEnabled ? 1u : 0u;
     sceneData->selectedMeshIndex = settings->selectedMeshIndex;
+    sceneData->noiseThreshold = settings->noiseThreshold;
+    sceneData->adaptiveMinSamples = VKRT_ADAPTIVE_MIN_SAMPLES;
+    sceneData->adaptiveMaxSampleScale = VKRT_ADAPTIVE_MAX_SAMPLE_SCALE;
     sceneData->rgb2specSRGB = vkrt->core.rgb2specSRGBInfo;
 }
 
@@ -229,6 +229,7 @@ void resetSceneData(VKRT* vkrt) {
 
     resetAutoSPPForSceneChange(vkrt);
     resetAutoExposureForSceneChange(vkrt);
+    resetAdaptiveSamplingState(vkrt);
     vkrt->core.sceneData->frameNumber = 0;
     vkrt->renderStatus.renderPhase = VKRT_renderPhaseIsActive(vkrt->renderStatus.renderPhase)
                                        ? VKRT_RENDER_PHASE_SAMPLING
@@ -244,6 +245,25 @@ void resetSceneData(VKRT* vkrt) {
     memset(vkrt->renderStatus.frametimes, 0, sizeof(vkrt->renderStatus.frametimes));
 }
 
+void invalidateReservoirHistory(VKRT* vkrt) {
+    if (!vkrt || !vkrt->core.sceneData) return;
+    vkrt->core.sceneData->reservoirHistoryValid = 0u;
+}
+
+// Called once the frame that wrote the current reservoirs has been kept; its camera becomes the reprojection source.
+// Only the RGB integrator fills the reservoir images, so other render modes leave the history invalid.
+void advanceReservoirHistory(VKRT* vkrt) {
+    if (!vkrt || !vkrt->core.sceneData) return;
+
+    const VKRT_SceneSettingsSnapshot* settings = &vkrt->sceneSettings;
+    SceneData* sceneData = vkrt->core.sceneData;
+    memcpy(sceneData->prevViewInverse, sceneData->viewInverse, sizeof(sceneData->prevViewInverse));
+    memcpy(sceneData->prevProjInverse, sceneData->projInverse, sizeof(sceneData->prevProjInverse));
+    VkBool32 reservoirsWritten = settings->misNeeEnabled && settings->renderMode == VKRT_RENDER_MODE_RGB &&
+                                 settings->directLightingMode != VKRT_DIRECT_LIGHTING_MODE_NEE;
+    sceneData->reservoirHistoryValid = reservoirsWritten ? 1u : 0u;
+}
+
 void syncSelectionSceneData(VKRT* vkrt) {
     if (!vkrt || !vkrt->core.sceneData) return;
 
@@ -44,6 +44,7 @@ void vkrtSetInfoLoggingEnabled(int enabled);
             VKRT_LOG_LINE(stdout, "[INFO]", __VA_ARGS__); \
         }                                                 \
     } while (0)
+#define LOG_WARN(...) VKRT_LOG_LINE(stderr, "[WARN]", __VA_ARGS__)
 #define LOG_ERROR(...) VKRT_LOG_LINE(stderr, "[ERROR]", __VA_ARGS__)
 
 #if defined(__GNUC__) || defined(__clang__)
@@ -1,11 +1,25 @@
 #include "denoise.h"
 
 #include <OpenImageDenoise/oidn.h>
+#include <math.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+enum {
+    K_OIDN_FILTER_CACHE_SIZE = 6,
+};
+
+static const size_t kOIDNPixelStride = sizeof(float) * 4u;
+static const uint64_t kOIDNMaxCachedPixels = 3840ull * 2160ull;
+static const uint64_t kOIDNTiledPixelThreshold = 4096ull * 4096ull;
+static const uint32_t kOIDNTileSize = 2048u;
+static const uint32_t kOIDNTileOverlap = 64u;
+static const uint32_t kOIDNExposureBinSize = 16u;
+static const double kOIDNExposureKey = 0.18;
+
 static void setOIDNErrorMessage(const char** outErrorMessage, const char* message) {
     if (outErrorMessage) *outErrorMessage = message;
 }
@@ -26,260 +40,415 @@ typedef struct OIDNFilterConfig {
     uint8_t cleanAux;
 } OIDNFilterConfig;
 
-static int createOIDNBuffer(
-    OIDNDevice device,
-    const float* input,
-    size_t byteCount,
-    OIDNBuffer* outBuffer,
-    const char** outErrorMessage,
-    const char* label
-) {
-    if (!device || !input || !outBuffer || !label || !label[0]) return 0;
+typedef struct OIDNFilterSlot {
+    OIDNFilter filter;
+    OIDNBufferSet buffers;
+    const char* mainImageName;
+    uint32_t width;
+    uint32_t height;
+    uint8_t hasAlbedo;
+    uint8_t hasNormal;
+    uint8_t cleanAux;
+    float inputScale;
+    uint64_t lastUse;
+} OIDNFilterSlot;
+
+typedef struct OIDNTileRegion {
+    uint32_t x;
+    uint32_t y;
+    uint32_t innerX0;
+    uint32_t innerY0;
+    uint32_t innerX1;
+    uint32_t innerY1;
+} OIDNTileRegion;
+
+struct VKRT_OIDNContext {
+    OIDNDevice device;
+    uint32_t deviceThreadCount;
+    uint8_t devicePinThreads;
+    uint32_t threadCount;
+    uint8_t pinThreads;
+    uint64_t tiledPixelThreshold;
+    uint64_t useCounter;
+    OIDNFilterSlot slots[K_OIDN_FILTER_CACHE_SIZE];
+};
 
-    OIDNBuffer buffer = oidnNewBuffer(device, byteCount);
-    if (!buffer) {
-        (void)snprintf(oidnErrorStorage, sizeof(oidnErrorStorage), "failed to allocate OIDN %s buffer", label);
+static void releaseOIDNBuffer(OIDNBuffer* buffer) {
+    if (!buffer || !*buffer) return;
+    oidnReleaseBuffer(*buffer);
+    *buffer = NULL;
+}
+
+static void releaseOIDNFilterSlot(OIDNFilterSlot* slot) {
+    if (!slot) return;
+    releaseOIDNBuffer(&slot->buffers.output);
+    releaseOIDNBuffer(&slot->buffers.normal);
+    releaseOIDNBuffer(&slot->buffers.albedo);
+    releaseOIDNBuffer(&slot->buffers.color);
+    if (slot->filter) {
+        oidnReleaseFilter(slot->filter);
+    }
+    *slot = (OIDNFilterSlot){0};
+}
+
+static void releaseOIDNDevice(VKRT_OIDNContext* context) {
+    for (uint32_t i = 0; i < K_OIDN_FILTER_CACHE_SIZE; i++) {
+        releaseOIDNFilterSlot(&context->slots[i]);
+    }
+    if (context->device) {
+        oidnReleaseDevice(context->device);
+        context->device = NULL;
+    }
+}
+
+static int reportOIDNDeviceError(OIDNDevice device, const char* fallbackMessage, const char** outErrorMessage) {
+    const char* errorMessage = NULL;
+    if (oidnGetDeviceError(device, &errorMessage) == OIDN_ERROR_NONE) return 0;
+
+    if (errorMessage && errorMessage[0]) {
+        (void)snprintf(oidnErrorStorage, sizeof(oidnErrorStorage), "%s", errorMessage);
         setOIDNErrorMessage(outErrorMessage, oidnErrorStorage);
+    } else {
+        setOIDNErrorMessage(outErrorMessage, fallbackMessage);
+    }
+    return 1;
+}
+
+static int ensureOIDNDevice(VKRT_OIDNContext* context, const char** outErrorMessage) {
+    if (context->device && context->deviceThreadCount == context->threadCount &&
+        context->devicePinThreads == context->pinThreads) {
+        return 1;
+    }
+    releaseOIDNDevice(context);
+
+    context->device = oidnNewDevice(OIDN_DEVICE_TYPE_CPU);
+    if (!context->device) {
+        setOIDNErrorMessage(outErrorMessage, "failed to create OIDN device");
+        return 0;
+    }
+    if (context->threadCount > 0u) {
+        oidnSetDeviceInt(context->device, "numThreads", (int)context->threadCount);
+    }
+    oidnSetDeviceBool(context->device, "setAffinity", context->pinThreads != 0u);
+    oidnCommitDevice(context->device);
+    if (reportOIDNDeviceError(context->device, "failed to initialize OIDN device", outErrorMessage)) {
+        releaseOIDNDevice(context);
         return 0;
     }
 
-    oidnWriteBuffer(buffer, 0u, byteCount, input);
-    *outBuffer = buffer;
+    context->deviceThreadCount = context->threadCount;
+    context->devicePinThreads = context->pinThreads;
     return 1;
 }
 
-static int createOIDNOutputBuffer(
+static int createOIDNBuffer(
     OIDNDevice device,
-    const float* seedInput,
     size_t byteCount,
     OIDNBuffer* outBuffer,
-    const char** outErrorMessage
+    const char** outErrorMessage,
+    const char* label
 ) {
-    if (!device || !seedInput || !outBuffer) return 0;
+    if (!device || !outBuffer || !label || !label[0]) return 0;
 
     OIDNBuffer buffer = oidnNewBuffer(device, byteCount);
     if (!buffer) {
-        setOIDNErrorMessage(outErrorMessage, "failed to allocate OIDN output buffer");
+        (void)snprintf(oidnErrorStorage, sizeof(oidnErrorStorage), "failed to allocate OIDN %s buffer", label);
+        setOIDNErrorMessage(outErrorMessage, oidnErrorStorage);
         return 0;
     }
 
-    oidnWriteBuffer(buffer, 0u, byteCount, seedInput);
     *outBuffer = buffer;
     return 1;
 }
 
-static void releaseOIDNBuffer(OIDNBuffer* buffer) {
-    if (!buffer || !*buffer) return;
-    oidnReleaseBuffer(*buffer);
-    *buffer = NULL;
+static void setOIDNFilterImage(
+    OIDNFilter filter,
+    const char* name,
+    OIDNBuffer buffer,
+    uint32_t width,
+    uint32_t height
+) {
+    oidnSetFilterImage(
+        filter,
+        name,
+        buffer,
+        OIDN_FORMAT_FLOAT3,
+        width,
+        height,
+        0u,
+        kOIDNPixelStride,
+        kOIDNPixelStride * (size_t)width
+    );
 }
 
-static void releaseOIDNResources(
-    OIDNDevice* device,
-    OIDNFilter* filter,
-    OIDNBuffer* colorBuffer,
-    OIDNBuffer* albedoBuffer,
-    OIDNBuffer* normalBuffer,
-    OIDNBuffer* outputBuffer
+static int initializeOIDNFilterSlot(
+    OIDNDevice device,
+    const OIDNFilterConfig* config,
+    const VKRT_OIDNFilterInput* input,
+    uint32_t width,
+    uint32_t height,
+    OIDNFilterSlot* slot,
+    const char** outErrorMessage
 ) {
-    releaseOIDNBuffer(outputBuffer);
-    releaseOIDNBuffer(normalBuffer);
-    releaseOIDNBuffer(albedoBuffer);
-    releaseOIDNBuffer(colorBuffer);
-    if (filter && *filter) {
-        oidnReleaseFilter(*filter);
-        *filter = NULL;
-    }
-    if (device && *device) {
-        oidnReleaseDevice(*device);
-        *device = NULL;
-    }
-}
+    *slot = (OIDNFilterSlot){
+        .mainImageName = config->mainImageName,
+        .width = width,
+        .height = height,
+        .hasAlbedo = input->albedo != NULL,
+        .hasNormal = input->normal != NULL,
+        .cleanAux = config->cleanAux,
+        .inputScale = NAN,
+    };
 
-static int createOIDNFilterContext(OIDNDevice* outDevice, OIDNFilter* outFilter, const char** outErrorMessage) {
-    *outDevice = oidnNewDevice(OIDN_DEVICE_TYPE_CPU);
-    if (!*outDevice) {
-        setOIDNErrorMessage(outErrorMessage, "failed to create OIDN device");
+    slot->filter = oidnNewFilter(device, "RT");
+    if (!slot->filter) {
+        setOIDNErrorMessage(outErrorMessage, "failed to create OIDN RT filter");
         return 0;
     }
-    oidnCommitDevice(*outDevice);
 
-    *outFilter = oidnNewFilter(*outDevice, "RT");
-    if (!*outFilter) {
-        setOIDNErrorMessage(outErrorMessage, "failed to create OIDN RT filter");
+    const size_t byteCount = kOIDNPixelStride * (size_t)width * (size_t)height;
+    if (!createOIDNBuffer(device, byteCount, &slot->buffers.color, outErrorMessage, "color") ||
+        !createOIDNBuffer(device, byteCount, &slot->buffers.output, outErrorMessage, "output") ||
+        (slot->hasAlbedo && !createOIDNBuffer(device, byteCount, &slot->buffers.albedo, outErrorMessage, "albedo")) ||
+        (slot->hasNormal && !createOIDNBuffer(device, byteCount, &slot->buffers.normal, outErrorMessage, "normal"))) {
         return 0;
     }
 
-    return 1;
+    setOIDNFilterImage(slot->filter, config->mainImageName, slot->buffers.color, width, height);
+    if (slot->hasAlbedo && strcmp(config->mainImageName, "albedo") != 0) {
+        setOIDNFilterImage(slot->filter, "albedo", slot->buffers.albedo, width, height);
+    }
+    if (slot->hasNormal && strcmp(config->mainImageName, "normal") != 0) {
+        setOIDNFilterImage(slot->filter, "normal", slot->buffers.normal, width, height);
+    }
+    setOIDNFilterImage(slot->filter, "output", slot->buffers.output, width, height);
+    oidnSetFilterBool(slot->filter, "hdr", config->hdr != 0);
+    oidnSetFilterBool(slot->filter, "srgb", config->srgb != 0);
+    oidnSetFilterBool(slot->filter, "cleanAux", config->cleanAux != 0);
+    oidnSetFilterInt(slot->filter, "quality", OIDN_QUALITY_HIGH);
+    oidnCommitFilter(slot->filter);
+    return !reportOIDNDeviceError(device, "failed to commit OIDN filter", outErrorMessage);
 }
 
-static int createOIDNInputBuffers(
-    OIDNDevice device,
+// Filters and their buffers are keyed by role and extent so repeated jobs at one size skip weight loading.
+static OIDNFilterSlot* acquireOIDNFilterSlot(
+    VKRT_OIDNContext* context,
+    const OIDNFilterConfig* config,
     const VKRT_OIDNFilterInput* input,
-    size_t imageByteCount,
-    OIDNBufferSet* buffers,
-    const float* outputSeed,
+    uint32_t width,
+    uint32_t height,
     const char** outErrorMessage
 ) {
-    if (!buffers) return 0;
-
-    if (!createOIDNBuffer(device, input->color, imageByteCount, &buffers->color, outErrorMessage, "color")) {
-        return 0;
+    OIDNFilterSlot* victim = &context->slots[0];
+    for (uint32_t i = 0; i < K_OIDN_FILTER_CACHE_SIZE; i++) {
+        OIDNFilterSlot* slot = &context->slots[i];
+        if (slot->filter && strcmp(slot->mainImageName, config->mainImageName) == 0 && slot->width == width &&
+            slot->height == height && slot->hasAlbedo == (input->albedo != NULL) &&
+            slot->hasNormal == (input->normal != NULL) && slot->cleanAux == config->cleanAux) {
+            slot->lastUse = ++context->useCounter;
+            return slot;
+        }
+        if (!slot->filter) {
+            victim = slot;
+        } else if (victim->filter && slot->lastUse < victim->lastUse) {
+            victim = slot;
+        }
     }
 
-    if (!createOIDNOutputBuffer(device, outputSeed, imageByteCount, &buffers->output, outErrorMessage)) {
-        return 0;
+    releaseOIDNFilterSlot(victim);
+    if (!initializeOIDNFilterSlot(context->device, config, input, width, height, victim, outErrorMessage)) {
+        releaseOIDNFilterSlot(victim);
+        return NULL;
     }
+    victim->lastUse = ++context->useCounter;
+    return victim;
+}
 
-    if (input->albedo &&
-        !createOIDNBuffer(device, input->albedo, imageByteCount, &buffers->albedo, outErrorMessage, "albedo")) {
-        return 0;
+// Log-average luminance of 16x16 pixel bins mapped to a middle-grey key, modelled on OIDN's own autoexposure.
+static float computeOIDNInputScale(const float* color, uint32_t width, uint32_t height) {
+    double logLuminanceSum = 0.0;
+    uint64_t binCount = 0u;
+    for (uint32_t binY = 0; binY < height; binY += kOIDNExposureBinSize) {
+        uint32_t binY1 = height - binY > kOIDNExposureBinSize ? binY + kOIDNExposureBinSize : height;
+        for (uint32_t binX = 0; binX < width; binX += kOIDNExposureBinSize) {
+            uint32_t binX1 = width - binX > kOIDNExposureBinSize ? binX + kOIDNExposureBinSize : width;
+            double luminanceSum = 0.0;
+            for (uint32_t y = binY; y < binY1; y++) {
+                const float* pixel = color + ((((size_t)y * width) + binX) * 4u);
+                for (uint32_t x = binX; x < binX1; x++, pixel += 4) {
+                    double luminance = (0.212671 * pixel[0]) + (0.715160 * pixel[1]) + (0.072169 * pixel[2]);
+                    if (isfinite(luminance) && luminance > 0.0) luminanceSum += luminance;
+                }
+            }
+            double binLuminance = luminanceSum / (double)((binX1 - binX) * (binY1 - binY));
+            if (binLuminance > 1e-8) {
+                logLuminanceSum += log2(binLuminance);
+                binCount++;
+            }
+        }
     }
-    if (input->normal &&
-        !createOIDNBuffer(device, input->normal, imageByteCount, &buffers->normal, outErrorMessage, "normal")) {
-        return 0;
-    }
-
-    return 1;
+    return binCount > 0u ? (float)(kOIDNExposureKey / exp2(logLuminanceSum / (double)binCount)) : 1.0f;
 }
 
-static void configureOIDNFilterImages(
-    OIDNFilter filter,
-    const OIDNFilterConfig* config,
-    const VKRT_OIDNFilterInput* input,
-    OIDNBuffer colorBuffer,
-    OIDNBuffer albedoBuffer,
-    OIDNBuffer normalBuffer,
-    OIDNBuffer outputBuffer
+// NaN restores OIDN's per-execution autoexposure. Recommitting only when the scale changes keeps cached filters warm.
+static int applyOIDNInputScale(
+    OIDNDevice device,
+    OIDNFilterSlot* slot,
+    float inputScale,
+    const char** outErrorMessage
 ) {
-    if (!config || !config->mainImageName || !config->mainImageName[0]) return;
+    if (slot->inputScale == inputScale || (isnan(slot->inputScale) && isnan(inputScale))) return 1;
 
-    const size_t pixelStride = sizeof(float) * 4u;
-    const size_t rowStride = pixelStride * (size_t)input->width;
+    oidnSetFilterFloat(slot->filter, "inputScale", inputScale);
+    oidnCommitFilter(slot->filter);
+    slot->inputScale = inputScale;
+    return !reportOIDNDeviceError(device, "failed to commit OIDN filter", outErrorMessage);
+}
 
-    oidnSetFilterImage(
-        filter,
-        config->mainImageName,
-        colorBuffer,
-        OIDN_FORMAT_FLOAT3,
-        input->width,
-        input->height,
-        0u,
-        pixelStride,
-        rowStride
-    );
-    if (input->albedo && strcmp(config->mainImageName, "albedo") != 0) {
-        oidnSetFilterImage(
-            filter,
-            "albedo",
-            albedoBuffer,
-            OIDN_FORMAT_FLOAT3,
-            input->width,
-            input->height,
-            0u,
-            pixelStride,
-            rowStride
-        );
+static void writeOIDNTileRows(
+    OIDNBuffer buffer,
+    const float* image,
+    uint32_t imageWidth,
+    const OIDNTileRegion* tile,
+    uint32_t tileWidth,
+    uint32_t tileHeight
+) {
+    const size_t rowBytes = kOIDNPixelStride * (size_t)tileWidth;
+    for (uint32_t row = 0; row < tileHeight; row++) {
+        const float* source = image + ((((size_t)(tile->y + row) * imageWidth) + tile->x) * 4u);
+        oidnWriteBuffer(buffer, (size_t)row * rowBytes, rowBytes, source);
     }
-    if (input->normal && strcmp(config->mainImageName, "normal") != 0) {
-        oidnSetFilterImage(
-            filter,
-            "normal",
-            normalBuffer,
-            OIDN_FORMAT_FLOAT3,
-            input->width,
-            input->height,
-            0u,
-            pixelStride,
-            rowStride
-        );
+}
+
+static void readOIDNTileRows(
+    OIDNBuffer buffer,
+    float* image,
+    uint32_t imageWidth,
+    const OIDNTileRegion* tile,
+    uint32_t tileWidth
+) {
+    const size_t innerBytes = kOIDNPixelStride * (size_t)(tile->innerX1 - tile->innerX0);
+    for (uint32_t y = tile->innerY0; y < tile->innerY1; y++) {
+        size_t tilePixel = ((size_t)(y - tile->y) * tileWidth) + (tile->innerX0 - tile->x);
+        float* destination = image + ((((size_t)y * imageWidth) + tile->innerX0) * 4u);
+        oidnReadBuffer(buffer, tilePixel * kOIDNPixelStride, innerBytes, destination);
     }
-    oidnSetFilterImage(
-        filter,
-        "output",
-        outputBuffer,
-        OIDN_FORMAT_FLOAT3,
-        input->width,
-        input->height,
-        0u,
-        pixelStride,
-        rowStride
-    );
-    oidnSetFilterBool(filter, "hdr", config->hdr != 0);
-    oidnSetFilterBool(filter, "srgb", config->srgb != 0);
-    oidnSetFilterBool(filter, "cleanAux", config->cleanAux != 0);
-    oidnSetFilterInt(filter, "quality", OIDN_QUALITY_HIGH);
 }
 
-static int executeOIDNFilter(
+static uint32_t placeOIDNTile(uint32_t innerStart, uint32_t tileExtent, uint32_t imageExtent) {
+    uint32_t start = innerStart > kOIDNTileOverlap ? innerStart - kOIDNTileOverlap : 0u;
+    return start + tileExtent > imageExtent ? imageExtent - tileExtent : start;
+}
+
+static int executeOIDNTile(
     OIDNDevice device,
-    OIDNFilter filter,
-    OIDNBuffer outputBuffer,
-    size_t imageByteCount,
+    const OIDNFilterSlot* slot,
+    const VKRT_OIDNFilterInput* input,
+    const OIDNTileRegion* tile,
     float* output,
     const char** outErrorMessage
 ) {
-    oidnCommitFilter(filter);
-    oidnExecuteFilter(filter);
-    oidnSyncDevice(device);
-
-    const char* errorMessage = NULL;
-    OIDNError error = oidnGetDeviceError(device, &errorMessage);
-    if (error == OIDN_ERROR_NONE) {
-        oidnReadBuffer(outputBuffer, 0u, imageByteCount, output);
-        error = oidnGetDeviceError(device, &errorMessage);
+    writeOIDNTileRows(slot->buffers.color, input->color, input->width, tile, slot->width, slot->height);
+    writeOIDNTileRows(slot->buffers.output, input->color, input->width, tile, slot->width, slot->height);
+    if (slot->hasAlbedo) {
+        writeOIDNTileRows(slot->buffers.albedo, input->albedo, input->width, tile, slot->width, slot->height);
     }
-    if (error == OIDN_ERROR_NONE) {
-        return 1;
+    if (slot->hasNormal) {
+        writeOIDNTileRows(slot->buffers.normal, input->normal, input->width, tile, slot->width, slot->height);
     }
 
-    if (errorMessage && errorMessage[0]) {
-        (void)snprintf(oidnErrorStorage, sizeof(oidnErrorStorage), "%s", errorMessage);
-        setOIDNErrorMessage(outErrorMessage, oidnErrorStorage);
-    } else {
-        setOIDNErrorMessage(outErrorMessage, "OIDN filtering failed");
-    }
-    return 0;
+    oidnExecuteFilter(slot->filter);
+    oidnSyncDevice(device);
+    if (reportOIDNDeviceError(device, "OIDN filtering failed", outErrorMessage)) return 0;
+
+    readOIDNTileRows(slot->buffers.output, output, input->width, tile, slot->width);
+    return !reportOIDNDeviceError(device, "OIDN filtering failed", outErrorMessage);
 }
 
+// Images above the tiling threshold run through fixed-size overlapping tiles so OIDN memory stays bounded;
+// every tile shares one extent, and therefore one cached filter. HDR tiles share one exposure taken from the
+// whole image, since per-tile autoexposure leaves seams across the overlaps.
 static int runOIDNFilter(
+    VKRT_OIDNContext* context,
     const VKRT_OIDNFilterInput* input,
     const OIDNFilterConfig* config,
     float* output,
     const char** outErrorMessage
 ) {
-    if (!input || !config || !output || !input->color || input->width == 0u || input->height == 0u) {
+    if (!context || !input || !config || !output || !input->color || input->width == 0u || input->height == 0u) {
         setOIDNErrorMessage(outErrorMessage, "invalid OIDN input");
         return 0;
     }
+    if (!ensureOIDNDevice(context, outErrorMessage)) return 0;
+
+    uint32_t tileWidth = input->width;
+    uint32_t tileHeight = input->height;
+    uint32_t innerStep = input->width > input->height ? input->width : input->height;
+    int tiled = (uint64_t)input->width * input->height > context->tiledPixelThreshold;
+    if (tiled) {
+        uint32_t paddedTile = kOIDNTileSize + (2u * kOIDNTileOverlap);
+        tileWidth = input->width < paddedTile ? input->width : paddedTile;
+        tileHeight = input->height < paddedTile ? input->height : paddedTile;
+        innerStep = kOIDNTileSize;
+    }
 
-    OIDNBufferSet buffers = {0};
-    OIDNFilter filter = NULL;
-    OIDNDevice device = NULL;
-    int succeeded = 0;
+    OIDNFilterSlot* slot = acquireOIDNFilterSlot(context, config, input, tileWidth, tileHeight, outErrorMessage);
+    if (!slot) return 0;
 
-    if (!createOIDNFilterContext(&device, &filter, outErrorMessage)) {
-        goto cleanup;
+    int succeeded = 1;
+    if (config->hdr) {
+        float inputScale = tiled ? computeOIDNInputScale(input->color, input->width, input->height) : NAN;
+        succeeded = applyOIDNInputScale(context->device, slot, inputScale, outErrorMessage);
     }
-
-    const size_t imageByteCount = (sizeof(float) * 4u * (size_t)input->width) * (size_t)input->height;
-    if (!createOIDNInputBuffers(device, input, imageByteCount, &buffers, input->color, outErrorMessage)) {
-        goto cleanup;
+    for (uint32_t innerY = 0; succeeded && innerY < input->height; innerY += innerStep) {
+        for (uint32_t innerX = 0; succeeded && innerX < input->width; innerX += innerStep) {
+            OIDNTileRegion tile = {
+                .x = placeOIDNTile(innerX, tileWidth, input->width),
+                .y = placeOIDNTile(innerY, tileHeight, input->height),
+                .innerX0 = innerX,
+                .innerY0 = innerY,
+                .innerX1 = input->width - innerX > innerStep ? innerX + innerStep : input->width,
+                .innerY1 = input->height - innerY > innerStep ? innerY + innerStep : input->height,
+            };
+            succeeded = executeOIDNTile(context->device, slot, input, &tile, output, outErrorMessage);
+        }
     }
 
-    configureOIDNFilterImages(filter, config, input, buffers.color, buffers.albedo, buffers.normal, buffers.output);
-    if (!executeOIDNFilter(device, filter, buffers.output, imageByteCount, output, outErrorMessage)) {
-        goto cleanup;
+    if (!succeeded || (uint64_t)tileWidth * tileHeight > kOIDNMaxCachedPixels) {
+        releaseOIDNFilterSlot(slot);
     }
+    return succeeded;
+}
 
-    succeeded = 1;
+VKRT_OIDNContext* vkrtOIDNCreateContext(void) {
+    VKRT_OIDNContext* context = (VKRT_OIDNContext*)calloc(1u, sizeof(VKRT_OIDNContext));
+    if (context) context->tiledPixelThreshold = kOIDNTiledPixelThreshold;
+    return context;
+}
 
-cleanup:
-    releaseOIDNResources(&device, &filter, &buffers.color, &buffers.albedo, &buffers.normal, &buffers.output);
-    return succeeded;
+void vkrtOIDNDestroyContext(VKRT_OIDNContext* context) {
+    if (!context) return;
+    releaseOIDNDevice(context);
+    free(context);
 }
 
-int vkrtOIDNDenoise(const VKRT_OIDNFilterInput* input, float* output, const char** outErrorMessage) {
+void vkrtOIDNSetThreading(VKRT_OIDNContext* context, uint32_t threadCount, uint8_t pinThreads) {
+    if (!context) return;
+    context->threadCount = threadCount;
+    context->pinThreads = pinThreads ? 1u : 0u;
+}
+
+void vkrtOIDNSetTiledPixelThreshold(VKRT_OIDNContext* context, uint64_t pixelThreshold) {
+    if (!context) return;
+    context->tiledPixelThreshold = pixelThreshold > 0u ? pixelThreshold : kOIDNTiledPixelThreshold;
+}
+
+int vkrtOIDNDenoise(
+    VKRT_OIDNContext* context,
+    const VKRT_OIDNFilterInput* input,
+    float* output,
+    const char** outErrorMessage
+) {
     setOIDNErrorMessage(outErrorMessage, NULL);
     if (!input || !output || !input->color || input->width == 0u || input->height == 0u) {
         setOIDNErrorMessage(outErrorMessage, "invalid OIDN input");
@@ -292,10 +461,11 @@ int vkrtOIDNDenoise(const VKRT_OIDNFilterInput* input, float* output, const char
         .srgb = 0u,
         .cleanAux = input->cleanAux,
     };
-    return runOIDNFilter(input, &config, output, outErrorMessage);
+    return runOIDNFilter(context, input, &config, output, outErrorMessage);
 }
 
 int vkrtOIDNPrefilterAux(
+    VKRT_OIDNContext* context,
     VKRT_OIDNAuxImage auxImage,
     const float* input,
     uint32_t width,
@@ -336,5 +506,5 @@ int vkrtOIDNPrefilterAux(
         .srgb = 0u,
         .cleanAux = 0u,
     };
-    return runOIDNFilter(&filterInput, &config, output, outErrorMessage);
+    return runOIDNFilter(context, &filterInput, &config, output, outErrorMessage);
 }
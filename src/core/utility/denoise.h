@@ -16,8 +16,23 @@ typedef struct VKRT_OIDNFilterInput {
     uint8_t cleanAux;
 } VKRT_OIDNFilterInput;
 
-int vkrtOIDNDenoise(const VKRT_OIDNFilterInput* input, float* output, const char** outErrorMessage);
+// Owns one OIDN device plus filters and buffers cached per resolution. Not thread-safe; use from a single thread.
+typedef struct VKRT_OIDNContext VKRT_OIDNContext;
+
+VKRT_OIDNContext* vkrtOIDNCreateContext(void);
+void vkrtOIDNDestroyContext(VKRT_OIDNContext* context);
+void vkrtOIDNSetThreading(VKRT_OIDNContext* context, uint32_t threadCount, uint8_t pinThreads);
+// Images with more pixels than this are denoised in tiles. Zero restores the default.
+void vkrtOIDNSetTiledPixelThreshold(VKRT_OIDNContext* context, uint64_t pixelThreshold);
+
+int vkrtOIDNDenoise(
+    VKRT_OIDNContext* context,
+    const VKRT_OIDNFilterInput* input,
+    float* output,
+    const char** outErrorMessage
+);
 int vkrtOIDNPrefilterAux(
+    VKRT_OIDNContext* context,
     VKRT_OIDNAuxImage auxImage,
     const float* input,
     uint32_t width,
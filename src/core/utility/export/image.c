@@ -6,6 +6,7 @@
 #include "exr.h"
 #include "internal.h"
 #include "io.h"
+#include "packing.h"
 #include "vkrt_types.h"
 
 #include <ctype.h>
@@ -30,6 +31,7 @@ typedef struct LinearRenderOutputRequest {
     uint32_t height;
     const VKRT_RenderExportSettings* settings;
     const VKRT_SceneSettingsSnapshot* sceneSettings;
+    VKRT_OIDNContext* denoiser;
     int allowRawFallback;
 } LinearRenderOutputRequest;
 
@@ -343,35 +345,6 @@ void freeRenderImageExportJob(RenderImageExportJob* job) {
     free(job);
 }
 
-static float decodeHalfFloat(uint16_t value) {
-    uint32_t sign = ((uint32_t)value & 0x8000u) << 16u;
-    uint32_t exponent = ((uint32_t)value >> 10u) & 0x1fu;
-    uint32_t mantissa = (uint32_t)value & 0x03ffu;
-    uint32_t bits = 0u;
-
-    if (exponent == 0u) {
-        if (mantissa == 0u) {
-            bits = sign;
-        } else {
-            exponent = 1u;
-            while ((mantissa & 0x0400u) == 0u) {
-                mantissa <<= 1u;
-                exponent++;
-            }
-            mantissa &= 0x03ffu;
-            bits = sign | ((127u - 15u - exponent + 1u) << 23u) | (mantissa << 13u);
-        }
-    } else if (exponent == 0x1fu) {
-        bits = sign | 0x7f800000u | (mantissa << 13u);
-    } else {
-        bits = sign | ((exponent + (127u - 15u)) << 23u) | (mantissa << 13u);
-    }
-
-    float result = 0.0f;
-    memcpy(&result, &bits, sizeof(result));
-    return result;
-}
-
 static float clampf(float value, float minValue, float maxValue) {
     if (value < minValue) return minValue;
     if (value > maxValue) return maxValue;
@@ -525,7 +498,7 @@ static int prepareRGBA32FPixels(
     if (source->format == RENDER_IMAGE_BUFFER_FORMAT_RGBA16F) {
         const uint16_t* halfPixels = (const uint16_t*)source->pixels;
         for (size_t i = 0; i < pixelCount * 4u; i++) {
-            converted[i] = decodeHalfFloat(halfPixels[i]);
+            converted[i] = unpackHalf(halfPixels[i]);
         }
         return 1;
     }
@@ -734,6 +707,7 @@ static int prepareDenoiseFeatureBuffers(
 }
 
 static int prefilterDenoiseFeatureBuffer(
+    VKRT_OIDNContext* denoiser,
     const char* outputLabel,
     const char* featureLabel,
     VKRT_OIDNAuxImage auxImage,
@@ -751,7 +725,7 @@ static int prefilterDenoiseFeatureBuffer(
     }
 
     const char* errorMessage = NULL;
-    if (vkrtOIDNPrefilterAux(auxImage, source, width, height, *outFiltered, &errorMessage)) {
+    if (vkrtOIDNPrefilterAux(denoiser, auxImage, source, width, height, *outFiltered, &errorMessage)) {
         return 1;
     }
 
@@ -765,6 +739,7 @@ static int prefilterDenoiseFeatureBuffer(
 }
 
 static int tryPrefilterDenoiseFeatureBufferInPlace(
+    VKRT_OIDNContext* denoiser,
     const char* outputLabel,
     const char* featureLabel,
     VKRT_OIDNAuxImage auxImage,
@@ -775,7 +750,16 @@ static int tryPrefilterDenoiseFeatureBufferInPlace(
     if (!inOutBuffer || !*inOutBuffer) return 0;
 
     float* filtered = NULL;
-    if (!prefilterDenoiseFeatureBuffer(outputLabel, featureLabel, auxImage, *inOutBuffer, width, height, &filtered)) {
+    if (!prefilterDenoiseFeatureBuffer(
+            denoiser,
+            outputLabel,
+            featureLabel,
+            auxImage,
+            *inOutBuffer,
+            width,
+            height,
+            &filtered
+        )) {
         return 0;
     }
 
@@ -798,6 +782,7 @@ static void tryPrefilterDenoiseFeatureBuffers(
 
     if (outAlbedoPrefiltered) {
         *outAlbedoPrefiltered = tryPrefilterDenoiseFeatureBufferInPlace(
+            request->denoiser,
             outputLabel,
             "albedo",
             VKRT_OIDN_AUX_IMAGE_ALBEDO,
@@ -808,6 +793,7 @@ static void tryPrefilterDenoiseFeatureBuffers(
     }
     if (outNormalPrefiltered) {
         *outNormalPrefiltered = tryPrefilterDenoiseFeatureBufferInPlace(
+            request->denoiser,
             outputLabel,
             "normal",
             VKRT_OIDN_AUX_IMAGE_NORMAL,
@@ -884,7 +870,7 @@ static int denoiseLinearRenderOutput(
         .cleanAux = (uint8_t)(albedoPrefiltered && normalPrefiltered),
     };
 
-    if (vkrtOIDNDenoise(&input, denoised, &errorMessage)) {
+    if (vkrtOIDNDenoise(request->denoiser, &input, denoised, &errorMessage)) {
         sanitizeLinearRGBA32FInPlace(denoised, request->width, request->height, 1.0f, 1);
         free(*inOutLinearOutput);
         *inOutLinearOutput = denoised;
@@ -959,7 +945,7 @@ cleanup:
     return result;
 }
 
-int processRenderImageExportJob(RenderImageExportJob* job) {
+int processRenderImageExportJob(RenderImageExportJob* job, VKRT_OIDNContext* denoiser) {
     if (!job || !job->path || !job->beauty.pixels || job->width == 0u || job->height == 0u) return -1;
 
     if (job->beauty.format == RENDER_IMAGE_BUFFER_FORMAT_RGBA16_UNORM && job->format != RENDER_IMAGE_FORMAT_EXR) {
@@ -979,6 +965,7 @@ int processRenderImageExportJob(RenderImageExportJob* job) {
         .height = job->height,
         .settings = &job->settings,
         .sceneSettings = &job->sceneSettings,
+        .denoiser = denoiser,
         .allowRawFallback = 1,
     };
 
@@ -1015,7 +1002,12 @@ cleanup:
     return result;
 }
 
-int processViewportDenoiseJob(RenderImageExportJob* job, uint16_t** outPixels, size_t* outByteCount) {
+int processViewportDenoiseJob(
+    RenderImageExportJob* job,
+    VKRT_OIDNContext* denoiser,
+    uint16_t** outPixels,
+    size_t* outByteCount
+) {
     if (outPixels) *outPixels = NULL;
     if (outByteCount) *outByteCount = 0u;
     if (!job || !job->beauty.pixels || !outPixels || !outByteCount || job->width == 0u || job->height == 0u) {
@@ -1036,6 +1028,7 @@ int processViewportDenoiseJob(RenderImageExportJob* job, uint16_t** outPixels, s
         .height = job->height,
         .settings = &job->settings,
         .sceneSettings = &job->sceneSettings,
+        .denoiser = denoiser,
         .allowRawFallback = 0,
     };
 
@@ -1100,6 +1093,8 @@ RenderImageExportJob* createRenderImageJob(
     job->height = height;
     job->settings = *settings;
     job->sceneSettings = vkrt->sceneSettings;
+    job->denoiseThreadCount = vkrt->renderImageExporter.denoiseThreadCount;
+    job->denoisePinThreads = vkrt->renderImageExporter.denoisePinThreads;
     initializeRenderImageJob(job);
     return job;
 }
@@ -37,6 +37,8 @@ typedef struct RenderImageExportJob {
     RenderImageFormat format;
     VKRT_RenderExportSettings settings;
     VKRT_SceneSettingsSnapshot sceneSettings;
+    uint32_t denoiseThreadCount;
+    uint8_t denoisePinThreads;
     RenderImageBuffer beauty;
     RenderImageBuffer albedo;
     RenderImageBuffer normal;
@@ -57,8 +59,13 @@ RenderImageExportJob* createRenderImageJob(
     const VKRT_RenderExportSettings* settings
 );
 void freeRenderImageExportJob(RenderImageExportJob* job);
-int processRenderImageExportJob(RenderImageExportJob* job);
-int processViewportDenoiseJob(RenderImageExportJob* job, uint16_t** outPixels, size_t* outByteCount);
+int processRenderImageExportJob(RenderImageExportJob* job, struct VKRT_OIDNContext* denoiser);
+int processViewportDenoiseJob(
+    RenderImageExportJob* job,
+    struct VKRT_OIDNContext* denoiser,
+    uint16_t** outPixels,
+    size_t* outByteCount
+);
 int queueRenderImageJob(VKRT* vkrt, RenderImageExportJob* job);
 int readbackImagePixels(
     VKRT* vkrt,
@@ -1,8 +1,8 @@
-#include "buffer.h"
 #include "command/pool.h"
 #include "command/record.h"
 #include "debug.h"
 #include "internal.h"
+#include "staging.h"
 #include "vkrt_types.h"
 #include "vulkan/vulkan_core.h"
 
@@ -27,32 +27,23 @@ int readbackImagePixels(
         return -1;
     }
 
-    VkBuffer stagingBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
-    void* mapped = NULL;
+    StagingAllocation staging = {0};
     int result = -1;
 
-    if (createBuffer(
-            vkrt,
-            (VkDeviceSize)readbackBytes,
-            VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            &stagingBuffer,
-            &stagingMemory
-        ) != VKRT_SUCCESS) {
+    if (vkrtAllocateStaging(vkrt, (VkDeviceSize)readbackBytes, &staging) != VKRT_SUCCESS) {
         return -1;
     }
 
     VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
     if (beginSingleTimeCommands(vkrt, &commandBuffer) != VKRT_SUCCESS) {
-        vkDestroyBuffer(vkrt->core.device, stagingBuffer, NULL);
-        vkFreeMemory(vkrt->core.device, stagingMemory, NULL);
+        vkrtReleaseStaging(vkrt, &staging);
         return -1;
     }
 
     transitionImageLayout(commandBuffer, image, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
 
     VkBufferImageCopy copyRegion = {0};
+    copyRegion.bufferOffset = staging.offset;
     copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     copyRegion.imageSubresource.mipLevel = 0;
     copyRegion.imageSubresource.baseArrayLayer = 0;
@@ -60,35 +51,25 @@ int readbackImagePixels(
     copyRegion.imageOffset = (VkOffset3D){0, 0, 0};
     copyRegion.imageExtent = (VkExtent3D){width, height, 1};
 
-    vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, stagingBuffer, 1, &copyRegion);
+    vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, staging.buffer, 1, &copyRegion);
     transitionImageLayout(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL);
 
     if (endSingleTimeCommands(vkrt, commandBuffer) != VKRT_SUCCESS) {
-        vkDestroyBuffer(vkrt->core.device, stagingBuffer, NULL);
-        vkFreeMemory(vkrt->core.device, stagingMemory, NULL);
+        vkrtReleaseStaging(vkrt, &staging);
         return -1;
     }
 
-    if (vkMapMemory(vkrt->core.device, stagingMemory, 0, (VkDeviceSize)readbackBytes, 0, &mapped) != VK_SUCCESS) {
-        LOG_ERROR("Failed to map render readback buffer");
-        goto cleanup;
-    }
-
     void* readbackCopy = malloc(readbackBytes);
     if (!readbackCopy) {
         LOG_ERROR("Failed to allocate render snapshot buffer");
         goto cleanup;
     }
-    memcpy(readbackCopy, mapped, readbackBytes);
+    memcpy(readbackCopy, staging.mapped, readbackBytes);
     *outPixels = readbackCopy;
     result = 0;
 
 cleanup:
-    if (mapped) {
-        vkUnmapMemory(vkrt->core.device, stagingMemory);
-    }
-    vkDestroyBuffer(vkrt->core.device, stagingBuffer, NULL);
-    vkFreeMemory(vkrt->core.device, stagingMemory, NULL);
+    vkrtReleaseStaging(vkrt, &staging);
     return result;
 }
 
@@ -102,30 +83,14 @@ int uploadImagePixels(
 ) {
     if (!vkrt || image == VK_NULL_HANDLE || width == 0u || height == 0u || !pixels || byteCount == 0u) return -1;
 
-    VkBuffer stagingBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory stagingMemory = VK_NULL_HANDLE;
-    void* mapped = NULL;
+    StagingAllocation staging = {0};
     int result = -1;
 
-    if (createBuffer(
-            vkrt,
-            (VkDeviceSize)byteCount,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            &stagingBuffer,
-            &stagingMemory
-        ) != VKRT_SUCCESS) {
+    if (vkrtAllocateStaging(vkrt, (VkDeviceSize)byteCount, &staging) != VKRT_SUCCESS) {
+        LOG_ERROR("Failed to allocate viewport upload staging memory");
         return -1;
     }
-
-    if (vkMapMemory(vkrt->core.device, stagingMemory, 0, (VkDeviceSize)byteCount, 0, &mapped) != VK_SUCCESS ||
-        !mapped) {
-        LOG_ERROR("Failed to map viewport upload staging buffer");
-        goto cleanup;
-    }
-    memcpy(mapped, pixels, byteCount);
-    vkUnmapMemory(vkrt->core.device, stagingMemory);
-    mapped = NULL;
+    memcpy(staging.mapped, pixels, byteCount);
 
     VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
     if (beginSingleTimeCommands(vkrt, &commandBuffer) != VKRT_SUCCESS) {
@@ -135,6 +100,7 @@ int uploadImagePixels(
     transitionImageLayout(commandBuffer, image, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
     VkBufferImageCopy copyRegion = {0};
+    copyRegion.bufferOffset = staging.offset;
     copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     copyRegion.imageSubresource.mipLevel = 0;
     copyRegion.imageSubresource.baseArrayLayer = 0;
@@ -142,7 +108,7 @@ int uploadImagePixels(
     copyRegion.imageOffset = (VkOffset3D){0, 0, 0};
     copyRegion.imageExtent = (VkExtent3D){width, height, 1u};
 
-    vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+    vkCmdCopyBufferToImage(commandBuffer, staging.buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
     transitionImageLayout(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL);
 
     if (endSingleTimeCommands(vkrt, commandBuffer) != VKRT_SUCCESS) {
@@ -152,10 +118,6 @@ int uploadImagePixels(
     result = 0;
 
 cleanup:
-    if (mapped) {
-        vkUnmapMemory(vkrt->core.device, stagingMemory);
-    }
-    vkDestroyBuffer(vkrt->core.device, stagingBuffer, NULL);
-    vkFreeMemory(vkrt->core.device, stagingMemory, NULL);
+    vkrtReleaseStaging(vkrt, &staging);
     return result;
 }
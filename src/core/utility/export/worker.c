@@ -1,4 +1,5 @@
 #include "debug.h"
+#include "denoise.h"
 #include "export.h"
 #include "internal.h"
 #include "platform.h"
@@ -53,11 +54,25 @@ static void publishCompletedViewportJob(
     vkrtMutexUnlock(&exporter->stateLock);
 }
 
+// The denoiser is owned by the worker thread and lives until shutdown, so OIDN device setup is paid once.
+static VKRT_OIDNContext* acquireRenderImageDenoiser(RenderImageExporter* exporter, const RenderImageExportJob* job) {
+    if (!exporter->denoiser) {
+        exporter->denoiser = vkrtOIDNCreateContext();
+        if (!exporter->denoiser) {
+            LOG_ERROR("Failed to allocate denoiser context");
+            return NULL;
+        }
+    }
+    vkrtOIDNSetThreading(exporter->denoiser, job->denoiseThreadCount, job->denoisePinThreads);
+    return exporter->denoiser;
+}
+
 static void processRenderImageWorkerJob(RenderImageExporter* exporter, RenderImageExportJob* job) {
     if (!exporter || !job) return;
 
+    VKRT_OIDNContext* denoiser = acquireRenderImageDenoiser(exporter, job);
     if (job->type == RENDER_IMAGE_JOB_TYPE_SAVE) {
-        int result = processRenderImageExportJob(job);
+        int result = processRenderImageExportJob(job, denoiser);
         if (result == 0) {
             LOG_INFO("Saved render image: %s", job->path);
         }
@@ -66,7 +81,14 @@ static void processRenderImageWorkerJob(RenderImageExporter* exporter, RenderIma
 
     uint16_t* displayPixels = NULL;
     size_t displayByteCount = 0u;
-    int result = processViewportDenoiseJob(job, &displayPixels, &displayByteCount);
+    uint64_t startTimeUs = getMicroseconds();
+    int result = processViewportDenoiseJob(job, denoiser, &displayPixels, &displayByteCount);
+    LOG_TRACE(
+        "Viewport denoise %ux%u took %.2f ms",
+        job->width,
+        job->height,
+        (double)(getMicroseconds() - startTimeUs) / 1000.0
+    );
     publishCompletedViewportJob(exporter, job, result, displayPixels, displayByteCount);
 }
 
@@ -246,6 +268,9 @@ void shutdownRenderImageExporter(VKRT* vkrt) {
         job = next;
     }
 
+    vkrtOIDNDestroyContext(exporter->denoiser);
+    exporter->denoiser = NULL;
+
     free(exporter->completedViewportPixels);
     exporter->completedViewportPixels = NULL;
     exporter->completedViewportByteCount = 0u;
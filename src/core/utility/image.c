@@ -4,6 +4,8 @@
 #include "debug.h"
 #include "exr.h"
 #include "formats.h"
+#include "io.h"
+#include "vulkan/vulkan_core.h"
 
 #include <limits.h>
 #include <math.h>
@@ -19,8 +21,74 @@ typedef enum ImageCodec {
     IMAGE_CODEC_PNG,
     IMAGE_CODEC_JPEG,
     IMAGE_CODEC_EXR,
+    IMAGE_CODEC_KTX2,
+    IMAGE_CODEC_DDS,
 } ImageCodec;
 
+typedef struct ContainerFormatMapping {
+    uint32_t sourceFormat;
+    uint32_t format;
+    uint32_t colorSpace;
+} ContainerFormatMapping;
+
+typedef struct ContainerLevels {
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;
+    uint32_t colorSpace;
+    uint32_t levelCount;
+    size_t levelOffsets[VKRT_TEXTURE_MAX_MIP_LEVELS];
+} ContainerLevels;
+
+static const size_t kKTX2HeaderSize = 80u;
+static const size_t kKTX2LevelIndexEntrySize = 24u;
+static const size_t kDDSHeaderSize = 128u;
+static const size_t kDDSHeaderDX10Size = 20u;
+static const uint32_t kDDSFlagMipMapCount = 0x20000u;
+static const uint32_t kDDSPixelFormatAlphaPixels = 0x1u;
+static const uint32_t kDDSPixelFormatFourCC = 0x4u;
+static const uint32_t kDDSCaps2CubeOrVolume = 0x200u | 0x200000u;
+static const uint32_t kDDSResourceDimensionTexture2D = 3u;
+static const uint32_t kDDSMiscTextureCube = 0x4u;
+static const uint32_t kDDSAlphaModeMask = 0x7u;
+static const uint32_t kDDSAlphaModeOpaque = 3u;
+
+static const ContainerFormatMapping kKTX2FormatMappings[] = {
+    {VK_FORMAT_R8G8B8A8_UNORM, VKRT_TEXTURE_FORMAT_RGBA8_UNORM, VKRT_TEXTURE_COLOR_SPACE_LINEAR},
+    {VK_FORMAT_R8G8B8A8_SRGB, VKRT_TEXTURE_FORMAT_RGBA8_UNORM, VKRT_TEXTURE_COLOR_SPACE_SRGB},
+    {VK_FORMAT_R16G16B16A16_UNORM, VKRT_TEXTURE_FORMAT_RGBA16_UNORM, VKRT_TEXTURE_COLOR_SPACE_LINEAR},
+    {VK_FORMAT_R16G16B16A16_SFLOAT, VKRT_TEXTURE_FORMAT_RGBA16_SFLOAT, VKRT_TEXTURE_COLOR_SPACE_LINEAR},
+    {VK_FORMAT_R32G32B32A32_SFLOAT, VKRT_TEXTURE_FORMAT_RGBA32_SFLOAT, VKRT_TEXTURE_COLOR_SPACE_LINEAR},
+    {VK_FORMAT_BC1_RGB_UNORM_BLOCK, VKRT_TEXTURE_FORMAT_BC1_RGB_UNORM, VKRT_TEXTURE_COLOR_SPACE_LINEAR},
+    {VK_FORMAT_BC1_RGB_SRGB_BLOCK, VKRT_TEXTURE_FORMAT_BC1_RGB_UNORM, VKRT_TEXTURE_COLOR_SPACE_SRGB},
+    {VK_FORMAT_BC1_RGBA_UNORM_BLOCK, VKRT_TEXTURE_FORMAT_BC1_RGBA_UNORM, VKRT_TEXTURE_COLOR_SPACE_LINEAR},
+    {VK_FORMAT_BC1_RGBA_SRGB_BLOCK, VKRT_TEXTURE_FORMAT_BC1_RGBA_UNORM, VKRT_TEXTURE_COLOR_SPACE_SRGB},
+    {VK_FORMAT_BC3_UNORM_BLOCK, VKRT_TEXTURE_FORMAT_BC3_RGBA_UNORM, VKRT_TEXTURE_COLOR_SPACE_LINEAR},
+    {VK_FORMAT_BC3_SRGB_BLOCK, VKRT_TEXTURE_FORMAT_BC3_RGBA_UNORM, VKRT_TEXTURE_COLOR_SPACE_SRGB},
+    {VK_FORMAT_BC4_UNORM_BLOCK, VKRT_TEXTURE_FORMAT_BC4_R_UNORM, VKRT_TEXTURE_COLOR_SPACE_LINEAR},
+    {VK_FORMAT_BC5_UNORM_BLOCK, VKRT_TEXTURE_FORMAT_BC5_RG_UNORM, VKRT_TEXTURE_COLOR_SPACE_LINEAR},
+    {VK_FORMAT_BC7_UNORM_BLOCK, VKRT_TEXTURE_FORMAT_BC7_RGBA_UNORM, VKRT_TEXTURE_COLOR_SPACE_LINEAR},
+    {VK_FORMAT_BC7_SRGB_BLOCK, VKRT_TEXTURE_FORMAT_BC7_RGBA_UNORM, VKRT_TEXTURE_COLOR_SPACE_SRGB},
+};
+
+// DXGI_FORMAT values from the DX10 DDS header extension. DXGI has a single BC1 format, so opacity comes from the
+// header's alpha mode instead.
+static const ContainerFormatMapping kDDSDXGIFormatMappings[] = {
+    {2u, VKRT_TEXTURE_FORMAT_RGBA32_SFLOAT, VKRT_TEXTURE_COLOR_SPACE_LINEAR},
+    {10u, VKRT_TEXTURE_FORMAT_RGBA16_SFLOAT, VKRT_TEXTURE_COLOR_SPACE_LINEAR},
+    {11u, VKRT_TEXTURE_FORMAT_RGBA16_UNORM, VKRT_TEXTURE_COLOR_SPACE_LINEAR},
+    {28u, VKRT_TEXTURE_FORMAT_RGBA8_UNORM, VKRT_TEXTURE_COLOR_SPACE_LINEAR},
+    {29u, VKRT_TEXTURE_FORMAT_RGBA8_UNORM, VKRT_TEXTURE_COLOR_SPACE_SRGB},
+    {71u, VKRT_TEXTURE_FORMAT_BC1_RGBA_UNORM, VKRT_TEXTURE_COLOR_SPACE_LINEAR},
+    {72u, VKRT_TEXTURE_FORMAT_BC1_RGBA_UNORM, VKRT_TEXTURE_COLOR_SPACE_SRGB},
+    {77u, VKRT_TEXTURE_FORMAT_BC3_RGBA_UNORM, VKRT_TEXTURE_COLOR_SPACE_LINEAR},
+    {78u, VKRT_TEXTURE_FORMAT_BC3_RGBA_UNORM, VKRT_TEXTURE_COLOR_SPACE_SRGB},
+    {80u, VKRT_TEXTURE_FORMAT_BC4_R_UNORM, VKRT_TEXTURE_COLOR_SPACE_LINEAR},
+    {83u, VKRT_TEXTURE_FORMAT_BC5_RG_UNORM, VKRT_TEXTURE_COLOR_SPACE_LINEAR},
+    {98u, VKRT_TEXTURE_FORMAT_BC7_RGBA_UNORM, VKRT_TEXTURE_COLOR_SPACE_LINEAR},
+    {99u, VKRT_TEXTURE_FORMAT_BC7_RGBA_UNORM, VKRT_TEXTURE_COLOR_SPACE_SRGB},
+};
+
 static int mimeTypeStartsWith(const char* mimeType, const char* prefix) {
     if (!mimeType || !prefix) return 0;
     size_t prefixLength = strlen(prefix);
@@ -90,6 +158,8 @@ static ImageCodec queryImageCodecFromMimeType(const char* mimeType) {
     if (mimeTypeStartsWith(mimeType, "image/exr") || mimeTypeStartsWith(mimeType, "image/x-exr")) {
         return IMAGE_CODEC_EXR;
     }
+    if (mimeTypeStartsWith(mimeType, "image/ktx2")) return IMAGE_CODEC_KTX2;
+    if (mimeTypeStartsWith(mimeType, "image/vnd-ms.dds")) return IMAGE_CODEC_DDS;
     return IMAGE_CODEC_UNKNOWN;
 }
 
@@ -97,6 +167,9 @@ static ImageCodec queryImageCodecFromBytes(const uint8_t* data, size_t size) {
     static const uint8_t pngSignature[8] = {137u, 80u, 78u, 71u, 13u, 10u, 26u, 10u};
     static const uint8_t jpegSignature[3] = {0xffu, 0xd8u, 0xffu};
     static const uint8_t exrSignature[4] = {0x76u, 0x2fu, 0x31u, 0x01u};
+    static const uint8_t ktx2Signature[12] =
+        {0xabu, 0x4bu, 0x54u, 0x58u, 0x20u, 0x32u, 0x30u, 0xbbu, 0x0du, 0x0au, 0x1au, 0x0au};
+    static const uint8_t ddsSignature[4] = {0x44u, 0x44u, 0x53u, 0x20u};
 
     if (!data || size == 0u) return IMAGE_CODEC_UNKNOWN;
     if (size >= sizeof(pngSignature) && memcmp(data, pngSignature, sizeof(pngSignature)) == 0) {
@@ -108,6 +181,12 @@ static ImageCodec queryImageCodecFromBytes(const uint8_t* data, size_t size) {
     if (size >= sizeof(exrSignature) && memcmp(data, exrSignature, sizeof(exrSignature)) == 0) {
         return IMAGE_CODEC_EXR;
     }
+    if (size >= sizeof(ktx2Signature) && memcmp(data, ktx2Signature, sizeof(ktx2Signature)) == 0) {
+        return IMAGE_CODEC_KTX2;
+    }
+    if (size >= sizeof(ddsSignature) && memcmp(data, ddsSignature, sizeof(ddsSignature)) == 0) {
+        return IMAGE_CODEC_DDS;
+    }
     return IMAGE_CODEC_UNKNOWN;
 }
 
@@ -283,100 +362,331 @@ static int decodeEXRImage(const void* data, size_t size, const char* sourceLabel
     return vkrtLoadEXRImageFromMemory(data, size, sourceLabel, outImage);
 }
 
-static int decodeImageBytes(
-    const void* data,
+static uint32_t readLE32(const uint8_t* bytes) {
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8u) | ((uint32_t)bytes[2] << 16u) | ((uint32_t)bytes[3] << 24u);
+}
+
+static uint64_t readLE64(const uint8_t* bytes) {
+    return (uint64_t)readLE32(bytes) | ((uint64_t)readLE32(bytes + 4u) << 32u);
+}
+
+static const ContainerFormatMapping* findContainerFormatMapping(
+    const ContainerFormatMapping* mappings,
+    size_t mappingCount,
+    uint32_t sourceFormat
+) {
+    for (size_t i = 0; i < mappingCount; i++) {
+        if (mappings[i].sourceFormat == sourceFormat) return &mappings[i];
+    }
+    return NULL;
+}
+
+static uint32_t clampContainerLevelCount(uint32_t width, uint32_t height, uint32_t levelCount) {
+    uint32_t extent = width > height ? width : height;
+    uint32_t maxLevelCount = 1u;
+    while (extent > 1u && maxLevelCount < VKRT_TEXTURE_MAX_MIP_LEVELS) {
+        extent >>= 1u;
+        maxLevelCount++;
+    }
+    if (levelCount == 0u) return 1u;
+    return levelCount < maxLevelCount ? levelCount : maxLevelCount;
+}
+
+static int queryContainerLevelSize(const ContainerLevels* levels, uint32_t level, size_t* outBytes) {
+    uint32_t width = (levels->width >> level) > 0u ? levels->width >> level : 1u;
+    uint32_t height = (levels->height >> level) > 0u ? levels->height >> level : 1u;
+    return vkrtTryComputeTextureByteSize(width, height, levels->format, outBytes);
+}
+
+// Keeps the container mapping when the caller hands it over so mip data is staged straight from the file view.
+static int finalizeContainerImage(
+    const uint8_t* data,
     size_t size,
-    const char* mimeType,
+    const VKRT_MappedFile* adoptableMapping,
     const char* sourceLabel,
-    uint32_t preferredColorSpace,
+    const ContainerLevels* levels,
     VKRT_LoadedImage* outImage
 ) {
-    ImageCodec codec = queryImageCodecFromMimeType(mimeType);
-    if (codec == IMAGE_CODEC_UNKNOWN) {
-        codec = queryImageCodecFromBytes((const uint8_t*)data, size);
+    size_t rangeBegin = SIZE_MAX;
+    size_t rangeEnd = 0u;
+    for (uint32_t level = 0; level < levels->levelCount; level++) {
+        size_t levelBytes = 0u;
+        size_t offset = levels->levelOffsets[level];
+        if (!queryContainerLevelSize(levels, level, &levelBytes) || offset > size || levelBytes > size - offset) {
+            LOG_ERROR("Mip level %u of %s is truncated", level, sourceLabel);
+            return 0;
+        }
+        if (offset < rangeBegin) rangeBegin = offset;
+        if (offset + levelBytes > rangeEnd) rangeEnd = offset + levelBytes;
+    }
+    // Levels are copied starting at rangeBegin, so block alignment is relative to it rather than to the file.
+    for (uint32_t level = 0; level < levels->levelCount; level++) {
+        if (((levels->levelOffsets[level] - rangeBegin) % vkrtTextureFormatBlockBytes(levels->format)) != 0u) {
+            LOG_ERROR("Mip level %u of %s is misaligned", level, sourceLabel);
+            return 0;
+        }
     }
 
-    switch (codec) {
-        case IMAGE_CODEC_PNG:
-            return decodePNGImage(data, size, sourceLabel, preferredColorSpace, outImage);
-        case IMAGE_CODEC_JPEG:
-            return decodeJPEGImage(data, size, sourceLabel, preferredColorSpace, outImage);
-        case IMAGE_CODEC_EXR:
-            return decodeEXRImage(data, size, sourceLabel, outImage);
-        case IMAGE_CODEC_UNKNOWN:
-        default:
-            return reportUnsupportedImageFormat(sourceLabel, mimeType);
+    uint8_t* pixels = NULL;
+    if (adoptableMapping) {
+        pixels = (uint8_t*)adoptableMapping->data + rangeBegin;
+        outImage->mappedStorage = *adoptableMapping;
+    } else {
+        pixels = (uint8_t*)malloc(rangeEnd - rangeBegin);
+        if (!pixels) {
+            LOG_ERROR("Failed to allocate texture level buffer for %s", sourceLabel);
+            return 0;
+        }
+        memcpy(pixels, data + rangeBegin, rangeEnd - rangeBegin);
     }
+
+    outImage->pixels = pixels;
+    outImage->width = levels->width;
+    outImage->height = levels->height;
+    outImage->format = levels->format;
+    outImage->colorSpace = levels->colorSpace;
+    outImage->mipLevelCount = levels->levelCount;
+    for (uint32_t level = 0; level < levels->levelCount; level++) {
+        outImage->mipLevelOffsets[level] = levels->levelOffsets[level] - rangeBegin;
+    }
+    return 1;
 }
 
-static int readBinaryFile(const char* path, uint8_t** outData, size_t* outSize) {
-    if (!path || !path[0] || !outData || !outSize) return 0;
-    *outData = NULL;
-    *outSize = 0u;
-
-    FILE* file = NULL;
-#ifdef _WIN32
-    if (fopen_s(&file, path, "rb") != 0) file = NULL;
-#else
-    file = fopen(path, "rb");
-#endif
-    if (!file) {
-        LOG_ERROR("Failed to open image file: %s", path);
+static int decodeKTX2Image(
+    const uint8_t* data,
+    size_t size,
+    const VKRT_MappedFile* adoptableMapping,
+    const char* sourceLabel,
+    VKRT_LoadedImage* outImage
+) {
+    if (size < kKTX2HeaderSize) {
+        LOG_ERROR("KTX2 header truncated for %s", sourceLabel);
+        return 0;
+    }
+
+    uint32_t vkFormat = readLE32(data + 12u);
+    uint32_t pixelDepth = readLE32(data + 28u);
+    uint32_t layerCount = readLE32(data + 32u);
+    uint32_t faceCount = readLE32(data + 36u);
+    uint32_t levelCount = readLE32(data + 40u);
+    uint32_t supercompressionScheme = readLE32(data + 44u);
+    if (supercompressionScheme != 0u) {
+        LOG_ERROR("KTX2 supercompression scheme %u in %s is not supported", supercompressionScheme, sourceLabel);
+        return 0;
+    }
+    if (pixelDepth > 1u || layerCount > 1u || faceCount != 1u) {
+        LOG_ERROR("KTX2 %s is not a single 2D texture", sourceLabel);
         return 0;
     }
 
-    if (fseek(file, 0, SEEK_END) != 0) {
-        LOG_ERROR("Failed to seek image file: %s", path);
-        (void)fclose(file);
+    const ContainerFormatMapping* mapping = findContainerFormatMapping(
+        kKTX2FormatMappings,
+        sizeof(kKTX2FormatMappings) / sizeof(kKTX2FormatMappings[0]),
+        vkFormat
+    );
+    if (!mapping) {
+        LOG_ERROR("KTX2 format %u in %s is not supported", vkFormat, sourceLabel);
         return 0;
     }
 
-    long fileLength = ftell(file);
-    if (fileLength <= 0) {
-        LOG_ERROR("Failed to determine image file size: %s", path);
-        (void)fclose(file);
+    ContainerLevels levels = {
+        .width = readLE32(data + 20u),
+        .height = readLE32(data + 24u),
+        .format = mapping->format,
+        .colorSpace = mapping->colorSpace,
+    };
+    if (levels.width == 0u || levels.height == 0u) {
+        LOG_ERROR("KTX2 %s has invalid dimensions", sourceLabel);
         return 0;
     }
+    levels.levelCount = clampContainerLevelCount(levels.width, levels.height, levelCount);
+    if ((size - kKTX2HeaderSize) / kKTX2LevelIndexEntrySize < levels.levelCount) {
+        LOG_ERROR("KTX2 level index truncated for %s", sourceLabel);
+        return 0;
+    }
+
+    for (uint32_t level = 0; level < levels.levelCount; level++) {
+        uint64_t byteOffset = readLE64(data + kKTX2HeaderSize + ((size_t)level * kKTX2LevelIndexEntrySize));
+        if (byteOffset > (uint64_t)size) {
+            LOG_ERROR("KTX2 level %u of %s lies outside the file", level, sourceLabel);
+            return 0;
+        }
+        levels.levelOffsets[level] = (size_t)byteOffset;
+    }
+
+    return finalizeContainerImage(data, size, adoptableMapping, sourceLabel, &levels, outImage);
+}
+
+static int queryDDSFourCCFormat(uint32_t fourCC, uint32_t* outFormat) {
+    switch (fourCC) {
+        case 0x31545844u:
+            *outFormat = VKRT_TEXTURE_FORMAT_BC1_RGBA_UNORM;
+            return 1;
+        case 0x35545844u:
+            *outFormat = VKRT_TEXTURE_FORMAT_BC3_RGBA_UNORM;
+            return 1;
+        case 0x31495441u:
+        case 0x55344342u:
+            *outFormat = VKRT_TEXTURE_FORMAT_BC4_R_UNORM;
+            return 1;
+        case 0x32495441u:
+        case 0x55354342u:
+            *outFormat = VKRT_TEXTURE_FORMAT_BC5_RG_UNORM;
+            return 1;
+        default:
+            return 0;
+    }
+}
 
-    if (fseek(file, 0, SEEK_SET) != 0) {
-        LOG_ERROR("Failed to rewind image file: %s", path);
-        (void)fclose(file);
+static int decodeDDSImage(
+    const uint8_t* data,
+    size_t size,
+    const VKRT_MappedFile* adoptableMapping,
+    const char* sourceLabel,
+    uint32_t preferredColorSpace,
+    VKRT_LoadedImage* outImage
+) {
+    if (size < kDDSHeaderSize || readLE32(data + 4u) != 124u) {
+        LOG_ERROR("DDS header truncated for %s", sourceLabel);
         return 0;
     }
 
-    size_t bufferSize = (size_t)fileLength;
-    uint8_t* buffer = (uint8_t*)malloc(bufferSize);
-    if (!buffer) {
-        LOG_ERROR("Failed to allocate image file buffer for %s", path);
-        (void)fclose(file);
+    uint32_t flags = readLE32(data + 8u);
+    uint32_t mipMapCount = (flags & kDDSFlagMipMapCount) != 0u ? readLE32(data + 28u) : 1u;
+    uint32_t pixelFormatFlags = readLE32(data + 80u);
+    uint32_t fourCC = readLE32(data + 84u);
+    if ((readLE32(data + 112u) & kDDSCaps2CubeOrVolume) != 0u) {
+        LOG_ERROR("DDS %s is not a single 2D texture", sourceLabel);
+        return 0;
+    }
+    if ((pixelFormatFlags & kDDSPixelFormatFourCC) == 0u) {
+        LOG_ERROR("DDS %s uses an uncompressed legacy layout, which is not supported", sourceLabel);
         return 0;
     }
 
-    size_t bytesRead = fread(buffer, 1u, bufferSize, file);
-    (void)fclose(file);
-    if (bytesRead != bufferSize) {
-        free(buffer);
-        LOG_ERROR("Failed to read image file: %s", path);
+    ContainerLevels levels = {
+        .width = readLE32(data + 16u),
+        .height = readLE32(data + 12u),
+    };
+    size_t dataOffset = kDDSHeaderSize;
+    if (fourCC == 0x30315844u) {
+        if (size < kDDSHeaderSize + kDDSHeaderDX10Size) {
+            LOG_ERROR("DDS DX10 header truncated for %s", sourceLabel);
+            return 0;
+        }
+        if (readLE32(data + 132u) != kDDSResourceDimensionTexture2D ||
+            (readLE32(data + 136u) & kDDSMiscTextureCube) != 0u || readLE32(data + 140u) > 1u) {
+            LOG_ERROR("DDS %s is not a single 2D texture", sourceLabel);
+            return 0;
+        }
+
+        uint32_t dxgiFormat = readLE32(data + 128u);
+        const ContainerFormatMapping* mapping = findContainerFormatMapping(
+            kDDSDXGIFormatMappings,
+            sizeof(kDDSDXGIFormatMappings) / sizeof(kDDSDXGIFormatMappings[0]),
+            dxgiFormat
+        );
+        if (!mapping) {
+            LOG_ERROR("DDS DXGI format %u in %s is not supported", dxgiFormat, sourceLabel);
+            return 0;
+        }
+        levels.format = mapping->format;
+        levels.colorSpace = mapping->colorSpace;
+        if (levels.format == VKRT_TEXTURE_FORMAT_BC1_RGBA_UNORM &&
+            (readLE32(data + 144u) & kDDSAlphaModeMask) == kDDSAlphaModeOpaque) {
+            levels.format = VKRT_TEXTURE_FORMAT_BC1_RGB_UNORM;
+        }
+        dataOffset += kDDSHeaderDX10Size;
+    } else {
+        if (!queryDDSFourCCFormat(fourCC, &levels.format)) {
+            LOG_ERROR("DDS FourCC 0x%08x in %s is not supported", fourCC, sourceLabel);
+            return 0;
+        }
+        // Legacy DXT1 files flag punch-through alpha with DDPF_ALPHAPIXELS; without it the texture is opaque.
+        if (levels.format == VKRT_TEXTURE_FORMAT_BC1_RGBA_UNORM &&
+            (pixelFormatFlags & kDDSPixelFormatAlphaPixels) == 0u) {
+            levels.format = VKRT_TEXTURE_FORMAT_BC1_RGB_UNORM;
+        }
+        levels.colorSpace = preferredColorSpace == VKRT_TEXTURE_COLOR_SPACE_SRGB &&
+                                    levels.format != VKRT_TEXTURE_FORMAT_BC4_R_UNORM &&
+                                    levels.format != VKRT_TEXTURE_FORMAT_BC5_RG_UNORM
+                              ? VKRT_TEXTURE_COLOR_SPACE_SRGB
+                              : VKRT_TEXTURE_COLOR_SPACE_LINEAR;
+    }
+
+    if (levels.width == 0u || levels.height == 0u) {
+        LOG_ERROR("DDS %s has invalid dimensions", sourceLabel);
         return 0;
     }
+    levels.levelCount = clampContainerLevelCount(levels.width, levels.height, mipMapCount);
+
+    size_t offset = dataOffset;
+    for (uint32_t level = 0; level < levels.levelCount; level++) {
+        size_t levelBytes = 0u;
+        if (!queryContainerLevelSize(&levels, level, &levelBytes) || offset > size) {
+            LOG_ERROR("DDS level %u of %s lies outside the file", level, sourceLabel);
+            return 0;
+        }
+        levels.levelOffsets[level] = offset;
+        offset += levelBytes;
+    }
 
-    *outData = buffer;
-    *outSize = bufferSize;
-    return 1;
+    return finalizeContainerImage(data, size, adoptableMapping, sourceLabel, &levels, outImage);
+}
+
+static int decodeImageBytes(
+    const void* data,
+    size_t size,
+    const VKRT_MappedFile* adoptableMapping,
+    const char* mimeType,
+    const char* sourceLabel,
+    uint32_t preferredColorSpace,
+    VKRT_LoadedImage* outImage
+) {
+    ImageCodec codec = queryImageCodecFromMimeType(mimeType);
+    if (codec == IMAGE_CODEC_UNKNOWN) {
+        codec = queryImageCodecFromBytes((const uint8_t*)data, size);
+    }
+
+    switch (codec) {
+        case IMAGE_CODEC_PNG:
+            return decodePNGImage(data, size, sourceLabel, preferredColorSpace, outImage);
+        case IMAGE_CODEC_JPEG:
+            return decodeJPEGImage(data, size, sourceLabel, preferredColorSpace, outImage);
+        case IMAGE_CODEC_EXR:
+            return decodeEXRImage(data, size, sourceLabel, outImage);
+        case IMAGE_CODEC_KTX2:
+            return decodeKTX2Image((const uint8_t*)data, size, adoptableMapping, sourceLabel, outImage);
+        case IMAGE_CODEC_DDS:
+            return decodeDDSImage(
+                (const uint8_t*)data,
+                size,
+                adoptableMapping,
+                sourceLabel,
+                preferredColorSpace,
+                outImage
+            );
+        case IMAGE_CODEC_UNKNOWN:
+        default:
+            return reportUnsupportedImageFormat(sourceLabel, mimeType);
+    }
 }
 
 int vkrtLoadImageFromFile(const char* path, uint32_t preferredColorSpace, VKRT_LoadedImage* outImage) {
     if (!path || !path[0] || !outImage) return 0;
     *outImage = (VKRT_LoadedImage){0};
 
-    uint8_t* encodedBytes = NULL;
-    size_t encodedSize = 0u;
-    if (!readBinaryFile(path, &encodedBytes, &encodedSize)) {
+    // Decoders read straight from the mapped view; block-compressed containers keep the view as their storage.
+    VKRT_MappedFile file = {0};
+    if (mapFile(path, VKRT_FILE_ACCESS_SEQUENTIAL, &file) != 0) {
+        LOG_ERROR("Failed to map image file: %s", path);
         return 0;
     }
 
-    int result = decodeImageBytes(encodedBytes, encodedSize, NULL, path, preferredColorSpace, outImage);
-    free(encodedBytes);
+    int result = decodeImageBytes(file.data, file.size, &file, NULL, path, preferredColorSpace, outImage);
+    if (outImage->mappedStorage.data != file.data) {
+        unmapFile(&file);
+    }
     return result;
 }
 
@@ -389,11 +699,15 @@ int vkrtLoadImageFromMemory(
 ) {
     if (!data || size == 0u || !outImage) return 0;
     *outImage = (VKRT_LoadedImage){0};
-    return decodeImageBytes(data, size, mimeType, imageSourceLabel(mimeType), preferredColorSpace, outImage);
+    return decodeImageBytes(data, size, NULL, mimeType, imageSourceLabel(mimeType), preferredColorSpace, outImage);
 }
 
 void vkrtFreeLoadedImage(VKRT_LoadedImage* image) {
     if (!image) return;
-    free(image->pixels);
+    if (image->mappedStorage.data) {
+        unmapFile(&image->mappedStorage);
+    } else {
+        free(image->pixels);
+    }
     *image = (VKRT_LoadedImage){0};
 }
@@ -2,18 +2,26 @@
 
 #include "constants.h"
 #include "formats.h"
+#include "io.h"
 
 #include <stddef.h>
 #include <stdint.h>
 
 typedef struct VKRT_LoadedImage {
     void* pixels;
+    VKRT_MappedFile mappedStorage;
     uint32_t width;
     uint32_t height;
     uint32_t format;
     uint32_t colorSpace;
+    uint32_t mipLevelCount;
+    size_t mipLevelOffsets[VKRT_TEXTURE_MAX_MIP_LEVELS];
 } VKRT_LoadedImage;
 
+static inline const void* vkrtLoadedImageBaseLevel(const VKRT_LoadedImage* image) {
+    return (const uint8_t*)image->pixels + (image->mipLevelCount > 0u ? image->mipLevelOffsets[0] : 0u);
+}
+
 int vkrtTryComputeImageByteCount(uint32_t width, uint32_t height, uint32_t channels, size_t* outByteCount);
 int vkrtLoadImageFromFile(const char* path, uint32_t preferredColorSpace, VKRT_LoadedImage* outImage);
 int vkrtLoadImageFromMemory(
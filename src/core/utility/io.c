@@ -3,6 +3,7 @@
 #include "debug.h"
 #include "platform.h"
 
+#include <errno.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -10,13 +11,19 @@
 
 #ifdef _WIN32
 #include <fileapi.h>
+#include <handleapi.h>
 #include <libloaderapi.h>
+#include <memoryapi.h>
 #include <minwindef.h>
 #elif defined(__APPLE__)
+#include <fcntl.h>
 #include <mach-o/dyld.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #else
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #endif
@@ -315,3 +322,189 @@ const char* readFile(const char* filename, size_t* fileSize) {
 
     return buffer;
 }
+
+static int makeDirectory(const char* path) {
+    if (!path || !path[0]) return -1;
+#ifdef _WIN32
+    if (CreateDirectoryA(path, NULL)) return 0;
+    return GetLastError() == ERROR_ALREADY_EXISTS ? 0 : -1;
+#else
+    if (mkdir(path, 0755) == 0) return 0;
+    return errno == EEXIST ? 0 : -1;
+#endif
+}
+
+static const char* queryUserCacheRoot(char* scratch, size_t scratchSize) {
+#ifdef _WIN32
+    const char* localAppData = getenv("LOCALAPPDATA");
+    (void)scratch;
+    (void)scratchSize;
+    return (localAppData && localAppData[0]) ? localAppData : NULL;
+#else
+#if !defined(__APPLE__)
+    const char* xdgCacheHome = getenv("XDG_CACHE_HOME");
+    if (xdgCacheHome && xdgCacheHome[0] == '/') return xdgCacheHome;
+#endif
+    const char* home = getenv("HOME");
+    if (!home || !home[0]) return NULL;
+#if defined(__APPLE__)
+    if (joinPath(scratch, scratchSize, home, "Library/Caches") != 0) return NULL;
+#else
+    if (joinPath(scratch, scratchSize, home, ".cache") != 0) return NULL;
+#endif
+    if (makeDirectory(scratch) != 0) return NULL;
+    return scratch;
+#endif
+}
+
+int resolveUserCacheDirectory(const char* subdirectory, char* outPath, size_t outPathSize) {
+    if (!subdirectory || !subdirectory[0] || !outPath || outPathSize == 0) return -1;
+
+    char rootScratch[VKRT_PATH_MAX];
+    const char* root = queryUserCacheRoot(rootScratch, sizeof(rootScratch));
+    if (!root) return -1;
+    if (joinPath(outPath, outPathSize, root, subdirectory) != 0) return -1;
+    return makeDirectory(outPath);
+}
+
+int writeFileReplacing(const char* path, const void* data, size_t dataSize) {
+    if (!data && dataSize > 0) return -1;
+    VKRT_FileSpan span = {.data = data, .size = dataSize};
+    return writeFileSpansReplacing(path, &span, 1u);
+}
+
+// Writes the spans back to back into a temporary file and renames it over the target, so readers only ever see a
+// complete file. Spans let large payloads be written from where they already live instead of being gathered first.
+int writeFileSpansReplacing(const char* path, const VKRT_FileSpan* spans, size_t spanCount) {
+    if (!path || !path[0] || (!spans && spanCount > 0)) return -1;
+    for (size_t spanIndex = 0; spanIndex < spanCount; spanIndex++) {
+        if (!spans[spanIndex].data && spans[spanIndex].size > 0) return -1;
+    }
+
+    char temporaryPath[VKRT_PATH_MAX];
+    int written = snprintf(temporaryPath, sizeof(temporaryPath), "%s.tmp", path);
+    if (written <= 0 || (size_t)written >= sizeof(temporaryPath)) return -1;
+
+    FILE* file = NULL;
+#ifdef _WIN32
+    if (fopen_s(&file, temporaryPath, "wb") != 0) file = NULL;
+#else
+    file = fopen(temporaryPath, "wb");
+#endif
+    if (!file) return -1;
+
+    int writeFailed = 0;
+    for (size_t spanIndex = 0; spanIndex < spanCount && !writeFailed; spanIndex++) {
+        const VKRT_FileSpan* span = &spans[spanIndex];
+        writeFailed = span->size > 0 && fwrite(span->data, 1, span->size, file) != span->size;
+    }
+    int closeResult = fclose(file);
+    if (writeFailed || closeResult != 0) {
+        (void)remove(temporaryPath);
+        return -1;
+    }
+
+#ifdef _WIN32
+    int replaceResult = MoveFileExA(temporaryPath, path, MOVEFILE_REPLACE_EXISTING) ? 0 : -1;
+#else
+    int replaceResult = rename(temporaryPath, path);
+#endif
+    if (replaceResult != 0) {
+        (void)remove(temporaryPath);
+        return -1;
+    }
+    return 0;
+}
+
+int queryFileStamp(const char* path, VKRT_FileStamp* outStamp) {
+    if (!path || !path[0] || !outStamp) return -1;
+    *outStamp = (VKRT_FileStamp){0};
+
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA attributes = {0};
+    if (!GetFileAttributesExA(path, GetFileExInfoStandard, &attributes)) return -1;
+    outStamp->size = ((uint64_t)attributes.nFileSizeHigh << 32u) | attributes.nFileSizeLow;
+    outStamp->modifiedTime =
+        (int64_t)(((uint64_t)attributes.ftLastWriteTime.dwHighDateTime << 32u) |
+                  attributes.ftLastWriteTime.dwLowDateTime);
+#else
+    struct stat status = {0};
+    if (stat(path, &status) != 0 || status.st_size < 0) return -1;
+    outStamp->size = (uint64_t)status.st_size;
+#if defined(__APPLE__)
+    outStamp->modifiedTime = (int64_t)status.st_mtimespec.tv_sec * 1000000000 + status.st_mtimespec.tv_nsec;
+#else
+    outStamp->modifiedTime = (int64_t)status.st_mtim.tv_sec * 1000000000 + status.st_mtim.tv_nsec;
+#endif
+#endif
+    return 0;
+}
+
+#ifdef _WIN32
+int mapFile(const char* path, VKRT_FileAccessHint accessHint, VKRT_MappedFile* outFile) {
+    if (!path || !path[0] || !outFile) return -1;
+    *outFile = (VKRT_MappedFile){0};
+
+    DWORD flags = accessHint == VKRT_FILE_ACCESS_SEQUENTIAL ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL;
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, flags, NULL);
+    if (file == INVALID_HANDLE_VALUE) return -1;
+
+    LARGE_INTEGER fileSize = {0};
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0 || (uint64_t)fileSize.QuadPart > SIZE_MAX) {
+        CloseHandle(file);
+        return -1;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping) return -1;
+
+    // The view keeps the mapping object alive, so both handles can be closed right away.
+    void* view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!view) return -1;
+
+    outFile->data = view;
+    outFile->size = (size_t)fileSize.QuadPart;
+    return 0;
+}
+
+void unmapFile(VKRT_MappedFile* file) {
+    if (!file) return;
+    if (file->data) UnmapViewOfFile(file->data);
+    *file = (VKRT_MappedFile){0};
+}
+#else
+int mapFile(const char* path, VKRT_FileAccessHint accessHint, VKRT_MappedFile* outFile) {
+    if (!path || !path[0] || !outFile) return -1;
+    *outFile = (VKRT_MappedFile){0};
+
+    int descriptor = open(path, O_RDONLY);
+    if (descriptor < 0) return -1;
+
+    struct stat status = {0};
+    if (fstat(descriptor, &status) != 0 || status.st_size <= 0 || (uint64_t)status.st_size > SIZE_MAX) {
+        (void)close(descriptor);
+        return -1;
+    }
+
+    size_t size = (size_t)status.st_size;
+    void* view = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, descriptor, 0);
+    (void)close(descriptor);
+    if (view == MAP_FAILED) return -1;
+
+    if (accessHint == VKRT_FILE_ACCESS_SEQUENTIAL) {
+        (void)madvise(view, size, MADV_SEQUENTIAL);
+    }
+
+    outFile->data = view;
+    outFile->size = size;
+    return 0;
+}
+
+void unmapFile(VKRT_MappedFile* file) {
+    if (!file) return;
+    if (file->data) (void)munmap(file->data, file->size);
+    *file = (VKRT_MappedFile){0};
+}
+#endif
@@ -3,11 +3,35 @@
 #include "platform.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+typedef enum VKRT_FileAccessHint {
+    VKRT_FILE_ACCESS_NORMAL = 0,
+    VKRT_FILE_ACCESS_SEQUENTIAL,
+} VKRT_FileAccessHint;
+
+// A private copy-on-write view of a whole file. Pages are faulted in from the page cache on first touch instead of
+// being copied into the heap up front.
+typedef struct VKRT_MappedFile {
+    void* data;
+    size_t size;
+} VKRT_MappedFile;
+
+// Size and modification time of a file, used to notice when a derived file has gone stale.
+typedef struct VKRT_FileStamp {
+    uint64_t size;
+    int64_t modifiedTime;
+} VKRT_FileStamp;
+
+typedef struct VKRT_FileSpan {
+    const void* data;
+    size_t size;
+} VKRT_FileSpan;
+
 char* stringDuplicate(const char* value);
 const char* pathBasename(const char* path);
 char* pathTrimTrailingSeparators(char* path);
@@ -15,6 +39,12 @@ int copyParentDirectoryPath(const char* path, char* outDirectory, size_t outDire
 int resolveExistingParentPath(const char* preferredPath, const char* fallbackPath, char* outPath, size_t outPathSize);
 const char* readFile(const char* filename, size_t* fileSize);
 int resolveExistingPath(const char* path, char* outPath, size_t outPathSize);
+int resolveUserCacheDirectory(const char* subdirectory, char* outPath, size_t outPathSize);
+int writeFileReplacing(const char* path, const void* data, size_t dataSize);
+int writeFileSpansReplacing(const char* path, const VKRT_FileSpan* spans, size_t spanCount);
+int queryFileStamp(const char* path, VKRT_FileStamp* outStamp);
+int mapFile(const char* path, VKRT_FileAccessHint accessHint, VKRT_MappedFile* outFile);
+void unmapFile(VKRT_MappedFile* file);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,284 @@
+#include "job_pool.h"
+
+#include "platform.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef struct JobRange {
+    VKRT_Mutex mutex;
+    uint32_t begin;
+    uint32_t end;
+} JobRange;
+
+typedef struct JobWorker {
+    VKRT_JobPool* pool;
+    uint32_t rangeIndex;
+} JobWorker;
+
+struct VKRT_JobPool {
+    VKRT_Thread* threads;
+    JobWorker* workers;
+    JobRange* ranges;
+    uint32_t threadCount;
+    uint32_t rangeCount;
+    VKRT_Mutex submitMutex;
+    VKRT_Mutex mutex;
+    VKRT_Cond workReady;
+    VKRT_Cond workDone;
+    VKRT_JobFunc function;
+    void* userData;
+    uint64_t generation;
+    uint32_t activeThreads;
+    int failed;
+    int shutdown;
+};
+
+static VKRT_JobPool* gSharedJobPool = NULL;
+static uint32_t gSharedJobPoolRefCount = 0u;
+
+static int popOwnJob(JobRange* range, uint32_t* outJobIndex) {
+    int taken = 0;
+    vkrtMutexLock(&range->mutex);
+    if (range->begin < range->end) {
+        *outJobIndex = range->begin++;
+        taken = 1;
+    }
+    vkrtMutexUnlock(&range->mutex);
+    return taken;
+}
+
+// Takes the back half of the victim's remaining jobs so a thief rarely needs to come back for more.
+static int stealJobs(JobRange* victim, JobRange* own) {
+    uint32_t begin = 0u;
+    uint32_t end = 0u;
+    vkrtMutexLock(&victim->mutex);
+    if (victim->begin < victim->end) {
+        uint32_t count = (victim->end - victim->begin + 1u) / 2u;
+        end = victim->end;
+        begin = end - count;
+        victim->end = begin;
+    }
+    vkrtMutexUnlock(&victim->mutex);
+    if (begin == end) return 0;
+
+    vkrtMutexLock(&own->mutex);
+    own->begin = begin;
+    own->end = end;
+    vkrtMutexUnlock(&own->mutex);
+    return 1;
+}
+
+static int takeJob(VKRT_JobPool* pool, uint32_t rangeIndex, uint32_t* outJobIndex) {
+    JobRange* own = &pool->ranges[rangeIndex];
+    while (!popOwnJob(own, outJobIndex)) {
+        int stole = 0;
+        for (uint32_t offset = 1u; offset < pool->rangeCount && !stole; offset++) {
+            stole = stealJobs(&pool->ranges[(rangeIndex + offset) % pool->rangeCount], own);
+        }
+        if (!stole) return 0;
+    }
+    return 1;
+}
+
+static void runJobs(VKRT_JobPool* pool, uint32_t rangeIndex) {
+    uint32_t jobIndex = 0u;
+    while (takeJob(pool, rangeIndex, &jobIndex)) {
+        if (pool->function(pool->userData, jobIndex) != 0) {
+            vkrtMutexLock(&pool->mutex);
+            pool->failed = 1;
+            vkrtMutexUnlock(&pool->mutex);
+        }
+    }
+}
+
+static int jobWorkerMain(void* userData) {
+    JobWorker* worker = (JobWorker*)userData;
+    VKRT_JobPool* pool = worker->pool;
+    uint64_t seenGeneration = 0u;
+
+    for (;;) {
+        vkrtMutexLock(&pool->mutex);
+        while (!pool->shutdown && pool->generation == seenGeneration) {
+            vkrtCondWait(&pool->workReady, &pool->mutex);
+        }
+        if (pool->shutdown) {
+            vkrtMutexUnlock(&pool->mutex);
+            return 0;
+        }
+        seenGeneration = pool->generation;
+        vkrtMutexUnlock(&pool->mutex);
+
+        runJobs(pool, worker->rangeIndex);
+
+        vkrtMutexLock(&pool->mutex);
+        if (--pool->activeThreads == 0u) {
+            vkrtCondBroadcast(&pool->workDone);
+        }
+        vkrtMutexUnlock(&pool->mutex);
+    }
+}
+
+static void releaseJobPoolStorage(VKRT_JobPool* pool, uint32_t initializedRangeCount) {
+    for (uint32_t rangeIndex = 0u; rangeIndex < initializedRangeCount; rangeIndex++) {
+        vkrtMutexDestroy(&pool->ranges[rangeIndex].mutex);
+    }
+    free(pool->threads);
+    free(pool->workers);
+    free(pool->ranges);
+    free(pool);
+}
+
+// A worker count of zero sizes the pool to the machine. The calling thread counts as one worker.
+VKRT_JobPool* vkrtJobPoolCreate(uint32_t workerCount) {
+    if (workerCount == 0u) workerCount = vkrtQueryProcessorCount();
+    if (workerCount == 0u) workerCount = 1u;
+
+    VKRT_JobPool* pool = (VKRT_JobPool*)calloc(1u, sizeof(*pool));
+    if (!pool) return NULL;
+
+    pool->rangeCount = workerCount;
+    pool->ranges = (JobRange*)calloc(workerCount, sizeof(*pool->ranges));
+    pool->workers = (JobWorker*)calloc(workerCount, sizeof(*pool->workers));
+    pool->threads = (VKRT_Thread*)calloc(workerCount, sizeof(*pool->threads));
+    if (!pool->ranges || !pool->workers || !pool->threads) {
+        releaseJobPoolStorage(pool, 0u);
+        return NULL;
+    }
+
+    uint32_t initializedRangeCount = 0u;
+    for (; initializedRangeCount < workerCount; initializedRangeCount++) {
+        if (vkrtMutexInit(&pool->ranges[initializedRangeCount].mutex, VKRT_MUTEX_PLAIN) != VKRT_THREAD_SUCCESS) {
+            break;
+        }
+    }
+    if (initializedRangeCount != workerCount) {
+        releaseJobPoolStorage(pool, initializedRangeCount);
+        return NULL;
+    }
+
+    if (vkrtMutexInit(&pool->submitMutex, VKRT_MUTEX_PLAIN) != VKRT_THREAD_SUCCESS) {
+        releaseJobPoolStorage(pool, workerCount);
+        return NULL;
+    }
+    if (vkrtMutexInit(&pool->mutex, VKRT_MUTEX_PLAIN) != VKRT_THREAD_SUCCESS) {
+        vkrtMutexDestroy(&pool->submitMutex);
+        releaseJobPoolStorage(pool, workerCount);
+        return NULL;
+    }
+    if (vkrtCondInit(&pool->workReady) != VKRT_THREAD_SUCCESS) {
+        vkrtMutexDestroy(&pool->mutex);
+        vkrtMutexDestroy(&pool->submitMutex);
+        releaseJobPoolStorage(pool, workerCount);
+        return NULL;
+    }
+    if (vkrtCondInit(&pool->workDone) != VKRT_THREAD_SUCCESS) {
+        vkrtCondDestroy(&pool->workReady);
+        vkrtMutexDestroy(&pool->mutex);
+        vkrtMutexDestroy(&pool->submitMutex);
+        releaseJobPoolStorage(pool, workerCount);
+        return NULL;
+    }
+
+    // Range 0 belongs to the submitting thread. A thread that fails to start just leaves its range to be stolen.
+    for (uint32_t rangeIndex = 1u; rangeIndex < workerCount; rangeIndex++) {
+        JobWorker* worker = &pool->workers[pool->threadCount];
+        *worker = (JobWorker){.pool = pool, .rangeIndex = rangeIndex};
+        if (vkrtThreadCreate(&pool->threads[pool->threadCount], jobWorkerMain, worker) != VKRT_THREAD_SUCCESS) {
+            break;
+        }
+        pool->threadCount++;
+    }
+    return pool;
+}
+
+void vkrtJobPoolDestroy(VKRT_JobPool* pool) {
+    if (!pool) return;
+
+    vkrtMutexLock(&pool->mutex);
+    pool->shutdown = 1;
+    vkrtCondBroadcast(&pool->workReady);
+    vkrtMutexUnlock(&pool->mutex);
+
+    for (uint32_t threadIndex = 0u; threadIndex < pool->threadCount; threadIndex++) {
+        vkrtThreadJoin(pool->threads[threadIndex], NULL);
+    }
+
+    vkrtCondDestroy(&pool->workDone);
+    vkrtCondDestroy(&pool->workReady);
+    vkrtMutexDestroy(&pool->mutex);
+    vkrtMutexDestroy(&pool->submitMutex);
+    releaseJobPoolStorage(pool, pool->rangeCount);
+}
+
+uint32_t vkrtJobPoolWorkerCount(const VKRT_JobPool* pool) {
+    return pool ? pool->threadCount + 1u : 1u;
+}
+
+// Returns 0 when every job returned 0. A missing pool or a single job runs inline on the caller.
+int vkrtJobPoolRun(VKRT_JobPool* pool, uint32_t jobCount, VKRT_JobFunc function, void* userData) {
+    if (!function) return -1;
+    if (jobCount == 0u) return 0;
+
+    if (!pool || pool->threadCount == 0u || jobCount == 1u) {
+        int failed = 0;
+        for (uint32_t jobIndex = 0u; jobIndex < jobCount; jobIndex++) {
+            if (function(userData, jobIndex) != 0) failed = 1;
+        }
+        return failed ? -1 : 0;
+    }
+
+    vkrtMutexLock(&pool->submitMutex);
+
+    for (uint32_t rangeIndex = 0u; rangeIndex < pool->rangeCount; rangeIndex++) {
+        JobRange* range = &pool->ranges[rangeIndex];
+        vkrtMutexLock(&range->mutex);
+        range->begin = (uint32_t)(((uint64_t)jobCount * rangeIndex) / pool->rangeCount);
+        range->end = (uint32_t)(((uint64_t)jobCount * (rangeIndex + 1u)) / pool->rangeCount);
+        vkrtMutexUnlock(&range->mutex);
+    }
+
+    vkrtMutexLock(&pool->mutex);
+    pool->function = function;
+    pool->userData = userData;
+    pool->failed = 0;
+    pool->activeThreads = pool->threadCount;
+    pool->generation++;
+    vkrtCondBroadcast(&pool->workReady);
+    vkrtMutexUnlock(&pool->mutex);
+
+    runJobs(pool, 0u);
+
+    vkrtMutexLock(&pool->mutex);
+    while (pool->activeThreads > 0u) {
+        vkrtCondWait(&pool->workDone, &pool->mutex);
+    }
+    int failed = pool->failed;
+    vkrtMutexUnlock(&pool->mutex);
+
+    vkrtMutexUnlock(&pool->submitMutex);
+    return failed ? -1 : 0;
+}
+
+VKRT_JobPool* vkrtJobPoolAcquireShared(void) {
+    if (gSharedJobPoolRefCount == 0u) {
+        gSharedJobPool = vkrtJobPoolCreate(0u);
+    }
+    gSharedJobPoolRefCount++;
+    return gSharedJobPool;
+}
+
+void vkrtJobPoolReleaseShared(void) {
+    if (gSharedJobPoolRefCount == 0u) return;
+
+    gSharedJobPoolRefCount--;
+    if (gSharedJobPoolRefCount == 0u) {
+        vkrtJobPoolDestroy(gSharedJobPool);
+        gSharedJobPool = NULL;
+    }
+}
+
+VKRT_JobPool* vkrtJobPoolShared(void) {
+    return gSharedJobPool;
+}
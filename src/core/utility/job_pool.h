@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdint.h>
+
+// Runs batches of indexed jobs on a fixed set of worker threads. Each batch is split into one contiguous range per
+// worker; a worker that drains its range steals half of what another worker has left. Jobs write their results by
+// index, so output order never depends on scheduling. The submitting thread works through the batch too, and jobs
+// must not submit to the pool that runs them.
+typedef int (*VKRT_JobFunc)(void* userData, uint32_t jobIndex);
+typedef struct VKRT_JobPool VKRT_JobPool;
+
+VKRT_JobPool* vkrtJobPoolCreate(uint32_t workerCount);
+void vkrtJobPoolDestroy(VKRT_JobPool* pool);
+uint32_t vkrtJobPoolWorkerCount(const VKRT_JobPool* pool);
+int vkrtJobPoolRun(VKRT_JobPool* pool, uint32_t jobCount, VKRT_JobFunc function, void* userData);
+
+// One pool sized to the machine, shared by everything that fans work out. Each VKRT instance holds a reference while
+// it is initialized. Acquire and release on the thread that owns the instances; vkrtJobPoolShared may be called from
+// any thread and returns NULL when no reference is held, which runs batches inline.
+VKRT_JobPool* vkrtJobPoolAcquireShared(void);
+void vkrtJobPoolReleaseShared(void);
+VKRT_JobPool* vkrtJobPoolShared(void);
@@ -85,10 +85,43 @@ static uint16_t f32tof16(float value) {
     return (uint16_t)half;
 }
 
+uint16_t packHalf(float value) {
+    return f32tof16(value);
+}
+
 uint32_t packHalf2(const float input[2]) {
     return (uint32_t)f32tof16(input[0]) | ((uint32_t)f32tof16(input[1]) << sizeof(uint16_t));
 }
 
+float unpackHalf(uint16_t value) {
+    uint32_t sign = ((uint32_t)value & 0x8000u) << 16u;
+    uint32_t exponent = ((uint32_t)value >> 10u) & 0x1fu;
+    uint32_t mantissa = (uint32_t)value & 0x03ffu;
+    uint32_t bits = 0u;
+
+    if (exponent == 0u) {
+        if (mantissa == 0u) {
+            bits = sign;
+        } else {
+            exponent = 1u;
+            while ((mantissa & 0x0400u) == 0u) {
+                mantissa <<= 1u;
+                exponent++;
+            }
+            mantissa &= 0x03ffu;
+            bits = sign | ((127u - 15u - exponent + 1u) << 23u) | (mantissa << 13u);
+        }
+    } else if (exponent == 0x1fu) {
+        bits = sign | 0x7f800000u | (mantissa << 13u);
+    } else {
+        bits = sign | ((exponent + (127u - 15u)) << 23u) | (mantissa << 13u);
+    }
+
+    float result = 0.0f;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
 uint32_t packOctNormal32(const float normal[3]) {
     float norm[3];
     normalize3f(normal, norm);
@@ -145,12 +178,11 @@ ShaderVertex packShaderVertex(const Vertex* vertex) {
     ShaderVertex packed = {0};
     if (!vertex) return packed;
 
-    memcpy(packed.position, vertex->position, sizeof(packed.position));
     packed.packedNormal = packOctNormal32(vertex->normal);
     packed.packedTangent = packTangent32(vertex->tangent);
     packed.packedColor = packColorRGBA8(vertex->color);
     memcpy(packed.texcoord0, vertex->texcoord0, sizeof(packed.texcoord0));
-    memcpy(packed.texcoord1, vertex->texcoord1, sizeof(packed.texcoord1));
+    packed.packedTexcoord1 = packHalf2(vertex->texcoord1);
 
     return packed;
 }
@@ -4,7 +4,9 @@
 
 #include <stdint.h>
 
+uint16_t packHalf(float value);
 uint32_t packHalf2(const float input[2]);
+float unpackHalf(uint16_t value);
 uint32_t packOctNormal32(const float normal[3]);
 uint32_t packSnorm15(float value);
 uint32_t packTangent32(const float tangent[4]);
@@ -145,9 +145,15 @@ int vkrtThreadJoin(VKRT_Thread thread, int* result) {
     return VKRT_THREAD_SUCCESS;
 }
 
+uint32_t vkrtQueryProcessorCount(void) {
+    DWORD count = GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+    return count > 0u ? (uint32_t)count : 1u;
+}
+
 #else
 
 #include <pthread.h>
+#include <unistd.h>
 
 static int gVkrtInfoLoggingEnabled = 1;
 
@@ -263,4 +269,9 @@ int vkrtThreadJoin(VKRT_Thread thread, int* result) {
     return VKRT_THREAD_SUCCESS;
 }
 
+uint32_t vkrtQueryProcessorCount(void) {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (uint32_t)count : 1u;
+}
+
 #endif
@@ -61,3 +61,5 @@ int vkrtCondBroadcast(VKRT_Cond* condition);
 
 int vkrtThreadCreate(VKRT_Thread* thread, VKRT_ThreadFunc function, void* argument);
 int vkrtThreadJoin(VKRT_Thread thread, int* result);
+
+uint32_t vkrtQueryProcessorCount(void);
@@ -51,8 +51,35 @@
 #define VKRT_DEBUG_MODE_DENOISER_FOLLOW_SPECULAR  16u
 #define VKRT_DEBUG_MODE_COUNT                     17u
 
+#define VKRT_LIGHT_SAMPLING_MODE_ALIAS 0u
+#define VKRT_LIGHT_SAMPLING_MODE_BVH   1u
+#define VKRT_LIGHT_SAMPLING_MODE_COUNT 2u
+
+#define VKRT_LIGHT_BVH_LEAF_BIT           0x80000000u
+#define VKRT_LIGHT_BVH_MAX_DEPTH          32u
+#define VKRT_LIGHT_CLUSTER_TRIANGLE_COUNT 16u
+
+#define VKRT_DIRECT_LIGHTING_MODE_NEE             0u
+#define VKRT_DIRECT_LIGHTING_MODE_RESTIR_UNBIASED 1u
+#define VKRT_DIRECT_LIGHTING_MODE_RESTIR_BIASED   2u
+#define VKRT_DIRECT_LIGHTING_MODE_COUNT           3u
+
+#define VKRT_SAMPLER_MODE_HASH       0u
+#define VKRT_SAMPLER_MODE_SOBOL      1u
+#define VKRT_SAMPLER_MODE_BLUE_NOISE 2u
+#define VKRT_SAMPLER_MODE_COUNT      3u
+
+#define VKRT_SOBOL_DIMENSION_COUNT 4u
+#define VKRT_SOBOL_DIRECTION_BITS  32u
+#define VKRT_BLUE_NOISE_SIZE       64u
+
 #define VKRT_INVALID_INDEX 0xFFFFFFFFu
 
+#define VKRT_ADAPTIVE_TILE_SIZE        16u
+#define VKRT_ADAPTIVE_MIN_SAMPLES      16u
+#define VKRT_ADAPTIVE_MAX_SAMPLE_SCALE 4u
+#define VKRT_ADAPTIVE_LUMINANCE_FLOOR  0.01f
+
 #define VKRT_MATERIAL_ALPHA_MODE_OPAQUE 0u
 #define VKRT_MATERIAL_ALPHA_MODE_MASK   1u
 #define VKRT_MATERIAL_ALPHA_MODE_BLEND  2u
@@ -63,6 +90,11 @@
 
 #define VKRT_MAX_BINDLESS_TEXTURES 1024u
 
+#define VKRT_VERTEX_POSITION_COMPONENTS     3u
+#define VKRT_MESH_INDEX_FORMAT_UINT32       0u
+#define VKRT_MESH_INDEX_FORMAT_UINT16       1u
+#define VKRT_MESH_UINT16_INDEX_VERTEX_LIMIT 65536u
+
 #define VKRT_MATERIAL_TEXTURE_SLOT_BASE_COLOR         0u
 #define VKRT_MATERIAL_TEXTURE_SLOT_METALLIC_ROUGHNESS 1u
 #define VKRT_MATERIAL_TEXTURE_SLOT_NORMAL             2u
@@ -73,6 +105,7 @@
 #define VKRT_TEXTURE_WRAP_CLAMP_TO_EDGE    33071u
 #define VKRT_TEXTURE_WRAP_MIRRORED_REPEAT  33648u
 #define VKRT_TEXTURE_SAMPLER_VARIANT_COUNT 9u
+#define VKRT_TEXTURE_MAX_MIP_LEVELS        32u
 #define VKRT_TEXTURE_WRAP_DEFAULT          (VKRT_TEXTURE_WRAP_REPEAT | (VKRT_TEXTURE_WRAP_REPEAT << 16u))
 
 #endif
@@ -1,6 +1,7 @@
 #ifndef VKRT_SHARED_TEXTURE_FORMATS_H
 #define VKRT_SHARED_TEXTURE_FORMATS_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 typedef uint32_t VKRT_TextureFormat;
@@ -10,7 +11,56 @@ enum {
     VKRT_TEXTURE_FORMAT_RGBA16_UNORM = 1u,
     VKRT_TEXTURE_FORMAT_RGBA16_SFLOAT = 2u,
     VKRT_TEXTURE_FORMAT_RGBA32_SFLOAT = 3u,
-    VKRT_TEXTURE_FORMAT_COUNT = 4u,
+    VKRT_TEXTURE_FORMAT_BC1_RGBA_UNORM = 4u,
+    VKRT_TEXTURE_FORMAT_BC3_RGBA_UNORM = 5u,
+    VKRT_TEXTURE_FORMAT_BC4_R_UNORM = 6u,
+    VKRT_TEXTURE_FORMAT_BC5_RG_UNORM = 7u,
+    VKRT_TEXTURE_FORMAT_BC7_RGBA_UNORM = 8u,
+    VKRT_TEXTURE_FORMAT_BC1_RGB_UNORM = 9u,
+    VKRT_TEXTURE_FORMAT_COUNT = 10u,
 };
 
+static inline int vkrtTextureFormatIsBlockCompressed(uint32_t format) {
+    return format >= VKRT_TEXTURE_FORMAT_BC1_RGBA_UNORM && format < VKRT_TEXTURE_FORMAT_COUNT;
+}
+
+static inline uint32_t vkrtTextureFormatBlockExtent(uint32_t format) {
+    return vkrtTextureFormatIsBlockCompressed(format) ? 4u : 1u;
+}
+
+static inline uint32_t vkrtTextureFormatBlockBytes(uint32_t format) {
+    switch (format) {
+        case VKRT_TEXTURE_FORMAT_RGBA8_UNORM:
+            return 4u;
+        case VKRT_TEXTURE_FORMAT_RGBA16_UNORM:
+        case VKRT_TEXTURE_FORMAT_RGBA16_SFLOAT:
+        case VKRT_TEXTURE_FORMAT_BC1_RGBA_UNORM:
+        case VKRT_TEXTURE_FORMAT_BC1_RGB_UNORM:
+        case VKRT_TEXTURE_FORMAT_BC4_R_UNORM:
+            return 8u;
+        case VKRT_TEXTURE_FORMAT_RGBA32_SFLOAT:
+        case VKRT_TEXTURE_FORMAT_BC3_RGBA_UNORM:
+        case VKRT_TEXTURE_FORMAT_BC5_RG_UNORM:
+        case VKRT_TEXTURE_FORMAT_BC7_RGBA_UNORM:
+            return 16u;
+        default:
+            return 0u;
+    }
+}
+
+static inline int vkrtTryComputeTextureByteSize(uint32_t width, uint32_t height, uint32_t format, size_t* outBytes) {
+    if (!outBytes || width == 0u || height == 0u) return 0;
+    uint32_t blockBytes = vkrtTextureFormatBlockBytes(format);
+    if (blockBytes == 0u) return 0;
+
+    uint32_t blockExtent = vkrtTextureFormatBlockExtent(format);
+    size_t blocksWide = ((size_t)width + blockExtent - 1u) / blockExtent;
+    size_t blocksHigh = ((size_t)height + blockExtent - 1u) / blockExtent;
+    size_t rowBytes = blocksWide * (size_t)blockBytes;
+    if (blocksHigh > SIZE_MAX / rowBytes) return 0;
+
+    *outBytes = rowBytes * blocksHigh;
+    return 1;
+}
+
 #endif
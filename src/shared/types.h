@@ -32,29 +32,28 @@ VKRT_SHARED_STRUCT(Vertex, {
 })
 
 VKRT_SHARED_STRUCT(ShaderVertex, {
-    float4 position;
     float2 texcoord0;
-    float2 texcoord1;
+    uint packedTexcoord1;
     uint packedNormal;
     uint packedTangent;
     uint packedColor;
 })
 
 VKRT_SHARED_STRUCT(MeshInfo, {
-    float3 position;
+    float4 objectToWorld[3];
+    float4 normalToWorld[3];
     uint vertexBase;
-    float3 rotation;
     uint vertexCount;
-    float3 scale;
     uint indexBase;
     uint indexCount;
     uint materialIndex;
     uint renderBackfaces;
     float lightPdfArea;
     float opacity;
-    uint reserved0;
+    float transformSign;
+    uint indexFormat;
+    uint lightEmitterOffset;
     uint reserved1;
-    uint reserved2;
 })
 
 VKRT_SHARED_STRUCT(Material, {
@@ -100,13 +99,19 @@ VKRT_SHARED_STRUCT(Material, {
     float4 textureRotations;
 })
 
+// One light-sampling emitter: a cluster of up to VKRT_LIGHT_CLUSTER_TRIANGLE_COUNT consecutive triangles of an
+// emissive mesh. A mesh's clusters are stored contiguously from MeshInfo.lightEmitterOffset.
 VKRT_SHARED_STRUCT(EmissiveMesh, {
     uint triOffset;
     uint triCount;
     float pmfMesh;
     float invTotalArea;
     float3 emission;
-    float reserved0;
+    uint meshIndex;
+    uint lightBitTrail;
+    uint reserved0;
+    uint reserved1;
+    uint reserved2;
 })
 
 VKRT_SHARED_STRUCT(EmissiveTriangle, {
@@ -115,6 +120,13 @@ VKRT_SHARED_STRUCT(EmissiveTriangle, {
     float4 e2Pad;
 })
 
+VKRT_SHARED_STRUCT(LightBVHNode, {
+    float4 boundsMinPower;
+    float4 boundsMaxCosTheta;
+    float3 axis;
+    uint childOrEmitter;
+})
+
 VKRT_SHARED_STRUCT(RGB2SpecTableInfo, {
     uint res;
     uint scaleOffset;
@@ -128,6 +140,8 @@ VKRT_SHARED_STRUCT(RGB2SpecTableInfo, {
 VKRT_SHARED_STRUCT(SceneData, {
     float4x4 viewInverse;
     float4x4 projInverse;
+    float4x4 prevViewInverse;
+    float4x4 prevProjInverse;
     uint frameNumber;
     uint samplesPerPixel;
     uint rrMaxDepth;
@@ -146,6 +160,18 @@ VKRT_SHARED_STRUCT(SceneData, {
     uint emissiveTriangleCount;
     uint selectionEnabled;
     uint selectedMeshIndex;
+    float environmentSelectionProbability;
+    uint environmentSamplingWidth;
+    uint environmentSamplingHeight;
+    float environmentSamplingPdfScale;
+    float noiseThreshold;
+    uint adaptiveMinSamples;
+    uint adaptiveMaxSampleScale;
+    uint lightSamplingMode;
+    uint directLightingMode;
+    uint reservoirHistoryValid;
+    uint samplerMode;
+    uint reserved1;
     RGB2SpecTableInfo rgb2specSRGB;
 })
 
@@ -158,6 +184,11 @@ VKRT_SHARED_STRUCT(Selection, {
     uint hitMeshIndex;
 })
 
+VKRT_SHARED_STRUCT(AdaptiveStatus, {
+    uint activeTileCount;
+    uint evaluatedTileCount;
+})
+
 #undef VKRT_SHARED_STRUCT
 
 #endif
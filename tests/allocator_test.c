@@ -0,0 +1,410 @@
+#include "allocator.h"
+#include "test.h"
+#include "vkrt_internal.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vulkan/vulkan.h>
+
+// Drives the block sub-allocator against a mock memory-type table. The Vulkan entry points it calls are defined here,
+// so the test needs neither a loader nor a device.
+
+enum {
+    MOCK_TYPE_DEVICE_LOCAL = 0,
+    MOCK_TYPE_HOST_VISIBLE = 1,
+    MOCK_TYPE_SMALL_HEAP = 2,
+    MOCK_TYPE_COUNT = 3,
+};
+
+static const VkDeviceSize kMockLargeHeapSize = 8ull * 1024ull * 1024ull * 1024ull;
+static const VkDeviceSize kMockSmallHeapSize = 256ull * 1024ull * 1024ull;
+static const VkDeviceSize kMockLargeBlockSize = 64ull * 1024ull * 1024ull;
+
+typedef struct MockDeviceMemory {
+    VkDeviceSize size;
+    uint32_t memoryTypeIndex;
+    void* mapped;
+} MockDeviceMemory;
+
+typedef struct MockDevice {
+    VkMemoryRequirements nextRequirements;
+    VkDeviceMemory boundMemory;
+    VkDeviceSize boundOffset;
+    uint32_t liveMemoryCount;
+    uint32_t allocateCallCount;
+    VkDeviceSize lastAllocationSize;
+} MockDevice;
+
+static MockDevice gMockDevice;
+
+VKAPI_ATTR void VKAPI_CALL
+vkGetPhysicalDeviceMemoryProperties(VkPhysicalDevice physicalDevice, VkPhysicalDeviceMemoryProperties* outProperties) {
+    (void)physicalDevice;
+    memset(outProperties, 0, sizeof(*outProperties));
+    outProperties->memoryHeapCount = 3u;
+    outProperties->memoryHeaps[0] = (VkMemoryHeap){kMockLargeHeapSize, VK_MEMORY_HEAP_DEVICE_LOCAL_BIT};
+    outProperties->memoryHeaps[1] = (VkMemoryHeap){kMockLargeHeapSize, 0u};
+    outProperties->memoryHeaps[2] = (VkMemoryHeap){kMockSmallHeapSize, VK_MEMORY_HEAP_DEVICE_LOCAL_BIT};
+
+    outProperties->memoryTypeCount = MOCK_TYPE_COUNT;
+    outProperties->memoryTypes[MOCK_TYPE_DEVICE_LOCAL] = (VkMemoryType){VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0u};
+    outProperties->memoryTypes[MOCK_TYPE_HOST_VISIBLE] = (VkMemoryType){
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        1u,
+    };
+    outProperties->memoryTypes[MOCK_TYPE_SMALL_HEAP] = (VkMemoryType){
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+        2u,
+    };
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkAllocateMemory(
+    VkDevice device,
+    const VkMemoryAllocateInfo* allocateInfo,
+    const VkAllocationCallbacks* allocator,
+    VkDeviceMemory* outMemory
+) {
+    (void)device;
+    (void)allocator;
+    MockDeviceMemory* memory = (MockDeviceMemory*)calloc(1, sizeof(MockDeviceMemory));
+    if (!memory) return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+
+    memory->size = allocateInfo->allocationSize;
+    memory->memoryTypeIndex = allocateInfo->memoryTypeIndex;
+    gMockDevice.liveMemoryCount++;
+    gMockDevice.allocateCallCount++;
+    gMockDevice.lastAllocationSize = allocateInfo->allocationSize;
+    *outMemory = (VkDeviceMemory)memory;
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL
+vkFreeMemory(VkDevice device, VkDeviceMemory memory, const VkAllocationCallbacks* allocator) {
+    (void)device;
+    (void)allocator;
+    MockDeviceMemory* mock = (MockDeviceMemory*)memory;
+    if (!mock) return;
+    free(mock->mapped);
+    free(mock);
+    gMockDevice.liveMemoryCount--;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkMapMemory(
+    VkDevice device,
+    VkDeviceMemory memory,
+    VkDeviceSize offset,
+    VkDeviceSize size,
+    VkMemoryMapFlags flags,
+    void** outData
+) {
+    (void)device;
+    (void)offset;
+    (void)size;
+    (void)flags;
+    MockDeviceMemory* mock = (MockDeviceMemory*)memory;
+    // Untouched pages of a large malloc are never committed, so mapping whole mock blocks stays cheap.
+    if (!mock->mapped) mock->mapped = malloc((size_t)mock->size);
+    *outData = mock->mapped;
+    return mock->mapped ? VK_SUCCESS : VK_ERROR_OUT_OF_DEVICE_MEMORY;
+}
+
+VKAPI_ATTR void VKAPI_CALL
+vkGetBufferMemoryRequirements(VkDevice device, VkBuffer buffer, VkMemoryRequirements* outRequirements) {
+    (void)device;
+    (void)buffer;
+    *outRequirements = gMockDevice.nextRequirements;
+}
+
+VKAPI_ATTR void VKAPI_CALL
+vkGetImageMemoryRequirements(VkDevice device, VkImage image, VkMemoryRequirements* outRequirements) {
+    (void)device;
+    (void)image;
+    *outRequirements = gMockDevice.nextRequirements;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+vkBindBufferMemory(VkDevice device, VkBuffer buffer, VkDeviceMemory memory, VkDeviceSize offset) {
+    (void)device;
+    (void)buffer;
+    gMockDevice.boundMemory = memory;
+    gMockDevice.boundOffset = offset;
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+vkBindImageMemory(VkDevice device, VkImage image, VkDeviceMemory memory, VkDeviceSize offset) {
+    (void)device;
+    (void)image;
+    gMockDevice.boundMemory = memory;
+    gMockDevice.boundOffset = offset;
+    return VK_SUCCESS;
+}
+
+// What the allocator bound a resource to, as seen by the mock driver.
+typedef struct TestAllocation {
+    MemoryAllocation handle;
+    const MockDeviceMemory* memory;
+    VkDeviceSize offset;
+    VkDeviceSize size;
+} TestAllocation;
+
+static VKRT* createMockRuntime(void) {
+    VKRT* vkrt = (VKRT*)calloc(1, sizeof(VKRT));
+    if (!vkrt) return NULL;
+
+    vkrt->core.physicalDevice = (VkPhysicalDevice)(uintptr_t)0x1;
+    vkrt->core.device = (VkDevice)(uintptr_t)0x2;
+    if (vkrtCreateMemoryAllocator(vkrt) != VKRT_SUCCESS) {
+        free(vkrt);
+        return NULL;
+    }
+    return vkrt;
+}
+
+static void destroyMockRuntime(VKRT* vkrt) {
+    vkrtDestroyMemoryAllocator(vkrt);
+    free(vkrt);
+}
+
+static TestAllocation recordBinding(MemoryAllocation handle, VkDeviceSize size) {
+    if (!handle) return (TestAllocation){0};
+    return (TestAllocation){
+        .handle = handle,
+        .memory = (const MockDeviceMemory*)gMockDevice.boundMemory,
+        .offset = gMockDevice.boundOffset,
+        .size = size,
+    };
+}
+
+static TestAllocation allocateBuffer(
+    VKRT* vkrt,
+    VkDeviceSize size,
+    VkDeviceSize alignment,
+    uint32_t memoryTypeBits,
+    VkMemoryPropertyFlags properties
+) {
+    gMockDevice.nextRequirements = (VkMemoryRequirements){size, alignment, memoryTypeBits};
+    MemoryAllocation handle = VK_NULL_HANDLE;
+    VkBuffer buffer = (VkBuffer)(uintptr_t)0x10;
+    if (vkrtAllocateBufferMemory(vkrt, buffer, properties, &handle) != VKRT_SUCCESS) return (TestAllocation){0};
+    return recordBinding(handle, size);
+}
+
+static TestAllocation allocateDeviceBuffer(VKRT* vkrt, VkDeviceSize size, VkDeviceSize alignment) {
+    return allocateBuffer(vkrt, size, alignment, 1u << MOCK_TYPE_DEVICE_LOCAL, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+}
+
+static TestAllocation allocateImage(VKRT* vkrt, VkDeviceSize size, VkDeviceSize alignment) {
+    gMockDevice.nextRequirements = (VkMemoryRequirements){size, alignment, 1u << MOCK_TYPE_DEVICE_LOCAL};
+    MemoryAllocation handle = VK_NULL_HANDLE;
+    VkImage image = (VkImage)(uintptr_t)0x20;
+    if (vkrtAllocateImageMemory(vkrt, image, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &handle) != VKRT_SUCCESS) {
+        return (TestAllocation){0};
+    }
+    return recordBinding(handle, size);
+}
+
+static void freeAllocation(VKRT* vkrt, TestAllocation* allocation) {
+    vkrtFreeMemory(vkrt, &allocation->handle);
+    *allocation = (TestAllocation){0};
+}
+
+static int allocationsOverlap(const TestAllocation* lhs, const TestAllocation* rhs) {
+    if (lhs->memory != rhs->memory) return 0;
+    return lhs->offset < rhs->offset + rhs->size && rhs->offset < lhs->offset + lhs->size;
+}
+
+static void testMemoryTypeSelection(void) {
+    VKRT* vkrt = createMockRuntime();
+    TEST_CHECK(vkrt != NULL);
+    if (!vkrt) return;
+
+    // The first type in the filter that carries every requested property wins.
+    TestAllocation hostVisible = allocateBuffer(vkrt, 256u, 16u, 0x7u, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+    TEST_CHECK(hostVisible.handle != VK_NULL_HANDLE);
+    if (hostVisible.handle) {
+        TEST_CHECK(hostVisible.memory->memoryTypeIndex == MOCK_TYPE_HOST_VISIBLE);
+        TEST_CHECK(vkrtMappedMemory(hostVisible.handle) == (uint8_t*)hostVisible.memory->mapped + hostVisible.offset);
+    }
+
+    TestAllocation filtered = allocateBuffer(vkrt, 256u, 16u, 0x6u, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    TEST_CHECK(filtered.handle != VK_NULL_HANDLE);
+    if (filtered.handle) TEST_CHECK(filtered.memory->memoryTypeIndex == MOCK_TYPE_SMALL_HEAP);
+
+    // No type in the filter is host cached, so the request fails without touching the device.
+    uint32_t allocateCalls = gMockDevice.allocateCallCount;
+    TestAllocation unsupported = allocateBuffer(vkrt, 256u, 16u, 0x7u, VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+    TEST_CHECK(unsupported.handle == VK_NULL_HANDLE);
+    TEST_CHECK(gMockDevice.allocateCallCount == allocateCalls);
+
+    // Device-local memory is never mapped.
+    TestAllocation deviceLocal = allocateDeviceBuffer(vkrt, 256u, 16u);
+    TEST_CHECK(deviceLocal.handle != VK_NULL_HANDLE);
+    TEST_CHECK(vkrtMappedMemory(deviceLocal.handle) == NULL);
+
+    freeAllocation(vkrt, &hostVisible);
+    freeAllocation(vkrt, &filtered);
+    freeAllocation(vkrt, &deviceLocal);
+    destroyMockRuntime(vkrt);
+    TEST_CHECK(gMockDevice.liveMemoryCount == 0u);
+}
+
+static void testBlockSizing(void) {
+    VKRT* vkrt = createMockRuntime();
+    TEST_CHECK(vkrt != NULL);
+    if (!vkrt) return;
+
+    // Heaps of 1 GiB or more get 64 MiB blocks; smaller heaps get an eighth of their size.
+    TEST_CHECK(vkrt->core.memoryAllocator.preferredBlockSizes[0] == kMockLargeBlockSize);
+    TEST_CHECK(vkrt->core.memoryAllocator.preferredBlockSizes[2] == kMockSmallHeapSize / 8u);
+
+    TestAllocation small = allocateBuffer(vkrt, 4096u, 256u, 1u << MOCK_TYPE_SMALL_HEAP, 0u);
+    TEST_CHECK(small.handle != VK_NULL_HANDLE);
+    if (small.handle) TEST_CHECK(small.memory->size == kMockSmallHeapSize / 8u);
+
+    freeAllocation(vkrt, &small);
+    destroyMockRuntime(vkrt);
+    TEST_CHECK(gMockDevice.liveMemoryCount == 0u);
+}
+
+static void testSubAllocationAndCoalescing(void) {
+    enum { K_BUFFER_COUNT = 64 };
+    VKRT* vkrt = createMockRuntime();
+    TEST_CHECK(vkrt != NULL);
+    if (!vkrt) return;
+
+    uint32_t allocateCalls = gMockDevice.allocateCallCount;
+    TestAllocation buffers[K_BUFFER_COUNT] = {0};
+    for (uint32_t i = 0; i < K_BUFFER_COUNT; i++) {
+        VkDeviceSize alignment = (VkDeviceSize)1u << (4u + i % 5u);
+        buffers[i] = allocateDeviceBuffer(vkrt, 1000u + (VkDeviceSize)i * 37u, alignment);
+        TEST_CHECK(buffers[i].handle != VK_NULL_HANDLE);
+        TEST_CHECK(buffers[i].offset % alignment == 0u);
+    }
+
+    // Every buffer fits one block: a single device allocation backs all of them without overlap.
+    TEST_CHECK(gMockDevice.allocateCallCount == allocateCalls + 1u);
+    for (uint32_t i = 0; i < K_BUFFER_COUNT; i++) {
+        for (uint32_t j = i + 1u; j < K_BUFFER_COUNT; j++) {
+            TEST_CHECK(!allocationsOverlap(&buffers[i], &buffers[j]));
+        }
+    }
+
+    VKRT_MemorySnapshot snapshot = {0};
+    vkrtQueryMemoryStats(vkrt, &snapshot);
+    TEST_CHECK(snapshot.heapCount == 3u);
+    TEST_CHECK(snapshot.blockCount == 1u);
+    TEST_CHECK(snapshot.allocationCount == K_BUFFER_COUNT);
+    TEST_CHECK(snapshot.heaps[0].reservedBytes == kMockLargeBlockSize);
+    TEST_CHECK(snapshot.heaps[0].deviceLocal == 1u);
+
+    // Freeing every other buffer leaves holes, so the free list is fragmented.
+    VkDeviceSize lastOffset = buffers[K_BUFFER_COUNT - 1].offset;
+    for (uint32_t i = 0; i < K_BUFFER_COUNT; i += 2u) freeAllocation(vkrt, &buffers[i]);
+    vkrtQueryMemoryStats(vkrt, &snapshot);
+    TEST_CHECK(snapshot.allocationCount == K_BUFFER_COUNT / 2u);
+    TEST_CHECK(snapshot.fragmentation > 0.0f);
+
+    // A hole left behind is reused before the untouched tail of the block.
+    TestAllocation refill = allocateDeviceBuffer(vkrt, 1000u, 16u);
+    TEST_CHECK(refill.handle != VK_NULL_HANDLE);
+    TEST_CHECK(refill.offset < lastOffset);
+    freeAllocation(vkrt, &refill);
+
+    // Releasing the rest merges every range back into one span covering the whole block.
+    for (uint32_t i = 1u; i < K_BUFFER_COUNT; i += 2u) freeAllocation(vkrt, &buffers[i]);
+    vkrtQueryMemoryStats(vkrt, &snapshot);
+    TEST_CHECK(snapshot.allocationCount == 0u);
+    TEST_CHECK(snapshot.usedBytes == 0u);
+    TEST_CHECK(snapshot.fragmentation == 0.0f);
+
+    TestAllocation half = allocateDeviceBuffer(vkrt, kMockLargeBlockSize / 2u, 256u);
+    TestAllocation otherHalf = allocateDeviceBuffer(vkrt, kMockLargeBlockSize / 2u, 256u);
+    TEST_CHECK(half.handle && otherHalf.handle);
+    TEST_CHECK(half.offset == 0u && otherHalf.offset == kMockLargeBlockSize / 2u);
+    TEST_CHECK(half.memory == otherHalf.memory);
+    TEST_CHECK(gMockDevice.allocateCallCount == allocateCalls + 1u);
+    freeAllocation(vkrt, &half);
+    freeAllocation(vkrt, &otherHalf);
+
+    destroyMockRuntime(vkrt);
+    TEST_CHECK(gMockDevice.liveMemoryCount == 0u);
+}
+
+static void testBlockGrowthAndRelease(void) {
+    VKRT* vkrt = createMockRuntime();
+    TEST_CHECK(vkrt != NULL);
+    if (!vkrt) return;
+
+    // Three allocations of 40% of a block cannot share one, so the third spills into a new block.
+    VkDeviceSize size = kMockLargeBlockSize / 5u * 2u;
+    TestAllocation first = allocateDeviceBuffer(vkrt, size, 256u);
+    TestAllocation second = allocateDeviceBuffer(vkrt, size, 256u);
+    TestAllocation third = allocateDeviceBuffer(vkrt, size, 256u);
+    TEST_CHECK(first.handle && second.handle && third.handle);
+    TEST_CHECK(first.memory == second.memory);
+    TEST_CHECK(third.memory != first.memory);
+
+    VKRT_MemorySnapshot snapshot = {0};
+    vkrtQueryMemoryStats(vkrt, &snapshot);
+    TEST_CHECK(snapshot.blockCount == 2u);
+
+    // An emptied block is returned to the device unless it is the pool's last one.
+    freeAllocation(vkrt, &third);
+    vkrtQueryMemoryStats(vkrt, &snapshot);
+    TEST_CHECK(snapshot.blockCount == 1u);
+    freeAllocation(vkrt, &first);
+    freeAllocation(vkrt, &second);
+    vkrtQueryMemoryStats(vkrt, &snapshot);
+    TEST_CHECK(snapshot.blockCount == 1u);
+    TEST_CHECK(gMockDevice.liveMemoryCount == 1u);
+
+    destroyMockRuntime(vkrt);
+    TEST_CHECK(gMockDevice.liveMemoryCount == 0u);
+}
+
+static void testDedicatedAndImagePools(void) {
+    VKRT* vkrt = createMockRuntime();
+    TEST_CHECK(vkrt != NULL);
+    if (!vkrt) return;
+
+    // Requests above half a block bypass the pools.
+    VkDeviceSize largeSize = kMockLargeBlockSize / 2u + 4096u;
+    TestAllocation dedicated = allocateDeviceBuffer(vkrt, largeSize, 256u);
+    TEST_CHECK(dedicated.handle != VK_NULL_HANDLE);
+    if (dedicated.handle) TEST_CHECK(dedicated.offset == 0u && dedicated.memory->size == largeSize);
+
+    VKRT_MemorySnapshot snapshot = {0};
+    vkrtQueryMemoryStats(vkrt, &snapshot);
+    TEST_CHECK(snapshot.dedicatedAllocationCount == 1u);
+    TEST_CHECK(snapshot.blockCount == 0u);
+    TEST_CHECK(snapshot.heaps[0].usedBytes == largeSize);
+
+    // Buffers and images of the same memory type never share a block.
+    TestAllocation buffer = allocateDeviceBuffer(vkrt, 4096u, 256u);
+    TestAllocation image = allocateImage(vkrt, 4096u, 4096u);
+    TEST_CHECK(buffer.handle && image.handle);
+    TEST_CHECK(buffer.memory != image.memory);
+    vkrtQueryMemoryStats(vkrt, &snapshot);
+    TEST_CHECK(snapshot.blockCount == 2u);
+
+    freeAllocation(vkrt, &dedicated);
+    freeAllocation(vkrt, &buffer);
+    freeAllocation(vkrt, &image);
+    vkrtQueryMemoryStats(vkrt, &snapshot);
+    TEST_CHECK(snapshot.dedicatedAllocationCount == 0u);
+    TEST_CHECK(snapshot.usedBytes == 0u);
+
+    destroyMockRuntime(vkrt);
+    TEST_CHECK(gMockDevice.liveMemoryCount == 0u);
+}
+
+int main(void) {
+    testMemoryTypeSelection();
+    testBlockSizing();
+    testSubAllocationAndCoalescing();
+    testBlockGrowthAndRelease();
+    testDedicatedAndImagePools();
+    return testExitCode("allocator");
+}
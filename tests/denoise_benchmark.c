@@ -0,0 +1,296 @@
+#include "denoise.h"
+#include "platform.h"
+#include "test.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Times repeated 1080p viewport denoises the way the export worker runs them: albedo and normal prefilters followed
+// by the beauty filter. The cold pass builds a new OIDN context for every job. That is a lower bound on the old cost,
+// when each of the three calls created its own device and filter. The cached pass reuses one context across all jobs.
+// A final pass denoises an export-sized frame above the tiling threshold both tiled and untiled and compares them.
+// `meson test --benchmark` runs it.
+
+enum {
+    BENCHMARK_WIDTH = 1920,
+    BENCHMARK_HEIGHT = 1080,
+    BENCHMARK_JOB_COUNT = 8,
+    TILED_WIDTH = 4160,
+    TILED_HEIGHT = 4096,
+    TILED_INNER_STEP = 2048,
+};
+
+typedef struct DenoiseImages {
+    float* color;
+    float* albedo;
+    float* normal;
+    float* albedoPrefiltered;
+    float* normalPrefiltered;
+    float* output;
+} DenoiseImages;
+
+static float nextNoise(uint32_t* state) {
+    *state = (*state * 1664525u) + 1013904223u;
+    return (float)(*state >> 8) * (1.0f / 16777216.0f);
+}
+
+// A lit checkerboard on a bumpy surface with heavy per-pixel noise, roughly what a few-spp viewport frame looks like.
+static void fillDenoiseImages(DenoiseImages* images) {
+    uint32_t noise = 0x2545f491u;
+    for (uint32_t y = 0; y < BENCHMARK_HEIGHT; y++) {
+        for (uint32_t x = 0; x < BENCHMARK_WIDTH; x++) {
+            size_t pixel = (((size_t)y * BENCHMARK_WIDTH) + x) * 4u;
+            float checker = (((x / 64u) + (y / 64u)) & 1u) ? 0.8f : 0.2f;
+            float bumpX = 0.3f * sinf((float)x * 0.05f);
+            float bumpY = 0.3f * cosf((float)y * 0.05f);
+            float shading = 0.25f + (0.75f * (float)y / (float)BENCHMARK_HEIGHT);
+            for (uint32_t c = 0; c < 3u; c++) {
+                float albedo = checker * (c == 0u ? 1.0f : 0.85f);
+                images->albedo[pixel + c] = albedo;
+                images->color[pixel + c] = albedo * shading * nextNoise(&noise) * 2.0f;
+            }
+            float length = sqrtf((bumpX * bumpX) + (bumpY * bumpY) + 1.0f);
+            images->normal[pixel + 0u] = bumpX / length;
+            images->normal[pixel + 1u] = bumpY / length;
+            images->normal[pixel + 2u] = 1.0f / length;
+            images->color[pixel + 3u] = 1.0f;
+            images->albedo[pixel + 3u] = 1.0f;
+            images->normal[pixel + 3u] = 0.0f;
+        }
+    }
+}
+
+static int createDenoiseImages(DenoiseImages* outImages) {
+    size_t floatCount = (size_t)BENCHMARK_WIDTH * BENCHMARK_HEIGHT * 4u;
+    *outImages = (DenoiseImages){
+        .color = (float*)malloc(floatCount * sizeof(float)),
+        .albedo = (float*)malloc(floatCount * sizeof(float)),
+        .normal = (float*)malloc(floatCount * sizeof(float)),
+        .albedoPrefiltered = (float*)malloc(floatCount * sizeof(float)),
+        .normalPrefiltered = (float*)malloc(floatCount * sizeof(float)),
+        .output = (float*)malloc(floatCount * sizeof(float)),
+    };
+    if (!outImages->color || !outImages->albedo || !outImages->normal || !outImages->albedoPrefiltered ||
+        !outImages->normalPrefiltered || !outImages->output) {
+        return 0;
+    }
+    fillDenoiseImages(outImages);
+    return 1;
+}
+
+static void destroyDenoiseImages(DenoiseImages* images) {
+    free(images->color);
+    free(images->albedo);
+    free(images->normal);
+    free(images->albedoPrefiltered);
+    free(images->normalPrefiltered);
+    free(images->output);
+    *images = (DenoiseImages){0};
+}
+
+static int runDenoiseJob(VKRT_OIDNContext* context, DenoiseImages* images) {
+    const char* errorMessage = NULL;
+    int succeeded = vkrtOIDNPrefilterAux(
+                        context,
+                        VKRT_OIDN_AUX_IMAGE_ALBEDO,
+                        images->albedo,
+                        BENCHMARK_WIDTH,
+                        BENCHMARK_HEIGHT,
+                        images->albedoPrefiltered,
+                        &errorMessage
+                    ) &&
+                    vkrtOIDNPrefilterAux(
+                        context,
+                        VKRT_OIDN_AUX_IMAGE_NORMAL,
+                        images->normal,
+                        BENCHMARK_WIDTH,
+                        BENCHMARK_HEIGHT,
+                        images->normalPrefiltered,
+                        &errorMessage
+                    );
+    if (succeeded) {
+        VKRT_OIDNFilterInput input = {
+            .color = images->color,
+            .albedo = images->albedoPrefiltered,
+            .normal = images->normalPrefiltered,
+            .width = BENCHMARK_WIDTH,
+            .height = BENCHMARK_HEIGHT,
+            .cleanAux = 1u,
+        };
+        succeeded = vkrtOIDNDenoise(context, &input, images->output, &errorMessage);
+    }
+    if (!succeeded) fprintf(stderr, "denoise job failed: %s\n", errorMessage ? errorMessage : "(no message)");
+    return succeeded;
+}
+
+static double measureColdJobs(DenoiseImages* images) {
+    uint64_t start = getMicroseconds();
+    for (uint32_t job = 0; job < BENCHMARK_JOB_COUNT; job++) {
+        VKRT_OIDNContext* context = vkrtOIDNCreateContext();
+        TEST_CHECK(context != NULL);
+        if (!context) return 0.0;
+        TEST_CHECK(runDenoiseJob(context, images));
+        vkrtOIDNDestroyContext(context);
+    }
+    return (double)(getMicroseconds() - start) / (1000.0 * BENCHMARK_JOB_COUNT);
+}
+
+static double measureCachedJobs(DenoiseImages* images, double* outFirstJobMilliseconds) {
+    VKRT_OIDNContext* context = vkrtOIDNCreateContext();
+    TEST_CHECK(context != NULL);
+    if (!context) return 0.0;
+
+    uint64_t start = getMicroseconds();
+    TEST_CHECK(runDenoiseJob(context, images));
+    *outFirstJobMilliseconds = (double)(getMicroseconds() - start) / 1000.0;
+
+    start = getMicroseconds();
+    for (uint32_t job = 0; job < BENCHMARK_JOB_COUNT; job++) TEST_CHECK(runDenoiseJob(context, images));
+    double milliseconds = (double)(getMicroseconds() - start) / (1000.0 * BENCHMARK_JOB_COUNT);
+
+    vkrtOIDNDestroyContext(context);
+    return milliseconds;
+}
+
+// The denoised frame should be finite and much smoother than its input.
+static void checkDenoisedOutput(const DenoiseImages* images) {
+    double inputVariation = 0.0;
+    double outputVariation = 0.0;
+    uint32_t nonFinite = 0;
+    for (size_t pixel = 1; pixel < (size_t)BENCHMARK_WIDTH * BENCHMARK_HEIGHT; pixel++) {
+        float value = images->output[pixel * 4u];
+        if (!isfinite(value)) nonFinite++;
+        inputVariation += fabs((double)images->color[pixel * 4u] - (double)images->color[(pixel - 1u) * 4u]);
+        outputVariation += fabs((double)value - (double)images->output[(pixel - 1u) * 4u]);
+    }
+    TEST_CHECK(nonFinite == 0u);
+    TEST_CHECK(outputVariation < inputVariation * 0.5);
+}
+
+// Exposure sweeps 8 stops from left to right, so tiles exposed on their own would each pick a different scale.
+static void fillTiledColor(float* color) {
+    uint32_t noise = 0x68e31da4u;
+    for (uint32_t y = 0; y < TILED_HEIGHT; y++) {
+        for (uint32_t x = 0; x < TILED_WIDTH; x++) {
+            size_t pixel = (((size_t)y * TILED_WIDTH) + x) * 4u;
+            float exposure = exp2f(-4.0f + (8.0f * (float)x / (float)TILED_WIDTH));
+            float checker = (((x / 64u) + (y / 64u)) & 1u) ? 0.8f : 0.2f;
+            for (uint32_t c = 0; c < 3u; c++) color[pixel + c] = exposure * checker * nextNoise(&noise) * 2.0f;
+            color[pixel + 3u] = 1.0f;
+        }
+    }
+}
+
+// Sum of first-channel steps across the tiled pass's inner tile boundaries.
+static double measureTileSeams(const float* image) {
+    double step = 0.0;
+    for (uint32_t y = 0; y < TILED_HEIGHT; y++) {
+        for (uint32_t x = TILED_INNER_STEP; x < TILED_WIDTH; x += TILED_INNER_STEP) {
+            size_t pixel = ((size_t)y * TILED_WIDTH) + x;
+            step += fabs((double)image[pixel * 4u] - (double)image[(pixel - 1u) * 4u]);
+        }
+    }
+    for (uint32_t y = TILED_INNER_STEP; y < TILED_HEIGHT; y += TILED_INNER_STEP) {
+        for (uint32_t x = 0; x < TILED_WIDTH; x++) {
+            size_t pixel = ((size_t)y * TILED_WIDTH) + x;
+            step += fabs((double)image[pixel * 4u] - (double)image[(pixel - TILED_WIDTH) * 4u]);
+        }
+    }
+    return step;
+}
+
+static double measureDenoise(VKRT_OIDNContext* context, const VKRT_OIDNFilterInput* input, float* output) {
+    const char* errorMessage = NULL;
+    uint64_t start = getMicroseconds();
+    int succeeded = vkrtOIDNDenoise(context, input, output, &errorMessage);
+    if (!succeeded) fprintf(stderr, "denoise failed: %s\n", errorMessage ? errorMessage : "(no message)");
+    TEST_CHECK(succeeded);
+    return (double)(getMicroseconds() - start) / 1000.0;
+}
+
+// Tiles share one exposure, so the tiled frame should match the untiled one and show no extra steps at tile edges.
+static void checkTiledDenoise(void) {
+    size_t floatCount = (size_t)TILED_WIDTH * TILED_HEIGHT * 4u;
+    float* color = (float*)malloc(floatCount * sizeof(float));
+    float* tiled = (float*)malloc(floatCount * sizeof(float));
+    float* untiled = (float*)malloc(floatCount * sizeof(float));
+    VKRT_OIDNContext* context = vkrtOIDNCreateContext();
+    TEST_CHECK(color && tiled && untiled && context);
+    if (!color || !tiled || !untiled || !context) goto cleanup;
+
+    fillTiledColor(color);
+    VKRT_OIDNFilterInput input = {
+        .color = color,
+        .width = TILED_WIDTH,
+        .height = TILED_HEIGHT,
+    };
+    double tiledMilliseconds = measureDenoise(context, &input, tiled);
+    vkrtOIDNSetTiledPixelThreshold(context, UINT64_MAX);
+    double untiledMilliseconds = measureDenoise(context, &input, untiled);
+
+    double difference = 0.0;
+    double magnitude = 0.0;
+    for (size_t i = 0; i < floatCount; i += 4u) {
+        difference += fabs((double)tiled[i] - (double)untiled[i]);
+        magnitude += fabs((double)untiled[i]);
+    }
+    double relativeDifference = magnitude > 0.0 ? difference / magnitude : 0.0;
+    double untiledSeams = measureTileSeams(untiled);
+    double seamRatio = untiledSeams > 0.0 ? measureTileSeams(tiled) / untiledSeams : 0.0;
+    TEST_CHECK(relativeDifference < 0.01);
+    TEST_CHECK(seamRatio < 1.1);
+
+    printf(
+        "denoise: %ux%u: tiled %.1f ms, untiled %.1f ms, mean difference %.3f%%, seam step ratio %.3f\n",
+        (unsigned)TILED_WIDTH,
+        (unsigned)TILED_HEIGHT,
+        tiledMilliseconds,
+        untiledMilliseconds,
+        relativeDifference * 100.0,
+        seamRatio
+    );
+
+cleanup:
+    vkrtOIDNDestroyContext(context);
+    free(color);
+    free(tiled);
+    free(untiled);
+}
+
+int main(void) {
+    DenoiseImages images = {0};
+    int created = createDenoiseImages(&images);
+    TEST_CHECK(created);
+    if (!created) {
+        destroyDenoiseImages(&images);
+        return testExitCode("denoise");
+    }
+
+    // Loading the OIDN library and its weights happens once per process, so keep it out of both passes.
+    VKRT_OIDNContext* warmup = vkrtOIDNCreateContext();
+    TEST_CHECK(warmup != NULL && runDenoiseJob(warmup, &images));
+    vkrtOIDNDestroyContext(warmup);
+
+    double firstJobMilliseconds = 0.0;
+    double coldMilliseconds = measureColdJobs(&images);
+    double cachedMilliseconds = measureCachedJobs(&images, &firstJobMilliseconds);
+    checkDenoisedOutput(&images);
+
+    printf(
+        "denoise: %ux%u, %u jobs: new context per job %.1f ms/job, cached context %.1f ms/job (first job %.1f ms), "
+        "%.2fx\n",
+        (unsigned)BENCHMARK_WIDTH,
+        (unsigned)BENCHMARK_HEIGHT,
+        (unsigned)BENCHMARK_JOB_COUNT,
+        coldMilliseconds,
+        cachedMilliseconds,
+        firstJobMilliseconds,
+        cachedMilliseconds > 0.0 ? coldMilliseconds / cachedMilliseconds : 0.0
+    );
+
+    destroyDenoiseImages(&images);
+    checkTiledDenoise();
+    return testExitCode("denoise");
+}
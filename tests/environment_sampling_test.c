@@ -0,0 +1,226 @@
+#include "alias_table.h"
+#include "environment_distribution.h"
+#include "formats.h"
+#include "image.h"
+#include "test.h"
+#include "vkrt_internal.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+// CPU reference for the lat-long environment sampler. The pdf and the alias lookups mirror light/environment.slang and
+// sampling/discrete.slang with the environment rotation at zero.
+
+enum {
+    TEST_IMAGE_WIDTH = 64,
+    TEST_IMAGE_HEIGHT = 32,
+    TEST_SAMPLE_COUNT = 1 << 20,
+};
+
+static const double kTestPi = 3.14159265358979323846;
+
+typedef struct TestRandom {
+    uint64_t state;
+} TestRandom;
+
+static float nextRandom(TestRandom* random) {
+    random->state = (random->state * 6364136223846793005ull) + 1442695040888963407ull;
+    return (float)(random->state >> 40) * (1.0f / 16777216.0f);
+}
+
+static void fillTestEnvironment(float* pixels, uint32_t width, uint32_t height, int constantRadiance) {
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            float* pixel = &pixels[(((size_t)y * width) + x) * 4u];
+            float radiance = 1.0f;
+            if (!constantRadiance) {
+                // Sky gradient with a small bright sun and a black band, so some cells have zero weight.
+                radiance = 0.2f + (0.8f * (float)y / (float)height);
+                if (x >= 40u && x < 43u && y >= 6u && y < 8u) radiance = 500.0f;
+                if (y >= 24u && y < 26u) radiance = 0.0f;
+            }
+            pixel[0] = radiance;
+            pixel[1] = radiance * 0.9f;
+            pixel[2] = radiance * 0.8f;
+            pixel[3] = 1.0f;
+        }
+    }
+}
+
+static int buildTestDistribution(const float* pixels, EnvironmentDistribution* outDistribution) {
+    VKRT_LoadedImage image = {
+        .pixels = (void*)pixels,
+        .width = TEST_IMAGE_WIDTH,
+        .height = TEST_IMAGE_HEIGHT,
+        .format = VKRT_TEXTURE_FORMAT_RGBA32_SFLOAT,
+        .colorSpace = VKRT_TEXTURE_COLOR_SPACE_LINEAR,
+        .mipLevelCount = 1u,
+    };
+    return vkrtBuildEnvironmentDistribution(&image, outDistribution) == VKRT_SUCCESS;
+}
+
+static uint32_t sampleAlias(float u, uint32_t count, uint32_t offset, const float* aliasQ, const uint32_t* aliasIdx) {
+    float scaled = u * (float)count;
+    uint32_t i = (uint32_t)scaled < count - 1u ? (uint32_t)scaled : count - 1u;
+    float remainder = scaled - (float)i;
+    return remainder < aliasQ[offset + i] ? i : aliasIdx[offset + i];
+}
+
+static double environmentPdf(const EnvironmentDistribution* distribution, double theta, double phi) {
+    uint32_t width = distribution->width;
+    uint32_t height = distribution->height;
+    double u = (phi / (2.0 * kTestPi)) + 0.5;
+    double v = theta / kTestPi;
+    uint32_t column = (uint32_t)(u * width) < width - 1u ? (uint32_t)(u * width) : width - 1u;
+    uint32_t row = (uint32_t)(v * height) < height - 1u ? (uint32_t)(v * height) : height - 1u;
+    double sinTheta = sin(theta);
+    if (sinTheta <= 0.0) return 0.0;
+
+    double pdfUV = (double)distribution->pmf[row] * (double)distribution->pmf[height + (row * width) + column];
+    return pdfUV * (double)width * (double)height / (2.0 * kTestPi * kTestPi * sinTheta);
+}
+
+// Alias tables are exact: bin i keeps aliasQ[i] of its 1/count slot and donates the rest to aliasIdx[i].
+static void checkAliasTableMatchesPmf(const float* pmf, const float* aliasQ, const uint32_t* aliasIdx, uint32_t count) {
+    double* implied = (double*)calloc(count, sizeof(double));
+    TEST_CHECK(implied != NULL);
+    if (!implied) return;
+
+    for (uint32_t i = 0; i < count; i++) {
+        TEST_CHECK(aliasQ[i] >= 0.0f && aliasQ[i] <= 1.0f);
+        TEST_CHECK(aliasIdx[i] < count);
+        implied[i] += (double)aliasQ[i] / count;
+        implied[aliasIdx[i]] += (1.0 - (double)aliasQ[i]) / count;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        TEST_CHECK_NEAR(implied[i], pmf[i], 1e-5);
+    }
+    free(implied);
+}
+
+static void testAliasTable(void) {
+    const float pmf[] = {0.5f, 0.0f, 0.125f, 0.25f, 0.0625f, 0.0625f};
+    const uint32_t count = (uint32_t)(sizeof(pmf) / sizeof(pmf[0]));
+    float aliasQ[sizeof(pmf) / sizeof(pmf[0])];
+    uint32_t aliasIdx[sizeof(pmf) / sizeof(pmf[0])];
+    TEST_CHECK(vkrtBuildAliasTable(pmf, count, aliasQ, aliasIdx));
+    checkAliasTableMatchesPmf(pmf, aliasQ, aliasIdx, count);
+}
+
+static void testDistributionTables(const EnvironmentDistribution* distribution) {
+    uint32_t width = distribution->width;
+    uint32_t height = distribution->height;
+    double rowSum = 0.0;
+    for (uint32_t row = 0; row < height; row++) rowSum += distribution->pmf[row];
+    TEST_CHECK_NEAR(rowSum, 1.0, 1e-5);
+    checkAliasTableMatchesPmf(distribution->pmf, distribution->aliasQ, distribution->aliasIdx, height);
+
+    for (uint32_t row = 0; row < height; row++) {
+        size_t offset = height + ((size_t)row * width);
+        double columnSum = 0.0;
+        for (uint32_t column = 0; column < width; column++) columnSum += distribution->pmf[offset + column];
+        TEST_CHECK_NEAR(columnSum, 1.0, 1e-5);
+        checkAliasTableMatchesPmf(
+            &distribution->pmf[offset],
+            &distribution->aliasQ[offset],
+            &distribution->aliasIdx[offset],
+            width
+        );
+    }
+
+    // The zero-radiance band must never be picked.
+    TEST_CHECK(distribution->pmf[24] == 0.0f);
+    TEST_CHECK(distribution->pmf[25] == 0.0f);
+}
+
+// Midpoint quadrature of pdf * sin(theta) dtheta dphi on a grid much finer than the distribution.
+static void testPdfIntegratesToOne(const EnvironmentDistribution* distribution) {
+    const uint32_t thetaSteps = 4096u;
+    const uint32_t phiSteps = 1024u;
+    double dTheta = kTestPi / thetaSteps;
+    double dPhi = 2.0 * kTestPi / phiSteps;
+    double integral = 0.0;
+    for (uint32_t i = 0; i < thetaSteps; i++) {
+        double theta = (i + 0.5) * dTheta;
+        double sinTheta = sin(theta);
+        for (uint32_t j = 0; j < phiSteps; j++) {
+            double phi = -kTestPi + ((j + 0.5) * dPhi);
+            integral += environmentPdf(distribution, theta, phi) * sinTheta * dTheta * dPhi;
+        }
+    }
+    TEST_CHECK_NEAR(integral, 1.0, 1e-3);
+}
+
+// Draws directions the way sampleEnvironmentLight does and compares cell frequencies with the pmf product.
+static void testSampledCellFrequencies(const EnvironmentDistribution* distribution) {
+    uint32_t width = distribution->width;
+    uint32_t height = distribution->height;
+    uint32_t* counts = (uint32_t*)calloc((size_t)width * height, sizeof(uint32_t));
+    TEST_CHECK(counts != NULL);
+    if (!counts) return;
+
+    TestRandom random = {0x9e3779b97f4a7c15ull};
+    for (uint32_t sample = 0; sample < TEST_SAMPLE_COUNT; sample++) {
+        uint32_t row = sampleAlias(nextRandom(&random), height, 0u, distribution->aliasQ, distribution->aliasIdx);
+        uint32_t column = sampleAlias(
+            nextRandom(&random),
+            width,
+            height + (row * width),
+            distribution->aliasQ,
+            distribution->aliasIdx
+        );
+        counts[((size_t)row * width) + column]++;
+    }
+
+    for (uint32_t row = 0; row < height; row++) {
+        for (uint32_t column = 0; column < width; column++) {
+            double expected =
+                (double)distribution->pmf[row] * (double)distribution->pmf[height + (row * width) + column];
+            double observed = (double)counts[((size_t)row * width) + column] / TEST_SAMPLE_COUNT;
+            // Five binomial standard deviations, plus a floor for cells that are almost never drawn.
+            double tolerance = (5.0 * sqrt(expected * (1.0 - expected) / TEST_SAMPLE_COUNT)) + 1e-6;
+            TEST_CHECK_NEAR(observed, expected, tolerance);
+        }
+    }
+    free(counts);
+}
+
+static void testIntegratedLuminance(void) {
+    float* pixels = (float*)malloc(sizeof(float) * 4u * TEST_IMAGE_WIDTH * TEST_IMAGE_HEIGHT);
+    TEST_CHECK(pixels != NULL);
+    if (!pixels) return;
+    fillTestEnvironment(pixels, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT, 1);
+
+    EnvironmentDistribution distribution = {0};
+    TEST_CHECK(buildTestDistribution(pixels, &distribution));
+    float luminance = (0.2126f * 1.0f) + (0.7152f * 0.9f) + (0.0722f * 0.8f);
+    TEST_CHECK_NEAR(distribution.integratedLuminance, 4.0 * kTestPi * luminance, 4e-3 * 4.0 * kTestPi);
+
+    vkrtReleaseEnvironmentDistribution(&distribution);
+    free(pixels);
+}
+
+int main(void) {
+    testAliasTable();
+    testIntegratedLuminance();
+
+    float* pixels = (float*)malloc(sizeof(float) * 4u * TEST_IMAGE_WIDTH * TEST_IMAGE_HEIGHT);
+    TEST_CHECK(pixels != NULL);
+    if (!pixels) return testExitCode("environment_sampling");
+    fillTestEnvironment(pixels, TEST_IMAGE_WIDTH, TEST_IMAGE_HEIGHT, 0);
+
+    EnvironmentDistribution distribution = {0};
+    TEST_CHECK(buildTestDistribution(pixels, &distribution));
+    if (distribution.pmf) {
+        TEST_CHECK(distribution.width == TEST_IMAGE_WIDTH);
+        TEST_CHECK(distribution.height == TEST_IMAGE_HEIGHT);
+        testDistributionTables(&distribution);
+        testPdfIntegratesToOne(&distribution);
+        testSampledCellFrequencies(&distribution);
+    }
+
+    vkrtReleaseEnvironmentDistribution(&distribution);
+    free(pixels);
+    return testExitCode("environment_sampling");
+}
@@ -0,0 +1,249 @@
+#include "constants.h"
+#include "geometry.h"
+#include "geometry_dedup.h"
+#include "geometry_heap.h"
+#include "mock_gpu.h"
+#include "rebuild.h"
+#include "state.h"
+#include "test.h"
+#include "types.h"
+#include "vkrt_internal.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+// Covers the geometry heap range allocator on its own, then drives the real mesh add/remove/upload path in
+// geometry.c against stubbed buffer, staging and acceleration-structure entry points to check that a scene edit
+// stages only the geometry it introduced.
+
+static void testAllocateAndFree(void) {
+    GeometryRangeAllocator allocator = {0};
+    TEST_CHECK(vkrtGeometryRangeReset(&allocator, 100u, 0u) == VKRT_SUCCESS);
+
+    uint32_t first = VKRT_INVALID_INDEX;
+    uint32_t second = VKRT_INVALID_INDEX;
+    TEST_CHECK(vkrtGeometryRangeAllocate(&allocator, 30u, &first));
+    TEST_CHECK(vkrtGeometryRangeAllocate(&allocator, 20u, &second));
+    TEST_CHECK(first == 0u);
+    TEST_CHECK(second == 30u);
+    TEST_CHECK(allocator.usedCount == 50u);
+
+    uint32_t tooLarge = VKRT_INVALID_INDEX;
+    TEST_CHECK(!vkrtGeometryRangeAllocate(&allocator, 51u, &tooLarge));
+    TEST_CHECK(!vkrtGeometryRangeAllocate(&allocator, 0u, &tooLarge));
+
+    // First fit reuses the hole at the front before touching the tail.
+    TEST_CHECK(vkrtGeometryRangeFree(&allocator, first, 30u) == VKRT_SUCCESS);
+    TEST_CHECK(allocator.freeRangeCount == 2u);
+    uint32_t reused = VKRT_INVALID_INDEX;
+    TEST_CHECK(vkrtGeometryRangeAllocate(&allocator, 10u, &reused));
+    TEST_CHECK(reused == 0u);
+    TEST_CHECK(allocator.usedCount == 30u);
+
+    TEST_CHECK(vkrtGeometryRangeFree(&allocator, 90u, 20u) == VKRT_ERROR_INVALID_ARGUMENT);
+    TEST_CHECK(vkrtGeometryRangeFree(&allocator, 0u, 0u) == VKRT_ERROR_INVALID_ARGUMENT);
+    vkrtGeometryRangeRelease(&allocator);
+}
+
+static void testFreeMergesNeighbours(void) {
+    GeometryRangeAllocator allocator = {0};
+    TEST_CHECK(vkrtGeometryRangeReset(&allocator, 100u, 0u) == VKRT_SUCCESS);
+
+    uint32_t offsets[4] = {0};
+    for (uint32_t i = 0; i < 4u; i++) TEST_CHECK(vkrtGeometryRangeAllocate(&allocator, 25u, &offsets[i]));
+    TEST_CHECK(allocator.freeRangeCount == 0u);
+
+    TEST_CHECK(vkrtGeometryRangeFree(&allocator, offsets[0], 25u) == VKRT_SUCCESS);
+    TEST_CHECK(vkrtGeometryRangeFree(&allocator, offsets[2], 25u) == VKRT_SUCCESS);
+    TEST_CHECK(allocator.freeRangeCount == 2u);
+
+    // Joins the previous range only, then the next range only, then both at once.
+    TEST_CHECK(vkrtGeometryRangeFree(&allocator, offsets[1], 10u) == VKRT_SUCCESS);
+    TEST_CHECK(allocator.freeRangeCount == 2u);
+    TEST_CHECK(allocator.freeRanges[0].offset == 0u && allocator.freeRanges[0].count == 35u);
+    TEST_CHECK(vkrtGeometryRangeFree(&allocator, offsets[1] + 20u, 5u) == VKRT_SUCCESS);
+    TEST_CHECK(allocator.freeRangeCount == 2u);
+    TEST_CHECK(allocator.freeRanges[1].offset == 45u && allocator.freeRanges[1].count == 30u);
+    TEST_CHECK(vkrtGeometryRangeFree(&allocator, offsets[1] + 10u, 10u) == VKRT_SUCCESS);
+    TEST_CHECK(allocator.freeRangeCount == 1u);
+
+    TEST_CHECK(vkrtGeometryRangeFree(&allocator, offsets[3], 25u) == VKRT_SUCCESS);
+    TEST_CHECK(allocator.freeRangeCount == 1u);
+    TEST_CHECK(allocator.freeRanges[0].offset == 0u && allocator.freeRanges[0].count == 100u);
+    TEST_CHECK(allocator.usedCount == 0u);
+    vkrtGeometryRangeRelease(&allocator);
+}
+
+static void testGrowth(void) {
+    GeometryRangeAllocator allocator = {0};
+    uint32_t target = vkrtGeometryRangeGrowthTarget(&allocator, 10u);
+    TEST_CHECK(target == 64u * 1024u);
+    TEST_CHECK(vkrtGeometryRangeGrow(&allocator, target) == VKRT_SUCCESS);
+    TEST_CHECK(allocator.freeRangeCount == 1u && allocator.freeRanges[0].count == target);
+
+    uint32_t whole = VKRT_INVALID_INDEX;
+    TEST_CHECK(vkrtGeometryRangeAllocate(&allocator, target, &whole));
+    TEST_CHECK(allocator.freeRangeCount == 0u);
+
+    // A full small heap grows by the minimum step, and the new space becomes a tail range.
+    uint32_t grown = vkrtGeometryRangeGrowthTarget(&allocator, 1u);
+    TEST_CHECK(grown == target + (64u * 1024u));
+    TEST_CHECK(vkrtGeometryRangeGrow(&allocator, grown) == VKRT_SUCCESS);
+    TEST_CHECK(allocator.freeRangeCount == 1u);
+    TEST_CHECK(allocator.freeRanges[0].offset == target && allocator.freeRanges[0].count == grown - target);
+
+    // A request larger than the geometric step sizes the heap to fit, counting the free tail it extends.
+    uint32_t required = vkrtGeometryRangeGrowthTarget(&allocator, 4u * grown);
+    TEST_CHECK(required == grown + (4u * grown) - (grown - target));
+    TEST_CHECK(vkrtGeometryRangeGrow(&allocator, required) == VKRT_SUCCESS);
+    TEST_CHECK(allocator.freeRangeCount == 1u);
+    uint32_t large = VKRT_INVALID_INDEX;
+    TEST_CHECK(vkrtGeometryRangeAllocate(&allocator, 4u * grown, &large));
+    TEST_CHECK(large == target);
+
+    // Once the heap is large, growth is geometric so repeated imports copy the heap a logarithmic number of times.
+    TEST_CHECK(allocator.freeRangeCount == 0u);
+    TEST_CHECK(vkrtGeometryRangeGrowthTarget(&allocator, 1u) == allocator.capacity + (allocator.capacity / 2u));
+
+    TEST_CHECK(vkrtGeometryRangeGrow(&allocator, target) == VKRT_ERROR_INVALID_ARGUMENT);
+    vkrtGeometryRangeRelease(&allocator);
+}
+
+typedef struct TestMesh {
+    Vertex* vertices;
+    uint32_t* indices;
+    VKRT_MeshUpload upload;
+} TestMesh;
+
+static int createTestMesh(uint32_t vertexCount, uint32_t triangleCount, float seed, TestMesh* outMesh) {
+    *outMesh = (TestMesh){0};
+    outMesh->vertices = (Vertex*)calloc(vertexCount, sizeof(Vertex));
+    outMesh->indices = (uint32_t*)malloc((size_t)triangleCount * 3u * sizeof(uint32_t));
+    if (!outMesh->vertices || !outMesh->indices) return 0;
+
+    for (uint32_t i = 0; i < vertexCount; i++) {
+        outMesh->vertices[i].position[0] = (float)i;
+        outMesh->vertices[i].position[1] = seed;
+        outMesh->vertices[i].normal[2] = 1.0f;
+    }
+    for (uint32_t i = 0; i < triangleCount * 3u; i++) outMesh->indices[i] = (i / 3u + (i % 3u)) % vertexCount;
+
+    outMesh->upload = (VKRT_MeshUpload){
+        .vertices = outMesh->vertices,
+        .vertexCount = vertexCount,
+        .indices = outMesh->indices,
+        .indexCount = (size_t)triangleCount * 3u,
+    };
+    return 1;
+}
+
+static void destroyTestMesh(TestMesh* mesh) {
+    free(mesh->vertices);
+    free(mesh->indices);
+    *mesh = (TestMesh){0};
+}
+
+static uint64_t expectedUploadBytes(const TestMesh* mesh) {
+    uint64_t vertexCount = mesh->upload.vertexCount;
+    uint64_t indexElements = vertexCount <= VKRT_MESH_UINT16_INDEX_VERTEX_LIMIT ? (mesh->upload.indexCount + 1u) / 2u
+                                                                                : mesh->upload.indexCount;
+    uint64_t vertexBytes = (VKRT_VERTEX_POSITION_COMPONENTS * sizeof(float)) + sizeof(ShaderVertex);
+    return (vertexCount * vertexBytes) + (indexElements * sizeof(uint32_t));
+}
+
+// Stages pending geometry the way a frame does and returns how much the scene's upload counter moved.
+static uint64_t stageFrameGeometry(VKRT* vkrt) {
+    uint64_t before = vkrt->core.geometryLayout.uploadedBytes;
+    uint64_t stagedBefore = gMockGpu.stagedBytes;
+    TEST_CHECK(vkrtScenePreparePendingGeometryUploads(vkrt) == VKRT_SUCCESS);
+    uint64_t uploaded = vkrt->core.geometryLayout.uploadedBytes - before;
+    TEST_CHECK(gMockGpu.stagedBytes - stagedBefore == uploaded);
+
+    for (uint32_t i = 0; i < vkrt->core.meshCount; i++) {
+        vkrt->core.meshes[i].geometryUploadPending = 0;
+        vkrt->core.meshes[i].blasBuildPending = 0;
+    }
+    vkrtCleanupPendingGeometryUploads(vkrt, vkrtCurrentFrameSceneUpdate(vkrt));
+    releaseMockStaging();
+    return uploaded;
+}
+
+static void testUploadBytesTrackEdits(void) {
+    VKRT* vkrt = (VKRT*)calloc(1u, sizeof(VKRT));
+    TEST_CHECK(vkrt != NULL);
+    if (!vkrt) return;
+
+    // The second mesh needs 32-bit indices and overflows the initial heap, forcing a grow.
+    TestMesh small = {0};
+    TestMesh large = {0};
+    TestMesh refill = {0};
+    int created = createTestMesh(1000u, 1999u, 0.0f, &small) && createTestMesh(70000u, 70000u, 1.0f, &large) &&
+                  createTestMesh(400u, 300u, 2.0f, &refill);
+    TEST_CHECK(created);
+    if (!created) goto cleanup;
+
+    TEST_CHECK(vkrtSceneUploadMeshData(vkrt, small.vertices, 1000u, small.indices, small.upload.indexCount) ==
+               VKRT_SUCCESS);
+    TEST_CHECK(vkrt->core.meshes[0].info.indexFormat == VKRT_MESH_INDEX_FORMAT_UINT16);
+    TEST_CHECK(stageFrameGeometry(vkrt) == expectedUploadBytes(&small));
+    TEST_CHECK(stageFrameGeometry(vkrt) == 0u);
+
+    uint64_t copiedBeforeGrowth = gMockGpu.copiedBytes;
+    uint32_t vertexCapacity = vkrt->core.geometryLayout.vertices.capacity;
+    TEST_CHECK(vkrtSceneUploadMeshDataBatch(vkrt, &large.upload, 1u) == VKRT_SUCCESS);
+    TEST_CHECK(vkrt->core.meshes[1].info.indexFormat == VKRT_MESH_INDEX_FORMAT_UINT32);
+    TEST_CHECK(vkrt->core.geometryLayout.vertices.capacity > vertexCapacity);
+    TEST_CHECK(gMockGpu.copiedBytes > copiedBeforeGrowth);
+    TEST_CHECK(vkrt->core.meshes[0].info.vertexBase == 0u);
+    TEST_CHECK(stageFrameGeometry(vkrt) == expectedUploadBytes(&large));
+
+    // An instance of existing geometry shares its ranges and uploads nothing.
+    TEST_CHECK(vkrtSceneUploadMeshDataBatch(vkrt, &small.upload, 1u) == VKRT_SUCCESS);
+    TEST_CHECK(vkrt->core.meshCount == 3u && !vkrt->core.meshes[2].ownsGeometry);
+    TEST_CHECK(stageFrameGeometry(vkrt) == 0u);
+
+    uint32_t usedVertices = vkrt->core.geometryLayout.vertices.usedCount;
+    TEST_CHECK(vkrtSceneRemoveMesh(vkrt, 1u) == VKRT_SUCCESS);
+    TEST_CHECK(vkrt->core.geometryLayout.vertices.usedCount == usedVertices - 70000u);
+    TEST_CHECK(stageFrameGeometry(vkrt) == 0u);
+
+    // Removing the owner hands its ranges to the remaining instance instead of freeing them.
+    usedVertices = vkrt->core.geometryLayout.vertices.usedCount;
+    TEST_CHECK(vkrtSceneRemoveMesh(vkrt, 0u) == VKRT_SUCCESS);
+    TEST_CHECK(vkrt->core.meshCount == 1u && vkrt->core.meshes[0].ownsGeometry);
+    TEST_CHECK(vkrt->core.geometryLayout.vertices.usedCount == usedVertices);
+    TEST_CHECK(stageFrameGeometry(vkrt) == 0u);
+
+    // New geometry lands in the hole the large mesh left and still stages only itself.
+    uint32_t heapCapacity = vkrt->core.geometryLayout.vertices.capacity;
+    TEST_CHECK(vkrtSceneUploadMeshDataBatch(vkrt, &refill.upload, 1u) == VKRT_SUCCESS);
+    TEST_CHECK(vkrt->core.meshes[1].info.vertexBase == 1000u);
+    TEST_CHECK(vkrt->core.geometryLayout.vertices.capacity == heapCapacity);
+    TEST_CHECK(stageFrameGeometry(vkrt) == expectedUploadBytes(&refill));
+
+    TEST_CHECK(vkrt->core.geometryLayout.uploadedBytes ==
+               expectedUploadBytes(&small) + expectedUploadBytes(&large) + expectedUploadBytes(&refill));
+
+    while (vkrt->core.meshCount > 0u) TEST_CHECK(vkrtSceneRemoveMesh(vkrt, vkrt->core.meshCount - 1u) == VKRT_SUCCESS);
+    TEST_CHECK(vkrt->core.geometryLayout.vertices.usedCount == 0u);
+    TEST_CHECK(vkrt->core.geometryLayout.indices.usedCount == 0u);
+
+cleanup:
+    vkrtGeometryRangeRelease(&vkrt->core.geometryLayout.vertices);
+    vkrtGeometryRangeRelease(&vkrt->core.geometryLayout.indices);
+    vkrtGeometryDedupRelease(&vkrt->core.geometryDedup);
+    free(vkrt->core.meshes);
+    free(vkrt);
+    destroyTestMesh(&small);
+    destroyTestMesh(&large);
+    destroyTestMesh(&refill);
+}
+
+int main(void) {
+    testAllocateAndFree();
+    testFreeMergesNeighbours();
+    testGrowth();
+    testUploadBytesTrackEdits();
+    destroyMockGpu();
+    return testExitCode("geometry_heap");
+}
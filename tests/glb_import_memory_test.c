@@ -0,0 +1,270 @@
+#include "job_pool.h"
+#include "loader.h"
+#include "platform.h"
+#include "test.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Peak-memory regression check for importing a large GLB. The GLB's binary chunk is mapped, so the anonymous memory an
+// import adds should be only the decoded vertex and index arrays plus tangent-generation scratch. A heap copy of the
+// file would add the whole chunk on top. A sampler thread polls RssAnon while meshLoadFromFile runs. File-backed pages
+// faulted in from the mapping are reclaimable page cache and are not counted.
+
+#if defined(__linux__)
+
+#include <time.h>
+#include <unistd.h>
+
+enum {
+    TEST_GRID_SIZE = 1449,
+    TEST_VERTEX_COUNT = TEST_GRID_SIZE * TEST_GRID_SIZE,
+    TEST_INDEX_COUNT = (TEST_GRID_SIZE - 1) * (TEST_GRID_SIZE - 1) * 6,
+    TEST_GLB_HEADER_BYTES = 12,
+    TEST_GLB_CHUNK_HEADER_BYTES = 8,
+    TEST_JSON_CAPACITY = 4096,
+};
+
+static const uint32_t kGLBMagic = 0x46546C67u;
+static const uint32_t kGLBVersion = 2u;
+static const uint32_t kGLBChunkJSON = 0x4E4F534Au;
+static const uint32_t kGLBChunkBIN = 0x004E4942u;
+static const uint64_t kPositionBytes = (uint64_t)TEST_VERTEX_COUNT * 3u * sizeof(float);
+static const uint64_t kNormalBytes = (uint64_t)TEST_VERTEX_COUNT * 3u * sizeof(float);
+static const uint64_t kTexcoordBytes = (uint64_t)TEST_VERTEX_COUNT * 2u * sizeof(float);
+static const uint64_t kIndexBytes = (uint64_t)TEST_INDEX_COUNT * sizeof(uint32_t);
+static const double kBytesPerMiB = 1024.0 * 1024.0;
+
+typedef struct AnonymousMemorySampler {
+    VKRT_Mutex mutex;
+    VKRT_Thread thread;
+    uint64_t peakBytes;
+    uint8_t stop;
+} AnonymousMemorySampler;
+
+static uint64_t queryAnonymousBytes(void) {
+    FILE* status = fopen("/proc/self/status", "r");
+    if (!status) return 0u;
+
+    char line[256];
+    unsigned long long kilobytes = 0u;
+    while (fgets(line, sizeof(line), status)) {
+        if (sscanf(line, "RssAnon: %llu kB", &kilobytes) == 1) break;
+    }
+    fclose(status);
+    return (uint64_t)kilobytes * 1024u;
+}
+
+static int sampleAnonymousMemory(void* userData) {
+    AnonymousMemorySampler* sampler = (AnonymousMemorySampler*)userData;
+    const struct timespec interval = {.tv_sec = 0, .tv_nsec = 1000000};
+    for (;;) {
+        uint64_t bytes = queryAnonymousBytes();
+        vkrtMutexLock(&sampler->mutex);
+        if (bytes > sampler->peakBytes) sampler->peakBytes = bytes;
+        uint8_t stop = sampler->stop;
+        vkrtMutexUnlock(&sampler->mutex);
+        if (stop) return 0;
+        nanosleep(&interval, NULL);
+    }
+}
+
+static int writeBytes(FILE* file, const void* data, size_t size) {
+    return fwrite(data, 1u, size, file) == size;
+}
+
+static int writeUInt32(FILE* file, uint32_t value) {
+    return writeBytes(file, &value, sizeof(value));
+}
+
+// Streams a flat grid as one indexed primitive, so building the test file never holds it in memory.
+static int writeGridBinaryChunk(FILE* file) {
+    float row[TEST_GRID_SIZE * 3];
+    for (uint32_t y = 0; y < TEST_GRID_SIZE; y++) {
+        for (uint32_t x = 0; x < TEST_GRID_SIZE; x++) {
+            row[(x * 3u) + 0u] = (float)x;
+            row[(x * 3u) + 1u] = 0.0f;
+            row[(x * 3u) + 2u] = (float)y;
+        }
+        if (!writeBytes(file, row, sizeof(float) * TEST_GRID_SIZE * 3u)) return 0;
+    }
+    for (uint32_t i = 0; i < TEST_GRID_SIZE; i++) {
+        row[(i * 3u) + 0u] = 0.0f;
+        row[(i * 3u) + 1u] = 1.0f;
+        row[(i * 3u) + 2u] = 0.0f;
+    }
+    for (uint32_t y = 0; y < TEST_GRID_SIZE; y++) {
+        if (!writeBytes(file, row, sizeof(float) * TEST_GRID_SIZE * 3u)) return 0;
+    }
+    for (uint32_t y = 0; y < TEST_GRID_SIZE; y++) {
+        for (uint32_t x = 0; x < TEST_GRID_SIZE; x++) {
+            row[(x * 2u) + 0u] = (float)x / (float)(TEST_GRID_SIZE - 1);
+            row[(x * 2u) + 1u] = (float)y / (float)(TEST_GRID_SIZE - 1);
+        }
+        if (!writeBytes(file, row, sizeof(float) * TEST_GRID_SIZE * 2u)) return 0;
+    }
+
+    uint32_t quadIndices[(TEST_GRID_SIZE - 1) * 6];
+    for (uint32_t y = 0; y + 1u < TEST_GRID_SIZE; y++) {
+        for (uint32_t x = 0; x + 1u < TEST_GRID_SIZE; x++) {
+            uint32_t corner = (y * TEST_GRID_SIZE) + x;
+            uint32_t* quad = &quadIndices[x * 6u];
+            quad[0] = corner;
+            quad[1] = corner + TEST_GRID_SIZE;
+            quad[2] = corner + 1u;
+            quad[3] = corner + 1u;
+            quad[4] = corner + TEST_GRID_SIZE;
+            quad[5] = corner + TEST_GRID_SIZE + 1u;
+        }
+        if (!writeBytes(file, quadIndices, sizeof(quadIndices))) return 0;
+    }
+    return 1;
+}
+
+static int formatGridJSON(char* json, size_t jsonCapacity, uint32_t* outPaddedLength) {
+    uint64_t binaryBytes = kPositionBytes + kNormalBytes + kTexcoordBytes + kIndexBytes;
+    int written = snprintf(
+        json,
+        jsonCapacity,
+        "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],"
+        "\"nodes\":[{\"mesh\":0,\"name\":\"grid\"}],"
+        "\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0,\"NORMAL\":1,\"TEXCOORD_0\":2},\"indices\":3}]}],"
+        "\"buffers\":[{\"byteLength\":%llu}],"
+        "\"bufferViews\":["
+        "{\"buffer\":0,\"byteOffset\":0,\"byteLength\":%llu},"
+        "{\"buffer\":0,\"byteOffset\":%llu,\"byteLength\":%llu},"
+        "{\"buffer\":0,\"byteOffset\":%llu,\"byteLength\":%llu},"
+        "{\"buffer\":0,\"byteOffset\":%llu,\"byteLength\":%llu}],"
+        "\"accessors\":["
+        "{\"bufferView\":0,\"componentType\":5126,\"count\":%u,\"type\":\"VEC3\",\"min\":[0,0,0],\"max\":[%u,0,%u]},"
+        "{\"bufferView\":1,\"componentType\":5126,\"count\":%u,\"type\":\"VEC3\"},"
+        "{\"bufferView\":2,\"componentType\":5126,\"count\":%u,\"type\":\"VEC2\"},"
+        "{\"bufferView\":3,\"componentType\":5125,\"count\":%u,\"type\":\"SCALAR\"}]}",
+        (unsigned long long)binaryBytes,
+        (unsigned long long)kPositionBytes,
+        (unsigned long long)kPositionBytes,
+        (unsigned long long)kNormalBytes,
+        (unsigned long long)(kPositionBytes + kNormalBytes),
+        (unsigned long long)kTexcoordBytes,
+        (unsigned long long)(kPositionBytes + kNormalBytes + kTexcoordBytes),
+        (unsigned long long)kIndexBytes,
+        (unsigned)TEST_VERTEX_COUNT,
+        (unsigned)(TEST_GRID_SIZE - 1),
+        (unsigned)(TEST_GRID_SIZE - 1),
+        (unsigned)TEST_VERTEX_COUNT,
+        (unsigned)TEST_VERTEX_COUNT,
+        (unsigned)TEST_INDEX_COUNT
+    );
+    if (written <= 0 || (size_t)written + 3u >= jsonCapacity) return 0;
+
+    // GLB chunks are 4-byte aligned; the JSON chunk pads with spaces.
+    uint32_t length = (uint32_t)written;
+    while ((length & 3u) != 0u) json[length++] = ' ';
+    *outPaddedLength = length;
+    return 1;
+}
+
+static int writeGridGLB(const char* path, uint64_t* outFileBytes) {
+    char json[TEST_JSON_CAPACITY];
+    uint32_t jsonLength = 0u;
+    if (!formatGridJSON(json, sizeof(json), &jsonLength)) return 0;
+
+    uint64_t binaryBytes = kPositionBytes + kNormalBytes + kTexcoordBytes + kIndexBytes;
+    uint64_t fileBytes = TEST_GLB_HEADER_BYTES + (2u * TEST_GLB_CHUNK_HEADER_BYTES) + jsonLength + binaryBytes;
+    FILE* file = fopen(path, "wb");
+    if (!file) return 0;
+
+    int written = writeUInt32(file, kGLBMagic) && writeUInt32(file, kGLBVersion) &&
+                  writeUInt32(file, (uint32_t)fileBytes) && writeUInt32(file, jsonLength) &&
+                  writeUInt32(file, kGLBChunkJSON) && writeBytes(file, json, jsonLength) &&
+                  writeUInt32(file, (uint32_t)binaryBytes) && writeUInt32(file, kGLBChunkBIN) &&
+                  writeGridBinaryChunk(file);
+    if (fclose(file) != 0) written = 0;
+    *outFileBytes = fileBytes;
+    return written;
+}
+
+static void testLargeGLBImportMemory(const char* path) {
+    uint64_t fileBytes = 0u;
+    TEST_CHECK(writeGridGLB(path, &fileBytes));
+    if (fileBytes == 0u) return;
+
+    MeshImportOptions options = {0};
+    meshDefaultImportOptions(&options);
+    options.optimizeGeometry = 0u;
+    meshSetImportOptions(&options);
+
+    AnonymousMemorySampler sampler = {0};
+    TEST_CHECK(vkrtMutexInit(&sampler.mutex, VKRT_MUTEX_PLAIN) == VKRT_THREAD_SUCCESS);
+    uint64_t baselineBytes = queryAnonymousBytes();
+    sampler.peakBytes = baselineBytes;
+    TEST_CHECK(vkrtThreadCreate(&sampler.thread, sampleAnonymousMemory, &sampler) == VKRT_THREAD_SUCCESS);
+
+    MeshImportData importData = {0};
+    uint64_t start = getMicroseconds();
+    int loaded = meshLoadFromFile(path, &importData) == 0;
+    double seconds = (double)(getMicroseconds() - start) / 1000000.0;
+
+    vkrtMutexLock(&sampler.mutex);
+    sampler.stop = 1u;
+    vkrtMutexUnlock(&sampler.mutex);
+    TEST_CHECK(vkrtThreadJoin(sampler.thread, NULL) == VKRT_THREAD_SUCCESS);
+    vkrtMutexDestroy(&sampler.mutex);
+
+    TEST_CHECK(loaded);
+    TEST_CHECK(importData.count == 1u);
+    if (loaded && importData.count == 1u) {
+        TEST_CHECK(importData.entries[0].vertexCount == TEST_VERTEX_COUNT);
+        TEST_CHECK(importData.entries[0].indexCount == TEST_INDEX_COUNT);
+    }
+
+    uint64_t binaryBytes = kPositionBytes + kNormalBytes + kTexcoordBytes + kIndexBytes;
+    uint64_t decodedBytes = ((uint64_t)TEST_VERTEX_COUNT * sizeof(Vertex)) + kIndexBytes;
+    // The grid has no TANGENT attribute, so the importer generates tangents from a texcoord copy and two per-vertex
+    // accumulators.
+    uint64_t tangentScratchBytes = (uint64_t)TEST_VERTEX_COUNT * ((2u * sizeof(float)) + (6u * sizeof(float)));
+    uint64_t growthBytes = sampler.peakBytes - baselineBytes;
+    // Half of the binary chunk leaves room for allocator and job-pool overhead while still failing on a full copy.
+    uint64_t budgetBytes = decodedBytes + tangentScratchBytes + (binaryBytes / 2u);
+    printf(
+        "glb_import_memory: %.1f MiB GLB imported in %.2f s, %.1f MiB decoded, peak anonymous growth %.1f MiB "
+        "(budget %.1f MiB)\n",
+        (double)fileBytes / kBytesPerMiB,
+        seconds,
+        (double)decodedBytes / kBytesPerMiB,
+        (double)growthBytes / kBytesPerMiB,
+        (double)budgetBytes / kBytesPerMiB
+    );
+    TEST_CHECK(growthBytes <= budgetBytes);
+
+    meshReleaseImportData(&importData);
+}
+
+int main(void) {
+    // An XDG cache root that cannot be created keeps the import off the mesh cache, so every run parses the GLB and
+    // nothing large is left behind.
+    TEST_CHECK(setenv("XDG_CACHE_HOME", "/proc/vkrt-glb-import-memory-test", 1) == 0);
+
+    char path[] = "/tmp/vkrt-glb-import-memory-XXXXXX.glb";
+    int descriptor = mkstemps(path, 4);
+    TEST_CHECK(descriptor >= 0);
+    if (descriptor < 0) return testExitCode("glb_import_memory");
+    close(descriptor);
+
+    // The app imports with the shared pool held by its VKRT instance; take it before the memory baseline is sampled.
+    (void)vkrtJobPoolAcquireShared();
+    testLargeGLBImportMemory(path);
+    vkrtJobPoolReleaseShared();
+    unlink(path);
+    return testExitCode("glb_import_memory");
+}
+
+#else
+
+int main(void) {
+    printf("glb_import_memory: skipped, RssAnon sampling needs Linux\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,242 @@
+#include "constants.h"
+#include "formats.h"
+#include "image.h"
+#include "test.h"
+#include "vulkan/vulkan_core.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Decodes synthetic KTX2 and DDS files through vkrtLoadImageFromMemory: block-compressed mip chains come back with
+// the right format, color space and level offsets, and a truncated level index or a level that runs past the end of
+// the file or sits off its block alignment is rejected.
+
+enum {
+    TEST_FILE_CAPACITY = 4096,
+    TEST_KTX2_HEADER_BYTES = 80,
+    TEST_KTX2_LEVEL_ENTRY_BYTES = 24,
+    TEST_DDS_HEADER_BYTES = 128,
+    TEST_DDS_DX10_HEADER_BYTES = 20,
+    TEST_EXTENT = 16,
+    TEST_LEVEL_COUNT = 5,
+};
+
+static const uint8_t kKTX2Identifier[12] = {0xab, 0x4b, 0x54, 0x58, 0x20, 0x32, 0x30, 0xbb, 0x0d, 0x0a, 0x1a, 0x0a};
+static const uint32_t kDDSFlagMipMapCount = 0x20000u;
+static const uint32_t kDDSPixelFormatAlphaPixels = 0x1u;
+static const uint32_t kDDSPixelFormatFourCC = 0x4u;
+static const uint32_t kDDSFourCCDXT1 = 0x31545844u;
+static const uint32_t kDDSFourCCDX10 = 0x30315844u;
+static const uint32_t kDXGIFormatBC7Unorm = 98u;
+
+typedef struct TestFile {
+    uint8_t bytes[TEST_FILE_CAPACITY];
+    size_t size;
+    size_t levelOffsets[TEST_LEVEL_COUNT];
+    size_t levelBytes[TEST_LEVEL_COUNT];
+} TestFile;
+
+static void writeLE32(uint8_t* bytes, uint32_t value) {
+    for (uint32_t i = 0; i < 4u; i++) bytes[i] = (uint8_t)(value >> (i * 8u));
+}
+
+static void writeLE64(uint8_t* bytes, uint64_t value) {
+    writeLE32(bytes, (uint32_t)value);
+    writeLE32(bytes + 4u, (uint32_t)(value >> 32u));
+}
+
+static size_t levelByteSize(uint32_t format, uint32_t level) {
+    uint32_t extent = (uint32_t)TEST_EXTENT >> level;
+    size_t bytes = 0u;
+    TEST_CHECK(vkrtTryComputeTextureByteSize(extent > 0u ? extent : 1u, extent > 0u ? extent : 1u, format, &bytes));
+    return bytes;
+}
+
+// Every level gets its own byte pattern so a wrong offset shows up as mismatched contents.
+static void fillLevel(TestFile* file, uint32_t level, size_t offset, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) file->bytes[offset + i] = (uint8_t)((level * 37u) + i);
+    file->levelOffsets[level] = offset;
+    file->levelBytes[level] = bytes;
+}
+
+// KTX2 stores the smallest level first, so the level index points backwards through the file.
+static void buildKTX2(TestFile* file, uint32_t vkFormat, uint32_t format) {
+    memset(file, 0, sizeof(*file));
+    memcpy(file->bytes, kKTX2Identifier, sizeof(kKTX2Identifier));
+    writeLE32(file->bytes + 12u, vkFormat);
+    writeLE32(file->bytes + 16u, 1u);
+    writeLE32(file->bytes + 20u, TEST_EXTENT);
+    writeLE32(file->bytes + 24u, TEST_EXTENT);
+    writeLE32(file->bytes + 36u, 1u);
+    writeLE32(file->bytes + 40u, TEST_LEVEL_COUNT);
+
+    size_t offset = TEST_KTX2_HEADER_BYTES + ((size_t)TEST_LEVEL_COUNT * TEST_KTX2_LEVEL_ENTRY_BYTES);
+    for (uint32_t level = TEST_LEVEL_COUNT; level-- > 0u;) {
+        size_t bytes = levelByteSize(format, level);
+        uint8_t* entry = file->bytes + TEST_KTX2_HEADER_BYTES + ((size_t)level * TEST_KTX2_LEVEL_ENTRY_BYTES);
+        writeLE64(entry, offset);
+        writeLE64(entry + 8u, bytes);
+        writeLE64(entry + 16u, bytes);
+        fillLevel(file, level, offset, bytes);
+        offset += bytes;
+    }
+    file->size = offset;
+}
+
+static void buildDDS(TestFile* file, uint32_t pixelFormatFlags, uint32_t fourCC, uint32_t dxgiFormat, uint32_t format) {
+    memset(file, 0, sizeof(*file));
+    memcpy(file->bytes, "DDS ", 4u);
+    writeLE32(file->bytes + 4u, 124u);
+    writeLE32(file->bytes + 8u, kDDSFlagMipMapCount);
+    writeLE32(file->bytes + 12u, TEST_EXTENT);
+    writeLE32(file->bytes + 16u, TEST_EXTENT);
+    writeLE32(file->bytes + 28u, TEST_LEVEL_COUNT);
+    writeLE32(file->bytes + 76u, 32u);
+    writeLE32(file->bytes + 80u, kDDSPixelFormatFourCC | pixelFormatFlags);
+    writeLE32(file->bytes + 84u, fourCC);
+
+    size_t offset = TEST_DDS_HEADER_BYTES;
+    if (fourCC == kDDSFourCCDX10) {
+        writeLE32(file->bytes + 128u, dxgiFormat);
+        writeLE32(file->bytes + 132u, 3u);
+        writeLE32(file->bytes + 140u, 1u);
+        offset += TEST_DDS_DX10_HEADER_BYTES;
+    }
+    for (uint32_t level = 0; level < TEST_LEVEL_COUNT; level++) {
+        size_t bytes = levelByteSize(format, level);
+        fillLevel(file, level, offset, bytes);
+        offset += bytes;
+    }
+    file->size = offset;
+}
+
+static int decodeFile(const TestFile* file, uint32_t preferredColorSpace, VKRT_LoadedImage* outImage) {
+    return vkrtLoadImageFromMemory(file->bytes, file->size, NULL, preferredColorSpace, outImage);
+}
+
+static void checkDecodedChain(const TestFile* file, uint32_t preferredColorSpace, uint32_t format, uint32_t colorSpace) {
+    VKRT_LoadedImage image = {0};
+    TEST_CHECK(decodeFile(file, preferredColorSpace, &image));
+    TEST_CHECK(image.width == TEST_EXTENT && image.height == TEST_EXTENT);
+    TEST_CHECK(image.format == format);
+    TEST_CHECK(image.colorSpace == colorSpace);
+    TEST_CHECK(image.mipLevelCount == TEST_LEVEL_COUNT);
+    if (image.pixels && image.mipLevelCount == TEST_LEVEL_COUNT) {
+        for (uint32_t level = 0; level < TEST_LEVEL_COUNT; level++) {
+            const uint8_t* decoded = (const uint8_t*)image.pixels + image.mipLevelOffsets[level];
+            TEST_CHECK(memcmp(decoded, file->bytes + file->levelOffsets[level], file->levelBytes[level]) == 0);
+        }
+    }
+    vkrtFreeLoadedImage(&image);
+}
+
+static void checkRejected(const TestFile* file) {
+    VKRT_LoadedImage image = {0};
+    TEST_CHECK(!decodeFile(file, VKRT_TEXTURE_COLOR_SPACE_LINEAR, &image));
+    TEST_CHECK(image.pixels == NULL);
+    vkrtFreeLoadedImage(&image);
+}
+
+static void testKTX2MipChains(void) {
+    TestFile file;
+    buildKTX2(&file, VK_FORMAT_BC7_UNORM_BLOCK, VKRT_TEXTURE_FORMAT_BC7_RGBA_UNORM);
+    checkDecodedChain(
+        &file,
+        VKRT_TEXTURE_COLOR_SPACE_SRGB,
+        VKRT_TEXTURE_FORMAT_BC7_RGBA_UNORM,
+        VKRT_TEXTURE_COLOR_SPACE_LINEAR
+    );
+
+    buildKTX2(&file, VK_FORMAT_BC7_SRGB_BLOCK, VKRT_TEXTURE_FORMAT_BC7_RGBA_UNORM);
+    checkDecodedChain(
+        &file,
+        VKRT_TEXTURE_COLOR_SPACE_LINEAR,
+        VKRT_TEXTURE_FORMAT_BC7_RGBA_UNORM,
+        VKRT_TEXTURE_COLOR_SPACE_SRGB
+    );
+
+    buildKTX2(&file, VK_FORMAT_BC1_RGB_UNORM_BLOCK, VKRT_TEXTURE_FORMAT_BC1_RGB_UNORM);
+    checkDecodedChain(
+        &file,
+        VKRT_TEXTURE_COLOR_SPACE_LINEAR,
+        VKRT_TEXTURE_FORMAT_BC1_RGB_UNORM,
+        VKRT_TEXTURE_COLOR_SPACE_LINEAR
+    );
+}
+
+static void testKTX2Rejections(void) {
+    TestFile file;
+
+    // The header promises five levels but the file ends after two index entries.
+    buildKTX2(&file, VK_FORMAT_BC7_UNORM_BLOCK, VKRT_TEXTURE_FORMAT_BC7_RGBA_UNORM);
+    file.size = TEST_KTX2_HEADER_BYTES + (2u * TEST_KTX2_LEVEL_ENTRY_BYTES);
+    checkRejected(&file);
+
+    // A level offset past the end of the file.
+    buildKTX2(&file, VK_FORMAT_BC7_UNORM_BLOCK, VKRT_TEXTURE_FORMAT_BC7_RGBA_UNORM);
+    writeLE64(file.bytes + TEST_KTX2_HEADER_BYTES + TEST_KTX2_LEVEL_ENTRY_BYTES, (uint64_t)file.size + 16u);
+    checkRejected(&file);
+
+    // An offset inside the file whose level runs past its end.
+    buildKTX2(&file, VK_FORMAT_BC7_UNORM_BLOCK, VKRT_TEXTURE_FORMAT_BC7_RGBA_UNORM);
+    file.size -= 16u;
+    checkRejected(&file);
+
+    // An offset that splits a 16-byte BC7 block.
+    buildKTX2(&file, VK_FORMAT_BC7_UNORM_BLOCK, VKRT_TEXTURE_FORMAT_BC7_RGBA_UNORM);
+    writeLE64(file.bytes + TEST_KTX2_HEADER_BYTES, (uint64_t)file.levelOffsets[0] - 4u);
+    checkRejected(&file);
+}
+
+static void testDDSMipChains(void) {
+    TestFile file;
+
+    // Legacy DXT1 is opaque unless DDPF_ALPHAPIXELS asks for punch-through alpha. It carries no color space, so the
+    // caller's preference applies.
+    buildDDS(&file, 0u, kDDSFourCCDXT1, 0u, VKRT_TEXTURE_FORMAT_BC1_RGB_UNORM);
+    checkDecodedChain(
+        &file,
+        VKRT_TEXTURE_COLOR_SPACE_SRGB,
+        VKRT_TEXTURE_FORMAT_BC1_RGB_UNORM,
+        VKRT_TEXTURE_COLOR_SPACE_SRGB
+    );
+
+    buildDDS(&file, kDDSPixelFormatAlphaPixels, kDDSFourCCDXT1, 0u, VKRT_TEXTURE_FORMAT_BC1_RGBA_UNORM);
+    checkDecodedChain(
+        &file,
+        VKRT_TEXTURE_COLOR_SPACE_LINEAR,
+        VKRT_TEXTURE_FORMAT_BC1_RGBA_UNORM,
+        VKRT_TEXTURE_COLOR_SPACE_LINEAR
+    );
+
+    buildDDS(&file, 0u, kDDSFourCCDX10, kDXGIFormatBC7Unorm, VKRT_TEXTURE_FORMAT_BC7_RGBA_UNORM);
+    checkDecodedChain(
+        &file,
+        VKRT_TEXTURE_COLOR_SPACE_SRGB,
+        VKRT_TEXTURE_FORMAT_BC7_RGBA_UNORM,
+        VKRT_TEXTURE_COLOR_SPACE_LINEAR
+    );
+}
+
+static void testDDSRejections(void) {
+    TestFile file;
+
+    // The last mip level is cut short.
+    buildDDS(&file, 0u, kDDSFourCCDXT1, 0u, VKRT_TEXTURE_FORMAT_BC1_RGB_UNORM);
+    file.size -= 4u;
+    checkRejected(&file);
+
+    // The DX10 extension header itself is cut short.
+    buildDDS(&file, 0u, kDDSFourCCDX10, kDXGIFormatBC7Unorm, VKRT_TEXTURE_FORMAT_BC7_RGBA_UNORM);
+    file.size = TEST_DDS_HEADER_BYTES + 8u;
+    checkRejected(&file);
+}
+
+int main(void) {
+    testKTX2MipChains();
+    testKTX2Rejections();
+    testDDSMipChains();
+    testDDSRejections();
+    return testExitCode("image_container");
+}
@@ -0,0 +1,423 @@
+#include "buffer.h"
+#include "constants.h"
+#include "lighting.h"
+#include "state.h"
+#include "test.h"
+#include "types.h"
+#include "vkrt_internal.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vulkan/vulkan.h>
+
+// Runs the real light rebuild in lighting.c against captured buffer uploads and checks what the shaders rely on:
+// a hit primitive finds its cluster by division, each cluster's alias table matches its areas, every non-empty
+// cluster is one BVH leaf whose bit trail replays to it, and the leaf bounds and cones cover its world triangles.
+
+enum {
+    MOCK_MAX_UPLOADS = 64,
+    TEST_GRID_SIZE = 10,
+    TEST_STRIP_TRIANGLES = 40,
+};
+
+typedef struct MockUpload {
+    VkBuffer buffer;
+    void* data;
+    VkDeviceSize size;
+} MockUpload;
+
+static MockUpload gMockUploads[MOCK_MAX_UPLOADS];
+static uint64_t gNextMockHandle;
+static Material gMaterials[2];
+
+VKRT_Result createDeviceBufferFromData(
+    VKRT* vkrt,
+    const void* hostData,
+    VkDeviceSize size,
+    VkBufferUsageFlags usage,
+    VkBuffer* outBuffer,
+    MemoryAllocation* outMemory,
+    VkDeviceAddress* outDeviceAddress
+) {
+    (void)vkrt;
+    (void)usage;
+    for (uint32_t i = 0; i < MOCK_MAX_UPLOADS; i++) {
+        MockUpload* upload = &gMockUploads[i];
+        if (upload->buffer != VK_NULL_HANDLE) continue;
+
+        upload->data = malloc((size_t)size);
+        if (!upload->data) return VKRT_ERROR_OUT_OF_MEMORY;
+        memcpy(upload->data, hostData, (size_t)size);
+        upload->size = size;
+        upload->buffer = (VkBuffer)(uintptr_t)++gNextMockHandle;
+        *outBuffer = upload->buffer;
+        *outMemory = NULL;
+        if (outDeviceAddress) *outDeviceAddress = 0u;
+        return VKRT_SUCCESS;
+    }
+    return VKRT_ERROR_OUT_OF_MEMORY;
+}
+
+void destroyBufferResources(VKRT* vkrt, Buffer* buffer) {
+    (void)vkrt;
+    if (!buffer) return;
+    for (uint32_t i = 0; i < MOCK_MAX_UPLOADS; i++) {
+        if (buffer->buffer == VK_NULL_HANDLE || gMockUploads[i].buffer != buffer->buffer) continue;
+        free(gMockUploads[i].data);
+        gMockUploads[i] = (MockUpload){0};
+    }
+    *buffer = (Buffer){0};
+}
+
+const Material* vkrtGetSceneMaterialData(const VKRT* vkrt, uint32_t materialIndex) {
+    (void)vkrt;
+    return materialIndex < 2u ? &gMaterials[materialIndex] : NULL;
+}
+
+static const void* findUpload(const Buffer* buffer, VkDeviceSize elementSize, uint32_t minimumCount) {
+    for (uint32_t i = 0; i < MOCK_MAX_UPLOADS; i++) {
+        if (buffer->buffer == VK_NULL_HANDLE || gMockUploads[i].buffer != buffer->buffer) continue;
+        TEST_CHECK(gMockUploads[i].size >= elementSize * minimumCount);
+        return gMockUploads[i].data;
+    }
+    TEST_CHECK(!"light buffer was not uploaded");
+    return NULL;
+}
+
+static void setVertex(Mesh* mesh, uint32_t index, float x, float y, float z) {
+    mesh->vertices[index] = (Vertex){0};
+    mesh->vertices[index].position[0] = x;
+    mesh->vertices[index].position[1] = y;
+    mesh->vertices[index].position[2] = z;
+    mesh->vertices[index].position[3] = 1.0f;
+}
+
+static void allocateMesh(Mesh* mesh, uint32_t vertexCount, uint32_t triangleCount, uint32_t materialIndex) {
+    *mesh = (Mesh){0};
+    mesh->vertices = (Vertex*)calloc(vertexCount, sizeof(Vertex));
+    mesh->indices = (uint32_t*)calloc((size_t)triangleCount * 3u, sizeof(uint32_t));
+    mesh->info.vertexCount = vertexCount;
+    mesh->info.indexCount = triangleCount * 3u;
+    mesh->info.materialIndex = materialIndex;
+    mesh->info.opacity = 1.0f;
+    glm_mat4_identity(mesh->worldTransform);
+}
+
+// A curved emissive sheet: a height field bent along x so neighbouring clusters face different ways. One triangle is
+// degenerate, so its cluster holds one triangle fewer than its source range.
+static void buildCurvedGrid(Mesh* mesh) {
+    const uint32_t rowVertices = TEST_GRID_SIZE + 1u;
+    const uint32_t triangleCount = (TEST_GRID_SIZE * TEST_GRID_SIZE * 2u) + 1u;
+    allocateMesh(mesh, rowVertices * rowVertices, triangleCount, 0u);
+    for (uint32_t z = 0; z < rowVertices; z++) {
+        for (uint32_t x = 0; x < rowVertices; x++) {
+            float u = (float)x / TEST_GRID_SIZE;
+            setVertex(mesh, (z * rowVertices) + x, cosf(u * 3.0f), sinf(u * 3.0f), (float)z / TEST_GRID_SIZE);
+        }
+    }
+
+    uint32_t* index = mesh->indices;
+    for (uint32_t z = 0; z < TEST_GRID_SIZE; z++) {
+        for (uint32_t x = 0; x < TEST_GRID_SIZE; x++) {
+            uint32_t corner = (z * rowVertices) + x;
+            if (z == 1u && x == 3u) {
+                *index++ = corner;
+                *index++ = corner;
+                *index++ = corner + 1u;
+            }
+            *index++ = corner;
+            *index++ = corner + rowVertices;
+            *index++ = corner + 1u;
+            *index++ = corner + 1u;
+            *index++ = corner + rowVertices;
+            *index++ = corner + rowVertices + 1u;
+        }
+    }
+}
+
+// A strip of triangles whose second cluster is entirely degenerate, under a non-uniform scale so areas are measured
+// in world space.
+static void buildScaledStrip(Mesh* mesh) {
+    allocateMesh(mesh, (TEST_STRIP_TRIANGLES * 3u), TEST_STRIP_TRIANGLES, 0u);
+    for (uint32_t triangle = 0; triangle < TEST_STRIP_TRIANGLES; triangle++) {
+        float x = (float)triangle;
+        float height = 1.0f + (0.1f * (float)triangle);
+        setVertex(mesh, (triangle * 3u) + 0u, x, 0.0f, 0.0f);
+        setVertex(mesh, (triangle * 3u) + 1u, x + 1.0f, 0.0f, 0.0f);
+        setVertex(mesh, (triangle * 3u) + 2u, x, height, 0.2f * (float)triangle);
+        for (uint32_t corner = 0; corner < 3u; corner++) {
+            int degenerate = triangle >= VKRT_LIGHT_CLUSTER_TRIANGLE_COUNT &&
+                             triangle < 2u * VKRT_LIGHT_CLUSTER_TRIANGLE_COUNT;
+            mesh->indices[(triangle * 3u) + corner] = (triangle * 3u) + (degenerate ? 0u : corner);
+        }
+    }
+
+    mesh->worldTransform[0][0] = 2.0f;
+    mesh->worldTransform[2][2] = 0.5f;
+    mesh->worldTransform[3][0] = -4.0f;
+    mesh->worldTransform[3][1] = 3.0f;
+}
+
+static void releaseTestScene(VKRT* vkrt) {
+    for (uint32_t i = 0; i < vkrt->core.meshCount; i++) {
+        vkrtReleaseEmissiveTriangleCache(&vkrt->core.meshes[i].emissiveCache);
+        free(vkrt->core.meshes[i].vertices);
+        free(vkrt->core.meshes[i].indices);
+    }
+    free(vkrt->core.meshes);
+    destroyBufferResources(vkrt, &vkrt->core.sceneEmissiveMeshData);
+    destroyBufferResources(vkrt, &vkrt->core.sceneEmissiveTriangleData);
+    destroyBufferResources(vkrt, &vkrt->core.sceneMeshAliasQ);
+    destroyBufferResources(vkrt, &vkrt->core.sceneMeshAliasIdx);
+    destroyBufferResources(vkrt, &vkrt->core.sceneTriAliasQ);
+    destroyBufferResources(vkrt, &vkrt->core.sceneTriAliasIdx);
+    destroyBufferResources(vkrt, &vkrt->core.sceneLightBVHData);
+    destroyBufferResources(vkrt, &vkrt->core.sceneEnvironmentAliasQ);
+    destroyBufferResources(vkrt, &vkrt->core.sceneEnvironmentAliasIdx);
+    destroyBufferResources(vkrt, &vkrt->core.sceneEnvironmentPmf);
+    free(vkrt);
+}
+
+static void transformPoint(const Mesh* mesh, const float local[3], float outWorld[3]) {
+    for (int row = 0; row < 3; row++) {
+        outWorld[row] = (mesh->worldTransform[0][row] * local[0]) + (mesh->worldTransform[1][row] * local[1]) +
+                        (mesh->worldTransform[2][row] * local[2]) + mesh->worldTransform[3][row];
+    }
+}
+
+static void queryWorldTriangle(const Mesh* mesh, const EmissiveTriangle* triangle, float outCorners[3][3]) {
+    float corners[3][3];
+    for (int axis = 0; axis < 3; axis++) {
+        corners[0][axis] = triangle->v0Area[axis];
+        corners[1][axis] = triangle->v0Area[axis] + triangle->e1Pad[axis];
+        corners[2][axis] = triangle->v0Area[axis] + triangle->e2Pad[axis];
+    }
+    for (int corner = 0; corner < 3; corner++) transformPoint(mesh, corners[corner], outCorners[corner]);
+}
+
+static int sourceTriangleIsDegenerate(const Mesh* mesh, uint32_t triangleIndex) {
+    const uint32_t* indices = &mesh->indices[triangleIndex * 3u];
+    return indices[0] == indices[1] || indices[1] == indices[2] || indices[0] == indices[2];
+}
+
+// Walks the source triangles of every emissive mesh and checks that the emitter found the way the MIS code finds it
+// holds exactly that mesh's surviving triangles, in order, with an alias table that reproduces their areas.
+static void checkClusterLayout(
+    const VKRT* vkrt,
+    const EmissiveMesh* emitters,
+    const EmissiveTriangle* triangles,
+    const float* aliasQ,
+    const uint32_t* aliasIdx
+) {
+    for (uint32_t meshIndex = 0; meshIndex < vkrt->core.meshCount; meshIndex++) {
+        const Mesh* mesh = &vkrt->core.meshes[meshIndex];
+        if (mesh->info.lightPdfArea <= 0.0f) continue;
+
+        uint32_t sourceTriangleCount = mesh->info.indexCount / 3u;
+        uint32_t clusterCount =
+            (sourceTriangleCount + VKRT_LIGHT_CLUSTER_TRIANGLE_COUNT - 1u) / VKRT_LIGHT_CLUSTER_TRIANGLE_COUNT;
+        for (uint32_t cluster = 0; cluster < clusterCount; cluster++) {
+            const EmissiveMesh* emitter = &emitters[mesh->info.lightEmitterOffset + cluster];
+            TEST_CHECK(emitter->meshIndex == meshIndex);
+
+            uint32_t first = cluster * VKRT_LIGHT_CLUSTER_TRIANGLE_COUNT;
+            uint32_t last = first + VKRT_LIGHT_CLUSTER_TRIANGLE_COUNT;
+            if (last > sourceTriangleCount) last = sourceTriangleCount;
+            uint32_t local = 0u;
+            double clusterArea = 0.0;
+            for (uint32_t source = first; source < last; source++) {
+                if (sourceTriangleIsDegenerate(mesh, source)) continue;
+                TEST_CHECK(local < emitter->triCount);
+                if (local >= emitter->triCount) break;
+
+                const EmissiveTriangle* triangle = &triangles[emitter->triOffset + local++];
+                const float* v0 = mesh->vertices[mesh->indices[source * 3u]].position;
+                for (int axis = 0; axis < 3; axis++) TEST_CHECK(triangle->v0Area[axis] == v0[axis]);
+                clusterArea += triangle->v0Area[3];
+            }
+            TEST_CHECK(local == emitter->triCount);
+            if (emitter->triCount == 0u) {
+                TEST_CHECK(emitter->pmfMesh == 0.0f);
+                TEST_CHECK(emitter->invTotalArea == 0.0f);
+                continue;
+            }
+
+            double implied[VKRT_LIGHT_CLUSTER_TRIANGLE_COUNT] = {0};
+            for (uint32_t i = 0; i < emitter->triCount; i++) {
+                uint32_t alias = aliasIdx[emitter->triOffset + i];
+                TEST_CHECK(alias < emitter->triCount);
+                if (alias >= emitter->triCount) continue;
+                implied[i] += (double)aliasQ[emitter->triOffset + i] / emitter->triCount;
+                implied[alias] += (1.0 - (double)aliasQ[emitter->triOffset + i]) / emitter->triCount;
+            }
+            for (uint32_t i = 0; i < emitter->triCount; i++) {
+                TEST_CHECK_NEAR(implied[i], triangles[emitter->triOffset + i].v0Area[3] / clusterArea, 1e-5);
+            }
+
+            // Alias sampling picks a cluster by power, then a point by area, which must match the mesh-wide density.
+            TEST_CHECK_NEAR(
+                emitter->pmfMesh * emitter->invTotalArea,
+                mesh->info.lightPdfArea,
+                1e-5 * mesh->info.lightPdfArea
+            );
+        }
+    }
+}
+
+static int boundsContain(const LightBVHNode* node, const float point[3]) {
+    const float slack = 1e-4f;
+    for (int axis = 0; axis < 3; axis++) {
+        if (point[axis] < node->boundsMinPower[axis] - slack) return 0;
+        if (point[axis] > node->boundsMaxCosTheta[axis] + slack) return 0;
+    }
+    return 1;
+}
+
+static void checkLeaf(
+    const VKRT* vkrt,
+    const LightBVHNode* leaf,
+    const EmissiveMesh* emitters,
+    const EmissiveTriangle* triangles
+) {
+    const EmissiveMesh* emitter = &emitters[leaf->childOrEmitter & ~VKRT_LIGHT_BVH_LEAF_BIT];
+    const Mesh* mesh = &vkrt->core.meshes[emitter->meshIndex];
+    for (uint32_t i = 0; i < emitter->triCount; i++) {
+        float corners[3][3];
+        queryWorldTriangle(mesh, &triangles[emitter->triOffset + i], corners);
+        for (int corner = 0; corner < 3; corner++) TEST_CHECK(boundsContain(leaf, corners[corner]));
+
+        vec3 edge1;
+        vec3 edge2;
+        vec3 normal;
+        glm_vec3_sub(corners[1], corners[0], edge1);
+        glm_vec3_sub(corners[2], corners[0], edge2);
+        glm_vec3_cross(edge1, edge2, normal);
+        glm_vec3_normalize(normal);
+        TEST_CHECK(fabsf(glm_vec3_dot((float*)leaf->axis, normal)) >= leaf->boundsMaxCosTheta[3] - 1e-4f);
+    }
+}
+
+// Follows a bit trail the way lightBVHEmitterPmf does and returns the node it ends on.
+static uint32_t replayBitTrail(const LightBVHNode* nodes, uint32_t nodeCount, uint32_t bitTrail) {
+    uint32_t nodeIndex = 0u;
+    for (uint32_t depth = 0u; depth <= VKRT_LIGHT_BVH_MAX_DEPTH && nodeIndex < nodeCount; depth++) {
+        if (nodes[nodeIndex].childOrEmitter & VKRT_LIGHT_BVH_LEAF_BIT) return nodeIndex;
+        nodeIndex = (bitTrail & 1u) ? nodes[nodeIndex].childOrEmitter : nodeIndex + 1u;
+        bitTrail >>= 1u;
+    }
+    return VKRT_INVALID_INDEX;
+}
+
+static void checkLightBVH(
+    const VKRT* vkrt,
+    const EmissiveMesh* emitters,
+    uint32_t emitterCount,
+    const EmissiveTriangle* triangles
+) {
+    const LightBVHNode* nodes =
+        (const LightBVHNode*)findUpload(&vkrt->core.sceneLightBVHData, sizeof(LightBVHNode), 1u);
+    uint32_t nodeCount = (uint32_t)vkrt->core.sceneLightBVHData.count;
+    if (!nodes) return;
+
+    uint32_t leafCount = 0u;
+    for (uint32_t i = 0; i < emitterCount; i++) {
+        if (emitters[i].triCount > 0u) leafCount++;
+    }
+    TEST_CHECK(nodeCount == (2u * leafCount) - 1u);
+
+    uint32_t visitedLeaves = 0u;
+    double leafPower = 0.0;
+    for (uint32_t nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++) {
+        const LightBVHNode* node = &nodes[nodeIndex];
+        if (node->childOrEmitter & VKRT_LIGHT_BVH_LEAF_BIT) {
+            uint32_t emitterIndex = node->childOrEmitter & ~VKRT_LIGHT_BVH_LEAF_BIT;
+            TEST_CHECK(emitterIndex < emitterCount);
+            if (emitterIndex >= emitterCount) continue;
+            TEST_CHECK(emitters[emitterIndex].triCount > 0u);
+            TEST_CHECK(replayBitTrail(nodes, nodeCount, emitters[emitterIndex].lightBitTrail) == nodeIndex);
+            checkLeaf(vkrt, node, emitters, triangles);
+            leafPower += node->boundsMinPower[3];
+            visitedLeaves++;
+            continue;
+        }
+
+        const LightBVHNode* first = &nodes[nodeIndex + 1u];
+        const LightBVHNode* second = &nodes[node->childOrEmitter];
+        TEST_CHECK(node->childOrEmitter > nodeIndex + 1u && node->childOrEmitter < nodeCount);
+        TEST_CHECK_NEAR(
+            node->boundsMinPower[3],
+            first->boundsMinPower[3] + second->boundsMinPower[3],
+            1e-5 * node->boundsMinPower[3]
+        );
+        float firstMin[3] = {first->boundsMinPower[0], first->boundsMinPower[1], first->boundsMinPower[2]};
+        float secondMax[3] = {second->boundsMaxCosTheta[0], second->boundsMaxCosTheta[1], second->boundsMaxCosTheta[2]};
+        TEST_CHECK(boundsContain(node, firstMin));
+        TEST_CHECK(boundsContain(node, secondMax));
+    }
+    TEST_CHECK(visitedLeaves == leafCount);
+    TEST_CHECK_NEAR(nodes[0].boundsMinPower[3], leafPower, 1e-5 * leafPower);
+}
+
+static void checkLightBuffers(const VKRT* vkrt, uint32_t expectedEmitterCount) {
+    uint32_t emitterCount = vkrt->core.emissiveMeshCount;
+    uint32_t triangleCount = vkrt->core.emissiveTriangleCount;
+    TEST_CHECK(emitterCount == expectedEmitterCount);
+
+    const EmissiveMesh* emitters =
+        (const EmissiveMesh*)findUpload(&vkrt->core.sceneEmissiveMeshData, sizeof(EmissiveMesh), emitterCount);
+    const EmissiveTriangle* triangles = (const EmissiveTriangle*)
+        findUpload(&vkrt->core.sceneEmissiveTriangleData, sizeof(EmissiveTriangle), triangleCount);
+    const float* aliasQ = (const float*)findUpload(&vkrt->core.sceneTriAliasQ, sizeof(float), triangleCount);
+    const uint32_t* aliasIdx =
+        (const uint32_t*)findUpload(&vkrt->core.sceneTriAliasIdx, sizeof(uint32_t), triangleCount);
+    if (!emitters || !triangles || !aliasQ || !aliasIdx) return;
+
+    double pmfSum = 0.0;
+    for (uint32_t i = 0; i < emitterCount; i++) pmfSum += emitters[i].pmfMesh;
+    TEST_CHECK_NEAR(pmfSum, 1.0, 1e-5);
+
+    checkClusterLayout(vkrt, emitters, triangles, aliasQ, aliasIdx);
+    checkLightBVH(vkrt, emitters, emitterCount, triangles);
+}
+
+int main(void) {
+    gMaterials[0].emissionColor[0] = 1.0f;
+    gMaterials[0].emissionColor[1] = 0.8f;
+    gMaterials[0].emissionColor[2] = 0.6f;
+    gMaterials[0].emissionLuminance = 5.0f;
+    gMaterials[0].opacity = 1.0f;
+    gMaterials[0].emissiveTextureIndex = VKRT_INVALID_INDEX;
+    gMaterials[0].alphaMode = VKRT_MATERIAL_ALPHA_MODE_OPAQUE;
+    gMaterials[1] = gMaterials[0];
+    gMaterials[1].emissionLuminance = 0.0f;
+
+    VKRT* vkrt = (VKRT*)calloc(1, sizeof(VKRT));
+    TEST_CHECK(vkrt != NULL);
+    if (!vkrt) return testExitCode("light_bvh");
+    vkrt->sceneSettings.environmentTextureIndex = VKRT_INVALID_INDEX;
+    vkrt->core.meshes = (Mesh*)calloc(3u, sizeof(Mesh));
+    vkrt->core.meshCount = 3u;
+    buildScaledStrip(&vkrt->core.meshes[0]);
+    buildCurvedGrid(&vkrt->core.meshes[1]);
+    buildScaledStrip(&vkrt->core.meshes[2]);
+    vkrt->core.meshes[2].info.materialIndex = 1u;
+
+    // 40 strip triangles make three clusters, the middle one empty; the 201-triangle grid makes thirteen.
+    const uint32_t expectedEmitterCount = 3u + 13u;
+    TEST_CHECK(vkrtSceneRebuildLightBuffers(vkrt) == VKRT_SUCCESS);
+    TEST_CHECK(vkrt->core.meshes[2].info.lightPdfArea == 0.0f);
+    TEST_CHECK(vkrt->core.meshes[1].info.lightEmitterOffset == 3u);
+    checkLightBuffers(vkrt, expectedEmitterCount);
+
+    // Moving the grid keeps the cached triangles, so only the emitters and the BVH are rebuilt.
+    VkBuffer triangleBuffer = vkrt->core.sceneEmissiveTriangleData.buffer;
+    vkrt->core.meshes[1].worldTransform[3][2] = 7.0f;
+    TEST_CHECK(vkrtSceneRebuildLightBuffers(vkrt) == VKRT_SUCCESS);
+    TEST_CHECK(vkrt->core.sceneEmissiveTriangleData.buffer == triangleBuffer);
+    checkLightBuffers(vkrt, expectedEmitterCount);
+
+    releaseTestScene(vkrt);
+    return testExitCode("light_bvh");
+}
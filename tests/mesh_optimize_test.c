@@ -0,0 +1,309 @@
+#include "loader.h"
+#include "optimize.h"
+#include "test.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Drives meshOptimizePrimitive on hand-built primitives: exact and epsilon welding, dropping collapsed triangles, and
+// the triangle set, winding and index bounds that must survive the Tipsify and fetch reorders.
+
+enum {
+    TEST_GRID_CELLS = 32,
+    TEST_GRID_POINTS = TEST_GRID_CELLS + 1,
+    TEST_GRID_TRIANGLES = TEST_GRID_CELLS * TEST_GRID_CELLS * 2,
+    TEST_CACHE_SIZE = 16,
+};
+
+typedef struct TestTriangle {
+    float corners[3][3];
+} TestTriangle;
+
+static Vertex makeVertex(float x, float y, float z) {
+    Vertex vertex = {0};
+    vertex.position[0] = x;
+    vertex.position[1] = y;
+    vertex.position[2] = z;
+    vertex.normal[2] = 1.0f;
+    vertex.color[0] = 1.0f;
+    vertex.color[1] = 1.0f;
+    vertex.color[2] = 1.0f;
+    vertex.color[3] = 1.0f;
+    return vertex;
+}
+
+// Takes ownership copies of the arrays, since the optimizer frees and replaces them.
+static MeshImportEntry makeEntry(const Vertex* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount) {
+    MeshImportEntry entry = {0};
+    entry.vertices = (Vertex*)malloc(vertexCount * sizeof(Vertex));
+    entry.indices = (uint32_t*)malloc(indexCount * sizeof(uint32_t));
+    if (entry.vertices) memcpy(entry.vertices, vertices, vertexCount * sizeof(Vertex));
+    if (entry.indices) memcpy(entry.indices, indices, indexCount * sizeof(uint32_t));
+    entry.vertexCount = vertexCount;
+    entry.indexCount = indexCount;
+    return entry;
+}
+
+static void releaseEntry(MeshImportEntry* entry) {
+    free(entry->vertices);
+    free(entry->indices);
+    *entry = (MeshImportEntry){0};
+}
+
+static int optimizeEntry(MeshImportEntry* entry, float weldEpsilon) {
+    MeshOptimizeStats stats = {0};
+    size_t vertexCountBefore = entry->vertexCount;
+    size_t indexCountBefore = entry->indexCount;
+    int result = meshOptimizePrimitive(entry, weldEpsilon, &stats);
+    TEST_CHECK(stats.vertexCountBefore == vertexCountBefore && stats.indexCountBefore == indexCountBefore);
+    TEST_CHECK(stats.vertexCountAfter == entry->vertexCount && stats.indexCountAfter == entry->indexCount);
+    return result;
+}
+
+// Every index is in range, and vertices are numbered in the order the index buffer first touches them.
+static int indicesInFetchOrder(const MeshImportEntry* entry) {
+    uint32_t nextVertex = 0u;
+    for (size_t i = 0; i < entry->indexCount; i++) {
+        uint32_t index = entry->indices[i];
+        if (index >= entry->vertexCount || index > nextVertex) return 0;
+        if (index == nextVertex) nextVertex++;
+    }
+    return nextVertex == entry->vertexCount;
+}
+
+static void testExactWeld(void) {
+    // A quad split into two triangles that each carry their own copies of the shared diagonal, one of them at -0.
+    const Vertex vertices[] = {
+        makeVertex(0.0f, 0.0f, 0.0f),
+        makeVertex(1.0f, 0.0f, 0.0f),
+        makeVertex(1.0f, 1.0f, 0.0f),
+        makeVertex(-0.0f, 0.0f, 0.0f),
+        makeVertex(1.0f, 1.0f, 0.0f),
+        makeVertex(0.0f, 1.0f, 0.0f),
+    };
+    const uint32_t indices[] = {0, 1, 2, 3, 4, 5};
+    MeshImportEntry entry = makeEntry(vertices, 6u, indices, 6u);
+    TEST_CHECK(optimizeEntry(&entry, 0.0f) == 0);
+    TEST_CHECK(entry.vertexCount == 4u);
+    TEST_CHECK(entry.indexCount == 6u);
+    TEST_CHECK(indicesInFetchOrder(&entry));
+    releaseEntry(&entry);
+
+    // The same quad with a UV seam along the diagonal keeps both copies of it.
+    Vertex seamVertices[6];
+    memcpy(seamVertices, vertices, sizeof(seamVertices));
+    seamVertices[3].texcoord0[0] = 0.5f;
+    seamVertices[4].texcoord0[0] = 0.5f;
+    entry = makeEntry(seamVertices, 6u, indices, 6u);
+    TEST_CHECK(optimizeEntry(&entry, 0.0f) == 0);
+    TEST_CHECK(entry.vertexCount == 6u);
+    TEST_CHECK(entry.indexCount == 6u);
+    TEST_CHECK(indicesInFetchOrder(&entry));
+    releaseEntry(&entry);
+}
+
+static void testEpsilonWeld(void) {
+    // With a 0.01 grid, 0.101 and 0.109 share a cell and weld. 0.0999 and 0.1001 are closer but straddle the cell
+    // boundary at 0.1, so they stay apart.
+    const Vertex vertices[] = {
+        makeVertex(0.0f, 0.0f, 0.0f),
+        makeVertex(0.101f, 0.0f, 0.0f),
+        makeVertex(0.0999f, 1.0f, 0.0f),
+        makeVertex(0.109f, 0.0f, 0.0f),
+        makeVertex(1.0f, 0.0f, 0.0f),
+        makeVertex(0.1001f, 1.0f, 0.0f),
+    };
+    const uint32_t indices[] = {0, 1, 2, 3, 4, 5};
+    MeshImportEntry entry = makeEntry(vertices, 6u, indices, 6u);
+    TEST_CHECK(optimizeEntry(&entry, 0.01f) == 0);
+    TEST_CHECK(entry.vertexCount == 5u);
+    TEST_CHECK(entry.indexCount == 6u);
+    TEST_CHECK(indicesInFetchOrder(&entry));
+    releaseEntry(&entry);
+
+    // A sliver whose two far corners fall into one cell collapses and is dropped.
+    const Vertex sliverVertices[] = {
+        makeVertex(0.0f, 0.0f, 0.0f),
+        makeVertex(1.0f, 0.0f, 0.0f),
+        makeVertex(0.0f, 1.0f, 0.0f),
+        makeVertex(0.0f, 0.0f, 0.0f),
+        makeVertex(2.001f, 0.0f, 0.0f),
+        makeVertex(2.002f, 0.0f, 0.0f),
+    };
+    entry = makeEntry(sliverVertices, 6u, indices, 6u);
+    TEST_CHECK(optimizeEntry(&entry, 0.01f) == 0);
+    TEST_CHECK(entry.vertexCount == 3u);
+    TEST_CHECK(entry.indexCount == 3u);
+    TEST_CHECK(indicesInFetchOrder(&entry));
+    releaseEntry(&entry);
+}
+
+static uint32_t nextRandom(uint64_t* state) {
+    *state = (*state * 6364136223846793005ull) + 1442695040888963407ull;
+    return (uint32_t)(*state >> 33);
+}
+
+static void readTriangle(const Vertex* vertices, const uint32_t* indices, TestTriangle* outTriangle) {
+    for (uint32_t corner = 0; corner < 3u; corner++) {
+        memcpy(outTriangle->corners[corner], vertices[indices[corner]].position, sizeof(outTriangle->corners[0]));
+    }
+}
+
+// Rotates the corners so the smallest comes first. The cyclic order, and with it the winding, is unchanged.
+static void canonicalizeTriangle(TestTriangle* triangle) {
+    uint32_t first = 0u;
+    for (uint32_t corner = 1u; corner < 3u; corner++) {
+        if (memcmp(triangle->corners[corner], triangle->corners[first], sizeof(triangle->corners[0])) < 0) {
+            first = corner;
+        }
+    }
+    TestTriangle rotated;
+    for (uint32_t corner = 0; corner < 3u; corner++) {
+        memcpy(rotated.corners[corner], triangle->corners[(first + corner) % 3u], sizeof(rotated.corners[0]));
+    }
+    *triangle = rotated;
+}
+
+static int compareTriangles(const void* a, const void* b) {
+    return memcmp(a, b, sizeof(TestTriangle));
+}
+
+static size_t collectTriangles(const MeshImportEntry* entry, TestTriangle* outTriangles) {
+    size_t triangleCount = 0u;
+    for (size_t i = 0; i + 2u < entry->indexCount; i += 3u) {
+        TestTriangle* triangle = &outTriangles[triangleCount];
+        readTriangle(entry->vertices, &entry->indices[i], triangle);
+        if (memcmp(triangle->corners[0], triangle->corners[1], sizeof(triangle->corners[0])) == 0 ||
+            memcmp(triangle->corners[1], triangle->corners[2], sizeof(triangle->corners[0])) == 0 ||
+            memcmp(triangle->corners[0], triangle->corners[2], sizeof(triangle->corners[0])) == 0) {
+            continue;
+        }
+        canonicalizeTriangle(triangle);
+        triangleCount++;
+    }
+    qsort(outTriangles, triangleCount, sizeof(TestTriangle), compareTriangles);
+    return triangleCount;
+}
+
+// Average misses per triangle for a FIFO post-transform cache.
+static double measureCacheMissRatio(const uint32_t* indices, size_t indexCount, size_t vertexCount) {
+    uint32_t* insertedAt = (uint32_t*)calloc(vertexCount, sizeof(uint32_t));
+    if (!insertedAt) return 0.0;
+    uint32_t misses = 0u;
+    for (size_t i = 0; i < indexCount; i++) {
+        uint32_t vertex = indices[i];
+        if (insertedAt[vertex] == 0u || misses + 1u - insertedAt[vertex] > TEST_CACHE_SIZE) {
+            insertedAt[vertex] = ++misses;
+        }
+    }
+    free(insertedAt);
+    return (double)misses / (double)(indexCount / 3u);
+}
+
+static void testReorderKeepsTriangles(void) {
+    // A grid where every triangle has its own vertex copies, shuffled, plus a few degenerate triangles.
+    enum { DEGENERATE_COUNT = 8, TRIANGLE_COUNT = TEST_GRID_TRIANGLES + DEGENERATE_COUNT };
+    size_t vertexCount = (size_t)TRIANGLE_COUNT * 3u;
+    Vertex* vertices = (Vertex*)malloc(vertexCount * sizeof(Vertex));
+    uint32_t* order = (uint32_t*)malloc(TRIANGLE_COUNT * sizeof(uint32_t));
+    uint32_t* indices = (uint32_t*)malloc(vertexCount * sizeof(uint32_t));
+    TestTriangle* expected = (TestTriangle*)malloc(TRIANGLE_COUNT * sizeof(TestTriangle));
+    TestTriangle* actual = (TestTriangle*)malloc(TRIANGLE_COUNT * sizeof(TestTriangle));
+    TEST_CHECK(vertices && order && indices && expected && actual);
+    if (!vertices || !order || !indices || !expected || !actual) goto cleanup;
+
+    uint64_t random = 0x9e3779b97f4a7c15ull;
+    for (uint32_t i = 0; i < TRIANGLE_COUNT; i++) order[i] = i;
+    for (uint32_t i = TRIANGLE_COUNT - 1u; i > 0u; i--) {
+        uint32_t j = nextRandom(&random) % (i + 1u);
+        uint32_t swap = order[i];
+        order[i] = order[j];
+        order[j] = swap;
+    }
+
+    for (uint32_t slot = 0; slot < TRIANGLE_COUNT; slot++) {
+        uint32_t triangle = order[slot];
+        Vertex* corners = &vertices[(size_t)slot * 3u];
+        if (triangle >= TEST_GRID_TRIANGLES) {
+            float x = (float)(triangle - TEST_GRID_TRIANGLES);
+            corners[0] = makeVertex(x, 0.0f, 1.0f);
+            corners[1] = makeVertex(x, 0.0f, 1.0f);
+            corners[2] = makeVertex(x + 1.0f, 0.0f, 1.0f);
+        } else {
+            uint32_t cell = triangle / 2u;
+            float x = (float)(cell % TEST_GRID_CELLS);
+            float y = (float)(cell / TEST_GRID_CELLS);
+            if ((triangle & 1u) == 0u) {
+                corners[0] = makeVertex(x, y, 0.0f);
+                corners[1] = makeVertex(x + 1.0f, y, 0.0f);
+                corners[2] = makeVertex(x + 1.0f, y + 1.0f, 0.0f);
+            } else {
+                corners[0] = makeVertex(x, y, 0.0f);
+                corners[1] = makeVertex(x + 1.0f, y + 1.0f, 0.0f);
+                corners[2] = makeVertex(x, y + 1.0f, 0.0f);
+            }
+        }
+        for (uint32_t corner = 0; corner < 3u; corner++) indices[(size_t)slot * 3u + corner] = slot * 3u + corner;
+    }
+
+    MeshImportEntry entry = makeEntry(vertices, vertexCount, indices, vertexCount);
+    size_t expectedCount = collectTriangles(&entry, expected);
+    TEST_CHECK(expectedCount == TEST_GRID_TRIANGLES);
+
+    // The shuffled input, indexed by grid point, is the baseline the reorders should improve on. Degenerate triangles
+    // all share one extra slot past the grid.
+    size_t pointCount = (size_t)TEST_GRID_POINTS * TEST_GRID_POINTS;
+    for (size_t i = 0; i < vertexCount; i++) {
+        const float* position = vertices[i].position;
+        indices[i] = position[2] > 0.0f ? (uint32_t)pointCount
+                                        : (uint32_t)position[1] * TEST_GRID_POINTS + (uint32_t)position[0];
+    }
+    double shuffledRatio = measureCacheMissRatio(indices, vertexCount, pointCount + 1u);
+
+    TEST_CHECK(optimizeEntry(&entry, 0.0f) == 0);
+    TEST_CHECK(entry.vertexCount == (size_t)TEST_GRID_POINTS * TEST_GRID_POINTS);
+    TEST_CHECK(entry.indexCount == (size_t)TEST_GRID_TRIANGLES * 3u);
+    TEST_CHECK(indicesInFetchOrder(&entry));
+
+    size_t actualCount = collectTriangles(&entry, actual);
+    TEST_CHECK(actualCount == expectedCount);
+    TEST_CHECK(
+        actualCount == expectedCount && memcmp(actual, expected, actualCount * sizeof(TestTriangle)) == 0
+    );
+
+    double optimizedRatio = measureCacheMissRatio(entry.indices, entry.indexCount, entry.vertexCount);
+    TEST_CHECK(optimizedRatio < shuffledRatio * 0.75);
+
+    releaseEntry(&entry);
+
+cleanup:
+    free(vertices);
+    free(order);
+    free(indices);
+    free(expected);
+    free(actual);
+}
+
+static void testUnoptimizablePrimitive(void) {
+    // Every triangle collapses, so the primitive is left exactly as it was.
+    const Vertex vertices[] = {
+        makeVertex(0.0f, 0.0f, 0.0f),
+        makeVertex(0.0f, 0.0f, 0.0f),
+        makeVertex(1.0f, 0.0f, 0.0f),
+    };
+    const uint32_t indices[] = {0, 1, 2};
+    MeshImportEntry entry = makeEntry(vertices, 3u, indices, 3u);
+    TEST_CHECK(optimizeEntry(&entry, 0.0f) == 0);
+    TEST_CHECK(entry.vertexCount == 3u && entry.indexCount == 3u);
+    TEST_CHECK(memcmp(entry.indices, indices, sizeof(indices)) == 0);
+    releaseEntry(&entry);
+}
+
+int main(void) {
+    testExactWeld();
+    testEpsilonWeld();
+    testReorderKeepsTriangles();
+    testUnoptimizablePrimitive();
+    return testExitCode("mesh_optimize");
+}
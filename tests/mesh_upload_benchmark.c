@@ -0,0 +1,144 @@
+#include "geometry.h"
+#include "geometry_dedup.h"
+#include "geometry_heap.h"
+#include "mock_gpu.h"
+#include "platform.h"
+#include "rebuild.h"
+#include "state.h"
+#include "test.h"
+#include "types.h"
+#include "vkrt_internal.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Uploads 100k small meshes in one batch, as a large instanced glTF import does, against the stubbed GPU entry points
+// from mock_gpu.c. Half of the meshes reuse earlier geometry, so the timing covers fingerprinting, duplicate lookup,
+// heap allocation and staging of the unique geometry. `meson test --benchmark` runs it.
+
+enum {
+    BENCHMARK_MESH_COUNT = 100000,
+    BENCHMARK_GEOMETRY_COUNT = BENCHMARK_MESH_COUNT / 2,
+    BENCHMARK_VERTEX_COUNT = 8,
+    BENCHMARK_INDEX_COUNT = 36,
+};
+
+static const uint32_t kBoxIndices[BENCHMARK_INDEX_COUNT] = {
+    0, 1, 2, 2, 1, 3, 4, 6, 5, 5, 6, 7, 0, 4, 1, 1, 4, 5, 2, 3, 6, 6, 3, 7, 0, 2, 4, 4, 2, 6, 1, 5, 3, 3, 5, 7,
+};
+
+typedef struct BenchmarkScene {
+    Vertex* vertices;
+    VKRT_MeshUpload* uploads;
+} BenchmarkScene;
+
+// Geometry g is a unit box offset by g, so every geometry is distinct and every instance matches its source exactly.
+static void fillBoxGeometry(Vertex* vertices, uint32_t geometryIndex) {
+    for (uint32_t i = 0; i < BENCHMARK_VERTEX_COUNT; i++) {
+        vertices[i] = (Vertex){0};
+        vertices[i].position[0] = (float)(i & 1u) + (float)geometryIndex;
+        vertices[i].position[1] = (float)((i >> 1u) & 1u);
+        vertices[i].position[2] = (float)((i >> 2u) & 1u);
+        vertices[i].normal[1] = 1.0f;
+        vertices[i].color[0] = 1.0f;
+        vertices[i].color[1] = 1.0f;
+        vertices[i].color[2] = 1.0f;
+        vertices[i].color[3] = 1.0f;
+    }
+}
+
+// Even meshes introduce the next geometry; odd meshes instance a pseudo-random geometry introduced before them.
+static uint32_t queryMeshGeometry(uint32_t meshIndex) {
+    if ((meshIndex & 1u) == 0u) return meshIndex / 2u;
+    uint32_t introduced = (meshIndex / 2u) + 1u;
+    return (uint32_t)(((uint64_t)meshIndex * 2654435761ull) % introduced);
+}
+
+static int createBenchmarkScene(BenchmarkScene* outScene) {
+    *outScene = (BenchmarkScene){0};
+    outScene->vertices = (Vertex*)malloc((size_t)BENCHMARK_GEOMETRY_COUNT * BENCHMARK_VERTEX_COUNT * sizeof(Vertex));
+    outScene->uploads = (VKRT_MeshUpload*)calloc(BENCHMARK_MESH_COUNT, sizeof(VKRT_MeshUpload));
+    if (!outScene->vertices || !outScene->uploads) return 0;
+
+    for (uint32_t g = 0; g < BENCHMARK_GEOMETRY_COUNT; g++) {
+        fillBoxGeometry(&outScene->vertices[(size_t)g * BENCHMARK_VERTEX_COUNT], g);
+    }
+    for (uint32_t i = 0; i < BENCHMARK_MESH_COUNT; i++) {
+        outScene->uploads[i] = (VKRT_MeshUpload){
+            .vertices = &outScene->vertices[(size_t)queryMeshGeometry(i) * BENCHMARK_VERTEX_COUNT],
+            .vertexCount = BENCHMARK_VERTEX_COUNT,
+            .indices = kBoxIndices,
+            .indexCount = BENCHMARK_INDEX_COUNT,
+        };
+    }
+    return 1;
+}
+
+static void destroyBenchmarkScene(BenchmarkScene* scene) {
+    free(scene->vertices);
+    free(scene->uploads);
+    *scene = (BenchmarkScene){0};
+}
+
+static double elapsedMilliseconds(uint64_t startMicroseconds) {
+    return (double)(getMicroseconds() - startMicroseconds) / 1000.0;
+}
+
+static void releaseBenchmarkCore(VKRT* vkrt) {
+    // Instances alias their owner's host geometry, as in lifecycle.c's teardown.
+    for (uint32_t i = 0; i < vkrt->core.meshCount; i++) {
+        if (!vkrt->core.meshes[i].ownsGeometry) continue;
+        free(vkrt->core.meshes[i].vertices);
+        free(vkrt->core.meshes[i].indices);
+    }
+    vkrtGeometryRangeRelease(&vkrt->core.geometryLayout.vertices);
+    vkrtGeometryRangeRelease(&vkrt->core.geometryLayout.indices);
+    vkrtGeometryDedupRelease(&vkrt->core.geometryDedup);
+    free(vkrt->core.meshes);
+}
+
+int main(void) {
+    BenchmarkScene scene = {0};
+    VKRT* vkrt = (VKRT*)calloc(1u, sizeof(VKRT));
+    TEST_CHECK(vkrt != NULL);
+    TEST_CHECK(createBenchmarkScene(&scene));
+    if (!vkrt || !scene.uploads || !scene.vertices) goto cleanup;
+
+    uint64_t start = getMicroseconds();
+    TEST_CHECK(vkrtSceneUploadMeshDataBatch(vkrt, scene.uploads, BENCHMARK_MESH_COUNT) == VKRT_SUCCESS);
+    double uploadMilliseconds = elapsedMilliseconds(start);
+
+    start = getMicroseconds();
+    TEST_CHECK(vkrtScenePreparePendingGeometryUploads(vkrt) == VKRT_SUCCESS);
+    double stageMilliseconds = elapsedMilliseconds(start);
+
+    uint32_t ownerCount = 0;
+    for (uint32_t i = 0; i < vkrt->core.meshCount; i++) ownerCount += vkrt->core.meshes[i].ownsGeometry ? 1u : 0u;
+    TEST_CHECK(vkrt->core.meshCount == BENCHMARK_MESH_COUNT);
+    TEST_CHECK(ownerCount == BENCHMARK_GEOMETRY_COUNT);
+    TEST_CHECK(vkrt->core.geometryLayout.vertices.usedCount == BENCHMARK_GEOMETRY_COUNT * BENCHMARK_VERTEX_COUNT);
+
+    printf(
+        "mesh_upload: %u meshes (%u unique): batch upload %.1f ms (%.0f meshes/s), staging %.1f ms, %.1f MiB staged\n",
+        (unsigned)BENCHMARK_MESH_COUNT,
+        (unsigned)ownerCount,
+        uploadMilliseconds,
+        uploadMilliseconds > 0.0 ? (double)BENCHMARK_MESH_COUNT * 1000.0 / uploadMilliseconds : 0.0,
+        stageMilliseconds,
+        (double)gMockGpu.stagedBytes / (1024.0 * 1024.0)
+    );
+
+    for (uint32_t i = 0; i < vkrt->core.meshCount; i++) {
+        vkrt->core.meshes[i].geometryUploadPending = 0;
+        vkrt->core.meshes[i].blasBuildPending = 0;
+    }
+    vkrtCleanupPendingGeometryUploads(vkrt, vkrtCurrentFrameSceneUpdate(vkrt));
+
+cleanup:
+    if (vkrt) releaseBenchmarkCore(vkrt);
+    free(vkrt);
+    destroyBenchmarkScene(&scene);
+    destroyMockGpu();
+    return testExitCode("mesh_upload");
+}
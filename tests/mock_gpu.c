@@ -0,0 +1,232 @@
+#include "mock_gpu.h"
+
+#include "accel/accel.h"
+#include "buffer.h"
+#include "command/pool.h"
+#include "descriptor.h"
+#include "geometry.h"
+#include "lighting.h"
+#include "rebuild.h"
+#include "scene.h"
+#include "staging.h"
+#include "state.h"
+#include "types.h"
+#include "vkrt_internal.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <vulkan/vulkan.h>
+
+// Stand-ins for the buffer, staging, command and acceleration-structure entry points the scene geometry code calls,
+// so geometry.c runs on the host. Staging memory is real so packed uploads can be inspected; everything else only
+// hands out fake handles and counts bytes.
+
+MockGpu gMockGpu;
+
+
+static uint64_t nextMockHandle(void) {
+    return ++gMockGpu.nextHandle;
+}
+
+VKRT_Result createBuffer(
+    VKRT* vkrt,
+    VkDeviceSize size,
+    VkBufferUsageFlags usage,
+    VkMemoryPropertyFlags properties,
+    VkBuffer* buffer,
+    MemoryAllocation* bufferMemory
+) {
+    (void)vkrt;
+    (void)size;
+    (void)usage;
+    (void)properties;
+    *buffer = (VkBuffer)(uintptr_t)nextMockHandle();
+    *bufferMemory = NULL;
+    return VKRT_SUCCESS;
+}
+
+VKRT_Result copyBuffer(VKRT* vkrt, VkBuffer srcBuffer, VkDeviceSize srcOffset, VkBuffer dstBuffer, VkDeviceSize size) {
+    (void)vkrt;
+    (void)srcBuffer;
+    (void)srcOffset;
+    (void)dstBuffer;
+    gMockGpu.copiedBytes += size;
+    return VKRT_SUCCESS;
+}
+
+VKRT_Result createDeviceBufferFromData(
+    VKRT* vkrt,
+    const void* hostData,
+    VkDeviceSize size,
+    VkBufferUsageFlags usage,
+    VkBuffer* outBuffer,
+    MemoryAllocation* outMemory,
+    VkDeviceAddress* outDeviceAddress
+) {
+    (void)hostData;
+    if (outDeviceAddress) *outDeviceAddress = 0u;
+    return createBuffer(vkrt, size, usage, 0u, outBuffer, outMemory);
+}
+
+VKRT_Result updateDeviceBufferFromData(VKRT* vkrt, const void* hostData, VkDeviceSize size, VkBuffer dstBuffer) {
+    (void)vkrt;
+    (void)hostData;
+    (void)size;
+    (void)dstBuffer;
+    return VKRT_SUCCESS;
+}
+
+VKRT_Result createZeroInitializedDeviceBuffer(
+    VKRT* vkrt,
+    VkDeviceSize size,
+    VkBufferUsageFlags usage,
+    Buffer* outBuffer
+) {
+    *outBuffer = (Buffer){0};
+    return createBuffer(vkrt, size, usage, 0u, &outBuffer->buffer, &outBuffer->memory);
+}
+
+VkDeviceAddress queryBufferDeviceAddress(VKRT* vkrt, VkBuffer buffer) {
+    (void)vkrt;
+    return (VkDeviceAddress)(uintptr_t)buffer << 32u;
+}
+
+void destroyBufferResources(VKRT* vkrt, Buffer* buffer) {
+    (void)vkrt;
+    if (buffer) *buffer = (Buffer){0};
+}
+
+VKRT_Result beginSingleTimeCommands(VKRT* vkrt, VkCommandBuffer* outCommandBuffer) {
+    (void)vkrt;
+    *outCommandBuffer = (VkCommandBuffer)(uintptr_t)nextMockHandle();
+    return VKRT_SUCCESS;
+}
+
+VKRT_Result endSingleTimeCommands(VKRT* vkrt, VkCommandBuffer commandBuffer) {
+    (void)vkrt;
+    (void)commandBuffer;
+    return VKRT_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdCopyBuffer(
+    VkCommandBuffer commandBuffer,
+    VkBuffer srcBuffer,
+    VkBuffer dstBuffer,
+    uint32_t regionCount,
+    const VkBufferCopy* regions
+) {
+    (void)commandBuffer;
+    (void)srcBuffer;
+    (void)dstBuffer;
+    for (uint32_t i = 0; i < regionCount; i++) gMockGpu.copiedBytes += regions[i].size;
+}
+
+VKRT_Result vkrtAllocateStaging(VKRT* vkrt, VkDeviceSize size, StagingAllocation* outAllocation) {
+    (void)vkrt;
+    if (gMockGpu.stagingCount == gMockGpu.stagingCapacity) {
+        uint32_t capacity = gMockGpu.stagingCapacity > 0u ? gMockGpu.stagingCapacity * 2u : 64u;
+        void** staging = (void**)realloc(gMockGpu.staging, (size_t)capacity * sizeof(void*));
+        if (!staging) return VKRT_ERROR_OUT_OF_MEMORY;
+        gMockGpu.staging = staging;
+        gMockGpu.stagingCapacity = capacity;
+    }
+    void* mapped = malloc((size_t)size);
+    if (!mapped) return VKRT_ERROR_OUT_OF_MEMORY;
+
+    gMockGpu.staging[gMockGpu.stagingCount++] = mapped;
+    gMockGpu.stagedBytes += size;
+    *outAllocation = (StagingAllocation){
+        .buffer = (VkBuffer)(uintptr_t)nextMockHandle(),
+        .size = size,
+        .mapped = mapped,
+    };
+    return VKRT_SUCCESS;
+}
+
+void vkrtCleanupPendingGeometryUploads(VKRT* vkrt, FrameSceneUpdate* update) {
+    (void)vkrt;
+    free(update->geometryUploads);
+    update->geometryUploads = NULL;
+    update->geometryUploadCount = 0;
+}
+
+VKRT_Result createBottomLevelAccelerationStructureForGeometry(
+    VKRT* vkrt,
+    const MeshInfo* meshInfo,
+    VkDeviceAddress vertexDataAddress,
+    VkDeviceAddress indexDataAddress,
+    AccelerationStructure* outAccelerationStructure
+) {
+    (void)vkrt;
+    (void)meshInfo;
+    (void)vertexDataAddress;
+    (void)indexDataAddress;
+    *outAccelerationStructure = (AccelerationStructure){0};
+    outAccelerationStructure->structure = (VkAccelerationStructureKHR)(uintptr_t)nextMockHandle();
+    return VKRT_SUCCESS;
+}
+
+void vkrtDestroyAccelerationStructureResources(VKRT* vkrt, AccelerationStructure* accelerationStructure) {
+    (void)vkrt;
+    if (accelerationStructure) *accelerationStructure = (AccelerationStructure){0};
+}
+
+VKRT_Result updateAllDescriptorSets(VKRT* vkrt) {
+    (void)vkrt;
+    return VKRT_SUCCESS;
+}
+
+VKRT_Result vkrtWaitForAllInFlightFrames(const VKRT* vkrt) {
+    (void)vkrt;
+    return VKRT_SUCCESS;
+}
+
+VKRT_Result vkrtEnsureDefaultMaterial(VKRT* vkrt) {
+    (void)vkrt;
+    return VKRT_SUCCESS;
+}
+
+uint32_t vkrtResolveMeshRenderBackfaces(const Mesh* mesh) {
+    (void)mesh;
+    return 0u;
+}
+
+void vkrtReleaseEmissiveTriangleCache(EmissiveTriangleCache* cache) {
+    (void)cache;
+}
+
+void packMeshInfoTransform(mat4 worldTransform, MeshInfo* outInfo) {
+    (void)worldTransform;
+    (void)outInfo;
+}
+
+void vkrtMarkSceneResourcesDirty(VKRT* vkrt) {
+    (void)vkrt;
+}
+
+void vkrtMarkMaterialResourcesDirty(VKRT* vkrt) {
+    (void)vkrt;
+}
+
+void vkrtMarkLightResourcesDirty(VKRT* vkrt) {
+    (void)vkrt;
+}
+
+void markSelectionMaskDirty(VKRT* vkrt) {
+    (void)vkrt;
+}
+
+void resetSceneData(VKRT* vkrt) {
+    (void)vkrt;
+}
+
+void releaseMockStaging(void) {
+    for (uint32_t i = 0; i < gMockGpu.stagingCount; i++) free(gMockGpu.staging[i]);
+    gMockGpu.stagingCount = 0u;
+}
+
+void destroyMockGpu(void) {
+    releaseMockStaging();
+    free(gMockGpu.staging);
+    gMockGpu = (MockGpu){0};
+}
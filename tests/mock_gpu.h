@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdint.h>
+
+typedef struct MockGpu {
+    uint64_t nextHandle;
+    uint64_t copiedBytes;
+    uint64_t stagedBytes;
+    void** staging;
+    uint32_t stagingCount;
+    uint32_t stagingCapacity;
+} MockGpu;
+
+extern MockGpu gMockGpu;
+
+void releaseMockStaging(void);
+void destroyMockGpu(void);
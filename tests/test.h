@@ -0,0 +1,46 @@
+#pragma once
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Minimal check helpers shared by the host-side tests. A failed check logs and keeps going so one run reports every
+// broken expectation; the test's main returns testExitCode().
+
+static int gTestFailureCount = 0;
+
+#define TEST_CHECK(condition)                                                             \
+    do {                                                                                  \
+        if (!(condition)) {                                                               \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            gTestFailureCount++;                                                          \
+        }                                                                                 \
+    } while (0)
+
+#define TEST_CHECK_NEAR(actual, expected, tolerance)                     \
+    do {                                                                 \
+        double testActual = (double)(actual);                            \
+        double testExpected = (double)(expected);                        \
+        if (!(fabs(testActual - testExpected) <= (double)(tolerance))) { \
+            fprintf(                                                     \
+                stderr,                                                  \
+                "%s:%d: %s = %.9g, expected %.9g within %.3g\n",         \
+                __FILE__,                                                \
+                __LINE__,                                                \
+                #actual,                                                 \
+                testActual,                                              \
+                testExpected,                                            \
+                (double)(tolerance)                                      \
+            );                                                           \
+            gTestFailureCount++;                                         \
+        }                                                                \
+    } while (0)
+
+static inline int testExitCode(const char* testName) {
+    if (gTestFailureCount == 0) {
+        printf("%s: all checks passed\n", testName);
+        return EXIT_SUCCESS;
+    }
+    fprintf(stderr, "%s: %d check(s) failed\n", testName, gTestFailureCount);
+    return EXIT_FAILURE;
+}